@@ -0,0 +1,26 @@
+# @brief 无 Qt 依赖的命令行客户端与吞吐基准
+# @note 仅编译传输引擎、协议与传输对象，只链接 ProjectTransCommonDaneJoe
+set(CLIENT_CLI_EXECUTABLE_NAME ${PROJECT_NAME}Cli)
+
+if(NOT TARGET ProjectTransCommonDaneJoe)
+    add_subdirectory("${CMAKE_CURRENT_LIST_DIR}/../../common" "${CMAKE_BINARY_DIR}/ProjectTransCommon")
+endif()
+
+add_executable(${CLIENT_CLI_EXECUTABLE_NAME}
+    "${CMAKE_CURRENT_LIST_DIR}/../source/main/cli_main.cpp"
+    ${CLIENT_ENGINE_SOURCES}
+)
+target_include_directories(${CLIENT_CLI_EXECUTABLE_NAME} PRIVATE "${CMAKE_CURRENT_LIST_DIR}/../include")
+target_link_libraries(${CLIENT_CLI_EXECUTABLE_NAME} PRIVATE ProjectTransCommonDaneJoe)
+apply_warnings(${CLIENT_CLI_EXECUTABLE_NAME})
+
+# @brief 端到端吞吐基准（负载生成器）
+set(CLIENT_BENCH_EXECUTABLE_NAME ProjectTransBench)
+
+add_executable(${CLIENT_BENCH_EXECUTABLE_NAME}
+    "${CMAKE_CURRENT_LIST_DIR}/../source/main/bench_main.cpp"
+    ${CLIENT_ENGINE_SOURCES}
+)
+target_include_directories(${CLIENT_BENCH_EXECUTABLE_NAME} PRIVATE "${CMAKE_CURRENT_LIST_DIR}/../include")
+target_link_libraries(${CLIENT_BENCH_EXECUTABLE_NAME} PRIVATE ProjectTransCommonDaneJoe ProjectTransCommonAllocationCounter)
+apply_warnings(${CLIENT_BENCH_EXECUTABLE_NAME})
@@ -10,3 +10,5 @@ option(WARNINGS_AS_ERRORS "Treat warnings as errors" OFF)
 option(ADD_QT_LIB "Enable Qt6 integration" ON)
 # @brief 启用 DaneJoe 集成
 option(ADD_DANEJOE_LIB "Enable DaneJoe integration" ON)
+# @brief 构建无 Qt 依赖的命令行客户端
+option(BUILD_CLIENT_CLI "Build Qt-free command line client" ON)
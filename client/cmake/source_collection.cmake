@@ -23,6 +23,14 @@ file(GLOB CLIENT_NORMAL_DIR_SOURCES CONFIGURE_DEPENDS
     "${CLIENT_PROJECT_DIR}/source/common/util/*.cpp"
     "${CLIENT_PROJECT_DIR}/source/common/protocol/*.cpp"
     "${CLIENT_PROJECT_DIR}/source/protocol/*.cpp"
+    "${CLIENT_PROJECT_DIR}/source/engine/*.cpp"
+)
+
+# 客户端无 Qt 依赖的传输引擎源文件（命令行客户端）
+file(GLOB CLIENT_ENGINE_SOURCES CONFIGURE_DEPENDS
+    "${CLIENT_PROJECT_DIR}/source/model/transfer/*.cpp"
+    "${CLIENT_PROJECT_DIR}/source/protocol/*.cpp"
+    "${CLIENT_PROJECT_DIR}/source/engine/*.cpp"
 )
 
 # 客户端QObject对象系统头文件
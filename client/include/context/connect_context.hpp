@@ -7,6 +7,9 @@
   */
 #pragma once
 
+#include <vector>
+#include <cstdint>
+
 #include <QObject>
 #include <QPointer>
 #include <QTcpSocket>
@@ -46,10 +49,12 @@ signals:
     /**
       * @brief 完整帧组装完成信号
       * @param frame 组装完成的帧数据
+      * @note 仅在连接所在线程内直接连接使用，以引用传递避免复制帧数据
       */
-    void frame_assembled(QByteArray frame);
+    void frame_assembled(const std::vector<uint8_t>& frame);
     /**
       * @brief socket 断开连接信号
+      * @details 连接断开或建立连接失败时发出，每个上下文只发出一次。
       */
     void socket_disconnected();
 private slots:
@@ -67,6 +72,12 @@ private slots:
       * @brief 处理 socket 断开事件
       */
     void on_socket_disconnected();
+    /**
+      * @brief 处理 socket 错误事件
+      * @param error 错误类型
+      * @details 建立连接失败时 socket 不会发出 disconnected，在此按断开处理。
+      */
+    void on_socket_error(QAbstractSocket::SocketError error);
 private:
     /// @brief 绑定的 socket 指针（QPointer 自动跟踪对象销毁）
     QPointer<QTcpSocket> m_socket;
@@ -74,6 +85,8 @@ private:
     QByteArray m_write_buffer;
     /// @brief 帧组装器，用于将接收字节流切分为完整帧
     DaneJoe::FrameAssembler m_frame_assembler;
+    /// @brief 是否已发出断开信号
+    bool m_is_disconnected = false;
     /// @brief 最近一次读写活动时间
     std::chrono::steady_clock::time_point m_last_activity;
 };
\ No newline at end of file
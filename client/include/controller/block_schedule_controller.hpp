@@ -6,25 +6,80 @@
   */
 #pragma once
 
+#include <deque>
+#include <chrono>
+#include <future>
+#include <functional>
 #include <memory>
+#include <string>
+#include <vector>
+#include <utility>
+#include <optional>
 #include <unordered_map>
+#include <unordered_set>
 
 #include <QObject>
-#include <QQueue>
 #include <QMutex>
 #include <QTimer>
-#include <QFile>
 #include <QPointer>
 
+#include "danejoe/network/flow/adaptive_window.hpp"
+#include "danejoe/network/flow/adaptive_block_size.hpp"
+#include "danejoe/common/io/positional_file_writer.hpp"
+#include "danejoe/common/hash/chunk_manifest.hpp"
+
 #include "model/entity/task_entity.hpp"
 #include "service/block_service.hpp"
 #include "service/task_service.hpp"
+#include "service/client_file_service.hpp"
+#include "service/task_progress_service.hpp"
 #include "view/event/view_event_hub.hpp"
 
+/**
+ * @struct TaskSource
+ * @brief 任务的下载源
+ * @details 镜像服务端上同一文件的 file_id 可能不同，因此每个源记录自己的 file_id。
+ */
+struct TaskSource
+{
+    /// @brief 源网络端点
+    NetworkEndpoint endpoint;
+    /// @brief 源服务端上的文件ID
+    int64_t file_id = -1;
+};
+
+/**
+ * @struct InFlightRequest
+ * @brief 块在某个源上的一次在途请求
+ */
+struct InFlightRequest
+{
+    /// @brief 源网络端点
+    NetworkEndpoint endpoint;
+    /// @brief 发出时间
+    std::chrono::steady_clock::time_point sent_time;
+    /// @brief 请求事件ID，超时或不再需要时据此撤销请求
+    uint64_t event_id = 0;
+};
+
+/**
+ * @struct InFlightBlock
+ * @brief 在途块
+ * @details 尾部窃取时同一块可能同时在两个源上请求，先到的响应生效。
+ */
+struct InFlightBlock
+{
+    /// @brief 块请求
+    BlockRequestTransfer transfer;
+    /// @brief 各源上的在途请求
+    std::vector<InFlightRequest> requests;
+};
+
   /**
    * @struct TaskPendding
    * @brief 任务调度中的暂存信息
    * @details 用于记录单个任务在块请求/响应调度过程中的状态与资源。
+   *          块按需从 unrequested_ranges 的首个区间切分，块长度由发出请求的源端点的 AdaptiveBlockSize 决定。
    */
 struct TaskPending
 {
@@ -32,18 +87,97 @@ struct TaskPending
     bool is_paused = false;
     /// @brief 事件来源上下文（用于回传/关联 UI 触发源）
     EventContext event_source;
-    /// @brief 目标网络端点
-    NetworkEndpoint endpoint;
     /// @brief 任务实体数据
     TaskEntity task_entity;
-    /// @brief 目标输出文件（下载写入）
-    std::unique_ptr<QFile> dest_file;
+    /// @brief 目标输出文件在写入器中的ID（首次写入时打开）
+    std::optional<uint64_t> dest_file_id;
+    /// @brief 已提交写入器、尚未写完的块
+    std::unordered_set<int64_t> writing_blocks;
+    /// @brief 已切分但尚未结束的块（按 block_id 索引）
+    std::unordered_map<int64_t, BlockRequestTransfer> live_blocks;
+    /// @brief 已落盘的字节区间
+    TaskProgressEntity progress;
+    /// @brief 自上次提交进度后新完成的块数
+    std::size_t unflushed_blocks = 0;
+    /// @brief 自上次通知界面后进度是否有变化
+    bool is_progress_changed = false;
+    /// @brief 文件 MD5，用于校验镜像源的文件一致性
+    std::string md5_code;
+    /// @brief 文件大小
+    int64_t file_size = 0;
+    /// @brief 主源返回的分块哈希清单，存在时块按清单的块边界切分并在写入前逐块校验
+    std::optional<DaneJoe::ChunkManifest> manifest;
+    /// @brief 各区间（按起始偏移）收到无效数据的次数
+    std::unordered_map<int64_t, int> range_mismatch_counts;
+    /// @brief 各源返回无效数据的次数
+    std::unordered_map<NetworkEndpoint, int> source_mismatch_counts;
+    /// @brief 是否正在按清单校验续传时已完成的区间，校验期间任务不结束
+    bool is_verifying_resume = false;
+    /// @brief 差量传输的基准文件路径，非空时等待差量结果，不发出块请求
+    std::string delta_basis_path;
+    /// @brief 本次差量传输的序号，用于丢弃已放弃的差量传输的迟到结果
+    uint64_t delta_id = 0;
+    /// @brief 差量传输开始时间
+    std::chrono::steady_clock::time_point delta_start_time;
+    /// @brief 尚未切分为块的字节区间 [begin, end)，按偏移升序
+    std::deque<std::pair<int64_t, int64_t>> unrequested_ranges;
+    /// @brief 下一个块ID（仅用于在本次调度中关联请求与响应）
+    int64_t next_block_id = 1;
+    /// @brief 已完成的字节数
+    int64_t completed_bytes = 0;
+    /// @brief 已校验的下载源（首个为任务入队时的主源）
+    std::vector<TaskSource> sources;
+    /// @brief 等待校验的镜像源
+    std::vector<TaskSource> unverified_sources;
+    /// @brief 已切分但需要重新请求的块（超时或断点恢复）
+    std::deque<BlockRequestTransfer> pending_blocks;
+    /// @brief 在途块（按 block_id 索引）
+    std::unordered_map<int64_t, InFlightBlock> in_flight_blocks;
+    /// @brief 各源上的在途请求数
+    std::unordered_map<NetworkEndpoint, int64_t> in_flight_counts;
+};
+
+/**
+ * @struct EndpointSchedule
+ * @brief 单个网络端点的调度状态
+ */
+struct EndpointSchedule
+{
+    /// @brief 在途块窗口
+    DaneJoe::AdaptiveWindow window;
+    /// @brief 块大小
+    DaneJoe::AdaptiveBlockSize block_size;
 };
 
 /**
  * @class BlockScheduleController
  * @brief 块调度控制器
- * @details 负责管理任务队列与定时触发块请求，并在收到块响应后推进任务进度。
+ * @details 负责管理任务队列与块请求的发出，并在收到块响应后推进任务进度。
+ *          块请求由事件驱动：任务入队、收到响应、恢复任务与超时重排时补足窗口。
+ *          每个网络端点维护一个 AdaptiveWindow，按测得的 RTT 与吞吐估计在途块数量；
+ *          同一端点上的活跃任务轮流发出请求，单个任务的在途数量不超过窗口的均分份额。
+ *          块不预先切分，也不逐块落库：发出请求时按端点的 AdaptiveBlockSize 从任务的缺失区间切出下一段，
+ *          块ID只在内存中分配。
+ *          任务可有多个下载源：镜像源经下载请求返回的 md5_code 与文件大小校验后加入，
+ *          各源按自身窗口拉取新块，吞吐越高的源分得的区间越多；全部区间发出后，
+ *          空闲的源会重复请求慢源上预计更晚完成的在途块，以消除尾部拖尾。
+ *          块数据交由 PositionalFileWriter 在写线程上按偏移写入，写完后才标记块完成；
+ *          任务结束时关闭目标文件，同步成功后任务才标记为完成。
+ *          任务进度为已落盘字节的区间集合（TaskProgressEntity），每累计若干块或每隔一段时间，
+ *          在目标文件同步后整体保存为一条记录；因此持久化的进度不会领先于磁盘数据，崩溃后未提交的区间仅会被重新下载。
+ *          恢复时由区间集合求出缺失区间，开销与历史块数量无关。
+ *          文件 MD5 在下载过程中增量校验：写线程把写入成功的数据按偏移顺序喂给前缀摘要，
+ *          摘要中间状态随进度一起保存；任务结束时只需比较摘要，不回读整个文件。
+ *          校验失败时清除进度，任务标记为失败。
+ *          任务入队时同时向主源请求分块哈希清单（XXH64）；清单到达后新切分的块与清单块边界对齐，
+ *          收到块数据时先校验其完整覆盖的清单块，不一致的块不写入并立即重新请求，
+ *          使损坏在到达时即被定位，而不是等到整个文件结束。服务端没有清单时仅做整体 MD5 校验。
+ *          续传的任务在清单到达后，由后台线程回读已完成区间完整覆盖的清单块并逐块校验，
+ *          不一致的区间从进度中撤销并重新下载；未被完整覆盖的清单块只由整体 MD5 兜底。
+ *          新任务若在本地找到同名文件的旧副本（保存路径上已有的文件，或同名文件已完成的下载任务），
+ *          先走差量传输：后台线程计算旧副本的签名发给主源，主源返回复制指令与字面数据，
+ *          后台线程据此重建到临时文件，MD5 一致后替换目标文件，传输量与改动量成正比。
+ *          差量不可用、失败或超时时回退为按块下载。
  */
 class BlockScheduleController : public QObject
 {
@@ -52,17 +186,22 @@ public:
     /**
      * @brief 构造函数
      * @param m_block_service 块服务引用
+     * @param task_service 任务服务引用
+     * @param client_file_service 客户端文件服务引用
+     * @param task_progress_service 任务进度服务引用
      * @param view_event_hub 视图事件中心
      * @param parent Qt 父对象
      */
     BlockScheduleController(
         BlockService& m_block_service,
         TaskService& task_service,
+        ClientFileService& client_file_service,
+        TaskProgressService& task_progress_service,
         QPointer<ViewEventHub> view_event_hub,
         QObject* parent = nullptr);
     /**
      * @brief 初始化
-     * @details 建立必要的信号槽连接并启动块请求定时器。
+     * @details 建立必要的信号槽连接并启动块超时检查定时器。
      */
     void init();
 signals:
@@ -94,9 +233,65 @@ public slots:
      */
     void on_task_paused(int64_t task_id, bool is_paused);
     /**
-     * @brief 定时触发块请求
+     * @brief 为任务添加镜像源
+     * @param task_id 任务ID
+     * @param endpoint 镜像源网络端点
+     * @param file_id 镜像源上的文件ID
+     * @details 向镜像源发出下载请求，响应的 md5_code 与文件大小一致后才参与调度。
+     */
+    void on_task_source_add(int64_t task_id, NetworkEndpoint endpoint, int64_t file_id);
+    /**
+     * @brief 处理镜像源校验的下载响应
+     * @param event_envelope 事件信封
+     * @param trans_context 传输上下文
+     * @param response 下载响应
+     * @details 仅处理由本控制器发出的下载请求。
+     */
+    void on_download_response(
+        EventEnvelope event_envelope,
+        TransContext trans_context,
+        DownloadResponseTransfer response);
+    /**
+     * @brief 处理分块哈希清单响应
+     * @param event_envelope 事件信封
+     * @param trans_context 传输上下文
+     * @param response 清单响应
+     * @details 仅处理由本控制器发出的清单请求；清单与任务文件大小不符时丢弃。
+     */
+    void on_manifest_response(
+        EventEnvelope event_envelope,
+        TransContext trans_context,
+        ManifestResponseTransfer response);
+    /**
+     * @brief 处理差量响应
+     * @param event_envelope 事件信封
+     * @param trans_context 传输上下文
+     * @param response 差量响应
+     * @details 差量为空或与任务的文件信息不符时回退为按块下载，否则在后台线程中应用差量。
+     */
+    void on_delta_response(
+        EventEnvelope event_envelope,
+        TransContext trans_context,
+        DeltaResponseTransfer response);
+    /**
+     * @brief 发出块请求
+     * @details 按各端点的自适应窗口轮流为活跃任务发出请求，直到窗口填满或无待发请求。
      */
     void on_block_request();
+    /**
+     * @brief 检查在途块超时
+     * @details 超过重传超时仍未响应的块重新排入队首，并通知窗口发生丢失。
+     */
+    void on_block_timeout();
+    /**
+     * @brief 定时提交各任务的进度
+     */
+    void on_progress_flush();
+    /**
+     * @brief 定时通知界面各任务的进度
+     * @details 只发布上次通知后有变化的任务，界面收到的进度事件频率与块速率无关。
+     */
+    void on_progress_notify();
     /**
      * @brief 处理块响应
      * @param event_envelope 事件信封
@@ -107,21 +302,242 @@ public slots:
         EventEnvelope event_envelope,
         TransContext trans_context,
         BlockResponseTransfer response);
+private:
+    /**
+     * @brief 查找可作为差量基准的本地旧副本
+     * @param task_pendding 任务暂存信息
+     * @param file_name 任务文件名
+     * @return 基准文件路径；无可用副本或任务已有进度时返回空
+     * @details 优先使用保存路径上已有的文件，其次为同名文件最近完成的下载任务的保存文件。
+     */
+    std::string find_delta_basis(const TaskPending& task_pendding, const std::string& file_name);
+    /**
+     * @brief 开始差量传输
+     * @param task_pendding 任务暂存信息
+     * @param basis_path 基准文件路径
+     * @details 在后台线程计算基准文件签名，完成后回到本线程调用 on_delta_signature_built()。
+     */
+    void start_delta(TaskPending& task_pendding, const std::string& basis_path);
+    /**
+     * @brief 基准文件签名计算完成
+     * @param task_id 任务ID
+     * @param delta_id 差量传输序号
+     * @param signature 编码后的签名，计算失败时为空
+     */
+    void on_delta_signature_built(int64_t task_id, uint64_t delta_id, std::optional<std::vector<uint8_t>> signature);
+    /**
+     * @brief 差量应用完成
+     * @param task_id 任务ID
+     * @param delta_id 差量传输序号
+     * @param output_path 重建的临时文件路径
+     * @param md5 重建文件的 MD5，应用失败时为空
+     * @details MD5 一致时替换目标文件并标记任务完成，否则删除临时文件并回退。
+     */
+    void on_delta_applied(int64_t task_id, uint64_t delta_id, const std::string& output_path, std::optional<DaneJoe::Md5> md5);
+    /**
+     * @brief 放弃差量传输并回退为按块下载
+     * @param task_pendding 任务暂存信息
+     * @param reason 原因（用于日志）
+     */
+    void fallback_from_delta(TaskPending& task_pendding, const std::string& reason);
+    /**
+     * @brief 开始校验续传时已完成的区间
+     * @param task_pendding 任务暂存信息（清单已到达）
+     * @details 在后台线程回读目标文件，完成后回到本线程调用 on_resume_verified()。
+     */
+    void start_resume_verify(TaskPending& task_pendding);
+    /**
+     * @brief 续传区间校验完成
+     * @param task_id 任务ID
+     * @param mismatched_ranges 与清单不一致（或无法读取）的 [begin, end) 区间，按偏移升序
+     * @details 撤销不一致区间的进度并重新排队，前缀摘要不再使用这些区间上的旧数据。
+     */
+    void on_resume_verified(int64_t task_id, std::vector<std::pair<int64_t, int64_t>> mismatched_ranges);
+    /**
+     * @brief 在后台线程中执行差量与续传校验相关的文件操作
+     * @param job 任务
+     * @details 同时清理已结束的任务；控制器析构时等待全部任务结束。
+     */
+    void run_delta_job(std::function<void()> job);
+    /**
+     * @brief 释放任务的全部在途块
+     * @param task_pendding 任务暂存信息
+     */
+    void release_in_flight_blocks(TaskPending& task_pendding);
+    /**
+     * @brief 任务是否还有待发出的块
+     * @param task_pendding 任务暂存信息
+     * @return 有待重发的块或尚有未切分区间时返回 true
+     */
+    bool has_block_to_request(const TaskPending& task_pendding)const;
+    /**
+     * @brief 获取端点的调度状态，不存在时按配置创建
+     * @param endpoint 网络端点
+     * @return 调度状态
+     */
+    EndpointSchedule& get_endpoint_schedule(const NetworkEndpoint& endpoint);
+    /**
+     * @brief 在指定源上发出块请求
+     * @param task_pendding 任务暂存信息
+     * @param source 下载源
+     * @param transfer 块请求
+     */
+    void dispatch_block_request(TaskPending& task_pendding, const TaskSource& source, BlockRequestTransfer transfer);
+    /**
+     * @brief 为空闲源挑选可窃取的在途块
+     * @param task_pendding 任务暂存信息
+     * @param endpoint 空闲源端点
+     * @return 块请求；无值得窃取的块时返回空
+     * @details 仅考虑只在其他源上在途的块，且空闲源预计完成时间早于原源的剩余预计时间。
+     */
+    std::optional<BlockRequestTransfer> take_straggler_block(TaskPending& task_pendding, const NetworkEndpoint& endpoint);
+    /**
+     * @brief 取出任务的下一个块请求
+     * @param task_pendding 任务暂存信息
+     * @param block_size 端点的块大小
+     * @return 块请求；切分新块失败时返回空
+     * @details 优先重发 pending_blocks 中的块，否则从首个未切分区间切出新块；
+     *          有分块哈希清单时块的结束位置对齐到清单块边界。
+     */
+    std::optional<BlockRequestTransfer> take_block_request(TaskPending& task_pendding, const DaneJoe::AdaptiveBlockSize& block_size);
+    /**
+     * @brief 检查任务是否结束并更新任务状态
+     * @param task_pendding 任务暂存信息
+     */
+    void check_task_completed(TaskPending& task_pendding);
+    /**
+     * @brief 校验任务的文件摘要
+     * @param task_pendding 任务暂存信息
+     * @param md5 写入器返回的前缀摘要
+     * @return 摘要覆盖整个文件且与 md5_code 一致时返回 true；任务没有 md5_code 时不校验
+     */
+    bool verify_digest(const TaskPending& task_pendding, const std::optional<DaneJoe::Md5>& md5)const;
+    /**
+     * @brief 结束任务并更新任务状态
+     * @param task_pendding 任务暂存信息
+     * @param is_success 目标文件是否已成功同步并通过校验
+     */
+    void finish_task(TaskPending& task_pendding, bool is_success);
+    /**
+     * @brief 打开任务的目标文件
+     * @param task_pendding 任务暂存信息
+     * @return 是否成功
+     * @details 任务有 md5_code 时启用前缀摘要，并从进度中保存的摘要状态与已完成区间继续。
+     */
+    bool open_dest_file(TaskPending& task_pendding);
+    /**
+     * @brief 关闭任务的目标文件
+     * @param task_pendding 任务暂存信息
+     * @details 仅提交关闭，不等待完成；用于任务取消或重新入队。
+     */
+    void close_dest_file(TaskPending& task_pendding);
+    /**
+     * @brief 将块数据提交给写入器
+     * @param task_pendding 任务暂存信息
+     * @param response 块响应（数据移动给写入器）
+     * @param endpoint 返回该响应的源端点
+     * @details 写入在写线程上完成，完成后回到本线程调用 on_block_written()。
+     *          偏移或数据长度与请求的区间不符（包括服务端读取失败时返回的空块）、或与清单不一致的数据不写入，
+     *          交给 retry_block() 重新请求。写入位置与进度只按请求的区间计算，不信任响应中的偏移与大小。
+     */
+    void save_block_response(TaskPending& task_pendding, BlockResponseTransfer& response, const NetworkEndpoint& endpoint);
+    /**
+     * @brief 重新请求收到无效数据的块
+     * @param task_pendding 任务暂存信息
+     * @param block_id 块ID（必须仍在 live_blocks 中）
+     * @param endpoint 返回无效数据的源端点
+     * @param reason 原因（用于日志）
+     * @details 请求的区间放回队首重新请求；同一源累计无效达到上限且还有其他源时移除该源，
+     *          同一区间累计无效达到上限时该块记为失败，任务结束时按失败处理。
+     */
+    void retry_block(TaskPending& task_pendding, int64_t block_id, const NetworkEndpoint& endpoint, const std::string& reason);
+    /**
+     * @brief 按分块哈希清单校验块数据
+     * @param task_pendding 任务暂存信息
+     * @param response 块响应
+     * @return 块完整覆盖的清单块全部一致时返回 true；没有清单时返回 true
+     */
+    bool verify_block_chunks(const TaskPending& task_pendding, const BlockResponseTransfer& response)const;
+    /**
+     * @brief 块写入完成
+     * @param task_id 任务ID
+     * @param block_id 块ID
+     * @param is_success 是否写入成功
+     * @details 更新块状态与任务进度；任务已取消或重新入队时忽略。
+     */
+    void on_block_written(int64_t task_id, int64_t block_id, bool is_success);
+    /**
+     * @brief 记录块的结束状态
+     * @param task_pendding 任务暂存信息
+     * @param block_id 块ID
+     * @param state 结束状态（Completed/Failed）
+     * @details 完成的块并入进度区间集合，新完成块数达到阈值时提交进度。
+     */
+    void record_block_state(TaskPending& task_pendding, int64_t block_id, BlockState state);
+    /**
+     * @brief 提交任务进度
+     * @param task_pendding 任务暂存信息
+     * @details 目标文件已打开时先提交同步检查点，同步完成后再保存进度快照与此时的摘要状态。
+     */
+    void flush_progress(TaskPending& task_pendding);
+    /**
+     * @brief 持久化任务进度
+     * @param progress 进度快照
+     * @param is_synced 对应数据是否已落盘，未落盘时不保存
+     */
+    void commit_progress(const TaskProgressEntity& progress, bool is_synced);
 private:
     /// @brief 是否已初始化
     bool m_is_init = false;
-    /// @brief 块请求定时器
-    QTimer* m_block_request_timer;
-    /// @brief 待发送的块请求队列
-    QQueue<BlockRequestTransfer> m_block_request_transfer_queue;
-    /// @brief 块请求间隔（毫秒）
-    int m_block_request_interval_ms = 30;
+    /// @brief 块超时检查定时器
+    QTimer* m_block_timeout_timer = nullptr;
+    /// @brief 块超时检查间隔（毫秒）
+    int m_block_timeout_check_interval_ms = 1000;
+    /// @brief 进度提交定时器
+    QTimer* m_progress_flush_timer = nullptr;
+    /// @brief 进度提交间隔（毫秒）
+    int m_progress_flush_interval_ms = 500;
+    /// @brief 单个任务新完成块数达到该数量时立即提交进度
+    std::size_t m_progress_flush_blocks = 64;
+    /// @brief 单个源返回无效数据（与请求不符或与清单不一致）的次数上限，达到后不再向该源请求（至少保留一个源）
+    int m_max_source_mismatches = 3;
+    /// @brief 单个区间收到无效数据的次数上限，达到后该块记为失败
+    int m_max_range_mismatches = 3;
+    /// @brief 进度通知定时器
+    QTimer* m_progress_notify_timer = nullptr;
+    /// @brief 进度通知间隔（毫秒），即界面进度刷新频率为 10 Hz
+    int m_progress_notify_interval_ms = 100;
+    /// @brief 自适应窗口配置
+    DaneJoe::AdaptiveWindowConfig m_window_config;
+    /// @brief 自适应块大小配置
+    DaneJoe::AdaptiveBlockSizeConfig m_block_size_config;
+    /// @brief 块数据写入器（独立写线程，检查点同步）
+    DaneJoe::PositionalFileWriter m_file_writer;
+    /// @brief 各端点的调度状态
+    std::unordered_map<NetworkEndpoint, EndpointSchedule> m_endpoint_schedules;
     /// @brief 视图事件中心
     QPointer<ViewEventHub> m_view_event_hub = nullptr;
     /// @brief 块服务引用
     BlockService& m_block_service;
+    /// @brief 任务服务引用
     TaskService& m_task_service;
+    /// @brief 客户端文件服务引用
+    ClientFileService& m_client_file_service;
+    /// @brief 任务进度服务引用
+    TaskProgressService& m_task_progress_service;
+    /// @brief 发出镜像源校验请求时使用的事件来源名称
+    static constexpr const char* SOURCE_CHECK_OBJECT_NAME = "BlockScheduleController";
+    /// @brief 发出分块哈希清单请求时使用的事件来源名称
+    static constexpr const char* MANIFEST_OBJECT_NAME = "BlockScheduleController.Manifest";
+    /// @brief 发出差量请求时使用的事件来源名称
+    static constexpr const char* DELTA_OBJECT_NAME = "BlockScheduleController.Delta";
+    /// @brief 差量传输超时，超时后回退为按块下载
+    std::chrono::steady_clock::duration m_delta_timeout = std::chrono::seconds(120);
+    /// @brief 下一个差量传输序号
+    uint64_t m_next_delta_id = 1;
     /// @brief 任务暂存表（按 task_id 索引）
     std::unordered_map<int64_t, TaskPending> m_task_pendding_map;
+    /// @brief 文件后台任务（签名计算、差量应用与续传校验），析构时等待结束
+    std::vector<std::future<void>> m_delta_jobs;
 
 };
\ No newline at end of file
@@ -6,6 +6,8 @@
  */
 #pragma once
 
+#include <mutex>
+#include <optional>
 #include <unordered_map>
 
 #include <QObject>
@@ -17,6 +19,8 @@
 #include "model/transfer/test_transfer.hpp"
 #include "model/transfer/block_transfer.hpp"
 #include "model/transfer/download_transfer.hpp"
+#include "model/transfer/manifest_transfer.hpp"
+#include "model/transfer/delta_transfer.hpp"
 #include "service/trans_service.hpp"
 
  /**
@@ -26,6 +30,8 @@
   *          - 接收来自视图层的请求事件并转发为网络请求
   *          - 接收来自传输层的响应信号并回投到事件中心
   *          - 维护 request_id -> EventEnvelope 的关联，用于请求-响应匹配
+  *          - 按事件ID撤销不再需要响应的请求
+  *          请求在发出方线程、响应在网络线程中直接处理，关联表由互斥锁保护。
   */
 class ViewEventController : public QObject
 {
@@ -84,6 +90,34 @@ public slots:
         EventEnvelope event_envelope,
         NetworkEndpoint endpoint,
         DownloadRequestTransfer request);
+    /**
+     * @brief 处理分块哈希清单请求事件
+     * @param event_envelope 事件封包，包含事件ID、上下文和时间戳
+     * @param endpoint 网络端点，指定清单请求的目标地址和端口
+     * @param request 清单请求传输对象
+     * @details 通过传输服务发送清单请求，并将事件封包与请求ID关联存储
+     */
+    void on_manifest_request(
+        EventEnvelope event_envelope,
+        NetworkEndpoint endpoint,
+        ManifestRequestTransfer request);
+    /**
+     * @brief 处理差量请求事件
+     * @param event_envelope 事件封包，包含事件ID、上下文和时间戳
+     * @param endpoint 网络端点，指定差量请求的目标地址和端口
+     * @param request 差量请求传输对象
+     * @details 通过传输服务发送差量请求，并将事件封包与请求ID关联存储
+     */
+    void on_delta_request(
+        EventEnvelope event_envelope,
+        NetworkEndpoint endpoint,
+        DeltaRequestTransfer request);
+    /**
+     * @brief 处理撤销请求事件
+     * @param event_id 请求事件的事件ID
+     * @details 移除事件封包关联并撤销对应的传输请求，迟到的响应将被忽略
+     */
+    void on_cancel_request(uint64_t event_id);
     /**
      * @brief 处理测试响应事件
      * @param trans_context 传输上下文，包含请求ID等传输相关信息
@@ -104,6 +138,24 @@ public slots:
     void on_download_response(
         TransContext trans_context,
         DownloadResponseTransfer response);
+    /**
+     * @brief 处理分块哈希清单响应事件
+     * @param trans_context 传输上下文，包含请求ID等传输相关信息
+     * @param response 清单响应传输对象
+     * @details 根据请求ID查找原始事件封包，找到后通过事件中心发布清单响应信号
+     */
+    void on_manifest_response(
+        TransContext trans_context,
+        ManifestResponseTransfer response);
+    /**
+     * @brief 处理差量响应事件
+     * @param trans_context 传输上下文，包含请求ID等传输相关信息
+     * @param response 差量响应传输对象
+     * @details 根据请求ID查找原始事件封包，找到后通过事件中心发布差量响应信号
+     */
+    void on_delta_response(
+        TransContext trans_context,
+        DeltaResponseTransfer response);
     /**
      * @brief 处理块响应事件
      * @param trans_context 传输上下文，包含请求ID等传输相关信息
@@ -114,11 +166,35 @@ public slots:
     void on_block_response(
         TransContext trans_context,
         BlockResponseTransfer response);
+    /**
+     * @brief 处理请求失败事件
+     * @param trans_context 传输上下文，包含请求ID等传输相关信息
+     * @details 请求超时、连接断开或响应无法解析时移除对应的事件封包，避免关联表无限增长
+     */
+    void on_request_failed(TransContext trans_context);
+private:
+    /**
+     * @brief 登记请求对应的事件封包
+     * @param request_id 请求ID
+     * @param event_envelope 事件封包
+     * @note 调用方需持有 m_event_envelope_mutex
+     */
+    void add_event_envelope(uint64_t request_id, EventEnvelope event_envelope);
+    /**
+     * @brief 取出并移除请求对应的事件封包
+     * @param request_id 请求ID
+     * @return 事件封包，不存在时返回 std::nullopt
+     */
+    std::optional<EventEnvelope> take_event_envelope(uint64_t request_id);
 private:
     /// @brief 事件中心（用于订阅请求事件与发布响应事件）
     QPointer<ViewEventHub> m_view_event_hub;
     /// @brief 传输服务引用（用于发送请求/接收响应）
     TransService& m_trans_service;
-    /// @brief 请求ID到事件封包的映射（用于响应到来时匹配原始事件）
+    /// @brief 事件封包映射锁，发送请求时持有，保证响应到达时已能查到对应封包
+    std::mutex m_event_envelope_mutex;
+    /// @brief 请求ID到事件封包的映射（用于响应到来时匹配原始事件，匹配后移除）
     std::unordered_map<uint64_t, EventEnvelope> m_event_envelopes;
+    /// @brief 事件ID到请求ID的映射（用于按事件撤销请求）
+    std::unordered_map<uint64_t, uint64_t> m_event_request_ids;
 };
\ No newline at end of file
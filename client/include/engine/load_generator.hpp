@@ -0,0 +1,200 @@
+/**
+ * @file load_generator.hpp
+ * @author DaneJoe001 (danejoe001.github)
+ * @brief 负载生成器
+ * @date 2026-01-11
+ * @details 以真实协议向服务端发送 /test、/download、/block 请求，用于端到端吞吐与延迟基准：
+ *          - 模拟客户端（长连接）均分到若干工作线程，每个工作线程独立运行 epoll 事件循环；
+ *          - 每个客户端保持固定数量的在途请求，响应到达后立即补发，请求类型按权重随机选择；
+ *          - 先预热再测量，只统计测量窗口内完成的请求，窗口边界处回调调用方以采集服务端指标；
+ *          - 统计按线程分别记录，结束后合并，记录路径上不加锁。
+ */
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <cstdint>
+#include <optional>
+#include <functional>
+
+#include "danejoe/metrics/latency_histogram.hpp"
+
+#include "common/protocol/network_endpoint.hpp"
+
+/**
+ * @enum LoadRequestKind
+ * @brief 负载请求类型
+ */
+enum class LoadRequestKind : uint8_t
+{
+    /// @brief /test
+    Test,
+    /// @brief /download
+    Download,
+    /// @brief /block
+    Block,
+    /// @brief 类型数量
+    Count
+};
+
+/**
+ * @brief 获取请求类型对应的路径
+ * @param kind 请求类型
+ * @return 路径
+ */
+const char* to_path(LoadRequestKind kind);
+
+/**
+ * @struct LoadGeneratorConfig
+ * @brief 负载生成配置
+ */
+struct LoadGeneratorConfig
+{
+    /// @brief 服务端地址
+    NetworkEndpoint endpoint;
+    /// @brief /download 与 /block 请求的文件ID
+    int64_t file_id = 1;
+    /// @brief 文件大小，决定 /block 请求的偏移范围
+    int64_t file_size = 0;
+    /// @brief 模拟客户端数（每个客户端一条连接）
+    std::size_t client_count = 16;
+    /// @brief 工作线程数
+    std::size_t thread_count = 2;
+    /// @brief 每个客户端的在途请求数
+    std::size_t pipeline_depth = 4;
+    /// @brief 块大小（字节），块请求按该大小对齐
+    int64_t block_size = 64 * 1024;
+    /// @brief /test 请求权重
+    uint32_t test_weight = 1;
+    /// @brief /download 请求权重
+    uint32_t download_weight = 1;
+    /// @brief /block 请求权重
+    uint32_t block_weight = 8;
+    /// @brief 预热时长
+    std::chrono::milliseconds warmup = std::chrono::milliseconds(2000);
+    /// @brief 测量时长
+    std::chrono::milliseconds duration = std::chrono::milliseconds(10000);
+};
+
+/**
+ * @struct LoadPathStats
+ * @brief 单个路径的统计
+ */
+struct LoadPathStats
+{
+    /// @brief 成功的请求数
+    uint64_t requests = 0;
+    /// @brief 失败的请求数（状态非 Ok、响应无法解析或连接断开）
+    uint64_t errors = 0;
+    /// @brief 成功响应的帧字节数
+    uint64_t bytes = 0;
+    /// @brief 成功请求的往返延迟（纳秒）
+    DaneJoe::LatencyHistogram latency;
+    /**
+     * @brief 合并另一个统计
+     * @param other 另一个统计
+     */
+    void merge(const LoadPathStats& other);
+};
+
+/**
+ * @struct LoadGeneratorReport
+ * @brief 负载生成结果
+ */
+struct LoadGeneratorReport
+{
+    /// @brief 各路径统计，按 LoadRequestKind 索引
+    std::array<LoadPathStats, static_cast<std::size_t>(LoadRequestKind::Count)> paths;
+    /// @brief 成功建立的连接数
+    std::size_t connected_clients = 0;
+    /// @brief 测量窗口时长
+    std::chrono::nanoseconds measured = std::chrono::nanoseconds(0);
+};
+
+/**
+ * @class LoadGenerator
+ * @brief 负载生成器
+ */
+class LoadGenerator
+{
+public:
+    using Clock = std::chrono::steady_clock;
+    using PhaseCallback = std::function<void()>;
+public:
+    /**
+     * @brief 构造函数
+     * @param config 负载生成配置
+     */
+    LoadGenerator(const LoadGeneratorConfig& config);
+    /**
+     * @brief 设置测量窗口回调
+     * @param on_measure_begin 测量开始时调用
+     * @param on_measure_end 测量结束时调用
+     * @details 回调在调用 run() 的线程上执行，此时工作线程仍在持续施压。
+     */
+    void set_measure_callbacks(PhaseCallback on_measure_begin, PhaseCallback on_measure_end);
+    /**
+     * @brief 运行负载直到测量窗口结束
+     * @return 负载生成结果，没有任何连接建立时返回 std::nullopt
+     */
+    std::optional<LoadGeneratorReport> run();
+    /**
+     * @brief 提前结束
+     * @note 可在任意线程调用。
+     */
+    void stop();
+    /**
+     * @brief 查询文件大小
+     * @param endpoint 服务端地址
+     * @param file_id 文件ID
+     * @param timeout 超时时间
+     * @return 文件大小，文件不存在或请求失败时返回 std::nullopt
+     */
+    static std::optional<int64_t> probe_file_size(
+        const NetworkEndpoint& endpoint,
+        int64_t file_id,
+        std::chrono::milliseconds timeout);
+    /**
+     * @brief 获取服务端指标文本
+     * @param endpoint 服务端地址
+     * @param timeout 超时时间
+     * @return 服务端 /metrics 返回的指标文本，请求失败时返回 std::nullopt
+     */
+    static std::optional<std::string> fetch_metrics(
+        const NetworkEndpoint& endpoint,
+        std::chrono::milliseconds timeout);
+private:
+    /**
+     * @enum Phase
+     * @brief 运行阶段
+     */
+    enum class Phase : uint8_t
+    {
+        /// @brief 预热，不统计
+        Warmup,
+        /// @brief 测量
+        Measure,
+        /// @brief 停止
+        Stop
+    };
+    /**
+     * @brief 工作线程主循环
+     * @param thread_index 线程序号
+     * @param client_count 该线程负责的客户端数
+     * @param report 线程私有的统计
+     */
+    void run_worker(std::size_t thread_index, std::size_t client_count, LoadGeneratorReport& report);
+private:
+    /// @brief 负载生成配置
+    LoadGeneratorConfig m_config;
+    /// @brief 运行阶段
+    std::atomic<Phase> m_phase = Phase::Warmup;
+    /// @brief 是否已请求提前结束
+    std::atomic<bool> m_is_stopped = false;
+    /// @brief 测量开始回调
+    PhaseCallback m_on_measure_begin;
+    /// @brief 测量结束回调
+    PhaseCallback m_on_measure_end;
+};
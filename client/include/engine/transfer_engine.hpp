@@ -0,0 +1,489 @@
+/**
+ * @file transfer_engine.hpp
+ * @author DaneJoe001 (danejoe001.github)
+ * @brief 无界面传输引擎
+ * @date 2026-01-10
+ * @details 不依赖 Qt 与客户端数据库，直接使用 common 中的套接字、epoll、帧组装与定位写入组件：
+ *          - 事件循环运行在调用 run() 的线程上，每个服务端维持若干条长连接；
+ *          - 块请求分发到在途字节数最少的连接，单个下载的在途块数受上限约束；
+ *          - 块数据交给写线程按偏移落盘，并增量计算 MD5，全部落盘后与服务端给出的 MD5 比对；
+ *          - 可同时执行多个下载，超出并发上限的下载排队。
+ *          供命令行客户端与负载生成使用。
+ */
+#pragma once
+
+#include <deque>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <optional>
+#include <functional>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "danejoe/common/io/positional_file_writer.hpp"
+#include "danejoe/network/context/connect_context.hpp"
+#include "danejoe/network/flow/least_outstanding_balancer.hpp"
+#include "danejoe/network/handle/posix_epoll_handle.hpp"
+#include "danejoe/network/handle/posix_event_handle.hpp"
+
+#include "common/protocol/network_endpoint.hpp"
+#include "model/transfer/block_transfer.hpp"
+#include "model/transfer/envelope_transfer.hpp"
+#include "protocol/client_message_codec.hpp"
+
+/**
+ * @struct TransferEngineConfig
+ * @brief 传输引擎配置
+ */
+struct TransferEngineConfig
+{
+    /// @brief 每个服务端的连接数
+    std::size_t connections_per_endpoint = 4;
+    /// @brief 块大小（字节）
+    int64_t block_size = 1024 * 1024;
+    /// @brief 单个下载的最大在途块数
+    std::size_t max_in_flight_blocks = 16;
+    /// @brief 同时进行的最大下载数，其余下载排队
+    std::size_t max_active_downloads = 8;
+    /// @brief 请求超时，超时的块请求重新排队
+    std::chrono::milliseconds request_timeout = std::chrono::milliseconds(30000);
+    /// @brief 单个请求的最大重试次数，超出后下载失败
+    int max_retries = 3;
+    /// @brief 是否校验 MD5（服务端未提供 MD5 时跳过）
+    bool is_verify_md5 = true;
+};
+
+/**
+ * @struct DownloadJob
+ * @brief 下载任务
+ */
+struct DownloadJob
+{
+    /// @brief 服务端
+    NetworkEndpoint endpoint;
+    /// @brief 服务端文件ID
+    int64_t file_id = -1;
+    /// @brief 输出路径（已存在时覆盖）
+    std::string output_path;
+};
+
+/**
+ * @struct DownloadResult
+ * @brief 下载结果
+ */
+struct DownloadResult
+{
+    /// @brief 下载任务
+    DownloadJob job;
+    /// @brief 是否成功
+    bool is_success = false;
+    /// @brief 失败原因
+    std::string error;
+    /// @brief 服务端文件名
+    std::string file_name;
+    /// @brief 文件大小
+    int64_t file_size = 0;
+    /// @brief 服务端给出的 MD5
+    std::string md5_code;
+    /// @brief 自开始请求到落盘关闭的耗时
+    std::chrono::nanoseconds elapsed = std::chrono::nanoseconds(0);
+};
+
+/**
+ * @struct TransferEngineProgress
+ * @brief 传输进度
+ */
+struct TransferEngineProgress
+{
+    /// @brief 下载总数
+    std::size_t total_downloads = 0;
+    /// @brief 已成功的下载数
+    std::size_t succeeded_downloads = 0;
+    /// @brief 已失败的下载数
+    std::size_t failed_downloads = 0;
+    /// @brief 已接收的块数据字节数
+    int64_t received_bytes = 0;
+    /// @brief 自 run() 开始的耗时
+    std::chrono::nanoseconds elapsed = std::chrono::nanoseconds(0);
+};
+
+/**
+ * @class TransferEngine
+ * @brief 无界面传输引擎
+ * @note 除 stop() 外的接口只能在同一线程上调用。
+ */
+class TransferEngine
+{
+public:
+    /// @brief 时钟类型
+    using Clock = std::chrono::steady_clock;
+    /// @brief 进度回调，在事件循环线程上执行
+    using ProgressCallback = std::function<void(const TransferEngineProgress&)>;
+public:
+    /**
+     * @brief 构造
+     * @param config 引擎配置
+     */
+    TransferEngine(const TransferEngineConfig& config = TransferEngineConfig());
+    /**
+     * @brief 析构
+     */
+    ~TransferEngine();
+    TransferEngine(const TransferEngine&) = delete;
+    TransferEngine& operator=(const TransferEngine&) = delete;
+    /**
+     * @brief 添加下载任务
+     * @param job 下载任务
+     * @note 需在 run() 之前调用
+     */
+    void add_download(const DownloadJob& job);
+    /**
+     * @brief 设置进度回调
+     * @param callback 进度回调
+     * @param interval 回调间隔
+     */
+    void set_progress_callback(ProgressCallback callback, std::chrono::milliseconds interval);
+    /**
+     * @brief 执行全部下载
+     * @return 各下载的结果，顺序与添加顺序一致
+     * @details 阻塞直到全部下载成功、失败或被 stop() 中止。
+     */
+    std::vector<DownloadResult> run();
+    /**
+     * @brief 中止运行
+     * @details 可在任意线程调用，未完成的下载以失败结束。
+     */
+    void stop();
+private:
+    /**
+     * @enum RequestKind
+     * @brief 在途请求类型
+     */
+    enum class RequestKind : uint8_t
+    {
+        /// @brief 文件信息请求
+        Download,
+        /// @brief 块请求
+        Block
+    };
+    /**
+     * @enum DownloadPhase
+     * @brief 下载阶段
+     */
+    enum class DownloadPhase : uint8_t
+    {
+        /// @brief 排队等待
+        Queued,
+        /// @brief 等待文件信息
+        Requesting,
+        /// @brief 块传输中
+        Transferring,
+        /// @brief 等待摘要检查点与关闭
+        Finishing,
+        /// @brief 已结束
+        Finished
+    };
+    /**
+     * @struct BlockAttempt
+     * @brief 块请求及其已重试次数
+     */
+    struct BlockAttempt
+    {
+        /// @brief 块请求
+        BlockRequestTransfer block;
+        /// @brief 已重试次数
+        int retry_count = 0;
+    };
+    /**
+     * @struct PendingRequest
+     * @brief 在途请求
+     */
+    struct PendingRequest
+    {
+        /// @brief 请求类型
+        RequestKind kind = RequestKind::Download;
+        /// @brief 所属下载的下标
+        std::size_t download_index = 0;
+        /// @brief 发送所用连接
+        uint64_t connect_id = 0;
+        /// @brief 块请求（仅块请求有效）
+        BlockAttempt attempt;
+        /// @brief 文件信息请求已重试次数
+        int retry_count = 0;
+        /// @brief 发送时间
+        Clock::time_point sent_time;
+    };
+    /**
+     * @struct Connection
+     * @brief 到服务端的连接
+     */
+    struct Connection
+    {
+        /// @brief 服务端
+        NetworkEndpoint endpoint;
+        /// @brief 在连接池中的槽位
+        std::size_t slot = 0;
+        /// @brief 连接上下文（帧组装与分片发送）
+        std::unique_ptr<DaneJoe::ConnectContext> context;
+        /// @brief 套接字描述符
+        int fd = -1;
+        /// @brief 是否正在监听可写事件
+        bool is_watching_write = false;
+        /// @brief 本轮事件循环中待发送的帧
+        std::vector<DaneJoe::PosixFrame> outgoing_frames;
+        /// @brief 在该连接上的在途请求
+        std::unordered_set<uint64_t> request_ids;
+    };
+    /**
+     * @struct EndpointPool
+     * @brief 单个服务端的连接池
+     */
+    struct EndpointPool
+    {
+        /// @brief 槽位到连接ID的映射，0 表示该槽位的连接已断开
+        std::vector<uint64_t> connect_ids;
+        /// @brief 按槽位统计在途字节数
+        DaneJoe::LeastOutstandingBalancer balancer;
+        /// @brief 该服务端支持的请求编码版本，收到声明支持紧凑编码的响应后升级
+        DaneJoe::SerializeVersion wire_version = DaneJoe::SerializeVersion::Named;
+    };
+    /**
+     * @struct DownloadState
+     * @brief 下载状态
+     */
+    struct DownloadState
+    {
+        /// @brief 下载阶段
+        DownloadPhase phase = DownloadPhase::Queued;
+        /// @brief 下载结果（同时保存任务本身）
+        DownloadResult result;
+        /// @brief 下一个未请求块的偏移
+        int64_t next_offset = 0;
+        /// @brief 下一个块ID
+        int64_t next_block_id = 0;
+        /// @brief 待重新请求的块
+        std::deque<BlockAttempt> retry_blocks;
+        /// @brief 在途块数
+        std::size_t in_flight_blocks = 0;
+        /// @brief 已落盘的字节数
+        int64_t written_bytes = 0;
+        /// @brief 写入器中的文件ID
+        std::optional<uint64_t> writer_file_id;
+        /// @brief 开始时间
+        Clock::time_point start_time;
+    };
+    /**
+     * @enum WriterEventKind
+     * @brief 写线程完成事件类型
+     */
+    enum class WriterEventKind : uint8_t
+    {
+        /// @brief 块写入完成
+        Write,
+        /// @brief 摘要检查点完成
+        Checkpoint,
+        /// @brief 文件关闭完成
+        Close
+    };
+    /**
+     * @struct WriterEvent
+     * @brief 写线程完成事件，由写线程投递回事件循环
+     */
+    struct WriterEvent
+    {
+        /// @brief 事件类型
+        WriterEventKind kind = WriterEventKind::Write;
+        /// @brief 所属下载的下标
+        std::size_t download_index = 0;
+        /// @brief 是否成功
+        bool is_success = false;
+        /// @brief 写入的字节数（仅写入事件有效）
+        int64_t bytes = 0;
+        /// @brief 摘要（仅检查点事件有效）
+        std::optional<DaneJoe::Md5> md5;
+    };
+private:
+    /**
+     * @brief 开始排队中的下载，直到达到并发上限
+     */
+    void start_queued_downloads();
+    /**
+     * @brief 获取服务端的连接池，连接不足时补齐
+     * @param endpoint 服务端
+     * @return 连接池，无可用连接时返回 nullptr
+     */
+    EndpointPool* ensure_endpoint_pool(const NetworkEndpoint& endpoint);
+    /**
+     * @brief 建立连接
+     * @param endpoint 服务端
+     * @param slot 在连接池中的槽位
+     * @return 连接ID，失败返回 std::nullopt
+     */
+    std::optional<uint64_t> open_connection(const NetworkEndpoint& endpoint, std::size_t slot);
+    /**
+     * @brief 断开连接，并将其上的在途请求重新排队
+     * @param connect_id 连接ID
+     * @param reason 断开原因
+     */
+    void close_connection(uint64_t connect_id, const std::string& reason);
+    /**
+     * @brief 选择在途字节数最少的连接
+     * @param endpoint 服务端
+     * @return 连接ID，无可用连接时返回 std::nullopt
+     */
+    std::optional<uint64_t> select_connection(const NetworkEndpoint& endpoint);
+    /**
+     * @brief 登记在途请求，并将帧加入连接的待发送队列
+     * @param connect_id 连接ID
+     * @param request_id 请求ID
+     * @param frame 请求帧
+     * @param pending 在途请求
+     * @param expected_bytes 期望响应的字节数，计入连接的在途字节
+     */
+    void send_request(uint64_t connect_id, uint64_t request_id, std::vector<uint8_t> frame, PendingRequest pending, int64_t expected_bytes);
+    /**
+     * @brief 发送文件信息请求
+     * @param download_index 下载下标
+     * @param retry_count 已重试次数
+     */
+    void send_download_request(std::size_t download_index, int retry_count);
+    /**
+     * @brief 发送块请求
+     * @param download_index 下载下标
+     * @param attempt 块请求
+     * @return 是否已发送
+     */
+    bool send_block_request(std::size_t download_index, BlockAttempt attempt);
+    /**
+     * @brief 为传输中的下载补足在途块请求
+     */
+    void dispatch_blocks();
+    /**
+     * @brief 处理连接上的 epoll 事件
+     * @param connect_id 连接ID
+     * @param events epoll 事件
+     */
+    void handle_connection_event(uint64_t connect_id, uint32_t events);
+    /**
+     * @brief 处理收到的响应帧
+     * @param connect_id 连接ID
+     * @param frame 帧数据
+     */
+    void handle_frame(uint64_t connect_id, const std::vector<uint8_t>& frame);
+    /**
+     * @brief 取出在途请求，并释放其占用的连接额度
+     * @param request_id 请求ID
+     * @return 在途请求，不存在（已超时或已取消）时返回 std::nullopt
+     */
+    std::optional<PendingRequest> take_pending_request(uint64_t request_id);
+    /**
+     * @brief 处理文件信息响应
+     * @param pending 在途请求
+     * @param response 信封响应
+     */
+    void handle_download_response(const PendingRequest& pending, const EnvelopeResponseTransfer& response);
+    /**
+     * @brief 处理块响应
+     * @param pending 在途请求
+     * @param response 信封响应
+     */
+    void handle_block_response(PendingRequest& pending, const EnvelopeResponseTransfer& response);
+    /**
+     * @brief 重新排队失败的请求
+     * @param pending 在途请求
+     * @param reason 失败原因
+     */
+    void retry_request(PendingRequest& pending, const std::string& reason);
+    /**
+     * @brief 全部块已落盘，提交摘要检查点
+     * @param download_index 下载下标
+     */
+    void finish_transfer(std::size_t download_index);
+    /**
+     * @brief 处理写线程投递的完成事件
+     */
+    void process_writer_events();
+    /**
+     * @brief 投递写线程完成事件并唤醒事件循环
+     * @param event 完成事件
+     */
+    void post_writer_event(WriterEvent event);
+    /**
+     * @brief 重新排队超时的请求
+     * @param now 当前时间
+     */
+    void expire_requests(Clock::time_point now);
+    /**
+     * @brief 发送各连接本轮积累的帧
+     */
+    void flush_connections();
+    /**
+     * @brief 结束下载
+     * @param download_index 下载下标
+     * @param is_success 是否成功
+     * @param error 失败原因
+     * @details 失败时撤销其在途请求并关闭文件，不等待关闭完成。
+     */
+    void finish_download(std::size_t download_index, bool is_success, const std::string& error = std::string());
+    /**
+     * @brief 以失败结束全部未完成的下载
+     * @param reason 失败原因
+     */
+    void abort_downloads(const std::string& reason);
+    /**
+     * @brief 生成当前进度
+     * @param now 当前时间
+     * @return 进度
+     */
+    TransferEngineProgress get_progress(Clock::time_point now)const;
+private:
+    /// @brief 引擎配置
+    TransferEngineConfig m_config;
+    /// @brief 消息编解码器
+    ClientMessageCodec m_message_codec;
+    /// @brief epoll 句柄
+    DaneJoe::PosixEpollHandle m_epoll;
+    /// @brief 写线程完成通知
+    DaneJoe::PosixEventHandle m_writer_event_handle;
+    /// @brief 是否已请求中止
+    std::atomic<bool> m_is_stopped = false;
+    /// @brief 各下载状态
+    std::vector<DownloadState> m_downloads;
+    /// @brief 排队中的下载下标
+    std::deque<std::size_t> m_queued_downloads;
+    /// @brief 进行中的下载下标
+    std::vector<std::size_t> m_active_downloads;
+    /// @brief 已结束的下载数
+    std::size_t m_finished_downloads = 0;
+    /// @brief 已成功的下载数
+    std::size_t m_succeeded_downloads = 0;
+    /// @brief 已接收的块数据字节数
+    int64_t m_received_bytes = 0;
+    /// @brief 连接
+    std::unordered_map<uint64_t, Connection> m_connections;
+    /// @brief 各服务端的连接池
+    std::unordered_map<NetworkEndpoint, EndpointPool> m_endpoint_pools;
+    /// @brief 在途请求
+    std::unordered_map<uint64_t, PendingRequest> m_pending_requests;
+    /// @brief 下一个连接ID（0 保留给写线程通知）
+    uint64_t m_next_connect_id = 1;
+    /// @brief 下一个请求ID
+    uint64_t m_next_request_id = 1;
+    /// @brief 进度回调
+    ProgressCallback m_progress_callback;
+    /// @brief 进度回调间隔
+    std::chrono::milliseconds m_progress_interval = std::chrono::milliseconds(1000);
+    /// @brief run() 开始时间
+    Clock::time_point m_start_time;
+    /// @brief 保护写线程完成事件
+    std::mutex m_writer_event_mutex;
+    /// @brief 写线程完成事件
+    std::vector<WriterEvent> m_writer_events;
+    /// @brief 定位写入器，最后声明以便最先析构，析构时投递的完成事件仍有合法的去处
+    DaneJoe::PositionalFileWriter m_file_writer;
+};
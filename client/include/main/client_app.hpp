@@ -14,6 +14,7 @@
 #include "service/block_service.hpp"
 #include "service/client_file_service.hpp"
 #include "service/task_service.hpp"
+#include "service/task_progress_service.hpp"
 #include "controller/view_event_controller.hpp"
 #include "controller/block_schedule_controller.hpp"
 #include "view/event/view_event_hub.hpp"
@@ -99,4 +100,6 @@ private:
     BlockService m_block_service;
     /// @brief 客户端文件服务引用，处理文件操作
     ClientFileService m_client_file_service;
+    /// @brief 任务进度服务，持久化任务的已完成区间
+    TaskProgressService m_task_progress_service;
 };
\ No newline at end of file
@@ -73,6 +73,7 @@ struct TaskEntity
     /// @note full_path
     std::string saved_path;
     /// @brief 源链接
+    /// @note 多个镜像源以空白分隔，首个为主源
     std::string source_url;
     /// @brief 操作
     Operation operation = Operation::Unknown;
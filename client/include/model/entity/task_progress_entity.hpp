@@ -0,0 +1,77 @@
+/**
+ * @file task_progress_entity.hpp
+ * @brief 任务进度实体
+ * @author DaneJoe001
+ * @date 2026-01-06
+ */
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "danejoe/condition/range_condition.hpp"
+
+/**
+ * @struct TaskProgressEntity
+ * @brief 任务进度
+ * @details 以区间集合记录任务已落盘的字节范围，每个任务只对应一条记录。
+ *          相邻或重叠的区间在加入时自动合并，区间数量只取决于乱序完成造成的空洞数，与块数量无关。
+ *          持久化时区间集合编码为单个二进制块：区间数量后跟各区间相对上一区间末尾的间隔与长度，均为变长整数。
+ *          同时保存文件前缀的 MD5 中间状态，恢复后从已摘要的偏移继续校验。
+ */
+struct TaskProgressEntity
+{
+    /// @brief 任务ID
+    int64_t task_id = -1;
+    /// @brief 已完成的字节区间（左闭右开，首尾相接的区间可直接合并）
+    DaneJoe::RangeCondition<int64_t> completed_ranges;
+    /// @brief 文件前缀的 MD5 中间状态（DaneJoe::Md5::save_state()），为空表示尚未摘要
+    std::vector<uint8_t> digest_state;
+    /**
+     * @brief 记录一段已完成的字节范围
+     * @param offset 起始偏移
+     * @param size 字节数
+     */
+    void add_completed(int64_t offset, int64_t size);
+    /**
+     * @brief 撤销一段已完成的字节范围
+     * @param offset 起始偏移
+     * @param size 字节数
+     * @details 用于恢复时发现磁盘数据与清单不一致，需要重新下载该范围。
+     */
+    void remove_completed(int64_t offset, int64_t size);
+    /**
+     * @brief 获取已完成的字节数
+     * @return 字节数
+     */
+    int64_t get_completed_bytes() const;
+    /**
+     * @brief 获取已完成的字节范围
+     * @return 按偏移升序的 [begin, end) 区间列表
+     */
+    std::vector<std::pair<int64_t, int64_t>> get_completed_ranges() const;
+    /**
+     * @brief 获取尚未完成的字节范围
+     * @param file_size 文件大小
+     * @return 按偏移升序的 [begin, end) 区间列表
+     */
+    std::vector<std::pair<int64_t, int64_t>> get_missing_ranges(int64_t file_size) const;
+    /**
+     * @brief 编码已完成区间
+     * @return 二进制数据
+     */
+    std::vector<uint8_t> to_blob() const;
+    /**
+     * @brief 从二进制数据解码已完成区间
+     * @param blob 二进制数据
+     * @return 是否解码成功（失败时区间集合为空）
+     */
+    bool from_blob(const std::vector<uint8_t>& blob);
+    /**
+     * @brief 转换为字符串
+     * @return 字符串
+     */
+    std::string to_string() const;
+};
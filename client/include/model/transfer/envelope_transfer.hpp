@@ -113,7 +113,7 @@ struct EnvelopeRequestTransfer
 struct EnvelopeResponseTransfer
 {
     /// @brief 协议版本
-    uint16_t version;
+    uint16_t version = 0;
     /// @brief 请求ID
     uint64_t request_id;
     /// @brief 响应状态
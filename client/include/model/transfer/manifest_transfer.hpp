@@ -0,0 +1,52 @@
+/**
+  * @file manifest_transfer.hpp
+  * @brief 分块哈希清单请求/响应传输模型
+  * @author DaneJoe001
+  * @date 2026-01-07
+  */
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @struct ManifestRequestTransfer
+ * @brief 分块哈希清单请求传输模型
+ */
+struct ManifestRequestTransfer
+{
+    /// @brief 文件ID
+    int64_t file_id = -1;
+    /// @brief 任务ID
+    int64_t task_id = -1;
+    /**
+     * @brief 转换为字符串
+     * @return 字符串
+     */
+    std::string to_string() const;
+};
+
+/**
+ * @struct ManifestResponseTransfer
+ * @brief 分块哈希清单响应传输模型
+ * @details 服务端没有该文件的清单时 chunk_size 为 0、chunk_hashes 为空。
+ */
+struct ManifestResponseTransfer
+{
+    /// @brief 文件ID
+    int64_t file_id = -1;
+    /// @brief 任务ID
+    int64_t task_id = -1;
+    /// @brief 文件大小
+    int64_t file_size = 0;
+    /// @brief 块大小
+    int64_t chunk_size = 0;
+    /// @brief 块哈希（每块 8 字节小端 XXH64）
+    std::vector<uint8_t> chunk_hashes;
+    /**
+     * @brief 转换为字符串
+     * @return 字符串
+     */
+    std::string to_string() const;
+};
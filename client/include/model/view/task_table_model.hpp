@@ -7,6 +7,8 @@
 #pragma once
 
 #include <cstdint>
+#include <utility>
+#include <unordered_map>
 
 #include <QAbstractTableModel>
 #include <QList>
@@ -42,6 +44,13 @@ public:
      * @param task_id 任务ID
      */
     void update(int64_t task_id);
+    /**
+     * @brief 更新任务进度
+     * @param task_id 任务ID
+     * @param completed_bytes 已完成字节数
+     * @param total_bytes 文件总字节数
+     */
+    void update_progress(int64_t task_id, int64_t completed_bytes, int64_t total_bytes);
     /**
      * @brief 列数
      * @param parent 父索引
@@ -95,4 +104,6 @@ private:
     TaskService& m_task_service;
     /// @brief 任务列表
     QList<TaskEntity> m_task_list;
+    /// @brief 任务进度（已完成字节数，总字节数），按任务ID索引
+    std::unordered_map<int64_t, std::pair<int64_t, int64_t>> m_task_progress;
 };
\ No newline at end of file
@@ -10,8 +10,12 @@
 #include <cstdint>
 #include <optional>
 
+#include "danejoe/network/codec/serialize_codec.hpp"
+
 #include "model/transfer/envelope_transfer.hpp"
 #include "model/transfer/download_transfer.hpp"
+#include "model/transfer/manifest_transfer.hpp"
+#include "model/transfer/delta_transfer.hpp"
 #include "model/transfer/block_transfer.hpp"
 #include "model/transfer/test_transfer.hpp"
 
@@ -21,10 +25,32 @@
    * @details 负责：
    *          - 将请求传输对象序列化为可发送的字节数组（帧）
    *          - 将响应帧/消息体反序列化为对应的传输对象
+   *          服务端以请求的编码版本回复；响应解析按消息头版本自动选择。
+   *          请求的编码版本由调用方按对端传入（见 get_peer_wire_version()），未传入时使用默认版本：
+   *          默认使用字段名编码，以兼容只支持该编码的旧服务端。编解码器本身不记录对端状态。
    */
 class ClientMessageCodec
 {
 public:
+    /**
+     * @brief 设置请求编码版本
+     * @param wire_version 编码版本
+     * @details 设置后所有请求固定使用该版本，忽略构建时按对端传入的版本。
+     */
+    void set_wire_version(DaneJoe::SerializeVersion wire_version);
+    /**
+     * @brief 获取请求编码版本
+     * @return 编码版本
+     */
+    DaneJoe::SerializeVersion get_wire_version()const;
+    /**
+     * @brief 获取对端支持的请求编码版本
+     * @param data 响应帧
+     * @param envelope 解析后的响应信封
+     * @return 响应为紧凑编码或信封版本声明支持紧凑编码时返回 Compact，否则返回 Named
+     * @details 调用方按网络端点保存结果，之后发往该端点的请求以此版本构建。
+     */
+    DaneJoe::SerializeVersion get_peer_wire_version(const std::vector<uint8_t>& data, const EnvelopeResponseTransfer& envelope)const;
     /**
      * @brief 解析响应信息
      * @param data 数据
@@ -38,6 +64,18 @@ public:
      * @return 解析后的文件信息
      */
     std::optional<DownloadResponseTransfer> try_parse_byte_array_download_response(const std::vector<uint8_t>& body);
+    /**
+     * @brief 解析分块哈希清单响应
+     * @param body 消息体
+     * @return 解析后的清单
+     */
+    std::optional<ManifestResponseTransfer> try_parse_byte_array_manifest_response(const std::vector<uint8_t>& body);
+    /**
+     * @brief 解析差量响应
+     * @param body 消息体
+     * @return 解析后的差量响应
+     */
+    std::optional<DeltaResponseTransfer> try_parse_byte_array_delta_response(const std::vector<uint8_t>& body);
     /**
      * @brief 解析块响应
      * @param body 消息体
@@ -54,34 +92,117 @@ public:
     /**
      * @brief 构建请求信息
      * @param request 请求信封对象
+     * @param wire_version 对端的编码版本，为空时使用默认版本
      * @return 序列化的消息
      */
-    std::vector<uint8_t> build_request_byte_array(EnvelopeRequestTransfer request);
+    std::vector<uint8_t> build_request_byte_array(EnvelopeRequestTransfer request, std::optional<DaneJoe::SerializeVersion> wire_version = std::nullopt);
     /**
      * @brief 构建测试消息
      * @param test_request 测试请求
      * @param request_id 请求ID
+     * @param wire_version 对端的编码版本，为空时使用默认版本
      * @return 序列化的测试请求帧数据
      */
     std::vector<uint8_t> build_test_request_byte_array(
         const TestRequestTransfer& test_request,
-        int64_t request_id);
+        int64_t request_id,
+        std::optional<DaneJoe::SerializeVersion> wire_version = std::nullopt);
+    /**
+     * @brief 构建指标请求
+     * @param request_id 请求ID
+     * @param wire_version 对端的编码版本，为空时使用默认版本
+     * @return 构建后的指标请求（消息体为空，响应按测试响应解析）
+     */
+    std::vector<uint8_t> build_metrics_request_byte_array(int64_t request_id, std::optional<DaneJoe::SerializeVersion> wire_version = std::nullopt);
     /**
      * @brief 构建下载消息
      * @param download_request 下载请求
      * @param request_id 请求ID
+     * @param wire_version 对端的编码版本，为空时使用默认版本
      * @return 构建后的下载消息
      */
     std::vector<uint8_t> build_download_request_byte_array(
         const DownloadRequestTransfer& download_request,
-        int64_t request_id);
+        int64_t request_id,
+        std::optional<DaneJoe::SerializeVersion> wire_version = std::nullopt);
+    /**
+     * @brief 构建分块哈希清单请求
+     * @param manifest_request 清单请求
+     * @param request_id 请求ID
+     * @param wire_version 对端的编码版本，为空时使用默认版本
+     * @return 构建后的清单请求
+     */
+    std::vector<uint8_t> build_manifest_request_byte_array(
+        const ManifestRequestTransfer& manifest_request,
+        int64_t request_id,
+        std::optional<DaneJoe::SerializeVersion> wire_version = std::nullopt);
+    /**
+     * @brief 构建差量请求
+     * @param delta_request 差量请求（携带基准文件签名）
+     * @param request_id 请求ID
+     * @param wire_version 对端的编码版本，为空时使用默认版本
+     * @return 构建后的差量请求
+     */
+    std::vector<uint8_t> build_delta_request_byte_array(
+        const DeltaRequestTransfer& delta_request,
+        int64_t request_id,
+        std::optional<DaneJoe::SerializeVersion> wire_version = std::nullopt);
     /**
      * @brief 构建块请求
      * @param block_request 块请求
      * @param request_id 请求ID
+     * @param wire_version 对端的编码版本，为空时使用默认版本
      * @return 构建后的块请求
      */
     std::vector<uint8_t> build_block_request_byte_array(
         const BlockRequestTransfer& block_request,
-        int64_t request_id);
+        int64_t request_id,
+        std::optional<DaneJoe::SerializeVersion> wire_version = std::nullopt);
+    /**
+     * @brief 交还不再使用的请求字节数组
+     * @param frame 由 build_*_request_byte_array 构建的请求
+     * @details 缓冲区交还当前线程的信封编码器，下一次构建直接复用其容量。
+     *          只有在构建该请求的线程上交还才会被复用。
+     */
+    void recycle_frame_byte_array(std::vector<uint8_t>&& frame)const;
+private:
+    /**
+     * @brief 确定请求使用的编码版本
+     * @param wire_version 调用方传入的对端编码版本
+     * @return 显式设置过版本或未传入时为默认版本，否则为传入的版本
+     */
+    DaneJoe::SerializeVersion resolve_wire_version(std::optional<DaneJoe::SerializeVersion> wire_version)const;
+    /**
+     * @brief 获取构建用的序列化配置
+     * @param wire_version 编码版本
+     * @return 序列化配置（编码版本与字段标签表）
+     */
+    DaneJoe::SerializeConfig get_build_config(DaneJoe::SerializeVersion wire_version)const;
+    /**
+     * @brief 获取解析用的序列化配置
+     * @return 序列化配置（字段标签表）
+     */
+    DaneJoe::SerializeConfig get_parse_config()const;
+    /**
+     * @brief 获取当前线程复用的消息体构建编码器
+     * @param wire_version 编码版本
+     * @return 已按编码版本重置的编码器
+     */
+    DaneJoe::SerializeCodec& get_body_build_codec(DaneJoe::SerializeVersion wire_version)const;
+    /**
+     * @brief 获取当前线程复用的信封构建编码器
+     * @param body_size 消息体大小（用于预留构建缓冲区）
+     * @param wire_version 编码版本
+     * @return 已按编码版本重置的编码器
+     */
+    DaneJoe::SerializeCodec& get_envelope_build_codec(std::size_t body_size, DaneJoe::SerializeVersion wire_version)const;
+private:
+    /// @brief 信封除消息体外预留的字节数
+    static constexpr uint32_t ENVELOPE_RESERVED_SIZE = 256;
+    /// @brief 表明服务端支持紧凑编码的最低响应信封版本
+    static constexpr uint16_t COMPACT_ENVELOPE_VERSION = 2;
+    /// @brief 默认请求编码版本
+    DaneJoe::SerializeVersion m_wire_version = DaneJoe::SerializeVersion::Named;
+    /// @brief 编码版本是否由调用方显式设置
+    bool m_is_wire_version_pinned = false;
 };
\ No newline at end of file
@@ -0,0 +1,19 @@
+/**
+ * @file message_field_tag.hpp
+ * @author DaneJoe001
+ * @brief 消息字段标签
+ * @date 2026-01-06
+ * @details 紧凑编码（DaneJoe::SerializeVersion::Compact）下字段名与数值标签的映射。
+ *          必须与服务端 protocol/message_field_tag 保持一致；新增字段只能追加新标签，不能复用或修改已有标签。
+ */
+#pragma once
+
+#include <memory>
+
+#include "danejoe/network/codec/serialize_field_tag_table.hpp"
+
+/**
+ * @brief 获取消息字段标签表
+ * @return 字段标签表（进程内共享，只读）
+ */
+std::shared_ptr<const DaneJoe::SerializeFieldTagTable> get_message_field_tag_table();
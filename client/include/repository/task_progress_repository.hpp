@@ -0,0 +1,78 @@
+/**
+  * @file task_progress_repository.hpp
+  * @brief 任务进度仓库
+  * @author DaneJoe001
+  * @date 2026-01-06
+  */
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include <danejoe/database/sql_query.hpp>
+#include <danejoe/database/sql_schema.hpp>
+#include <danejoe/database/sql_table_query.hpp>
+
+#include "model/entity/task_progress_entity.hpp"
+
+  /**
+    * @class TaskProgressRepository
+    * @brief 任务进度仓库
+    * @details 负责对 TaskProgressEntity 进行数据库持久化读写操作，每个任务一行，已完成区间存为单个 BLOB。
+    */
+class TaskProgressRepository
+{
+public:
+    /**
+     * @brief 构造函数
+     */
+    TaskProgressRepository();
+    /**
+     * @brief 析构函数
+     */
+    ~TaskProgressRepository();
+    /**
+     * @brief 初始化
+     */
+    void init();
+    /**
+     * @brief 确保表存在
+     * @return 是否成功
+     */
+    bool ensure_table_exists();
+    /**
+     * @brief 通过任务ID获取任务进度
+     * @param task_id 任务ID
+     * @return 任务进度（不存在或解码失败时返回空）
+     */
+    std::optional<TaskProgressEntity> get_by_task_id(int64_t task_id);
+    /**
+     * @brief 保存任务进度
+     * @param progress 任务进度
+     * @return 是否成功
+     * @details 不存在时插入，存在时整体替换。
+     */
+    bool save(const TaskProgressEntity& progress);
+    /**
+     * @brief 删除任务进度
+     * @param task_id 任务ID
+     * @return 是否成功
+     */
+    bool remove(int64_t task_id);
+private:
+    /**
+     * @brief 将查询结果转换为任务进度实体列表
+     * @param data 查询结果数据
+     * @return 任务进度实体列表
+     */
+    std::vector<TaskProgressEntity> from_query_data(const std::vector<std::vector<DaneJoe::SqlCell>>& data);
+private:
+    /// @brief 是否已初始化
+    bool m_is_init = false;
+    /// @brief 数据表信息
+    std::shared_ptr<DaneJoe::SqlTableItem> m_table;
+    /// @brief 数据表查询器
+    DaneJoe::SqlTableQuery m_table_query;
+};
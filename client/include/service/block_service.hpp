@@ -8,18 +8,6 @@
 
 #include "model/entity/block_entity.hpp"
 #include "repository/block_repository.hpp"
-#include "model/entity/client_file_entity.hpp"
-
-/**
- * @struct BlockParam
- * @brief 块参数
- * @details 用于生成块列表时的分块策略参数。
- */
-struct BlockParam
-{
-    /// @brief 分块大小（Bytes）
-    int64_t block_bytes = 128 * 1024 * 1024;
-};
 
 /**
  * @class BlockService
@@ -72,14 +60,6 @@ public:
      * @return 是否成功
      */
     bool add(const BlockEntity& block_entity);
-    /**
-     * @brief 为指定任务与文件生成块信息并写入仓库
-     * @param file_entity 文件信息
-     * @param task_id 任务ID
-     * @param param 分块参数
-     * @return 是否成功
-     */
-    bool add(const ClientFileEntity& file_entity, int64_t task_id, const BlockParam& param);
     /**
      * @brief 通过块ID获取块信息
      * @param block_id 块ID
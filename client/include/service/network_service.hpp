@@ -6,18 +6,50 @@
  */
 #pragma once
 
+#include <memory>
+#include <vector>
+#include <unordered_map>
+
 #include <QObject>
 #include <QPointer>
 #include <QTcpSocket>
 #include <QByteArray>
 
+#include "danejoe/network/flow/least_outstanding_balancer.hpp"
+
 #include "common/protocol/network_endpoint.hpp"
 #include "context/connect_context.hpp"
 
+/**
+ * @struct NetworkPoolConfig
+ * @brief 连接池配置
+ */
+struct NetworkPoolConfig
+{
+    /// @brief 单个端点的最大连接数
+    std::size_t max_connections_per_endpoint = 4;
+};
+
+/**
+ * @struct EndpointConnectPool
+ * @brief 单个端点的连接池
+ * @details 连接按需建立：所有已有连接都有在途请求且未达上限时才新建连接。
+ */
+struct EndpointConnectPool
+{
+    /// @brief 连接上下文列表（下标与负载均衡槽位一致），连接断开后置空，下次选中时重新建立
+    std::vector<std::unique_ptr<ConnectContext>> connect_contexts;
+    /// @brief 按在途字节的负载均衡器
+    DaneJoe::LeastOutstandingBalancer balancer;
+};
+
  /**
   * @class NetworkService
   * @brief 网络服务类
-  * @details 管理网络连接，处理原始数据的发送和接收，负责帧的组装和分发
+  * @details 管理网络连接，处理原始数据的发送和接收，负责帧的组装和分发。
+  *          每个端点维护一个连接池，请求分配到在途字节最少的连接；
+  *          各连接独立组装帧，响应由上层按 request_id 关联，与所经连接无关。
+  *          连接断开时其在途请求通过 connect_lost 交由上层处理。
   */
 class NetworkService :public QObject
 {
@@ -36,28 +68,86 @@ public:
      * @details 建立内部信号槽连接并准备连接上下文映射表。
      */
     void init();
+    /**
+     * @brief 设置连接池配置
+     * @param config 连接池配置
+     * @details 需在网络线程中调用，或在发出首个请求前调用；不会关闭已建立的连接。
+     */
+    void set_pool_config(const NetworkPoolConfig& config);
+    /**
+     * @brief 获取连接池配置
+     * @return 连接池配置
+     */
+    NetworkPoolConfig get_pool_config()const;
 signals:
     /**
      * @brief 接收到完整帧信号
      * @param data 组装完成的帧数据
+     * @note 在网络线程中发出，接收方需直接连接并在返回前处理完数据
      */
-    void received_frame_ready(QByteArray data);
+    void received_frame_ready(const std::vector<uint8_t>& data);
+    /**
+     * @brief 连接断开信号
+     * @param endpoint 网络端点
+     * @param request_ids 断开时在该连接上在途的请求ID，这些请求不会再收到响应
+     * @note 在网络线程中发出
+     */
+    void connect_lost(NetworkEndpoint endpoint, std::vector<uint64_t> request_ids);
 public slots:
     /**
      * @brief 处理写入原始数据请求
      * @param endpoint 网络端点，指定目标地址和端口
      * @param data 要发送的原始数据
-     * @details 如果端点不存在连接，则创建新的连接并发送数据；
-     *          如果已存在连接，则通过现有连接发送数据
+     * @details 写入在途字节最少的连接，不登记在途字节；端点尚无连接时新建连接。
      */
     void on_write_raw_data(const NetworkEndpoint& endpoint, QByteArray data);
+    /**
+     * @brief 处理写入请求帧
+     * @param endpoint 网络端点
+     * @param request_id 请求ID
+     * @param expected_bytes 期望响应的字节数
+     * @param data 已编码的请求帧
+     * @details 按最少在途字节选择连接并登记，必要时在连接池上限内新建连接。
+     */
+    void on_write_request_frame(const NetworkEndpoint& endpoint, uint64_t request_id, int64_t expected_bytes, QByteArray data);
+    /**
+     * @brief 处理请求结束
+     * @param endpoint 网络端点
+     * @param request_id 请求ID
+     * @details 收到响应或请求超时后调用，释放该请求在所属连接上登记的在途字节。
+     */
+    void on_request_finished(const NetworkEndpoint& endpoint, uint64_t request_id);
     /**
      * @brief 处理帧组装完成事件
      * @param frame 组装完成的帧数据
      * @details 当连接上下文完成帧组装后，通过此槽函数接收并转发帧数据
      */
-    void on_frame_assembled(QByteArray frame);
+    void on_frame_assembled(const std::vector<uint8_t>& frame);
+private:
+    /**
+     * @brief 选择端点上用于发送的连接
+     * @param endpoint 网络端点
+     * @return 连接池与所选连接下标
+     * @details 负载均衡器认为需要扩容且未达上限时新建连接。
+     */
+    std::pair<EndpointConnectPool&, std::size_t> select_connect(const NetworkEndpoint& endpoint);
+    /**
+     * @brief 建立到端点的连接
+     * @param endpoint 网络端点
+     * @return 连接上下文（socket 归上下文所有）
+     */
+    std::unique_ptr<ConnectContext> open_connect(const NetworkEndpoint& endpoint);
+    /**
+     * @brief 处理连接断开
+     * @param endpoint 网络端点
+     * @param connect_context 断开的连接上下文
+     * @details 从连接池中移除该连接并清空其槽位的在途请求，随后发出 connect_lost；
+     *          槽位保留，下次被选中时重新建立连接。
+     */
+    void on_connect_disconnected(const NetworkEndpoint& endpoint, ConnectContext* connect_context);
 private:
-    /// @brief 连接映射表，按网络端点组织连接上下文列表
-    std::unordered_map<NetworkEndpoint, std::vector<std::unique_ptr<ConnectContext>>> m_connect_map;
+    /// @brief 连接池配置
+    NetworkPoolConfig m_pool_config;
+    /// @brief 连接映射表，按网络端点组织连接池
+    std::unordered_map<NetworkEndpoint, EndpointConnectPool> m_connect_map;
 };
\ No newline at end of file
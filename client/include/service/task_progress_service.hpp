@@ -0,0 +1,56 @@
+/**
+ * @file task_progress_service.hpp
+ * @brief 任务进度服务
+ * @author DaneJoe001
+ * @date 2026-01-06
+ */
+#pragma once
+
+#include <cstdint>
+#include <optional>
+
+#include "model/entity/task_progress_entity.hpp"
+#include "repository/task_progress_repository.hpp"
+
+ /**
+  * @class TaskProgressService
+  * @brief 任务进度服务
+  * @details 封装对 TaskProgressRepository 的访问，提供任务已完成区间的读取与保存接口。
+  */
+class TaskProgressService
+{
+public:
+    /**
+     * @brief 构造函数
+     */
+    TaskProgressService();
+    /**
+     * @brief 析构函数
+     */
+    ~TaskProgressService();
+    /**
+     * @brief 初始化
+     */
+    void init();
+    /**
+     * @brief 获取任务进度
+     * @param task_id 任务ID
+     * @return 任务进度（不存在时返回空）
+     */
+    std::optional<TaskProgressEntity> get_by_task_id(int64_t task_id);
+    /**
+     * @brief 保存任务进度
+     * @param progress 任务进度
+     * @return 是否成功
+     */
+    bool save(const TaskProgressEntity& progress);
+    /**
+     * @brief 删除任务进度
+     * @param task_id 任务ID
+     * @return 是否成功
+     */
+    bool remove(int64_t task_id);
+private:
+    /// @brief 任务进度仓库
+    TaskProgressRepository m_task_progress_repository;
+};
@@ -0,0 +1,123 @@
+/**
+ * @file trans_correlation_table.hpp
+ * @author DaneJoe001 (danejoe001.github)
+ * @brief 请求关联表
+ * @date 2026-01-09
+ * @details request_id 由单调递增的计数器生成，在途请求的 ID 落在一个连续的窗口内，
+ *          因此以 request_id 对容量取模直接定位槽位即可，无需哈希与动态分配。
+ *          槽位按 request_id 的低位分片加锁，相邻请求落在不同分片上，发送线程与接收线程很少争用同一把锁。
+ *          槽位已被更早的在途请求占用时（在途请求数超过容量），新请求进入所在分片的溢出表，保证正确性。
+ */
+#pragma once
+
+#include <array>
+#include <mutex>
+#include <vector>
+#include <cstdint>
+#include <optional>
+#include <unordered_map>
+
+#include "danejoe/common/core/inplace_function.hpp"
+#include "danejoe/concurrent/timer/timer_manager.hpp"
+
+#include "context/trans_context.hpp"
+
+/// @brief 响应回调函数，内联存储，不分配内存
+using TransResponseCallback = DaneJoe::InplaceFunction<void(const TransContext&, std::vector<uint8_t>), 16>;
+
+ /**
+  * @struct TransCorrelation
+  * @brief 传输关联结构
+  * @details 用于关联传输上下文和响应回调函数，实现请求-响应的匹配
+  */
+struct TransCorrelation
+{
+    /// @brief 传输上下文，包含请求ID和网络端点信息
+    TransContext context;
+    /// @brief 响应回调函数，当收到响应时以 context 调用
+    TransResponseCallback callback;
+    /// @brief 该请求占用的字节额度（期望响应的数据量）
+    int64_t credit_bytes = 0;
+    /// @brief 超时定时任务句柄，收到响应时取消
+    DaneJoe::TimerHandle timeout_handle;
+};
+
+/**
+ * @class TransCorrelationTable
+ * @brief 请求关联表
+ * @details 固定容量的槽位环，按 request_id 分片加锁，线程安全。
+ */
+class TransCorrelationTable
+{
+public:
+    /**
+     * @brief 构造函数
+     * @param capacity 槽位数，向上取整为 2 的幂且不少于分片数
+     */
+    explicit TransCorrelationTable(std::size_t capacity = 4096);
+    /**
+     * @brief 插入关联
+     * @param correlation 关联，以 correlation.context.request_id 为键
+     */
+    void insert(TransCorrelation correlation);
+    /**
+     * @brief 取出并移除关联
+     * @param request_id 请求ID
+     * @return 关联，不存在时返回 std::nullopt
+     */
+    std::optional<TransCorrelation> take(uint64_t request_id);
+    /**
+     * @brief 设置超时定时任务句柄
+     * @param request_id 请求ID
+     * @param handle 句柄
+     * @return 关联存在时返回 true
+     */
+    bool set_timeout_handle(uint64_t request_id, const DaneJoe::TimerHandle& handle);
+    /**
+     * @brief 获取关联数量
+     * @return 在途关联数量
+     */
+    std::size_t size();
+private:
+    /**
+     * @struct Slot
+     * @brief 槽位
+     */
+    struct Slot
+    {
+        /// @brief 是否被占用
+        bool is_occupied = false;
+        /// @brief 关联
+        TransCorrelation correlation;
+    };
+    /**
+     * @struct Shard
+     * @brief 分片，独占缓存行以避免伪共享
+     */
+    struct alignas(64) Shard
+    {
+        /// @brief 分片锁，保护本分片的槽位与溢出表
+        std::mutex mutex;
+        /// @brief 溢出表
+        std::unordered_map<uint64_t, TransCorrelation> overflow;
+        /// @brief 本分片的关联数量
+        std::size_t size = 0;
+    };
+    /// @brief 分片数
+    static constexpr std::size_t SHARD_COUNT = 16;
+    /**
+     * @brief 查找关联
+     * @param shard 所在分片
+     * @param request_id 请求ID
+     * @return 关联指针，不存在时返回 nullptr
+     * @note 调用方需持有分片锁
+     */
+    TransCorrelation* find_locked(Shard& shard, uint64_t request_id);
+private:
+    /// @brief 槽位下标掩码
+    std::size_t m_slot_mask = 0;
+    /// @brief 槽位
+    std::vector<Slot> m_slots;
+    /// @brief 分片
+    std::array<Shard, SHARD_COUNT> m_shards;
+};
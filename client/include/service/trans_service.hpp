@@ -8,9 +8,11 @@
 
 #include <atomic>
 #include <mutex>
+#include <deque>
 #include <vector>
 #include <chrono>
 #include <cstdint>
+#include <optional>
 #include <functional>
 #include <unordered_map>
 
@@ -27,27 +29,69 @@
 #include "protocol/client_message_codec.hpp"
 #include "model/transfer/test_transfer.hpp"
 #include "model/transfer/download_transfer.hpp"
+#include "model/transfer/manifest_transfer.hpp"
+#include "model/transfer/delta_transfer.hpp"
 #include "model/transfer/block_transfer.hpp"
 #include "context/trans_context.hpp"
+#include "service/trans_correlation_table.hpp"
 
- /**
-  * @struct TransCorrelation
-  * @brief 传输关联结构
-  * @details 用于关联传输上下文和响应回调函数，实现请求-响应的匹配
-  */
-struct TransCorrelation
+/**
+ * @struct TransWindowConfig
+ * @brief 传输窗口配置
+ * @details 描述单个网络端点（单连接）上允许同时在途的请求上限。
+ *          客户端据此进行基于额度（credit）的流控，避免压垮服务端的接收队列。
+ */
+struct TransWindowConfig
 {
-    /// @brief 传输上下文，包含请求ID和网络端点信息
-    TransContext context;
-    /// @brief 响应回调函数，当收到响应时调用
-    std::function<void(std::vector<uint8_t>)> callback;
+    /// @brief 单连接最大在途请求数（实际在途数量由块调度的自适应窗口决定，此处为安全上限）
+    int64_t max_in_flight_requests = 256;
+    /// @brief 单连接最大在途字节数（按期望响应的数据量计）
+    int64_t max_in_flight_bytes = 64 * 1024 * 1024;
+};
+
+/**
+ * @struct TransPendingFrame
+ * @brief 等待额度的请求帧
+ * @details 窗口额度不足时暂存已编码的请求帧，额度释放后按入队顺序发送。
+ */
+struct TransPendingFrame
+{
+    /// @brief 请求ID
+    uint64_t request_id = 0;
+    /// @brief 该请求占用的字节额度
+    int64_t credit_bytes = 0;
+    /// @brief 已编码的请求帧
+    QByteArray data;
+};
+
+/**
+ * @struct TransWindow
+ * @brief 传输窗口
+ * @details 记录单个网络端点上的在途请求额度占用情况与等待发送的请求帧。
+ */
+struct TransWindow
+{
+    /// @brief 在途请求数
+    int64_t in_flight_requests = 0;
+    /// @brief 在途字节数
+    int64_t in_flight_bytes = 0;
+    /// @brief 等待额度的请求帧队列
+    std::deque<TransPendingFrame> pending_frames;
+    /// @brief 该端点支持的请求编码版本，收到声明支持紧凑编码的响应后升级
+    DaneJoe::SerializeVersion wire_version = DaneJoe::SerializeVersion::Named;
 };
 
 /**
  * @class TransService
  * @brief 传输服务类
  * @details 负责管理网络传输请求和响应，采用单例模式。提供测试、下载和块请求的发送功能，
- *          并管理请求-响应的关联关系，支持超时处理
+ *          并管理请求-响应的关联关系，支持超时处理。
+ *          同一连接上允许多个请求同时在途（流水线），响应可按任意顺序到达，
+ *          通过 request_id 关联；在途请求数与字节数受 TransWindowConfig 限制。
+ *          请求编码版本按端点协商：新端点使用字段名编码，该端点的响应表明支持紧凑编码后才改用紧凑编码，
+ *          同一任务的多个镜像源互不影响。
+ *          发送接口可在任意线程调用；响应在网络线程中解码并发出 *_response_received 信号，
+ *          接收方按自身所在线程决定是否排队，传输数据不经过 GUI 线程。
  */
 class TransService : public QObject
 {
@@ -68,6 +112,29 @@ public:
      * @details 执行服务的初始化操作
      */
     void init();
+    /**
+     * @brief 设置传输窗口配置
+     * @param config 窗口配置
+     * @details 新配置对之后释放/申请的额度生效，不影响已经在途的请求。
+     */
+    void set_window_config(const TransWindowConfig& config);
+    /**
+     * @brief 获取传输窗口配置
+     * @return 窗口配置
+     */
+    TransWindowConfig get_window_config();
+    /**
+     * @brief 设置连接池配置
+     * @param config 连接池配置
+     * @details 转发到网络线程执行，对之后新建的连接生效。
+     */
+    void set_connection_pool_config(const NetworkPoolConfig& config);
+    /**
+     * @brief 获取指定端点的在途请求数
+     * @param endpoint 网络端点
+     * @return 在途请求数
+     */
+    int64_t get_in_flight_count(const NetworkEndpoint& endpoint);
     /**
      * @brief 发送测试请求
      * @param endpoint 网络端点，指定目标地址和端口
@@ -88,6 +155,26 @@ public:
     TransContext send_download_request(
         const NetworkEndpoint& endpoint,
         const DownloadRequestTransfer& request);
+    /**
+     * @brief 发送分块哈希清单请求
+     * @param endpoint 网络端点，指定目标地址和端口
+     * @param request 清单请求传输对象
+     * @return 传输上下文，包含请求ID和端点信息
+     * @details 生成请求ID，注册超时处理，建立请求-响应关联，发送请求到网络服务
+     */
+    TransContext send_manifest_request(
+        const NetworkEndpoint& endpoint,
+        const ManifestRequestTransfer& request);
+    /**
+     * @brief 发送差量请求
+     * @param endpoint 网络端点，指定目标地址和端口
+     * @param request 差量请求传输对象
+     * @return 传输上下文，包含请求ID和端点信息
+     * @details 生成请求ID，注册超时处理，建立请求-响应关联，发送请求到网络服务
+     */
+    TransContext send_delta_request(
+        const NetworkEndpoint& endpoint,
+        const DeltaRequestTransfer& request);
     /**
      * @brief 发送块请求
      * @param endpoint 网络端点，指定目标地址和端口
@@ -98,6 +185,14 @@ public:
     TransContext send_block_request(
         const NetworkEndpoint& endpoint,
         const BlockRequestTransfer& request);
+    /**
+     * @brief 撤销请求
+     * @param request_id 请求ID
+     * @return 请求仍在等待响应时返回 true
+     * @details 移除请求关联并取消超时，归还其占用的额度；尚在等待额度的请求帧直接丢弃不再发送。
+     *          已发出请求的响应到达后按未知请求忽略。
+     */
+    bool cancel_request(uint64_t request_id);
 signals:
     /**
      * @brief 测试响应接收信号
@@ -115,6 +210,22 @@ signals:
     void download_response_received(
         TransContext trans_context,
         DownloadResponseTransfer response);
+    /**
+     * @brief 分块哈希清单响应接收信号
+     * @param trans_context 传输上下文，包含请求ID和端点信息
+     * @param response 清单响应传输对象
+     */
+    void manifest_response_received(
+        TransContext trans_context,
+        ManifestResponseTransfer response);
+    /**
+     * @brief 差量响应接收信号
+     * @param trans_context 传输上下文，包含请求ID和端点信息
+     * @param response 差量响应传输对象
+     */
+    void delta_response_received(
+        TransContext trans_context,
+        DeltaResponseTransfer response);
     /**
      * @brief 块响应接收信号
      * @param trans_context 传输上下文，包含请求ID和端点信息
@@ -123,6 +234,13 @@ signals:
     void block_response_received(
         TransContext trans_context,
         BlockResponseTransfer response);
+    /**
+     * @brief 请求失败信号
+     * @param trans_context 传输上下文，包含请求ID和端点信息
+     * @details 请求超时、所在连接断开或响应无法解析时发出，该请求不会再有响应信号；
+     *          调用方主动撤销（cancel_request()）的请求不发出此信号。
+     */
+    void request_failed(TransContext trans_context);
 private:
     /**
      * @brief 接收测试响应
@@ -142,6 +260,23 @@ private:
     void receive_download_response(
         TransContext trans_context,
         const std::vector<uint8_t>& data);
+    /**
+     * @brief 接收分块哈希清单响应
+     * @param trans_context 传输上下文
+     * @param data 响应数据
+     * @details 解析响应数据，发出清单响应接收信号
+     */
+    void receive_manifest_response(
+        TransContext trans_context,
+        const std::vector<uint8_t>& data);    /**
+     * @brief 接收差量响应
+     * @param trans_context 传输上下文
+     * @param data 响应数据
+     * @details 解析响应数据，发出差量响应接收信号
+     */
+    void receive_delta_response(
+        TransContext trans_context,
+        const std::vector<uint8_t>& data);
     /**
      * @brief 接收块响应
      * @param request_id 请求ID
@@ -152,33 +287,126 @@ private:
         TransContext trans_context,
         const std::vector<uint8_t>& data);
     /**
-     * @brief 移除响应处理器
+     * @brief 注册请求关联
+     * @param context 传输上下文
+     * @param credit_bytes 该请求占用的字节额度
+     * @param callback 响应回调函数
+     */
+    void add_response_handler(
+        const TransContext& context,
+        int64_t credit_bytes,
+        TransResponseCallback callback);
+    /**
+     * @brief 提交请求帧
+     * @param endpoint 网络端点
+     * @param request_id 请求ID
+     * @param credit_bytes 该请求占用的字节额度
+     * @param data 已编码的请求帧
+     * @details 窗口有额度且无排队请求时立即发送，否则进入等待队列。
+     */
+    void submit_frame(
+        const NetworkEndpoint& endpoint,
+        uint64_t request_id,
+        int64_t credit_bytes,
+        QByteArray data);
+    /**
+     * @brief 释放额度并发送等待中的请求帧
+     * @param endpoint 网络端点
+     * @param request_id 结束的请求ID
+     * @param credit_bytes 释放的字节额度
+     * @details 在收到响应或请求超时后调用，同时通知网络层释放该请求在连接上的在途字节。
+     */
+    void release_credit(const NetworkEndpoint& endpoint, uint64_t request_id, int64_t credit_bytes);
+    /**
+     * @brief 判断窗口是否有足够额度
+     * @param window 传输窗口
+     * @param credit_bytes 需要的字节额度
+     * @return 是否有足够额度
+     * @details 窗口为空时总是允许发送，避免超过字节上限的单个请求永远无法发出。调用方需持有 m_mutex。
+     */
+    bool has_credit(const TransWindow& window, int64_t credit_bytes) const;
+    /**
+     * @brief 从等待队列中移除请求帧
+     * @param endpoint 网络端点
+     * @param request_id 请求ID
+     * @return 请求帧仍在等待额度时返回 true（此时未占用额度）
+     */
+    bool remove_pending_frame(const NetworkEndpoint& endpoint, uint64_t request_id);
+    /**
+     * @brief 结束请求并归还其资源
+     * @param request_id 请求ID
+     * @return 请求的传输上下文，请求已结束时返回 std::nullopt
+     * @details 移除请求关联并取消超时，归还额度或丢弃尚未发出的请求帧。
+     */
+    std::optional<TransContext> take_request(uint64_t request_id);
+    /**
+     * @brief 获取端点的请求编码版本
+     * @param endpoint 网络端点
+     * @return 编码版本，尚未收到该端点的响应时为字段名编码
+     */
+    DaneJoe::SerializeVersion get_endpoint_wire_version(const NetworkEndpoint& endpoint);
+    /**
+     * @brief 按响应更新端点的请求编码版本
+     * @param endpoint 网络端点
+     * @param wire_version 响应表明的对端编码版本
+     */
+    void set_endpoint_wire_version(const NetworkEndpoint& endpoint, DaneJoe::SerializeVersion wire_version);
+    /**
+     * @brief 发出请求帧
+     * @param endpoint 网络端点
      * @param request_id 请求ID
-     * @details 从传输关联映射中移除指定请求ID的关联关系
+     * @param credit_bytes 该请求占用的字节额度
+     * @param data 已编码的请求帧
+     * @details 注册超时处理并发出发送信号，额度已由调用方占用。
      */
-    void remove_response_handler(uint64_t request_id);
+    void dispatch_frame(
+        const NetworkEndpoint& endpoint,
+        uint64_t request_id,
+        int64_t credit_bytes,
+        const QByteArray& data);
 signals:
     /**
-     * @brief 发送帧就绪信号
+     * @brief 发送请求帧就绪信号
+     * @param endpoint 网络端点
+     * @param request_id 请求ID
+     * @param expected_bytes 期望响应的字节数（用于连接间负载均衡）
      * @param data 要发送的帧数据
      */
-    void send_frame_ready(NetworkEndpoint endpoint, QByteArray data);
+    void send_frame_ready(NetworkEndpoint endpoint, uint64_t request_id, int64_t expected_bytes, QByteArray data);
+    /**
+     * @brief 请求结束信号
+     * @param endpoint 网络端点
+     * @param request_id 请求ID
+     */
+    void request_finished(NetworkEndpoint endpoint, uint64_t request_id);
 public slots:
     /**
      * @brief 处理接收到的帧数据
      * @param data 接收到的帧数据
-     * @details 解析响应数据，查找对应的响应处理器，执行回调并移除处理器
+     * @details 解析响应数据，查找对应的响应处理器，执行回调并移除处理器。
+     *          在网络线程中直接调用：信封与消息体的解码、响应信号的发出都不经过 GUI 线程。
+     */
+    void on_received_frame_ready(const std::vector<uint8_t>& data);
+    /**
+     * @brief 处理连接断开
+     * @param endpoint 网络端点
+     * @param request_ids 断开时在该连接上在途的请求ID
+     * @details 这些请求不会再收到响应，逐个结束以归还额度并发出 request_failed，不必等待超时。
      */
-    void on_received_frame_ready(QByteArray data);
+    void on_connect_lost(NetworkEndpoint endpoint, std::vector<uint64_t> request_ids);
 private:
-    /// @brief 互斥锁，保护传输关联映射的并发访问
+    /// @brief 互斥锁，保护传输窗口的并发访问（关联表自带分片锁）
     std::mutex m_mutex;
     /// @brief 超时间隔，请求超时的时间长度
     std::chrono::steady_clock::duration m_time_out_interval;
     /// @brief 定时器管理器引用，用于管理请求超时
     DaneJoe::TimerManager& m_timer_manager;
-    /// @brief 传输关联映射表，按请求ID组织传输关联
-    std::unordered_map<uint64_t, TransCorrelation> m_trans_correlations;
+    /// @brief 传输关联表，按请求ID组织传输关联
+    TransCorrelationTable m_trans_correlations;
+    /// @brief 传输窗口配置
+    TransWindowConfig m_window_config;
+    /// @brief 传输窗口表，按网络端点组织在途额度
+    std::unordered_map<NetworkEndpoint, TransWindow> m_trans_windows;
     /// @brief 消息编解码器，负责消息的序列化和反序列化
     ClientMessageCodec m_message_codec;
     /// @brief 请求ID计数器，用于生成唯一的请求ID
@@ -15,6 +15,8 @@
 #include "model/transfer/test_transfer.hpp"
 #include "model/transfer/block_transfer.hpp"
 #include "model/transfer/download_transfer.hpp"
+#include "model/transfer/manifest_transfer.hpp"
+#include "model/transfer/delta_transfer.hpp"
 #include "model/entity/task_entity.hpp"
 #include "context/trans_context.hpp"
 
@@ -49,9 +51,10 @@ public:
      * @param event_source 事件源上下文，标识事件的发起者
      * @param endpoint 网络端点，指定请求的目标地址和端口
      * @param request 块请求传输对象
+     * @return 事件ID，可用于撤销该请求（见 publish_cancel_request()）
      * @details 创建事件封包，生成唯一事件ID和时间戳，发出块请求信号
      */
-    void publish_block_request(
+    uint64_t publish_block_request(
         EventContext event_source,
         NetworkEndpoint endpoint,
         BlockRequestTransfer request);
@@ -66,6 +69,34 @@ public:
         EventContext event_source,
         NetworkEndpoint endpoint,
         DownloadRequestTransfer request);
+    /**
+     * @brief 发布分块哈希清单请求事件
+     * @param event_source 事件源上下文，标识事件的发起者
+     * @param endpoint 网络端点，指定请求的目标地址和端口
+     * @param request 清单请求传输对象
+     * @details 创建事件封包，生成唯一事件ID和时间戳，发出清单请求信号
+     */
+    void publish_manifest_request(
+        EventContext event_source,
+        NetworkEndpoint endpoint,
+        ManifestRequestTransfer request);
+    /**
+     * @brief 发布差量请求事件
+     * @param event_source 事件源上下文，标识事件的发起者
+     * @param endpoint 网络端点，指定请求的目标地址和端口
+     * @param request 差量请求传输对象
+     * @details 创建事件封包，生成唯一事件ID和时间戳，发出差量请求信号
+     */
+    void publish_delta_request(
+        EventContext event_source,
+        NetworkEndpoint endpoint,
+        DeltaRequestTransfer request);
+    /**
+     * @brief 发布撤销请求事件
+     * @param event_id 请求事件的事件ID
+     * @details 请求方不再需要响应时调用（例如块请求超时后重新调度），释放该请求占用的传输资源。
+     */
+    void publish_cancel_request(uint64_t event_id);
     /**
      * @brief 发布测试响应事件
      * @param event_envelope 事件封包，包含原始请求的事件信息
@@ -86,6 +117,26 @@ public:
     void publish_download_response(EventEnvelope event_envelope,
         TransContext trans_context,
         DownloadResponseTransfer response);
+    /**
+     * @brief 发布分块哈希清单响应事件
+     * @param event_envelope 事件封包，包含原始请求的事件信息
+     * @param trans_context 传输上下文，包含请求ID和端点信息
+     * @param response 清单响应传输对象
+     * @details 直接发出清单响应信号，用于响应匹配和事件追踪
+     */
+    void publish_manifest_response(EventEnvelope event_envelope,
+        TransContext trans_context,
+        ManifestResponseTransfer response);
+    /**
+     * @brief 发布差量响应事件
+     * @param event_envelope 事件封包，包含原始请求的事件信息
+     * @param trans_context 传输上下文，包含请求ID和端点信息
+     * @param response 差量响应传输对象
+     * @details 直接发出差量响应信号，用于响应匹配和事件追踪
+     */
+    void publish_delta_response(EventEnvelope event_envelope,
+        TransContext trans_context,
+        DeltaResponseTransfer response);
     /**
      * @brief 发布块响应事件
      * @param event_envelope 事件封包，包含原始请求的事件信息
@@ -108,6 +159,14 @@ public:
      * @details 通知外部新增任务实体，可用于在界面中追加显示。
      */
     void publish_task_entity_add(TaskEntity task_entity);
+    /**
+     * @brief 发布任务进度事件
+     * @param task_id 任务ID
+     * @param completed_bytes 已完成字节数
+     * @param total_bytes 文件总字节数
+     * @details 由块调度按固定频率合并发布，界面无需跟随每个块刷新。
+     */
+    void publish_task_progress(int64_t task_id, int64_t completed_bytes, int64_t total_bytes);
 signals:
     /**
      * @brief 任务更新信号
@@ -119,6 +178,13 @@ signals:
      * @param task_entity 任务实体
      */
     void task_entity_add(TaskEntity task_entity);
+    /**
+     * @brief 任务进度信号
+     * @param task_id 任务ID
+     * @param completed_bytes 已完成字节数
+     * @param total_bytes 文件总字节数
+     */
+    void task_progress(int64_t task_id, int64_t completed_bytes, int64_t total_bytes);
     /**
      * @brief 测试请求信号
      * @param event_envelope 事件封包，包含事件ID、上下文和时间戳
@@ -149,6 +215,31 @@ signals:
         EventEnvelope event_envelope,
         NetworkEndpoint endpoint,
         DownloadRequestTransfer request);
+    /**
+     * @brief 分块哈希清单请求信号
+     * @param event_envelope 事件封包，包含事件ID、上下文和时间戳
+     * @param endpoint 网络端点，指定请求的目标地址和端口
+     * @param request 清单请求传输对象
+     */
+    void manifest_request(
+        EventEnvelope event_envelope,
+        NetworkEndpoint endpoint,
+        ManifestRequestTransfer request);
+    /**
+     * @brief 差量请求信号
+     * @param event_envelope 事件封包，包含事件ID、上下文和时间戳
+     * @param endpoint 网络端点，指定请求的目标地址和端口
+     * @param request 差量请求传输对象
+     */
+    void delta_request(
+        EventEnvelope event_envelope,
+        NetworkEndpoint endpoint,
+        DeltaRequestTransfer request);
+    /**
+     * @brief 撤销请求信号
+     * @param event_id 请求事件的事件ID
+     */
+    void cancel_request(uint64_t event_id);
     /**
      * @brief 测试响应信号
      * @param event_envelope 事件封包，包含原始请求的事件信息
@@ -169,6 +260,26 @@ signals:
         EventEnvelope event_envelope, 
         TransContext trans_context,
         DownloadResponseTransfer response);
+    /**
+     * @brief 分块哈希清单响应信号
+     * @param event_envelope 事件封包，包含原始请求的事件信息
+     * @param trans_context 传输上下文，包含请求ID和端点信息
+     * @param response 清单响应传输对象
+     */
+    void manifest_response(
+        EventEnvelope event_envelope,
+        TransContext trans_context,
+        ManifestResponseTransfer response);
+    /**
+     * @brief 差量响应信号
+     * @param event_envelope 事件封包，包含原始请求的事件信息
+     * @param trans_context 传输上下文，包含请求ID和端点信息
+     * @param response 差量响应传输对象
+     */
+    void delta_response(
+        EventEnvelope event_envelope,
+        TransContext trans_context,
+        DeltaResponseTransfer response);
     /**
      * @brief 块响应信号
      * @param event_envelope 事件封包，包含原始请求的事件信息
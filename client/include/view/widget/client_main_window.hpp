@@ -77,6 +77,16 @@ public:
         EventContext event_context,
         NetworkEndpoint endpoint,
         TaskEntity task_entity);
+    /**
+     * @brief 任务镜像源添加信号
+     * @param task_id 任务ID
+     * @param endpoint 镜像源网络端点
+     * @param file_id 镜像源上的文件ID
+     */
+    void task_source_add(
+        int64_t task_id,
+        NetworkEndpoint endpoint,
+        int64_t file_id);
 public slots:
     /**
      * @brief 连接测试动作触发
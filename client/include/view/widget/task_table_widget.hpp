@@ -59,6 +59,13 @@ public slots:
      */
     void on_task_entity_add(TaskEntity task_entity);
     void on_task_update(int64_t task_id);
+    /**
+     * @brief 任务进度槽函数
+     * @param task_id 任务ID
+     * @param completed_bytes 已完成字节数
+     * @param total_bytes 文件总字节数
+     */
+    void on_task_progress(int64_t task_id, int64_t completed_bytes, int64_t total_bytes);
 private:
     /// @brief 是否已初始化
     bool m_is_init = false;
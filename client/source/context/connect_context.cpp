@@ -6,6 +6,7 @@ ConnectContext::ConnectContext(QTcpSocket* socket, QObject* parent) : QObject(pa
     connect(m_socket, &QTcpSocket::connected, this, &ConnectContext::on_socket_write);
     connect(m_socket, &QTcpSocket::readyRead, this, &ConnectContext::on_socket_read);
     connect(m_socket, &QTcpSocket::disconnected, this, &ConnectContext::on_socket_disconnected);
+    connect(m_socket, &QTcpSocket::errorOccurred, this, &ConnectContext::on_socket_error);
     connect(m_socket, &QTcpSocket::bytesWritten, this, &ConnectContext::on_socket_write);
 }
 
@@ -48,18 +49,41 @@ void ConnectContext::on_socket_read()
     DANEJOE_LOG_DEBUG("default", "ConnectContext", "Socket ready read");
     auto data = m_socket->readAll();
     std::vector<uint8_t> vec(data.begin(), data.end());
-    m_frame_assembler.push_data(vec);
+    if (!m_frame_assembler.push_data(vec))
+    {
+        DANEJOE_LOG_ERROR("default", "ConnectContext", "Frame limit exceeded, abort connection");
+        m_socket->abort();
+        return;
+    }
     while (auto frame_opt = m_frame_assembler.pop_frame())
     {
         if (frame_opt.has_value())
         {
-            QByteArray frame_data(reinterpret_cast<const char*>(frame_opt.value().data()), frame_opt.value().size());
-            emit frame_assembled(frame_data);
+            emit frame_assembled(frame_opt.value());
         }
     }
 }
 
 void ConnectContext::on_socket_disconnected()
 {
+    if (m_is_disconnected)
+    {
+        return;
+    }
+    m_is_disconnected = true;
     emit socket_disconnected();
+}
+
+void ConnectContext::on_socket_error(QAbstractSocket::SocketError error)
+{
+    if (!m_socket)
+    {
+        return;
+    }
+    DANEJOE_LOG_WARN("default", "ConnectContext", "Socket error {}: {}", static_cast<int>(error), m_socket->errorString().toStdString());
+    // 已建立的连接出错后会再发出 disconnected，这里只处理连接失败
+    if (m_socket->state() == QAbstractSocket::UnconnectedState)
+    {
+        on_socket_disconnected();
+    }
 }
\ No newline at end of file
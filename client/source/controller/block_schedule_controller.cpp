@@ -1,9 +1,15 @@
 #include <QDir>
-#include <QFile>
 #include <QFileInfo>
 #include <QMutexLocker>
 
+#include <cctype>
+#include <format>
+#include <fstream>
+#include <algorithm>
+#include <filesystem>
+
 #include "danejoe/logger/logger_manager.hpp"
+#include "danejoe/common/delta/file_delta.hpp"
 
 #include "controller/block_schedule_controller.hpp"
 #include "model/transfer/block_transfer.hpp"
@@ -13,12 +19,16 @@ using namespace std::literals;
 BlockScheduleController::BlockScheduleController(
     BlockService& block_service,
     TaskService& task_service,
+    ClientFileService& client_file_service,
+    TaskProgressService& task_progress_service,
     QPointer<ViewEventHub> view_event_hub,
     QObject* parent) :
     QObject(parent),
     m_view_event_hub(view_event_hub),
     m_block_service(block_service),
-    m_task_service(task_service)
+    m_task_service(task_service),
+    m_client_file_service(client_file_service),
+    m_task_progress_service(task_progress_service)
 
 {}
 
@@ -29,11 +39,22 @@ void BlockScheduleController::init()
         DANEJOE_LOG_WARN("default", "BlockScheduleController", "Failed to init: Has been inited");
         return;
     }
-    m_block_request_timer = new QTimer(this);
-    m_block_request_timer->start(m_block_request_interval_ms);
-    connect(m_block_request_timer, &QTimer::timeout, this, &BlockScheduleController::on_block_request);
+    // 块超时远大于一般 RTT，避免排队造成的时延抖动引发误判
+    m_window_config.min_retransmit_timeout = 5000ms;
+    m_block_timeout_timer = new QTimer(this);
+    m_block_timeout_timer->start(m_block_timeout_check_interval_ms);
+    connect(m_block_timeout_timer, &QTimer::timeout, this, &BlockScheduleController::on_block_timeout);
+    m_progress_flush_timer = new QTimer(this);
+    m_progress_flush_timer->start(m_progress_flush_interval_ms);
+    connect(m_progress_flush_timer, &QTimer::timeout, this, &BlockScheduleController::on_progress_flush);
+    m_progress_notify_timer = new QTimer(this);
+    m_progress_notify_timer->start(m_progress_notify_interval_ms);
+    connect(m_progress_notify_timer, &QTimer::timeout, this, &BlockScheduleController::on_progress_notify);
     m_is_init = true;
     connect(m_view_event_hub, &ViewEventHub::block_response, this, &BlockScheduleController::on_block_response);
+    connect(m_view_event_hub, &ViewEventHub::download_response, this, &BlockScheduleController::on_download_response);
+    connect(m_view_event_hub, &ViewEventHub::manifest_response, this, &BlockScheduleController::on_manifest_response);
+    connect(m_view_event_hub, &ViewEventHub::delta_response, this, &BlockScheduleController::on_delta_response);
 }
 
 void BlockScheduleController::on_task_enqueue(
@@ -41,24 +62,76 @@ void BlockScheduleController::on_task_enqueue(
     NetworkEndpoint endpoint,
     TaskEntity task_entity)
 {
-    auto blocks =
-        m_block_service.get_by_task_id(task_entity.task_id);
+    auto file_entity_opt =
+        m_client_file_service.get_by_file_id(static_cast<int32_t>(task_entity.file_id));
+    if (!file_entity_opt.has_value())
+    {
+        DANEJOE_LOG_WARN("default", "BlockScheduleController", "Failed to enqueue task {}: file {} not found", task_entity.task_id, task_entity.file_id);
+        return;
+    }
+    auto task_pendding_it = m_task_pendding_map.find(task_entity.task_id);
+    if (task_pendding_it != m_task_pendding_map.end())
+    {
+        release_in_flight_blocks(task_pendding_it->second);
+        close_dest_file(task_pendding_it->second);
+    }
     TaskPending task_pendding;
-    task_pendding.endpoint = endpoint;
     task_pendding.event_source = event_source;
     task_pendding.task_entity = task_entity;
     task_pendding.is_paused = false;
+    task_pendding.md5_code = file_entity_opt.value().md5_code;
+    task_pendding.file_size = file_entity_opt.value().file_size;
+    task_pendding.sources.push_back(TaskSource{ endpoint, task_entity.file_id });
+    auto progress_opt = m_task_progress_service.get_by_task_id(task_entity.task_id);
+    if (progress_opt.has_value())
+    {
+        task_pendding.progress = std::move(progress_opt.value());
+    }
+    else
+    {
+        // 尚无进度记录时兼容旧版本的逐块记录
+        for (const auto& block : m_block_service.get_by_task_id_and_block_state(task_entity.task_id, BlockState::Completed))
+        {
+            task_pendding.progress.add_completed(block.offset, block.block_size);
+        }
+    }
+    task_pendding.progress.task_id = task_entity.task_id;
+    DaneJoe::Md5 resumed_md5;
+    if (!task_pendding.progress.digest_state.empty() && resumed_md5.load_state(task_pendding.progress.digest_state))
+    {
+        // 摘要快照在同步之后获取，其覆盖的前缀必然已落盘
+        task_pendding.progress.add_completed(0, std::min(static_cast<int64_t>(resumed_md5.get_size()), task_pendding.file_size));
+    }
+    else
+    {
+        task_pendding.progress.digest_state.clear();
+    }
+    // 恢复时只需按已完成区间求出缺失区间，与历史块数量无关
+    task_pendding.completed_bytes = task_pendding.progress.get_completed_bytes();
+    task_pendding.is_progress_changed = true;
+    for (const auto& range : task_pendding.progress.get_missing_ranges(task_pendding.file_size))
+    {
+        task_pendding.unrequested_ranges.push_back(range);
+    }
+    bool is_completed = task_pendding.completed_bytes >= task_pendding.file_size;
+    auto basis_path = is_completed ? std::string() : find_delta_basis(task_pendding, file_entity_opt.value().file_name);
     m_task_pendding_map[task_entity.task_id] = std::move(task_pendding);
-    for (auto block : blocks)
+    if (!basis_path.empty())
     {
-        BlockRequestTransfer transfer;
-        transfer.block_id = block.block_id;
-        transfer.file_id = block.file_id;
-        transfer.task_id = block.task_id;
-        transfer.offset = block.offset;
-        transfer.block_size = block.block_size;
-        m_block_request_transfer_queue.enqueue(transfer);
+        start_delta(m_task_pendding_map[task_entity.task_id], basis_path);
     }
+    get_endpoint_schedule(endpoint);
+    if (!is_completed)
+    {
+        // 清单到达前切出的块只做整体 MD5 校验
+        EventContext event_context;
+        event_context.m_object_name = MANIFEST_OBJECT_NAME;
+        ManifestRequestTransfer request;
+        request.file_id = task_entity.file_id;
+        request.task_id = task_entity.task_id;
+        m_view_event_hub->publish_manifest_request(event_context, endpoint, request);
+    }
+    on_block_request();
 }
 
 void BlockScheduleController::on_task_cancle(int64_t task_id)
@@ -69,7 +142,10 @@ void BlockScheduleController::on_task_cancle(int64_t task_id)
     {
         return;
     }
+    release_in_flight_blocks(task_schedule_it->second);
+    close_dest_file(task_schedule_it->second);
     m_task_pendding_map.erase(task_schedule_it);
+    on_block_request();
 }
 
 void BlockScheduleController::on_task_paused(int64_t task_id, bool is_paused)
@@ -80,30 +156,367 @@ void BlockScheduleController::on_task_paused(int64_t task_id, bool is_paused)
     {
         return;
     }
-    m_task_pendding_map[task_id].is_paused = is_paused;
+    task_schedule_it->second.is_paused = is_paused;
+    // 暂停或恢复都会改变端点上活跃任务的份额
+    on_block_request();
 }
 
-void BlockScheduleController::on_block_request()
+void BlockScheduleController::on_task_source_add(int64_t task_id, NetworkEndpoint endpoint, int64_t file_id)
+{
+    auto task_pendding_it = m_task_pendding_map.find(task_id);
+    if (task_pendding_it == m_task_pendding_map.end())
+    {
+        DANEJOE_LOG_WARN("default", "BlockScheduleController", "Failed to add source: task {} not found", task_id);
+        return;
+    }
+    auto& task_pendding = task_pendding_it->second;
+    auto is_same_endpoint = [&endpoint](const TaskSource& source)
+        {
+            return source.endpoint == endpoint;
+        };
+    if (std::any_of(task_pendding.sources.begin(), task_pendding.sources.end(), is_same_endpoint) ||
+        std::any_of(task_pendding.unverified_sources.begin(), task_pendding.unverified_sources.end(), is_same_endpoint))
+    {
+        return;
+    }
+    task_pendding.unverified_sources.push_back(TaskSource{ endpoint, file_id });
+    EventContext event_context;
+    event_context.m_object_name = SOURCE_CHECK_OBJECT_NAME;
+    DownloadRequestTransfer request;
+    request.file_id = file_id;
+    request.task_id = task_id;
+    m_view_event_hub->publish_download_request(event_context, endpoint, request);
+}
+
+void BlockScheduleController::on_download_response(
+    EventEnvelope event_envelope,
+    TransContext trans_context,
+    DownloadResponseTransfer response)
 {
-    if (m_block_request_transfer_queue.empty())
+    if (event_envelope.m_event_context.m_object_name != SOURCE_CHECK_OBJECT_NAME)
     {
         return;
     }
-    auto transfer =
-        m_block_request_transfer_queue.dequeue();
-    auto task_penddind_it = m_task_pendding_map.find(transfer.task_id);
-    if (task_penddind_it == m_task_pendding_map.end())
+    auto task_pendding_it = m_task_pendding_map.find(response.task_id);
+    if (task_pendding_it == m_task_pendding_map.end())
     {
         return;
     }
-    if (task_penddind_it->second.is_paused)
+    auto& task_pendding = task_pendding_it->second;
+    auto source_it = std::find_if(task_pendding.unverified_sources.begin(), task_pendding.unverified_sources.end(),
+        [&trans_context](const TaskSource& source)
+        {
+            return source.endpoint == trans_context.endpoint;
+        });
+    if (source_it == task_pendding.unverified_sources.end())
+    {
+        return;
+    }
+    auto source = *source_it;
+    task_pendding.unverified_sources.erase(source_it);
+    if (response.md5_code.empty() ||
+        response.md5_code != task_pendding.md5_code ||
+        response.file_size != task_pendding.file_size)
     {
-        m_block_request_transfer_queue.enqueue(transfer);
+        DANEJOE_LOG_WARN("default", "BlockScheduleController", "Rejected source {}:{} for task {}: md5 {} size {}, expected md5 {} size {}",
+            source.endpoint.ip, source.endpoint.port, response.task_id,
+            response.md5_code, response.file_size,
+            task_pendding.md5_code, task_pendding.file_size);
         return;
     }
-    m_view_event_hub->publish_block_request(
-        task_penddind_it->second.event_source,
-        task_penddind_it->second.endpoint, transfer);
+    source.file_id = response.file_id;
+    task_pendding.sources.push_back(source);
+    get_endpoint_schedule(source.endpoint);
+    DANEJOE_LOG_INFO("default", "BlockScheduleController", "Added source {}:{} for task {}, sources: {}",
+        source.endpoint.ip, source.endpoint.port, response.task_id, task_pendding.sources.size());
+    on_block_request();
+}
+
+void BlockScheduleController::on_manifest_response(
+    EventEnvelope event_envelope,
+    TransContext trans_context,
+    ManifestResponseTransfer response)
+{
+    if (event_envelope.m_event_context.m_object_name != MANIFEST_OBJECT_NAME)
+    {
+        return;
+    }
+    auto task_pendding_it = m_task_pendding_map.find(response.task_id);
+    if (task_pendding_it == m_task_pendding_map.end())
+    {
+        return;
+    }
+    auto& task_pendding = task_pendding_it->second;
+    if (response.chunk_hashes.empty())
+    {
+        DANEJOE_LOG_DEBUG("default", "BlockScheduleController", "No manifest for task {} on {}:{}",
+            response.task_id, trans_context.endpoint.ip, trans_context.endpoint.port);
+        return;
+    }
+    DaneJoe::ChunkManifest manifest;
+    manifest.file_size = response.file_size;
+    manifest.chunk_size = response.chunk_size;
+    if (!manifest.set_hash_bytes(response.chunk_hashes) ||
+        !manifest.is_valid() ||
+        manifest.file_size != task_pendding.file_size)
+    {
+        DANEJOE_LOG_WARN("default", "BlockScheduleController", "Rejected manifest for task {}: size {} chunk size {}, expected size {}",
+            response.task_id, response.file_size, response.chunk_size, task_pendding.file_size);
+        return;
+    }
+    DANEJOE_LOG_INFO("default", "BlockScheduleController", "Received manifest for task {}: {} chunks of {} bytes",
+        response.task_id, manifest.get_chunk_count(), manifest.chunk_size);
+    task_pendding.manifest = std::move(manifest);
+    if (task_pendding.completed_bytes > 0 && !task_pendding.is_verifying_resume)
+    {
+        start_resume_verify(task_pendding);
+    }
+}
+
+void BlockScheduleController::start_resume_verify(TaskPending& task_pendding)
+{
+    task_pendding.is_verifying_resume = true;
+    int64_t task_id = task_pendding.task_entity.task_id;
+    DANEJOE_LOG_INFO("default", "BlockScheduleController", "Verifying {} completed bytes of task {} against manifest",
+        task_pendding.completed_bytes, task_id);
+    run_delta_job([this, task_id, path = task_pendding.task_entity.saved_path,
+        manifest = task_pendding.manifest.value(), completed_ranges = task_pendding.progress.get_completed_ranges()]()
+        {
+            std::vector<std::pair<int64_t, int64_t>> mismatched_ranges;
+            std::ifstream file(path, std::ios::binary);
+            std::vector<uint8_t> buffer;
+            for (const auto& [begin, end] : completed_ranges)
+            {
+                // 只校验被已完成区间完整覆盖的清单块
+                for (int64_t index = (begin + manifest.chunk_size - 1) / manifest.chunk_size; index < manifest.get_chunk_count(); index++)
+                {
+                    auto [chunk_begin, chunk_end] = manifest.get_chunk_range(index);
+                    if (chunk_end > end)
+                    {
+                        break;
+                    }
+                    buffer.resize(static_cast<std::size_t>(chunk_end - chunk_begin));
+                    file.clear();
+                    file.seekg(chunk_begin);
+                    file.read(reinterpret_cast<char*>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+                    if (file.gcount() == static_cast<std::streamsize>(buffer.size()) &&
+                        manifest.verify_chunk(index, buffer.data(), buffer.size()))
+                    {
+                        continue;
+                    }
+                    if (!mismatched_ranges.empty() && mismatched_ranges.back().second == chunk_begin)
+                    {
+                        mismatched_ranges.back().second = chunk_end;
+                    }
+                    else
+                    {
+                        mismatched_ranges.emplace_back(chunk_begin, chunk_end);
+                    }
+                }
+            }
+            QMetaObject::invokeMethod(this, [this, task_id, mismatched_ranges = std::move(mismatched_ranges)]()
+                {
+                    on_resume_verified(task_id, mismatched_ranges);
+                }, Qt::QueuedConnection);
+        });
+}
+
+void BlockScheduleController::on_resume_verified(int64_t task_id, std::vector<std::pair<int64_t, int64_t>> mismatched_ranges)
+{
+    auto task_pendding_it = m_task_pendding_map.find(task_id);
+    if (task_pendding_it == m_task_pendding_map.end() || !task_pendding_it->second.is_verifying_resume)
+    {
+        return;
+    }
+    auto& task_pendding = task_pendding_it->second;
+    task_pendding.is_verifying_resume = false;
+    if (!mismatched_ranges.empty())
+    {
+        int64_t mismatched_bytes = 0;
+        for (const auto& [begin, end] : mismatched_ranges)
+        {
+            mismatched_bytes += end - begin;
+            task_pendding.progress.remove_completed(begin, end - begin);
+            if (task_pendding.dest_file_id.has_value())
+            {
+                m_file_writer.invalidate_range(task_pendding.dest_file_id.value(), begin, end);
+            }
+            task_pendding.unrequested_ranges.emplace_back(begin, end);
+        }
+        std::sort(task_pendding.unrequested_ranges.begin(), task_pendding.unrequested_ranges.end());
+        // 保存的摘要可能已覆盖不一致的数据；文件已打开时由写入器从头重算，下一个检查点会覆盖该状态
+        task_pendding.progress.digest_state.clear();
+        task_pendding.completed_bytes = task_pendding.progress.get_completed_bytes();
+        task_pendding.is_progress_changed = true;
+        task_pendding.unflushed_blocks++;
+        DANEJOE_LOG_WARN("default", "BlockScheduleController", "Task {}: {} resumed bytes in {} ranges mismatch the manifest, re-downloading",
+            task_id, mismatched_bytes, mismatched_ranges.size());
+        flush_progress(task_pendding);
+    }
+    else
+    {
+        DANEJOE_LOG_INFO("default", "BlockScheduleController", "Resumed ranges of task {} match the manifest", task_id);
+    }
+    check_task_completed(task_pendding);
+    on_block_request();
+}
+
+void BlockScheduleController::on_delta_response(
+    EventEnvelope event_envelope,
+    TransContext trans_context,
+    DeltaResponseTransfer response)
+{
+    if (event_envelope.m_event_context.m_object_name != DELTA_OBJECT_NAME)
+    {
+        return;
+    }
+    auto task_pendding_it = m_task_pendding_map.find(response.task_id);
+    if (task_pendding_it == m_task_pendding_map.end() || task_pendding_it->second.delta_basis_path.empty())
+    {
+        return;
+    }
+    auto& task_pendding = task_pendding_it->second;
+    if (response.delta.empty())
+    {
+        fallback_from_delta(task_pendding, "no delta from source");
+        return;
+    }
+    if (response.file_size != task_pendding.file_size || response.md5_code != task_pendding.md5_code)
+    {
+        fallback_from_delta(task_pendding, std::format("file changed on source: md5 {} size {}", response.md5_code, response.file_size));
+        return;
+    }
+    DANEJOE_LOG_INFO("default", "BlockScheduleController", "Received delta for task {} from {}:{}: {} bytes for a {} byte file",
+        response.task_id, trans_context.endpoint.ip, trans_context.endpoint.port, response.delta.size(), response.file_size);
+    // 重建到临时文件，校验通过后再替换目标文件；基准文件可能就是目标文件本身
+    int64_t task_id = task_pendding.task_entity.task_id;
+    uint64_t delta_id = task_pendding.delta_id;
+    std::string basis_path = task_pendding.delta_basis_path;
+    std::string output_path = task_pendding.task_entity.saved_path + ".delta";
+    run_delta_job([this, task_id, delta_id, basis_path, output_path, delta_bytes = std::move(response.delta)]()
+        {
+            std::optional<DaneJoe::Md5> md5;
+            auto delta_opt = DaneJoe::FileDelta::decode(delta_bytes);
+            if (delta_opt.has_value())
+            {
+                md5 = delta_opt->apply(basis_path, output_path);
+            }
+            QMetaObject::invokeMethod(this, [this, task_id, delta_id, output_path, md5 = std::move(md5)]()
+                {
+                    on_delta_applied(task_id, delta_id, output_path, md5);
+                }, Qt::QueuedConnection);
+        });
+}
+
+void BlockScheduleController::on_block_request()
+{
+    // 统计各端点上的活跃任务数，用于均分窗口
+    std::unordered_map<NetworkEndpoint, int64_t> active_task_counts;
+    for (const auto& [task_id, task_pendding] : m_task_pendding_map)
+    {
+        if (task_pendding.is_paused || !task_pendding.delta_basis_path.empty() ||
+            task_pendding.completed_bytes >= task_pendding.file_size)
+        {
+            continue;
+        }
+        for (const auto& source : task_pendding.sources)
+        {
+            active_task_counts[source.endpoint]++;
+        }
+    }
+    if (active_task_counts.empty())
+    {
+        return;
+    }
+    // 轮流为各任务的各个源发出一个请求，直到所有端点窗口填满或无可发请求
+    bool is_dispatched = true;
+    while (is_dispatched)
+    {
+        is_dispatched = false;
+        for (auto& [task_id, task_pendding] : m_task_pendding_map)
+        {
+            if (task_pendding.is_paused || !task_pendding.delta_basis_path.empty())
+            {
+                continue;
+            }
+            for (const auto& source : task_pendding.sources)
+            {
+                auto& schedule = get_endpoint_schedule(source.endpoint);
+                if (!schedule.window.can_send())
+                {
+                    continue;
+                }
+                int64_t active_task_count = std::max<int64_t>(1, active_task_counts[source.endpoint]);
+                int64_t task_share = std::max<int64_t>(1, (schedule.window.get_window() + active_task_count - 1) / active_task_count);
+                if (task_pendding.in_flight_counts[source.endpoint] >= task_share)
+                {
+                    continue;
+                }
+                std::optional<BlockRequestTransfer> transfer_opt;
+                if (has_block_to_request(task_pendding))
+                {
+                    transfer_opt = take_block_request(task_pendding, schedule.block_size);
+                }
+                else if (task_pendding.sources.size() > 1)
+                {
+                    transfer_opt = take_straggler_block(task_pendding, source.endpoint);
+                }
+                if (!transfer_opt.has_value())
+                {
+                    continue;
+                }
+                dispatch_block_request(task_pendding, source, transfer_opt.value());
+                is_dispatched = true;
+            }
+        }
+    }
+}
+
+void BlockScheduleController::on_block_timeout()
+{
+    auto now = std::chrono::steady_clock::now();
+    bool is_requeued = false;
+    for (auto& [task_id, task_pendding] : m_task_pendding_map)
+    {
+        if (!task_pendding.delta_basis_path.empty() && now - task_pendding.delta_start_time > m_delta_timeout)
+        {
+            fallback_from_delta(task_pendding, "timed out");
+        }
+        for (auto block_it = task_pendding.in_flight_blocks.begin(); block_it != task_pendding.in_flight_blocks.end();)
+        {
+            auto& requests = block_it->second.requests;
+            for (auto request_it = requests.begin(); request_it != requests.end();)
+            {
+                auto& schedule = get_endpoint_schedule(request_it->endpoint);
+                if (now - request_it->sent_time < schedule.window.get_retransmit_timeout())
+                {
+                    ++request_it;
+                    continue;
+                }
+                DANEJOE_LOG_WARN("default", "BlockScheduleController", "Block {} of task {} timed out on {}:{}",
+                    block_it->first, task_id, request_it->endpoint.ip, request_it->endpoint.port);
+                schedule.window.on_lost();
+                schedule.block_size.on_block_lost();
+                task_pendding.in_flight_counts[request_it->endpoint]--;
+                // 归还传输层额度，迟到的响应按未知请求丢弃
+                m_view_event_hub->publish_cancel_request(request_it->event_id);
+                request_it = requests.erase(request_it);
+                is_requeued = true;
+            }
+            if (!requests.empty())
+            {
+                ++block_it;
+                continue;
+            }
+            // 所有源上的请求都已超时，重新排入队首
+            task_pendding.pending_blocks.push_front(block_it->second.transfer);
+            block_it = task_pendding.in_flight_blocks.erase(block_it);
+        }
+    }
+    if (is_requeued)
+    {
+        on_block_request();
+    }
 }
 
 void BlockScheduleController::on_block_response(
@@ -119,94 +532,696 @@ void BlockScheduleController::on_block_response(
         DANEJOE_LOG_WARN("default", "BlockScheduleController", "Failed to find task!");
         return;
     }
-    auto block_entity_opt =
-        m_block_service.get_by_id(response.block_id);
-    if (!block_entity_opt.has_value())
+    auto& task_pendding = task_pendding_it->second;
+    auto in_flight_it = task_pendding.in_flight_blocks.find(response.block_id);
+    if (in_flight_it != task_pendding.in_flight_blocks.end())
     {
-        return;
+        auto now = std::chrono::steady_clock::now();
+        auto bytes = static_cast<int64_t>(response.data.size());
+        for (const auto& request : in_flight_it->second.requests)
+        {
+            auto& schedule = get_endpoint_schedule(request.endpoint);
+            task_pendding.in_flight_counts[request.endpoint]--;
+            if (request.endpoint == trans_context.endpoint)
+            {
+                auto latency = std::chrono::duration_cast<std::chrono::nanoseconds>(now - request.sent_time);
+                schedule.window.on_acked(latency, bytes);
+                schedule.block_size.on_block_completed(bytes, latency);
+            }
+            else
+            {
+                // 另一个源上的重复请求已无意义，撤销后其迟到的响应将被忽略
+                schedule.window.on_cancelled();
+                m_view_event_hub->publish_cancel_request(request.event_id);
+            }
+        }
+        task_pendding.in_flight_blocks.erase(in_flight_it);
     }
-    auto block_entity = block_entity_opt.value();
-    QFileInfo dest_file_info(QString::fromStdString(task_pendding_it->second.task_entity.saved_path));
-    if (!task_pendding_it->second.dest_file)
+    else
     {
-        task_pendding_it->second.dest_file = std::make_unique<QFile>(dest_file_info.absoluteFilePath());
+        // 超时后迟到的响应：块已重新排队，收到数据后无需再次请求
+        auto pending_it = std::find_if(task_pendding.pending_blocks.begin(), task_pendding.pending_blocks.end(),
+            [&response](const BlockRequestTransfer& transfer)
+            {
+                return transfer.block_id == response.block_id;
+            });
+        if (pending_it == task_pendding.pending_blocks.end())
+        {
+            // 既不在途也不待重发：重复响应，块已处理
+            return;
+        }
+        task_pendding.pending_blocks.erase(pending_it);
     }
-    if (!task_pendding_it->second.dest_file->isOpen())
+    save_block_response(task_pendding, response, trans_context.endpoint);
+    check_task_completed(task_pendding);
+    on_block_request();
+}
+
+std::string BlockScheduleController::find_delta_basis(const TaskPending& task_pendding, const std::string& file_name)
+{
+    // 只对尚无进度且可校验的任务使用差量，否则无法确认重建结果
+    if (task_pendding.md5_code.empty() || task_pendding.file_size <= 0 ||
+        task_pendding.completed_bytes > 0 || !task_pendding.progress.digest_state.empty())
+    {
+        return {};
+    }
+    auto is_usable = [](const std::string& path)
+        {
+            std::error_code error_code;
+            return !path.empty() &&
+                std::filesystem::is_regular_file(path, error_code) &&
+                std::filesystem::file_size(path, error_code) > 0 && !error_code;
+        };
+    const auto& task_entity = task_pendding.task_entity;
+    if (is_usable(task_entity.saved_path))
+    {
+        return task_entity.saved_path;
+    }
+    std::optional<TaskEntity> latest_task;
+    for (const auto& task : m_task_service.get_all())
     {
-        QDir dir = dest_file_info.absoluteDir();
-        if (!dir.exists())
+        if (task.task_id == task_entity.task_id ||
+            task.operation != Operation::Download ||
+            task.state != TaskState::Completed ||
+            (latest_task.has_value() && task.end_time <= latest_task->end_time) ||
+            !is_usable(task.saved_path))
         {
-            auto is_mkdir = dir.mkpath(".");
-            if (!is_mkdir)
+            continue;
+        }
+        auto file_entity_opt = m_client_file_service.get_by_file_id(static_cast<int32_t>(task.file_id));
+        if (file_entity_opt.has_value() && file_entity_opt->file_name == file_name)
+        {
+            latest_task = task;
+        }
+    }
+    return latest_task.has_value() ? latest_task->saved_path : std::string();
+}
+
+void BlockScheduleController::start_delta(TaskPending& task_pendding, const std::string& basis_path)
+{
+    task_pendding.delta_basis_path = basis_path;
+    task_pendding.delta_id = m_next_delta_id++;
+    task_pendding.delta_start_time = std::chrono::steady_clock::now();
+    DANEJOE_LOG_INFO("default", "BlockScheduleController", "Starting delta transfer for task {} from basis {}",
+        task_pendding.task_entity.task_id, basis_path);
+    int64_t task_id = task_pendding.task_entity.task_id;
+    uint64_t delta_id = task_pendding.delta_id;
+    run_delta_job([this, task_id, delta_id, basis_path]()
+        {
+            std::optional<std::vector<uint8_t>> signature;
+            auto signature_opt = DaneJoe::FileSignature::build_from_file(basis_path);
+            if (signature_opt.has_value())
             {
-                DANEJOE_LOG_WARN("default", "BlockScheduleController", "Failed to create dest directory");
-                block_entity.state = BlockState::Failed;
-                m_block_service.update(block_entity);
-                return;
+                signature = signature_opt->encode();
             }
+            QMetaObject::invokeMethod(this, [this, task_id, delta_id, signature = std::move(signature)]()
+                {
+                    on_delta_signature_built(task_id, delta_id, signature);
+                }, Qt::QueuedConnection);
+        });
+}
+
+void BlockScheduleController::on_delta_signature_built(int64_t task_id, uint64_t delta_id, std::optional<std::vector<uint8_t>> signature)
+{
+    auto task_pendding_it = m_task_pendding_map.find(task_id);
+    if (task_pendding_it == m_task_pendding_map.end() || task_pendding_it->second.delta_id != delta_id ||
+        task_pendding_it->second.delta_basis_path.empty())
+    {
+        return;
+    }
+    auto& task_pendding = task_pendding_it->second;
+    if (!signature.has_value())
+    {
+        fallback_from_delta(task_pendding, "failed to build signature");
+        return;
+    }
+    EventContext event_context;
+    event_context.m_object_name = DELTA_OBJECT_NAME;
+    DeltaRequestTransfer request;
+    request.file_id = task_pendding.sources.front().file_id;
+    request.task_id = task_id;
+    request.signature = std::move(signature.value());
+    m_view_event_hub->publish_delta_request(event_context, task_pendding.sources.front().endpoint, request);
+}
+
+void BlockScheduleController::on_delta_applied(int64_t task_id, uint64_t delta_id, const std::string& output_path, std::optional<DaneJoe::Md5> md5)
+{
+    std::error_code error_code;
+    auto task_pendding_it = m_task_pendding_map.find(task_id);
+    if (task_pendding_it == m_task_pendding_map.end() || task_pendding_it->second.delta_id != delta_id ||
+        task_pendding_it->second.delta_basis_path.empty())
+    {
+        std::filesystem::remove(output_path, error_code);
+        return;
+    }
+    auto& task_pendding = task_pendding_it->second;
+    // 重建结果即完整文件，按完整文件校验摘要
+    task_pendding.completed_bytes = task_pendding.file_size;
+    if (!verify_digest(task_pendding, md5))
+    {
+        task_pendding.completed_bytes = 0;
+        std::filesystem::remove(output_path, error_code);
+        fallback_from_delta(task_pendding, std::format("rebuilt file mismatch: got md5 {}", md5.has_value() ? md5->get_hex_digest() : std::string("none")));
+        return;
+    }
+    std::filesystem::rename(output_path, task_pendding.task_entity.saved_path, error_code);
+    if (error_code)
+    {
+        task_pendding.completed_bytes = 0;
+        std::filesystem::remove(output_path, error_code);
+        fallback_from_delta(task_pendding, "failed to replace dest file: " + error_code.message());
+        return;
+    }
+    DANEJOE_LOG_INFO("default", "BlockScheduleController", "Task {} rebuilt from delta", task_id);
+    task_pendding.delta_basis_path.clear();
+    task_pendding.unrequested_ranges.clear();
+    task_pendding.progress.add_completed(0, task_pendding.file_size);
+    task_pendding.progress.digest_state = md5->save_state();
+    commit_progress(task_pendding.progress, true);
+    finish_task(task_pendding, true);
+}
+
+void BlockScheduleController::fallback_from_delta(TaskPending& task_pendding, const std::string& reason)
+{
+    DANEJOE_LOG_WARN("default", "BlockScheduleController", "Delta transfer for task {} abandoned ({}), downloading blocks",
+        task_pendding.task_entity.task_id, reason);
+    task_pendding.delta_basis_path.clear();
+    // 使迟到的差量结果失效
+    task_pendding.delta_id = m_next_delta_id++;
+    on_block_request();
+}
+
+void BlockScheduleController::run_delta_job(std::function<void()> job)
+{
+    std::erase_if(m_delta_jobs, [](const std::future<void>& delta_job)
+        {
+            return delta_job.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+        });
+    m_delta_jobs.push_back(std::async(std::launch::async, std::move(job)));
+}
+
+void BlockScheduleController::release_in_flight_blocks(TaskPending& task_pendding)
+{
+    for (const auto& [block_id, in_flight_block] : task_pendding.in_flight_blocks)
+    {
+        for (const auto& request : in_flight_block.requests)
+        {
+            get_endpoint_schedule(request.endpoint).window.on_cancelled();
+            m_view_event_hub->publish_cancel_request(request.event_id);
         }
-        auto is_open =
-            task_pendding_it->second.dest_file->open(QIODevice::ReadWrite);
-        if (!is_open)
+    }
+    task_pendding.in_flight_blocks.clear();
+    task_pendding.in_flight_counts.clear();
+}
+
+bool BlockScheduleController::has_block_to_request(const TaskPending& task_pendding)const
+{
+    return !task_pendding.pending_blocks.empty() ||
+        !task_pendding.unrequested_ranges.empty();
+}
+
+EndpointSchedule& BlockScheduleController::get_endpoint_schedule(const NetworkEndpoint& endpoint)
+{
+    auto schedule_it = m_endpoint_schedules.find(endpoint);
+    if (schedule_it == m_endpoint_schedules.end())
+    {
+        schedule_it = m_endpoint_schedules.emplace(endpoint, EndpointSchedule{
+            DaneJoe::AdaptiveWindow(m_window_config),
+            DaneJoe::AdaptiveBlockSize(m_block_size_config) }).first;
+    }
+    return schedule_it->second;
+}
+
+void BlockScheduleController::dispatch_block_request(TaskPending& task_pendding, const TaskSource& source, BlockRequestTransfer transfer)
+{
+    auto& in_flight_block = task_pendding.in_flight_blocks[transfer.block_id];
+    if (in_flight_block.requests.empty())
+    {
+        in_flight_block.transfer = transfer;
+    }
+    in_flight_block.requests.push_back(InFlightRequest{ source.endpoint, std::chrono::steady_clock::now() });
+    task_pendding.in_flight_counts[source.endpoint]++;
+    get_endpoint_schedule(source.endpoint).window.on_sent();
+    // 各源上的文件ID可能不同
+    transfer.file_id = source.file_id;
+    in_flight_block.requests.back().event_id = m_view_event_hub->publish_block_request(
+        task_pendding.event_source,
+        source.endpoint, transfer);
+}
+
+std::optional<BlockRequestTransfer> BlockScheduleController::take_straggler_block(TaskPending& task_pendding, const NetworkEndpoint& endpoint)
+{
+    auto& schedule = get_endpoint_schedule(endpoint);
+    double bandwidth = schedule.window.get_bandwidth();
+    if (bandwidth <= 0.0)
+    {
+        return std::nullopt;
+    }
+    auto now = std::chrono::steady_clock::now();
+    double min_rtt = std::chrono::duration<double>(schedule.window.get_min_rtt()).count();
+    const InFlightBlock* best_block = nullptr;
+    double best_saving = 0.0;
+    for (const auto& [block_id, in_flight_block] : task_pendding.in_flight_blocks)
+    {
+        if (in_flight_block.requests.size() != 1 || in_flight_block.requests.front().endpoint == endpoint)
         {
-            DANEJOE_LOG_WARN("default", "BlockScheduleController", "Failed to open file");
-            block_entity.state = BlockState::Failed;
-            m_block_service.update(block_entity);
-            return;
+            continue;
+        }
+        const auto& request = in_flight_block.requests.front();
+        double block_bytes = static_cast<double>(in_flight_block.transfer.block_size);
+        double expected_here = min_rtt + block_bytes / bandwidth;
+        // 原源的预计剩余时间：按其带宽估计的总时间减去已等待时间；无带宽样本时，等待超过本源预计时间即视为拖尾
+        auto& owner_schedule = get_endpoint_schedule(request.endpoint);
+        double owner_bandwidth = owner_schedule.window.get_bandwidth();
+        double elapsed = std::chrono::duration<double>(now - request.sent_time).count();
+        double saving = 0.0;
+        if (owner_bandwidth > 0.0)
+        {
+            double owner_min_rtt = std::chrono::duration<double>(owner_schedule.window.get_min_rtt()).count();
+            saving = owner_min_rtt + block_bytes / owner_bandwidth - elapsed - expected_here;
+        }
+        else
+        {
+            saving = elapsed - expected_here;
+        }
+        if (saving > best_saving)
+        {
+            best_saving = saving;
+            best_block = &in_flight_block;
+        }
+    }
+    if (!best_block)
+    {
+        return std::nullopt;
+    }
+    DANEJOE_LOG_DEBUG("default", "BlockScheduleController", "Stealing block {} of task {} to {}:{}",
+        best_block->transfer.block_id, task_pendding.task_entity.task_id, endpoint.ip, endpoint.port);
+    return best_block->transfer;
+}
+
+std::optional<BlockRequestTransfer> BlockScheduleController::take_block_request(
+    TaskPending& task_pendding,
+    const DaneJoe::AdaptiveBlockSize& block_size)
+{
+    if (!task_pendding.pending_blocks.empty())
+    {
+        auto transfer = task_pendding.pending_blocks.front();
+        task_pendding.pending_blocks.pop_front();
+        return transfer;
+    }
+    if (task_pendding.unrequested_ranges.empty())
+    {
+        return std::nullopt;
+    }
+    auto& range = task_pendding.unrequested_ranges.front();
+    BlockRequestTransfer transfer;
+    transfer.block_id = task_pendding.next_block_id++;
+    transfer.file_id = task_pendding.task_entity.file_id;
+    transfer.task_id = task_pendding.task_entity.task_id;
+    transfer.offset = range.first;
+    transfer.block_size = block_size.get_next_length(range.second - range.first);
+    if (task_pendding.manifest.has_value() && range.first + transfer.block_size < range.second)
+    {
+        // 结束位置对齐到清单块边界，使块完整覆盖清单块而可被校验；不足一块时向上取整
+        int64_t chunk_size = task_pendding.manifest->chunk_size;
+        int64_t end = (range.first + transfer.block_size) / chunk_size * chunk_size;
+        if (end <= range.first)
+        {
+            end = std::min(range.second, (range.first / chunk_size + 1) * chunk_size);
         }
+        transfer.block_size = end - range.first;
     }
+    range.first += transfer.block_size;
+    if (range.first >= range.second)
+    {
+        task_pendding.unrequested_ranges.pop_front();
+    }
+    task_pendding.live_blocks.emplace(transfer.block_id, transfer);
+    return transfer;
+}
 
-    auto is_seeked = task_pendding_it->second.dest_file->seek(response.offset);
-    if (!is_seeked)
+void BlockScheduleController::check_task_completed(TaskPending& task_pendding)
+{
+    if (task_pendding.is_verifying_resume ||
+        has_block_to_request(task_pendding) ||
+        !task_pendding.in_flight_blocks.empty() ||
+        !task_pendding.writing_blocks.empty())
     {
-        DANEJOE_LOG_WARN("default", "BlockScheduleController", "Failed to seek file");
-        block_entity.state = BlockState::Failed;
-        m_block_service.update(block_entity);
         return;
     }
-    int64_t has_write = 0;
-    if (static_cast<std::size_t>(response.block_size) > response.data.size())
+    task_pendding.unflushed_blocks = 0;
+    bool need_verify = !task_pendding.md5_code.empty() && task_pendding.completed_bytes >= task_pendding.file_size;
+    if (!task_pendding.dest_file_id.has_value() && (!need_verify || !open_dest_file(task_pendding)))
     {
-        DANEJOE_LOG_WARN("default", "BlockScheduleController", "No enough data");
-        block_entity.state = BlockState::Failed;
-        m_block_service.update(block_entity);
+        commit_progress(task_pendding.progress, true);
+        finish_task(task_pendding, !need_verify);
         return;
     }
-    int64_t rest_bytes = response.block_size;
+    // 任务结束为同步检查点：落盘并取得最终摘要后关闭，校验通过才提交最终进度并标记任务完成
+    auto file_id = task_pendding.dest_file_id.value();
+    task_pendding.dest_file_id.reset();
+    int64_t task_id = task_pendding.task_entity.task_id;
+    m_file_writer.checkpoint(file_id, [this, task_id, file_id](bool is_success, std::optional<DaneJoe::Md5> md5)
+        {
+            QMetaObject::invokeMethod(this, [this, task_id, file_id, is_success, md5 = std::move(md5)]()
+                {
+                    auto task_pendding_it = m_task_pendding_map.find(task_id);
+                    if (task_pendding_it == m_task_pendding_map.end())
+                    {
+                        m_file_writer.close_file(file_id);
+                        return;
+                    }
+                    auto& task_pendding = task_pendding_it->second;
+                    if (is_success && !verify_digest(task_pendding, md5))
+                    {
+                        // 已写入的数据无法定位到具体区间，清除进度使重新开始时完整下载
+                        DANEJOE_LOG_ERROR("default", "BlockScheduleController", "MD5 mismatch for task {}: expected {}, got {}",
+                            task_id, task_pendding.md5_code, md5.has_value() ? md5->get_hex_digest() : std::string("none"));
+                        m_file_writer.close_file(file_id);
+                        m_task_progress_service.remove(task_id);
+                        finish_task(task_pendding, false);
+                        return;
+                    }
+                    auto progress = task_pendding.progress;
+                    if (md5.has_value())
+                    {
+                        progress.digest_state = md5->save_state();
+                    }
+                    m_file_writer.close_file(file_id, [this, task_id, progress = std::move(progress), is_checked = is_success](bool is_success)
+                        {
+                            QMetaObject::invokeMethod(this, [this, task_id, progress, is_success = is_checked && is_success]()
+                                {
+                                    commit_progress(progress, is_success);
+                                    auto task_pendding_it = m_task_pendding_map.find(task_id);
+                                    if (task_pendding_it == m_task_pendding_map.end())
+                                    {
+                                        return;
+                                    }
+                                    finish_task(task_pendding_it->second, is_success);
+                                }, Qt::QueuedConnection);
+                        });
+                }, Qt::QueuedConnection);
+        });
+}
 
-    while (rest_bytes > 0)
+bool BlockScheduleController::verify_digest(const TaskPending& task_pendding, const std::optional<DaneJoe::Md5>& md5)const
+{
+    if (task_pendding.md5_code.empty() || task_pendding.completed_bytes < task_pendding.file_size)
+    {
+        return true;
+    }
+    if (!md5.has_value() || static_cast<int64_t>(md5->get_size()) != task_pendding.file_size)
     {
-        int64_t bytes_written =
-            task_pendding_it->second.dest_file->write(reinterpret_cast<const char*>(response.data.data() + has_write), rest_bytes);
-        if (bytes_written < 0)
+        return false;
+    }
+    std::string expected = task_pendding.md5_code;
+    std::transform(expected.begin(), expected.end(), expected.begin(), [](unsigned char c)
         {
-            DANEJOE_LOG_WARN("default", "BlockScheduleController", "Failed to write data");
-            block_entity.state = BlockState::Failed;
-            m_block_service.update(block_entity);
-            return;
+            return static_cast<char>(std::tolower(c));
+        });
+    return md5->get_hex_digest() == expected;
+}
+
+void BlockScheduleController::finish_task(TaskPending& task_pendding, bool is_success)
+{
+    auto task_entity_opt = m_task_service.get_by_task_id(task_pendding.task_entity.task_id);
+    if (task_entity_opt.has_value())
+    {
+        auto task_entity = task_entity_opt.value();
+        task_entity.end_time = std::chrono::system_clock::now();
+        // 所有区间均已请求且无在途块，已完成字节数不足说明存在写入失败的块
+        task_entity.state = is_success && task_pendding.completed_bytes >= task_pendding.file_size ?
+            TaskState::Completed :
+            TaskState::Failed;
+        bool is_updated = m_task_service.update(task_entity);
+        DANEJOE_LOG_DEBUG("default", "BlockScheduleController", "Updated:{}", is_updated);
+    }
+    /// @todo 后续再考虑其他处理
+    emit task_completed(task_pendding.task_entity.task_id);
+}
+
+bool BlockScheduleController::open_dest_file(TaskPending& task_pendding)
+{
+    QFileInfo dest_file_info(QString::fromStdString(task_pendding.task_entity.saved_path));
+    QDir dir = dest_file_info.absoluteDir();
+    if (!dir.exists() && !dir.mkpath("."))
+    {
+        DANEJOE_LOG_WARN("default", "BlockScheduleController", "Failed to create dest directory");
+        return false;
+    }
+    std::optional<DaneJoe::FileDigest> digest;
+    if (!task_pendding.md5_code.empty())
+    {
+        // 摘要从上次保存的状态继续，其后已完成的区间由写入器在前缀到达时从文件读取
+        digest.emplace();
+        if (!task_pendding.progress.digest_state.empty())
+        {
+            digest->md5.load_state(task_pendding.progress.digest_state);
+        }
+        digest->written_ranges = task_pendding.progress.get_completed_ranges();
+    }
+    // 文件大小已知，打开时预分配空间
+    task_pendding.dest_file_id = m_file_writer.open_file(
+        dest_file_info.absoluteFilePath().toStdString(),
+        task_pendding.file_size,
+        std::move(digest));
+    if (!task_pendding.dest_file_id.has_value())
+    {
+        DANEJOE_LOG_WARN("default", "BlockScheduleController", "Failed to open file");
+        return false;
+    }
+    return true;
+}
+
+void BlockScheduleController::close_dest_file(TaskPending& task_pendding)
+{
+    flush_progress(task_pendding);
+    if (!task_pendding.dest_file_id.has_value())
+    {
+        return;
+    }
+    m_file_writer.close_file(task_pendding.dest_file_id.value());
+    task_pendding.dest_file_id.reset();
+    task_pendding.writing_blocks.clear();
+}
+
+void BlockScheduleController::save_block_response(TaskPending& task_pendding, BlockResponseTransfer& response, const NetworkEndpoint& endpoint)
+{
+    auto block_it = task_pendding.live_blocks.find(response.block_id);
+    if (block_it == task_pendding.live_blocks.end())
+    {
+        return;
+    }
+    const auto& request = block_it->second;
+    // 服务端无法读取文件时返回空块；只接受与请求区间完全一致的数据，否则空洞会被记为已完成
+    if (response.offset != request.offset ||
+        response.block_size != request.block_size ||
+        static_cast<int64_t>(response.data.size()) < request.block_size)
+    {
+        retry_block(task_pendding, response.block_id, endpoint,
+            std::format("got {} bytes at offset {}, expected {} at {}", response.data.size(), response.offset, request.block_size, request.offset));
+        return;
+    }
+    if (!task_pendding.dest_file_id.has_value() && !open_dest_file(task_pendding))
+    {
+        record_block_state(task_pendding, response.block_id, BlockState::Failed);
+        return;
+    }
+    response.data.resize(static_cast<std::size_t>(request.block_size));
+    if (!verify_block_chunks(task_pendding, response))
+    {
+        retry_block(task_pendding, response.block_id, endpoint, "chunk hash mismatch");
+        return;
+    }
+    int64_t task_id = task_pendding.task_entity.task_id;
+    int64_t block_id = response.block_id;
+    task_pendding.writing_blocks.insert(block_id);
+    m_file_writer.write(task_pendding.dest_file_id.value(), request.offset, std::move(response.data),
+        [this, task_id, block_id](bool is_success)
+        {
+            QMetaObject::invokeMethod(this, [this, task_id, block_id, is_success]()
+                {
+                    on_block_written(task_id, block_id, is_success);
+                }, Qt::QueuedConnection);
+        });
+}
+
+void BlockScheduleController::retry_block(TaskPending& task_pendding, int64_t block_id, const NetworkEndpoint& endpoint, const std::string& reason)
+{
+    auto block_it = task_pendding.live_blocks.find(block_id);
+    if (block_it == task_pendding.live_blocks.end())
+    {
+        return;
+    }
+    int64_t task_id = task_pendding.task_entity.task_id;
+    int64_t offset = block_it->second.offset;
+    int64_t block_size = block_it->second.block_size;
+    int source_mismatches = ++task_pendding.source_mismatch_counts[endpoint];
+    int range_mismatches = ++task_pendding.range_mismatch_counts[offset];
+    // 源上的文件在清单生成后被修改、读取失败，或镜像返回不同的数据：不再向该源请求，区间交给其他源
+    if (source_mismatches >= m_max_source_mismatches && task_pendding.sources.size() > 1)
+    {
+        auto source_it = std::find_if(task_pendding.sources.begin(), task_pendding.sources.end(),
+            [&endpoint](const TaskSource& source)
+            {
+                return source.endpoint == endpoint;
+            });
+        if (source_it != task_pendding.sources.end())
+        {
+            DANEJOE_LOG_WARN("default", "BlockScheduleController", "Removing source {}:{} from task {} after {} invalid blocks",
+                endpoint.ip, endpoint.port, task_id, source_mismatches);
+            task_pendding.sources.erase(source_it);
+            task_pendding.range_mismatch_counts.erase(offset);
+            range_mismatches = 0;
         }
-        rest_bytes -= bytes_written;
-        has_write += bytes_written;
     }
-    task_pendding_it->second.dest_file->flush();
-    block_entity.state = BlockState::Completed;
-    block_entity.end_time = std::chrono::system_clock::now();
-    m_block_service.update(block_entity);
-    auto rest_block_count =
-        m_block_service.get_count_by_task_id_and_block_state(task_pendding_it->second.task_entity.task_id, BlockState::Waiting);
-    if (rest_block_count == 0)
+    if (range_mismatches >= m_max_range_mismatches)
+    {
+        // 所有源都返回无效数据，继续请求没有意义：块记为失败，任务在其余块结束后按失败处理
+        DANEJOE_LOG_ERROR("default", "BlockScheduleController", "Invalid block {} of task {} at offset {} {} times ({}), giving up",
+            block_id, task_id, offset, range_mismatches, reason);
+        record_block_state(task_pendding, block_id, BlockState::Failed);
+        return;
+    }
+    // 无效数据不写入，请求的区间放回队首重新请求
+    DANEJOE_LOG_WARN("default", "BlockScheduleController", "Invalid block {} of task {} at offset {} from {}:{} ({}), requesting again",
+        block_id, task_id, offset, endpoint.ip, endpoint.port, reason);
+    task_pendding.live_blocks.erase(block_it);
+    task_pendding.unrequested_ranges.emplace_front(offset, offset + block_size);
+}
+
+bool BlockScheduleController::verify_block_chunks(const TaskPending& task_pendding, const BlockResponseTransfer& response)const
+{
+    if (!task_pendding.manifest.has_value())
+    {
+        return true;
+    }
+    const auto& manifest = task_pendding.manifest.value();
+    int64_t block_end = response.offset + response.block_size;
+    // 仅校验被块完整覆盖的清单块，未对齐的首尾部分留给整体 MD5
+    int64_t first_chunk = (response.offset + manifest.chunk_size - 1) / manifest.chunk_size;
+    for (int64_t index = first_chunk; index < manifest.get_chunk_count(); index++)
+    {
+        auto [begin, end] = manifest.get_chunk_range(index);
+        if (end > block_end)
+        {
+            break;
+        }
+        if (!manifest.verify_chunk(index, response.data.data() + (begin - response.offset), static_cast<std::size_t>(end - begin)))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+void BlockScheduleController::on_block_written(int64_t task_id, int64_t block_id, bool is_success)
+{
+    auto task_pendding_it = m_task_pendding_map.find(task_id);
+    if (task_pendding_it == m_task_pendding_map.end())
+    {
+        return;
+    }
+    auto& task_pendding = task_pendding_it->second;
+    // 不在写入集合中说明任务已重新入队，块状态以新的调度为准
+    if (task_pendding.writing_blocks.erase(block_id) == 0)
+    {
+        return;
+    }
+    if (!is_success)
+    {
+        DANEJOE_LOG_WARN("default", "BlockScheduleController", "Failed to write block {} of task {}", block_id, task_id);
+    }
+    record_block_state(task_pendding, block_id, is_success ? BlockState::Completed : BlockState::Failed);
+    check_task_completed(task_pendding);
+}
+
+void BlockScheduleController::record_block_state(TaskPending& task_pendding, int64_t block_id, BlockState state)
+{
+    auto block_it = task_pendding.live_blocks.find(block_id);
+    if (block_it == task_pendding.live_blocks.end())
+    {
+        return;
+    }
+    auto transfer = block_it->second;
+    task_pendding.live_blocks.erase(block_it);
+    if (state != BlockState::Completed)
+    {
+        // 失败的区间不计入进度，任务结束时因已完成字节数不足而失败，恢复后重新下载
+        return;
+    }
+    task_pendding.progress.add_completed(transfer.offset, transfer.block_size);
+    task_pendding.completed_bytes += transfer.block_size;
+    task_pendding.unflushed_blocks++;
+    task_pendding.is_progress_changed = true;
+    if (task_pendding.unflushed_blocks >= m_progress_flush_blocks)
     {
-        auto task_entity_opt = m_task_service.get_by_task_id(task_pendding_it->second.task_entity.task_id);
-        if (task_entity_opt.has_value())
+        flush_progress(task_pendding);
+    }
+}
+
+void BlockScheduleController::on_progress_flush()
+{
+    for (auto& [task_id, task_pendding] : m_task_pendding_map)
+    {
+        flush_progress(task_pendding);
+    }
+}
+
+void BlockScheduleController::on_progress_notify()
+{
+    if (!m_view_event_hub)
+    {
+        return;
+    }
+    for (auto& [task_id, task_pendding] : m_task_pendding_map)
+    {
+        if (!task_pendding.is_progress_changed)
         {
-            auto task_entity = task_entity_opt.value();
-            task_entity.end_time = std::chrono::system_clock::now();
-            task_entity.state = TaskState::Completed;
-            bool is_updated = m_task_service.update(task_entity);
-            DANEJOE_LOG_DEBUG("default", "BlockScheduleController", "Updated:{}", is_updated);
+            continue;
         }
-        /// @todo 后续再考虑其他处理
-        emit task_completed(task_pendding_it->second.task_entity.task_id);
+        task_pendding.is_progress_changed = false;
+        m_view_event_hub->publish_task_progress(task_id, task_pendding.completed_bytes, task_pendding.file_size);
+    }
+}
+
+void BlockScheduleController::flush_progress(TaskPending& task_pendding)
+{
+    if (task_pendding.unflushed_blocks == 0)
+    {
+        return;
+    }
+    task_pendding.unflushed_blocks = 0;
+    if (!task_pendding.dest_file_id.has_value())
+    {
+        commit_progress(task_pendding.progress, true);
+        return;
     }
+    // 先同步再提交：持久化的进度不会领先于磁盘上的数据
+    m_file_writer.checkpoint(task_pendding.dest_file_id.value(),
+        [this, progress = task_pendding.progress](bool is_success, std::optional<DaneJoe::Md5> md5) mutable
+        {
+            if (md5.has_value())
+            {
+                progress.digest_state = md5->save_state();
+            }
+            QMetaObject::invokeMethod(this, [this, progress = std::move(progress), is_success]()
+                {
+                    commit_progress(progress, is_success);
+                }, Qt::QueuedConnection);
+        });
+}
 
-}
\ No newline at end of file
+void BlockScheduleController::commit_progress(const TaskProgressEntity& progress, bool is_synced)
+{
+    if (!is_synced)
+    {
+        // 数据未能落盘，保留上一次持久化的进度，恢复时重新下载其后完成的区间
+        DANEJOE_LOG_WARN("default", "BlockScheduleController", "Failed to sync dest file, progress of task {} is not persisted", progress.task_id);
+        return;
+    }
+    if (!m_task_progress_service.save(progress))
+    {
+        DANEJOE_LOG_WARN("default", "BlockScheduleController", "Failed to persist progress of task {}", progress.task_id);
+    }
+}
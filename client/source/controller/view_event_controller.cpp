@@ -1,3 +1,4 @@
+#include "danejoe/logger/logger_manager.hpp"
 #include "controller/view_event_controller.hpp"
 
 ViewEventController::ViewEventController(
@@ -13,21 +14,35 @@ ViewEventController::ViewEventController(
 
 void ViewEventController::init()
 {
+    // 请求与响应都在发出方所在线程中直接处理：块调度线程发出的块请求直接发送，
+    // 网络线程解码出的响应直接发布到事件中心，再由各订阅方按所在线程排队，不经过 GUI 线程中转
     if (m_view_event_hub)
     {
         connect(m_view_event_hub, &ViewEventHub::test_request,
-            this, &ViewEventController::on_test_request);
+            this, &ViewEventController::on_test_request, Qt::DirectConnection);
         connect(m_view_event_hub, &ViewEventHub::block_request,
-            this, &ViewEventController::on_block_request);
+            this, &ViewEventController::on_block_request, Qt::DirectConnection);
         connect(m_view_event_hub, &ViewEventHub::download_request,
-            this, &ViewEventController::on_download_request);
+            this, &ViewEventController::on_download_request, Qt::DirectConnection);
+        connect(m_view_event_hub, &ViewEventHub::manifest_request,
+            this, &ViewEventController::on_manifest_request, Qt::DirectConnection);
+        connect(m_view_event_hub, &ViewEventHub::delta_request,
+            this, &ViewEventController::on_delta_request, Qt::DirectConnection);
+        connect(m_view_event_hub, &ViewEventHub::cancel_request,
+            this, &ViewEventController::on_cancel_request, Qt::DirectConnection);
     }
     connect(&m_trans_service, &TransService::test_response_received, this,
-            &ViewEventController::on_test_response);
+            &ViewEventController::on_test_response, Qt::DirectConnection);
     connect(&m_trans_service, &TransService::download_response_received, this,
-            &ViewEventController::on_download_response);
+            &ViewEventController::on_download_response, Qt::DirectConnection);
+    connect(&m_trans_service, &TransService::manifest_response_received, this,
+            &ViewEventController::on_manifest_response, Qt::DirectConnection);
+    connect(&m_trans_service, &TransService::delta_response_received, this,
+            &ViewEventController::on_delta_response, Qt::DirectConnection);
     connect(&m_trans_service, &TransService::block_response_received, this,
-            &ViewEventController::on_block_response);
+            &ViewEventController::on_block_response, Qt::DirectConnection);
+    connect(&m_trans_service, &TransService::request_failed, this,
+            &ViewEventController::on_request_failed, Qt::DirectConnection);
 }
 
 void ViewEventController::on_test_request(
@@ -35,64 +50,158 @@ void ViewEventController::on_test_request(
     NetworkEndpoint endpoint,
     TestRequestTransfer request)
 {
+    std::lock_guard<std::mutex> lock(m_event_envelope_mutex);
     auto trans_context = m_trans_service.send_test_request(endpoint, request);
-    m_event_envelopes[trans_context.request_id] = event_envelope;
+    add_event_envelope(trans_context.request_id, std::move(event_envelope));
 }
 void ViewEventController::on_block_request(
     EventEnvelope event_envelope,
     NetworkEndpoint endpoint,
     BlockRequestTransfer request)
 {
+    std::lock_guard<std::mutex> lock(m_event_envelope_mutex);
     auto trans_context = m_trans_service.send_block_request(endpoint, request);
-    m_event_envelopes[trans_context.request_id] = event_envelope;
+    add_event_envelope(trans_context.request_id, std::move(event_envelope));
 }
 void ViewEventController::on_download_request(
     EventEnvelope event_envelope,
     NetworkEndpoint endpoint,
     DownloadRequestTransfer request)
 {
+    std::lock_guard<std::mutex> lock(m_event_envelope_mutex);
     auto trans_context = m_trans_service.send_download_request(endpoint, request);
-    m_event_envelopes[trans_context.request_id] = event_envelope;
+    add_event_envelope(trans_context.request_id, std::move(event_envelope));
+}
+void ViewEventController::on_manifest_request(
+    EventEnvelope event_envelope,
+    NetworkEndpoint endpoint,
+    ManifestRequestTransfer request)
+{
+    std::lock_guard<std::mutex> lock(m_event_envelope_mutex);
+    auto trans_context = m_trans_service.send_manifest_request(endpoint, request);
+    add_event_envelope(trans_context.request_id, std::move(event_envelope));
+}
+void ViewEventController::on_delta_request(
+    EventEnvelope event_envelope,
+    NetworkEndpoint endpoint,
+    DeltaRequestTransfer request)
+{
+    std::lock_guard<std::mutex> lock(m_event_envelope_mutex);
+    auto trans_context = m_trans_service.send_delta_request(endpoint, request);
+    add_event_envelope(trans_context.request_id, std::move(event_envelope));
+}
+
+void ViewEventController::on_cancel_request(uint64_t event_id)
+{
+    uint64_t request_id = 0;
+    {
+        std::lock_guard<std::mutex> lock(m_event_envelope_mutex);
+        auto request_id_it = m_event_request_ids.find(event_id);
+        if (request_id_it == m_event_request_ids.end())
+        {
+            return;
+        }
+        request_id = request_id_it->second;
+        m_event_request_ids.erase(request_id_it);
+        m_event_envelopes.erase(request_id);
+    }
+    m_trans_service.cancel_request(request_id);
 }
 
 void ViewEventController::on_test_response(
     TransContext trans_context,
     TestResponseTransfer response)
 {
-    auto event_envelope_it = m_event_envelopes.find(trans_context.request_id);
-    if (event_envelope_it == m_event_envelopes.end())
+    auto event_envelope_opt = take_event_envelope(trans_context.request_id);
+    if (!event_envelope_opt.has_value() || !m_view_event_hub)
     {
         return;
     }
     m_view_event_hub->publish_test_response(
-        event_envelope_it->second,
+        std::move(event_envelope_opt.value()),
         trans_context,
-        response);
+        std::move(response));
 }
 void ViewEventController::on_download_response(
     TransContext trans_context, DownloadResponseTransfer response)
 {
-  auto event_envelope_it = m_event_envelopes.find(trans_context.request_id);
-  if (event_envelope_it == m_event_envelopes.end())
-  {
-    return;
-  }
-  m_view_event_hub->publish_download_response(
-      event_envelope_it->second,
-      trans_context,
-      response);
+    auto event_envelope_opt = take_event_envelope(trans_context.request_id);
+    if (!event_envelope_opt.has_value() || !m_view_event_hub)
+    {
+        return;
+    }
+    m_view_event_hub->publish_download_response(
+        std::move(event_envelope_opt.value()),
+        trans_context,
+        std::move(response));
+}
+void ViewEventController::on_manifest_response(
+    TransContext trans_context, ManifestResponseTransfer response)
+{
+    auto event_envelope_opt = take_event_envelope(trans_context.request_id);
+    if (!event_envelope_opt.has_value() || !m_view_event_hub)
+    {
+        return;
+    }
+    m_view_event_hub->publish_manifest_response(
+        std::move(event_envelope_opt.value()),
+        trans_context,
+        std::move(response));
+}
+
+void ViewEventController::on_delta_response(
+    TransContext trans_context, DeltaResponseTransfer response)
+{
+    auto event_envelope_opt = take_event_envelope(trans_context.request_id);
+    if (!event_envelope_opt.has_value() || !m_view_event_hub)
+    {
+        return;
+    }
+    m_view_event_hub->publish_delta_response(
+        std::move(event_envelope_opt.value()),
+        trans_context,
+        std::move(response));
 }
 
 void ViewEventController::on_block_response(TransContext trans_context,
                                             BlockResponseTransfer response)
 {
-  auto event_envelope_it = m_event_envelopes.find(trans_context.request_id);
-  if (event_envelope_it == m_event_envelopes.end())
-  {
-    return;
-  }
-  m_view_event_hub->publish_block_response(
-      event_envelope_it->second,
-      trans_context,
-      response);
-}
\ No newline at end of file
+    auto event_envelope_opt = take_event_envelope(trans_context.request_id);
+    if (!event_envelope_opt.has_value() || !m_view_event_hub)
+    {
+        return;
+    }
+    m_view_event_hub->publish_block_response(
+        std::move(event_envelope_opt.value()),
+        trans_context,
+        std::move(response));
+}
+
+void ViewEventController::on_request_failed(TransContext trans_context)
+{
+    // 失败的请求不会再有响应，移除其事件封包
+    if (take_event_envelope(trans_context.request_id).has_value())
+    {
+        DANEJOE_LOG_DEBUG("default", "ViewEventController", "Dropped event envelope of failed request {}", trans_context.request_id);
+    }
+}
+
+void ViewEventController::add_event_envelope(uint64_t request_id, EventEnvelope event_envelope)
+{
+    m_event_request_ids[event_envelope.m_event_id] = request_id;
+    m_event_envelopes[request_id] = std::move(event_envelope);
+}
+
+std::optional<EventEnvelope> ViewEventController::take_event_envelope(uint64_t request_id)
+{
+    std::lock_guard<std::mutex> lock(m_event_envelope_mutex);
+    auto event_envelope_it = m_event_envelopes.find(request_id);
+    if (event_envelope_it == m_event_envelopes.end())
+    {
+        return std::nullopt;
+    }
+    auto event_envelope = std::move(event_envelope_it->second);
+    m_event_envelopes.erase(event_envelope_it);
+    m_event_request_ids.erase(event_envelope.m_event_id);
+    return event_envelope;
+}
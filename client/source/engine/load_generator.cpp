@@ -0,0 +1,518 @@
+#include <memory>
+#include <random>
+#include <thread>
+#include <vector>
+#include <algorithm>
+#include <unordered_map>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/epoll.h>
+
+#include "danejoe/logger/logger_manager.hpp"
+#include "danejoe/network/context/connect_context.hpp"
+#include "danejoe/network/handle/posix_epoll_handle.hpp"
+#include "danejoe/network/handle/posix_socket_handle.hpp"
+
+#include "engine/load_generator.hpp"
+#include "model/transfer/block_transfer.hpp"
+#include "model/transfer/download_transfer.hpp"
+#include "model/transfer/envelope_transfer.hpp"
+#include "model/transfer/test_transfer.hpp"
+#include "protocol/client_message_codec.hpp"
+
+namespace
+{
+    constexpr int MAX_EPOLL_EVENTS = 64;
+    constexpr int EPOLL_TIMEOUT_MS = 10;
+    constexpr uint32_t CONNECTION_EVENTS = EPOLLIN | EPOLLRDHUP;
+
+    /**
+     * @struct InFlightRequest
+     * @brief 在途请求
+     */
+    struct InFlightRequest
+    {
+        LoadRequestKind kind = LoadRequestKind::Test;
+        int64_t expected_bytes = 0;
+        LoadGenerator::Clock::time_point sent_time;
+    };
+
+    /**
+     * @struct LoadClient
+     * @brief 模拟客户端
+     */
+    struct LoadClient
+    {
+        std::unique_ptr<DaneJoe::ConnectContext> context;
+        int fd = -1;
+        bool is_watching_write = false;
+        int64_t next_request_id = 1;
+        std::unordered_map<int64_t, InFlightRequest> in_flight;
+        std::vector<DaneJoe::PosixFrame> outgoing_frames;
+    };
+
+    /**
+     * @brief 阻塞建立连接
+     * @details 连接建立后由调用方切换为非阻塞。
+     */
+    std::optional<DaneJoe::PosixSocketHandle> connect_endpoint(const NetworkEndpoint& endpoint)
+    {
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_port = htons(endpoint.port);
+        if (::inet_pton(AF_INET, endpoint.ip.c_str(), &address.sin_addr) != 1)
+        {
+            DANEJOE_LOG_WARN("default", "LoadGenerator", "Invalid endpoint address: {}", endpoint.ip);
+            return std::nullopt;
+        }
+        DaneJoe::PosixSocketHandle socket_handle(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (!socket_handle)
+        {
+            return std::nullopt;
+        }
+        auto status_code = socket_handle.connect(reinterpret_cast<const sockaddr*>(&address), sizeof(address));
+        if (!status_code.is_ok())
+        {
+            DANEJOE_LOG_WARN("default", "LoadGenerator", "Failed to connect to {}:{}: {}", endpoint.ip, endpoint.port, status_code.message());
+            return std::nullopt;
+        }
+        int no_delay = 1;
+        ::setsockopt(socket_handle.get_handle().get(), IPPROTO_TCP, TCP_NODELAY, &no_delay, sizeof(no_delay));
+        return socket_handle;
+    }
+
+    /**
+     * @brief 发送单个请求并等待响应
+     * @param endpoint 服务端地址
+     * @param request_data 已编码的请求
+     * @param timeout 超时时间
+     * @param message_codec 消息编解码器
+     * @return 响应信封，连接失败、超时或解析失败时返回 std::nullopt
+     */
+    std::optional<EnvelopeResponseTransfer> send_request(
+        const NetworkEndpoint& endpoint,
+        std::vector<uint8_t>&& request_data,
+        std::chrono::milliseconds timeout,
+        ClientMessageCodec& message_codec)
+    {
+        auto socket_handle = connect_endpoint(endpoint);
+        if (!socket_handle.has_value())
+        {
+            return std::nullopt;
+        }
+        socket_handle->set_blocking(false);
+        int fd = socket_handle->get_handle().get();
+        DaneJoe::ConnectContext context(0, std::move(socket_handle.value()));
+        std::vector<DaneJoe::PosixFrame> frames;
+        frames.push_back({ 0, std::move(request_data), {} });
+        auto write_ret = context.write(std::move(frames));
+        auto deadline = LoadGenerator::Clock::now() + timeout;
+        while (write_ret.status_code().get_status_level() != DaneJoe::StatusLevel::Error && LoadGenerator::Clock::now() < deadline)
+        {
+            pollfd poll_fd{};
+            poll_fd.fd = fd;
+            poll_fd.events = static_cast<short>(POLLIN | (context.has_pending_write() ? POLLOUT : 0));
+            if (::poll(&poll_fd, 1, EPOLL_TIMEOUT_MS) <= 0)
+            {
+                continue;
+            }
+            if (poll_fd.revents & POLLOUT)
+            {
+                write_ret = context.write({});
+            }
+            if (!(poll_fd.revents & POLLIN))
+            {
+                continue;
+            }
+            auto read_ret = context.read();
+            if (read_ret.status_code().get_status_level() == DaneJoe::StatusLevel::Error)
+            {
+                return std::nullopt;
+            }
+            if (!read_ret.has_value() || read_ret.value().empty())
+            {
+                continue;
+            }
+            return message_codec.try_parse_byte_array_response(read_ret.value().front().data);
+        }
+        return std::nullopt;
+    }
+}
+
+const char* to_path(LoadRequestKind kind)
+{
+    switch (kind)
+    {
+        case LoadRequestKind::Test: return "/test";
+        case LoadRequestKind::Download: return "/download";
+        case LoadRequestKind::Block: return "/block";
+        default: return "unknown";
+    }
+}
+
+void LoadPathStats::merge(const LoadPathStats& other)
+{
+    requests += other.requests;
+    errors += other.errors;
+    bytes += other.bytes;
+    latency.merge(other.latency);
+}
+
+LoadGenerator::LoadGenerator(const LoadGeneratorConfig& config) :
+    m_config(config)
+{
+    m_config.client_count = std::max<std::size_t>(m_config.client_count, 1);
+    m_config.thread_count = std::clamp<std::size_t>(m_config.thread_count, 1, m_config.client_count);
+    m_config.pipeline_depth = std::max<std::size_t>(m_config.pipeline_depth, 1);
+    m_config.block_size = std::max<int64_t>(m_config.block_size, 1);
+    // 文件为空时没有可请求的块
+    if (m_config.file_size <= 0)
+    {
+        m_config.block_weight = 0;
+    }
+}
+
+void LoadGenerator::set_measure_callbacks(PhaseCallback on_measure_begin, PhaseCallback on_measure_end)
+{
+    m_on_measure_begin = std::move(on_measure_begin);
+    m_on_measure_end = std::move(on_measure_end);
+}
+
+void LoadGenerator::stop()
+{
+    m_is_stopped.store(true, std::memory_order_release);
+}
+
+std::optional<LoadGeneratorReport> LoadGenerator::run()
+{
+    if (m_config.test_weight + m_config.download_weight + m_config.block_weight == 0)
+    {
+        DANEJOE_LOG_ERROR("default", "LoadGenerator", "All request weights are zero");
+        return std::nullopt;
+    }
+    m_phase.store(Phase::Warmup, std::memory_order_release);
+    std::size_t thread_count = m_config.thread_count;
+    std::vector<LoadGeneratorReport> reports(thread_count);
+    std::vector<std::thread> threads;
+    std::atomic<std::size_t> active_workers = thread_count;
+    for (std::size_t i = 0; i < thread_count; i++)
+    {
+        std::size_t client_count = m_config.client_count / thread_count + (i < m_config.client_count % thread_count ? 1 : 0);
+        threads.emplace_back([this, i, client_count, &reports, &active_workers]()
+            {
+                run_worker(i, client_count, reports[i]);
+                active_workers.fetch_sub(1, std::memory_order_acq_rel);
+            });
+    }
+    // 所有工作线程都已退出（连接失败或断开）时提前结束等待
+    auto wait_until = [this, &active_workers](Clock::time_point deadline)
+        {
+            while (Clock::now() < deadline &&
+                !m_is_stopped.load(std::memory_order_acquire) &&
+                active_workers.load(std::memory_order_acquire) > 0)
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(EPOLL_TIMEOUT_MS));
+            }
+        };
+    wait_until(Clock::now() + m_config.warmup);
+    if (m_on_measure_begin)
+    {
+        m_on_measure_begin();
+    }
+    auto measure_begin = Clock::now();
+    m_phase.store(Phase::Measure, std::memory_order_release);
+    wait_until(measure_begin + m_config.duration);
+    m_phase.store(Phase::Stop, std::memory_order_release);
+    auto measure_end = Clock::now();
+    if (m_on_measure_end)
+    {
+        m_on_measure_end();
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    LoadGeneratorReport report;
+    report.measured = measure_end - measure_begin;
+    for (const auto& thread_report : reports)
+    {
+        report.connected_clients += thread_report.connected_clients;
+        for (std::size_t i = 0; i < report.paths.size(); i++)
+        {
+            report.paths[i].merge(thread_report.paths[i]);
+        }
+    }
+    if (report.connected_clients == 0)
+    {
+        return std::nullopt;
+    }
+    return report;
+}
+
+void LoadGenerator::run_worker(std::size_t thread_index, std::size_t client_count, LoadGeneratorReport& report)
+{
+    DaneJoe::PosixEpollHandle epoll_handle(EPOLL_CLOEXEC);
+    if (!epoll_handle)
+    {
+        DANEJOE_LOG_ERROR("default", "LoadGenerator", "Failed to create epoll fd for worker {}", thread_index);
+        return;
+    }
+    ClientMessageCodec message_codec;
+    // 所有连接指向同一服务端，收到声明支持紧凑编码的响应后后续请求随之升级
+    DaneJoe::SerializeVersion wire_version = DaneJoe::SerializeVersion::Named;
+    std::mt19937_64 random_engine(thread_index + 1);
+    std::discrete_distribution<int> kind_distribution({
+        static_cast<double>(m_config.test_weight),
+        static_cast<double>(m_config.download_weight),
+        static_cast<double>(m_config.block_weight) });
+    uint64_t block_count = m_config.file_size > 0 ?
+        static_cast<uint64_t>((m_config.file_size + m_config.block_size - 1) / m_config.block_size) : 0;
+
+    std::vector<LoadClient> clients;
+    clients.reserve(client_count);
+    for (std::size_t i = 0; i < client_count; i++)
+    {
+        auto socket_handle = connect_endpoint(m_config.endpoint);
+        if (!socket_handle.has_value())
+        {
+            continue;
+        }
+        socket_handle->set_blocking(false);
+        LoadClient client;
+        client.fd = socket_handle->get_handle().get();
+        epoll_event event{};
+        event.events = CONNECTION_EVENTS;
+        event.data.u64 = clients.size();
+        if (!epoll_handle.add(client.fd, &event).is_ok())
+        {
+            continue;
+        }
+        client.context = std::make_unique<DaneJoe::ConnectContext>(clients.size(), std::move(socket_handle.value()));
+        clients.push_back(std::move(client));
+    }
+    report.connected_clients = clients.size();
+    std::size_t open_clients = clients.size();
+
+    auto issue_request = [&](std::size_t client_index)
+        {
+            auto& client = clients[client_index];
+            InFlightRequest request;
+            request.kind = static_cast<LoadRequestKind>(kind_distribution(random_engine));
+            int64_t request_id = client.next_request_id++;
+            std::vector<uint8_t> frame;
+            switch (request.kind)
+            {
+                case LoadRequestKind::Test:
+                {
+                    TestRequestTransfer test_request;
+                    test_request.message = "ping";
+                    frame = message_codec.build_test_request_byte_array(test_request, request_id, wire_version);
+                    break;
+                }
+                case LoadRequestKind::Download:
+                {
+                    DownloadRequestTransfer download_request;
+                    download_request.file_id = m_config.file_id;
+                    download_request.task_id = request_id;
+                    frame = message_codec.build_download_request_byte_array(download_request, request_id, wire_version);
+                    break;
+                }
+                default:
+                {
+                    BlockRequestTransfer block_request;
+                    block_request.block_id = static_cast<int64_t>(random_engine() % block_count);
+                    block_request.file_id = m_config.file_id;
+                    block_request.offset = block_request.block_id * m_config.block_size;
+                    block_request.block_size = std::min(m_config.block_size, m_config.file_size - block_request.offset);
+                    request.expected_bytes = block_request.block_size;
+                    frame = message_codec.build_block_request_byte_array(block_request, request_id, wire_version);
+                    break;
+                }
+            }
+            request.sent_time = Clock::now();
+            client.in_flight.emplace(request_id, request);
+            client.outgoing_frames.push_back({ client_index, std::move(frame), {} });
+        };
+    auto close_client = [&](std::size_t client_index, const std::string& reason)
+        {
+            auto& client = clients[client_index];
+            if (!client.context)
+            {
+                return;
+            }
+            DANEJOE_LOG_WARN("default", "LoadGenerator", "Client {} of worker {} closed: {}", client_index, thread_index, reason);
+            if (m_phase.load(std::memory_order_acquire) == Phase::Measure)
+            {
+                for (const auto& [request_id, request] : client.in_flight)
+                {
+                    report.paths[static_cast<std::size_t>(request.kind)].errors++;
+                }
+            }
+            epoll_handle.remove(client.fd);
+            client.in_flight.clear();
+            client.outgoing_frames.clear();
+            client.context.reset();
+            open_clients--;
+        };
+    auto handle_frame = [&](std::size_t client_index, const std::vector<uint8_t>& frame)
+        {
+            auto response = message_codec.try_parse_byte_array_response(frame);
+            if (!response.has_value())
+            {
+                close_client(client_index, "malformed frame");
+                return;
+            }
+            wire_version = message_codec.get_peer_wire_version(frame, response.value());
+            auto& client = clients[client_index];
+            auto request_it = client.in_flight.find(response->request_id);
+            if (request_it == client.in_flight.end())
+            {
+                return;
+            }
+            InFlightRequest request = request_it->second;
+            client.in_flight.erase(request_it);
+            auto latency = Clock::now() - request.sent_time;
+            bool is_success = response->status == ResponseStatus::Ok;
+            if (is_success && request.kind == LoadRequestKind::Download)
+            {
+                is_success = message_codec.try_parse_byte_array_download_response(response->body).has_value();
+            }
+            else if (is_success && request.kind == LoadRequestKind::Block)
+            {
+                auto block = message_codec.try_parse_byte_array_block_response(response->body);
+                is_success = block.has_value() && static_cast<int64_t>(block->data.size()) == request.expected_bytes;
+            }
+            if (m_phase.load(std::memory_order_acquire) == Phase::Measure)
+            {
+                auto& stats = report.paths[static_cast<std::size_t>(request.kind)];
+                if (is_success)
+                {
+                    stats.requests++;
+                    stats.bytes += frame.size();
+                    stats.latency.record(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(latency).count()));
+                }
+                else
+                {
+                    stats.errors++;
+                }
+            }
+            issue_request(client_index);
+        };
+
+    for (std::size_t i = 0; i < clients.size(); i++)
+    {
+        for (std::size_t j = 0; j < m_config.pipeline_depth; j++)
+        {
+            issue_request(i);
+        }
+    }
+    std::vector<epoll_event> events(MAX_EPOLL_EVENTS);
+    while (open_clients > 0 && m_phase.load(std::memory_order_acquire) != Phase::Stop)
+    {
+        for (std::size_t i = 0; i < clients.size(); i++)
+        {
+            auto& client = clients[i];
+            if (!client.context || (client.outgoing_frames.empty() && !client.context->has_pending_write()))
+            {
+                continue;
+            }
+            auto write_ret = client.context->write(std::move(client.outgoing_frames));
+            client.outgoing_frames.clear();
+            if (write_ret.status_code().get_status_level() == DaneJoe::StatusLevel::Error)
+            {
+                close_client(i, write_ret.status_code().message());
+                continue;
+            }
+            bool is_watching_write = client.context->has_pending_write();
+            if (is_watching_write != client.is_watching_write)
+            {
+                epoll_event event{};
+                event.events = CONNECTION_EVENTS | (is_watching_write ? static_cast<uint32_t>(EPOLLOUT) : 0u);
+                event.data.u64 = i;
+                epoll_handle.modify(client.fd, &event);
+                client.is_watching_write = is_watching_write;
+            }
+        }
+        auto wait_ret = epoll_handle.wait(events.data(), MAX_EPOLL_EVENTS, EPOLL_TIMEOUT_MS);
+        if (wait_ret.status_code().get_status_level() == DaneJoe::StatusLevel::Error)
+        {
+            DANEJOE_LOG_ERROR("default", "LoadGenerator", "epoll wait failed: {}", wait_ret.status_code().message());
+            break;
+        }
+        int event_count = wait_ret.has_value() ? wait_ret.value() : 0;
+        for (int i = 0; i < event_count; i++)
+        {
+            std::size_t client_index = static_cast<std::size_t>(events[i].data.u64);
+            if (!clients[client_index].context)
+            {
+                continue;
+            }
+            if (events[i].events & EPOLLIN)
+            {
+                auto read_ret = clients[client_index].context->read();
+                if (read_ret.status_code().get_status_level() == DaneJoe::StatusLevel::Error)
+                {
+                    close_client(client_index, read_ret.status_code().message());
+                    continue;
+                }
+                if (read_ret.has_value())
+                {
+                    for (const auto& frame : read_ret.value())
+                    {
+                        if (!clients[client_index].context)
+                        {
+                            break;
+                        }
+                        handle_frame(client_index, frame.data);
+                    }
+                }
+            }
+            if (events[i].events & (EPOLLRDHUP | EPOLLHUP | EPOLLERR))
+            {
+                close_client(client_index, "peer closed");
+            }
+        }
+    }
+}
+
+std::optional<int64_t> LoadGenerator::probe_file_size(
+    const NetworkEndpoint& endpoint,
+    int64_t file_id,
+    std::chrono::milliseconds timeout)
+{
+    ClientMessageCodec message_codec;
+    DownloadRequestTransfer download_request;
+    download_request.file_id = file_id;
+    auto response = send_request(endpoint, message_codec.build_download_request_byte_array(download_request, 1), timeout, message_codec);
+    if (!response.has_value() || response->status != ResponseStatus::Ok)
+    {
+        return std::nullopt;
+    }
+    auto info = message_codec.try_parse_byte_array_download_response(response->body);
+    if (!info.has_value() || (info->file_name.empty() && info->md5_code.empty()) || info->file_size < 0)
+    {
+        return std::nullopt;
+    }
+    return info->file_size;
+}
+
+std::optional<std::string> LoadGenerator::fetch_metrics(
+    const NetworkEndpoint& endpoint,
+    std::chrono::milliseconds timeout)
+{
+    ClientMessageCodec message_codec;
+    auto response = send_request(endpoint, message_codec.build_metrics_request_byte_array(1), timeout, message_codec);
+    if (!response.has_value() || response->status != ResponseStatus::Ok)
+    {
+        return std::nullopt;
+    }
+    auto info = message_codec.try_parse_byte_array_test_response(response->body);
+    if (!info.has_value())
+    {
+        return std::nullopt;
+    }
+    return info->message;
+}
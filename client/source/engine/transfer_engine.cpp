@@ -0,0 +1,812 @@
+#include <array>
+#include <cctype>
+#include <format>
+#include <algorithm>
+#include <filesystem>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+
+#include "danejoe/logger/logger_manager.hpp"
+
+#include "engine/transfer_engine.hpp"
+#include "model/transfer/download_transfer.hpp"
+
+namespace
+{
+    /// @brief 写线程通知在 epoll 中的标识（连接ID从 1 开始）
+    constexpr uint64_t WRITER_EVENT_TAG = 0;
+    /// @brief 单次 epoll_wait 处理的最大事件数
+    constexpr int MAX_EPOLL_EVENTS = 64;
+    /// @brief epoll_wait 超时（毫秒），同时决定超时检查与进度回调的最大延迟
+    constexpr int EPOLL_TIMEOUT_MS = 100;
+    /// @brief 连接的基础监听事件
+    constexpr uint32_t CONNECTION_EVENTS = EPOLLIN | EPOLLRDHUP;
+
+    std::string to_lower(std::string text)
+    {
+        std::transform(text.begin(), text.end(), text.begin(), [](unsigned char c)
+            {
+                return static_cast<char>(std::tolower(c));
+            });
+        return text;
+    }
+}
+
+TransferEngine::TransferEngine(const TransferEngineConfig& config) :
+    m_config(config),
+    m_epoll(EPOLL_CLOEXEC),
+    m_writer_event_handle(0, EFD_NONBLOCK | EFD_CLOEXEC)
+{
+    m_config.connections_per_endpoint = std::max<std::size_t>(1, m_config.connections_per_endpoint);
+    m_config.block_size = std::max<int64_t>(1, m_config.block_size);
+    m_config.max_in_flight_blocks = std::max<std::size_t>(1, m_config.max_in_flight_blocks);
+    m_config.max_active_downloads = std::max<std::size_t>(1, m_config.max_active_downloads);
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.u64 = WRITER_EVENT_TAG;
+    auto status_code = m_epoll.add(m_writer_event_handle.get_handle().get(), &event);
+    if (!status_code.is_ok())
+    {
+        DANEJOE_LOG_ERROR("default", "TransferEngine", "Failed to watch writer event fd: {}", status_code.message());
+    }
+}
+
+TransferEngine::~TransferEngine()
+{
+}
+
+void TransferEngine::add_download(const DownloadJob& job)
+{
+    DownloadState download;
+    download.result.job = job;
+    m_downloads.push_back(std::move(download));
+    m_queued_downloads.push_back(m_downloads.size() - 1);
+}
+
+void TransferEngine::set_progress_callback(ProgressCallback callback, std::chrono::milliseconds interval)
+{
+    m_progress_callback = std::move(callback);
+    m_progress_interval = interval;
+}
+
+std::vector<DownloadResult> TransferEngine::run()
+{
+    m_start_time = Clock::now();
+    auto next_progress_time = m_start_time + m_progress_interval;
+    auto next_expire_time = m_start_time;
+    std::array<epoll_event, MAX_EPOLL_EVENTS> events;
+    while (m_finished_downloads < m_downloads.size())
+    {
+        if (m_is_stopped.load(std::memory_order_acquire))
+        {
+            abort_downloads("stopped");
+            break;
+        }
+        start_queued_downloads();
+        dispatch_blocks();
+        flush_connections();
+        if (m_finished_downloads >= m_downloads.size())
+        {
+            break;
+        }
+        auto wait_ret = m_epoll.wait(events.data(), MAX_EPOLL_EVENTS, EPOLL_TIMEOUT_MS);
+        if (wait_ret.status_code().get_status_level() == DaneJoe::StatusLevel::Error)
+        {
+            DANEJOE_LOG_ERROR("default", "TransferEngine", "epoll wait failed: {}", wait_ret.status_code().message());
+            abort_downloads("epoll wait failed");
+            break;
+        }
+        int event_count = wait_ret.has_value() ? wait_ret.value() : 0;
+        for (int i = 0; i < event_count; i++)
+        {
+            if (events[i].data.u64 == WRITER_EVENT_TAG)
+            {
+                m_writer_event_handle.read();
+                continue;
+            }
+            handle_connection_event(events[i].data.u64, events[i].events);
+        }
+        process_writer_events();
+        auto now = Clock::now();
+        if (now >= next_expire_time)
+        {
+            expire_requests(now);
+            next_expire_time = now + std::chrono::milliseconds(EPOLL_TIMEOUT_MS);
+        }
+        if (m_progress_callback && now >= next_progress_time)
+        {
+            m_progress_callback(get_progress(now));
+            next_progress_time = now + m_progress_interval;
+        }
+    }
+    if (m_progress_callback)
+    {
+        m_progress_callback(get_progress(Clock::now()));
+    }
+    std::vector<DownloadResult> results;
+    results.reserve(m_downloads.size());
+    for (const auto& download : m_downloads)
+    {
+        results.push_back(download.result);
+    }
+    return results;
+}
+
+void TransferEngine::stop()
+{
+    m_is_stopped.store(true, std::memory_order_release);
+    m_writer_event_handle.write(1);
+}
+
+void TransferEngine::start_queued_downloads()
+{
+    while (m_active_downloads.size() < m_config.max_active_downloads && !m_queued_downloads.empty())
+    {
+        std::size_t download_index = m_queued_downloads.front();
+        m_queued_downloads.pop_front();
+        auto& download = m_downloads[download_index];
+        download.phase = DownloadPhase::Requesting;
+        download.start_time = Clock::now();
+        m_active_downloads.push_back(download_index);
+        send_download_request(download_index, 0);
+    }
+}
+
+TransferEngine::EndpointPool* TransferEngine::ensure_endpoint_pool(const NetworkEndpoint& endpoint)
+{
+    auto& pool = m_endpoint_pools[endpoint];
+    if (pool.connect_ids.empty())
+    {
+        for (std::size_t i = 0; i < m_config.connections_per_endpoint; i++)
+        {
+            pool.connect_ids.push_back(0);
+            pool.balancer.add_slot();
+        }
+    }
+    auto is_alive = [](uint64_t connect_id)
+        {
+            return connect_id != 0;
+        };
+    // 只在全部连接都断开时重连：部分连接断开时其余连接仍可承载请求，避免对故障服务端反复阻塞连接
+    if (std::none_of(pool.connect_ids.begin(), pool.connect_ids.end(), is_alive))
+    {
+        for (std::size_t slot = 0; slot < pool.connect_ids.size(); slot++)
+        {
+            pool.connect_ids[slot] = open_connection(endpoint, slot).value_or(0);
+        }
+    }
+    if (std::none_of(pool.connect_ids.begin(), pool.connect_ids.end(), is_alive))
+    {
+        return nullptr;
+    }
+    return &pool;
+}
+
+std::optional<uint64_t> TransferEngine::open_connection(const NetworkEndpoint& endpoint, std::size_t slot)
+{
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(endpoint.port);
+    if (::inet_pton(AF_INET, endpoint.ip.c_str(), &address.sin_addr) != 1)
+    {
+        DANEJOE_LOG_WARN("default", "TransferEngine", "Invalid endpoint address: {}", endpoint.ip);
+        return std::nullopt;
+    }
+    DaneJoe::PosixSocketHandle socket_handle(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (!socket_handle)
+    {
+        DANEJOE_LOG_WARN("default", "TransferEngine", "Failed to create socket for {}:{}", endpoint.ip, endpoint.port);
+        return std::nullopt;
+    }
+    // 阻塞连接，连接建立后再切换为非阻塞，交由 epoll 驱动
+    auto status_code = socket_handle.connect(reinterpret_cast<const sockaddr*>(&address), sizeof(address));
+    if (!status_code.is_ok())
+    {
+        DANEJOE_LOG_WARN("default", "TransferEngine", "Failed to connect to {}:{}: {}", endpoint.ip, endpoint.port, status_code.message());
+        return std::nullopt;
+    }
+    socket_handle.set_blocking(false);
+    int fd = socket_handle.get_handle().get();
+    int no_delay = 1;
+    ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &no_delay, sizeof(no_delay));
+    uint64_t connect_id = m_next_connect_id++;
+    epoll_event event{};
+    event.events = CONNECTION_EVENTS;
+    event.data.u64 = connect_id;
+    status_code = m_epoll.add(fd, &event);
+    if (!status_code.is_ok())
+    {
+        DANEJOE_LOG_WARN("default", "TransferEngine", "Failed to watch connection to {}:{}: {}", endpoint.ip, endpoint.port, status_code.message());
+        return std::nullopt;
+    }
+    Connection connection;
+    connection.endpoint = endpoint;
+    connection.slot = slot;
+    connection.fd = fd;
+    connection.context = std::make_unique<DaneJoe::ConnectContext>(connect_id, std::move(socket_handle));
+    m_connections.emplace(connect_id, std::move(connection));
+    DANEJOE_LOG_INFO("default", "TransferEngine", "Connected to {}:{}: connect_id={}, slot={}", endpoint.ip, endpoint.port, connect_id, slot);
+    return connect_id;
+}
+
+void TransferEngine::close_connection(uint64_t connect_id, const std::string& reason)
+{
+    auto node = m_connections.extract(connect_id);
+    if (node.empty())
+    {
+        return;
+    }
+    auto& connection = node.mapped();
+    DANEJOE_LOG_WARN("default", "TransferEngine", "Connection to {}:{} closed: connect_id={}, in_flight={}, reason={}",
+        connection.endpoint.ip,
+        connection.endpoint.port,
+        connect_id,
+        connection.request_ids.size(),
+        reason);
+    m_epoll.remove(connection.fd);
+    auto pool_it = m_endpoint_pools.find(connection.endpoint);
+    if (pool_it != m_endpoint_pools.end())
+    {
+        pool_it->second.connect_ids[connection.slot] = 0;
+    }
+    // 连接已从表中移除，重新排队的请求不会再选中它
+    for (uint64_t request_id : connection.request_ids)
+    {
+        auto pending_node = m_pending_requests.extract(request_id);
+        if (pending_node.empty())
+        {
+            continue;
+        }
+        if (pool_it != m_endpoint_pools.end())
+        {
+            pool_it->second.balancer.on_finished(request_id);
+        }
+        retry_request(pending_node.mapped(), reason);
+    }
+}
+
+std::optional<uint64_t> TransferEngine::select_connection(const NetworkEndpoint& endpoint)
+{
+    auto* pool = ensure_endpoint_pool(endpoint);
+    if (!pool)
+    {
+        return std::nullopt;
+    }
+    std::optional<uint64_t> selected_id;
+    int64_t selected_bytes = 0;
+    for (std::size_t slot = 0; slot < pool->connect_ids.size(); slot++)
+    {
+        if (pool->connect_ids[slot] == 0)
+        {
+            continue;
+        }
+        int64_t bytes = pool->balancer.get_outstanding_bytes(slot);
+        if (!selected_id.has_value() || bytes < selected_bytes)
+        {
+            selected_id = pool->connect_ids[slot];
+            selected_bytes = bytes;
+        }
+    }
+    return selected_id;
+}
+
+void TransferEngine::send_request(uint64_t connect_id, uint64_t request_id, std::vector<uint8_t> frame, PendingRequest pending, int64_t expected_bytes)
+{
+    auto& connection = m_connections.at(connect_id);
+    connection.outgoing_frames.push_back({ connect_id, std::move(frame), {} });
+    connection.request_ids.insert(request_id);
+    m_endpoint_pools[connection.endpoint].balancer.on_dispatched(request_id, connection.slot, expected_bytes);
+    pending.connect_id = connect_id;
+    pending.sent_time = Clock::now();
+    m_pending_requests.emplace(request_id, std::move(pending));
+}
+
+void TransferEngine::send_download_request(std::size_t download_index, int retry_count)
+{
+    auto& download = m_downloads[download_index];
+    const auto& job = download.result.job;
+    auto connect_id_opt = select_connection(job.endpoint);
+    if (!connect_id_opt.has_value())
+    {
+        finish_download(download_index, false, std::format("no connection to {}:{}", job.endpoint.ip, job.endpoint.port));
+        return;
+    }
+    DownloadRequestTransfer request;
+    request.file_id = job.file_id;
+    request.task_id = static_cast<int64_t>(download_index);
+    PendingRequest pending;
+    pending.kind = RequestKind::Download;
+    pending.download_index = download_index;
+    pending.retry_count = retry_count;
+    uint64_t request_id = m_next_request_id++;
+    auto frame = m_message_codec.build_download_request_byte_array(
+        request, static_cast<int64_t>(request_id), m_endpoint_pools[job.endpoint].wire_version);
+    send_request(connect_id_opt.value(), request_id, std::move(frame), std::move(pending), 0);
+}
+
+bool TransferEngine::send_block_request(std::size_t download_index, BlockAttempt attempt)
+{
+    const auto& job = m_downloads[download_index].result.job;
+    auto connect_id_opt = select_connection(job.endpoint);
+    if (!connect_id_opt.has_value())
+    {
+        return false;
+    }
+    int64_t block_size = attempt.block.block_size;
+    uint64_t request_id = m_next_request_id++;
+    auto frame = m_message_codec.build_block_request_byte_array(
+        attempt.block, static_cast<int64_t>(request_id), m_endpoint_pools[job.endpoint].wire_version);
+    PendingRequest pending;
+    pending.kind = RequestKind::Block;
+    pending.download_index = download_index;
+    pending.attempt = std::move(attempt);
+    send_request(connect_id_opt.value(), request_id, std::move(frame), std::move(pending), block_size);
+    return true;
+}
+
+void TransferEngine::dispatch_blocks()
+{
+    // finish_download 会修改活动列表，按副本遍历
+    auto active_downloads = m_active_downloads;
+    for (std::size_t download_index : active_downloads)
+    {
+        auto& download = m_downloads[download_index];
+        while (download.phase == DownloadPhase::Transferring &&
+            download.in_flight_blocks < m_config.max_in_flight_blocks)
+        {
+            BlockAttempt attempt;
+            if (!download.retry_blocks.empty())
+            {
+                attempt = download.retry_blocks.front();
+                download.retry_blocks.pop_front();
+            }
+            else if (download.next_offset < download.result.file_size)
+            {
+                attempt.block.block_id = download.next_block_id++;
+                attempt.block.file_id = download.result.job.file_id;
+                attempt.block.task_id = static_cast<int64_t>(download_index);
+                attempt.block.offset = download.next_offset;
+                attempt.block.block_size = std::min(m_config.block_size, download.result.file_size - download.next_offset);
+                download.next_offset += attempt.block.block_size;
+            }
+            else
+            {
+                break;
+            }
+            if (!send_block_request(download_index, std::move(attempt)))
+            {
+                const auto& endpoint = download.result.job.endpoint;
+                finish_download(download_index, false, std::format("no connection to {}:{}", endpoint.ip, endpoint.port));
+                break;
+            }
+            download.in_flight_blocks++;
+        }
+    }
+}
+
+void TransferEngine::handle_connection_event(uint64_t connect_id, uint32_t events)
+{
+    auto it = m_connections.find(connect_id);
+    if (it == m_connections.end())
+    {
+        return;
+    }
+    if (events & EPOLLIN)
+    {
+        auto read_ret = it->second.context->read();
+        if (read_ret.status_code().get_status_level() == DaneJoe::StatusLevel::Error)
+        {
+            close_connection(connect_id, read_ret.status_code().message());
+            return;
+        }
+        // 处理响应不会移除连接，迭代器保持有效
+        if (read_ret.has_value())
+        {
+            for (const auto& frame : read_ret.value())
+            {
+                handle_frame(connect_id, frame.data);
+            }
+        }
+    }
+    if (events & (EPOLLRDHUP | EPOLLHUP | EPOLLERR))
+    {
+        close_connection(connect_id, "peer closed");
+    }
+    // 可写事件由 flush_connections 统一处理
+}
+
+void TransferEngine::handle_frame(uint64_t connect_id, const std::vector<uint8_t>& frame)
+{
+    auto response_opt = m_message_codec.try_parse_byte_array_response(frame);
+    if (!response_opt.has_value())
+    {
+        DANEJOE_LOG_WARN("default", "TransferEngine", "Dropped malformed frame: connect_id={}, size={}", connect_id, frame.size());
+        return;
+    }
+    auto connection_it = m_connections.find(connect_id);
+    if (connection_it != m_connections.end())
+    {
+        m_endpoint_pools[connection_it->second.endpoint].wire_version =
+            m_message_codec.get_peer_wire_version(frame, response_opt.value());
+    }
+    auto pending_opt = take_pending_request(response_opt->request_id);
+    if (!pending_opt.has_value())
+    {
+        // 已超时重发或所属下载已结束
+        DANEJOE_LOG_DEBUG("default", "TransferEngine", "Dropped late response: connect_id={}, request_id={}", connect_id, response_opt->request_id);
+        return;
+    }
+    switch (pending_opt->kind)
+    {
+        case RequestKind::Download:
+            handle_download_response(pending_opt.value(), response_opt.value());
+            break;
+        case RequestKind::Block:
+            handle_block_response(pending_opt.value(), response_opt.value());
+            break;
+    }
+}
+
+std::optional<TransferEngine::PendingRequest> TransferEngine::take_pending_request(uint64_t request_id)
+{
+    auto node = m_pending_requests.extract(request_id);
+    if (node.empty())
+    {
+        return std::nullopt;
+    }
+    auto connection_it = m_connections.find(node.mapped().connect_id);
+    if (connection_it != m_connections.end())
+    {
+        connection_it->second.request_ids.erase(request_id);
+        m_endpoint_pools[connection_it->second.endpoint].balancer.on_finished(request_id);
+    }
+    return std::move(node.mapped());
+}
+
+void TransferEngine::handle_download_response(const PendingRequest& pending, const EnvelopeResponseTransfer& response)
+{
+    std::size_t download_index = pending.download_index;
+    auto& download = m_downloads[download_index];
+    if (download.phase != DownloadPhase::Requesting)
+    {
+        return;
+    }
+    if (response.status != ResponseStatus::Ok)
+    {
+        finish_download(download_index, false, std::format("download request rejected: {}", to_string(response.status)));
+        return;
+    }
+    auto info_opt = m_message_codec.try_parse_byte_array_download_response(response.body);
+    if (!info_opt.has_value())
+    {
+        finish_download(download_index, false, "malformed download response");
+        return;
+    }
+    if ((info_opt->file_name.empty() && info_opt->md5_code.empty()) || info_opt->file_size < 0)
+    {
+        finish_download(download_index, false, std::format("file {} not found on server", download.result.job.file_id));
+        return;
+    }
+    download.result.file_name = info_opt->file_name;
+    download.result.file_size = info_opt->file_size;
+    download.result.md5_code = info_opt->md5_code;
+    const auto& output_path = download.result.job.output_path;
+    // open_file 不截断已有文件，先移除旧文件以免残留超出新文件长度的数据
+    std::error_code error_code;
+    std::filesystem::remove(output_path, error_code);
+    std::optional<DaneJoe::FileDigest> digest;
+    if (m_config.is_verify_md5 && !download.result.md5_code.empty())
+    {
+        digest = DaneJoe::FileDigest();
+    }
+    download.writer_file_id = m_file_writer.open_file(output_path, download.result.file_size, std::move(digest));
+    if (!download.writer_file_id.has_value())
+    {
+        finish_download(download_index, false, std::format("failed to open {}", output_path));
+        return;
+    }
+    DANEJOE_LOG_INFO("default", "TransferEngine", "Download started: file_id={}, file_name={}, file_size={}, output={}",
+        download.result.job.file_id,
+        download.result.file_name,
+        download.result.file_size,
+        output_path);
+    download.phase = DownloadPhase::Transferring;
+    if (download.result.file_size == 0)
+    {
+        finish_transfer(download_index);
+    }
+}
+
+void TransferEngine::handle_block_response(PendingRequest& pending, const EnvelopeResponseTransfer& response)
+{
+    std::size_t download_index = pending.download_index;
+    auto& download = m_downloads[download_index];
+    if (download.phase != DownloadPhase::Transferring)
+    {
+        return;
+    }
+    if (response.status != ResponseStatus::Ok)
+    {
+        retry_request(pending, std::format("block request rejected: {}", to_string(response.status)));
+        return;
+    }
+    auto block_opt = m_message_codec.try_parse_byte_array_block_response(response.body);
+    const auto& request = pending.attempt.block;
+    if (!block_opt.has_value() ||
+        block_opt->offset != request.offset ||
+        static_cast<int64_t>(block_opt->data.size()) != request.block_size)
+    {
+        retry_request(pending, "malformed or short block response");
+        return;
+    }
+    download.in_flight_blocks--;
+    int64_t bytes = request.block_size;
+    m_received_bytes += bytes;
+    m_file_writer.write(download.writer_file_id.value(), block_opt->offset, std::move(block_opt->data),
+        [this, download_index, bytes](bool is_success)
+        {
+            WriterEvent event;
+            event.kind = WriterEventKind::Write;
+            event.download_index = download_index;
+            event.is_success = is_success;
+            event.bytes = bytes;
+            post_writer_event(std::move(event));
+        });
+}
+
+void TransferEngine::retry_request(PendingRequest& pending, const std::string& reason)
+{
+    std::size_t download_index = pending.download_index;
+    auto& download = m_downloads[download_index];
+    if (download.phase == DownloadPhase::Finished)
+    {
+        return;
+    }
+    if (pending.kind == RequestKind::Download)
+    {
+        if (pending.retry_count >= m_config.max_retries)
+        {
+            finish_download(download_index, false, std::format("download request failed: {}", reason));
+            return;
+        }
+        send_download_request(download_index, pending.retry_count + 1);
+        return;
+    }
+    download.in_flight_blocks--;
+    auto& attempt = pending.attempt;
+    if (attempt.retry_count >= m_config.max_retries)
+    {
+        finish_download(download_index, false, std::format("block at offset {} failed: {}", attempt.block.offset, reason));
+        return;
+    }
+    attempt.retry_count++;
+    DANEJOE_LOG_DEBUG("default", "TransferEngine", "Retrying block: file_id={}, offset={}, retry={}, reason={}",
+        attempt.block.file_id,
+        attempt.block.offset,
+        attempt.retry_count,
+        reason);
+    download.retry_blocks.push_back(std::move(attempt));
+}
+
+void TransferEngine::finish_transfer(std::size_t download_index)
+{
+    auto& download = m_downloads[download_index];
+    download.phase = DownloadPhase::Finishing;
+    m_file_writer.checkpoint(download.writer_file_id.value(),
+        [this, download_index](bool is_success, std::optional<DaneJoe::Md5> md5)
+        {
+            WriterEvent event;
+            event.kind = WriterEventKind::Checkpoint;
+            event.download_index = download_index;
+            event.is_success = is_success;
+            event.md5 = std::move(md5);
+            post_writer_event(std::move(event));
+        });
+}
+
+void TransferEngine::post_writer_event(WriterEvent event)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_writer_event_mutex);
+        m_writer_events.push_back(std::move(event));
+    }
+    m_writer_event_handle.write(1);
+}
+
+void TransferEngine::process_writer_events()
+{
+    std::vector<WriterEvent> events;
+    {
+        std::lock_guard<std::mutex> lock(m_writer_event_mutex);
+        events.swap(m_writer_events);
+    }
+    for (auto& event : events)
+    {
+        std::size_t download_index = event.download_index;
+        auto& download = m_downloads[download_index];
+        if (download.phase == DownloadPhase::Finished)
+        {
+            continue;
+        }
+        switch (event.kind)
+        {
+            case WriterEventKind::Write:
+                if (!event.is_success)
+                {
+                    finish_download(download_index, false, "failed to write block");
+                    break;
+                }
+                download.written_bytes += event.bytes;
+                if (download.phase == DownloadPhase::Transferring && download.written_bytes >= download.result.file_size)
+                {
+                    finish_transfer(download_index);
+                }
+                break;
+            case WriterEventKind::Checkpoint:
+            {
+                if (!event.is_success)
+                {
+                    finish_download(download_index, false, "failed to sync file");
+                    break;
+                }
+                if (m_config.is_verify_md5 && !download.result.md5_code.empty())
+                {
+                    std::string expected = to_lower(download.result.md5_code);
+                    std::string actual = event.md5.has_value() &&
+                        static_cast<int64_t>(event.md5->get_size()) == download.result.file_size ?
+                        event.md5->get_hex_digest() : std::string("none");
+                    if (actual != expected)
+                    {
+                        finish_download(download_index, false, std::format("md5 mismatch: expected {}, got {}", expected, actual));
+                        break;
+                    }
+                }
+                uint64_t file_id = download.writer_file_id.value();
+                download.writer_file_id.reset();
+                m_file_writer.close_file(file_id, [this, download_index](bool is_success)
+                    {
+                        WriterEvent close_event;
+                        close_event.kind = WriterEventKind::Close;
+                        close_event.download_index = download_index;
+                        close_event.is_success = is_success;
+                        post_writer_event(std::move(close_event));
+                    });
+                break;
+            }
+            case WriterEventKind::Close:
+                finish_download(download_index, event.is_success, event.is_success ? std::string() : "failed to close file");
+                break;
+        }
+    }
+}
+
+void TransferEngine::expire_requests(Clock::time_point now)
+{
+    std::vector<uint64_t> expired_ids;
+    for (const auto& [request_id, pending] : m_pending_requests)
+    {
+        if (now - pending.sent_time >= m_config.request_timeout)
+        {
+            expired_ids.push_back(request_id);
+        }
+    }
+    for (uint64_t request_id : expired_ids)
+    {
+        auto pending_opt = take_pending_request(request_id);
+        if (pending_opt.has_value())
+        {
+            retry_request(pending_opt.value(), "timeout");
+        }
+    }
+}
+
+void TransferEngine::flush_connections()
+{
+    std::vector<std::pair<uint64_t, std::string>> broken_connections;
+    for (auto& [connect_id, connection] : m_connections)
+    {
+        if (connection.outgoing_frames.empty() && !connection.context->has_pending_write())
+        {
+            continue;
+        }
+        auto write_ret = connection.context->write(std::move(connection.outgoing_frames));
+        connection.outgoing_frames.clear();
+        if (write_ret.status_code().get_status_level() == DaneJoe::StatusLevel::Error)
+        {
+            broken_connections.emplace_back(connect_id, write_ret.status_code().message());
+            continue;
+        }
+        bool is_watching_write = connection.context->has_pending_write();
+        if (is_watching_write != connection.is_watching_write)
+        {
+            epoll_event event{};
+            event.events = CONNECTION_EVENTS | (is_watching_write ? static_cast<uint32_t>(EPOLLOUT) : 0u);
+            event.data.u64 = connect_id;
+            m_epoll.modify(connection.fd, &event);
+            connection.is_watching_write = is_watching_write;
+        }
+    }
+    for (const auto& [connect_id, reason] : broken_connections)
+    {
+        close_connection(connect_id, reason);
+    }
+}
+
+void TransferEngine::finish_download(std::size_t download_index, bool is_success, const std::string& error)
+{
+    auto& download = m_downloads[download_index];
+    if (download.phase == DownloadPhase::Finished)
+    {
+        return;
+    }
+    bool is_started = download.phase != DownloadPhase::Queued;
+    download.phase = DownloadPhase::Finished;
+    download.result.is_success = is_success;
+    download.result.error = error;
+    m_finished_downloads++;
+    if (is_success)
+    {
+        m_succeeded_downloads++;
+    }
+    if (!is_started)
+    {
+        return;
+    }
+    download.result.elapsed = Clock::now() - download.start_time;
+    m_active_downloads.erase(std::remove(m_active_downloads.begin(), m_active_downloads.end(), download_index), m_active_downloads.end());
+    const auto& job = download.result.job;
+    if (is_success)
+    {
+        DANEJOE_LOG_INFO("default", "TransferEngine", "Download finished: file_id={}, file_size={}, output={}, elapsed_ms={}",
+            job.file_id,
+            download.result.file_size,
+            job.output_path,
+            std::chrono::duration_cast<std::chrono::milliseconds>(download.result.elapsed).count());
+        return;
+    }
+    DANEJOE_LOG_WARN("default", "TransferEngine", "Download failed: file_id={}, output={}, error={}", job.file_id, job.output_path, error);
+    std::vector<uint64_t> request_ids;
+    for (const auto& [request_id, pending] : m_pending_requests)
+    {
+        if (pending.download_index == download_index)
+        {
+            request_ids.push_back(request_id);
+        }
+    }
+    for (uint64_t request_id : request_ids)
+    {
+        take_pending_request(request_id);
+    }
+    download.retry_blocks.clear();
+    download.in_flight_blocks = 0;
+    if (download.writer_file_id.has_value())
+    {
+        m_file_writer.close_file(download.writer_file_id.value());
+        download.writer_file_id.reset();
+    }
+}
+
+void TransferEngine::abort_downloads(const std::string& reason)
+{
+    m_is_stopped.store(true, std::memory_order_release);
+    m_queued_downloads.clear();
+    for (std::size_t i = 0; i < m_downloads.size(); i++)
+    {
+        finish_download(i, false, reason);
+    }
+}
+
+TransferEngineProgress TransferEngine::get_progress(Clock::time_point now)const
+{
+    TransferEngineProgress progress;
+    progress.total_downloads = m_downloads.size();
+    progress.succeeded_downloads = m_succeeded_downloads;
+    progress.failed_downloads = m_finished_downloads - m_succeeded_downloads;
+    progress.received_bytes = m_received_bytes;
+    progress.elapsed = now - m_start_time;
+    return progress;
+}
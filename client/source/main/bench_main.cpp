@@ -0,0 +1,696 @@
+/**
+ * @file bench_main.cpp
+ * @author DaneJoe001 (danejoe001.github)
+ * @brief 端到端吞吐基准
+ * @date 2026-01-11
+ * @details 两种运行方式：
+ *          - --server <ProjectTransServerHeadless>：生成随机测试文件，启动无界面服务端子进程并登记该文件，
+ *            通过子进程标准输出获得文件ID与服务端分配次数，结束后停止子进程并清理临时文件；
+ *          - --endpoint <ip:port>：压测已运行的服务端，可用 --server-pid 指定进程以统计 CPU。
+ *          结果以 JSON 输出，便于在版本之间比对；--metrics 可另存压测结束时服务端的 /metrics 指标文本。
+ */
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <optional>
+#include <exception>
+#include <filesystem>
+#include <string_view>
+#include <fcntl.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "danejoe/common/system/allocation_counter.hpp"
+#include "danejoe/logger/logger_manager.hpp"
+
+#include "engine/load_generator.hpp"
+
+namespace fs = std::filesystem;
+
+namespace
+{
+    /// @brief 收到 SIGINT/SIGTERM 后置位，由主线程转交给负载生成器
+    volatile std::sig_atomic_t g_is_interrupted = 0;
+
+    void handle_signal(int)
+    {
+        g_is_interrupted = 1;
+    }
+
+    void print_usage(const char* program)
+    {
+        std::fprintf(stderr,
+            "Usage: %s (--server <headless_server> | --endpoint <ip:port>) [options]\n"
+            "Target:\n"
+            "  --server <path>        spawn a headless server with a generated fixture file\n"
+            "  --file-size <MiB>      fixture size when spawning (default 64)\n"
+            "  --endpoint <ip:port>   benchmark an already running server\n"
+            "  --server-pid <pid>     process of the running server, for CPU accounting\n"
+            "  --file-id <id>         file requested by /download and /block (default 1)\n"
+            "Load:\n"
+            "  -c <count>             simulated clients, one connection each (default 16)\n"
+            "  -t <count>             load generator threads (default 2)\n"
+            "  -p <count>             in-flight requests per client (default 4)\n"
+            "  -b <KiB>               block size (default 64)\n"
+            "  --mix <t:d:b>          request weights for /test, /download, /block (default 1:1:8)\n"
+            "  --warmup <seconds>     warmup before measuring (default 2)\n"
+            "  --duration <seconds>   measurement window (default 10)\n"
+            "Output:\n"
+            "  --output <path>        write the JSON report to a file instead of stdout\n"
+            "  --metrics <path>       write the server's /metrics text after the run\n"
+            "  -v                     verbose logging\n",
+            program);
+    }
+
+    std::optional<int64_t> parse_integer(std::string_view text)
+    {
+        if (text.empty())
+        {
+            return std::nullopt;
+        }
+        try
+        {
+            std::size_t parsed = 0;
+            int64_t value = std::stoll(std::string(text), &parsed);
+            if (parsed != text.size())
+            {
+                return std::nullopt;
+            }
+            return value;
+        }
+        catch (const std::exception&)
+        {
+            return std::nullopt;
+        }
+    }
+
+    std::optional<NetworkEndpoint> parse_endpoint(std::string_view text)
+    {
+        auto colon = text.rfind(':');
+        if (colon == std::string_view::npos)
+        {
+            return std::nullopt;
+        }
+        auto port = parse_integer(text.substr(colon + 1));
+        if (!port.has_value() || port.value() <= 0 || port.value() > 65535)
+        {
+            return std::nullopt;
+        }
+        return NetworkEndpoint{ std::string(text.substr(0, colon)), static_cast<uint16_t>(port.value()) };
+    }
+
+    bool parse_mix(std::string_view text, LoadGeneratorConfig& config)
+    {
+        std::vector<int64_t> weights;
+        while (true)
+        {
+            auto colon = text.find(':');
+            auto weight = parse_integer(text.substr(0, colon));
+            if (!weight.has_value() || weight.value() < 0)
+            {
+                return false;
+            }
+            weights.push_back(weight.value());
+            if (colon == std::string_view::npos)
+            {
+                break;
+            }
+            text = text.substr(colon + 1);
+        }
+        if (weights.size() != 3)
+        {
+            return false;
+        }
+        config.test_weight = static_cast<uint32_t>(weights[0]);
+        config.download_weight = static_cast<uint32_t>(weights[1]);
+        config.block_weight = static_cast<uint32_t>(weights[2]);
+        return true;
+    }
+
+    void configure_logger(bool is_verbose)
+    {
+        DaneJoe::LoggerConfig config;
+        config.console_level = is_verbose ? DaneJoe::LogLevel::INFO : DaneJoe::LogLevel::WARN;
+        config.enable_file = false;
+        auto logger = DaneJoe::LoggerManager::get_instance().get_logger("default");
+        if (logger)
+        {
+            logger->set_config(config);
+        }
+    }
+
+    /**
+     * @brief 读取进程累计 CPU 时间（用户态与内核态之和）
+     * @return 秒数，进程不存在时返回 std::nullopt
+     */
+    std::optional<double> read_process_cpu_seconds(pid_t pid)
+    {
+        std::ifstream fin("/proc/" + std::to_string(pid) + "/stat");
+        std::string stat;
+        if (!std::getline(fin, stat))
+        {
+            return std::nullopt;
+        }
+        // 进程名可能包含空格，从最后一个 ')' 之后按空格切分：第 1 个字段是状态，utime/stime 为第 12/13 个
+        auto name_end = stat.rfind(')');
+        if (name_end == std::string::npos)
+        {
+            return std::nullopt;
+        }
+        std::vector<std::string> fields;
+        std::size_t position = name_end + 2;
+        while (position < stat.size() && fields.size() < 13)
+        {
+            auto next = stat.find(' ', position);
+            fields.push_back(stat.substr(position, next - position));
+            position = next == std::string::npos ? stat.size() : next + 1;
+        }
+        if (fields.size() < 13)
+        {
+            return std::nullopt;
+        }
+        auto user_ticks = parse_integer(fields[11]);
+        auto system_ticks = parse_integer(fields[12]);
+        if (!user_ticks.has_value() || !system_ticks.has_value())
+        {
+            return std::nullopt;
+        }
+        return static_cast<double>(user_ticks.value() + system_ticks.value()) / static_cast<double>(::sysconf(_SC_CLK_TCK));
+    }
+
+    /**
+     * @brief 申请一个当前空闲的本地端口
+     * @details 绑定端口 0 后立即释放，子进程随后绑定同一端口；其间被占用的概率可以忽略。
+     */
+    std::optional<uint16_t> find_free_port()
+    {
+        int fd = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (fd < 0)
+        {
+            return std::nullopt;
+        }
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        socklen_t length = sizeof(address);
+        std::optional<uint16_t> port;
+        if (::bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0 &&
+            ::getsockname(fd, reinterpret_cast<sockaddr*>(&address), &length) == 0)
+        {
+            port = ntohs(address.sin_port);
+        }
+        ::close(fd);
+        return port;
+    }
+
+    /**
+     * @class ServerProcess
+     * @brief 无界面服务端子进程
+     * @details 子进程的标准输出经管道读取，按行解析登记结果、监听状态与分配统计。
+     */
+    class ServerProcess
+    {
+    public:
+        ~ServerProcess()
+        {
+            stop();
+        }
+        bool start(const std::string& program, uint16_t port, const fs::path& directory, const fs::path& fixture_path)
+        {
+            int pipe_fds[2];
+            if (::pipe2(pipe_fds, O_CLOEXEC) != 0)
+            {
+                return false;
+            }
+            std::string port_text = std::to_string(port);
+            std::string database_path = (directory / "server_database.db").string();
+            std::string fixture_text = fixture_path.string();
+            m_pid = ::fork();
+            if (m_pid < 0)
+            {
+                ::close(pipe_fds[0]);
+                ::close(pipe_fds[1]);
+                return false;
+            }
+            if (m_pid == 0)
+            {
+                ::dup2(pipe_fds[1], STDOUT_FILENO);
+                std::vector<char*> arguments = {
+                    const_cast<char*>(program.c_str()),
+                    const_cast<char*>("--port"), port_text.data(),
+                    const_cast<char*>("--database"), database_path.data(),
+                    const_cast<char*>("--register"), fixture_text.data(),
+                    nullptr };
+                ::execv(program.c_str(), arguments.data());
+                std::fprintf(stderr, "Failed to exec %s: %s\n", program.c_str(), std::strerror(errno));
+                ::_exit(127);
+            }
+            ::close(pipe_fds[1]);
+            m_output = ::fdopen(pipe_fds[0], "r");
+            while (auto line = read_line())
+            {
+                unsigned long long file_size = 0;
+                long long file_id = 0;
+                if (std::sscanf(line->c_str(), "registered file_id=%lld size=%llu", &file_id, &file_size) == 2)
+                {
+                    m_file_id = file_id;
+                    m_file_size = static_cast<int64_t>(file_size);
+                }
+                else if (line->starts_with("listening "))
+                {
+                    return m_file_id.has_value();
+                }
+            }
+            return false;
+        }
+        /**
+         * @brief 获取服务端自启动以来的分配次数
+         */
+        std::optional<uint64_t> query_allocations()
+        {
+            if (m_pid <= 0 || ::kill(m_pid, SIGUSR1) != 0)
+            {
+                return std::nullopt;
+            }
+            while (auto line = read_line())
+            {
+                unsigned long long allocations = 0;
+                if (std::sscanf(line->c_str(), "stats allocations=%llu", &allocations) == 1)
+                {
+                    return allocations;
+                }
+            }
+            return std::nullopt;
+        }
+        void stop()
+        {
+            if (m_pid > 0)
+            {
+                // 正常退出需要等待在途请求处理完毕，超时后强制结束，避免基准挂起
+                ::kill(m_pid, SIGTERM);
+                auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+                while (::waitpid(m_pid, nullptr, WNOHANG) == 0)
+                {
+                    if (std::chrono::steady_clock::now() >= deadline)
+                    {
+                        ::kill(m_pid, SIGKILL);
+                        ::waitpid(m_pid, nullptr, 0);
+                        break;
+                    }
+                    ::usleep(10 * 1000);
+                }
+                m_pid = -1;
+            }
+            if (m_output)
+            {
+                std::fclose(m_output);
+                m_output = nullptr;
+            }
+        }
+        pid_t get_pid()const
+        {
+            return m_pid;
+        }
+        std::optional<int64_t> get_file_id()const
+        {
+            return m_file_id;
+        }
+        int64_t get_file_size()const
+        {
+            return m_file_size;
+        }
+    private:
+        std::optional<std::string> read_line()
+        {
+            char buffer[1024];
+            if (!m_output || !std::fgets(buffer, sizeof(buffer), m_output))
+            {
+                return std::nullopt;
+            }
+            std::string line(buffer);
+            while (!line.empty() && (line.back() == '\n' || line.back() == '\r'))
+            {
+                line.pop_back();
+            }
+            return line;
+        }
+    private:
+        pid_t m_pid = -1;
+        std::FILE* m_output = nullptr;
+        std::optional<int64_t> m_file_id;
+        int64_t m_file_size = 0;
+    };
+
+    bool write_fixture(const fs::path& path, int64_t size)
+    {
+        std::ofstream fout(path, std::ios::out | std::ios::binary | std::ios::trunc);
+        std::mt19937_64 engine(20260111);
+        std::vector<uint64_t> chunk(128 * 1024);
+        for (int64_t written = 0; written < size && fout; )
+        {
+            for (auto& value : chunk)
+            {
+                value = engine();
+            }
+            auto length = std::min<int64_t>(size - written, static_cast<int64_t>(chunk.size() * sizeof(uint64_t)));
+            fout.write(reinterpret_cast<const char*>(chunk.data()), static_cast<std::streamsize>(length));
+            written += length;
+        }
+        return static_cast<bool>(fout);
+    }
+
+    void print_optional(std::FILE* out, const char* key, std::optional<double> value, const char* suffix)
+    {
+        if (value.has_value())
+        {
+            std::fprintf(out, "    \"%s\": %.6g%s\n", key, value.value(), suffix);
+        }
+        else
+        {
+            std::fprintf(out, "    \"%s\": null%s\n", key, suffix);
+        }
+    }
+
+    double to_microseconds(uint64_t nanoseconds)
+    {
+        return static_cast<double>(nanoseconds) / 1000.0;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    LoadGeneratorConfig config;
+    std::string server_program;
+    std::optional<NetworkEndpoint> endpoint;
+    std::optional<pid_t> server_pid;
+    int64_t fixture_size = 64 * 1024 * 1024;
+    std::string output_path;
+    std::string metrics_path;
+    bool is_verbose = false;
+    for (int i = 1; i < argc; i++)
+    {
+        std::string_view argument = argv[i];
+        if (argument == "-h" || argument == "--help")
+        {
+            print_usage(argv[0]);
+            return 0;
+        }
+        if (argument == "-v")
+        {
+            is_verbose = true;
+            continue;
+        }
+        if (i + 1 >= argc)
+        {
+            std::fprintf(stderr, "Option %s requires a value\n", argv[i]);
+            return 2;
+        }
+        std::string_view value = argv[++i];
+        if (argument == "--server")
+        {
+            server_program = value;
+            continue;
+        }
+        if (argument == "--endpoint")
+        {
+            endpoint = parse_endpoint(value);
+            if (!endpoint.has_value())
+            {
+                std::fprintf(stderr, "Invalid endpoint: %s\n", argv[i]);
+                return 2;
+            }
+            continue;
+        }
+        if (argument == "--output")
+        {
+            output_path = value;
+            continue;
+        }
+        if (argument == "--metrics")
+        {
+            metrics_path = value;
+            continue;
+        }
+        if (argument == "--mix")
+        {
+            if (!parse_mix(value, config))
+            {
+                std::fprintf(stderr, "Invalid mix (expected <test>:<download>:<block>): %s\n", argv[i]);
+                return 2;
+            }
+            continue;
+        }
+        auto number = parse_integer(value);
+        if (!number.has_value() || number.value() <= 0)
+        {
+            std::fprintf(stderr, "Option %s requires a positive integer\n", argv[i - 1]);
+            return 2;
+        }
+        if (argument == "--server-pid") server_pid = static_cast<pid_t>(number.value());
+        else if (argument == "--file-size") fixture_size = number.value() * 1024 * 1024;
+        else if (argument == "--file-id") config.file_id = number.value();
+        else if (argument == "-c") config.client_count = static_cast<std::size_t>(number.value());
+        else if (argument == "-t") config.thread_count = static_cast<std::size_t>(number.value());
+        else if (argument == "-p") config.pipeline_depth = static_cast<std::size_t>(number.value());
+        else if (argument == "-b") config.block_size = number.value() * 1024;
+        else if (argument == "--warmup") config.warmup = std::chrono::seconds(number.value());
+        else if (argument == "--duration") config.duration = std::chrono::seconds(number.value());
+        else
+        {
+            std::fprintf(stderr, "Unknown option %s\n", argv[i - 1]);
+            print_usage(argv[0]);
+            return 2;
+        }
+    }
+    if (server_program.empty() == !endpoint.has_value())
+    {
+        print_usage(argv[0]);
+        return 2;
+    }
+    configure_logger(is_verbose);
+
+    ServerProcess server_process;
+    fs::path work_directory;
+    if (!server_program.empty())
+    {
+        std::string directory_template = (fs::temp_directory_path() / "projecttrans_bench_XXXXXX").string();
+        if (!::mkdtemp(directory_template.data()))
+        {
+            std::fprintf(stderr, "Failed to create temporary directory\n");
+            return 1;
+        }
+        work_directory = directory_template;
+        auto fixture_path = work_directory / "fixture.bin";
+        auto port = find_free_port();
+        if (!write_fixture(fixture_path, fixture_size) || !port.has_value() ||
+            !server_process.start(server_program, port.value(), work_directory, fixture_path))
+        {
+            std::fprintf(stderr, "Failed to start %s\n", server_program.c_str());
+            server_process.stop();
+            fs::remove_all(work_directory);
+            return 1;
+        }
+        endpoint = NetworkEndpoint{ "127.0.0.1", port.value() };
+        server_pid = server_process.get_pid();
+        config.file_id = server_process.get_file_id().value();
+        config.file_size = server_process.get_file_size();
+    }
+    else
+    {
+        auto file_size = LoadGenerator::probe_file_size(endpoint.value(), config.file_id, std::chrono::seconds(5));
+        if (!file_size.has_value())
+        {
+            std::fprintf(stderr, "File %lld is not available on %s:%u\n",
+                static_cast<long long>(config.file_id), endpoint->ip.c_str(), static_cast<unsigned>(endpoint->port));
+            return 1;
+        }
+        config.file_size = file_size.value();
+    }
+    config.endpoint = endpoint.value();
+
+    LoadGenerator load_generator(config);
+    std::optional<double> server_cpu_begin;
+    std::optional<double> server_cpu_end;
+    std::optional<uint64_t> server_allocations_begin;
+    std::optional<uint64_t> server_allocations_end;
+    uint64_t client_allocations_begin = 0;
+    uint64_t client_allocations_end = 0;
+    bool is_spawned = !server_program.empty();
+    load_generator.set_measure_callbacks(
+        [&]()
+        {
+            if (g_is_interrupted)
+            {
+                load_generator.stop();
+            }
+            std::fprintf(stderr, "measuring for %llds...\n", static_cast<long long>(config.duration.count() / 1000));
+            client_allocations_begin = DaneJoe::get_allocation_count();
+            server_allocations_begin = is_spawned ? server_process.query_allocations() : std::nullopt;
+            server_cpu_begin = server_pid.has_value() ? read_process_cpu_seconds(server_pid.value()) : std::nullopt;
+        },
+        [&]()
+        {
+            server_cpu_end = server_pid.has_value() ? read_process_cpu_seconds(server_pid.value()) : std::nullopt;
+            server_allocations_end = is_spawned ? server_process.query_allocations() : std::nullopt;
+            client_allocations_end = DaneJoe::get_allocation_count();
+        });
+    std::signal(SIGINT, handle_signal);
+    std::signal(SIGTERM, handle_signal);
+    std::fprintf(stderr, "%zu clients x %zu in flight on %zu threads against %s:%u, warming up for %llds...\n",
+        config.client_count, config.pipeline_depth, config.thread_count,
+        config.endpoint.ip.c_str(), static_cast<unsigned>(config.endpoint.port),
+        static_cast<long long>(config.warmup.count() / 1000));
+    auto report = load_generator.run();
+    if (!metrics_path.empty())
+    {
+        // 在停止子进程之前获取，指标反映整个压测过程
+        auto metrics_text = LoadGenerator::fetch_metrics(config.endpoint, std::chrono::seconds(5));
+        std::ofstream metrics_file(metrics_path, std::ios::out | std::ios::trunc);
+        if (!metrics_text.has_value() || !metrics_file.is_open())
+        {
+            std::fprintf(stderr, "Cannot write server metrics to %s\n", metrics_path.c_str());
+        }
+        else
+        {
+            metrics_file << metrics_text.value();
+        }
+    }
+    server_process.stop();
+    if (!work_directory.empty())
+    {
+        std::error_code error_code;
+        fs::remove_all(work_directory, error_code);
+    }
+    if (!report.has_value())
+    {
+        std::fprintf(stderr, "No connection to %s:%u\n", config.endpoint.ip.c_str(), static_cast<unsigned>(config.endpoint.port));
+        return 1;
+    }
+
+    double seconds = std::chrono::duration<double>(report->measured).count();
+    uint64_t total_requests = 0;
+    uint64_t total_errors = 0;
+    uint64_t total_bytes = 0;
+    for (const auto& path : report->paths)
+    {
+        total_requests += path.requests;
+        total_errors += path.errors;
+        total_bytes += path.bytes;
+    }
+    auto per_second = [seconds](double value)
+        {
+            return seconds > 0.0 ? value / seconds : 0.0;
+        };
+    std::optional<double> server_cpu_seconds;
+    std::optional<double> server_cpu_per_gb;
+    if (server_cpu_begin.has_value() && server_cpu_end.has_value())
+    {
+        server_cpu_seconds = server_cpu_end.value() - server_cpu_begin.value();
+        if (total_bytes > 0)
+        {
+            server_cpu_per_gb = server_cpu_seconds.value() / (static_cast<double>(total_bytes) / 1e9);
+        }
+    }
+    std::optional<double> server_allocations_per_request;
+    if (server_allocations_begin.has_value() && server_allocations_end.has_value() && total_requests > 0)
+    {
+        server_allocations_per_request =
+            static_cast<double>(server_allocations_end.value() - server_allocations_begin.value()) / static_cast<double>(total_requests);
+    }
+    std::optional<double> client_allocations_per_request;
+    if (total_requests > 0)
+    {
+        client_allocations_per_request =
+            static_cast<double>(client_allocations_end - client_allocations_begin) / static_cast<double>(total_requests);
+    }
+
+    std::fprintf(stderr, "%-10s %10s %8s %12s %10s %10s %10s %10s %10s\n",
+        "path", "requests", "errors", "req/s", "MB/s", "p50_us", "p99_us", "p999_us", "max_us");
+    for (std::size_t i = 0; i < report->paths.size(); i++)
+    {
+        const auto& path = report->paths[i];
+        std::fprintf(stderr, "%-10s %10llu %8llu %12.1f %10.1f %10.1f %10.1f %10.1f %10.1f\n",
+            to_path(static_cast<LoadRequestKind>(i)),
+            static_cast<unsigned long long>(path.requests),
+            static_cast<unsigned long long>(path.errors),
+            per_second(static_cast<double>(path.requests)),
+            per_second(static_cast<double>(path.bytes)) / 1e6,
+            to_microseconds(path.latency.get_percentile(50.0)),
+            to_microseconds(path.latency.get_percentile(99.0)),
+            to_microseconds(path.latency.get_percentile(99.9)),
+            to_microseconds(path.latency.get_max()));
+    }
+
+    std::FILE* out = stdout;
+    if (!output_path.empty())
+    {
+        out = std::fopen(output_path.c_str(), "w");
+        if (!out)
+        {
+            std::fprintf(stderr, "Cannot write %s\n", output_path.c_str());
+            return 1;
+        }
+    }
+    std::fprintf(out, "{\n");
+    std::fprintf(out, "  \"config\": {\n");
+    std::fprintf(out, "    \"endpoint\": \"%s:%u\",\n", config.endpoint.ip.c_str(), static_cast<unsigned>(config.endpoint.port));
+    std::fprintf(out, "    \"spawned_server\": %s,\n", is_spawned ? "true" : "false");
+    std::fprintf(out, "    \"clients\": %zu,\n", config.client_count);
+    std::fprintf(out, "    \"threads\": %zu,\n", config.thread_count);
+    std::fprintf(out, "    \"pipeline_depth\": %zu,\n", config.pipeline_depth);
+    std::fprintf(out, "    \"block_size\": %lld,\n", static_cast<long long>(config.block_size));
+    std::fprintf(out, "    \"file_size\": %lld,\n", static_cast<long long>(config.file_size));
+    std::fprintf(out, "    \"mix\": { \"/test\": %u, \"/download\": %u, \"/block\": %u },\n",
+        config.test_weight, config.download_weight, config.block_weight);
+    std::fprintf(out, "    \"warmup_seconds\": %lld\n", static_cast<long long>(config.warmup.count() / 1000));
+    std::fprintf(out, "  },\n");
+    std::fprintf(out, "  \"duration_seconds\": %.3f,\n", seconds);
+    std::fprintf(out, "  \"connected_clients\": %zu,\n", report->connected_clients);
+    std::fprintf(out, "  \"paths\": {\n");
+    for (std::size_t i = 0; i < report->paths.size(); i++)
+    {
+        const auto& path = report->paths[i];
+        std::fprintf(out, "    \"%s\": {\n", to_path(static_cast<LoadRequestKind>(i)));
+        std::fprintf(out, "      \"requests\": %llu,\n", static_cast<unsigned long long>(path.requests));
+        std::fprintf(out, "      \"errors\": %llu,\n", static_cast<unsigned long long>(path.errors));
+        std::fprintf(out, "      \"requests_per_second\": %.1f,\n", per_second(static_cast<double>(path.requests)));
+        std::fprintf(out, "      \"mb_per_second\": %.3f,\n", per_second(static_cast<double>(path.bytes)) / 1e6);
+        std::fprintf(out, "      \"latency_us\": { \"mean\": %.1f, \"p50\": %.1f, \"p99\": %.1f, \"p999\": %.1f, \"max\": %.1f }\n",
+            path.latency.get_mean() / 1000.0,
+            to_microseconds(path.latency.get_percentile(50.0)),
+            to_microseconds(path.latency.get_percentile(99.0)),
+            to_microseconds(path.latency.get_percentile(99.9)),
+            to_microseconds(path.latency.get_max()));
+        std::fprintf(out, "    }%s\n", i + 1 < report->paths.size() ? "," : "");
+    }
+    std::fprintf(out, "  },\n");
+    std::fprintf(out, "  \"total\": {\n");
+    std::fprintf(out, "    \"requests\": %llu,\n", static_cast<unsigned long long>(total_requests));
+    std::fprintf(out, "    \"errors\": %llu,\n", static_cast<unsigned long long>(total_errors));
+    std::fprintf(out, "    \"requests_per_second\": %.1f,\n", per_second(static_cast<double>(total_requests)));
+    std::fprintf(out, "    \"mb_per_second\": %.3f\n", per_second(static_cast<double>(total_bytes)) / 1e6);
+    std::fprintf(out, "  },\n");
+    std::fprintf(out, "  \"server\": {\n");
+    print_optional(out, "cpu_seconds", server_cpu_seconds, ",");
+    print_optional(out, "cpu_seconds_per_gb", server_cpu_per_gb, ",");
+    print_optional(out, "allocations_per_request", server_allocations_per_request, "");
+    std::fprintf(out, "  },\n");
+    std::fprintf(out, "  \"client\": {\n");
+    print_optional(out, "allocations_per_request", client_allocations_per_request, "");
+    std::fprintf(out, "  }\n");
+    std::fprintf(out, "}\n");
+    if (out != stdout)
+    {
+        std::fclose(out);
+    }
+    return total_errors == 0 ? 0 : 1;
+}
@@ -0,0 +1,237 @@
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+#include "danejoe/logger/logger_manager.hpp"
+
+#include "engine/transfer_engine.hpp"
+
+namespace
+{
+    /// @brief 收到 SIGINT/SIGTERM 后置位，由进度回调转交给引擎
+    volatile std::sig_atomic_t g_is_interrupted = 0;
+
+    void handle_signal(int)
+    {
+        g_is_interrupted = 1;
+    }
+
+    void print_usage(const char* program)
+    {
+        std::fprintf(stderr,
+            "Usage: %s [options] <ip:port> <file_id>:<output_path> [<file_id>:<output_path> ...]\n"
+            "Options:\n"
+            "  -c <count>    connections per endpoint (default 4)\n"
+            "  -b <KiB>      block size in KiB (default 1024)\n"
+            "  -w <count>    max in-flight blocks per download (default 16)\n"
+            "  -j <count>    max concurrent downloads (default 8)\n"
+            "  -r <count>    repeat every download <count> times, outputs suffixed with .<n> (default 1)\n"
+            "  -t <seconds>  request timeout (default 30)\n"
+            "  --no-verify   skip MD5 verification\n"
+            "  -v            verbose logging\n",
+            program);
+    }
+
+    std::optional<int64_t> parse_integer(std::string_view text)
+    {
+        if (text.empty())
+        {
+            return std::nullopt;
+        }
+        try
+        {
+            std::size_t parsed = 0;
+            int64_t value = std::stoll(std::string(text), &parsed);
+            if (parsed != text.size())
+            {
+                return std::nullopt;
+            }
+            return value;
+        }
+        catch (const std::exception&)
+        {
+            return std::nullopt;
+        }
+    }
+
+    std::optional<NetworkEndpoint> parse_endpoint(std::string_view text)
+    {
+        auto colon = text.rfind(':');
+        if (colon == std::string_view::npos)
+        {
+            return std::nullopt;
+        }
+        auto port = parse_integer(text.substr(colon + 1));
+        if (!port.has_value() || port.value() <= 0 || port.value() > 65535)
+        {
+            return std::nullopt;
+        }
+        return NetworkEndpoint{ std::string(text.substr(0, colon)), static_cast<uint16_t>(port.value()) };
+    }
+
+    double to_mib(int64_t bytes)
+    {
+        return static_cast<double>(bytes) / (1024.0 * 1024.0);
+    }
+
+    double to_seconds(std::chrono::nanoseconds duration)
+    {
+        return std::chrono::duration<double>(duration).count();
+    }
+
+    void configure_logger(bool is_verbose)
+    {
+        DaneJoe::LoggerConfig config;
+        config.console_level = is_verbose ? DaneJoe::LogLevel::INFO : DaneJoe::LogLevel::WARN;
+        config.enable_file = false;
+        auto logger = DaneJoe::LoggerManager::get_instance().get_logger("default");
+        if (logger)
+        {
+            logger->set_config(config);
+        }
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    TransferEngineConfig config;
+    int64_t repeat_count = 1;
+    bool is_verbose = false;
+    std::vector<std::string_view> positionals;
+    for (int i = 1; i < argc; i++)
+    {
+        std::string_view argument = argv[i];
+        if (argument == "-h" || argument == "--help")
+        {
+            print_usage(argv[0]);
+            return 0;
+        }
+        if (argument == "--no-verify")
+        {
+            config.is_verify_md5 = false;
+            continue;
+        }
+        if (argument == "-v")
+        {
+            is_verbose = true;
+            continue;
+        }
+        if (argument.size() == 2 && argument[0] == '-')
+        {
+            std::optional<int64_t> value = i + 1 < argc ? parse_integer(argv[i + 1]) : std::nullopt;
+            if (!value.has_value() || value.value() <= 0)
+            {
+                std::fprintf(stderr, "Option %s requires a positive integer\n", argv[i]);
+                return 2;
+            }
+            i++;
+            switch (argument[1])
+            {
+                case 'c': config.connections_per_endpoint = static_cast<std::size_t>(value.value()); break;
+                case 'b': config.block_size = value.value() * 1024; break;
+                case 'w': config.max_in_flight_blocks = static_cast<std::size_t>(value.value()); break;
+                case 'j': config.max_active_downloads = static_cast<std::size_t>(value.value()); break;
+                case 'r': repeat_count = value.value(); break;
+                case 't': config.request_timeout = std::chrono::seconds(value.value()); break;
+                default:
+                    std::fprintf(stderr, "Unknown option %s\n", argv[i - 1]);
+                    print_usage(argv[0]);
+                    return 2;
+            }
+            continue;
+        }
+        positionals.push_back(argument);
+    }
+    if (positionals.size() < 2)
+    {
+        print_usage(argv[0]);
+        return 2;
+    }
+    auto endpoint = parse_endpoint(positionals[0]);
+    if (!endpoint.has_value())
+    {
+        std::fprintf(stderr, "Invalid endpoint: %s\n", std::string(positionals[0]).c_str());
+        return 2;
+    }
+    configure_logger(is_verbose);
+
+    TransferEngine engine(config);
+    for (std::size_t i = 1; i < positionals.size(); i++)
+    {
+        auto colon = positionals[i].find(':');
+        auto file_id = colon == std::string_view::npos ? std::nullopt : parse_integer(positionals[i].substr(0, colon));
+        if (!file_id.has_value() || colon + 1 >= positionals[i].size())
+        {
+            std::fprintf(stderr, "Invalid download spec (expected <file_id>:<output_path>): %s\n", std::string(positionals[i]).c_str());
+            return 2;
+        }
+        std::string output_path(positionals[i].substr(colon + 1));
+        for (int64_t n = 0; n < repeat_count; n++)
+        {
+            DownloadJob job;
+            job.endpoint = endpoint.value();
+            job.file_id = file_id.value();
+            job.output_path = repeat_count > 1 ? output_path + "." + std::to_string(n) : output_path;
+            engine.add_download(job);
+        }
+    }
+
+    std::signal(SIGINT, handle_signal);
+    std::signal(SIGTERM, handle_signal);
+    engine.set_progress_callback([&engine](const TransferEngineProgress& progress)
+        {
+            if (g_is_interrupted)
+            {
+                engine.stop();
+            }
+            double seconds = to_seconds(progress.elapsed);
+            std::fprintf(stderr, "\r[%7.1fs] %zu/%zu done, %zu failed, %.1f MiB, %.1f MiB/s   ",
+                seconds,
+                progress.succeeded_downloads,
+                progress.total_downloads,
+                progress.failed_downloads,
+                to_mib(progress.received_bytes),
+                seconds > 0.0 ? to_mib(progress.received_bytes) / seconds : 0.0);
+        }, std::chrono::milliseconds(1000));
+
+    auto start_time = std::chrono::steady_clock::now();
+    auto results = engine.run();
+    auto elapsed = std::chrono::steady_clock::now() - start_time;
+    std::fprintf(stderr, "\n");
+
+    int64_t total_bytes = 0;
+    std::size_t failed_count = 0;
+    for (const auto& result : results)
+    {
+        if (result.is_success)
+        {
+            total_bytes += result.file_size;
+            std::printf("ok      %lld -> %s (%.1f MiB in %.2fs)\n",
+                static_cast<long long>(result.job.file_id),
+                result.job.output_path.c_str(),
+                to_mib(result.file_size),
+                to_seconds(result.elapsed));
+        }
+        else
+        {
+            failed_count++;
+            std::printf("failed  %lld -> %s: %s\n",
+                static_cast<long long>(result.job.file_id),
+                result.job.output_path.c_str(),
+                result.error.c_str());
+        }
+    }
+    double seconds = to_seconds(elapsed);
+    std::printf("%zu downloads, %zu failed, %.1f MiB in %.2fs, %.1f MiB/s\n",
+        results.size(),
+        failed_count,
+        to_mib(total_bytes),
+        seconds,
+        seconds > 0.0 ? to_mib(total_bytes) / seconds : 0.0);
+    return failed_count == 0 ? 0 : 1;
+}
@@ -44,13 +44,14 @@ void ClientApp::init()
     m_block_service.init();
     m_task_service.init();
     m_client_file_service.init();
+    m_task_progress_service.init();
     m_view_event_hub = new ViewEventHub();
     m_view_event_controller = new ViewEventController(
         m_view_event_hub,
         m_trans_service);
     m_block_schedule_thread = new QThread(this);
     m_block_schedule_controller =
-        new BlockScheduleController(m_block_service, m_task_service, m_view_event_hub);
+        new BlockScheduleController(m_block_service, m_task_service, m_client_file_service, m_task_progress_service, m_view_event_hub);
     m_block_schedule_controller->moveToThread(m_block_schedule_thread);
 
     m_main_window = new ClientMainWindow(
@@ -0,0 +1,173 @@
+#include <format>
+
+#include "danejoe/network/codec/varint.hpp"
+
+#include "model/entity/task_progress_entity.hpp"
+
+namespace
+{
+    /**
+     * @brief 获取整数区间的闭区间端点
+     * @param interval 区间
+     * @param first 输出：首个元素
+     * @param last 输出：末尾元素
+     * @return 区间有限且非空时返回 true
+     */
+    bool get_closed_bounds(const DaneJoe::SingleInterval<int64_t>& interval, int64_t& first, int64_t& last)
+    {
+        auto left = interval.get_left_endpoint();
+        auto right = interval.get_right_endpoint();
+        auto left_value_opt = left.get_value();
+        auto right_value_opt = right.get_value();
+        if (!left_value_opt.has_value() || !right_value_opt.has_value())
+        {
+            return false;
+        }
+        first = left_value_opt.value() + (left.is_open() ? 1 : 0);
+        last = right_value_opt.value() - (right.is_open() ? 1 : 0);
+        return first <= last;
+    }
+}
+
+void TaskProgressEntity::add_completed(int64_t offset, int64_t size)
+{
+    if (size <= 0)
+    {
+        return;
+    }
+    completed_ranges.add_range(
+        DaneJoe::SingleInterval<int64_t>({ offset, false }, { offset + size, true }),
+        DaneJoe::ConditionRelation::Or);
+}
+
+void TaskProgressEntity::remove_completed(int64_t offset, int64_t size)
+{
+    if (size <= 0)
+    {
+        return;
+    }
+    completed_ranges.add_range(
+        DaneJoe::SingleInterval<int64_t>({ offset, false }, { offset + size, true }),
+        DaneJoe::ConditionRelation::Not);
+}
+
+int64_t TaskProgressEntity::get_completed_bytes() const
+{
+    int64_t completed_bytes = 0;
+    for (const auto& interval : completed_ranges.get_intervals())
+    {
+        int64_t first = 0;
+        int64_t last = 0;
+        if (get_closed_bounds(interval, first, last))
+        {
+            completed_bytes += last - first + 1;
+        }
+    }
+    return completed_bytes;
+}
+
+std::vector<std::pair<int64_t, int64_t>> TaskProgressEntity::get_completed_ranges() const
+{
+    std::vector<std::pair<int64_t, int64_t>> ranges;
+    for (const auto& interval : completed_ranges.get_intervals())
+    {
+        int64_t first = 0;
+        int64_t last = 0;
+        if (get_closed_bounds(interval, first, last))
+        {
+            ranges.emplace_back(first, last + 1);
+        }
+    }
+    return ranges;
+}
+
+std::vector<std::pair<int64_t, int64_t>> TaskProgressEntity::get_missing_ranges(int64_t file_size) const
+{
+    std::vector<std::pair<int64_t, int64_t>> missing_ranges;
+    int64_t cursor = 0;
+    for (const auto& interval : completed_ranges.get_intervals())
+    {
+        int64_t first = 0;
+        int64_t last = 0;
+        if (!get_closed_bounds(interval, first, last))
+        {
+            continue;
+        }
+        if (first > cursor)
+        {
+            missing_ranges.emplace_back(cursor, std::min(first, file_size));
+        }
+        cursor = std::max(cursor, last + 1);
+        if (cursor >= file_size)
+        {
+            break;
+        }
+    }
+    if (cursor < file_size)
+    {
+        missing_ranges.emplace_back(cursor, file_size);
+    }
+    return missing_ranges;
+}
+
+std::vector<uint8_t> TaskProgressEntity::to_blob() const
+{
+    auto ranges = get_completed_ranges();
+    std::vector<uint8_t> blob;
+    blob.reserve(DaneJoe::MAX_VARINT_SIZE * (1 + 2 * ranges.size()));
+    uint8_t buffer[DaneJoe::MAX_VARINT_SIZE];
+    auto append = [&blob, &buffer](uint64_t value)
+        {
+            auto size = DaneJoe::write_varint(buffer, value);
+            blob.insert(blob.end(), buffer, buffer + size);
+        };
+    append(ranges.size());
+    int64_t previous_end = 0;
+    for (const auto& [begin, end] : ranges)
+    {
+        append(static_cast<uint64_t>(begin - previous_end));
+        append(static_cast<uint64_t>(end - begin));
+        previous_end = end;
+    }
+    return blob;
+}
+
+bool TaskProgressEntity::from_blob(const std::vector<uint8_t>& blob)
+{
+    completed_ranges = DaneJoe::RangeCondition<int64_t>();
+    std::size_t position = 0;
+    auto read = [&blob, &position]() -> std::optional<uint64_t>
+        {
+            uint32_t read_size = 0;
+            auto value_opt = DaneJoe::read_varint(blob.data() + position, blob.size() - position, read_size);
+            position += read_size;
+            return value_opt;
+        };
+    auto count_opt = read();
+    if (!count_opt.has_value())
+    {
+        return blob.empty();
+    }
+    int64_t previous_end = 0;
+    for (uint64_t i = 0; i < count_opt.value(); i++)
+    {
+        auto gap_opt = read();
+        auto length_opt = read();
+        if (!gap_opt.has_value() || !length_opt.has_value())
+        {
+            completed_ranges = DaneJoe::RangeCondition<int64_t>();
+            return false;
+        }
+        int64_t offset = previous_end + static_cast<int64_t>(gap_opt.value());
+        int64_t length = static_cast<int64_t>(length_opt.value());
+        add_completed(offset, length);
+        previous_end = offset + length;
+    }
+    return true;
+}
+
+std::string TaskProgressEntity::to_string() const
+{
+    return std::format("task_id={} | completed_bytes={} | completed_ranges={}",
+        task_id, get_completed_bytes(), completed_ranges.get_intervals().size());
+}
@@ -0,0 +1,14 @@
+#include <format>
+
+#include "model/transfer/manifest_transfer.hpp"
+
+std::string ManifestRequestTransfer::to_string() const
+{
+    return std::format("file_id={} | task_id={}", file_id, task_id);
+}
+
+std::string ManifestResponseTransfer::to_string() const
+{
+    return std::format("file_id={} | task_id={} | file_size={} | chunk_size={} | chunk_count={}",
+        file_id, task_id, file_size, chunk_size, chunk_hashes.size() / 8);
+}
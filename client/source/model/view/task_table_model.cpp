@@ -50,6 +50,19 @@ void TaskTableModel::update(int64_t task_id)
     emit dataChanged(index(row, 0), index(row, columnCount()));
 }
 
+void TaskTableModel::update_progress(int64_t task_id, int64_t completed_bytes, int64_t total_bytes)
+{
+    m_task_progress[task_id] = { completed_bytes, total_bytes };
+    for (int row = 0; row < m_task_list.size(); row++)
+    {
+        if (m_task_list[row].task_id == task_id)
+        {
+            emit dataChanged(index(row, 8), index(row, 8));
+            break;
+        }
+    }
+}
+
 int32_t TaskTableModel::columnCount(const QModelIndex& parent) const
 {
     // 存在父对象时不处理
@@ -58,7 +71,7 @@ int32_t TaskTableModel::columnCount(const QModelIndex& parent) const
         return 0;
     }
     // 返回固定列数
-    return 8;
+    return 9;
 }
 
 int32_t TaskTableModel::rowCount(const QModelIndex& parent) const
@@ -141,6 +154,20 @@ QVariant TaskTableModel::data(const QModelIndex& index, int32_t role) const
                 {
                     return QDateTime::fromSecsSinceEpoch(std::chrono::system_clock::to_time_t(m_task_list[row].end_time));
                 }
+            case 8:
+            {
+                if (m_task_list[row].state == TaskState::Completed)
+                {
+                    return "100%";
+                }
+                auto progress_it = m_task_progress.find(m_task_list[row].task_id);
+                if (progress_it == m_task_progress.end() || progress_it->second.second <= 0)
+                {
+                    return "-";
+                }
+                double percent = 100.0 * static_cast<double>(progress_it->second.first) / static_cast<double>(progress_it->second.second);
+                return QString::number(percent, 'f', 1) + "%";
+            }
             default:
                 return QVariant();
         }
@@ -174,6 +201,8 @@ QVariant TaskTableModel::headerData(int32_t section, Qt::Orientation orientation
                     return QStringLiteral("创建时间");
                 case 7:
                     return QStringLiteral("完成时间");
+                case 8:
+                    return QStringLiteral("进度");
                 default:
                     return QVariant();
             }
@@ -4,12 +4,96 @@
 #include <string>
 
 #include "protocol/client_message_codec.hpp"
+#include "protocol/message_field_tag.hpp"
+
+void ClientMessageCodec::set_wire_version(DaneJoe::SerializeVersion wire_version)
+{
+    m_wire_version = wire_version;
+    m_is_wire_version_pinned = true;
+}
+
+DaneJoe::SerializeVersion ClientMessageCodec::get_wire_version()const
+{
+    return m_wire_version;
+}
+
+DaneJoe::SerializeVersion ClientMessageCodec::get_peer_wire_version(const std::vector<uint8_t>& data, const EnvelopeResponseTransfer& envelope)const
+{
+    // 服务端以紧凑编码回复，或信封版本声明支持紧凑编码
+    DaneJoe::SerializeCodec serializer;
+    auto header_opt = serializer.get_message_header(data);
+    if ((header_opt.has_value() && header_opt->version == static_cast<uint8_t>(DaneJoe::SerializeVersion::Compact)) ||
+        envelope.version >= COMPACT_ENVELOPE_VERSION)
+    {
+        return DaneJoe::SerializeVersion::Compact;
+    }
+    return DaneJoe::SerializeVersion::Named;
+}
+
+DaneJoe::SerializeVersion ClientMessageCodec::resolve_wire_version(std::optional<DaneJoe::SerializeVersion> wire_version)const
+{
+    return m_is_wire_version_pinned || !wire_version.has_value() ? m_wire_version : wire_version.value();
+}
+
+DaneJoe::SerializeConfig ClientMessageCodec::get_build_config(DaneJoe::SerializeVersion wire_version)const
+{
+    DaneJoe::SerializeConfig config;
+    config.version = wire_version;
+    config.field_tag_table = get_message_field_tag_table();
+    return config;
+}
+
+DaneJoe::SerializeConfig ClientMessageCodec::get_parse_config()const
+{
+    DaneJoe::SerializeConfig config;
+    config.field_tag_table = get_message_field_tag_table();
+    return config;
+}
+
+namespace
+{
+    /**
+     * @brief 获取当前线程的消息体构建编码器
+     * @note 编码器按线程持有，构建缓冲区在消息间复用
+     */
+    DaneJoe::SerializeCodec& get_thread_body_codec()
+    {
+        thread_local DaneJoe::SerializeCodec codec;
+        return codec;
+    }
+    /**
+     * @brief 获取当前线程的信封构建编码器
+     */
+    DaneJoe::SerializeCodec& get_thread_envelope_codec()
+    {
+        thread_local DaneJoe::SerializeCodec codec;
+        return codec;
+    }
+}
+
+DaneJoe::SerializeCodec& ClientMessageCodec::get_body_build_codec(DaneJoe::SerializeVersion wire_version)const
+{
+    DaneJoe::SerializeCodec& codec = get_thread_body_codec();
+    codec.reset_build();
+    codec.set_config(get_build_config(wire_version));
+    return codec;
+}
+
+DaneJoe::SerializeCodec& ClientMessageCodec::get_envelope_build_codec(std::size_t body_size, DaneJoe::SerializeVersion wire_version)const
+{
+    DaneJoe::SerializeCodec& codec = get_thread_envelope_codec();
+    codec.reset_build();
+    // 按消息体大小一次性预留，避免构建过程中多次扩容
+    codec.ensure_enough_capacity_rest_to_build(static_cast<uint32_t>(body_size) + ENVELOPE_RESERVED_SIZE);
+    codec.set_config(get_build_config(wire_version));
+    return codec;
+}
 
 std::optional<EnvelopeResponseTransfer> ClientMessageCodec::try_parse_byte_array_response(const std::vector<uint8_t>& data)
 {
     DANEJOE_LOG_TRACE("default", "ClientMessageCodec", "Parsing envelope response");
     EnvelopeResponseTransfer envelope;
-    DaneJoe::SerializeCodec serializer;
+    DaneJoe::SerializeCodec serializer(get_parse_config());
     serializer.deserialize(data);
 
     auto version_field_opt = serializer.get_parsed_field("version");
@@ -86,7 +170,7 @@ std::optional<DownloadResponseTransfer> ClientMessageCodec::try_parse_byte_array
 {
     DANEJOE_LOG_TRACE("default", "ClientMessageCodec", "Parse download response");
     DownloadResponseTransfer info;
-    DaneJoe::SerializeCodec serializer;
+    DaneJoe::SerializeCodec serializer(get_parse_config());
     serializer.deserialize(body);
 
     auto task_id_field_opt = serializer.get_parsed_field("task_id");
@@ -149,10 +233,105 @@ std::optional<DownloadResponseTransfer> ClientMessageCodec::try_parse_byte_array
     return info;
 }
 
+std::optional<ManifestResponseTransfer> ClientMessageCodec::try_parse_byte_array_manifest_response(const std::vector<uint8_t>& body)
+{
+    DANEJOE_LOG_TRACE("default", "ClientMessageCodec", "Parse manifest response");
+    ManifestResponseTransfer info;
+    DaneJoe::SerializeCodec serializer(get_parse_config());
+    serializer.deserialize(body);
+
+    auto task_id_field_opt = serializer.get_parsed_field("task_id");
+    auto file_id_field_opt = serializer.get_parsed_field("file_id");
+    auto file_size_field_opt = serializer.get_parsed_field("file_size");
+    auto chunk_size_field_opt = serializer.get_parsed_field("chunk_size");
+    auto chunk_hashes_field_opt = serializer.get_parsed_field("chunk_hashes");
+
+    if (!task_id_field_opt.has_value() || !file_size_field_opt.has_value() || !chunk_size_field_opt.has_value())
+    {
+        DANEJOE_LOG_ERROR("default", "ClientMessageCodec", "Manifest field missing");
+        return std::nullopt;
+    }
+    auto task_id_op = DaneJoe::to_value<int64_t>(task_id_field_opt.value());
+    auto file_size_op = DaneJoe::to_value<int64_t>(file_size_field_opt.value());
+    auto chunk_size_op = DaneJoe::to_value<int64_t>(chunk_size_field_opt.value());
+    if (!task_id_op.has_value() || !file_size_op.has_value() || !chunk_size_op.has_value())
+    {
+        DANEJOE_LOG_ERROR("default", "ClientMessageCodec", "Manifest field parse failed");
+        return std::nullopt;
+    }
+    info.task_id = task_id_op.value();
+    info.file_size = file_size_op.value();
+    info.chunk_size = chunk_size_op.value();
+
+    if (file_id_field_opt.has_value())
+    {
+        auto file_id_op = DaneJoe::to_value<int64_t>(file_id_field_opt.value());
+        if (file_id_op.has_value())
+        {
+            info.file_id = file_id_op.value();
+        }
+    }
+
+    if (chunk_hashes_field_opt.has_value())
+    {
+        info.chunk_hashes = DaneJoe::to_array<uint8_t>(chunk_hashes_field_opt.value());
+    }
+
+    return info;
+}
+
+std::optional<DeltaResponseTransfer> ClientMessageCodec::try_parse_byte_array_delta_response(const std::vector<uint8_t>& body)
+{
+    DANEJOE_LOG_TRACE("default", "ClientMessageCodec", "Parse delta response");
+    DeltaResponseTransfer info;
+    DaneJoe::SerializeCodec serializer(get_parse_config());
+    serializer.deserialize(body);
+
+    auto task_id_field_opt = serializer.get_parsed_field("task_id");
+    auto file_id_field_opt = serializer.get_parsed_field("file_id");
+    auto file_size_field_opt = serializer.get_parsed_field("file_size");
+    auto md5_code_field_opt = serializer.get_parsed_field("md5_code");
+    auto delta_field_opt = serializer.get_parsed_field("delta");
+
+    if (!task_id_field_opt.has_value() || !file_size_field_opt.has_value())
+    {
+        DANEJOE_LOG_ERROR("default", "ClientMessageCodec", "Delta field missing");
+        return std::nullopt;
+    }
+    auto task_id_op = DaneJoe::to_value<int64_t>(task_id_field_opt.value());
+    auto file_size_op = DaneJoe::to_value<int64_t>(file_size_field_opt.value());
+    if (!task_id_op.has_value() || !file_size_op.has_value())
+    {
+        DANEJOE_LOG_ERROR("default", "ClientMessageCodec", "Delta field parse failed");
+        return std::nullopt;
+    }
+    info.task_id = task_id_op.value();
+    info.file_size = file_size_op.value();
+
+    if (file_id_field_opt.has_value())
+    {
+        auto file_id_op = DaneJoe::to_value<int64_t>(file_id_field_opt.value());
+        if (file_id_op.has_value())
+        {
+            info.file_id = file_id_op.value();
+        }
+    }
+    if (md5_code_field_opt.has_value())
+    {
+        info.md5_code = DaneJoe::to_string(md5_code_field_opt.value());
+    }
+    if (delta_field_opt.has_value())
+    {
+        info.delta = DaneJoe::to_array<uint8_t>(delta_field_opt.value());
+    }
+
+    return info;
+}
+
 std::optional<BlockResponseTransfer> ClientMessageCodec::try_parse_byte_array_block_response(const std::vector<uint8_t>& body)
 {
     BlockResponseTransfer info;
-    DaneJoe::SerializeCodec serializer;
+    DaneJoe::SerializeCodec serializer(get_parse_config());
     serializer.deserialize(body);
 
     auto block_id_field_op = serializer.get_parsed_field("block_id");
@@ -235,7 +414,7 @@ std::optional<BlockResponseTransfer> ClientMessageCodec::try_parse_byte_array_bl
 
 std::optional<TestResponseTransfer> ClientMessageCodec::try_parse_byte_array_test_response(const std::vector<uint8_t>& body)
 {
-    DaneJoe::SerializeCodec serializer;
+    DaneJoe::SerializeCodec serializer(get_parse_config());
     auto header_opt = serializer.get_message_header(body);
     DANEJOE_LOG_DEBUG("default", "ClientMessageCodec", "Header: {}", header_opt.has_value() ? header_opt->to_string() : "Invalid header");
     serializer.deserialize(body);
@@ -252,9 +431,9 @@ std::optional<TestResponseTransfer> ClientMessageCodec::try_parse_byte_array_tes
     return info;
 }
 
-std::vector<uint8_t> ClientMessageCodec::build_request_byte_array(EnvelopeRequestTransfer info)
+std::vector<uint8_t> ClientMessageCodec::build_request_byte_array(EnvelopeRequestTransfer info, std::optional<DaneJoe::SerializeVersion> wire_version)
 {
-    DaneJoe::SerializeCodec serializer;
+    DaneJoe::SerializeCodec& serializer = get_envelope_build_codec(info.body.size(), resolve_wire_version(wire_version));
     serializer.serialize(info.version, "version");
     serializer.serialize(info.request_id, "request_id");
     serializer.serialize(info.request_type, "request_type");
@@ -262,15 +441,23 @@ std::vector<uint8_t> ClientMessageCodec::build_request_byte_array(EnvelopeReques
     serializer.serialize(static_cast<uint8_t>(info.content_type), "content_type");
     serializer.serialize(info.body, "body");
     DANEJOE_LOG_DEBUG("default","ClientMessageCodec","--------Request------:{}",info.to_string());
-    return serializer.get_serialized_data_vector_build();
+    std::vector<uint8_t> data = serializer.take_serialized_data_vector_build();
+    // 消息体缓冲区交还消息体编码器复用
+    get_thread_body_codec().reset_build(std::move(info.body));
+    return data;
+}
+
+void ClientMessageCodec::recycle_frame_byte_array(std::vector<uint8_t>&& frame)const
+{
+    get_thread_envelope_codec().reset_build(std::move(frame));
 }
 
-std::vector<uint8_t> ClientMessageCodec::build_test_request_byte_array(const TestRequestTransfer& test_request, int64_t request_id)
+std::vector<uint8_t> ClientMessageCodec::build_test_request_byte_array(const TestRequestTransfer& test_request, int64_t request_id, std::optional<DaneJoe::SerializeVersion> wire_version)
 {
     // 构建消息体
-    DaneJoe::SerializeCodec body_serializer;
+    DaneJoe::SerializeCodec& body_serializer = get_body_build_codec(resolve_wire_version(wire_version));
     body_serializer.serialize(test_request.message, "message");
-    std::vector<uint8_t> body = body_serializer.get_serialized_data_vector_build();
+    std::vector<uint8_t> body = body_serializer.take_serialized_data_vector_build();
 
     // 构建Envelope请求
     EnvelopeRequestTransfer envelope;
@@ -279,19 +466,31 @@ std::vector<uint8_t> ClientMessageCodec::build_test_request_byte_array(const Tes
     envelope.request_type = 1; // POST
     envelope.path = "/test";
     envelope.content_type = ContentType::DaneJoe;
-    envelope.body = body;
+    envelope.body = std::move(body);
 
-    return build_request_byte_array(envelope);
+    return build_request_byte_array(std::move(envelope), wire_version);
 }
 
-std::vector<uint8_t> ClientMessageCodec::build_download_request_byte_array(const DownloadRequestTransfer& download_request, int64_t request_id)
+std::vector<uint8_t> ClientMessageCodec::build_metrics_request_byte_array(int64_t request_id, std::optional<DaneJoe::SerializeVersion> wire_version)
+{
+    EnvelopeRequestTransfer envelope;
+    envelope.version = 1;
+    envelope.request_id = request_id;
+    envelope.request_type = 0; // GET
+    envelope.path = "/metrics";
+    envelope.content_type = ContentType::DaneJoe;
+
+    return build_request_byte_array(std::move(envelope), wire_version);
+}
+
+std::vector<uint8_t> ClientMessageCodec::build_download_request_byte_array(const DownloadRequestTransfer& download_request, int64_t request_id, std::optional<DaneJoe::SerializeVersion> wire_version)
 {
     DANEJOE_LOG_TRACE("default", "ClientMessageCodec", "Building download request for file_id: {}", download_request.file_id);
     // 构建消息体
-    DaneJoe::SerializeCodec body_serializer;
+    DaneJoe::SerializeCodec& body_serializer = get_body_build_codec(resolve_wire_version(wire_version));
     body_serializer.serialize(download_request.file_id, "file_id");
     body_serializer.serialize(download_request.task_id, "task_id");
-    std::vector<uint8_t> body = body_serializer.get_serialized_data_vector_build();
+    std::vector<uint8_t> body = body_serializer.take_serialized_data_vector_build();
 
     // 构建Envelope请求
     EnvelopeRequestTransfer envelope;
@@ -300,22 +499,65 @@ std::vector<uint8_t> ClientMessageCodec::build_download_request_byte_array(const
     envelope.request_type = 0; // GET
     envelope.path = "/download";
     envelope.content_type = ContentType::DaneJoe;
-    envelope.body = body;
+    envelope.body = std::move(body);
+
+    return build_request_byte_array(std::move(envelope), wire_version);
+}
+
+std::vector<uint8_t> ClientMessageCodec::build_manifest_request_byte_array(const ManifestRequestTransfer& manifest_request, int64_t request_id, std::optional<DaneJoe::SerializeVersion> wire_version)
+{
+    DANEJOE_LOG_TRACE("default", "ClientMessageCodec", "Building manifest request for file_id: {}", manifest_request.file_id);
+    // 构建消息体
+    DaneJoe::SerializeCodec& body_serializer = get_body_build_codec(resolve_wire_version(wire_version));
+    body_serializer.serialize(manifest_request.file_id, "file_id");
+    body_serializer.serialize(manifest_request.task_id, "task_id");
+    std::vector<uint8_t> body = body_serializer.take_serialized_data_vector_build();
+
+    // 构建Envelope请求
+    EnvelopeRequestTransfer envelope;
+    envelope.version = 1;
+    envelope.request_id = request_id;
+    envelope.request_type = 0; // GET
+    envelope.path = "/manifest";
+    envelope.content_type = ContentType::DaneJoe;
+    envelope.body = std::move(body);
+
+    return build_request_byte_array(std::move(envelope), wire_version);
+}
+
+std::vector<uint8_t> ClientMessageCodec::build_delta_request_byte_array(const DeltaRequestTransfer& delta_request, int64_t request_id, std::optional<DaneJoe::SerializeVersion> wire_version)
+{
+    DANEJOE_LOG_TRACE("default", "ClientMessageCodec", "Building delta request for file_id: {}", delta_request.file_id);
+    // 构建消息体
+    DaneJoe::SerializeCodec& body_serializer = get_body_build_codec(resolve_wire_version(wire_version));
+    body_serializer.serialize(delta_request.file_id, "file_id");
+    body_serializer.serialize(delta_request.task_id, "task_id");
+    body_serializer.serialize(delta_request.signature, "signature");
+    std::vector<uint8_t> body = body_serializer.take_serialized_data_vector_build();
+
+    // 构建Envelope请求
+    EnvelopeRequestTransfer envelope;
+    envelope.version = 1;
+    envelope.request_id = request_id;
+    envelope.request_type = 1; // POST
+    envelope.path = "/delta";
+    envelope.content_type = ContentType::DaneJoe;
+    envelope.body = std::move(body);
 
-    return build_request_byte_array(envelope);
+    return build_request_byte_array(std::move(envelope), wire_version);
 }
 
-std::vector<uint8_t> ClientMessageCodec::build_block_request_byte_array(const BlockRequestTransfer& block_request, int64_t request_id)
+std::vector<uint8_t> ClientMessageCodec::build_block_request_byte_array(const BlockRequestTransfer& block_request, int64_t request_id, std::optional<DaneJoe::SerializeVersion> wire_version)
 {
     DANEJOE_LOG_TRACE("default", "ClientMessageCodec", "Building block request for block: {}", block_request.to_string());
     // 构建消息体
-    DaneJoe::SerializeCodec body_serializer;
+    DaneJoe::SerializeCodec& body_serializer = get_body_build_codec(resolve_wire_version(wire_version));
     body_serializer.serialize(block_request.block_id, "block_id");
     body_serializer.serialize(block_request.file_id, "file_id");
     body_serializer.serialize(block_request.task_id, "task_id");
     body_serializer.serialize(block_request.offset, "offset");
     body_serializer.serialize(block_request.block_size, "block_size");
-    std::vector<uint8_t> body = body_serializer.get_serialized_data_vector_build();
+    std::vector<uint8_t> body = body_serializer.take_serialized_data_vector_build();
 
     // 构建Envelope请求
     EnvelopeRequestTransfer envelope;
@@ -324,7 +566,7 @@ std::vector<uint8_t> ClientMessageCodec::build_block_request_byte_array(const Bl
     envelope.request_type = 0; // GET
     envelope.path = "/block";
     envelope.content_type = ContentType::DaneJoe;
-    envelope.body = body;
+    envelope.body = std::move(body);
 
-    return build_request_byte_array(envelope);
+    return build_request_byte_array(std::move(envelope), wire_version);
 }
@@ -0,0 +1,184 @@
+#include <danejoe/database/sql_database_manager.hpp>
+#include <danejoe/database/sql_query.hpp>
+#include <danejoe/database/sql_schema.hpp>
+#include <danejoe/database/sqlite_stringify.hpp>
+#include <danejoe/condition/range_condition.hpp>
+#include <danejoe/logger/logger_manager.hpp>
+
+#include "repository/task_progress_repository.hpp"
+
+TaskProgressRepository::TaskProgressRepository() {}
+
+TaskProgressRepository::~TaskProgressRepository() {}
+
+void TaskProgressRepository::init()
+{
+    if (m_is_init)
+    {
+        DANEJOE_LOG_TRACE("default", "TaskProgressRepository", "Database already initialized");
+        return;
+    }
+
+    m_table = std::make_shared<DaneJoe::SqlTableItem>();
+
+    auto sql_database = DaneJoe::SqlDatabaseManager::get_instance().get_database("client_database");
+    auto sql_query = std::make_shared<DaneJoe::SqlQuery>(sql_database);
+    auto sqlite_stringify = std::make_shared<DaneJoe::SqliteStringify>();
+
+    m_table->table_name = "task_progress";
+    m_table->is_unique = true;
+
+    DaneJoe::SqlColumnItem task_id_column;
+    task_id_column.column_index = 0;
+    task_id_column.column_name = "task_id";
+    task_id_column.data_type = DaneJoe::DataType::Int64;
+    task_id_column.is_primary_key = true;
+    task_id_column.is_not_null = true;
+    task_id_column.is_unique = true;
+    m_table->add_column(task_id_column);
+
+    DaneJoe::SqlColumnItem completed_ranges_column;
+    completed_ranges_column.column_index = 1;
+    completed_ranges_column.column_name = "completed_ranges";
+    completed_ranges_column.data_type = DaneJoe::DataType::ByteArray;
+    completed_ranges_column.is_not_null = true;
+    m_table->add_column(completed_ranges_column);
+
+    DaneJoe::SqlColumnItem digest_state_column;
+    digest_state_column.column_index = 2;
+    digest_state_column.column_name = "digest_state";
+    digest_state_column.data_type = DaneJoe::DataType::ByteArray;
+    digest_state_column.is_not_null = false;
+    m_table->add_column(digest_state_column);
+
+    m_table_query.set_stringify(sqlite_stringify);
+    m_table_query.set_table_info(m_table);
+    m_table_query.set_query(sql_query);
+
+    m_is_init = true;
+    m_is_init = ensure_table_exists();
+}
+
+bool TaskProgressRepository::ensure_table_exists()
+{
+    if (!m_is_init || !m_table)
+    {
+        DANEJOE_LOG_TRACE("default", "TaskProgressRepository", "Database not initialized");
+        return false;
+    }
+    return m_table_query.create();
+}
+
+std::optional<TaskProgressEntity> TaskProgressRepository::get_by_task_id(int64_t task_id)
+{
+    if (!m_is_init)
+    {
+        DANEJOE_LOG_TRACE("default", "TaskProgressRepository", "Database not initialized");
+        return std::nullopt;
+    }
+
+    DaneJoe::SqlConditionItem condition;
+    auto task_id_column_opt = m_table->get_column_info("task_id");
+    if (!task_id_column_opt)
+    {
+        DANEJOE_LOG_TRACE("default", "TaskProgressRepository", "Table column not found");
+        return std::nullopt;
+    }
+
+    condition.column_info = *task_id_column_opt;
+    condition.is_set = true;
+    condition.is_desc_order = std::nullopt;
+    condition.condition = std::make_shared<DaneJoe::RangeCondition<int64_t>>(task_id);
+
+    auto data = m_table_query.select(m_table->column_items, { condition });
+    auto result = from_query_data(data);
+    if (result.empty())
+    {
+        return std::nullopt;
+    }
+    return result[0];
+}
+
+bool TaskProgressRepository::save(const TaskProgressEntity& progress)
+{
+    if (!m_is_init)
+    {
+        DANEJOE_LOG_TRACE("default", "TaskProgressRepository", "Database not initialized");
+        return false;
+    }
+
+    auto database = DaneJoe::SqlDatabaseManager::get_instance().get_database("client_database");
+    if (!database)
+    {
+        DANEJOE_LOG_TRACE("default", "TaskProgressRepository", "Database not found");
+        return false;
+    }
+
+    DaneJoe::SqlQuery query(database);
+    query.prepare("INSERT OR REPLACE INTO task_progress (task_id, completed_ranges, digest_state) VALUES (?, ?, ?);");
+    query.reset();
+    query.bind(1, progress.task_id);
+    query.bind(2, progress.to_blob());
+    query.bind(3, progress.digest_state);
+    return query.execute_command();
+}
+
+bool TaskProgressRepository::remove(int64_t task_id)
+{
+    if (!m_is_init)
+    {
+        DANEJOE_LOG_TRACE("default", "TaskProgressRepository", "Database not initialized");
+        return false;
+    }
+
+    DaneJoe::SqlConditionItem condition;
+    auto task_id_column_opt = m_table->get_column_info("task_id");
+    if (!task_id_column_opt)
+    {
+        DANEJOE_LOG_TRACE("default", "TaskProgressRepository", "Table column not found");
+        return false;
+    }
+
+    condition.column_info = *task_id_column_opt;
+    condition.is_set = true;
+    condition.is_desc_order = std::nullopt;
+    condition.condition = std::make_shared<DaneJoe::RangeCondition<int64_t>>(task_id);
+
+    return m_table_query.remove({ condition });
+}
+
+std::vector<TaskProgressEntity> TaskProgressRepository::from_query_data(const std::vector<std::vector<DaneJoe::SqlCell>>& data)
+{
+    std::vector<TaskProgressEntity> result;
+    for (const auto& row : data)
+    {
+        TaskProgressEntity progress;
+        bool is_decoded = true;
+        for (const auto& cell : row)
+        {
+            if (cell.column_name == "task_id")
+            {
+                progress.task_id = std::get<int64_t>(cell.data);
+            }
+            else if (cell.column_name == "completed_ranges")
+            {
+                is_decoded = progress.from_blob(std::get<std::vector<uint8_t>>(cell.data));
+            }
+            else if (cell.column_name == "digest_state")
+            {
+                // 空状态以 NULL 存储
+                if (auto digest_state = std::get_if<std::vector<uint8_t>>(&cell.data))
+                {
+                    progress.digest_state = *digest_state;
+                }
+            }
+        }
+        if (!is_decoded)
+        {
+            DANEJOE_LOG_WARN("default", "TaskProgressRepository", "Failed to decode progress of task {}", progress.task_id);
+            continue;
+        }
+        result.push_back(progress);
+    }
+    return result;
+}
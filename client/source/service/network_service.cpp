@@ -1,3 +1,5 @@
+#include <algorithm>
+
 #include "danejoe/logger/logger_manager.hpp"
 #include "service/network_service.hpp"
 
@@ -9,26 +11,109 @@ void NetworkService::init()
 
 }
 
-void NetworkService::on_write_raw_data(const NetworkEndpoint& endpoint, QByteArray data)
+void NetworkService::set_pool_config(const NetworkPoolConfig& config)
 {
-    auto connect_context_it = m_connect_map.find(endpoint);
-    if (connect_context_it == m_connect_map.end())
+    m_pool_config = config;
+    if (m_pool_config.max_connections_per_endpoint == 0)
     {
-        auto socket = new QTcpSocket(this);
-        auto connect_context = std::make_unique<ConnectContext>(socket, this);
-        connect_context->write_data(data);
-        connect(connect_context.get(), &ConnectContext::frame_assembled, this, &NetworkService::on_frame_assembled);
-        socket->connectToHost(QString::fromStdString(endpoint.ip), endpoint.port);
-        m_connect_map[endpoint].push_back(std::move(connect_context));
+        m_pool_config.max_connections_per_endpoint = 1;
     }
-    else
+}
+
+NetworkPoolConfig NetworkService::get_pool_config()const
+{
+    return m_pool_config;
+}
+
+void NetworkService::on_write_raw_data(const NetworkEndpoint& endpoint, QByteArray data)
+{
+    auto [pool, index] = select_connect(endpoint);
+    pool.connect_contexts[index]->write_data(data);
+}
+
+void NetworkService::on_write_request_frame(const NetworkEndpoint& endpoint, uint64_t request_id, int64_t expected_bytes, QByteArray data)
+{
+    auto [pool, index] = select_connect(endpoint);
+    pool.balancer.on_dispatched(request_id, index, expected_bytes + data.size());
+    pool.connect_contexts[index]->write_data(data);
+    DANEJOE_LOG_TRACE("default", "NetworkService", "Request {} dispatched on connection {}, outstanding bytes: {}", request_id, index, pool.balancer.get_outstanding_bytes(index));
+}
+
+void NetworkService::on_request_finished(const NetworkEndpoint& endpoint, uint64_t request_id)
+{
+    auto connect_pool_it = m_connect_map.find(endpoint);
+    if (connect_pool_it == m_connect_map.end())
     {
-        /// @todo 如何处理负载问题
-        connect_context_it->second.front()->write_data(data);
+        return;
     }
+    connect_pool_it->second.balancer.on_finished(request_id);
 }
 
-void NetworkService::on_frame_assembled(QByteArray frame)
+void NetworkService::on_frame_assembled(const std::vector<uint8_t>& frame)
 {
     emit received_frame_ready(frame);
-}
\ No newline at end of file
+}
+
+std::pair<EndpointConnectPool&, std::size_t> NetworkService::select_connect(const NetworkEndpoint& endpoint)
+{
+    auto& pool = m_connect_map[endpoint];
+    if (pool.balancer.should_add_slot(m_pool_config.max_connections_per_endpoint))
+    {
+        pool.connect_contexts.push_back(open_connect(endpoint));
+        auto index = pool.balancer.add_slot();
+        DANEJOE_LOG_DEBUG("default", "NetworkService", "Opened connection {} to {}:{}", index, endpoint.ip, endpoint.port);
+        return { pool, index };
+    }
+    auto index = pool.balancer.select().value_or(0);
+    if (!pool.connect_contexts[index])
+    {
+        pool.connect_contexts[index] = open_connect(endpoint);
+        DANEJOE_LOG_DEBUG("default", "NetworkService", "Reopened connection {} to {}:{}", index, endpoint.ip, endpoint.port);
+    }
+    return { pool, index };
+}
+
+std::unique_ptr<ConnectContext> NetworkService::open_connect(const NetworkEndpoint& endpoint)
+{
+    auto socket = new QTcpSocket();
+    auto connect_context = std::make_unique<ConnectContext>(socket, this);
+    socket->setParent(connect_context.get());
+    connect(connect_context.get(), &ConnectContext::frame_assembled, this, &NetworkService::on_frame_assembled);
+    ConnectContext* context_ptr = connect_context.get();
+    connect(connect_context.get(), &ConnectContext::socket_disconnected, this,
+        [this, endpoint, context_ptr]()
+        {
+            on_connect_disconnected(endpoint, context_ptr);
+        });
+    socket->connectToHost(QString::fromStdString(endpoint.ip), endpoint.port);
+    return connect_context;
+}
+
+void NetworkService::on_connect_disconnected(const NetworkEndpoint& endpoint, ConnectContext* connect_context)
+{
+    auto connect_pool_it = m_connect_map.find(endpoint);
+    if (connect_pool_it == m_connect_map.end())
+    {
+        return;
+    }
+    auto& pool = connect_pool_it->second;
+    auto context_it = std::find_if(pool.connect_contexts.begin(), pool.connect_contexts.end(),
+        [connect_context](const std::unique_ptr<ConnectContext>& context)
+        {
+            return context.get() == connect_context;
+        });
+    if (context_it == pool.connect_contexts.end())
+    {
+        return;
+    }
+    auto index = static_cast<std::size_t>(context_it - pool.connect_contexts.begin());
+    // 断开信号由该上下文发出，延迟到事件循环中销毁
+    context_it->release()->deleteLater();
+    auto request_ids = pool.balancer.clear_slot(index);
+    DANEJOE_LOG_WARN("default", "NetworkService", "Connection {} to {}:{} lost, in-flight requests: {}",
+        index, endpoint.ip, endpoint.port, request_ids.size());
+    if (!request_ids.empty())
+    {
+        emit connect_lost(endpoint, std::move(request_ids));
+    }
+}
@@ -0,0 +1,32 @@
+#include "danejoe/logger/logger_manager.hpp"
+
+#include "service/task_progress_service.hpp"
+
+TaskProgressService::TaskProgressService() {}
+
+TaskProgressService::~TaskProgressService() {}
+
+void TaskProgressService::init()
+{
+    m_task_progress_repository.init();
+}
+
+std::optional<TaskProgressEntity> TaskProgressService::get_by_task_id(int64_t task_id)
+{
+    return m_task_progress_repository.get_by_task_id(task_id);
+}
+
+bool TaskProgressService::save(const TaskProgressEntity& progress)
+{
+    if (progress.task_id < 0)
+    {
+        DANEJOE_LOG_WARN("default", "TaskProgressService", "Failed to save task progress: Task ID is invalid!");
+        return false;
+    }
+    return m_task_progress_repository.save(progress);
+}
+
+bool TaskProgressService::remove(int64_t task_id)
+{
+    return m_task_progress_repository.remove(task_id);
+}
@@ -0,0 +1,96 @@
+#include "service/trans_correlation_table.hpp"
+
+TransCorrelationTable::TransCorrelationTable(std::size_t capacity)
+{
+    std::size_t slot_count = SHARD_COUNT;
+    while (slot_count < capacity)
+    {
+        slot_count <<= 1;
+    }
+    m_slots.resize(slot_count);
+    m_slot_mask = slot_count - 1;
+}
+
+void TransCorrelationTable::insert(TransCorrelation correlation)
+{
+    uint64_t request_id = correlation.context.request_id;
+    auto& shard = m_shards[request_id & (SHARD_COUNT - 1)];
+    auto& slot = m_slots[request_id & m_slot_mask];
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    if (!slot.is_occupied)
+    {
+        slot.correlation = std::move(correlation);
+        slot.is_occupied = true;
+    }
+    else
+    {
+        // 槽位仍被一圈之前的请求占用
+        shard.overflow[request_id] = std::move(correlation);
+    }
+    shard.size++;
+}
+
+std::optional<TransCorrelation> TransCorrelationTable::take(uint64_t request_id)
+{
+    auto& shard = m_shards[request_id & (SHARD_COUNT - 1)];
+    auto& slot = m_slots[request_id & m_slot_mask];
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    if (slot.is_occupied && slot.correlation.context.request_id == request_id)
+    {
+        slot.is_occupied = false;
+        shard.size--;
+        return std::move(slot.correlation);
+    }
+    if (shard.overflow.empty())
+    {
+        return std::nullopt;
+    }
+    auto it = shard.overflow.find(request_id);
+    if (it == shard.overflow.end())
+    {
+        return std::nullopt;
+    }
+    TransCorrelation correlation = std::move(it->second);
+    shard.overflow.erase(it);
+    shard.size--;
+    return correlation;
+}
+
+bool TransCorrelationTable::set_timeout_handle(uint64_t request_id, const DaneJoe::TimerHandle& handle)
+{
+    auto& shard = m_shards[request_id & (SHARD_COUNT - 1)];
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto correlation = find_locked(shard, request_id);
+    if (!correlation)
+    {
+        return false;
+    }
+    correlation->timeout_handle = handle;
+    return true;
+}
+
+std::size_t TransCorrelationTable::size()
+{
+    std::size_t total = 0;
+    for (auto& shard : m_shards)
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        total += shard.size;
+    }
+    return total;
+}
+
+TransCorrelation* TransCorrelationTable::find_locked(Shard& shard, uint64_t request_id)
+{
+    auto& slot = m_slots[request_id & m_slot_mask];
+    if (slot.is_occupied && slot.correlation.context.request_id == request_id)
+    {
+        return &slot.correlation;
+    }
+    if (shard.overflow.empty())
+    {
+        return nullptr;
+    }
+    auto it = shard.overflow.find(request_id);
+    return it == shard.overflow.end() ? nullptr : &it->second;
+}
@@ -1,3 +1,6 @@
+#include <algorithm>
+#include <optional>
+
 #include "danejoe/logger/logger_manager.hpp"
 #include "service/trans_service.hpp"
 
@@ -13,10 +16,15 @@ TransService::TransService() :
     m_network_service = new NetworkService();
     m_network_service->moveToThread(m_network_thread);
     m_network_thread->start();
+    // 帧在网络线程中组装完成后直接解码，避免经 GUI 线程的事件循环中转
     connect(m_network_service, &NetworkService::received_frame_ready, this,
-        &TransService::on_received_frame_ready);
+        &TransService::on_received_frame_ready, Qt::DirectConnection);
     connect(this, &TransService::send_frame_ready, m_network_service,
-        &NetworkService::on_write_raw_data, Qt::QueuedConnection);
+        &NetworkService::on_write_request_frame, Qt::QueuedConnection);
+    connect(this, &TransService::request_finished, m_network_service,
+        &NetworkService::on_request_finished, Qt::QueuedConnection);
+    connect(m_network_service, &NetworkService::connect_lost, this,
+        &TransService::on_connect_lost, Qt::DirectConnection);
 }
 TransService::~TransService()
 {
@@ -43,118 +51,269 @@ TransService::~TransService()
 void TransService::init()
 {}
 
+void TransService::set_window_config(const TransWindowConfig& config)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_window_config = config;
+}
+
+TransWindowConfig TransService::get_window_config()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_window_config;
+}
+
+void TransService::set_connection_pool_config(const NetworkPoolConfig& config)
+{
+    QMetaObject::invokeMethod(m_network_service,
+        [network_service = m_network_service, config]()
+        {
+            network_service->set_pool_config(config);
+        }, Qt::QueuedConnection);
+}
+
+int64_t TransService::get_in_flight_count(const NetworkEndpoint& endpoint)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto window_it = m_trans_windows.find(endpoint);
+    if (window_it == m_trans_windows.end())
+    {
+        return 0;
+    }
+    return window_it->second.in_flight_requests;
+}
+
 TransContext TransService::send_test_request(
     const NetworkEndpoint& endpoint,
     const TestRequestTransfer& request)
 {
     uint64_t request_id = m_request_id_counter++;
-    m_timer_manager.add_task_for(m_time_out_interval,
-        [this, request_id]()
+    TransContext context{ request_id,endpoint };
+    add_response_handler(context, 0,
+        [this](const TransContext& context, std::vector<uint8_t> data)
         {
-            bool erased = false;
-            {
-                std::lock_guard<std::mutex> lock(m_mutex);
-                auto it = m_trans_correlations.find(request_id);
-                if (it != m_trans_correlations.end())
-                {
-                    m_trans_correlations.erase(it);
-                    erased = true;
-                }
-            }
-            if (erased)
-            {
-                DANEJOE_LOG_WARN("default", "TransService", "Timeout for request id {}", request_id);
-            }
+            receive_test_response(context, data);
         });
-    {
-        std::lock_guard<std::mutex> lock(m_mutex);
-        TransCorrelation correlation;
-        correlation.context = TransContext{ request_id,endpoint };
-        correlation.callback = [this, correlation](const std::vector<uint8_t>& data)
-            {
-                receive_test_response(correlation.context, data);
-            };
-        m_trans_correlations[request_id] = correlation;
-    }
-    auto data = m_message_codec.build_test_request_byte_array(request, request_id);
-    emit send_frame_ready(endpoint, QByteArray(reinterpret_cast<const char*>(data.data()), data.size()));
-    return TransContext{ request_id,endpoint };
+    auto data = m_message_codec.build_test_request_byte_array(request, request_id, get_endpoint_wire_version(endpoint));
+    submit_frame(endpoint, request_id, 0,
+        QByteArray(reinterpret_cast<const char*>(data.data()), data.size()));
+    return context;
 }
 TransContext TransService::send_download_request(
     const NetworkEndpoint& endpoint,
     const DownloadRequestTransfer& request)
 {
     uint64_t request_id = m_request_id_counter++;
-    m_timer_manager.add_task_for(m_time_out_interval,
-        [this, request_id]()
+    TransContext context{ request_id,endpoint };
+    add_response_handler(context, 0,
+        [this](const TransContext& context, std::vector<uint8_t> data)
         {
-            bool erased = false;
-            {
-                std::lock_guard<std::mutex> lock(m_mutex);
-                auto it = m_trans_correlations.find(request_id);
-                if (it != m_trans_correlations.end())
-                {
-                    m_trans_correlations.erase(it);
-                    erased = true;
-                }
-            }
-            if (erased)
-            {
-                DANEJOE_LOG_WARN("default", "TransService", "Timeout for request id {}", request_id);
-            }
+            receive_download_response(context, data);
+        });
+    auto data = m_message_codec.build_download_request_byte_array(request, request_id, get_endpoint_wire_version(endpoint));
+    submit_frame(endpoint, request_id, 0,
+        QByteArray(reinterpret_cast<const char*>(data.data()), data.size()));
+    return context;
+}
+TransContext TransService::send_manifest_request(
+    const NetworkEndpoint& endpoint,
+    const ManifestRequestTransfer& request)
+{
+    uint64_t request_id = m_request_id_counter++;
+    TransContext context{ request_id,endpoint };
+    add_response_handler(context, 0,
+        [this](const TransContext& context, std::vector<uint8_t> data)
+        {
+            receive_manifest_response(context, data);
+        });
+    auto data = m_message_codec.build_manifest_request_byte_array(request, request_id, get_endpoint_wire_version(endpoint));
+    submit_frame(endpoint, request_id, 0,
+        QByteArray(reinterpret_cast<const char*>(data.data()), data.size()));
+    return context;
+}
+TransContext TransService::send_delta_request(
+    const NetworkEndpoint& endpoint,
+    const DeltaRequestTransfer& request)
+{
+    uint64_t request_id = m_request_id_counter++;
+    TransContext context{ request_id,endpoint };
+    add_response_handler(context, 0,
+        [this](const TransContext& context, std::vector<uint8_t> data)
+        {
+            receive_delta_response(context, data);
+        });
+    auto data = m_message_codec.build_delta_request_byte_array(request, request_id, get_endpoint_wire_version(endpoint));
+    submit_frame(endpoint, request_id, 0,
+        QByteArray(reinterpret_cast<const char*>(data.data()), data.size()));
+    return context;
+}
+TransContext TransService::send_block_request(
+    const NetworkEndpoint& endpoint,
+    const BlockRequestTransfer& request)
+{
+    uint64_t request_id = m_request_id_counter++;
+    TransContext context{ request_id,endpoint };
+    // 块请求按期望返回的数据量占用字节额度
+    int64_t credit_bytes = request.block_size > 0 ? request.block_size : 0;
+    add_response_handler(context, credit_bytes,
+        [this](const TransContext& context, std::vector<uint8_t> data)
+        {
+            receive_block_response(context, data);
+        });
+    auto data = m_message_codec.build_block_request_byte_array(request, request_id, get_endpoint_wire_version(endpoint));
+    submit_frame(endpoint, request_id, credit_bytes,
+        QByteArray(reinterpret_cast<const char*>(data.data()), data.size()));
+    return context;
+}
+
+bool TransService::cancel_request(uint64_t request_id)
+{
+    return take_request(request_id).has_value();
+}
+
+std::optional<TransContext> TransService::take_request(uint64_t request_id)
+{
+    auto correlation_opt = m_trans_correlations.take(request_id);
+    if (!correlation_opt.has_value())
+    {
+        return std::nullopt;
+    }
+    m_timer_manager.cancel(correlation_opt->timeout_handle);
+    const auto& endpoint = correlation_opt->context.endpoint;
+    if (remove_pending_frame(endpoint, request_id))
+    {
+        DANEJOE_LOG_DEBUG("default", "TransService", "Cancelled request {} before dispatch", request_id);
+        return correlation_opt->context;
+    }
+    DANEJOE_LOG_DEBUG("default", "TransService", "Cancelled request {}", request_id);
+    release_credit(endpoint, request_id, correlation_opt->credit_bytes);
+    return correlation_opt->context;
+}
+
+void TransService::add_response_handler(
+    const TransContext& context,
+    int64_t credit_bytes,
+    TransResponseCallback callback)
+{
+    TransCorrelation correlation;
+    correlation.context = context;
+    correlation.callback = std::move(callback);
+    correlation.credit_bytes = credit_bytes;
+    m_trans_correlations.insert(std::move(correlation));
+}
+
+bool TransService::has_credit(const TransWindow& window, int64_t credit_bytes) const
+{
+    if (window.in_flight_requests == 0)
+    {
+        return true;
+    }
+    if (window.in_flight_requests >= m_window_config.max_in_flight_requests)
+    {
+        return false;
+    }
+    return window.in_flight_bytes + credit_bytes <= m_window_config.max_in_flight_bytes;
+}
+
+void TransService::submit_frame(
+    const NetworkEndpoint& endpoint,
+    uint64_t request_id,
+    int64_t credit_bytes,
+    QByteArray data)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto& window = m_trans_windows[endpoint];
+        // 已有排队请求时保持先来先发，避免小请求持续插队导致大请求饥饿
+        if (!window.pending_frames.empty() || !has_credit(window, credit_bytes))
+        {
+            window.pending_frames.push_back(TransPendingFrame{ request_id,credit_bytes,std::move(data) });
+            DANEJOE_LOG_TRACE("default", "TransService", "Request {} waiting for credit, pending: {}", request_id, window.pending_frames.size());
+            return;
         }
-    );
+        window.in_flight_requests++;
+        window.in_flight_bytes += credit_bytes;
+    }
+    dispatch_frame(endpoint, request_id, credit_bytes, data);
+}
+
+bool TransService::remove_pending_frame(const NetworkEndpoint& endpoint, uint64_t request_id)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto window_it = m_trans_windows.find(endpoint);
+    if (window_it == m_trans_windows.end())
+    {
+        return false;
+    }
+    auto& pending_frames = window_it->second.pending_frames;
+    auto frame_it = std::find_if(pending_frames.begin(), pending_frames.end(),
+        [request_id](const TransPendingFrame& pending_frame)
+        {
+            return pending_frame.request_id == request_id;
+        });
+    if (frame_it == pending_frames.end())
+    {
+        return false;
+    }
+    pending_frames.erase(frame_it);
+    return true;
+}
+
+void TransService::release_credit(const NetworkEndpoint& endpoint, uint64_t request_id, int64_t credit_bytes)
+{
+    emit request_finished(endpoint, request_id);
+    std::vector<TransPendingFrame> ready_frames;
     {
         std::lock_guard<std::mutex> lock(m_mutex);
-        TransCorrelation correlation;
-        correlation.context = TransContext{ request_id,endpoint };
-        correlation.callback = [this, correlation](const std::vector<uint8_t>& data)
-            {
-                receive_download_response(correlation.context, data);
-            };
-        m_trans_correlations[request_id] = correlation;
+        auto window_it = m_trans_windows.find(endpoint);
+        if (window_it == m_trans_windows.end())
+        {
+            return;
+        }
+        auto& window = window_it->second;
+        window.in_flight_requests = std::max<int64_t>(0, window.in_flight_requests - 1);
+        window.in_flight_bytes = std::max<int64_t>(0, window.in_flight_bytes - credit_bytes);
+        while (!window.pending_frames.empty() &&
+            has_credit(window, window.pending_frames.front().credit_bytes))
+        {
+            auto& pending_frame = window.pending_frames.front();
+            window.in_flight_requests++;
+            window.in_flight_bytes += pending_frame.credit_bytes;
+            ready_frames.push_back(std::move(pending_frame));
+            window.pending_frames.pop_front();
+        }
+    }
+    for (const auto& pending_frame : ready_frames)
+    {
+        dispatch_frame(endpoint, pending_frame.request_id, pending_frame.credit_bytes, pending_frame.data);
     }
-    auto data = m_message_codec.build_download_request_byte_array(request, request_id);
-    emit send_frame_ready(endpoint, QByteArray(reinterpret_cast<const char*>(data.data()), data.size()));
-    return TransContext{ request_id,endpoint };
 }
-TransContext TransService::send_block_request(
+
+void TransService::dispatch_frame(
     const NetworkEndpoint& endpoint,
-    const BlockRequestTransfer& request)
+    uint64_t request_id,
+    int64_t credit_bytes,
+    const QByteArray& data)
 {
-    uint64_t request_id = m_request_id_counter++;
-    m_timer_manager.add_task_for(m_time_out_interval,
+    // 超时从真正发出时开始计算，排队等待额度的时间不计入
+    auto timeout_handle = m_timer_manager.add_task_for(m_time_out_interval,
         [this, request_id]()
         {
-            bool erased = false;
-            {
-                std::lock_guard<std::mutex> lock(m_mutex);
-                auto it = m_trans_correlations.find(request_id);
-                if (it != m_trans_correlations.end())
-                {
-                    m_trans_correlations.erase(it);
-                    erased = true;
-                }
-            }
-            if (erased)
+            auto correlation_opt = m_trans_correlations.take(request_id);
+            if (correlation_opt.has_value())
             {
                 DANEJOE_LOG_WARN("default", "TransService", "Timeout for request id {}", request_id);
+                release_credit(correlation_opt->context.endpoint, request_id, correlation_opt->credit_bytes);
+                emit request_failed(correlation_opt->context);
             }
-        }
-    );
+        });
+    if (!m_trans_correlations.set_timeout_handle(request_id, timeout_handle))
     {
-        std::lock_guard<std::mutex> lock(m_mutex);
-        TransCorrelation correlation;
-        correlation.context = TransContext{ request_id,endpoint };
-        correlation.callback = [this, correlation](const std::vector<uint8_t>& data)
-            {
-                receive_block_response(correlation.context, data);
-            };
-        m_trans_correlations[request_id] = correlation;
+        // 关联已被移除（例如请求被撤销），额度已由撤销方归还，请求不再发出
+        m_timer_manager.cancel(timeout_handle);
+        return;
     }
-    auto data = m_message_codec.build_block_request_byte_array(request, request_id);
-    emit send_frame_ready(endpoint, QByteArray(reinterpret_cast<const char*>(data.data()), data.size()));
-    return TransContext{ request_id,endpoint };
+    emit send_frame_ready(endpoint, request_id, credit_bytes, data);
 }
 void TransService::receive_test_response(
     TransContext trans_context,
@@ -166,6 +325,7 @@ void TransService::receive_test_response(
     if (!test_response_opt.has_value())
     {
         DANEJOE_LOG_ERROR("default", "TransService", "Failed to parse test response");
+        emit request_failed(trans_context);
         return;
     }
     auto response =
@@ -182,12 +342,47 @@ void TransService::receive_download_response(
     if (!download_response_opt.has_value())
     {
         DANEJOE_LOG_ERROR("default", "TransService", "Failed to parse download response");
+        emit request_failed(trans_context);
         return;
     }
     auto response =
         std::move(download_response_opt.value());
     emit download_response_received(trans_context, response);
 }
+void TransService::receive_manifest_response(
+    TransContext trans_context,
+    const std::vector<uint8_t>& data)
+{
+    auto manifest_response_opt =
+        m_message_codec.
+        try_parse_byte_array_manifest_response(data);
+    if (!manifest_response_opt.has_value())
+    {
+        DANEJOE_LOG_ERROR("default", "TransService", "Failed to parse manifest response");
+        emit request_failed(trans_context);
+        return;
+    }
+    auto response =
+        std::move(manifest_response_opt.value());
+    emit manifest_response_received(trans_context, response);
+}
+void TransService::receive_delta_response(
+    TransContext trans_context,
+    const std::vector<uint8_t>& data)
+{
+    auto delta_response_opt =
+        m_message_codec.
+        try_parse_byte_array_delta_response(data);
+    if (!delta_response_opt.has_value())
+    {
+        DANEJOE_LOG_ERROR("default", "TransService", "Failed to parse delta response");
+        emit request_failed(trans_context);
+        return;
+    }
+    auto response =
+        std::move(delta_response_opt.value());
+    emit delta_response_received(trans_context, response);
+}
 void TransService::receive_block_response(
     TransContext trans_context,
     const std::vector<uint8_t>& data)
@@ -198,6 +393,7 @@ void TransService::receive_block_response(
     if (!block_response_opt.has_value())
     {
         DANEJOE_LOG_ERROR("default", "TransService", "Failed to parse block response");
+        emit request_failed(trans_context);
         return;
     }
     auto response =
@@ -205,11 +401,34 @@ void TransService::receive_block_response(
     emit block_response_received(trans_context, response);
 }
 
-void TransService::on_received_frame_ready(QByteArray data)
+DaneJoe::SerializeVersion TransService::get_endpoint_wire_version(const NetworkEndpoint& endpoint)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto window_it = m_trans_windows.find(endpoint);
+    if (window_it == m_trans_windows.end())
+    {
+        return DaneJoe::SerializeVersion::Named;
+    }
+    return window_it->second.wire_version;
+}
+
+void TransService::set_endpoint_wire_version(const NetworkEndpoint& endpoint, DaneJoe::SerializeVersion wire_version)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto& window = m_trans_windows[endpoint];
+    if (window.wire_version != wire_version)
+    {
+        DANEJOE_LOG_INFO("default", "TransService", "Endpoint {}:{} wire version: {}",
+            endpoint.ip, endpoint.port, static_cast<int>(wire_version));
+        window.wire_version = wire_version;
+    }
+}
+
+void TransService::on_received_frame_ready(const std::vector<uint8_t>& data)
 {
     DANEJOE_LOG_DEBUG("default", "TransService", "on_received_frame_ready");
     auto response_opt =
-        m_message_codec.try_parse_byte_array_response(std::vector<uint8_t>(data.begin(), data.end()));
+        m_message_codec.try_parse_byte_array_response(data);
     if (!response_opt.has_value())
     {
         DANEJOE_LOG_ERROR("default", "TransService", "Failed to parse response");
@@ -218,24 +437,31 @@ void TransService::on_received_frame_ready(QByteArray data)
     auto response = std::move(response_opt.value());
     DANEJOE_LOG_DEBUG("default","TransService","Response: {}",response.to_string());
 
-    std::function<void(std::vector<uint8_t>)> handler;
+    auto correlation_opt = m_trans_correlations.take(response.request_id);
+    if (!correlation_opt.has_value())
     {
-        std::lock_guard<std::mutex> lock(m_mutex);
-        auto handler_it = m_trans_correlations.find(response.request_id);
-        if (handler_it == m_trans_correlations.end())
-        {
-            DANEJOE_LOG_WARN("default", "TransService", "No handler found for request id {}", response.request_id);
-            return;
-        }
-        handler = std::move(handler_it->second.callback);
-        m_trans_correlations.erase(handler_it);
+        DANEJOE_LOG_WARN("default", "TransService", "No handler found for request id {}", response.request_id);
+        return;
     }
+    auto& correlation = correlation_opt.value();
+    m_timer_manager.cancel(correlation.timeout_handle);
+    set_endpoint_wire_version(correlation.context.endpoint, m_message_codec.get_peer_wire_version(data, response));
+    // 先归还额度，使等待中的请求尽快发出，再处理响应
+    release_credit(correlation.context.endpoint, response.request_id, correlation.credit_bytes);
 
-    handler(std::move(response.body));
+    correlation.callback(correlation.context, std::move(response.body));
 }
 
-void TransService::remove_response_handler(uint64_t request_id)
+void TransService::on_connect_lost(NetworkEndpoint endpoint, std::vector<uint64_t> request_ids)
 {
-    std::lock_guard<std::mutex> lock(m_mutex);
-    m_trans_correlations.erase(request_id);
-}
\ No newline at end of file
+    DANEJOE_LOG_WARN("default", "TransService", "Connection to {}:{} lost, cancelling {} requests",
+        endpoint.ip, endpoint.port, request_ids.size());
+    for (auto request_id : request_ids)
+    {
+        auto context_opt = take_request(request_id);
+        if (context_opt.has_value())
+        {
+            emit request_failed(context_opt.value());
+        }
+    }
+}
@@ -134,8 +134,9 @@ void NewDownloadDialog::init()
 void NewDownloadDialog::on_add_download_push_button_clicked()
 {
     /// @todo 创建任务，发送请求--》等待面板-->>区分超时和正常
-    auto url_text = m_url_line_edit->text().toStdString();
-    auto url_info = m_url_resolver.parse(url_text);
+    // 可填写多个以空白分隔的镜像源链接，首个为主源
+    auto url_text = m_url_line_edit->text().trimmed().toStdString();
+    auto url_info = m_url_resolver.parse(url_text.substr(0, url_text.find_first_of(" \t")));
     EventContext event_context;
     event_context.m_object_name = "NewDownloadDialog";
     NetworkEndpoint endpoint;
@@ -207,6 +208,11 @@ void NewDownloadDialog::on_download_response(
     EventEnvelope event_envelope, TransContext trans_context,
     DownloadResponseTransfer response)
 {
+    // 下载响应广播给所有监听者，仅处理本对话框发出的请求
+    if (event_envelope.m_event_context.m_object_name != "NewDownloadDialog")
+    {
+        return;
+    }
     DANEJOE_LOG_INFO("default", "NewDownloadDialog",
         "Source from: {}",
         event_envelope.m_event_context.m_object_name);
@@ -279,7 +285,6 @@ void NewDownloadDialog::on_download_response(
     }
     DANEJOE_LOG_INFO("default", "NewDownloadDialog", "Recieved file info: {}", file_entity.to_string());
     m_client_file_service.add(file_entity);
-    m_block_service.add(file_entity, response.task_id, BlockParam());
 }
 
 void NewDownloadDialog::on_path_button_clicked()
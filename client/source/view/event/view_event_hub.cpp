@@ -17,7 +17,7 @@ void ViewEventHub::publish_test_request(
     event_envelope.m_event_time = std::chrono::steady_clock::now();
     emit test_request(event_envelope, endpoint, request);
 }
-void ViewEventHub::publish_block_request(
+uint64_t ViewEventHub::publish_block_request(
     EventContext event_context,
     NetworkEndpoint endpoint,
     BlockRequestTransfer request)
@@ -27,6 +27,7 @@ void ViewEventHub::publish_block_request(
     event_envelope.m_event_id = m_event_id_counter++;
     event_envelope.m_event_time = std::chrono::steady_clock::now();
     emit block_request(event_envelope, endpoint, request);
+    return event_envelope.m_event_id;
 }
 void ViewEventHub::publish_download_request(
     EventContext event_context,
@@ -40,6 +41,35 @@ void ViewEventHub::publish_download_request(
     emit download_request(event_envelope, endpoint, request);
 }
 
+void ViewEventHub::publish_manifest_request(
+    EventContext event_context,
+    NetworkEndpoint endpoint,
+    ManifestRequestTransfer request)
+{
+    EventEnvelope event_envelope;
+    event_envelope.m_event_context = event_context;
+    event_envelope.m_event_id = m_event_id_counter++;
+    event_envelope.m_event_time = std::chrono::steady_clock::now();
+    emit manifest_request(event_envelope, endpoint, request);
+}
+
+void ViewEventHub::publish_delta_request(
+    EventContext event_context,
+    NetworkEndpoint endpoint,
+    DeltaRequestTransfer request)
+{
+    EventEnvelope event_envelope;
+    event_envelope.m_event_context = event_context;
+    event_envelope.m_event_id = m_event_id_counter++;
+    event_envelope.m_event_time = std::chrono::steady_clock::now();
+    emit delta_request(event_envelope, endpoint, request);
+}
+
+void ViewEventHub::publish_cancel_request(uint64_t event_id)
+{
+    emit cancel_request(event_id);
+}
+
 void ViewEventHub::publish_test_response(
     EventEnvelope event_envelope,
     TransContext trans_context,
@@ -56,6 +86,22 @@ void ViewEventHub::publish_download_response(
     emit download_response(event_envelope, trans_context, response);
 }
 
+void ViewEventHub::publish_manifest_response(
+    EventEnvelope event_envelope,
+    TransContext trans_context,
+    ManifestResponseTransfer response)
+{
+    emit manifest_response(event_envelope, trans_context, response);
+}
+
+void ViewEventHub::publish_delta_response(
+    EventEnvelope event_envelope,
+    TransContext trans_context,
+    DeltaResponseTransfer response)
+{
+    emit delta_response(event_envelope, trans_context, response);
+}
+
 void ViewEventHub::publish_block_response(
     EventEnvelope event_envelope,
     TransContext trans_context,
@@ -72,4 +118,9 @@ void ViewEventHub::publish_task_entity_update(int64_t task_id)
 void ViewEventHub::publish_task_entity_add(TaskEntity task_entity)
 {
     emit task_entity_add(task_entity);
+}
+
+void ViewEventHub::publish_task_progress(int64_t task_id, int64_t completed_bytes, int64_t total_bytes)
+{
+    emit task_progress(task_id, completed_bytes, total_bytes);
 }
\ No newline at end of file
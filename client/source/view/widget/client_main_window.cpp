@@ -1,3 +1,7 @@
+#include <sstream>
+#include <vector>
+#include <string>
+
 #include <QMenuBar>
 #include <QMenu>
 #include <QWidget>
@@ -151,6 +155,7 @@ void ClientMainWindow::init()
     connect(m_start_task_action, &QAction::triggered, this, &ClientMainWindow::on_start_task_action_triggered);
     connect(m_stop_task_action, &QAction::triggered, this, &ClientMainWindow::on_stop_task_action_triggered);
     connect(this, &ClientMainWindow::task_enqueue, m_block_schedule_controller, &BlockScheduleController::on_task_enqueue);
+    connect(this, &ClientMainWindow::task_source_add, m_block_schedule_controller, &BlockScheduleController::on_task_source_add);
     m_is_init = true;
     connect(m_block_schedule_controller, &BlockScheduleController::task_completed, this, &ClientMainWindow::on_task_completed);
 }
@@ -238,11 +243,39 @@ void ClientMainWindow::on_start_task_action_triggered()
     }
     EventContext event_context;
     event_context.m_object_name = "ClientMainWindow";
+    // 源链接以空白分隔，首个为主源，其余为镜像源
+    std::vector<std::string> source_urls;
+    std::istringstream url_stream(task_entity_opt->source_url);
+    std::string source_url;
+    while (url_stream >> source_url)
+    {
+        source_urls.push_back(source_url);
+    }
+    if (source_urls.empty())
+    {
+        DANEJOE_LOG_WARN("default", "ClientMainWindow", "Task {} has no source url", m_selected_task_id);
+        QMessageBox::warning(this, "warn", "Task has no source!");
+        return;
+    }
     NetworkEndpoint endpoint;
-    auto url_info = m_resolver.parse(task_entity_opt->source_url);
+    auto url_info = m_resolver.parse(source_urls.front());
     endpoint.ip = url_info.host;
     endpoint.port = url_info.port;
     emit task_enqueue(event_context, endpoint, task_entity_opt.value());
+    for (std::size_t i = 1; i < source_urls.size(); i++)
+    {
+        auto mirror_info = m_resolver.parse(source_urls[i]);
+        auto file_id_opt = mirror_info.get_param("file_id");
+        if (!file_id_opt.has_value())
+        {
+            DANEJOE_LOG_WARN("default", "ClientMainWindow", "Skip mirror without file_id: {}", source_urls[i]);
+            continue;
+        }
+        NetworkEndpoint mirror_endpoint;
+        mirror_endpoint.ip = mirror_info.host;
+        mirror_endpoint.port = mirror_info.port;
+        emit task_source_add(task_entity_opt->task_id, mirror_endpoint, std::stoll(file_id_opt.value()));
+    }
     QMessageBox::information(this, "info", QString("Task %1 will start soon.").arg(m_selected_task_id));
 }
 
@@ -37,6 +37,7 @@ void TaskTableWidget::init()
     m_layout->setStretch(0, 1);
 
     connect(m_view_event_hub, &ViewEventHub::task_entity_add, this, &TaskTableWidget::on_task_entity_add);
+    connect(m_view_event_hub, &ViewEventHub::task_progress, this, &TaskTableWidget::on_task_progress);
     connect(m_table_view, &QTableView::clicked, this, &TaskTableWidget::on_cell_clicked);
 
     m_is_init = true;
@@ -65,4 +66,9 @@ void TaskTableWidget::on_task_entity_add(TaskEntity task_entity)
 void TaskTableWidget::on_task_update(int64_t task_id)
 {
     m_table_model->update(task_id);
+}
+
+void TaskTableWidget::on_task_progress(int64_t task_id, int64_t completed_bytes, int64_t total_bytes)
+{
+    m_table_model->update_progress(task_id, completed_bytes, total_bytes);
 }
\ No newline at end of file
@@ -0,0 +1,182 @@
+#include <gtest/gtest.h>
+
+#include <set>
+#include <cstddef>
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+
+#include <danejoe/network/codec/chunk_header.hpp>
+#include <danejoe/network/codec/frame_chunker.hpp>
+#include <danejoe/network/codec/frame_assembler.hpp>
+#include <danejoe/network/codec/serialize_codec.hpp>
+#include <danejoe/network/codec/chunk_reassembler.hpp>
+
+namespace
+{
+    std::vector<uint8_t> make_frame(int64_t id, std::size_t data_size)
+    {
+        DaneJoe::SerializeCodec codec;
+        codec.serialize(id, "id");
+        codec.serialize(std::vector<uint8_t>(data_size, static_cast<uint8_t>(id)), "data");
+        return codec.take_serialized_data_vector_build();
+    }
+
+    std::vector<uint8_t> make_chunk(uint32_t stream_id, DaneJoe::ChunkFlag flag, const std::vector<uint8_t>& payload)
+    {
+        DaneJoe::ChunkHeader header;
+        header.stream_id = stream_id;
+        header.flag = flag;
+        header.payload_length = static_cast<uint32_t>(payload.size());
+        auto chunk = header.to_serialized_byte_array();
+        chunk.insert(chunk.end(), payload.begin(), payload.end());
+        return chunk;
+    }
+
+    /**
+     * @brief 按固定步长把字节流写入帧组装器并取出全部完整帧
+     * @param stream 字节流
+     * @param step 每次写入的字节数
+     */
+    std::vector<std::vector<uint8_t>> assemble(const std::vector<uint8_t>& stream, std::size_t step)
+    {
+        DaneJoe::FrameAssembler assembler;
+        std::vector<std::vector<uint8_t>> frames;
+        for (std::size_t offset = 0; offset < stream.size(); offset += step)
+        {
+            std::size_t end = std::min(stream.size(), offset + step);
+            EXPECT_TRUE(assembler.push_data(std::vector<uint8_t>(stream.begin() + offset, stream.begin() + end)));
+            while (auto frame_opt = assembler.pop_frame())
+            {
+                frames.push_back(std::move(frame_opt.value()));
+            }
+        }
+        EXPECT_FALSE(assembler.has_pending_data());
+        return frames;
+    }
+}
+
+TEST(ChunkReassemblerTest, PlainFramesPassThrough)
+{
+    auto first = make_frame(1, 100);
+    auto second = make_frame(2, 3000);
+    DaneJoe::FrameChunker chunker;
+    chunker.push_frame(first);
+    chunker.push_frame(second);
+    std::vector<uint8_t> stream;
+    chunker.fill_buffer(stream, SIZE_MAX);
+    // 未启用分片时字节流就是原始帧的拼接
+    ASSERT_EQ(stream.size(), first.size() + second.size());
+
+    DaneJoe::ChunkReassembler reassembler;
+    auto output = reassembler.push_data(stream);
+    ASSERT_TRUE(output.has_value());
+    EXPECT_EQ(output.value(), stream);
+    EXPECT_FALSE(reassembler.has_pending_data());
+
+    // 逐字节写入时帧头被切开，仍应得到相同的帧
+    auto frames = assemble(stream, 1);
+    ASSERT_EQ(frames.size(), 2u);
+    EXPECT_EQ(frames[0], first);
+    EXPECT_EQ(frames[1], second);
+}
+
+TEST(ChunkReassemblerTest, InterleavedStreamsReassemble)
+{
+    auto large_first = make_frame(1, 10 * 1024);
+    auto large_second = make_frame(2, 7 * 1024);
+    auto small = make_frame(3, 16);
+    DaneJoe::FrameChunkConfig config;
+    config.is_enabled = true;
+    config.chunk_size = 1024;
+    DaneJoe::FrameChunker chunker(config);
+    chunker.push_frame(large_first);
+    chunker.push_frame(large_second);
+    chunker.push_frame(small);
+
+    std::vector<uint8_t> stream;
+    std::vector<uint32_t> stream_ids;
+    while (auto unit_opt = chunker.pop_unit())
+    {
+        auto header_opt = DaneJoe::ChunkHeader::from_serialized_byte_array(unit_opt->data(), unit_opt->size());
+        if (header_opt.has_value())
+        {
+            stream_ids.push_back(header_opt->stream_id);
+        }
+        stream.insert(stream.end(), unit_opt->begin(), unit_opt->end());
+    }
+    // 两个大帧的分片交错输出
+    ASSERT_GE(stream_ids.size(), 2u);
+    EXPECT_NE(stream_ids[0], stream_ids[1]);
+
+    // 奇数步长写入，使分片头与帧头跨越多次写入
+    for (std::size_t step : { std::size_t(7), std::size_t(1500), stream.size() })
+    {
+        auto frames = assemble(stream, step);
+        ASSERT_EQ(frames.size(), 3u);
+        // 小帧不必等大帧发完
+        EXPECT_EQ(frames[0], small);
+        std::set<std::vector<uint8_t>> large_frames(frames.begin() + 1, frames.end());
+        EXPECT_EQ(large_frames, (std::set<std::vector<uint8_t>>{ large_first, large_second }));
+    }
+}
+
+TEST(ChunkReassemblerTest, PartialChunkHeaderWaitsForMoreData)
+{
+    auto frame = make_frame(1, 64);
+    auto chunk = make_chunk(5, DaneJoe::ChunkFlag::Last, frame);
+    DaneJoe::ChunkReassembler reassembler;
+    std::size_t split = DaneJoe::ChunkHeader::min_serialized_byte_array_size() - 1;
+    auto output = reassembler.push_data(std::vector<uint8_t>(chunk.begin(), chunk.begin() + split));
+    ASSERT_TRUE(output.has_value());
+    EXPECT_TRUE(output->empty());
+    EXPECT_TRUE(reassembler.has_pending_data());
+
+    output = reassembler.push_data(std::vector<uint8_t>(chunk.begin() + split, chunk.end()));
+    ASSERT_TRUE(output.has_value());
+    EXPECT_EQ(output.value(), frame);
+    EXPECT_FALSE(reassembler.has_pending_data());
+}
+
+TEST(ChunkReassemblerTest, RejectsTooManyStreams)
+{
+    DaneJoe::ChunkReassemblerConfig config;
+    config.max_stream_count = 2;
+    DaneJoe::ChunkReassembler reassembler(config);
+    const std::vector<uint8_t> payload(16, 0x11);
+    ASSERT_TRUE(reassembler.push_data(make_chunk(1, DaneJoe::ChunkFlag::None, payload)).has_value());
+    ASSERT_TRUE(reassembler.push_data(make_chunk(2, DaneJoe::ChunkFlag::None, payload)).has_value());
+    // 已有流可以继续追加
+    ASSERT_TRUE(reassembler.push_data(make_chunk(1, DaneJoe::ChunkFlag::None, payload)).has_value());
+    EXPECT_FALSE(reassembler.push_data(make_chunk(3, DaneJoe::ChunkFlag::None, payload)).has_value());
+    EXPECT_FALSE(reassembler.has_pending_data());
+}
+
+TEST(ChunkReassemblerTest, RejectsOversizedStream)
+{
+    DaneJoe::ChunkReassemblerConfig config;
+    config.max_frame_size = 100;
+    DaneJoe::ChunkReassembler reassembler(config);
+    const std::vector<uint8_t> payload(60, 0x22);
+    ASSERT_TRUE(reassembler.push_data(make_chunk(1, DaneJoe::ChunkFlag::None, payload)).has_value());
+    EXPECT_FALSE(reassembler.push_data(make_chunk(1, DaneJoe::ChunkFlag::None, payload)).has_value());
+}
+
+TEST(ChunkReassemblerTest, RejectsOversizedPayloadBeforeBuffering)
+{
+    DaneJoe::ChunkHeader header;
+    header.stream_id = 1;
+    header.payload_length = UINT32_MAX;
+    // 只收到分片头即可判定超限，无需等待声明的负载
+    DaneJoe::FrameAssembler assembler;
+    EXPECT_FALSE(assembler.push_data(header.to_serialized_byte_array()));
+}
+
+TEST(ChunkReassemblerTest, RejectsOversizedPlainFrame)
+{
+    auto frame = make_frame(1, 200);
+    DaneJoe::ChunkReassemblerConfig config;
+    config.max_frame_size = 100;
+    DaneJoe::ChunkReassembler reassembler(config);
+    EXPECT_FALSE(reassembler.push_data(std::vector<uint8_t>(frame.begin(), frame.begin() + DaneJoe::SerializeCodec::get_message_header_size())).has_value());
+}
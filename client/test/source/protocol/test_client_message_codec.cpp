@@ -0,0 +1,318 @@
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <optional>
+
+#include <danejoe/network/codec/serialize_codec.hpp>
+
+#include "protocol/client_message_codec.hpp"
+#include "protocol/message_field_tag.hpp"
+
+namespace
+{
+    DaneJoe::SerializeConfig make_config(DaneJoe::SerializeVersion version)
+    {
+        DaneJoe::SerializeConfig config;
+        config.version = version;
+        config.field_tag_table = get_message_field_tag_table();
+        return config;
+    }
+
+    std::optional<uint8_t> get_header_version(const std::vector<uint8_t>& data)
+    {
+        DaneJoe::SerializeCodec codec;
+        auto header_opt = codec.get_message_header(data);
+        if (!header_opt.has_value())
+        {
+            return std::nullopt;
+        }
+        return header_opt->version;
+    }
+
+    /**
+     * @brief 按服务端的方式构建响应帧
+     * @param version 编码版本
+     * @param envelope_version 响应信封版本
+     * @param body 消息体
+     */
+    std::vector<uint8_t> build_response(DaneJoe::SerializeVersion version, uint16_t envelope_version, const std::vector<uint8_t>& body)
+    {
+        DaneJoe::SerializeCodec codec(make_config(version));
+        codec.serialize(envelope_version, "version");
+        codec.serialize(static_cast<uint64_t>(9), "request_id");
+        codec.serialize(static_cast<uint16_t>(ResponseStatus::Ok), "status");
+        codec.serialize(static_cast<uint8_t>(ContentType::DaneJoe), "content_type");
+        codec.serialize(body, "body");
+        return codec.take_serialized_data_vector_build();
+    }
+
+    /**
+     * @brief 解析请求帧并返回其消息体解析器
+     * @param frame 请求帧
+     * @param path 期望的请求路径
+     */
+    DaneJoe::SerializeCodec parse_request_body(const std::vector<uint8_t>& frame, const std::string& path)
+    {
+        DaneJoe::SerializeCodec envelope(make_config(DaneJoe::SerializeVersion::Named));
+        envelope.deserialize(frame);
+        auto path_field = envelope.get_parsed_field("path");
+        EXPECT_TRUE(path_field.has_value());
+        if (path_field.has_value())
+        {
+            EXPECT_EQ(DaneJoe::to_string(path_field.value()), path);
+        }
+        auto request_id_field = envelope.get_parsed_field("request_id");
+        EXPECT_TRUE(request_id_field.has_value());
+        if (request_id_field.has_value())
+        {
+            EXPECT_EQ(DaneJoe::to_value<uint64_t>(request_id_field.value()).value_or(0), 9u);
+        }
+        DaneJoe::SerializeCodec body(make_config(DaneJoe::SerializeVersion::Named));
+        // 空消息体（如指标请求）不携带 body 字段
+        auto body_field = envelope.get_parsed_field("body");
+        if (body_field.has_value())
+        {
+            body.deserialize(DaneJoe::to_array<uint8_t>(body_field.value()));
+        }
+        return body;
+    }
+
+    int64_t get_int64_field(DaneJoe::SerializeCodec& codec, const std::string& name)
+    {
+        auto field = codec.get_parsed_field(name);
+        EXPECT_TRUE(field.has_value()) << name;
+        return field.has_value() ? DaneJoe::to_value<int64_t>(field.value()).value_or(-1) : -1;
+    }
+
+    class ClientMessageCodecRoundTripTest : public ::testing::TestWithParam<DaneJoe::SerializeVersion>
+    {};
+}
+
+TEST(ClientMessageCodecTest, DefaultBuildUsesNamedEncoding)
+{
+    ClientMessageCodec codec;
+    TestRequestTransfer request;
+    request.message = "ping";
+    auto frame = codec.build_test_request_byte_array(request, 1);
+    EXPECT_EQ(get_header_version(frame), static_cast<uint8_t>(DaneJoe::SerializeVersion::Named));
+}
+
+TEST(ClientMessageCodecTest, MixedPeersNegotiateIndependently)
+{
+    ClientMessageCodec codec;
+    const std::vector<uint8_t> body;
+    // 旧服务端：字段名编码、信封版本 1；新服务端：字段名编码、信封版本 2
+    auto old_frame = build_response(DaneJoe::SerializeVersion::Named, 1, body);
+    auto new_frame = build_response(DaneJoe::SerializeVersion::Named, 2, body);
+    auto old_response = codec.try_parse_byte_array_response(old_frame);
+    auto new_response = codec.try_parse_byte_array_response(new_frame);
+    ASSERT_TRUE(old_response.has_value());
+    ASSERT_TRUE(new_response.has_value());
+
+    auto old_version = codec.get_peer_wire_version(old_frame, old_response.value());
+    auto new_version = codec.get_peer_wire_version(new_frame, new_response.value());
+    EXPECT_EQ(old_version, DaneJoe::SerializeVersion::Named);
+    EXPECT_EQ(new_version, DaneJoe::SerializeVersion::Compact);
+
+    // 同一编解码器交替发往两个端点，各自保持协商结果
+    BlockRequestTransfer request;
+    request.block_id = 3;
+    request.file_id = 7;
+    for (int i = 0; i < 2; i++)
+    {
+        auto old_request = codec.build_block_request_byte_array(request, 9, old_version);
+        auto new_request = codec.build_block_request_byte_array(request, 9, new_version);
+        EXPECT_EQ(get_header_version(old_request), static_cast<uint8_t>(DaneJoe::SerializeVersion::Named));
+        EXPECT_EQ(get_header_version(new_request), static_cast<uint8_t>(DaneJoe::SerializeVersion::Compact));
+    }
+    auto default_request = codec.build_block_request_byte_array(request, 9);
+    EXPECT_EQ(get_header_version(default_request), static_cast<uint8_t>(DaneJoe::SerializeVersion::Named));
+
+    // 紧凑编码的响应本身即表明对端支持紧凑编码
+    auto compact_frame = build_response(DaneJoe::SerializeVersion::Compact, 1, body);
+    auto compact_response = codec.try_parse_byte_array_response(compact_frame);
+    ASSERT_TRUE(compact_response.has_value());
+    EXPECT_EQ(codec.get_peer_wire_version(compact_frame, compact_response.value()), DaneJoe::SerializeVersion::Compact);
+}
+
+TEST(ClientMessageCodecTest, PinnedVersionOverridesPeerVersion)
+{
+    ClientMessageCodec codec;
+    codec.set_wire_version(DaneJoe::SerializeVersion::Named);
+    auto frame = codec.build_metrics_request_byte_array(1, DaneJoe::SerializeVersion::Compact);
+    EXPECT_EQ(get_header_version(frame), static_cast<uint8_t>(DaneJoe::SerializeVersion::Named));
+}
+
+TEST_P(ClientMessageCodecRoundTripTest, RequestsRoundTrip)
+{
+    ClientMessageCodec codec;
+    const auto version = GetParam();
+
+    TestRequestTransfer test_request;
+    test_request.message = "ping";
+    auto frame = codec.build_test_request_byte_array(test_request, 9, version);
+    EXPECT_EQ(get_header_version(frame), static_cast<uint8_t>(version));
+    {
+        auto body = parse_request_body(frame, "/test");
+        auto message_field = body.get_parsed_field("message");
+        ASSERT_TRUE(message_field.has_value());
+        EXPECT_EQ(DaneJoe::to_string(message_field.value()), "ping");
+    }
+
+    frame = codec.build_metrics_request_byte_array(9, version);
+    EXPECT_EQ(get_header_version(frame), static_cast<uint8_t>(version));
+    parse_request_body(frame, "/metrics");
+
+    DownloadRequestTransfer download_request;
+    download_request.file_id = 7;
+    download_request.task_id = 3;
+    frame = codec.build_download_request_byte_array(download_request, 9, version);
+    EXPECT_EQ(get_header_version(frame), static_cast<uint8_t>(version));
+    {
+        auto body = parse_request_body(frame, "/download");
+        EXPECT_EQ(get_int64_field(body, "file_id"), 7);
+        EXPECT_EQ(get_int64_field(body, "task_id"), 3);
+    }
+
+    ManifestRequestTransfer manifest_request;
+    manifest_request.file_id = 7;
+    manifest_request.task_id = 3;
+    frame = codec.build_manifest_request_byte_array(manifest_request, 9, version);
+    EXPECT_EQ(get_header_version(frame), static_cast<uint8_t>(version));
+    {
+        auto body = parse_request_body(frame, "/manifest");
+        EXPECT_EQ(get_int64_field(body, "file_id"), 7);
+        EXPECT_EQ(get_int64_field(body, "task_id"), 3);
+    }
+
+    DeltaRequestTransfer delta_request;
+    delta_request.file_id = 7;
+    delta_request.task_id = 3;
+    delta_request.signature = { 1, 2, 3, 4 };
+    frame = codec.build_delta_request_byte_array(delta_request, 9, version);
+    EXPECT_EQ(get_header_version(frame), static_cast<uint8_t>(version));
+    {
+        auto body = parse_request_body(frame, "/delta");
+        EXPECT_EQ(get_int64_field(body, "file_id"), 7);
+        auto signature_field = body.get_parsed_field("signature");
+        ASSERT_TRUE(signature_field.has_value());
+        EXPECT_EQ(DaneJoe::to_array<uint8_t>(signature_field.value()), delta_request.signature);
+    }
+
+    BlockRequestTransfer block_request;
+    block_request.block_id = 5;
+    block_request.file_id = 7;
+    block_request.task_id = 3;
+    block_request.offset = 5LL * 1024 * 1024;
+    block_request.block_size = 1024 * 1024;
+    frame = codec.build_block_request_byte_array(block_request, 9, version);
+    EXPECT_EQ(get_header_version(frame), static_cast<uint8_t>(version));
+    {
+        auto body = parse_request_body(frame, "/block");
+        EXPECT_EQ(get_int64_field(body, "block_id"), 5);
+        EXPECT_EQ(get_int64_field(body, "file_id"), 7);
+        EXPECT_EQ(get_int64_field(body, "task_id"), 3);
+        EXPECT_EQ(get_int64_field(body, "offset"), block_request.offset);
+        EXPECT_EQ(get_int64_field(body, "block_size"), block_request.block_size);
+    }
+}
+
+TEST_P(ClientMessageCodecRoundTripTest, ResponsesRoundTrip)
+{
+    ClientMessageCodec codec;
+    const auto version = GetParam();
+    auto take_body = [&](DaneJoe::SerializeCodec& body_codec)
+        {
+            auto frame = build_response(version, 2, body_codec.take_serialized_data_vector_build());
+            auto response = codec.try_parse_byte_array_response(frame);
+            EXPECT_TRUE(response.has_value());
+            if (!response.has_value())
+            {
+                return std::vector<uint8_t>();
+            }
+            EXPECT_EQ(response->version, 2);
+            EXPECT_EQ(response->request_id, 9u);
+            EXPECT_EQ(response->status, ResponseStatus::Ok);
+            return response->body;
+        };
+
+    {
+        DaneJoe::SerializeCodec body(make_config(version));
+        body.serialize(std::string("pong"), "message");
+        auto test_response = codec.try_parse_byte_array_test_response(take_body(body));
+        ASSERT_TRUE(test_response.has_value());
+        EXPECT_EQ(test_response->message, "pong");
+    }
+    {
+        DaneJoe::SerializeCodec body(make_config(version));
+        body.serialize(static_cast<int64_t>(3), "task_id");
+        body.serialize(static_cast<int64_t>(7), "file_id");
+        body.serialize(std::string("dataset.bin"), "file_name");
+        body.serialize(static_cast<int64_t>(1LL << 32), "file_size");
+        body.serialize(std::string("0123456789abcdef"), "md5_code");
+        auto download_response = codec.try_parse_byte_array_download_response(take_body(body));
+        ASSERT_TRUE(download_response.has_value());
+        EXPECT_EQ(download_response->task_id, 3);
+        EXPECT_EQ(download_response->file_id, 7);
+        EXPECT_EQ(download_response->file_name, "dataset.bin");
+        EXPECT_EQ(download_response->file_size, 1LL << 32);
+        EXPECT_EQ(download_response->md5_code, "0123456789abcdef");
+    }
+    {
+        const std::vector<uint8_t> chunk_hashes(64, 0x3c);
+        DaneJoe::SerializeCodec body(make_config(version));
+        body.serialize(static_cast<int64_t>(3), "task_id");
+        body.serialize(static_cast<int64_t>(7), "file_id");
+        body.serialize(static_cast<int64_t>(4096), "file_size");
+        body.serialize(static_cast<int64_t>(2048), "chunk_size");
+        body.serialize(chunk_hashes, "chunk_hashes");
+        auto manifest_response = codec.try_parse_byte_array_manifest_response(take_body(body));
+        ASSERT_TRUE(manifest_response.has_value());
+        EXPECT_EQ(manifest_response->task_id, 3);
+        EXPECT_EQ(manifest_response->file_id, 7);
+        EXPECT_EQ(manifest_response->file_size, 4096);
+        EXPECT_EQ(manifest_response->chunk_size, 2048);
+        EXPECT_EQ(manifest_response->chunk_hashes, chunk_hashes);
+    }
+    {
+        const std::vector<uint8_t> delta = { 9, 8, 7, 6, 5 };
+        DaneJoe::SerializeCodec body(make_config(version));
+        body.serialize(static_cast<int64_t>(3), "task_id");
+        body.serialize(static_cast<int64_t>(7), "file_id");
+        body.serialize(static_cast<int64_t>(4096), "file_size");
+        body.serialize(std::string("0123456789abcdef"), "md5_code");
+        body.serialize(delta, "delta");
+        auto delta_response = codec.try_parse_byte_array_delta_response(take_body(body));
+        ASSERT_TRUE(delta_response.has_value());
+        EXPECT_EQ(delta_response->task_id, 3);
+        EXPECT_EQ(delta_response->file_id, 7);
+        EXPECT_EQ(delta_response->file_size, 4096);
+        EXPECT_EQ(delta_response->md5_code, "0123456789abcdef");
+        EXPECT_EQ(delta_response->delta, delta);
+    }
+    {
+        const std::vector<uint8_t> data(4096, 0x5a);
+        DaneJoe::SerializeCodec body(make_config(version));
+        body.serialize(static_cast<int64_t>(5), "block_id");
+        body.serialize(static_cast<int64_t>(7), "file_id");
+        body.serialize(static_cast<int64_t>(3), "task_id");
+        body.serialize(static_cast<int64_t>(5 * 4096), "offset");
+        body.serialize(static_cast<int64_t>(data.size()), "block_size");
+        body.serialize(data, "data");
+        auto block_response = codec.try_parse_byte_array_block_response(take_body(body));
+        ASSERT_TRUE(block_response.has_value());
+        EXPECT_EQ(block_response->block_id, 5);
+        EXPECT_EQ(block_response->file_id, 7);
+        EXPECT_EQ(block_response->task_id, 3);
+        EXPECT_EQ(block_response->offset, 5 * 4096);
+        EXPECT_EQ(block_response->block_size, static_cast<int64_t>(data.size()));
+        EXPECT_EQ(block_response->data, data);
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    WireVersion,
+    ClientMessageCodecRoundTripTest,
+    ::testing::Values(DaneJoe::SerializeVersion::Named, DaneJoe::SerializeVersion::Compact));
@@ -0,0 +1,135 @@
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+#include <danejoe/logger/logger_manager.hpp>
+#include <danejoe/common/system/allocation_counter.hpp>
+#include <danejoe/network/codec/serialize_codec.hpp>
+
+#include "protocol/client_message_codec.hpp"
+#include "protocol/message_field_tag.hpp"
+
+namespace
+{
+    /// @brief 预热构建次数，使复用缓冲区增长到稳态容量
+    constexpr int WARMUP_BUILD_COUNT = 4;
+    /// @brief 计数期间的构建次数
+    constexpr int MEASURE_BUILD_COUNT = 1000;
+
+    DaneJoe::SerializeConfig make_config(DaneJoe::SerializeVersion version)
+    {
+        DaneJoe::SerializeConfig config;
+        config.version = version;
+        config.field_tag_table = get_message_field_tag_table();
+        return config;
+    }
+
+    void build_block_response(DaneJoe::SerializeCodec& codec, const std::vector<uint8_t>& data)
+    {
+        codec.serialize(static_cast<int64_t>(42), "block_id");
+        codec.serialize(static_cast<int64_t>(7), "file_id");
+        codec.serialize(static_cast<int64_t>(3), "task_id");
+        codec.serialize(static_cast<int64_t>(42LL * 1024 * 1024), "offset");
+        codec.serialize(static_cast<int64_t>(data.size()), "block_size");
+        codec.serialize(std::string("dataset.bin"), "file_name");
+        codec.serialize(data, "data");
+    }
+
+    BlockRequestTransfer make_block_request(int64_t block_id)
+    {
+        BlockRequestTransfer block_request;
+        block_request.block_id = block_id;
+        block_request.file_id = 7;
+        block_request.task_id = 3;
+        block_request.offset = block_id * 1024 * 1024;
+        block_request.block_size = 1024 * 1024;
+        return block_request;
+    }
+
+    class MessageCodecAllocationTest : public ::testing::TestWithParam<DaneJoe::SerializeVersion>
+    {
+    public:
+        /**
+         * @brief 按生产环境的日志级别运行
+         * @details 构建路径上的 TRACE/DEBUG 日志会格式化字符串，默认级别下计入分配次数。
+         */
+        static void SetUpTestSuite()
+        {
+            DaneJoe::LoggerConfig config;
+            config.console_level = DaneJoe::LogLevel::WARN;
+            config.enable_file = false;
+            auto logger = DaneJoe::LoggerManager::get_instance().get_logger("default");
+            if (logger)
+            {
+                logger->set_config(config);
+            }
+        }
+    };
+}
+
+TEST_P(MessageCodecAllocationTest, SerializeCodecSteadyStateBuildDoesNotAllocate)
+{
+    const std::vector<uint8_t> data(64 * 1024, 0x5a);
+    DaneJoe::SerializeCodec codec(make_config(GetParam()));
+    std::vector<uint8_t> buffer;
+    for (int i = 0; i < WARMUP_BUILD_COUNT; i++)
+    {
+        codec.reset_build(std::move(buffer));
+        build_block_response(codec, data);
+        buffer = codec.take_serialized_data_vector_build();
+    }
+
+    uint64_t allocation_count = DaneJoe::get_allocation_count();
+    for (int i = 0; i < MEASURE_BUILD_COUNT; i++)
+    {
+        codec.reset_build(std::move(buffer));
+        build_block_response(codec, data);
+        buffer = codec.take_serialized_data_vector_build();
+    }
+    EXPECT_EQ(DaneJoe::get_allocation_count() - allocation_count, 0u);
+
+    DaneJoe::SerializeCodec parser(make_config(GetParam()));
+    parser.deserialize(buffer);
+    auto data_field = parser.get_parsed_field("data");
+    ASSERT_TRUE(data_field.has_value());
+    EXPECT_EQ(DaneJoe::to_array<uint8_t>(data_field.value()), data);
+}
+
+TEST_P(MessageCodecAllocationTest, BlockRequestSteadyStateBuildDoesNotAllocate)
+{
+    ClientMessageCodec message_codec;
+    for (int i = 0; i < WARMUP_BUILD_COUNT; i++)
+    {
+        message_codec.recycle_frame_byte_array(message_codec.build_block_request_byte_array(make_block_request(i), i, GetParam()));
+    }
+
+    uint64_t allocation_count = DaneJoe::get_allocation_count();
+    for (int i = 0; i < MEASURE_BUILD_COUNT; i++)
+    {
+        auto frame = message_codec.build_block_request_byte_array(make_block_request(i), i, GetParam());
+        message_codec.recycle_frame_byte_array(std::move(frame));
+    }
+    EXPECT_EQ(DaneJoe::get_allocation_count() - allocation_count, 0u);
+
+    // 复用缓冲区构建的请求仍可被完整解析
+    auto frame = message_codec.build_block_request_byte_array(make_block_request(5), 99, GetParam());
+    DaneJoe::SerializeCodec envelope(make_config(GetParam()));
+    envelope.deserialize(frame);
+    auto request_id_field = envelope.get_parsed_field("request_id");
+    ASSERT_TRUE(request_id_field.has_value());
+    EXPECT_EQ(DaneJoe::to_value<uint64_t>(request_id_field.value()).value_or(0), 99u);
+    auto body_field = envelope.get_parsed_field("body");
+    ASSERT_TRUE(body_field.has_value());
+    DaneJoe::SerializeCodec body(make_config(GetParam()));
+    body.deserialize(DaneJoe::to_array<uint8_t>(body_field.value()));
+    auto block_id_field = body.get_parsed_field("block_id");
+    ASSERT_TRUE(block_id_field.has_value());
+    EXPECT_EQ(DaneJoe::to_value<int64_t>(block_id_field.value()).value_or(0), 5);
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    WireVersion,
+    MessageCodecAllocationTest,
+    ::testing::Values(DaneJoe::SerializeVersion::Named, DaneJoe::SerializeVersion::Compact));
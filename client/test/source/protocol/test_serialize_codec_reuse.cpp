@@ -0,0 +1,48 @@
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include <danejoe/network/codec/serialize_codec.hpp>
+
+#include "protocol/message_field_tag.hpp"
+
+namespace
+{
+    DaneJoe::SerializeConfig make_config(DaneJoe::SerializeVersion version)
+    {
+        DaneJoe::SerializeConfig config;
+        config.version = version;
+        config.field_tag_table = get_message_field_tag_table();
+        return config;
+    }
+
+    class SerializeCodecReuseTest : public ::testing::TestWithParam<DaneJoe::SerializeVersion>
+    {};
+}
+
+TEST_P(SerializeCodecReuseTest, TakeLeavesCodecReadyForNextBuild)
+{
+    DaneJoe::SerializeCodec codec(make_config(GetParam()));
+    codec.serialize(static_cast<int64_t>(1), "block_id");
+    auto first = codec.take_serialized_data_vector_build();
+    codec.serialize(static_cast<int64_t>(2), "block_id");
+    auto second = codec.take_serialized_data_vector_build();
+
+    auto first_header = codec.get_message_header(first);
+    auto second_header = codec.get_message_header(second);
+    ASSERT_TRUE(first_header.has_value());
+    ASSERT_TRUE(second_header.has_value());
+    EXPECT_EQ(first_header->field_count, 1);
+    EXPECT_EQ(second_header->field_count, 1);
+
+    DaneJoe::SerializeCodec parser(make_config(GetParam()));
+    parser.deserialize(second);
+    auto block_id_field = parser.get_parsed_field("block_id");
+    ASSERT_TRUE(block_id_field.has_value());
+    EXPECT_EQ(DaneJoe::to_value<int64_t>(block_id_field.value()).value_or(0), 2);
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    WireVersion,
+    SerializeCodecReuseTest,
+    ::testing::Values(DaneJoe::SerializeVersion::Named, DaneJoe::SerializeVersion::Compact));
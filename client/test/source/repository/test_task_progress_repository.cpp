@@ -0,0 +1,93 @@
+#include <gtest/gtest.h>
+
+#include <filesystem>
+
+#include <danejoe/database/sql_database_manager.hpp>
+#include <danejoe/database/sqlite_driver.hpp>
+
+#include "repository/task_progress_repository.hpp"
+
+namespace
+{
+    class TaskProgressRepositoryTest : public ::testing::Test
+    {
+    protected:
+        void SetUp() override
+        {
+            auto& database_manager = DaneJoe::SqlDatabaseManager::get_instance();
+            if (!database_manager.get_database("client_database"))
+            {
+                database_manager.add_database("client_database", std::make_shared<DaneJoe::SqliteDriver>());
+            }
+
+            auto db = database_manager.get_database("client_database");
+            ASSERT_TRUE(db);
+            if (auto driver = db->get_driver())
+            {
+                driver->close();
+            }
+
+            auto db_path = std::filesystem::temp_directory_path() / "task_progress_repository_test.db";
+            std::error_code ec;
+            std::filesystem::remove(db_path, ec);
+
+            DaneJoe::SqlConfig config;
+            config.database_name = "client_database";
+            config.path = db_path.string();
+            db->set_config(config);
+            ASSERT_TRUE(db->connect());
+
+            m_repo.init();
+            ASSERT_TRUE(m_repo.ensure_table_exists());
+        }
+
+        TaskProgressRepository m_repo;
+    };
+}
+
+TEST_F(TaskProgressRepositoryTest, SaveMergesRangesAndRoundTrips)
+{
+    EXPECT_FALSE(m_repo.get_by_task_id(1).has_value());
+
+    TaskProgressEntity progress;
+    progress.task_id = 1;
+    progress.add_completed(0, 100);
+    progress.add_completed(200, 50);
+    progress.add_completed(100, 100);
+    progress.add_completed(400, 10);
+    progress.digest_state = { 1, 2, 3 };
+    ASSERT_TRUE(m_repo.save(progress));
+
+    auto loaded = m_repo.get_by_task_id(1);
+    ASSERT_TRUE(loaded.has_value());
+    EXPECT_EQ(loaded->get_completed_bytes(), 260);
+    EXPECT_EQ(loaded->completed_ranges.get_intervals().size(), 2u);
+    EXPECT_EQ(loaded->digest_state, progress.digest_state);
+
+    auto missing = loaded->get_missing_ranges(500);
+    ASSERT_EQ(missing.size(), 2u);
+    EXPECT_EQ(missing[0].first, 250);
+    EXPECT_EQ(missing[0].second, 400);
+    EXPECT_EQ(missing[1].first, 410);
+    EXPECT_EQ(missing[1].second, 500);
+
+    TaskProgressEntity removed = *loaded;
+    removed.remove_completed(50, 20);
+    EXPECT_EQ(removed.get_completed_bytes(), 240);
+    auto completed = removed.get_completed_ranges();
+    ASSERT_EQ(completed.size(), 3u);
+    EXPECT_EQ(completed[0].second, 50);
+    EXPECT_EQ(completed[1].first, 70);
+    EXPECT_EQ(completed[1].second, 250);
+
+    loaded->add_completed(250, 150);
+    loaded->digest_state.clear();
+    ASSERT_TRUE(m_repo.save(*loaded));
+    auto reloaded = m_repo.get_by_task_id(1);
+    ASSERT_TRUE(reloaded.has_value());
+    EXPECT_EQ(reloaded->get_missing_ranges(500).size(), 1u);
+    EXPECT_TRUE(reloaded->digest_state.empty());
+
+    ASSERT_TRUE(m_repo.remove(1));
+    EXPECT_FALSE(m_repo.get_by_task_id(1).has_value());
+}
@@ -0,0 +1,67 @@
+#include <gtest/gtest.h>
+
+#include <vector>
+#include <cstdint>
+
+#include "service/trans_correlation_table.hpp"
+
+namespace
+{
+    TransCorrelation make_correlation(uint64_t request_id, int* call_count)
+    {
+        TransCorrelation correlation;
+        correlation.context.request_id = request_id;
+        correlation.context.endpoint = NetworkEndpoint{ "127.0.0.1", 8080 };
+        correlation.credit_bytes = static_cast<int64_t>(request_id);
+        correlation.callback = [call_count](const TransContext&, std::vector<uint8_t>)
+            {
+                (*call_count)++;
+            };
+        return correlation;
+    }
+}
+
+TEST(TransCorrelationTableTest, InsertTakeRoundTrip)
+{
+    TransCorrelationTable table(64);
+    int call_count = 0;
+    for (uint64_t id = 0; id < 32; id++)
+    {
+        table.insert(make_correlation(id, &call_count));
+    }
+    EXPECT_EQ(table.size(), 32u);
+
+    auto correlation = table.take(7);
+    ASSERT_TRUE(correlation.has_value());
+    EXPECT_EQ(correlation->context.request_id, 7u);
+    EXPECT_EQ(correlation->credit_bytes, 7);
+    correlation->callback(correlation->context, {});
+    EXPECT_EQ(call_count, 1);
+
+    EXPECT_FALSE(table.take(7).has_value());
+    EXPECT_FALSE(table.take(1000).has_value());
+    EXPECT_EQ(table.size(), 31u);
+}
+
+TEST(TransCorrelationTableTest, SlotCollisionFallsBackToOverflow)
+{
+    TransCorrelationTable table(16);
+    int call_count = 0;
+    // 0、16、32 落在同一槽位
+    table.insert(make_correlation(0, &call_count));
+    table.insert(make_correlation(16, &call_count));
+    table.insert(make_correlation(32, &call_count));
+    EXPECT_TRUE(table.set_timeout_handle(16, DaneJoe::TimerHandle{ 3, 1 }));
+
+    auto correlation = table.take(16);
+    ASSERT_TRUE(correlation.has_value());
+    EXPECT_EQ(correlation->timeout_handle.index, 3u);
+    ASSERT_TRUE(table.take(0).has_value());
+    ASSERT_TRUE(table.take(32).has_value());
+    EXPECT_EQ(table.size(), 0u);
+
+    // 槽位释放后重新使用
+    table.insert(make_correlation(48, &call_count));
+    EXPECT_TRUE(table.take(48).has_value());
+    EXPECT_FALSE(table.set_timeout_handle(48, DaneJoe::TimerHandle{}));
+}
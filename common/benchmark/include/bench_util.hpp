@@ -0,0 +1,71 @@
+/**
+ * @file bench_util.hpp
+ * @author DaneJoe (danejoe001.github)
+ * @brief 基准测试工具
+ * @version 0.2.0
+ * @date 2026-01-06
+ * @details 提供基准测试可执行文件共用的计时、防优化与日志静默工具。
+ */
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+
+#include "danejoe/logger/logger_manager.hpp"
+#include "danejoe/logger/logger_config.hpp"
+
+/**
+ * @namespace DaneJoe::Bench
+ * @brief 基准测试工具命名空间
+ */
+namespace DaneJoe::Bench
+{
+    /**
+     * @brief 防止编译器优化掉基准测试中的结果
+     * @tparam T 值类型
+     * @param value 需要保留的值
+     */
+    template<class T>
+    inline void do_not_optimize(const T& value)
+    {
+        asm volatile("" : : "r,m"(value) : "memory");
+    }
+    /**
+     * @brief 测量单次操作的平均耗时
+     * @param iterations 迭代次数
+     * @param operation 被测操作
+     * @return 平均耗时（纳秒）
+     * @details 正式计时前先执行少量预热迭代。
+     */
+    inline double measure_ns_per_op(uint64_t iterations, const std::function<void()>& operation)
+    {
+        uint64_t warmup = iterations / 10 + 1;
+        for (uint64_t i = 0; i < warmup; i++)
+        {
+            operation();
+        }
+        auto start = std::chrono::steady_clock::now();
+        for (uint64_t i = 0; i < iterations; i++)
+        {
+            operation();
+        }
+        auto end = std::chrono::steady_clock::now();
+        return std::chrono::duration<double, std::nano>(end - start).count() / static_cast<double>(iterations);
+    }
+    /**
+     * @brief 静默默认日志器
+     * @details 仅输出错误日志且不写文件，避免日志 IO 干扰计时。
+     */
+    inline void silence_default_logger()
+    {
+        DaneJoe::LoggerConfig config;
+        config.console_level = DaneJoe::LogLevel::ERROR;
+        config.enable_file = false;
+        auto logger = DaneJoe::LoggerManager::get_instance().get_logger("default");
+        if (logger)
+        {
+            logger->set_config(config);
+        }
+    }
+}
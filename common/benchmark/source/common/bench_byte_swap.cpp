@@ -0,0 +1,106 @@
+/**
+ * @file bench_byte_swap.cpp
+ * @author DaneJoe (danejoe001.github)
+ * @brief 批量字节翻转基准测试
+ * @version 0.2.0
+ * @date 2026-01-06
+ * @details 在不同数组长度与元素宽度下，对比逐字节翻转（原实现）与各字节翻转内核的吞吐，
+ *          并校验各内核输出一致。
+ */
+#include <cstdio>
+#include <vector>
+#include <cstdint>
+
+#include "danejoe/common/binary/byte_swap.hpp"
+
+#include "bench_util.hpp"
+
+namespace
+{
+    /**
+     * @brief 逐字节翻转（原 convert_byte_order 实现）
+     */
+    void byte_swap_per_byte(uint8_t* dest, const uint8_t* src, std::size_t element_size, std::size_t count)
+    {
+        for (std::size_t i = 0; i < count; i++)
+        {
+            std::size_t dest_index = i * element_size;
+            const uint8_t* src_ptr = src + dest_index;
+            for (std::size_t j = 0; j < element_size; j++)
+            {
+                dest[dest_index + j] = src_ptr[element_size - j - 1];
+            }
+        }
+    }
+
+    uint64_t get_iterations(std::size_t total_bytes)
+    {
+        // 每个样本约处理 256MB 数据
+        uint64_t iterations = (256ULL * 1024 * 1024) / total_bytes;
+        return iterations == 0 ? 1 : iterations;
+    }
+
+    double to_gib_per_second(std::size_t total_bytes, double ns_per_op)
+    {
+        return static_cast<double>(total_bytes) / ns_per_op * 1e9 / (1024.0 * 1024.0 * 1024.0);
+    }
+}
+
+int main()
+{
+    const std::vector<std::size_t> element_sizes = { 2, 4, 8 };
+    const std::vector<std::size_t> element_counts = { 16, 256, 4096, 65536, 1048576 };
+    const std::vector<DaneJoe::ByteSwapKernel> kernels = {
+        DaneJoe::ByteSwapKernel::Scalar,
+        DaneJoe::ByteSwapKernel::Ssse3,
+        DaneJoe::ByteSwapKernel::Avx2,
+        DaneJoe::ByteSwapKernel::Neon };
+
+    std::printf("dispatch kernel: %s\n", DaneJoe::to_string(DaneJoe::get_byte_swap_kernel()).c_str());
+    std::printf("%-6s %-9s %-24s %14s %12s\n", "width", "count", "kernel", "ns/op", "GiB/s");
+    bool is_all_ok = true;
+    for (std::size_t element_size : element_sizes)
+    {
+        for (std::size_t element_count : element_counts)
+        {
+            std::size_t total_bytes = element_size * element_count;
+            uint64_t iterations = get_iterations(total_bytes);
+            std::vector<uint8_t> src(total_bytes);
+            for (std::size_t i = 0; i < total_bytes; i++)
+            {
+                src[i] = static_cast<uint8_t>(i * 131 + 7);
+            }
+            std::vector<uint8_t> expected(total_bytes);
+            byte_swap_per_byte(expected.data(), src.data(), element_size, element_count);
+            std::vector<uint8_t> dest(total_bytes);
+
+            double per_byte_ns = DaneJoe::Bench::measure_ns_per_op(iterations, [&]()
+                {
+                    byte_swap_per_byte(dest.data(), src.data(), element_size, element_count);
+                    DaneJoe::Bench::do_not_optimize(dest.data());
+                });
+            std::printf("%-6zu %-9zu %-24s %14.1f %12.2f\n", element_size, element_count,
+                "PerByte", per_byte_ns, to_gib_per_second(total_bytes, per_byte_ns));
+
+            for (auto kernel : kernels)
+            {
+                if (!DaneJoe::is_byte_swap_kernel_supported(kernel))
+                {
+                    continue;
+                }
+                DaneJoe::byte_swap_copy(kernel, dest.data(), src.data(), element_size, element_count);
+                bool is_ok = dest == expected;
+                is_all_ok = is_all_ok && is_ok;
+                double kernel_ns = DaneJoe::Bench::measure_ns_per_op(iterations, [&]()
+                    {
+                        DaneJoe::byte_swap_copy(kernel, dest.data(), src.data(), element_size, element_count);
+                        DaneJoe::Bench::do_not_optimize(dest.data());
+                    });
+                std::printf("%-6zu %-9zu %-24s %14.1f %12.2f%s\n", element_size, element_count,
+                    DaneJoe::to_string(kernel).c_str(), kernel_ns,
+                    to_gib_per_second(total_bytes, kernel_ns), is_ok ? "" : "  MISMATCH");
+            }
+        }
+    }
+    return is_all_ok ? 0 : 1;
+}
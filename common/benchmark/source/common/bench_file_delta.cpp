@@ -0,0 +1,172 @@
+/**
+ * @file bench_file_delta.cpp
+ * @author DaneJoe (danejoe001.github)
+ * @brief 文件差量基准测试
+ * @version 0.2.0
+ * @date 2026-01-08
+ * @details 生成随机的基准文件，并按几种典型改动生成新文件：
+ *          - unchanged：内容不变
+ *          - scattered：分散修改 16 处，每处 100 字节
+ *          - insert：中部插入 4 KiB
+ *          - delete_head：删除开头 1 KiB
+ *          - append：末尾追加 1 MiB
+ *          - rewrite_10pct：前 10% 重写
+ *          对每种改动统计签名、差量计算（单线程与多线程）与应用的耗时、字面数据量，并校验重建结果的 MD5。
+ */
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <filesystem>
+
+#include "danejoe/common/delta/file_delta.hpp"
+#include "danejoe/common/hash/md5.hpp"
+
+#include "bench_util.hpp"
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    struct EditCase
+    {
+        const char* name;
+        std::function<std::vector<uint8_t>(const std::vector<uint8_t>&, std::mt19937_64&)> edit;
+    };
+
+    std::vector<uint8_t> make_random_bytes(std::size_t size, std::mt19937_64& engine)
+    {
+        std::vector<uint8_t> bytes(size);
+        for (std::size_t i = 0; i + 8 <= size; i += 8)
+        {
+            uint64_t value = engine();
+            for (std::size_t j = 0; j < 8; j++)
+            {
+                bytes[i + j] = static_cast<uint8_t>(value >> (8 * j));
+            }
+        }
+        return bytes;
+    }
+
+    void write_file(const std::string& path, const std::vector<uint8_t>& bytes)
+    {
+        std::ofstream fout(path, std::ios::out | std::ios::binary | std::ios::trunc);
+        fout.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+    }
+
+    double elapsed_ms(Clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+}
+
+int main()
+{
+    DaneJoe::Bench::silence_default_logger();
+    constexpr std::size_t file_size = 64 * 1024 * 1024;
+    std::mt19937_64 engine(20260108);
+    auto basis = make_random_bytes(file_size, engine);
+    auto directory = std::filesystem::temp_directory_path();
+    std::string basis_path = (directory / "bench_file_delta_basis.bin").string();
+    std::string target_path = (directory / "bench_file_delta_target.bin").string();
+    std::string output_path = (directory / "bench_file_delta_output.bin").string();
+    write_file(basis_path, basis);
+
+    std::vector<EditCase> edit_cases = {
+        { "unchanged", [](const std::vector<uint8_t>& bytes, std::mt19937_64&) { return bytes; } },
+        { "scattered", [](const std::vector<uint8_t>& bytes, std::mt19937_64& engine)
+            {
+                auto edited = bytes;
+                for (int i = 0; i < 16; i++)
+                {
+                    std::size_t offset = engine() % (edited.size() - 100);
+                    for (std::size_t j = 0; j < 100; j++)
+                    {
+                        edited[offset + j] ^= 0xa5;
+                    }
+                }
+                return edited;
+            } },
+        { "insert", [](const std::vector<uint8_t>& bytes, std::mt19937_64& engine)
+            {
+                auto edited = bytes;
+                auto inserted = make_random_bytes(4096, engine);
+                edited.insert(edited.begin() + static_cast<std::ptrdiff_t>(edited.size() / 2), inserted.begin(), inserted.end());
+                return edited;
+            } },
+        { "delete_head", [](const std::vector<uint8_t>& bytes, std::mt19937_64&)
+            {
+                return std::vector<uint8_t>(bytes.begin() + 1024, bytes.end());
+            } },
+        { "append", [](const std::vector<uint8_t>& bytes, std::mt19937_64& engine)
+            {
+                auto edited = bytes;
+                auto appended = make_random_bytes(1024 * 1024, engine);
+                edited.insert(edited.end(), appended.begin(), appended.end());
+                return edited;
+            } },
+        { "rewrite_10pct", [](const std::vector<uint8_t>& bytes, std::mt19937_64& engine)
+            {
+                auto edited = bytes;
+                auto rewritten = make_random_bytes(bytes.size() / 10, engine);
+                std::copy(rewritten.begin(), rewritten.end(), edited.begin());
+                return edited;
+            } },
+    };
+
+    auto start = Clock::now();
+    auto signature_opt = DaneJoe::FileSignature::build_from_file(basis_path);
+    double signature_ms = elapsed_ms(start);
+    if (!signature_opt.has_value())
+    {
+        std::printf("failed to build signature\n");
+        return 1;
+    }
+    const auto& signature = signature_opt.value();
+    std::printf("file %zu MiB, block %lld B, signature %zu B in %.1f ms\n",
+        file_size / (1024 * 1024), static_cast<long long>(signature.block_size),
+        signature.encode().size(), signature_ms);
+    int thread_count = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    std::printf("%-14s %12s %10s %12s %12s %10s %6s\n",
+        "edit", "literal_KiB", "ratio_%", "delta_1t_ms", "delta_nt_ms", "apply_ms", "md5");
+    for (const auto& edit_case : edit_cases)
+    {
+        auto target = edit_case.edit(basis, engine);
+        write_file(target_path, target);
+        DaneJoe::Md5 expected;
+        expected.update(target.data(), target.size());
+
+        start = Clock::now();
+        auto single_delta = DaneJoe::FileDelta::compute(target_path, signature, 1);
+        double single_ms = elapsed_ms(start);
+        start = Clock::now();
+        auto delta = DaneJoe::FileDelta::compute(target_path, signature, thread_count);
+        double multi_ms = elapsed_ms(start);
+        if (!single_delta.has_value() || !delta.has_value())
+        {
+            std::printf("%-14s failed to compute delta\n", edit_case.name);
+            continue;
+        }
+        // 经过编码与解码，与实际传输路径一致
+        auto decoded = DaneJoe::FileDelta::decode(delta->encode());
+        start = Clock::now();
+        auto md5 = decoded.has_value() ? decoded->apply(basis_path, output_path) : std::nullopt;
+        double apply_ms = elapsed_ms(start);
+        bool is_matched = md5.has_value() && md5->get_hex_digest() == expected.get_hex_digest();
+        std::printf("%-14s %12.1f %10.3f %12.1f %12.1f %10.1f %6s\n",
+            edit_case.name,
+            static_cast<double>(delta->get_literal_bytes()) / 1024.0,
+            100.0 * static_cast<double>(delta->get_literal_bytes()) / static_cast<double>(target.size()),
+            single_ms, multi_ms, apply_ms,
+            is_matched ? "ok" : "FAIL");
+    }
+    std::filesystem::remove(basis_path);
+    std::filesystem::remove(target_path);
+    std::filesystem::remove(output_path);
+    return 0;
+}
@@ -0,0 +1,52 @@
+/**
+ * @file bench_timer_manager.cpp
+ * @author DaneJoe (danejoe001.github)
+ * @brief 定时器管理器基准测试
+ * @version 0.2.0
+ * @date 2026-01-09
+ * @details 模拟请求超时的典型用法：每个请求添加一个 600 s 的超时任务，收到响应后取消。
+ *          在不同的在途任务数下测量“添加 + 取消”一对操作的平均耗时，时间轮实现下耗时应与在途任务数无关。
+ */
+#include <chrono>
+#include <cstdio>
+#include <vector>
+#include <cstdint>
+
+#include "danejoe/concurrent/timer/timer_manager.hpp"
+
+#include "bench_util.hpp"
+
+int main()
+{
+    DaneJoe::Bench::silence_default_logger();
+    auto& timer_manager = DaneJoe::TimerManager::get_instance();
+    constexpr uint64_t iterations = 1000000;
+    std::printf("%-12s %16s\n", "outstanding", "add_cancel_ns");
+    for (std::size_t outstanding : { 0, 10000, 100000, 1000000 })
+    {
+        std::vector<DaneJoe::TimerHandle> background_handles;
+        background_handles.reserve(outstanding);
+        for (std::size_t i = 0; i < outstanding; i++)
+        {
+            // 到期时间分散在各层，避免全部落在同一槽位
+            background_handles.push_back(timer_manager.add_task_for(
+                std::chrono::milliseconds(1000 + i * 7 % 3600000), []() {}));
+        }
+        uint64_t request_id = 0;
+        double ns = DaneJoe::Bench::measure_ns_per_op(iterations, [&]()
+            {
+                auto handle = timer_manager.add_task_for(std::chrono::seconds(600), [request_id]()
+                    {
+                        DaneJoe::Bench::do_not_optimize(request_id);
+                    });
+                DaneJoe::Bench::do_not_optimize(timer_manager.cancel(handle));
+                request_id++;
+            });
+        std::printf("%-12zu %16.1f\n", outstanding, ns);
+        for (const auto& handle : background_handles)
+        {
+            timer_manager.cancel(handle);
+        }
+    }
+    return 0;
+}
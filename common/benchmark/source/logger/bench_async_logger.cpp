@@ -0,0 +1,127 @@
+/**
+ * @file bench_async_logger.cpp
+ * @author DaneJoe (danejoe001.github)
+ * @brief 异步日志基准测试
+ * @version 0.2.0
+ * @date 2026-01-12
+ * @details 多个线程同时写一条带整数、字符串与浮点参数的日志，控制台关闭，文件写入临时目录：
+ *          - burst_ns：每次连续写 512 条后暂停 5 ms，只统计写入期间的平均耗时，即调用线程上的开销；
+ *          - sustained_ns：不间断写入时的平均耗时，受后台线程格式化与写文件的吞吐限制；
+ *          - drain_ms：生产者结束后日志器取空缓冲区并写完文件所需的时间。
+ *          同步模式作为对照，迭代次数较少。
+ */
+#include <chrono>
+#include <cstdio>
+#include <thread>
+#include <vector>
+#include <cstdint>
+#include <filesystem>
+
+#include "danejoe/logger/async_logger.hpp"
+
+#include "bench_util.hpp"
+
+namespace fs = std::filesystem;
+
+namespace
+{
+    /// @brief 每次突发写入的条数
+    constexpr uint64_t BURST_SIZE = 512;
+    /// @brief 突发之间的暂停时间
+    constexpr auto BURST_PAUSE = std::chrono::milliseconds(5);
+
+    struct BenchResult
+    {
+        double burst_ns = 0.0;
+        double sustained_ns = 0.0;
+        double drain_ms = 0.0;
+    };
+
+    void write_log(DaneJoe::AsyncLogger& logger, uint64_t i)
+    {
+        logger.info("Bench", __FILE__, __FUNCTION__, __LINE__,
+            "request {} from {} finished in {} ms", i, "127.0.0.1:50000", 0.25);
+    }
+
+    BenchResult run(bool enable_async, std::size_t thread_count, uint64_t iterations, const fs::path& log_path)
+    {
+        fs::remove(log_path);
+        DaneJoe::LoggerConfig config;
+        config.log_name = "bench";
+        config.log_path = log_path.string();
+        config.enable_console = false;
+        config.enable_async = enable_async;
+        auto logger = std::make_unique<DaneJoe::AsyncLogger>(config);
+
+        std::vector<double> burst_ns(thread_count, 0.0);
+        std::vector<double> sustained_ns(thread_count, 0.0);
+        std::vector<std::thread> threads;
+        for (std::size_t t = 0; t < thread_count; t++)
+        {
+            threads.emplace_back([&, t]()
+                {
+                    uint64_t burst_count = 40;
+                    double burst_total_ns = 0.0;
+                    for (uint64_t burst = 0; burst < burst_count; burst++)
+                    {
+                        auto start = std::chrono::steady_clock::now();
+                        for (uint64_t i = 0; i < BURST_SIZE; i++)
+                        {
+                            write_log(*logger, i);
+                        }
+                        auto end = std::chrono::steady_clock::now();
+                        burst_total_ns += std::chrono::duration<double, std::nano>(end - start).count();
+                        std::this_thread::sleep_for(BURST_PAUSE);
+                    }
+                    burst_ns[t] = burst_total_ns / static_cast<double>(burst_count * BURST_SIZE);
+
+                    auto start = std::chrono::steady_clock::now();
+                    for (uint64_t i = 0; i < iterations; i++)
+                    {
+                        write_log(*logger, i);
+                    }
+                    auto end = std::chrono::steady_clock::now();
+                    sustained_ns[t] = std::chrono::duration<double, std::nano>(end - start).count() / static_cast<double>(iterations);
+                });
+        }
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+        auto drain_start = std::chrono::steady_clock::now();
+        logger.reset();
+        auto drain_end = std::chrono::steady_clock::now();
+
+        BenchResult result;
+        for (std::size_t t = 0; t < thread_count; t++)
+        {
+            result.burst_ns += burst_ns[t] / static_cast<double>(thread_count);
+            result.sustained_ns += sustained_ns[t] / static_cast<double>(thread_count);
+        }
+        result.drain_ms = std::chrono::duration<double, std::milli>(drain_end - drain_start).count();
+        return result;
+    }
+}
+
+int main()
+{
+    DaneJoe::Bench::silence_default_logger();
+    fs::path log_path = fs::temp_directory_path() / "projecttrans_bench_async_logger.log";
+    std::printf("%-6s %8s %10s %14s %10s\n", "mode", "threads", "burst_ns", "sustained_ns", "drain_ms");
+    for (std::size_t thread_count : { 1, 2, 4 })
+    {
+        constexpr uint64_t iterations = 1000000;
+        BenchResult result = run(true, thread_count, iterations, log_path);
+        std::printf("%-6s %8zu %10.1f %14.1f %10.1f\n", "async", thread_count,
+            result.burst_ns, result.sustained_ns, result.drain_ms);
+    }
+    for (std::size_t thread_count : { 1, 4 })
+    {
+        constexpr uint64_t iterations = 100000;
+        BenchResult result = run(false, thread_count, iterations, log_path);
+        std::printf("%-6s %8zu %10.1f %14.1f %10.1f\n", "sync", thread_count,
+            result.burst_ns, result.sustained_ns, result.drain_ms);
+    }
+    fs::remove(log_path);
+    return 0;
+}
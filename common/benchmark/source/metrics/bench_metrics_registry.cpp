@@ -0,0 +1,83 @@
+/**
+ * @file bench_metrics_registry.cpp
+ * @author DaneJoe (danejoe001.github)
+ * @brief 运行指标基准测试
+ * @version 0.2.0
+ * @date 2026-01-13
+ * @details 多个线程同时更新同一指标，测量每次更新的平均耗时，
+ *          并与所有线程共享一个原子变量的计数方式对比。
+ */
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+#include <vector>
+#include <cstdint>
+#include <functional>
+
+#include "danejoe/metrics/metrics_registry.hpp"
+
+#include "bench_util.hpp"
+
+namespace
+{
+    /**
+     * @brief 多线程并发执行并测量单次操作的平均耗时
+     * @param thread_count 线程数
+     * @param iterations 每个线程的迭代次数
+     * @param operation 被测操作
+     * @return 平均耗时（纳秒，按墙钟时间与总操作数计算）
+     */
+    double measure_concurrent_ns_per_op(std::size_t thread_count, uint64_t iterations, const std::function<void()>& operation)
+    {
+        std::vector<std::thread> threads;
+        auto start = std::chrono::steady_clock::now();
+        for (std::size_t i = 0; i < thread_count; i++)
+        {
+            threads.emplace_back([&]()
+                {
+                    for (uint64_t j = 0; j < iterations; j++)
+                    {
+                        operation();
+                    }
+                });
+        }
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+        auto end = std::chrono::steady_clock::now();
+        return std::chrono::duration<double, std::nano>(end - start).count() / static_cast<double>(iterations * thread_count);
+    }
+}
+
+int main()
+{
+    DaneJoe::Bench::silence_default_logger();
+    auto& registry = DaneJoe::MetricsRegistry::get_instance();
+    auto& counter = registry.get_counter("bench_counter_total");
+    auto& histogram = registry.get_histogram("bench_latency_ns");
+    std::atomic<uint64_t> shared_counter = 0;
+    constexpr uint64_t iterations = 2000000;
+    std::printf("%-8s %16s %16s %16s\n", "threads", "shared_ns", "counter_ns", "histogram_ns");
+    for (std::size_t thread_count : { 1, 2, 4, 8 })
+    {
+        double shared_ns = measure_concurrent_ns_per_op(thread_count, iterations, [&]()
+            {
+                shared_counter.fetch_add(1, std::memory_order_relaxed);
+            });
+        double counter_ns = measure_concurrent_ns_per_op(thread_count, iterations, [&]()
+            {
+                counter.add();
+            });
+        double histogram_ns = measure_concurrent_ns_per_op(thread_count, iterations / 4, [&]()
+            {
+                thread_local uint64_t value = 0;
+                histogram.record(value++ % 100000);
+            });
+        std::printf("%-8zu %16.1f %16.1f %16.1f\n", thread_count, shared_ns, counter_ns, histogram_ns);
+    }
+    DaneJoe::Bench::do_not_optimize(shared_counter.load());
+    DaneJoe::Bench::do_not_optimize(counter.get_value());
+    return 0;
+}
@@ -0,0 +1,357 @@
+/**
+ * @file bench_block_window.cpp
+ * @author DaneJoe (danejoe001.github)
+ * @brief 块请求窗口吞吐基准测试
+ * @version 0.2.0
+ * @date 2026-01-06
+ * @details 在本地回环连接上模拟块下载：服务端线程按请求返回指定大小的数据，并对每个响应施加固定延迟以模拟链路 RTT。
+ *          客户端分别以三种方式发出块请求并统计吞吐：
+ *          - timer_30ms：每 30ms 补发一批请求，在途上限 16（原调度方式）
+ *          - fixed_16：收到响应即补发，在途上限固定为 16
+ *          - adaptive：收到响应即补发，在途数量由 AdaptiveWindow 按 BDP 估计
+ */
+#include <deque>
+#include <mutex>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <unordered_map>
+#include <condition_variable>
+
+#include <poll.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+
+#include "danejoe/network/flow/adaptive_window.hpp"
+
+#include "bench_util.hpp"
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * @struct BlockMessageHeader
+     * @brief 块请求/响应头
+     */
+    struct BlockMessageHeader
+    {
+        uint64_t block_id = 0;
+        uint32_t block_size = 0;
+        uint32_t reserved = 0;
+    };
+
+    enum class ScheduleMode
+    {
+        Timer30ms,
+        Fixed16,
+        Adaptive
+    };
+
+    const char* to_string(ScheduleMode mode)
+    {
+        switch (mode)
+        {
+        case ScheduleMode::Timer30ms: return "timer_30ms";
+        case ScheduleMode::Fixed16: return "fixed_16";
+        case ScheduleMode::Adaptive: return "adaptive";
+        }
+        return "unknown";
+    }
+
+    bool read_full(int fd, void* data, std::size_t size)
+    {
+        auto ptr = static_cast<uint8_t*>(data);
+        while (size > 0)
+        {
+            ssize_t n = ::read(fd, ptr, size);
+            if (n <= 0)
+            {
+                return false;
+            }
+            ptr += n;
+            size -= static_cast<std::size_t>(n);
+        }
+        return true;
+    }
+
+    bool write_full(int fd, const void* data, std::size_t size)
+    {
+        auto ptr = static_cast<const uint8_t*>(data);
+        while (size > 0)
+        {
+            ssize_t n = ::write(fd, ptr, size);
+            if (n <= 0)
+            {
+                return false;
+            }
+            ptr += n;
+            size -= static_cast<std::size_t>(n);
+        }
+        return true;
+    }
+
+    void set_no_delay(int fd)
+    {
+        int flag = 1;
+        ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &flag, sizeof(flag));
+    }
+
+    /**
+     * @class LoopbackBlockServer
+     * @brief 回环块服务端
+     * @details 读线程接收请求并记录到期时间，写线程到期后返回数据，从而模拟固定 RTT 的流水线链路。
+     */
+    class LoopbackBlockServer
+    {
+    public:
+        LoopbackBlockServer(std::chrono::microseconds delay, uint32_t max_block_size) :
+            m_delay(delay), m_payload(max_block_size, 0x5a)
+        {
+            m_listen_fd = ::socket(AF_INET, SOCK_STREAM, 0);
+            int flag = 1;
+            ::setsockopt(m_listen_fd, SOL_SOCKET, SO_REUSEADDR, &flag, sizeof(flag));
+            sockaddr_in addr{};
+            addr.sin_family = AF_INET;
+            addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+            addr.sin_port = 0;
+            ::bind(m_listen_fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+            ::listen(m_listen_fd, 1);
+            socklen_t length = sizeof(addr);
+            ::getsockname(m_listen_fd, reinterpret_cast<sockaddr*>(&addr), &length);
+            m_port = ntohs(addr.sin_port);
+            m_accept_thread = std::thread([this]() { serve(); });
+        }
+        ~LoopbackBlockServer()
+        {
+            if (m_accept_thread.joinable())
+            {
+                m_accept_thread.join();
+            }
+            ::close(m_listen_fd);
+        }
+        uint16_t get_port()const
+        {
+            return m_port;
+        }
+    private:
+        struct DueResponse
+        {
+            Clock::time_point due;
+            BlockMessageHeader header;
+        };
+        void serve()
+        {
+            int fd = ::accept(m_listen_fd, nullptr, nullptr);
+            if (fd < 0)
+            {
+                return;
+            }
+            set_no_delay(fd);
+            std::thread writer([this, fd]() { write_responses(fd); });
+            BlockMessageHeader header;
+            while (read_full(fd, &header, sizeof(header)) && header.block_size > 0)
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_due_responses.push_back(DueResponse{ Clock::now() + m_delay, header });
+                m_condition.notify_one();
+            }
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_is_stopped = true;
+                m_condition.notify_one();
+            }
+            writer.join();
+            ::close(fd);
+        }
+        void write_responses(int fd)
+        {
+            while (true)
+            {
+                DueResponse response;
+                {
+                    std::unique_lock<std::mutex> lock(m_mutex);
+                    m_condition.wait(lock, [this]() { return m_is_stopped || !m_due_responses.empty(); });
+                    if (m_due_responses.empty())
+                    {
+                        return;
+                    }
+                    response = m_due_responses.front();
+                    m_due_responses.pop_front();
+                }
+                std::this_thread::sleep_until(response.due);
+                if (!write_full(fd, &response.header, sizeof(response.header)) ||
+                    !write_full(fd, m_payload.data(), response.header.block_size))
+                {
+                    return;
+                }
+            }
+        }
+    private:
+        std::chrono::microseconds m_delay;
+        std::vector<uint8_t> m_payload;
+        int m_listen_fd = -1;
+        uint16_t m_port = 0;
+        std::thread m_accept_thread;
+        std::mutex m_mutex;
+        std::condition_variable m_condition;
+        std::deque<DueResponse> m_due_responses;
+        bool m_is_stopped = false;
+    };
+
+    struct RunResult
+    {
+        double mb_per_second = 0.0;
+        int64_t final_window = 0;
+    };
+
+    RunResult run_download(ScheduleMode mode, std::chrono::microseconds delay, uint32_t block_size, uint64_t block_count)
+    {
+        LoopbackBlockServer server(delay, block_size);
+        int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        addr.sin_port = htons(server.get_port());
+        if (::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0)
+        {
+            ::close(fd);
+            return {};
+        }
+        set_no_delay(fd);
+
+        const int64_t fixed_window = 16;
+        DaneJoe::AdaptiveWindow window;
+        std::unordered_map<uint64_t, Clock::time_point> in_flight;
+        std::vector<uint8_t> buffer(block_size);
+        uint64_t next_block = 0;
+        uint64_t received = 0;
+        auto start = Clock::now();
+        auto next_tick = start;
+
+        auto send_block = [&]()
+            {
+                BlockMessageHeader header{ next_block, block_size, 0 };
+                write_full(fd, &header, sizeof(header));
+                in_flight[next_block] = Clock::now();
+                next_block++;
+                if (mode == ScheduleMode::Adaptive)
+                {
+                    window.on_sent();
+                }
+            };
+
+        while (received < block_count)
+        {
+            int timeout_ms = -1;
+            switch (mode)
+            {
+            case ScheduleMode::Timer30ms:
+            {
+                auto now = Clock::now();
+                if (now >= next_tick)
+                {
+                    while (next_block < block_count && static_cast<int64_t>(in_flight.size()) < fixed_window)
+                    {
+                        send_block();
+                    }
+                    next_tick += std::chrono::milliseconds(30);
+                }
+                timeout_ms = static_cast<int>(std::chrono::ceil<std::chrono::milliseconds>(next_tick - Clock::now()).count());
+                timeout_ms = std::max(timeout_ms, 0);
+                break;
+            }
+            case ScheduleMode::Fixed16:
+                while (next_block < block_count && static_cast<int64_t>(in_flight.size()) < fixed_window)
+                {
+                    send_block();
+                }
+                break;
+            case ScheduleMode::Adaptive:
+                while (next_block < block_count && window.can_send())
+                {
+                    send_block();
+                }
+                break;
+            }
+            if (in_flight.empty())
+            {
+                continue;
+            }
+            pollfd poll_fd{ fd, POLLIN, 0 };
+            if (::poll(&poll_fd, 1, timeout_ms) <= 0)
+            {
+                continue;
+            }
+            BlockMessageHeader header;
+            if (!read_full(fd, &header, sizeof(header)) || !read_full(fd, buffer.data(), header.block_size))
+            {
+                break;
+            }
+            auto it = in_flight.find(header.block_id);
+            if (it != in_flight.end())
+            {
+                if (mode == ScheduleMode::Adaptive)
+                {
+                    window.on_acked(Clock::now() - it->second, header.block_size);
+                }
+                in_flight.erase(it);
+            }
+            received++;
+        }
+        auto elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+        BlockMessageHeader stop{};
+        write_full(fd, &stop, sizeof(stop));
+        ::shutdown(fd, SHUT_WR);
+        // 排空剩余数据，等待服务端关闭
+        while (::read(fd, buffer.data(), buffer.size()) > 0)
+        {
+        }
+        ::close(fd);
+
+        RunResult result;
+        result.mb_per_second = static_cast<double>(received) * block_size / elapsed / (1024.0 * 1024.0);
+        result.final_window = mode == ScheduleMode::Adaptive ? window.get_window() : fixed_window;
+        return result;
+    }
+}
+
+int main()
+{
+    DaneJoe::Bench::silence_default_logger();
+    const std::vector<uint32_t> block_sizes = { 64 * 1024, 1024 * 1024 };
+    const std::vector<std::chrono::microseconds> delays = {
+        std::chrono::microseconds(1000),
+        std::chrono::microseconds(5000) };
+    const std::vector<ScheduleMode> modes = {
+        ScheduleMode::Timer30ms,
+        ScheduleMode::Fixed16,
+        ScheduleMode::Adaptive };
+    // 每个样本传输约 128MB
+    const uint64_t total_bytes = 128ULL * 1024 * 1024;
+
+    std::printf("%-10s %-9s %-12s %12s %8s\n", "block", "rtt_ms", "mode", "MB/s", "window");
+    for (auto block_size : block_sizes)
+    {
+        for (auto delay : delays)
+        {
+            for (auto mode : modes)
+            {
+                auto result = run_download(mode, delay, block_size, total_bytes / block_size);
+                std::printf("%-10u %-9.1f %-12s %12.1f %8lld\n",
+                    block_size,
+                    static_cast<double>(delay.count()) / 1000.0,
+                    to_string(mode),
+                    result.mb_per_second,
+                    static_cast<long long>(result.final_window));
+            }
+        }
+    }
+    return 0;
+}
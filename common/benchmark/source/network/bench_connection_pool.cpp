@@ -0,0 +1,434 @@
+/**
+ * @file bench_connection_pool.cpp
+ * @author DaneJoe (danejoe001.github)
+ * @brief 连接池吞吐基准测试
+ * @version 0.2.0
+ * @date 2026-01-06
+ * @details 在本地回环上搭建“源服务端 ← 延迟代理 ← 客户端”的链路：
+ *          - 源服务端按请求返回指定大小的数据
+ *          - 延迟代理对每个方向施加单向时延，并限制每条连接在途字节，模拟高时延链路上单条 TCP 流受窗口限制
+ *          - 客户端以不同连接池大小发出流水线块请求，按 LeastOutstandingBalancer 选择连接并统计吞吐
+ */
+#include <deque>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <cstdint>
+#include <condition_variable>
+
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+
+#include "danejoe/network/flow/least_outstanding_balancer.hpp"
+
+#include "bench_util.hpp"
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * @struct BlockMessageHeader
+     * @brief 块请求/响应头
+     */
+    struct BlockMessageHeader
+    {
+        uint64_t request_id = 0;
+        uint32_t block_size = 0;
+        uint32_t reserved = 0;
+    };
+
+    bool read_full(int fd, void* data, std::size_t size)
+    {
+        auto ptr = static_cast<uint8_t*>(data);
+        while (size > 0)
+        {
+            ssize_t n = ::read(fd, ptr, size);
+            if (n <= 0)
+            {
+                return false;
+            }
+            ptr += n;
+            size -= static_cast<std::size_t>(n);
+        }
+        return true;
+    }
+
+    bool write_full(int fd, const void* data, std::size_t size)
+    {
+        auto ptr = static_cast<const uint8_t*>(data);
+        while (size > 0)
+        {
+            ssize_t n = ::send(fd, ptr, size, MSG_NOSIGNAL);
+            if (n <= 0)
+            {
+                return false;
+            }
+            ptr += n;
+            size -= static_cast<std::size_t>(n);
+        }
+        return true;
+    }
+
+    void set_no_delay(int fd)
+    {
+        int flag = 1;
+        ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &flag, sizeof(flag));
+    }
+
+    int listen_loopback(uint16_t& port)
+    {
+        int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+        int flag = 1;
+        ::setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &flag, sizeof(flag));
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        ::bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+        ::listen(fd, 64);
+        socklen_t length = sizeof(addr);
+        ::getsockname(fd, reinterpret_cast<sockaddr*>(&addr), &length);
+        port = ntohs(addr.sin_port);
+        return fd;
+    }
+
+    int connect_loopback(uint16_t port)
+    {
+        int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        addr.sin_port = htons(port);
+        if (::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0)
+        {
+            ::close(fd);
+            return -1;
+        }
+        set_no_delay(fd);
+        return fd;
+    }
+
+    /**
+     * @class OriginServer
+     * @brief 源服务端
+     * @details 每条连接一个线程，收到请求后立即返回对应大小的数据。
+     */
+    class OriginServer
+    {
+    public:
+        OriginServer(std::size_t connection_count, uint32_t max_block_size) :
+            m_payload(max_block_size, 0x5a)
+        {
+            m_listen_fd = listen_loopback(m_port);
+            m_accept_thread = std::thread([this, connection_count]()
+                {
+                    for (std::size_t i = 0; i < connection_count; ++i)
+                    {
+                        int fd = ::accept(m_listen_fd, nullptr, nullptr);
+                        if (fd < 0)
+                        {
+                            return;
+                        }
+                        set_no_delay(fd);
+                        m_connection_threads.emplace_back([this, fd]() { serve(fd); });
+                    }
+                });
+        }
+        ~OriginServer()
+        {
+            m_accept_thread.join();
+            for (auto& thread : m_connection_threads)
+            {
+                thread.join();
+            }
+            ::close(m_listen_fd);
+        }
+        uint16_t get_port()const
+        {
+            return m_port;
+        }
+    private:
+        void serve(int fd)
+        {
+            BlockMessageHeader header;
+            while (read_full(fd, &header, sizeof(header)) && header.block_size > 0)
+            {
+                if (!write_full(fd, &header, sizeof(header)) ||
+                    !write_full(fd, m_payload.data(), header.block_size))
+                {
+                    break;
+                }
+            }
+            ::close(fd);
+        }
+    private:
+        std::vector<uint8_t> m_payload;
+        int m_listen_fd = -1;
+        uint16_t m_port = 0;
+        std::thread m_accept_thread;
+        std::vector<std::thread> m_connection_threads;
+    };
+
+    /**
+     * @class DelayLine
+     * @brief 单方向延迟线
+     * @details 读线程读取数据并标记到期时间，写线程到期后转发；延迟线中的字节数达到上限时读线程暂停，
+     *          因此单条连接的吞吐约为 window_bytes / one_way_delay。
+     */
+    class DelayLine
+    {
+    public:
+        DelayLine(int from_fd, int to_fd, std::chrono::microseconds one_way_delay, std::size_t window_bytes) :
+            m_from_fd(from_fd), m_to_fd(to_fd), m_delay(one_way_delay), m_window_bytes(window_bytes)
+        {
+            m_reader = std::thread([this]() { read_loop(); });
+            m_writer = std::thread([this]() { write_loop(); });
+        }
+        ~DelayLine()
+        {
+            m_reader.join();
+            m_writer.join();
+        }
+    private:
+        struct Segment
+        {
+            Clock::time_point due;
+            std::vector<uint8_t> data;
+        };
+        void read_loop()
+        {
+            std::vector<uint8_t> buffer(64 * 1024);
+            while (true)
+            {
+                {
+                    std::unique_lock<std::mutex> lock(m_mutex);
+                    m_condition.wait(lock, [this]() { return m_queued_bytes < m_window_bytes; });
+                }
+                ssize_t n = ::read(m_from_fd, buffer.data(), buffer.size());
+                std::lock_guard<std::mutex> lock(m_mutex);
+                if (n <= 0)
+                {
+                    m_is_closed = true;
+                    m_condition.notify_all();
+                    return;
+                }
+                m_segments.push_back(Segment{ Clock::now() + m_delay,
+                    std::vector<uint8_t>(buffer.begin(), buffer.begin() + n) });
+                m_queued_bytes += static_cast<std::size_t>(n);
+                m_condition.notify_all();
+            }
+        }
+        void write_loop()
+        {
+            while (true)
+            {
+                Segment segment;
+                {
+                    std::unique_lock<std::mutex> lock(m_mutex);
+                    m_condition.wait(lock, [this]() { return m_is_closed || !m_segments.empty(); });
+                    if (m_segments.empty())
+                    {
+                        ::shutdown(m_to_fd, SHUT_WR);
+                        return;
+                    }
+                    segment = std::move(m_segments.front());
+                    m_segments.pop_front();
+                }
+                std::this_thread::sleep_until(segment.due);
+                bool is_written = write_full(m_to_fd, segment.data.data(), segment.data.size());
+                {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    m_queued_bytes -= segment.data.size();
+                    m_condition.notify_all();
+                }
+                if (!is_written)
+                {
+                    return;
+                }
+            }
+        }
+    private:
+        int m_from_fd;
+        int m_to_fd;
+        std::chrono::microseconds m_delay;
+        std::size_t m_window_bytes;
+        std::mutex m_mutex;
+        std::condition_variable m_condition;
+        std::deque<Segment> m_segments;
+        std::size_t m_queued_bytes = 0;
+        bool m_is_closed = false;
+        std::thread m_reader;
+        std::thread m_writer;
+    };
+
+    /**
+     * @class DelayProxy
+     * @brief 延迟代理
+     * @details 每接受一条客户端连接即连接源服务端，并在两个方向各建立一条延迟线。
+     */
+    class DelayProxy
+    {
+    public:
+        DelayProxy(std::size_t connection_count, uint16_t origin_port,
+            std::chrono::microseconds one_way_delay, std::size_t window_bytes)
+        {
+            m_listen_fd = listen_loopback(m_port);
+            m_accept_thread = std::thread([=, this]()
+                {
+                    for (std::size_t i = 0; i < connection_count; ++i)
+                    {
+                        int client_fd = ::accept(m_listen_fd, nullptr, nullptr);
+                        if (client_fd < 0)
+                        {
+                            return;
+                        }
+                        set_no_delay(client_fd);
+                        int origin_fd = connect_loopback(origin_port);
+                        m_fds.push_back(client_fd);
+                        m_fds.push_back(origin_fd);
+                        m_lines.push_back(std::make_unique<DelayLine>(client_fd, origin_fd, one_way_delay, window_bytes));
+                        m_lines.push_back(std::make_unique<DelayLine>(origin_fd, client_fd, one_way_delay, window_bytes));
+                    }
+                });
+        }
+        ~DelayProxy()
+        {
+            m_accept_thread.join();
+            m_lines.clear();
+            for (int fd : m_fds)
+            {
+                ::close(fd);
+            }
+            ::close(m_listen_fd);
+        }
+        uint16_t get_port()const
+        {
+            return m_port;
+        }
+    private:
+        int m_listen_fd = -1;
+        uint16_t m_port = 0;
+        std::thread m_accept_thread;
+        std::vector<int> m_fds;
+        std::vector<std::unique_ptr<DelayLine>> m_lines;
+    };
+
+    double run_download(std::size_t pool_size, std::chrono::microseconds one_way_delay,
+        std::size_t window_bytes, uint32_t block_size, uint64_t block_count, int64_t max_in_flight)
+    {
+        OriginServer origin(pool_size, block_size);
+        DelayProxy proxy(pool_size, origin.get_port(), one_way_delay, window_bytes);
+
+        DaneJoe::LeastOutstandingBalancer balancer;
+        std::vector<int> fds;
+        for (std::size_t i = 0; i < pool_size; ++i)
+        {
+            fds.push_back(connect_loopback(proxy.get_port()));
+            balancer.add_slot();
+        }
+
+        std::mutex mutex;
+        std::condition_variable condition;
+        std::deque<uint64_t> completed_ids;
+        std::vector<std::thread> readers;
+        for (int fd : fds)
+        {
+            readers.emplace_back([&, fd]()
+                {
+                    std::vector<uint8_t> buffer(block_size);
+                    BlockMessageHeader header;
+                    while (read_full(fd, &header, sizeof(header)) &&
+                        read_full(fd, buffer.data(), header.block_size))
+                    {
+                        std::lock_guard<std::mutex> lock(mutex);
+                        completed_ids.push_back(header.request_id);
+                        condition.notify_one();
+                    }
+                });
+        }
+
+        uint64_t next_request = 0;
+        uint64_t completed = 0;
+        int64_t in_flight = 0;
+        auto start = Clock::now();
+        while (completed < block_count)
+        {
+            while (in_flight < max_in_flight && next_request < block_count)
+            {
+                auto slot = balancer.select().value_or(0);
+                BlockMessageHeader header{ next_request, block_size, 0 };
+                write_full(fds[slot], &header, sizeof(header));
+                balancer.on_dispatched(next_request, slot, block_size);
+                next_request++;
+                in_flight++;
+            }
+            std::deque<uint64_t> ids;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                condition.wait(lock, [&]() { return !completed_ids.empty(); });
+                ids.swap(completed_ids);
+            }
+            for (auto id : ids)
+            {
+                balancer.on_finished(id);
+                completed++;
+                in_flight--;
+            }
+        }
+        auto elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+
+        for (int fd : fds)
+        {
+            BlockMessageHeader stop{};
+            write_full(fd, &stop, sizeof(stop));
+            ::shutdown(fd, SHUT_WR);
+        }
+        for (auto& reader : readers)
+        {
+            reader.join();
+        }
+        for (int fd : fds)
+        {
+            ::close(fd);
+        }
+        return static_cast<double>(block_count) * block_size / elapsed / (1024.0 * 1024.0);
+    }
+}
+
+int main()
+{
+    DaneJoe::Bench::silence_default_logger();
+    const std::vector<std::size_t> pool_sizes = { 1, 2, 4, 8 };
+    const std::vector<std::chrono::microseconds> one_way_delays = {
+        std::chrono::microseconds(5000),
+        std::chrono::microseconds(25000) };
+    // 每条连接在途字节上限，模拟单条 TCP 流的窗口
+    const std::size_t window_bytes = 1024 * 1024;
+    const uint32_t block_size = 256 * 1024;
+    const int64_t max_in_flight = 64;
+    // 每个样本传输约 128MB
+    const uint64_t block_count = 128ULL * 1024 * 1024 / block_size;
+
+    std::printf("per-connection window: %zu KB, block: %u KB, max in flight: %lld\n",
+        window_bytes / 1024, block_size / 1024, static_cast<long long>(max_in_flight));
+    std::printf("%-10s %-6s %12s\n", "rtt_ms", "pool", "MB/s");
+    for (auto delay : one_way_delays)
+    {
+        for (auto pool_size : pool_sizes)
+        {
+            double mb_per_second = run_download(pool_size, delay, window_bytes, block_size, block_count, max_in_flight);
+            std::printf("%-10.1f %-6zu %12.1f\n",
+                static_cast<double>(delay.count()) * 2.0 / 1000.0,
+                pool_size,
+                mb_per_second);
+        }
+    }
+    return 0;
+}
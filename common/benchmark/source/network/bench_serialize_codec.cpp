@@ -0,0 +1,201 @@
+/**
+ * @file bench_serialize_codec.cpp
+ * @author DaneJoe (danejoe001.github)
+ * @brief 序列化编码基准测试
+ * @version 0.2.0
+ * @date 2026-01-06
+ * @details 以传输协议中的典型消息为样本，对比具名字段模式（Named）与紧凑模式（Compact）的
+ *          编码体积、编码耗时与解码耗时。
+ */
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+#include <functional>
+
+#include "danejoe/network/codec/serialize_codec.hpp"
+#include "danejoe/network/codec/serialize_field_tag_table.hpp"
+
+#include "bench_util.hpp"
+
+namespace
+{
+    /**
+     * @brief 获取基准测试使用的字段标签表
+     * @return 标签表
+     * @note 与客户端/服务端 message_field_tag 保持一致。
+     */
+    std::shared_ptr<const DaneJoe::SerializeFieldTagTable> get_tag_table()
+    {
+        static const auto table = std::make_shared<const DaneJoe::SerializeFieldTagTable>(
+            std::initializer_list<std::pair<uint32_t, std::string>>{
+                { 1, "version" }, { 2, "request_id" }, { 3, "request_type" },
+                { 4, "path" }, { 5, "content_type" }, { 6, "body" }, { 7, "status" },
+                { 16, "block_id" }, { 17, "file_id" }, { 18, "task_id" },
+                { 19, "offset" }, { 20, "block_size" }, { 21, "data" },
+                { 22, "file_name" }, { 23, "file_size" }, { 24, "md5_code" },
+                { 25, "message" } });
+        return table;
+    }
+
+    DaneJoe::SerializeConfig make_config(DaneJoe::SerializeVersion version)
+    {
+        DaneJoe::SerializeConfig config;
+        config.version = version;
+        config.field_tag_table = get_tag_table();
+        return config;
+    }
+
+    /// @brief 单个基准样本
+    struct BenchCase
+    {
+        /// @brief 样本名称
+        std::string name;
+        /// @brief 迭代次数
+        uint64_t iterations;
+        /// @brief 编码函数
+        std::function<void(DaneJoe::SerializeCodec&)> build;
+        /// @brief 需要读取的字段名
+        std::vector<std::string> fields;
+    };
+
+    std::vector<BenchCase> make_cases()
+    {
+        static const std::vector<uint8_t> block_data(1024 * 1024, 0x5a);
+        static const std::vector<uint8_t> envelope_body(48, 0x01);
+        std::vector<BenchCase> cases;
+        cases.push_back({ "envelope", 200000,
+            [](DaneJoe::SerializeCodec& codec)
+            {
+                codec.serialize(static_cast<uint16_t>(1), "version");
+                codec.serialize(static_cast<uint64_t>(123456), "request_id");
+                codec.serialize(static_cast<uint8_t>(3), "request_type");
+                codec.serialize(std::string("/block"), "path");
+                codec.serialize(static_cast<uint8_t>(1), "content_type");
+                codec.serialize(envelope_body, "body");
+            },
+            { "version", "request_id", "request_type", "path", "content_type", "body" } });
+        cases.push_back({ "block_request", 200000,
+            [](DaneJoe::SerializeCodec& codec)
+            {
+                codec.serialize(static_cast<int64_t>(42), "block_id");
+                codec.serialize(static_cast<int64_t>(7), "file_id");
+                codec.serialize(static_cast<int64_t>(3), "task_id");
+                codec.serialize(static_cast<int64_t>(42LL * 1024 * 1024), "offset");
+                codec.serialize(static_cast<int64_t>(1024 * 1024), "block_size");
+            },
+            { "block_id", "file_id", "task_id", "offset", "block_size" } });
+        cases.push_back({ "download_response", 200000,
+            [](DaneJoe::SerializeCodec& codec)
+            {
+                codec.serialize(static_cast<int64_t>(3), "task_id");
+                codec.serialize(static_cast<int64_t>(7), "file_id");
+                codec.serialize(std::string("dataset.tar.gz"), "file_name");
+                codec.serialize(static_cast<int64_t>(4LL * 1024 * 1024 * 1024), "file_size");
+                codec.serialize(std::string("9e107d9d372bb6826bd81d3542a419d6"), "md5_code");
+            },
+            { "task_id", "file_id", "file_name", "file_size", "md5_code" } });
+        cases.push_back({ "test_request", 200000,
+            [](DaneJoe::SerializeCodec& codec)
+            {
+                codec.serialize(std::string("ping"), "message");
+            },
+            { "message" } });
+        cases.push_back({ "block_response_1MB", 500,
+            [](DaneJoe::SerializeCodec& codec)
+            {
+                codec.serialize(static_cast<int64_t>(42), "block_id");
+                codec.serialize(static_cast<int64_t>(7), "file_id");
+                codec.serialize(static_cast<int64_t>(3), "task_id");
+                codec.serialize(static_cast<int64_t>(42LL * 1024 * 1024), "offset");
+                codec.serialize(static_cast<int64_t>(1024 * 1024), "block_size");
+                codec.serialize(block_data, "data");
+            },
+            { "block_id", "file_id", "task_id", "offset", "block_size", "data" } });
+        return cases;
+    }
+
+    /// @brief 单次测量结果
+    struct BenchResult
+    {
+        /// @brief 编码后字节数
+        std::size_t size = 0;
+        /// @brief 编码耗时（纳秒/次）
+        double encode_ns = 0.0;
+        /// @brief 复用编码器与缓冲区时的编码耗时（纳秒/次）
+        double reuse_encode_ns = 0.0;
+        /// @brief 解码耗时（纳秒/次）
+        double decode_ns = 0.0;
+        /// @brief 往返结果是否一致
+        bool is_roundtrip_ok = false;
+    };
+
+    BenchResult run_case(const BenchCase& bench_case, DaneJoe::SerializeVersion version)
+    {
+        BenchResult result;
+        auto config = make_config(version);
+
+        DaneJoe::SerializeCodec reference_codec(config);
+        bench_case.build(reference_codec);
+        std::vector<uint8_t> encoded = reference_codec.get_serialized_data_vector_build();
+        result.size = encoded.size();
+
+        DaneJoe::SerializeCodec check_codec(config);
+        check_codec.deserialize(encoded);
+        result.is_roundtrip_ok = true;
+        for (const auto& field_name : bench_case.fields)
+        {
+            if (!check_codec.get_parsed_field(field_name).has_value())
+            {
+                result.is_roundtrip_ok = false;
+            }
+        }
+
+        result.encode_ns = DaneJoe::Bench::measure_ns_per_op(bench_case.iterations, [&]()
+            {
+                DaneJoe::SerializeCodec codec(config);
+                bench_case.build(codec);
+                auto data = codec.get_serialized_data_vector_build();
+                DaneJoe::Bench::do_not_optimize(data.data());
+            });
+        DaneJoe::SerializeCodec reuse_codec(config);
+        std::vector<uint8_t> reuse_buffer;
+        result.reuse_encode_ns = DaneJoe::Bench::measure_ns_per_op(bench_case.iterations, [&]()
+            {
+                reuse_codec.reset_build(std::move(reuse_buffer));
+                bench_case.build(reuse_codec);
+                reuse_buffer = reuse_codec.take_serialized_data_vector_build();
+                DaneJoe::Bench::do_not_optimize(reuse_buffer.data());
+            });
+        result.decode_ns = DaneJoe::Bench::measure_ns_per_op(bench_case.iterations, [&]()
+            {
+                DaneJoe::SerializeCodec codec(config);
+                codec.deserialize(encoded);
+                auto field = codec.get_parsed_field(bench_case.fields.front());
+                DaneJoe::Bench::do_not_optimize(field.has_value());
+            });
+        return result;
+    }
+}
+
+int main()
+{
+    DaneJoe::Bench::silence_default_logger();
+    std::printf("%-20s %10s %10s %7s %12s %12s %12s %12s %12s %s\n",
+        "case", "named_B", "compact_B", "ratio",
+        "named_enc", "compact_enc", "reuse_enc", "named_dec", "compact_dec", "roundtrip");
+    bool is_all_ok = true;
+    for (const auto& bench_case : make_cases())
+    {
+        BenchResult named = run_case(bench_case, DaneJoe::SerializeVersion::Named);
+        BenchResult compact = run_case(bench_case, DaneJoe::SerializeVersion::Compact);
+        bool is_ok = named.is_roundtrip_ok && compact.is_roundtrip_ok;
+        is_all_ok = is_all_ok && is_ok;
+        std::printf("%-20s %10zu %10zu %6.2f%% %10.1fns %10.1fns %10.1fns %10.1fns %10.1fns %s\n",
+            bench_case.name.c_str(), named.size, compact.size,
+            100.0 * static_cast<double>(compact.size) / static_cast<double>(named.size),
+            named.encode_ns, compact.encode_ns, compact.reuse_encode_ns, named.decode_ns, compact.decode_ns,
+            is_ok ? "ok" : "FAILED");
+    }
+    return is_all_ok ? 0 : 1;
+}
@@ -13,6 +13,7 @@
 #include <type_traits>
 
 #include "danejoe/common/enum/enum_convert.hpp"
+#include "danejoe/common/binary/byte_swap.hpp"
 
  /**
   * @namespace DaneJoe
@@ -69,7 +70,8 @@ namespace DaneJoe
      * @note 仅对对象表示（object representation）进行字节翻转；不处理高层语义。
      * @note dest 与 data 均须指向至少 sizeof(T) * count 字节的有效内存。
      * @note 如果 dest 为 nullptr 或 data 为 nullptr，则不进行转换。
-     * @note 如果 is_network_byte_order() 为 true，则直接 memcpy（无翻转）。
+     * @note 如果 is_network_byte_order() 为 true 或元素为单字节，则直接 memcpy（无翻转）。
+     * @note 多元素翻转交由 byte_swap_copy() 按 CPU 能力选择向量内核。
      * @note dest 与 data 内存区域应避免重叠（否则 memcpy 行为未定义）。
      */
     template <class T, typename =
@@ -80,23 +82,13 @@ namespace DaneJoe
         {
             return;
         }
-        if (is_network_byte_order())
+        if (sizeof(T) == 1 || is_network_byte_order())
         {
             std::memcpy(dest, data, sizeof(T) * count);
         }
         else
         {
-            for (uint32_t i = 0; i < count; i++)
-            {
-                // 每个元素目标的开始位置
-                uint32_t dest_index = i * sizeof(T);
-                // 每个元素源的结束位置
-                const uint8_t* src_ptr = reinterpret_cast<const uint8_t*>(data + i);
-                for (uint32_t j = 0; j < sizeof(T); j++)
-                {
-                    dest[dest_index + j] = src_ptr[sizeof(T) - j - 1];
-                }
-            }
+            byte_swap_copy(dest, reinterpret_cast<const uint8_t*>(data), sizeof(T), count);
         }
     }
     /**
@@ -248,13 +240,8 @@ namespace DaneJoe
         std::enable_if_t<std::is_trivially_copyable_v<T>, int>>
         std::vector<T> to_network_byte_order_array(const T* data, uint32_t count = 1)
     {
-        std::vector<T> dest(count);
-        std::memcpy(dest.data(), data, sizeof(T) * count);
         std::vector<T> result(count);
-        for (uint32_t i = 0; i < count; i++)
-        {
-            convert_byte_order<T>(reinterpret_cast<uint8_t*>(result.data() + i), dest[i]);
-        }
+        convert_byte_order<T>(reinterpret_cast<uint8_t*>(result.data()), data, count);
         return result;
     }
     /**
@@ -284,13 +271,8 @@ namespace DaneJoe
         std::enable_if_t<std::is_trivially_copyable_v<T>, int>>
         std::vector<T> to_local_byte_order_array(const T* data, uint32_t count = 1)
     {
-        std::vector<T> dest(count);
-        std::memcpy(dest.data(), data, sizeof(T) * count);
         std::vector<T> result(count);
-        for (uint32_t i = 0; i < count; i++)
-        {
-            convert_byte_order<T>(reinterpret_cast<uint8_t*>(result.data() + i), dest[i]);
-        }
+        convert_byte_order<T>(reinterpret_cast<uint8_t*>(result.data()), data, count);
         return result;
     }
 }
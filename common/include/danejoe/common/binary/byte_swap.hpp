@@ -0,0 +1,74 @@
+/**
+ * @file byte_swap.hpp
+ * @brief 批量字节翻转
+ * @author DaneJoe001
+ * @version 0.2.0
+ * @date 2026-01-06
+ * @details 为定宽数值数组（2/4/8 字节元素）提供批量字节翻转内核。
+ *          运行时根据 CPU 能力选择 AVX2/SSSE3（pshufb）或 NEON（vrev）实现，不支持时回退标量实现。
+ */
+#pragma once
+
+#include <string>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @namespace DaneJoe
+ * @brief DaneJoe 命名空间
+ */
+namespace DaneJoe
+{
+    /**
+     * @enum ByteSwapKernel
+     * @brief 字节翻转内核
+     */
+    enum class ByteSwapKernel :uint8_t
+    {
+        /// @brief 标量实现
+        Scalar,
+        /// @brief SSSE3 pshufb（16 字节/次）
+        Ssse3,
+        /// @brief AVX2 vpshufb（32 字节/次）
+        Avx2,
+        /// @brief NEON vrev（16 字节/次）
+        Neon
+    };
+    /**
+     * @brief 获取字节翻转内核字符串（调试用）
+     * @param kernel 字节翻转内核
+     * @return 对应的枚举字符串
+     */
+    std::string to_string(ByteSwapKernel kernel);
+    /**
+     * @brief 判断当前 CPU 是否支持指定内核
+     * @param kernel 字节翻转内核
+     * @return 支持返回 true
+     */
+    bool is_byte_swap_kernel_supported(ByteSwapKernel kernel)noexcept;
+    /**
+     * @brief 获取当前 CPU 上的最优内核
+     * @return 首次调用时探测并缓存的内核
+     */
+    ByteSwapKernel get_byte_swap_kernel()noexcept;
+    /**
+     * @brief 批量翻转元素字节序并写入目标地址
+     * @param dest 目标地址
+     * @param src 源地址
+     * @param element_size 元素宽度（字节）
+     * @param count 元素数量
+     * @note 元素宽度为 2/4/8 时使用向量内核，其余宽度使用标量实现。
+     * @note dest 可以等于 src（原地翻转），但不允许部分重叠。
+     */
+    void byte_swap_copy(uint8_t* dest, const uint8_t* src, std::size_t element_size, std::size_t count)noexcept;
+    /**
+     * @brief 使用指定内核批量翻转元素字节序
+     * @param kernel 字节翻转内核（不支持时回退标量实现）
+     * @param dest 目标地址
+     * @param src 源地址
+     * @param element_size 元素宽度（字节）
+     * @param count 元素数量
+     * @note 主要用于基准测试与结果对照。
+     */
+    void byte_swap_copy(ByteSwapKernel kernel, uint8_t* dest, const uint8_t* src, std::size_t element_size, std::size_t count)noexcept;
+}
@@ -0,0 +1,166 @@
+/**
+ * @file inplace_function.hpp
+ * @author DaneJoe (danejoe001.github)
+ * @brief 内联存储的可调用对象包装
+ * @version 0.2.0
+ * @date 2026-01-09
+ * @details 与 std::function 类似，但可调用对象始终存放在对象内部的固定大小缓冲区中，构造与移动都不会分配内存。
+ *          可调用对象超出缓冲区时在编译期报错，而不是退化为堆分配。仅支持移动。
+ */
+#pragma once
+
+#include <new>
+#include <cstddef>
+#include <utility>
+#include <functional>
+#include <type_traits>
+
+ /**
+  * @namespace DaneJoe
+  * @brief DaneJoe 命名空间
+  */
+namespace DaneJoe
+{
+    /**
+     * @class InplaceFunction
+     * @brief 内联存储的可调用对象包装
+     * @tparam Signature 函数签名
+     * @tparam Capacity 内联缓冲区大小（字节）
+     */
+    template<typename Signature, std::size_t Capacity = 32>
+    class InplaceFunction;
+
+    template<typename R, typename... Args, std::size_t Capacity>
+    class InplaceFunction<R(Args...), Capacity>
+    {
+    public:
+        /**
+         * @brief 构造空对象
+         */
+        InplaceFunction() = default;
+        /**
+         * @brief 构造空对象
+         */
+        InplaceFunction(std::nullptr_t) {}
+        /**
+         * @brief 由可调用对象构造
+         * @tparam F 可调用对象类型
+         * @param function 可调用对象
+         */
+        template<typename F,
+            typename = std::enable_if_t<!std::is_same_v<std::decay_t<F>, InplaceFunction>>>
+        InplaceFunction(F&& function)
+        {
+            using Functor = std::decay_t<F>;
+            static_assert(sizeof(Functor) <= Capacity, "InplaceFunction: callable does not fit in the inline buffer");
+            static_assert(alignof(Functor) <= alignof(std::max_align_t), "InplaceFunction: callable is over-aligned");
+            static_assert(std::is_nothrow_move_constructible_v<Functor>, "InplaceFunction: callable must be nothrow movable");
+            ::new (static_cast<void*>(m_storage)) Functor(std::forward<F>(function));
+            m_invoke = [](void* storage, Args&&... args) -> R
+                {
+                    return std::invoke(*static_cast<Functor*>(storage), std::forward<Args>(args)...);
+                };
+            m_manage = [](void* destination, void* source)
+                {
+                    auto* functor = static_cast<Functor*>(source);
+                    if (destination)
+                    {
+                        ::new (destination) Functor(std::move(*functor));
+                    }
+                    functor->~Functor();
+                };
+        }
+        /**
+         * @brief 移动构造函数
+         * @param other 被移动对象，移动后为空
+         */
+        InplaceFunction(InplaceFunction&& other) noexcept
+        {
+            move_from(other);
+        }
+        /**
+         * @brief 移动赋值运算符
+         * @param other 被移动对象，移动后为空
+         * @return 自身引用
+         */
+        InplaceFunction& operator=(InplaceFunction&& other) noexcept
+        {
+            if (this != &other)
+            {
+                reset();
+                move_from(other);
+            }
+            return *this;
+        }
+        /**
+         * @brief 置空
+         * @return 自身引用
+         */
+        InplaceFunction& operator=(std::nullptr_t) noexcept
+        {
+            reset();
+            return *this;
+        }
+        InplaceFunction(const InplaceFunction&) = delete;
+        InplaceFunction& operator=(const InplaceFunction&) = delete;
+        /**
+         * @brief 析构函数
+         */
+        ~InplaceFunction()
+        {
+            reset();
+        }
+        /**
+         * @brief 调用
+         * @param args 参数
+         * @return 可调用对象的返回值
+         * @note 对象为空时调用为未定义行为
+         */
+        R operator()(Args... args)
+        {
+            return m_invoke(static_cast<void*>(m_storage), std::forward<Args>(args)...);
+        }
+        /**
+         * @brief 是否持有可调用对象
+         */
+        explicit operator bool()const noexcept
+        {
+            return m_invoke != nullptr;
+        }
+    private:
+        /**
+         * @brief 析构持有的可调用对象并置空
+         */
+        void reset() noexcept
+        {
+            if (m_manage)
+            {
+                m_manage(nullptr, static_cast<void*>(m_storage));
+            }
+            m_invoke = nullptr;
+            m_manage = nullptr;
+        }
+        /**
+         * @brief 从另一对象移入可调用对象
+         * @param other 被移动对象，移动后为空
+         */
+        void move_from(InplaceFunction& other) noexcept
+        {
+            if (other.m_manage)
+            {
+                other.m_manage(static_cast<void*>(m_storage), static_cast<void*>(other.m_storage));
+            }
+            m_invoke = other.m_invoke;
+            m_manage = other.m_manage;
+            other.m_invoke = nullptr;
+            other.m_manage = nullptr;
+        }
+    private:
+        /// @brief 内联缓冲区
+        alignas(std::max_align_t) unsigned char m_storage[Capacity];
+        /// @brief 调用函数
+        R(*m_invoke)(void*, Args&&...) = nullptr;
+        /// @brief 管理函数：destination 非空时将可调用对象移入其中，随后析构 source 中的对象
+        void (*m_manage)(void* destination, void* source) = nullptr;
+    };
+}
@@ -0,0 +1,159 @@
+/**
+ * @file file_delta.hpp
+ * @author DaneJoe (danejoe001.github)
+ * @brief 文件差量
+ * @version 0.2.0
+ * @date 2026-01-08
+ * @details rsync 式差量传输：
+ *          - 接收方将已有的旧文件（基准文件）按固定大小切块，计算每块的滚动校验和与 XXH64，得到 FileSignature；
+ *          - 发送方在新文件的任意偏移上滚动查找与签名中块相同的窗口，命中部分编码为复制指令，其余为字面数据，得到 FileDelta；
+ *          - 接收方按指令从基准文件复制或写入字面数据，重建新文件。
+ *          差量大小与改动量成正比，与文件大小基本无关。强哈希为非加密哈希，重建结果需由整体 MD5 最终确认。
+ */
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <optional>
+
+#include "danejoe/common/hash/md5.hpp"
+
+ /**
+  * @namespace DaneJoe
+  * @brief DaneJoe 命名空间
+  */
+namespace DaneJoe
+{
+    /**
+     * @struct BlockSignature
+     * @brief 基准文件中单个块的签名
+     */
+    struct BlockSignature
+    {
+        /// @brief 滚动校验和
+        uint32_t weak_checksum = 0;
+        /// @brief XXH64
+        uint64_t strong_hash = 0;
+    };
+    /**
+     * @struct FileSignature
+     * @brief 基准文件签名
+     */
+    struct FileSignature
+    {
+        /// @brief 最小块大小
+        static constexpr int64_t MIN_BLOCK_SIZE = 2 * 1024;
+        /// @brief 最大块大小
+        static constexpr int64_t MAX_BLOCK_SIZE = 128 * 1024;
+        /// @brief 最大块数（签名约 192 MiB）
+        static constexpr uint64_t MAX_BLOCK_COUNT = 16 * 1024 * 1024;
+        /// @brief 基准文件大小
+        int64_t file_size = 0;
+        /// @brief 块大小（最后一块可能不足）
+        int64_t block_size = 0;
+        /// @brief 各块签名
+        std::vector<BlockSignature> blocks;
+        /**
+         * @brief 按文件大小选择块大小
+         * @param file_size 文件大小
+         * @return 约为文件大小的平方根，限制在 [2 KiB, 128 KiB] 并按 1 KiB 对齐
+         * @details 块越小匹配越精细但签名越大，取平方根使两者同阶。
+         */
+        static int64_t get_block_size_for(int64_t file_size);
+        /**
+         * @brief 编码
+         * @return 字节数组（小端）
+         */
+        std::vector<uint8_t> encode()const;
+        /**
+         * @brief 解码
+         * @param bytes encode() 的输出
+         * @return 签名，格式或长度不合法、块大小超出 [MIN_BLOCK_SIZE, MAX_BLOCK_SIZE]
+         *         或块数超过 MAX_BLOCK_COUNT 时返回 std::nullopt
+         * @note 签名来自对端，解码结果会直接决定差量计算的内存用量。
+         */
+        static std::optional<FileSignature> decode(const std::vector<uint8_t>& bytes);
+        /**
+         * @brief 计算文件签名
+         * @param path 基准文件路径
+         * @param block_size 块大小，<=0 时按文件大小选择
+         * @return 签名，文件无法读取时返回 std::nullopt
+         */
+        static std::optional<FileSignature> build_from_file(const std::string& path, int64_t block_size = 0);
+    };
+    /**
+     * @enum DeltaOperation
+     * @brief 差量指令类型
+     */
+    enum class DeltaOperation : uint8_t
+    {
+        /// @brief 从基准文件复制
+        Copy = 0,
+        /// @brief 写入字面数据
+        Literal = 1
+    };
+    /**
+     * @struct DeltaInstruction
+     * @brief 差量指令
+     */
+    struct DeltaInstruction
+    {
+        /// @brief 指令类型
+        DeltaOperation operation = DeltaOperation::Literal;
+        /// @brief 复制指令在基准文件中的偏移
+        int64_t basis_offset = 0;
+        /// @brief 输出长度
+        int64_t length = 0;
+        /// @brief 字面数据
+        std::vector<uint8_t> data;
+    };
+    /**
+     * @struct FileDelta
+     * @brief 由基准文件重建新文件的差量
+     */
+    struct FileDelta
+    {
+        /// @brief 新文件大小
+        int64_t file_size = 0;
+        /// @brief 指令序列，按输出偏移顺序排列
+        std::vector<DeltaInstruction> instructions;
+        /**
+         * @brief 字面数据总字节数
+         * @return 需要实际传输的文件数据量
+         */
+        int64_t get_literal_bytes()const;
+        /**
+         * @brief 编码
+         * @return 字节数组（小端）
+         */
+        std::vector<uint8_t> encode()const;
+        /**
+         * @brief 解码
+         * @param bytes encode() 的输出
+         * @return 差量，格式不合法或指令长度之和与文件大小不符时返回 std::nullopt
+         */
+        static std::optional<FileDelta> decode(const std::vector<uint8_t>& bytes);
+        /**
+         * @brief 多线程计算新文件相对签名的差量
+         * @param path 新文件路径
+         * @param signature 基准文件签名
+         * @param thread_count 线程数，<=0 时使用硬件并发数
+         * @return 差量，文件无法读取或签名块大小不在 [MIN_BLOCK_SIZE, MAX_BLOCK_SIZE] 时返回 std::nullopt
+         * @details 新文件按偏移均分为连续的若干段，每个线程独立读取并在自己的段内滚动匹配，
+         *          匹配窗口不跨段，因此分段只会让段边界附近少量数据退化为字面数据。
+         *          各段结果按顺序拼接，相邻的同类指令合并。
+         */
+        static std::optional<FileDelta> compute(
+            const std::string& path,
+            const FileSignature& signature,
+            int thread_count = 0);
+        /**
+         * @brief 应用差量
+         * @param basis_path 基准文件路径
+         * @param output_path 输出文件路径（覆盖写入，不能与基准文件相同）
+         * @return 输出文件的 MD5；读写失败或输出长度与 file_size 不符时返回 std::nullopt
+         */
+        std::optional<Md5> apply(const std::string& basis_path, const std::string& output_path)const;
+    };
+}
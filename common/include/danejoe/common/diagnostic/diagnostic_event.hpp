@@ -60,7 +60,7 @@ namespace DaneJoe
     {
         /// @brief 事件标识符
         int64_t event_id;
-        /// @brief 线程标识符（由线程 id 哈希得到）
+        /// @brief 线程标识符（系统线程ID）
         int64_t thread_id;
         /// @brief 事件等级
         DiagnosticEventLevel level;
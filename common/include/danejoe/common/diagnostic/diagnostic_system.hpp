@@ -5,21 +5,25 @@
  * @version 0.2.0
  * @date 2025-12-19
  * @details 诊断系统用于在库内部收集诊断事件（DiagnosticEvent），并提供按模块查询与清空能力。
+ *          事件保存在固定容量的环形缓冲区中，只保留最近的 EVENT_CAPACITY 个。
  *          该模块主要面向库内部日志/调试使用，不对外保证事件格式、等级含义与字符串表示的长期兼容性。
  */
 #pragma once
 
+#include <array>
 #include <atomic>
 #include <mutex>
 #include <vector>
 #include <format>
+#include <memory>
 #include <string>
 #include <string_view>
 #include <utility>
-#include <functional>
-#include <thread>
+#include <cstdint>
+#include <iterator>
 
 #include "danejoe/common/diagnostic/diagnostic_event.hpp"
+#include "danejoe/logger/logger_config.hpp"
 
  /**
   * @namespace DaneJoe
@@ -27,6 +31,7 @@
   */
 namespace DaneJoe
 {
+    class ILogger;
     /**
      * @brief 格式化消息
      * @param message 消息
@@ -49,12 +54,22 @@ namespace DaneJoe
     /**
      * @class DiagnosticSystem
      * @brief 诊断系统
-     * @details 以单例方式管理诊断事件列表。
-     *          对事件列表的读写通过内部互斥锁保护，接口线程安全。
+     * @details 以单例方式管理最近的诊断事件：
+     *          - 事件写入固定容量的环形缓冲区，写满后覆盖最旧的事件，写入不加锁；
+     *          - 模块名、函数名、文件名只保存指针（要求为字符串字面量等静态存储期字符串），消息超过槽位容量时截断；
+     *          - 每个模块可单独设置最低等级，ADD_DIAG_* 宏在格式化消息之前先检查等级；
+     *          - 通过检查的事件同时转发给默认日志器。
+     *          get_events() 等查询接口返回事件副本，读取时跳过正在被覆盖的槽位。
      */
     class DiagnosticSystem
     {
     public:
+        /// @brief 环形缓冲区容量（事件数）
+        static constexpr std::size_t EVENT_CAPACITY = 1024;
+        /// @brief 单个事件消息的最大字节数
+        static constexpr std::size_t MESSAGE_CAPACITY = 200;
+        /// @brief 可单独设置等级的模块数上限
+        static constexpr std::size_t MODULE_LEVEL_CAPACITY = 32;
         /**
          * @brief 获取单例实例
          * @return 单例实例
@@ -62,35 +77,96 @@ namespace DaneJoe
          */
         static DiagnosticSystem& get_instance();
         /**
-         * @brief 添加诊断事件
+         * @brief 是否记录该模块该等级的事件
+         * @param module_name 模块名称
          * @param level 事件等级
+         * @return 是否记录
+         */
+        bool is_enabled(std::string_view module_name, DiagnosticEventLevel level)const
+        {
+            if (m_module_level_count.load(std::memory_order_acquire) == 0)
+            {
+                return level >= m_level.load(std::memory_order_relaxed);
+            }
+            return level >= get_module_level(module_name);
+        }
+        /**
+         * @brief 设置默认最低等级
+         * @param level 最低等级
+         * @details 未单独设置等级的模块使用该等级，默认为 Info。
+         */
+        void set_level(DiagnosticEventLevel level);
+        /**
+         * @brief 设置模块的最低等级
          * @param module_name 模块名称
-         * @param message 事件消息
+         * @param level 最低等级
+         * @return 是否设置成功（超过 MODULE_LEVEL_CAPACITY 个模块时失败）
+         */
+        bool set_module_level(std::string_view module_name, DiagnosticEventLevel level);
+        /**
+         * @brief 获取模块的最低等级
+         * @param module_name 模块名称
+         * @return 最低等级，未单独设置时返回默认等级
+         */
+        DiagnosticEventLevel get_module_level(std::string_view module_name)const;
+        /**
+         * @brief 添加诊断事件
+         * @param level 事件等级
+         * @param module_name 模块名称（静态存储期）
          * @param line_number 行号
-         * @param function_name 函数名称
-         * @param file_name 文件名称
-         * @details 该接口会生成事件ID与线程ID，并将事件追加到内部事件列表。
+         * @param function_name 函数名称（静态存储期）
+         * @param file_name 文件名称（静态存储期）
+         * @param message 事件消息
+         * @details 不检查等级；生成事件ID与线程ID后写入环形缓冲区，并转发给默认日志器。
          */
         void add_event(DiagnosticEventLevel level,
-            const std::string& module_name,
-            const std::string& message, int64_t line_number,
-            const std::string& function_name,
-            const std::string& file_name);
+            const char* module_name,
+            int64_t line_number,
+            const char* function_name,
+            const char* file_name,
+            std::string_view message);
         /**
          * @brief 添加诊断事件
-         * @param event 诊断事件
-         * @details 将事件追加到内部事件列表。
+         * @tparam Args 参数类型
+         * @param level 事件等级
+         * @param module_name 模块名称（静态存储期）
+         * @param line_number 行号
+         * @param function_name 函数名称（静态存储期）
+         * @param file_name 文件名称（静态存储期）
+         * @param message_fmt 消息格式字符串
+         * @param args 格式化参数
+         * @details 消息格式化到线程复用的缓冲区中，稳态下不分配内存。
          */
-        void add_event(const DiagnosticEvent& event);
+        template <typename... Args>
+            requires (sizeof...(Args) > 0)
+        void add_event(DiagnosticEventLevel level,
+            const char* module_name,
+            int64_t line_number,
+            const char* function_name,
+            const char* file_name,
+            std::format_string<Args...> message_fmt,
+            Args&&... args)
+        {
+            std::string message = take_message_buffer();
+            std::format_to(std::back_inserter(message), message_fmt, std::forward<Args>(args)...);
+            add_event(level, module_name, line_number, function_name, file_name, std::string_view(message));
+            return_message_buffer(std::move(message));
+        }
         /**
          * @brief 清空事件
-         * @details 清空内部事件列表。
+         * @details 之后的查询只返回清空后写入的事件。
          */
         void clear_events();
+        /**
+         * @brief 获取丢弃的事件数
+         * @return 因槽位仍被其他写入者占用而未写入缓冲区的事件数
+         * @details 丢弃的事件仍会转发给默认日志器。
+         */
+        uint64_t get_dropped_event_count()const;
         /**
          * @brief 获取事件列表
          * @return 事件列表
-         * @details 返回内部事件列表的副本。
+         * @details 返回缓冲区中仍保留的事件副本，按事件ID升序。
          */
         std::vector<DiagnosticEvent> get_events();
         /**
@@ -101,51 +177,161 @@ namespace DaneJoe
          */
         std::vector<DiagnosticEvent>
             get_events_by_module(const std::string& module_name);
-        // std::optional<DiagnosticEvent> get_last_event();
     private:
+        /**
+         * @struct EventSlot
+         * @brief 环形缓冲区槽位
+         * @details 以顺序锁保护：写入期间 sequence 为奇数，写完后为 2 * (事件ID + 1)。
+         *          写入者以 CAS 从偶数占用槽位，落后一圈或遇到正在写入的槽位时丢弃事件。
+         */
+        struct EventSlot
+        {
+            /// @brief 顺序号
+            std::atomic<uint64_t> sequence = 0;
+            /// @brief 发生时间（system_clock 纪元以来的纳秒数）
+            int64_t timestamp = 0;
+            /// @brief 行号
+            int64_t line_number = 0;
+            /// @brief 模块名称
+            const char* module_name = nullptr;
+            /// @brief 函数名称
+            const char* function_name = nullptr;
+            /// @brief 文件名称
+            const char* file_name = nullptr;
+            /// @brief 线程ID
+            int32_t thread_id = 0;
+            /// @brief 事件等级
+            DiagnosticEventLevel level = DiagnosticEventLevel::Unknown;
+            /// @brief 消息长度
+            uint16_t message_size = 0;
+            /// @brief 消息
+            char message[MESSAGE_CAPACITY] = {};
+        };
+        /**
+         * @struct ModuleLevel
+         * @brief 模块等级
+         */
+        struct ModuleLevel
+        {
+            /// @brief 模块名称
+            std::string module_name;
+            /// @brief 最低等级
+            std::atomic<DiagnosticEventLevel> level = DiagnosticEventLevel::Info;
+        };
         DiagnosticSystem();
         ~DiagnosticSystem();
+        /**
+         * @brief 取出线程复用的消息缓冲区
+         * @return 已清空的缓冲区（嵌套调用时为新字符串）
+         */
+        static std::string take_message_buffer();
+        /**
+         * @brief 归还消息缓冲区
+         * @param buffer 缓冲区
+         */
+        static void return_message_buffer(std::string&& buffer);
+        /**
+         * @brief 转发到默认日志器
+         */
+        void forward_to_logger(DiagnosticEventLevel level,
+            const char* module_name,
+            int64_t line_number,
+            const char* function_name,
+            const char* file_name,
+            std::string_view message);
+        /**
+         * @brief 收集事件副本
+         * @param module_name 模块名称，为空时不过滤
+         * @return 事件列表
+         */
+        std::vector<DiagnosticEvent> collect_events(std::string_view module_name);
     private:
-        /// @brief 事件标识符计数器
-        std::atomic<int64_t> m_event_id = 0;
-        /// @brief 互斥锁
-        std::mutex m_mutex;
-        /// @brief 事件列表
-        std::vector<DiagnosticEvent> m_events;
-        /// @brief 线程 id 哈希器
-        std::hash<std::thread::id> m_thread_id_hash;
+        /// @brief 下一个事件标识符
+        std::atomic<uint64_t> m_next_event_id = 0;
+        /// @brief 清空时的事件标识符，更早的事件不再返回
+        std::atomic<uint64_t> m_cleared_event_id = 0;
+        /// @brief 因槽位被占用而未写入缓冲区的事件数
+        std::atomic<uint64_t> m_dropped_event_count = 0;
+        /// @brief 默认最低等级
+        std::atomic<DiagnosticEventLevel> m_level = DiagnosticEventLevel::Info;
+        /// @brief 已单独设置等级的模块数
+        std::atomic<std::size_t> m_module_level_count = 0;
+        /// @brief 模块等级表（只追加）
+        std::array<ModuleLevel, MODULE_LEVEL_CAPACITY> m_module_levels;
+        /// @brief 模块等级表写入互斥锁
+        std::mutex m_module_level_mutex;
+        /// @brief 事件槽位
+        std::unique_ptr<EventSlot[]> m_slots;
+        /// @brief 默认日志器
+        std::shared_ptr<ILogger> m_logger;
     };
 } // namespace DaneJoe
 
 /**
  * @brief 添加诊断事件宏
  * @param level 事件等级
- * @param module 模块名称
+ * @param module 模块名称（字符串字面量）
  * @param ... 消息格式化参数：支持传入 `std::string_view message` 或 `std::format_string<Args...> message_fmt, Args... args`
  * @details 该宏会自动捕获调用点信息（行号、函数名、文件名），并写入 DiagnosticSystem。
+ *          等级低于模块最低等级时不会求值消息参数。
  *          仅用于库内部诊断/调试，不对外保证接口与输出格式的长期兼容性。
  */
 #define ADD_DIAGNOSTIC_EVENT(level, module, ...)                         \
   do {                                                                   \
     auto &diagnostic_system = DaneJoe::DiagnosticSystem::get_instance(); \
-    diagnostic_system.add_event(                                         \
-        level,                                                           \
-        std::string(module),                                             \
-        DaneJoe::format_message(__VA_ARGS__),                            \
-        __LINE__,                                                        \
-        std::string(__FUNCTION__),                                       \
-        std::string(__FILE__));                                          \
+    if (diagnostic_system.is_enabled(module, level)) {                   \
+      diagnostic_system.add_event(                                       \
+          level,                                                         \
+          module,                                                        \
+          __LINE__,                                                      \
+          __FUNCTION__,                                                  \
+          __FILE__,                                                      \
+          __VA_ARGS__);                                                  \
+    }                                                                    \
+  } while (0)
+
+/**
+ * @brief 按编译期级别添加诊断事件宏
+ * @param active_level 对应的 DANEJOE_LOG_LEVEL_* 取值
+ * @param level 事件等级
+ * @param module 模块名称（字符串字面量）
+ * @param ... 消息格式化参数
+ * @details 低于 DANEJOE_LOG_ACTIVE_LEVEL 的等级在编译期被丢弃。
+ */
+#define ADD_DIAGNOSTIC_EVENT_AT(active_level, level, module, ...)      \
+  do {                                                                 \
+    if constexpr (DANEJOE_LOG_ACTIVE_LEVEL <= active_level) {          \
+      ADD_DIAGNOSTIC_EVENT(level, module, __VA_ARGS__);                \
+    }                                                                  \
   } while (0)
 
+/**
+ * @brief 诊断等级是否启用
+ * @param level 等级名称（Trace/Debug/Info/Warn/Error/Critical）
+ * @param module 模块名称
+ * @details 同时检查编译期与运行时等级，用于跳过仅为诊断服务的额外开销（如额外的系统调用）。
+ */
+#define ADD_DIAG_IS_ENABLED(level, module)                                      \
+  (DANEJOE_LOG_ACTIVE_LEVEL <= DANEJOE_DIAG_ACTIVE_LEVEL_##level &&             \
+   DaneJoe::DiagnosticSystem::get_instance().is_enabled(                        \
+       module, DaneJoe::DiagnosticEventLevel::level))
+
+#define DANEJOE_DIAG_ACTIVE_LEVEL_Trace DANEJOE_LOG_LEVEL_TRACE
+#define DANEJOE_DIAG_ACTIVE_LEVEL_Debug DANEJOE_LOG_LEVEL_DEBUG
+#define DANEJOE_DIAG_ACTIVE_LEVEL_Info DANEJOE_LOG_LEVEL_INFO
+#define DANEJOE_DIAG_ACTIVE_LEVEL_Warn DANEJOE_LOG_LEVEL_WARN
+#define DANEJOE_DIAG_ACTIVE_LEVEL_Error DANEJOE_LOG_LEVEL_ERROR
+#define DANEJOE_DIAG_ACTIVE_LEVEL_Critical DANEJOE_LOG_LEVEL_FATAL
+
 #define ADD_DIAG_TRACE(module, ...) \
-  ADD_DIAGNOSTIC_EVENT(DaneJoe::DiagnosticEventLevel::Trace, module, __VA_ARGS__)
+  ADD_DIAGNOSTIC_EVENT_AT(DANEJOE_LOG_LEVEL_TRACE, DaneJoe::DiagnosticEventLevel::Trace, module, __VA_ARGS__)
 #define ADD_DIAG_DEBUG(module, ...) \
-  ADD_DIAGNOSTIC_EVENT(DaneJoe::DiagnosticEventLevel::Debug, module, __VA_ARGS__)
+  ADD_DIAGNOSTIC_EVENT_AT(DANEJOE_LOG_LEVEL_DEBUG, DaneJoe::DiagnosticEventLevel::Debug, module, __VA_ARGS__)
 #define ADD_DIAG_INFO(module, ...) \
-  ADD_DIAGNOSTIC_EVENT(DaneJoe::DiagnosticEventLevel::Info, module, __VA_ARGS__)
+  ADD_DIAGNOSTIC_EVENT_AT(DANEJOE_LOG_LEVEL_INFO, DaneJoe::DiagnosticEventLevel::Info, module, __VA_ARGS__)
 #define ADD_DIAG_WARN(module, ...) \
-  ADD_DIAGNOSTIC_EVENT(DaneJoe::DiagnosticEventLevel::Warn, module, __VA_ARGS__)
+  ADD_DIAGNOSTIC_EVENT_AT(DANEJOE_LOG_LEVEL_WARN, DaneJoe::DiagnosticEventLevel::Warn, module, __VA_ARGS__)
 #define ADD_DIAG_ERROR(module, ...) \
-  ADD_DIAGNOSTIC_EVENT(DaneJoe::DiagnosticEventLevel::Error, module, __VA_ARGS__)
+  ADD_DIAGNOSTIC_EVENT_AT(DANEJOE_LOG_LEVEL_ERROR, DaneJoe::DiagnosticEventLevel::Error, module, __VA_ARGS__)
 #define ADD_DIAG_FATAL(module, ...) \
-  ADD_DIAGNOSTIC_EVENT(DaneJoe::DiagnosticEventLevel::Fatal, module, __VA_ARGS__)
+  ADD_DIAGNOSTIC_EVENT_AT(DANEJOE_LOG_LEVEL_FATAL, DaneJoe::DiagnosticEventLevel::Critical, module, __VA_ARGS__)
@@ -0,0 +1,215 @@
+/**
+ * @file trace_recorder.hpp
+ * @author DaneJoe001 (danejoe001.github)
+ * @brief 请求跟踪记录器
+ * @version 0.2.0
+ * @date 2026-01-13
+ * @details 在请求路径上的固定跟踪点记录 CLOCK_MONOTONIC_RAW 时间戳，按 (connect_id, request_id) 关联，
+ *          用于回答"一次请求的时间花在哪一段"。
+ *          每个线程写入自己的定长缓冲区，写满后丢弃并计数；导出为 Chrome trace / Perfetto 可读的 JSON。
+ * @note 默认关闭，关闭时每个跟踪点只有一次原子读取。
+ */
+#pragma once
+
+#include <atomic>
+#include <mutex>
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <ostream>
+
+ /**
+  * @namespace DaneJoe
+  * @brief DaneJoe 命名空间
+  */
+namespace DaneJoe
+{
+    /**
+     * @enum TracePoint
+     * @brief 跟踪点
+     * @details 按请求在服务端经过的先后顺序排列。
+     */
+    enum class TracePoint : uint8_t
+    {
+        /// @brief 接受连接（连接级事件，request_id 为 -1）
+        Accept,
+        /// @brief 读到帧的第一个字节
+        FirstByteRead,
+        /// @brief 帧组装完成
+        FrameAssembled,
+        /// @brief 投递到邮箱
+        PushedToMailBox,
+        /// @brief 业务线程取出
+        PoppedByBusiness,
+        /// @brief 数据库查询完成
+        DatabaseLookupDone,
+        /// @brief 文件读取完成
+        FileReadDone,
+        /// @brief 响应编码完成
+        Encoded,
+        /// @brief 响应投递到发送队列
+        QueuedToClient,
+        /// @brief 响应完全写出
+        FullyWritten
+    };
+    /**
+     * @brief 将跟踪点转换为字符串
+     * @param point 跟踪点
+     * @return 跟踪点名称（snake_case，用作 trace 事件名）
+     */
+    const char* to_string(TracePoint point);
+
+    /**
+     * @struct TraceRecord
+     * @brief 跟踪记录
+     */
+    struct TraceRecord
+    {
+        /// @brief 时间戳（CLOCK_MONOTONIC_RAW，纳秒）
+        int64_t timestamp_ns = 0;
+        /// @brief 连接ID
+        uint64_t connect_id = 0;
+        /// @brief 请求ID（连接级事件为 -1）
+        int64_t request_id = -1;
+        /// @brief 记录线程的系统线程ID
+        int32_t thread_id = 0;
+        /// @brief 跟踪点
+        TracePoint point = TracePoint::Accept;
+    };
+
+    /**
+     * @class TraceRecorder
+     * @brief 请求跟踪记录器
+     * @details 单例。记录写入调用线程首次记录时创建的缓冲区，缓冲区由记录器持有，线程退出后仍可导出。
+     *          IO 线程在解析请求之前不知道 request_id，相应时间戳随帧传递（见 FrameTrace），
+     *          由业务线程解析出 request_id 后补记。
+     */
+    class TraceRecorder
+    {
+    public:
+        /// @brief 默认每个线程的记录容量（每条 32 字节）
+        static constexpr std::size_t DEFAULT_THREAD_CAPACITY = 64 * 1024;
+        /**
+         * @brief 获取单例
+         * @return 单例引用
+         */
+        static TraceRecorder& get_instance();
+        /**
+         * @brief 获取当前时间戳
+         * @return CLOCK_MONOTONIC_RAW 纳秒
+         */
+        static int64_t now();
+        /**
+         * @brief 是否启用
+         * @return 启用返回 true
+         */
+        bool is_enabled()const
+        {
+            return m_is_enabled.load(std::memory_order_relaxed);
+        }
+        /**
+         * @brief 启用或关闭记录
+         * @param is_enabled 是否启用
+         */
+        void set_enabled(bool is_enabled);
+        /**
+         * @brief 设置每个线程的记录容量
+         * @param capacity 记录条数
+         * @note 只影响之后新建的线程缓冲区。
+         */
+        void set_thread_capacity(std::size_t capacity);
+        /**
+         * @brief 记录跟踪点
+         * @param point 跟踪点
+         * @param connect_id 连接ID
+         * @param request_id 请求ID
+         * @param timestamp_ns 时间戳（由 now() 获得）
+         * @details 未启用时直接返回；线程缓冲区已满时丢弃并计数。
+         */
+        void record(TracePoint point, uint64_t connect_id, int64_t request_id, int64_t timestamp_ns);
+        /**
+         * @brief 以当前时间记录跟踪点
+         * @param point 跟踪点
+         * @param connect_id 连接ID
+         * @param request_id 请求ID
+         */
+        void record(TracePoint point, uint64_t connect_id, int64_t request_id);
+        /**
+         * @brief 收集所有线程已提交的记录
+         * @return 记录集合（按线程分组，线程内按记录顺序）
+         */
+        std::vector<TraceRecord> collect_records()const;
+        /**
+         * @brief 获取因缓冲区已满被丢弃的记录数
+         * @return 丢弃的记录数
+         */
+        uint64_t get_dropped_count()const;
+        /**
+         * @brief 以 Chrome trace JSON 格式输出
+         * @param output 输出流
+         * @details 每个请求输出一个异步事件轨道：外层为整个请求，内层每个阶段从上一个跟踪点持续到当前跟踪点，
+         *          以当前跟踪点命名；另在记录线程的轨道上输出各跟踪点的瞬时事件。
+         */
+        void write_chrome_trace(std::ostream& output)const;
+        /**
+         * @brief 以 Chrome trace JSON 格式写入文件
+         * @param path 文件路径
+         * @return 写入成功返回 true
+         */
+        bool dump_chrome_trace(const std::string& path)const;
+    private:
+        /**
+         * @struct ThreadBuffer
+         * @brief 线程记录缓冲区
+         * @details 单生产者追加写入，count 以 release 语义发布，读取方只读取 [0, count)。
+         */
+        struct ThreadBuffer
+        {
+            /// @brief 记录数组
+            std::unique_ptr<TraceRecord[]> records;
+            /// @brief 容量
+            std::size_t capacity = 0;
+            /// @brief 已提交的记录数
+            std::atomic<std::size_t> count = 0;
+            /// @brief 丢弃的记录数
+            std::atomic<uint64_t> dropped_count = 0;
+        };
+        /**
+         * @brief 构造函数
+         */
+        TraceRecorder() = default;
+        /**
+         * @brief 获取当前线程的缓冲区
+         * @return 线程缓冲区
+         */
+        ThreadBuffer& get_thread_buffer();
+    private:
+        /// @brief 是否启用
+        std::atomic<bool> m_is_enabled = false;
+        /// @brief 新建线程缓冲区的容量
+        std::atomic<std::size_t> m_thread_capacity = DEFAULT_THREAD_CAPACITY;
+        /// @brief 线程缓冲区表互斥锁
+        mutable std::mutex m_buffer_mutex;
+        /// @brief 所有线程缓冲区
+        std::vector<std::shared_ptr<ThreadBuffer>> m_buffers;
+        /// @brief 当前线程的缓冲区（由 m_buffers 持有）
+        static thread_local ThreadBuffer* t_thread_buffer;
+    };
+}
+
+/**
+ * @brief 记录跟踪点宏
+ * @param point 跟踪点名称（TracePoint 枚举值）
+ * @param connect_id 连接ID
+ * @param request_id 请求ID
+ * @details 未启用跟踪时不读取时钟。
+ */
+#define ADD_TRACE_POINT(point, connect_id, request_id)                               \
+  do {                                                                               \
+    auto &trace_recorder = DaneJoe::TraceRecorder::get_instance();                   \
+    if (trace_recorder.is_enabled()) {                                               \
+      trace_recorder.record(DaneJoe::TracePoint::point, connect_id, request_id);     \
+    }                                                                                \
+  } while (0)
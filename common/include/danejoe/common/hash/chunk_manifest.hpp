@@ -0,0 +1,93 @@
+/**
+ * @file chunk_manifest.hpp
+ * @author DaneJoe (danejoe001.github)
+ * @brief 文件分块哈希清单
+ * @version 0.2.0
+ * @date 2026-01-07
+ * @details 定义 ChunkManifest：文件按固定大小切分为块，每块计算 XXH64，
+ *          根哈希为全部块哈希（小端拼接）的 XXH64，构成两层哈希树。
+ *          接收方可对任意完整块独立校验，无需等待整个文件到达。
+ */
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <utility>
+#include <optional>
+
+ /**
+  * @namespace DaneJoe
+  * @brief DaneJoe 命名空间
+  */
+namespace DaneJoe
+{
+    /**
+     * @struct ChunkManifest
+     * @brief 文件分块哈希清单
+     */
+    struct ChunkManifest
+    {
+        /// @brief 默认块大小
+        static constexpr int64_t DEFAULT_CHUNK_SIZE = 1024 * 1024;
+        /// @brief 文件大小
+        int64_t file_size = 0;
+        /// @brief 块大小（最后一块可能不足）
+        int64_t chunk_size = 0;
+        /// @brief 各块的 XXH64
+        std::vector<uint64_t> chunk_hashes;
+        /**
+         * @brief 按文件大小与块大小计算的块数量
+         * @return 块数量，块大小无效时为 0
+         */
+        int64_t get_chunk_count() const;
+        /**
+         * @brief 清单是否完整
+         * @return 块大小有效且块哈希数量与文件大小相符时返回 true
+         */
+        bool is_valid() const;
+        /**
+         * @brief 获取块的字节范围
+         * @param index 块下标
+         * @return [begin, end)
+         */
+        std::pair<int64_t, int64_t> get_chunk_range(int64_t index) const;
+        /**
+         * @brief 校验单个块
+         * @param index 块下标
+         * @param data 块数据
+         * @param size 块数据字节数，必须等于该块的实际大小
+         * @return 是否一致
+         */
+        bool verify_chunk(int64_t index, const uint8_t* data, std::size_t size) const;
+        /**
+         * @brief 计算根哈希
+         * @return 块哈希小端拼接后的 XXH64
+         */
+        uint64_t get_root_hash() const;
+        /**
+         * @brief 编码块哈希
+         * @return 每块 8 字节小端
+         */
+        std::vector<uint8_t> get_hash_bytes() const;
+        /**
+         * @brief 解码块哈希
+         * @param bytes get_hash_bytes() 的输出
+         * @return 长度合法时返回 true
+         */
+        bool set_hash_bytes(const std::vector<uint8_t>& bytes);
+        /**
+         * @brief 多线程计算文件的分块哈希清单
+         * @param path 文件路径
+         * @param chunk_size 块大小
+         * @param thread_count 线程数，<=0 时使用硬件并发数
+         * @return 清单，文件无法读取时返回 std::nullopt
+         * @details 文件按块均分为连续的若干段，每个线程独立打开文件顺序读取自己的段。
+         */
+        static std::optional<ChunkManifest> build_from_file(
+            const std::string& path,
+            int64_t chunk_size = DEFAULT_CHUNK_SIZE,
+            int thread_count = 0);
+    };
+}
@@ -0,0 +1,86 @@
+/**
+ * @file md5.hpp
+ * @author DaneJoe (danejoe001.github)
+ * @brief MD5 增量摘要
+ * @version 0.2.0
+ * @date 2026-01-07
+ * @details 定义可分段输入、可导出/恢复中间状态的 Md5。
+ *          中间状态可持久化，进程重启后从上次已摘要的偏移继续，无需重读已处理的数据。
+ */
+#pragma once
+
+#include <array>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+ /**
+  * @namespace DaneJoe
+  * @brief DaneJoe 命名空间
+  */
+namespace DaneJoe
+{
+    /**
+     * @class Md5
+     * @brief MD5 增量摘要
+     */
+    class Md5
+    {
+    public:
+        /// @brief 摘要字节数
+        static constexpr std::size_t DIGEST_SIZE = 16;
+        /// @brief 摘要
+        using Digest = std::array<uint8_t, DIGEST_SIZE>;
+        /**
+         * @brief 构造初始状态
+         */
+        Md5();
+        /**
+         * @brief 输入数据
+         * @param data 数据指针
+         * @param size 字节数
+         */
+        void update(const uint8_t* data, std::size_t size);
+        /**
+         * @brief 获取已输入的字节数
+         * @return 字节数
+         */
+        uint64_t get_size() const;
+        /**
+         * @brief 计算摘要
+         * @return 摘要
+         * @details 不修改当前状态，之后仍可继续输入。
+         */
+        Digest get_digest() const;
+        /**
+         * @brief 计算摘要的小写十六进制字符串
+         * @return 十六进制字符串
+         */
+        std::string get_hex_digest() const;
+        /**
+         * @brief 导出中间状态
+         * @return 状态字节（字节序固定为小端）
+         */
+        std::vector<uint8_t> save_state() const;
+        /**
+         * @brief 恢复中间状态
+         * @param state save_state() 导出的状态字节
+         * @return 是否成功（失败时保持原状态）
+         */
+        bool load_state(const std::vector<uint8_t>& state);
+    private:
+        /**
+         * @brief 处理一个 64 字节分组
+         * @param block 分组
+         */
+        void process_block(const uint8_t* block);
+    private:
+        /// @brief 链接变量 A/B/C/D
+        std::array<uint32_t, 4> m_state;
+        /// @brief 已输入字节数
+        uint64_t m_size = 0;
+        /// @brief 未满一个分组的缓存
+        std::array<uint8_t, 64> m_buffer = {};
+    };
+}
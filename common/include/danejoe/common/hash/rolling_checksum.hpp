@@ -0,0 +1,68 @@
+/**
+ * @file rolling_checksum.hpp
+ * @author DaneJoe (danejoe001.github)
+ * @brief 滚动校验和
+ * @version 0.2.0
+ * @date 2026-01-08
+ * @details 实现 rsync 使用的弱校验和：a 为窗口字节和，b 为按位置加权的字节和，各取低 16 位。
+ *          窗口向后滑动一个字节时可由移出与移入的字节在 O(1) 内更新，用于在任意偏移上查找已知块。
+ */
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+ /**
+  * @namespace DaneJoe
+  * @brief DaneJoe 命名空间
+  */
+namespace DaneJoe
+{
+    /**
+     * @class RollingChecksum
+     * @brief 滚动校验和
+     */
+    class RollingChecksum
+    {
+    public:
+        /**
+         * @brief 以数据初始化窗口
+         * @param data 窗口数据
+         * @param size 窗口长度
+         */
+        void reset(const uint8_t* data, std::size_t size);
+        /**
+         * @brief 窗口后移一个字节
+         * @param out_byte 移出窗口的字节
+         * @param in_byte 移入窗口的字节
+         * @note 位于匹配的内层循环，定义在头文件中以便内联
+         */
+        void roll(uint8_t out_byte, uint8_t in_byte)
+        {
+            m_a += static_cast<uint32_t>(in_byte) - static_cast<uint32_t>(out_byte);
+            m_b += m_a - static_cast<uint32_t>(m_size) * static_cast<uint32_t>(out_byte);
+        }
+        /**
+         * @brief 获取校验和
+         * @return (b << 16) | a
+         */
+        uint32_t get_value()const
+        {
+            return ((m_b & 0xffff) << 16) | (m_a & 0xffff);
+        }
+        /**
+         * @brief 计算数据的校验和
+         * @param data 数据
+         * @param size 长度
+         * @return 校验和
+         */
+        static uint32_t compute(const uint8_t* data, std::size_t size);
+    private:
+        /// @brief 字节和
+        uint32_t m_a = 0;
+        /// @brief 加权字节和
+        uint32_t m_b = 0;
+        /// @brief 窗口长度
+        std::size_t m_size = 0;
+    };
+}
@@ -0,0 +1,29 @@
+/**
+ * @file xxhash64.hpp
+ * @author DaneJoe (danejoe001.github)
+ * @brief XXH64 非加密哈希
+ * @version 0.2.0
+ * @date 2026-01-07
+ * @details 实现 XXH64 算法，四路并行累加，单核吞吐远高于 MD5，
+ *          用于分块完整性校验（防传输/存储损坏，不防篡改）。
+ */
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+ /**
+  * @namespace DaneJoe
+  * @brief DaneJoe 命名空间
+  */
+namespace DaneJoe
+{
+    /**
+     * @brief 计算 XXH64 哈希
+     * @param data 数据指针
+     * @param size 字节数
+     * @param seed 种子
+     * @return 64 位哈希值（与参考实现一致）
+     */
+    uint64_t xxhash64(const uint8_t* data, std::size_t size, uint64_t seed = 0);
+}
@@ -0,0 +1,256 @@
+/**
+ * @file positional_file_writer.hpp
+ * @author DaneJoe (danejoe001.github)
+ * @brief 定位批量文件写入器
+ * @version 0.2.0
+ * @date 2026-01-06
+ * @details 定义在独立线程上执行文件写入的 PositionalFileWriter。
+ *          调用方提交（文件，偏移，数据）写任务后立即返回，写线程负责：
+ *          - 以 pwrite/pwritev 按偏移写入，不依赖文件位置指针
+ *          - 合并一批任务中偏移相邻的数据为一次 pwritev
+ *          - 仅在检查点（累计写入达到阈值、显式同步或关闭文件）执行 fdatasync
+ *          - 可选地以 MD5 增量摘要文件的连续前缀，写入完成的数据直接喂给摘要，不回读磁盘
+ *          打开文件时若已知文件大小，会预先以 fallocate 分配空间。
+ */
+#pragma once
+
+#include <map>
+#include <deque>
+#include <mutex>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <cstdint>
+#include <optional>
+#include <functional>
+#include <unordered_map>
+#include <condition_variable>
+
+#include "danejoe/common/type_traits/platform_traits.hpp"
+#include "danejoe/common/handle/unique_handle.hpp"
+#include "danejoe/common/hash/md5.hpp"
+
+ /**
+  * @namespace DaneJoe
+  * @brief DaneJoe 命名空间
+  */
+namespace DaneJoe
+{
+#if DANEJOE_PLATFORM_LINUX==1
+    /**
+     * @struct PositionalWriterConfig
+     * @brief 定位写入器配置
+     */
+    struct PositionalWriterConfig
+    {
+        /// @brief 自上次同步起累计写入达到该字节数时执行 fdatasync，<=0 表示仅在显式同步/关闭时同步
+        int64_t sync_interval_bytes = 64 * 1024 * 1024;
+        /// @brief 单次 pwritev 合并的最大字节数
+        int64_t max_coalesce_bytes = 8 * 1024 * 1024;
+        /// @brief 单次 pwritev 合并的最大数据段数
+        int max_coalesce_segments = 64;
+        /// @brief 摘要等待前缀补齐时在内存中保留的乱序数据上限，超出部分改为前缀到达时从文件读取
+        int64_t max_digest_pending_bytes = 256 * 1024 * 1024;
+    };
+    /**
+     * @struct FileDigest
+     * @brief 文件前缀摘要的初始状态
+     */
+    struct FileDigest
+    {
+        /// @brief 已摘要到的状态，已摘要字节数即摘要前缀的结束偏移
+        Md5 md5;
+        /// @brief 摘要前缀之后已在文件中的 [begin, end) 区间（续传时的已落盘数据），前缀到达时从文件读取
+        std::vector<std::pair<int64_t, int64_t>> written_ranges;
+    };
+    /**
+     * @class PositionalFileWriter
+     * @brief 定位批量文件写入器
+     * @details 所有写入、同步与关闭都在内部写线程上按提交顺序处理；
+     *          完成回调在写线程上执行，调用方需自行投递回所属线程。
+     * @note 同一批次内的写任务会按偏移重排以便合并，调用方不应提交偏移重叠的写任务。
+     */
+    class PositionalFileWriter
+    {
+    public:
+        /**
+         * @brief 写完成回调
+         * @param is_success 是否写入（或同步、关闭）成功
+         */
+        using Callback = std::function<void(bool is_success)>;
+        /**
+         * @brief 检查点回调
+         * @param is_success 是否同步成功
+         * @param md5 同步时的前缀摘要状态，未启用摘要时为空
+         */
+        using CheckpointCallback = std::function<void(bool is_success, std::optional<Md5> md5)>;
+        /**
+         * @brief 构造并启动写线程
+         * @param config 写入器配置
+         */
+        PositionalFileWriter(const PositionalWriterConfig& config = PositionalWriterConfig());
+        /**
+         * @brief 析构
+         * @details 处理完已提交的任务并关闭所有文件后停止写线程。
+         */
+        ~PositionalFileWriter();
+        PositionalFileWriter(const PositionalFileWriter&) = delete;
+        PositionalFileWriter& operator=(const PositionalFileWriter&) = delete;
+        /**
+         * @brief 打开（或创建）文件
+         * @param path 文件路径
+         * @param file_size 文件大小，>0 时预分配空间
+         * @param digest 前缀摘要初始状态，为空时不计算摘要
+         * @return 文件ID，失败返回 std::nullopt
+         * @details 在调用线程上同步执行；文件不会被截断，以便续传已有数据。
+         */
+        std::optional<uint64_t> open_file(const std::string& path, int64_t file_size = -1, std::optional<FileDigest> digest = std::nullopt);
+        /**
+         * @brief 提交写任务
+         * @param file_id 文件ID
+         * @param offset 写入偏移
+         * @param data 待写入数据（移动接管）
+         * @param callback 完成回调，可为空
+         */
+        void write(uint64_t file_id, int64_t offset, std::vector<uint8_t> data, Callback callback = nullptr);
+        /**
+         * @brief 提交同步检查点
+         * @param file_id 文件ID
+         * @param callback 此前提交的写任务全部落盘后回调，可为空
+         */
+        void sync(uint64_t file_id, Callback callback = nullptr);
+        /**
+         * @brief 提交带摘要快照的同步检查点
+         * @param file_id 文件ID
+         * @param callback 此前提交的写任务全部落盘后回调，附带此时的前缀摘要状态
+         * @details 摘要只覆盖已写入的数据，且在同步之后取快照，因此快照覆盖的前缀必然已经落盘。
+         */
+        void checkpoint(uint64_t file_id, CheckpointCallback callback);
+        /**
+         * @brief 提交关闭文件
+         * @param file_id 文件ID
+         * @param callback 同步并关闭后回调，可为空
+         * @details 关闭前执行一次同步；之后该文件ID上的写任务均失败。
+         */
+        void close_file(uint64_t file_id, Callback callback = nullptr);
+        /**
+         * @brief 提交区间失效
+         * @param file_id 文件ID
+         * @param begin 起始偏移
+         * @param end 结束偏移（不含）
+         * @param callback 处理后回调，可为空
+         * @details 文件中该区间的数据已确认无效，将被重新写入：前缀摘要不再使用已写入的该区间数据；
+         *          若摘要前缀已覆盖该区间，则摘要从头重算，其余已写入部分在前缀到达时从文件读取。
+         */
+        void invalidate_range(uint64_t file_id, int64_t begin, int64_t end, Callback callback = nullptr);
+    private:
+        /**
+         * @enum JobType
+         * @brief 写线程任务类型
+         */
+        enum class JobType
+        {
+            Write,
+            Sync,
+            Checkpoint,
+            Close,
+            Invalidate
+        };
+        /**
+         * @struct Job
+         * @brief 写线程任务
+         */
+        struct Job
+        {
+            JobType type = JobType::Write;
+            uint64_t file_id = 0;
+            int64_t offset = 0;
+            /// @brief 失效区间的结束偏移（仅 Invalidate）
+            int64_t end_offset = 0;
+            std::vector<uint8_t> data;
+            Callback callback;
+            CheckpointCallback checkpoint_callback;
+        };
+        /**
+         * @struct OpenedFile
+         * @brief 写线程持有的文件状态
+         */
+        struct OpenedFile
+        {
+            UniqueHandle<int> handle;
+            int64_t unsynced_bytes = 0;
+            bool is_failed = false;
+            /// @brief 前缀摘要，未启用时为空
+            std::optional<Md5> md5;
+            /// @brief 已写入、等待前缀到达的乱序数据（key: 偏移）
+            std::map<int64_t, std::vector<uint8_t>> pending_data;
+            /// @brief pending_data 的总字节数
+            int64_t pending_bytes = 0;
+            /// @brief 已写入但不在内存中、等待前缀到达时从文件读取的区间（key: 起始偏移，value: 结束偏移）
+            std::map<int64_t, int64_t> pending_ranges;
+        };
+        /**
+         * @brief 写线程主循环
+         */
+        void run();
+        /**
+         * @brief 处理一批任务
+         * @param jobs 任务批次
+         * @details 连续的写任务按文件与偏移排序后合并写入，同步/关闭任务作为屏障保持提交顺序。
+         */
+        void process_jobs(std::vector<Job>& jobs);
+        /**
+         * @brief 合并并写入一段连续的写任务
+         * @param jobs 任务批次
+         * @param begin 起始下标
+         * @param end 结束下标（不含）
+         */
+        void write_jobs(std::vector<Job>& jobs, std::size_t begin, std::size_t end);
+        /**
+         * @brief 将写入成功的数据交给前缀摘要
+         * @param file 文件状态
+         * @param offset 数据偏移
+         * @param data 数据（位于前缀处时直接摘要，否则暂存）
+         */
+        void digest_data(OpenedFile& file, int64_t offset, std::vector<uint8_t>& data);
+        /**
+         * @brief 推进前缀摘要
+         * @param file 文件状态
+         * @details 依次消费紧接前缀的暂存数据或待读取区间，直到遇到空洞。
+         */
+        void advance_digest(OpenedFile& file);
+        /**
+         * @brief 使前缀摘要不再使用区间 [begin, end) 上已写入的数据
+         * @param file 文件状态
+         * @param begin 起始偏移
+         * @param end 结束偏移（不含）
+         */
+        void invalidate_digest(OpenedFile& file, int64_t begin, int64_t end);
+        /**
+         * @brief 同步文件
+         * @param file 文件状态
+         * @return 是否成功
+         */
+        bool sync_file(OpenedFile& file);
+    private:
+        /// @brief 写入器配置
+        PositionalWriterConfig m_config;
+        /// @brief 文件ID生成
+        std::atomic<uint64_t> m_file_id_counter = 0;
+        /// @brief 保护任务队列与文件表
+        std::mutex m_mutex;
+        /// @brief 任务队列条件变量
+        std::condition_variable m_condition;
+        /// @brief 待处理任务队列
+        std::deque<Job> m_jobs;
+        /// @brief 已打开文件（key: 文件ID）
+        std::unordered_map<uint64_t, OpenedFile> m_files;
+        /// @brief 是否运行
+        bool m_is_running = true;
+        /// @brief 写线程
+        std::thread m_thread;
+    };
+#endif
+}
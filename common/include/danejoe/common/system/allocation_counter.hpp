@@ -0,0 +1,28 @@
+/**
+ * @file allocation_counter.hpp
+ * @brief 进程级内存分配计数
+ * @author DaneJoe001
+ * @version 0.2.0
+ * @date 2026-01-11
+ * @details 实现文件替换了全局 operator new/delete，每次分配计数一次。
+ *          该编译单元单独构建为 ProjectTransCommonAllocationCounter 库，不在 ProjectTransCommonDaneJoe 中：
+ *          只有显式链接该库的程序才会替换分配函数，其余程序仍使用默认实现，不受影响。
+ *          用于基准测试统计每个请求的分配次数。
+ */
+#pragma once
+
+#include <cstdint>
+
+ /**
+  * @namespace DaneJoe
+  * @brief DaneJoe命名空间
+  */
+namespace DaneJoe
+{
+    /**
+     * @brief 获取进程启动以来经 operator new 分配的次数
+     * @return 分配次数，非 Linux 平台恒为 0
+     * @note 计数使用 relaxed 原子操作，跨线程读取时只保证最终一致。
+     */
+    uint64_t get_allocation_count();
+};
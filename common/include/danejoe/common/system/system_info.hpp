@@ -18,4 +18,10 @@ namespace DaneJoe
      * @return 进程ID
      */
     int get_process_id();
+    /**
+     * @brief 获取当前线程的系统线程ID
+     * @return 线程ID（Linux 下为 gettid() 的结果，与 top/perf 中显示的一致）
+     * @note 结果按线程缓存，重复调用不再进入内核。
+     */
+    int get_thread_id();
 };
@@ -7,11 +7,13 @@
  * @details 提供统一的定时任务与周期任务调度。
  *          定时任务使用 std::chrono::steady_clock 作为时间基准（避免系统时间跳变影响）。
  *          回调默认在内部任务线程中执行，也可通过 set_execute_environment() 注入自定义执行环境。
+ *          内部以 1 ms 为刻度的分层时间轮组织定时任务，添加与取消均为 O(1)，
+ *          同一刻度到期的任务在一次加锁内批量取出后统一执行。
  */
 #pragma once
 
-#include <map>
-#include <deque>
+#include <array>
+#include <vector>
 #include <thread>
 #include <mutex>
 #include <atomic>
@@ -27,6 +29,25 @@
   */
 namespace DaneJoe
 {
+    /**
+     * @struct TimerHandle
+     * @brief 定时任务句柄
+     * @details 由 add_task_until()/add_task_for() 返回，用于 cancel()。
+     *          句柄带有代数，任务到期或被取消后其槽位可能被复用，旧句柄不会误取消新任务。
+     */
+    struct TimerHandle
+    {
+        /// @brief 任务节点下标
+        uint32_t index = UINT32_MAX;
+        /// @brief 节点代数
+        uint32_t generation = 0;
+        /**
+         * @brief 是否指向过某个任务
+         * @return 默认构造的句柄返回 false
+         * @note 返回 true 不代表任务仍未到期
+         */
+        bool is_valid()const;
+    };
     /**
      * @struct PeriodicTask
      * @brief 周期任务
@@ -41,6 +62,8 @@ namespace DaneJoe
         std::function<void()> callback;
         /// @brief 剩余执行次数,-1表示无限次
         int64_t remain_times;
+        /// @brief 下一轮触发的定时任务句柄
+        TimerHandle timer_handle;
     };
     /**
      * @class TimerManager
@@ -75,20 +98,31 @@ namespace DaneJoe
          * @brief 添加任务直到指定时间
          * @param time 指定时间
          * @param callback 回调函数
+         * @return 任务句柄
          * @details 任务将被调度至 time 时刻触发；触发后回调将通过当前执行环境执行。
+         *          触发精度为 1 ms，不会早于 time 触发。
          */
-        void add_task_until(
+        TimerHandle add_task_until(
             const std::chrono::steady_clock::time_point& time,
             std::function<void()> callback);
         /**
          * @brief 添加任务直到指定时长
          * @param time 指定时长
          * @param callback 回调函数
+         * @return 任务句柄
          * @details 任务将被调度至“当前 steady 时间 + time”时触发；触发后回调将通过当前执行环境执行。
          */
-        void add_task_for(
+        TimerHandle add_task_for(
             const std::chrono::steady_clock::duration& time,
             std::function<void()> callback);
+        /**
+         * @brief 取消定时任务
+         * @param handle 任务句柄
+         * @return 任务尚未到期且被成功取消时返回 true
+         * @details 取消后回调立即析构，其捕获的资源随之释放。
+         *          已到期的任务（包括正在执行中的）返回 false。
+         */
+        bool cancel(const TimerHandle& handle);
         /**
          * @brief 添加周期任务
          * @param time 周期时长
@@ -113,6 +147,86 @@ namespace DaneJoe
          */
         void set_execute_environment(std::function<void(std::function<void()>)> execute_environment);
     private:
+        /**
+         * @struct TimerNode
+         * @brief 时间轮中的任务节点
+         * @details 节点存放在 m_timer_nodes 中，以下标串成各槽位的双向链表，空闲节点串成空闲链表。
+         */
+        struct TimerNode
+        {
+            /// @brief 回调函数
+            std::function<void()> callback;
+            /// @brief 到期刻度
+            uint64_t expire_tick = 0;
+            /// @brief 前驱节点下标
+            uint32_t prev = UINT32_MAX;
+            /// @brief 后继节点下标（空闲节点中指向下一个空闲节点）
+            uint32_t next = UINT32_MAX;
+            /// @brief 所在槽位，UINT32_MAX 表示空闲
+            uint32_t slot = UINT32_MAX;
+            /// @brief 节点代数，每次释放递增
+            uint32_t generation = 0;
+        };
+        /// @brief 刻度时长
+        static constexpr std::chrono::milliseconds TICK_DURATION{ 1 };
+        /// @brief 第 0 层槽位数（位数）
+        static constexpr uint32_t LEVEL0_BITS = 8;
+        /// @brief 第 1~3 层槽位数（位数）
+        static constexpr uint32_t LEVELN_BITS = 6;
+        /// @brief 上层数量
+        static constexpr uint32_t UPPER_LEVEL_COUNT = 3;
+        /// @brief 第 0 层槽位数
+        static constexpr uint32_t LEVEL0_SIZE = 1u << LEVEL0_BITS;
+        /// @brief 第 1~3 层每层槽位数
+        static constexpr uint32_t LEVELN_SIZE = 1u << LEVELN_BITS;
+        /// @brief 槽位总数
+        static constexpr uint32_t SLOT_COUNT = LEVEL0_SIZE + UPPER_LEVEL_COUNT * LEVELN_SIZE;
+        /// @brief 时间轮可直接表示的最大相对刻度，更远的任务先放在最高层，到时重新分配
+        static constexpr uint64_t MAX_WHEEL_TICKS = (1ull << (LEVEL0_BITS + UPPER_LEVEL_COUNT * LEVELN_BITS)) - 1;
+        /// @brief 无效下标
+        static constexpr uint32_t INVALID_INDEX = UINT32_MAX;
+        /**
+         * @brief 时间点转换为刻度（向上取整）
+         * @param time 时间点
+         * @return 刻度
+         */
+        uint64_t to_tick(const std::chrono::steady_clock::time_point& time)const;
+        /**
+         * @brief 按到期刻度将节点挂入槽位
+         * @param index 节点下标
+         * @note 调用方需持有 m_task_queue_mutex
+         */
+        void link_node(uint32_t index);
+        /**
+         * @brief 将节点从所在槽位摘下
+         * @param index 节点下标
+         * @note 调用方需持有 m_task_queue_mutex
+         */
+        void unlink_node(uint32_t index);
+        /**
+         * @brief 释放节点到空闲链表
+         * @param index 节点下标
+         * @note 调用方需持有 m_task_queue_mutex
+         */
+        void free_node(uint32_t index);
+        /**
+         * @brief 将上层槽位中的节点按当前刻度重新分配到下层
+         * @param slot 槽位
+         * @note 调用方需持有 m_task_queue_mutex
+         */
+        void cascade_slot(uint32_t slot);
+        /**
+         * @brief 推进一个刻度，取出到期回调
+         * @param expired_callbacks 到期回调输出
+         * @note 调用方需持有 m_task_queue_mutex
+         */
+        void advance_tick(std::vector<std::function<void()>>& expired_callbacks);
+        /**
+         * @brief 计算下次需要唤醒的刻度
+         * @return 刻度，没有任务时返回 UINT64_MAX
+         * @note 调用方需持有 m_task_queue_mutex
+         */
+        uint64_t get_next_wake_tick()const;
         /**
          * @brief 执行周期任务
          * @param task_id 任务ID
@@ -159,12 +273,22 @@ namespace DaneJoe
         std::mutex m_task_queue_mutex;
         /// @brief 任务队列条件变量，用于处理任务队列
         std::condition_variable m_task_queue_condition;
-        /// @brief 定时器回调队列，用于处理定时任务
-        std::multimap<std::chrono::steady_clock::time_point, std::function<void()>> m_timer_callbacks;
+        /// @brief 刻度零点
+        std::chrono::steady_clock::time_point m_start_time;
+        /// @brief 下一个待处理的刻度
+        uint64_t m_current_tick = 0;
+        /// @brief 任务线程计划唤醒的刻度，新任务更早到期时需唤醒任务线程
+        uint64_t m_planned_wake_tick = UINT64_MAX;
+        /// @brief 时间轮中的任务数
+        std::size_t m_timer_count = 0;
+        /// @brief 各槽位链表头，前 LEVEL0_SIZE 个为第 0 层
+        std::array<uint32_t, SLOT_COUNT> m_slot_heads;
+        /// @brief 任务节点池
+        std::vector<TimerNode> m_timer_nodes;
+        /// @brief 空闲节点链表头
+        uint32_t m_free_node_head = INVALID_INDEX;
         /// @brief 任务线程，用于处理任务
         std::thread m_task_thread;
-        /// @brief 任务队列，用于处理任务
-        std::deque<std::function<void()>> m_task_queue;
         /// @brief 执行环境，用于处理任务
         std::function<void(std::function<void()>)> m_execute_environment;
     };
@@ -5,15 +5,18 @@
  * @version 0.2.0
  * @date 2025-12-17
  * @details 定义 AsyncLogger，一个基于后台线程的异步日志器实现。
- *          log_msg() 将日志写入内部队列，并由后台线程负责输出到文件/控制台。
+ *          异步模式下每个写日志的线程拥有独立的二进制记录缓冲区，写入时不加锁、不格式化；
+ *          后台线程轮流取空各缓冲区，按时间戳排序后格式化，并对控制台与文件各做一次批量写入。
  */
 #pragma once
 
-#include <fstream>
-#include <thread>
-#include <queue>
 #include <mutex>
 #include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <cstdint>
+#include <fstream>
 #include <condition_variable>
 
 #include "danejoe/logger/i_logger.hpp"
@@ -27,10 +30,13 @@ namespace DaneJoe
     /**
      * @class AsyncLogger
      * @brief 异步日志器
-     * @details 通过队列与后台线程实现异步写日志。
-     *          - 文件日志与控制台日志分别由独立线程处理
-     *          - stop_async_log() 用于通知后台线程退出，并应唤醒等待中的线程
-     * @note 线程安全性取决于实现对队列与输出资源的同步策略；通常允许多线程并发调用 log_msg()。
+     * @details 异步模式（LoggerConfig::enable_async）下：
+     *          - 生产者线程首次写日志时创建容量为 thread_buffer_size 的记录缓冲区并登记到日志器，线程退出时标记废弃；
+     *          - 缓冲区满时生产者唤醒后台线程并等待，不丢弃日志；单条超过缓冲区一半的记录退化为同步输出；
+     *          - 后台线程空闲时每 10ms 轮询一次，每轮写完后刷新控制台；
+     *            文件在出现不低于 flush_level 的日志或距上次刷新超过 flush_interval_ms 时刷新。
+     *          同步模式下 log_msg() 在调用线程上直接输出。
+     * @note 允许多线程并发写日志；析构时会输出所有已写入缓冲区的日志。
      */
     class AsyncLogger : public ILogger
     {
@@ -42,7 +48,7 @@ namespace DaneJoe
         AsyncLogger();
         /**
          * @brief 析构函数
-         * @details 析构时应停止后台线程并回收资源。
+         * @details 停止后台线程，停止前取空所有记录缓冲区。
          */
         ~AsyncLogger();
         /**
@@ -52,6 +58,17 @@ namespace DaneJoe
          */
         AsyncLogger(const LoggerConfig& config);
     protected:
+        /**
+         * @brief 获取当前线程的记录缓冲区
+         * @return 记录缓冲区，未启用异步或后台已停止时返回 nullptr
+         */
+        LogRecordBuffer* get_record_buffer()override;
+        /**
+         * @brief 唤醒后台线程并短暂等待
+         * @param buffer 已满的记录缓冲区
+         * @return 后台线程是否仍在运行
+         */
+        bool wait_record_buffer(LogRecordBuffer& buffer)override;
         /**
          * @brief 日志消息
          * @param level 日志级别
@@ -62,7 +79,7 @@ namespace DaneJoe
          * @param line_num 行号
          * @param process_id 进程ID
          * @param thread_id 线程ID
-         * @details 将日志格式化后写入内部队列，由后台线程异步输出。
+         * @details 在调用线程上格式化并直接输出（同步模式，或记录无法写入缓冲区时）。
          */
         virtual void log_msg(LogLevel level,
             const std::string& module,
@@ -73,14 +90,29 @@ namespace DaneJoe
             int process_id = -1,
             const std::string& thread_id = "")override;
     private:
+        /**
+         * @struct PendingLine
+         * @brief 本轮已格式化、待输出的日志行
+         */
+        struct PendingLine
+        {
+            /// @brief 记录时间（纳秒）
+            int64_t timestamp = 0;
+            /// @brief 日志级别
+            LogLevel level = LogLevel::INFO;
+            /// @brief 在行缓冲中的偏移
+            std::size_t offset = 0;
+            /// @brief 行长度
+            std::size_t size = 0;
+        };
         /**
          * @brief 启动异步日志
-         * @details 启动后台线程与相关资源。
+         * @details 启动后台线程。
          */
         void start_async_log();
         /**
          * @brief 停止异步日志
-         * @details 通知后台线程退出，并唤醒等待中的线程。
+         * @details 通知后台线程取空缓冲区后退出，并等待其结束。
          */
         void stop_async_log();
         /**
@@ -90,45 +122,66 @@ namespace DaneJoe
          */
         bool open_log_file();
         /**
-         * @brief 异步文件日志处理
-         * @details 后台线程循环从文件日志队列中取出消息并写入文件。
+         * @brief 后台线程主循环
+         */
+        void async_log_handler();
+        /**
+         * @brief 取出各缓冲区中的记录并输出
+         * @return 本轮处理的记录数
+         */
+        std::size_t drain_buffers();
+        /**
+         * @brief 同步登记表到后台私有列表，并移除已取空的废弃缓冲区
+         */
+        void refresh_drain_buffers();
+        /**
+         * @brief 将本轮日志行按时间排序后批量写入控制台与文件
          */
-        void async_file_log_handler();
+        void write_pending_lines();
         /**
-         * @brief 异步控制台日志处理
-         * @details 后台线程循环从控制台日志队列中取出消息并输出到控制台。
+         * @brief 按刷新策略刷新日志文件
+         * @param is_forced 是否强制刷新
          */
-        void async_console_log_handler();
+        void flush_log_file(bool is_forced);
     private:
-        /// @brief 异步文件日志标志
-        std::atomic<bool> m_async_file_log_flag = false;
-        /// @brief 异步控制台日志标志
-        std::atomic<bool> m_async_console_log_flag = false;
-        /// @brief 控制台互斥锁
-        std::mutex m_console_mutex;
-        /// @brief 文件互斥锁
-        std::mutex m_file_mutex;
+        /// @brief 日志器编号，用于区分线程缓存中属于不同日志器的缓冲区
+        uint64_t m_logger_id = 0;
+        /// @brief 后台线程是否运行
+        std::atomic<bool> m_is_running = false;
+        /// @brief 输出互斥锁（后台线程与同步输出共用）
+        std::mutex m_output_mutex;
         /// @brief 日志文件
         std::ofstream m_log_file;
-        /// @brief 调用栈
-        std::queue<std::string> m_call_stack;
-        /// @brief 文件日志队列互斥锁
-        std::mutex m_file_log_queue_mutex;
-        /// @brief 控制台日志队列互斥锁
-        std::mutex m_console_log_queue_mutex;
-        /// @brief 文件日志队列
-        std::queue<std::string> m_file_log_queue;
-        /// @brief 控制台日志队列
-        std::queue<std::string> m_console_log_queue;
-        /// @brief 异步文件日志线程
-        std::thread m_async_file_log_thread;
-        /// @brief 异步控制台日志线程
-        std::thread m_async_console_log_thread;
-        /// @brief 文件日志队列条件变量
-        std::condition_variable m_file_log_queue_cond;
-        /// @brief 控制台日志队列条件变量
-        std::condition_variable m_console_log_queue_cond;
-
+        /// @brief 日志文件是否有未刷新的内容
+        bool m_is_file_dirty = false;
+        /// @brief 上次刷新日志文件的时间
+        std::chrono::steady_clock::time_point m_last_flush_time;
+        /// @brief 登记表互斥锁
+        std::mutex m_buffer_mutex;
+        /// @brief 已登记的记录缓冲区
+        std::vector<std::shared_ptr<LogRecordBuffer>> m_buffers;
+        /// @brief 登记表版本，登记表变化时递增
+        std::atomic<uint64_t> m_buffer_version = 0;
+        /// @brief 后台线程私有的缓冲区列表
+        std::vector<std::shared_ptr<LogRecordBuffer>> m_drain_buffers;
+        /// @brief 后台线程私有列表对应的登记表版本
+        uint64_t m_drain_version = 0;
+        /// @brief 本轮格式化的日志行
+        std::string m_line_arena;
+        /// @brief 本轮日志行索引
+        std::vector<PendingLine> m_pending_lines;
+        /// @brief 控制台批量输出缓冲
+        std::string m_console_batch;
+        /// @brief 文件批量输出缓冲
+        std::string m_file_batch;
+        /// @brief 唤醒互斥锁
+        std::mutex m_wakeup_mutex;
+        /// @brief 唤醒条件变量
+        std::condition_variable m_wakeup_cond;
+        /// @brief 是否有生产者请求唤醒
+        std::atomic<bool> m_is_wakeup_requested = false;
+        /// @brief 后台线程
+        std::thread m_async_log_thread;
     };
     /**
      * @class DaneJoeLoggerCreator
@@ -2,7 +2,8 @@
  * @file i_logger.hpp
  * @brief 日志接口类头文件
  * @details 定义日志抽象接口 ILogger 及日志创建器接口 ILoggerCreator。
- *          ILogger 提供 trace/debug/info/warn/error/fatal 等便捷模板接口，用于格式化日志内容并委托给 log_msg()。
+ *          ILogger 提供 trace/debug/info/warn/error/fatal 等便捷模板接口：
+ *          派生类提供线程记录缓冲区时以二进制记录写入缓冲区，否则格式化日志内容并委托给 log_msg()。
  *          具体日志输出方式（同步/异步、文件/控制台等）由派生类实现。
  * @author DaneJoe001
  * @version 0.2.0
@@ -10,12 +11,17 @@
  */
 #pragma once
 
+#include <atomic>
+#include <chrono>
 #include <format>
 #include <string>
 #include <thread>
 #include <memory>
+#include <string_view>
 
 #include "danejoe/logger/logger_config.hpp"
+#include "danejoe/logger/log_record.hpp"
+#include "danejoe/common/system/system_info.hpp"
 
  /**
   * @namespace DaneJoe
@@ -27,8 +33,8 @@ namespace DaneJoe
      * @class ILogger
      * @brief 日志接口类
      * @details 提供统一日志接口与通用格式化能力。
-     *          trace/debug/info/warn/error/fatal 负责格式化消息与收集元信息（文件/函数/行号、进程/线程 ID），
-     *          并最终调用 log_msg() 交由具体实现输出。
+     *          trace/debug/info/warn/error/fatal 负责收集元信息（文件/函数/行号、进程/线程 ID），
+     *          并写入 get_record_buffer() 提供的记录缓冲区，或格式化后调用 log_msg() 交由具体实现输出。
      * @note 线程安全性由具体实现决定；通常期望允许多线程并发调用日志接口。
      */
     class ILogger
@@ -44,32 +50,90 @@ namespace DaneJoe
          */
         ILogger(LoggerConfig config);
         /**
-         * @brief 跟踪级别日志
+         * @brief 记录日志
          * @tparam Args 可变参数类型
+         * @param level 日志级别
          * @param module 模块名称
          * @param file_name 文件名称
          * @param function_name 函数名称
          * @param line_num 行号
          * @param fmt 格式化字符串
          * @param args 可变参数
+         * @details 低于所有输出目标级别的日志直接丢弃。
+         *          派生类提供记录缓冲区时，仅将参数按二进制写入缓冲区，格式化由派生类在后台完成；
+         *          否则（或缓冲区无法容纳该记录时）在调用线程上格式化并交给 log_msg()。
          */
         template<typename... Args>
-        void trace(const std::string& module,
-            const std::string& file_name,
-            const std::string& function_name,
+        void log(LogLevel level,
+            std::string_view module,
+            std::string_view file_name,
+            std::string_view function_name,
             int line_num,
             std::format_string<Args...> fmt,
             Args&&... args)
         {
+            if (!is_enabled(level))
+            {
+                return;
+            }
+            LogRecordBuffer* buffer = get_record_buffer();
+            if (buffer)
+            {
+                LogRecordHeader header;
+                header.thread_id = get_thread_id();
+                header.timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::system_clock::now().time_since_epoch()).count();
+                header.line_num = line_num;
+                header.level = level;
+                if (write_record(*buffer,
+                    header,
+                    fmt.get(),
+                    module,
+                    m_output_setting.enable_file_name ? file_name : std::string_view(),
+                    m_output_setting.enable_function_name ? function_name : std::string_view(),
+                    LogRecordCodec::to_storage(args)...))
+                {
+                    return;
+                }
+            }
             std::string log_info = std::format(fmt, std::forward<Args>(args)...);
-            log_msg(LogLevel::TRACE,
-                module,
+            log_msg(level,
+                std::string(module),
                 log_info,
-                file_name,
-                function_name,
+                std::string(file_name),
+                std::string(function_name),
                 line_num,
                 get_pid(),
-                to_string(std::this_thread::get_id()));
+                std::to_string(get_thread_id()));
+        }
+        /**
+         * @brief 是否会输出该级别的日志
+         * @param level 日志级别
+         * @return 是否会输出
+         */
+        bool is_enabled(LogLevel level)const
+        {
+            return level >= m_min_level.load(std::memory_order_relaxed);
+        }
+        /**
+         * @brief 跟踪级别日志
+         * @tparam Args 可变参数类型
+         * @param module 模块名称
+         * @param file_name 文件名称
+         * @param function_name 函数名称
+         * @param line_num 行号
+         * @param fmt 格式化字符串
+         * @param args 可变参数
+         */
+        template<typename... Args>
+        void trace(std::string_view module,
+            std::string_view file_name,
+            std::string_view function_name,
+            int line_num,
+            std::format_string<Args...> fmt,
+            Args&&... args)
+        {
+            log(LogLevel::TRACE, module, file_name, function_name, line_num, fmt, std::forward<Args>(args)...);
         }
         /**
          * @brief 调试级别日志
@@ -82,22 +146,14 @@ namespace DaneJoe
          * @param args 可变参数
          */
         template<typename... Args>
-        void debug(const std::string& module,
-            const std::string& file_name,
-            const std::string& function_name,
+        void debug(std::string_view module,
+            std::string_view file_name,
+            std::string_view function_name,
             int line_num,
             std::format_string<Args...> fmt,
             Args&&... args)
         {
-            std::string log_info = std::format(fmt, std::forward<Args>(args)...);
-            log_msg(LogLevel::DEBUG,
-                module,
-                log_info,
-                file_name,
-                function_name,
-                line_num,
-                get_pid(),
-                to_string(std::this_thread::get_id()));
+            log(LogLevel::DEBUG, module, file_name, function_name, line_num, fmt, std::forward<Args>(args)...);
         }
         /**
          * @brief 信息级别日志
@@ -110,22 +166,14 @@ namespace DaneJoe
          * @param args 可变参数
          */
         template<typename... Args>
-        void info(const std::string& module,
-            const std::string& file_name,
-            const std::string& function_name,
+        void info(std::string_view module,
+            std::string_view file_name,
+            std::string_view function_name,
             int line_num,
             std::format_string<Args...> fmt,
             Args&&... args)
         {
-            std::string log_info = std::format(fmt, std::forward<Args>(args)...);
-            log_msg(LogLevel::INFO,
-                module,
-                log_info,
-                file_name,
-                function_name,
-                line_num,
-                get_pid(),
-                to_string(std::this_thread::get_id()));
+            log(LogLevel::INFO, module, file_name, function_name, line_num, fmt, std::forward<Args>(args)...);
         }
         /**
          * @brief 警告级别日志
@@ -136,24 +184,16 @@ namespace DaneJoe
          * @param line_num 行号
          * @param fmt 格式化字符串
          * @param args 可变参数
-          */
+         */
         template<typename... Args>
-        void warn(const std::string& module,
-            const std::string& file_name,
-            const std::string& function_name,
+        void warn(std::string_view module,
+            std::string_view file_name,
+            std::string_view function_name,
             int line_num,
             std::format_string<Args...> fmt,
             Args&&... args)
         {
-            std::string log_info = std::format(fmt, std::forward<Args>(args)...);
-            log_msg(LogLevel::WARN,
-                module,
-                log_info,
-                file_name,
-                function_name,
-                line_num,
-                get_pid(),
-                to_string(std::this_thread::get_id()));
+            log(LogLevel::WARN, module, file_name, function_name, line_num, fmt, std::forward<Args>(args)...);
         }
         /**
          * @brief 错误级别日志
@@ -166,22 +206,14 @@ namespace DaneJoe
          * @param args 可变参数
          */
         template<typename... Args>
-        void error(const std::string& module,
-            const std::string& file_name,
-            const std::string& function_name,
+        void error(std::string_view module,
+            std::string_view file_name,
+            std::string_view function_name,
             int line_num,
             std::format_string<Args...> fmt,
             Args&&... args)
         {
-            std::string log_info = std::format(fmt, std::forward<Args>(args)...);
-            log_msg(LogLevel::ERROR,
-                module,
-                log_info,
-                file_name,
-                function_name,
-                line_num,
-                get_pid(),
-                to_string(std::this_thread::get_id()));
+            log(LogLevel::ERROR, module, file_name, function_name, line_num, fmt, std::forward<Args>(args)...);
         }
         /**
          * @brief 致命错误级别日志
@@ -194,22 +226,14 @@ namespace DaneJoe
          * @param args 可变参数
          */
         template<typename... Args>
-        void fatal(const std::string& module,
-            const std::string& file_name,
-            const std::string& function_name,
+        void fatal(std::string_view module,
+            std::string_view file_name,
+            std::string_view function_name,
             int line_num,
             std::format_string<Args...> fmt,
             Args&&... args)
         {
-            std::string log_info = std::format(fmt, std::forward<Args>(args)...);
-            log_msg(LogLevel::FATAL,
-                module,
-                log_info,
-                file_name,
-                function_name,
-                line_num,
-                get_pid(),
-                to_string(std::this_thread::get_id()));
+            log(LogLevel::FATAL, module, file_name, function_name, line_num, fmt, std::forward<Args>(args)...);
         }
         /**
          * @brief 析构函数
@@ -272,7 +296,41 @@ namespace DaneJoe
             int line_num = -1,
             int process_id = -1,
             const std::string& thread_id = "");
+        /**
+         * @brief 追加日志头
+         * @param output 输出字符串
+         * @param level 日志级别
+         * @param time 记录时间
+         * @param module 模块名称
+         * @param file_name 文件名称
+         * @param function_name 函数名称
+         * @param line_num 行号
+         * @param process_id 进程ID
+         * @param thread_id 线程ID
+         * @details 与 get_header() 输出相同；时间字符串按秒缓存，供后台线程批量格式化时复用 output 的容量。
+         */
+        void append_header(
+            std::string& output,
+            LogLevel level,
+            std::chrono::system_clock::time_point time,
+            std::string_view module,
+            std::string_view file_name = {},
+            std::string_view function_name = {},
+            int line_num = -1,
+            int process_id = -1,
+            std::string_view thread_id = {});
     protected:
+        /**
+         * @brief 获取当前线程的记录缓冲区
+         * @return 记录缓冲区，返回 nullptr 时由调用线程同步格式化
+         */
+        virtual LogRecordBuffer* get_record_buffer();
+        /**
+         * @brief 等待记录缓冲区腾出空间
+         * @param buffer 已满的记录缓冲区
+         * @return 是否值得重试（后台已停止时返回 false）
+         */
+        virtual bool wait_record_buffer(LogRecordBuffer& buffer);
         /**
          * @brief 日志消息
          * @param level 日志级别
@@ -299,6 +357,38 @@ namespace DaneJoe
         LoggerConfig m_config = LoggerConfig();
         /// @brief 日志输出设置
         LogOutputSetting m_output_setting = LogOutputSetting();
+        /// @brief 控制台与文件中较低的输出级别
+        std::atomic<LogLevel> m_min_level = LogLevel::TRACE;
+    private:
+        /**
+         * @brief 将记录写入缓冲区，缓冲区满时等待后台取走
+         * @return 是否写入
+         */
+        template<typename... Storages>
+        bool write_record(
+            LogRecordBuffer& buffer,
+            const LogRecordHeader& header,
+            std::string_view format,
+            std::string_view module,
+            std::string_view file_name,
+            std::string_view function_name,
+            const Storages&... storages)
+        {
+            while (!LogRecordCodec::try_write(buffer, header, format, module, file_name, function_name, storages...))
+            {
+                std::size_t record_size = sizeof(LogRecordHeader) + module.size() + file_name.size() + function_name.size() +
+                    (LogRecordCodec::get_encoded_size(storages) + ... + 0);
+                if (!buffer.can_fit(record_size) || !wait_record_buffer(buffer))
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+        /**
+         * @brief 根据配置更新最低输出级别
+         */
+        void update_min_level();
 
     };
     /**
@@ -0,0 +1,366 @@
+/**
+ * @file log_record.hpp
+ * @brief 二进制日志记录
+ * @author DaneJoe001
+ * @version 0.2.0
+ * @date 2026-01-12
+ * @details 异步日志的生产者不再格式化消息，而是把格式字符串指针与参数按二进制写入线程私有的环形缓冲区，
+ *          由后台线程解码并格式化：
+ *          - 算术类型与指针按原值拷贝；
+ *          - 字符串类（const char*、字符数组、std::string、std::string_view）拷贝长度与字节；
+ *          - 其余可格式化类型在生产者线程上先格式化为字符串再拷贝（此时仅宽度、对齐等字符串说明符仍然有效）。
+ *          记录头中保存的格式字符串只存指针，要求其具有静态存储期（std::format_string 均来自字符串字面量）。
+ */
+#pragma once
+
+#include <span>
+#include <tuple>
+#include <atomic>
+#include <algorithm>
+#include <format>
+#include <memory>
+#include <iterator>
+#include <string>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <type_traits>
+
+#include "danejoe/logger/logger_config.hpp"
+
+ /**
+  * @namespace DaneJoe
+  * @brief DaneJoe 命名空间
+  */
+namespace DaneJoe
+{
+    /**
+     * @brief 日志参数解码函数
+     * @param data 参数区起始地址
+     * @param format 格式字符串
+     * @param output 追加格式化结果的字符串
+     * @details 每种参数类型组合实例化一个解码函数，记录中保存其地址。
+     */
+    using LogRecordDecoder = void(*)(const uint8_t* data, std::string_view format, std::string& output);
+
+    /**
+     * @struct LogRecordHeader
+     * @brief 日志记录头
+     * @details 记录头之后依次为模块名、文件名、函数名的字节，最后是参数区。
+     */
+    struct LogRecordHeader
+    {
+        /// @brief 参数解码函数
+        LogRecordDecoder decoder = nullptr;
+        /// @brief 格式字符串（静态存储期）
+        const char* format = nullptr;
+        /// @brief 格式字符串长度
+        uint32_t format_size = 0;
+        /// @brief 线程ID
+        int32_t thread_id = -1;
+        /// @brief 记录时间（system_clock 纪元以来的纳秒数）
+        int64_t timestamp = 0;
+        /// @brief 行号
+        int32_t line_num = -1;
+        /// @brief 日志级别
+        LogLevel level = LogLevel::INFO;
+        /// @brief 模块名长度
+        uint16_t module_size = 0;
+        /// @brief 文件名长度
+        uint16_t file_name_size = 0;
+        /// @brief 函数名长度
+        uint16_t function_name_size = 0;
+    };
+
+    /**
+     * @struct LogRecordView
+     * @brief 日志记录视图
+     * @details 指向环形缓冲区中的记录，在记录被弹出前有效。
+     */
+    struct LogRecordView
+    {
+        /// @brief 记录头
+        LogRecordHeader header;
+        /// @brief 模块名
+        std::string_view module;
+        /// @brief 文件名
+        std::string_view file_name;
+        /// @brief 函数名
+        std::string_view function_name;
+        /// @brief 参数区
+        const uint8_t* args = nullptr;
+        /**
+         * @brief 将消息格式化并追加到字符串
+         * @param output 输出字符串
+         * @return 是否成功（参数与格式说明符不匹配时返回 false，output 不变）
+         */
+        bool format_message(std::string& output)const;
+        /**
+         * @brief 从缓冲区解析记录
+         * @param record 记录字节
+         * @return 记录视图
+         */
+        static LogRecordView parse(std::span<const uint8_t> record);
+    };
+
+    /**
+     * @class LogRecordBuffer
+     * @brief 单生产者单消费者的变长记录环形缓冲区
+     * @details 记录以 8 字节长度前缀加负载的形式连续存放，按 8 字节对齐；
+     *          尾部剩余空间放不下一条记录时写入回绕标记，从头部继续。
+     *          生产者调用 try_reserve()/commit()，消费者调用 front()/pop_front()，彼此无锁。
+     */
+    class LogRecordBuffer
+    {
+    public:
+        /**
+         * @brief 构造函数
+         * @param capacity 容量（字节），向上取整为 2 的幂，至少 4 KiB
+         */
+        explicit LogRecordBuffer(std::size_t capacity);
+        /**
+         * @brief 预留一条记录
+         * @param size 负载大小
+         * @return 负载写入地址（8 字节对齐），空间不足时返回 nullptr
+         * @note 仅生产者线程调用；写完后必须调用 commit()。
+         */
+        uint8_t* try_reserve(std::size_t size);
+        /**
+         * @brief 发布最近一次预留的记录
+         */
+        void commit();
+        /**
+         * @brief 记录大小是否可能放入缓冲区
+         * @param size 负载大小
+         * @return 是否可能放入
+         */
+        bool can_fit(std::size_t size)const;
+        /**
+         * @brief 获取队首记录
+         * @return 记录负载，缓冲区为空时返回空 span
+         * @note 仅消费者线程调用。
+         */
+        std::span<const uint8_t> front();
+        /**
+         * @brief 弹出队首记录
+         * @note 仅在 front() 返回非空后调用。
+         */
+        void pop_front();
+        /**
+         * @brief 是否为空
+         * @return 是否为空
+         */
+        bool is_empty()const;
+        /**
+         * @brief 标记所属线程已退出
+         * @details 消费者取空后即可释放该缓冲区。
+         */
+        void abandon();
+        /**
+         * @brief 所属线程是否已退出
+         * @return 是否已退出
+         */
+        bool is_abandoned()const;
+    private:
+        /// @brief 回绕标记
+        static constexpr uint64_t WRAP_MARKER = 0;
+        /// @brief 数据区
+        std::unique_ptr<uint64_t[]> m_data;
+        /// @brief 容量（字节）
+        std::size_t m_capacity = 0;
+        /// @brief 已发布的写位置（单调递增）
+        alignas(64) std::atomic<uint64_t> m_write_position = 0;
+        /// @brief 预留记录的起始位置（生产者私有）
+        uint64_t m_reserved_position = 0;
+        /// @brief 预留记录的总长度（生产者私有）
+        uint64_t m_reserved_size = 0;
+        /// @brief 生产者缓存的读位置
+        uint64_t m_cached_read_position = 0;
+        /// @brief 已释放的读位置（单调递增）
+        alignas(64) std::atomic<uint64_t> m_read_position = 0;
+        /// @brief 队首记录的总长度（消费者私有）
+        uint64_t m_front_size = 0;
+        /// @brief 所属线程是否已退出
+        std::atomic<bool> m_is_abandoned = false;
+    };
+
+    /**
+     * @namespace DaneJoe::LogRecordCodec
+     * @brief 日志参数编解码
+     */
+    namespace LogRecordCodec
+    {
+        /**
+         * @brief 将参数转换为存储类型
+         * @tparam T 参数类型
+         * @param value 参数
+         * @return 算术类型、const void*、std::string_view 或预先格式化的 std::string
+         */
+        template<typename T>
+        auto to_storage(const T& value)
+        {
+            using Type = std::remove_cvref_t<T>;
+            if constexpr (std::is_same_v<Type, const char*> || std::is_same_v<Type, char*>)
+            {
+                return value ? std::string_view(value) : std::string_view("(null)");
+            }
+            else if constexpr (std::is_array_v<Type> && std::is_same_v<std::remove_cv_t<std::remove_extent_t<Type>>, char>)
+            {
+                return std::string_view(value);
+            }
+            else if constexpr (std::is_arithmetic_v<Type>)
+            {
+                return value;
+            }
+            else if constexpr (std::is_pointer_v<Type> || std::is_null_pointer_v<Type>)
+            {
+                return static_cast<const void*>(value);
+            }
+            else if constexpr (std::is_convertible_v<const Type&, std::string_view>)
+            {
+                return std::string_view(value);
+            }
+            else
+            {
+                return std::format("{}", value);
+            }
+        }
+
+        /**
+         * @brief 是否按字符串编码
+         */
+        template<typename Storage>
+        inline constexpr bool is_string_storage = std::is_same_v<Storage, std::string_view> || std::is_same_v<Storage, std::string>;
+
+        /**
+         * @brief 解码后的参数类型
+         */
+        template<typename Storage>
+        using DecodedType = std::conditional_t<is_string_storage<Storage>, std::string_view, Storage>;
+
+        /**
+         * @brief 获取参数编码长度
+         */
+        template<typename Storage>
+        std::size_t get_encoded_size(const Storage& value)
+        {
+            if constexpr (is_string_storage<Storage>)
+            {
+                return sizeof(uint32_t) + value.size();
+            }
+            else
+            {
+                return sizeof(Storage);
+            }
+        }
+
+        /**
+         * @brief 编码参数
+         * @return 下一个写入位置
+         */
+        template<typename Storage>
+        uint8_t* encode(uint8_t* cursor, const Storage& value)
+        {
+            if constexpr (is_string_storage<Storage>)
+            {
+                uint32_t size = static_cast<uint32_t>(value.size());
+                std::memcpy(cursor, &size, sizeof(size));
+                std::memcpy(cursor + sizeof(size), value.data(), size);
+                return cursor + sizeof(size) + size;
+            }
+            else
+            {
+                std::memcpy(cursor, &value, sizeof(Storage));
+                return cursor + sizeof(Storage);
+            }
+        }
+
+        /**
+         * @brief 解码参数
+         * @param cursor 读取位置，读取后前移
+         */
+        template<typename Storage>
+        DecodedType<Storage> decode(const uint8_t*& cursor)
+        {
+            if constexpr (is_string_storage<Storage>)
+            {
+                uint32_t size = 0;
+                std::memcpy(&size, cursor, sizeof(size));
+                std::string_view value(reinterpret_cast<const char*>(cursor + sizeof(size)), size);
+                cursor += sizeof(size) + size;
+                return value;
+            }
+            else
+            {
+                Storage value;
+                std::memcpy(&value, cursor, sizeof(Storage));
+                cursor += sizeof(Storage);
+                return value;
+            }
+        }
+
+        /**
+         * @brief 解码参数区并格式化
+         * @tparam Storages 参数存储类型
+         */
+        template<typename... Storages>
+        void decode_and_format(const uint8_t* data, std::string_view format, std::string& output)
+        {
+            const uint8_t* cursor = data;
+            // 花括号初始化保证按从左到右的顺序解码
+            std::tuple<DecodedType<Storages>...> values{ decode<Storages>(cursor)... };
+            std::apply([&](auto&... value)
+                {
+                    std::vformat_to(std::back_inserter(output), format, std::make_format_args(value...));
+                }, values);
+        }
+
+        /**
+         * @brief 将记录写入缓冲区
+         * @param buffer 目标缓冲区
+         * @param header 记录头（解码函数、格式字符串与各长度由本函数填写）
+         * @param format 格式字符串
+         * @param module 模块名
+         * @param file_name 文件名
+         * @param function_name 函数名
+         * @param storages 已转换为存储类型的参数
+         * @return 是否写入；空间不足时返回 false，由调用方决定等待或回退
+         */
+        template<typename... Storages>
+        bool try_write(
+            LogRecordBuffer& buffer,
+            LogRecordHeader header,
+            std::string_view format,
+            std::string_view module,
+            std::string_view file_name,
+            std::string_view function_name,
+            const Storages&... storages)
+        {
+            header.decoder = &decode_and_format<Storages...>;
+            header.format = format.data();
+            header.format_size = static_cast<uint32_t>(format.size());
+            header.module_size = static_cast<uint16_t>(std::min<std::size_t>(module.size(), UINT16_MAX));
+            header.file_name_size = static_cast<uint16_t>(std::min<std::size_t>(file_name.size(), UINT16_MAX));
+            header.function_name_size = static_cast<uint16_t>(std::min<std::size_t>(function_name.size(), UINT16_MAX));
+            std::size_t size = sizeof(LogRecordHeader) +
+                header.module_size + header.file_name_size + header.function_name_size +
+                (get_encoded_size(storages) + ... + 0);
+            uint8_t* cursor = buffer.try_reserve(size);
+            if (!cursor)
+            {
+                return false;
+            }
+            std::memcpy(cursor, &header, sizeof(LogRecordHeader));
+            cursor += sizeof(LogRecordHeader);
+            std::copy_n(module.data(), header.module_size, cursor);
+            cursor += header.module_size;
+            std::copy_n(file_name.data(), header.file_name_size, cursor);
+            cursor += header.file_name_size;
+            std::copy_n(function_name.data(), header.function_name_size, cursor);
+            cursor += header.function_name_size;
+            ((cursor = encode(cursor, storages)), ...);
+            buffer.commit();
+            return true;
+        }
+    }
+}
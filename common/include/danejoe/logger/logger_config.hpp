@@ -13,6 +13,27 @@
 
 #include "danejoe/common/enum/enum_convert.hpp"
 
+/**
+ * @brief 编译期日志级别取值
+ * @details 与 LogLevel 的前六个枚举值一一对应，供预处理与 if constexpr 比较。
+ */
+#define DANEJOE_LOG_LEVEL_TRACE 0
+#define DANEJOE_LOG_LEVEL_DEBUG 1
+#define DANEJOE_LOG_LEVEL_INFO 2
+#define DANEJOE_LOG_LEVEL_WARN 3
+#define DANEJOE_LOG_LEVEL_ERROR 4
+#define DANEJOE_LOG_LEVEL_FATAL 5
+#define DANEJOE_LOG_LEVEL_NONE 6
+
+/**
+ * @brief 编译期最低日志级别
+ * @details 低于该级别的 DANEJOE_LOG_* 与 ADD_DIAG_* 宏不生成任何代码，参数也不会求值。
+ *          由 CMake 缓存变量 DANEJOE_LOG_ACTIVE_LEVEL 设置，默认保留全部级别。
+ */
+#ifndef DANEJOE_LOG_ACTIVE_LEVEL
+#define DANEJOE_LOG_ACTIVE_LEVEL DANEJOE_LOG_LEVEL_TRACE
+#endif
+
 /**
  * @namespace DaneJoe
  * @brief DaneJoe 命名空间
@@ -71,6 +92,7 @@ namespace DaneJoe
      *          - console_level/file_level：控制台/文件输出的过滤级别
      *          - enable_console/enable_file/enable_async：是否启用对应输出与异步模式
      *          - max_file_size/max_file_num/use_daily_log：文件滚动/切分策略（具体行为由实现决定）
+     *          - thread_buffer_size/flush_level/flush_interval_ms：异步模式的线程缓冲区大小与文件刷新策略
      */
     struct LoggerConfig
     {
@@ -98,6 +120,12 @@ namespace DaneJoe
         bool enable_backtrace = false;
         /// @brief 堆栈回溯大小
         std::size_t backtrace_size = 0;
+        /// @brief 异步模式下每个线程的记录缓冲区大小（字节）
+        std::size_t thread_buffer_size = 256 * 1024;
+        /// @brief 不低于该级别的日志写入后立即刷新文件
+        LogLevel flush_level = LogLevel::WARN;
+        /// @brief 文件刷新的最长间隔（毫秒）
+        std::size_t flush_interval_ms = 100;
     };
     /**
      * @struct LogOutputSetting
@@ -13,6 +13,7 @@
 #include <string>
 #include <memory>
 #include <mutex>
+#include <string_view>
 
 #include "danejoe/logger/i_logger.hpp"
 
@@ -46,6 +47,14 @@ namespace DaneJoe
          * @return 日志对象
          */
         std::shared_ptr<DaneJoe::ILogger> get_logger(const std::string& log_name);
+        /**
+         * @brief 查找日志对象
+         * @param log_name 日志名称
+         * @return 日志对象，不存在时返回默认日志对象
+         * @details 供日志宏使用：默认日志对象直接返回缓存的指针，不加锁。
+         *          日志对象注册后不会移除，返回的指针在进程内始终有效。
+         */
+        DaneJoe::ILogger* find_logger(std::string_view log_name);
         /**
          * @brief 添加日志对象
          * @param logger_type 日志类型
@@ -98,142 +107,96 @@ namespace DaneJoe
         std::unordered_map<std::string, std::shared_ptr<ILoggerCreator>> m_logger_creator_map;
         /// @brief 默认日志配置
         DaneJoe::LoggerConfig m_default_log_config;
+        /// @brief 默认日志对象
+        DaneJoe::ILogger* m_default_logger = nullptr;
     };
 }
 /**
- * @brief 日志宏
+ * @brief 按级别写日志
+ * @param level_name 级别名称（TRACE/DEBUG/INFO/WARN/ERROR/FATAL）
+ * @param method ILogger 的对应成员函数
  * @param log_name 日志名称
  * @param module 模块名称
  * @param fmt 格式化字符串
  * @param ... 可变参数
+ * @details 级别低于 DANEJOE_LOG_ACTIVE_LEVEL 时整条语句被丢弃（仍做语法检查，不生成代码）；
+ *          否则先检查日志器的运行时级别，通过后才求值参数。
  */
-#define DANEJOE_LOG_TRACE(log_name,module,fmt,...)\
+#define DANEJOE_LOG_AT_LEVEL(level_name,method,log_name,module,fmt,...)\
 do\
 {\
-auto logger=DaneJoe::LoggerManager::get_instance().get_logger(log_name);\
-    if(logger)\
+    if constexpr (DANEJOE_LOG_ACTIVE_LEVEL <= DANEJOE_LOG_LEVEL_##level_name)\
     {\
-        logger->trace(\
-        std::string(module),\
-        std::string(__FILE__), \
-        std::string(__FUNCTION__), \
-        __LINE__, \
-        fmt, \
-        ##__VA_ARGS__, "");\
+        DaneJoe::ILogger* danejoe_logger = DaneJoe::LoggerManager::get_instance().find_logger(log_name);\
+        if (danejoe_logger && danejoe_logger->is_enabled(DaneJoe::LogLevel::level_name))\
+        {\
+            danejoe_logger->method(\
+                module,\
+                __FILE__,\
+                __FUNCTION__,\
+                __LINE__,\
+                fmt,\
+                ##__VA_ARGS__, "");\
+        }\
     }\
 }while (0)
 
- /**
-  * @brief 日志宏
-  * @param log_name 日志名称
-  * @param module 模块名称
-  * @param fmt 格式化字符串
-  * @param ... 可变参数
-  */
+/**
+ * @brief 日志宏
+ * @param log_name 日志名称
+ * @param module 模块名称
+ * @param fmt 格式化字符串
+ * @param ... 可变参数
+ */
+#define DANEJOE_LOG_TRACE(log_name,module,fmt,...)\
+    DANEJOE_LOG_AT_LEVEL(TRACE,trace,log_name,module,fmt,##__VA_ARGS__)
+
+/**
+ * @brief 日志宏
+ * @param log_name 日志名称
+ * @param module 模块名称
+ * @param fmt 格式化字符串
+ * @param ... 可变参数
+ */
 #define DANEJOE_LOG_DEBUG(log_name,module,fmt,...)\
-do\
-{\
-auto logger=DaneJoe::LoggerManager::get_instance().get_logger(log_name);\
-    if(logger)\
-    {\
-        logger->debug(\
-    std::string(module),\
-    std::string(__FILE__), \
-    std::string(__FUNCTION__), \
-    __LINE__, \
-    fmt, \
-    ##__VA_ARGS__, "");\
-    }\
-}while (0)
+    DANEJOE_LOG_AT_LEVEL(DEBUG,debug,log_name,module,fmt,##__VA_ARGS__)
 
-  /**
-   * @brief 日志宏
-   * @param log_name 日志名称
-   * @param module 模块名称
-   * @param fmt 格式化字符串
-   * @param ... 可变参数
-   */
+/**
+ * @brief 日志宏
+ * @param log_name 日志名称
+ * @param module 模块名称
+ * @param fmt 格式化字符串
+ * @param ... 可变参数
+ */
 #define DANEJOE_LOG_INFO(log_name,module,fmt,...)\
-do\
-{\
-auto logger=DaneJoe::LoggerManager::get_instance().get_logger(log_name);\
-    if(logger)\
-    {\
-        logger->info(\
-    std::string(module),\
-    std::string(__FILE__), \
-    std::string(__FUNCTION__), \
-    __LINE__, \
-    fmt, \
-    ##__VA_ARGS__, "");\
-    }\
-}while (0)
+    DANEJOE_LOG_AT_LEVEL(INFO,info,log_name,module,fmt,##__VA_ARGS__)
 
-   /**
-    * @brief 日志宏
-    * @param log_name 日志名称
-    * @param module 模块名称
-    * @param fmt 格式化字符串
-    * @param ... 可变参数
-    */
+/**
+ * @brief 日志宏
+ * @param log_name 日志名称
+ * @param module 模块名称
+ * @param fmt 格式化字符串
+ * @param ... 可变参数
+ */
 #define DANEJOE_LOG_WARN(log_name,module,fmt,...)\
-do\
-{\
-auto logger=DaneJoe::LoggerManager::get_instance().get_logger(log_name);\
-    if(logger)\
-    {\
-        logger->warn(\
-    std::string(module),\
-    std::string(__FILE__), \
-    std::string(__FUNCTION__), \
-    __LINE__, \
-    fmt, \
-    ##__VA_ARGS__, "");\
-    }\
-}while (0)
+    DANEJOE_LOG_AT_LEVEL(WARN,warn,log_name,module,fmt,##__VA_ARGS__)
 
-    /**
-     * @brief 日志宏
-     * @param log_name 日志名称
-     * @param module 模块名称
-     * @param fmt 格式化字符串
-     * @param ... 可变参数
-     */
+/**
+ * @brief 日志宏
+ * @param log_name 日志名称
+ * @param module 模块名称
+ * @param fmt 格式化字符串
+ * @param ... 可变参数
+ */
 #define DANEJOE_LOG_ERROR(log_name,module,fmt,...)\
-do\
-{\
-auto logger=DaneJoe::LoggerManager::get_instance().get_logger(log_name);\
-    if(logger)\
-    {\
-        logger->error(\
-    std::string(module),\
-    std::string(__FILE__), \
-    std::string(__FUNCTION__), \
-    __LINE__, \
-    fmt, \
-    ##__VA_ARGS__, "");\
-    }\
-}while (0)
+    DANEJOE_LOG_AT_LEVEL(ERROR,error,log_name,module,fmt,##__VA_ARGS__)
 
-     /**
-      * @brief 日志宏
-      * @param log_name 日志名称
-      * @param module 模块名称
-      * @param fmt 格式化字符串
-      * @param ... 可变参数
-      */
+/**
+ * @brief 日志宏
+ * @param log_name 日志名称
+ * @param module 模块名称
+ * @param fmt 格式化字符串
+ * @param ... 可变参数
+ */
 #define DANEJOE_LOG_FATAL(log_name,module,fmt,...)\
-do\
-{\
-auto logger=DaneJoe::LoggerManager::get_instance().get_logger(log_name);\
-    if(logger)\
-    {\
-        logger->fatal(\
-    std::string(module),\
-    std::string(__FILE__), \
-    std::string(__FUNCTION__), \
-    __LINE__, \
-    fmt, \
-    ##__VA_ARGS__, "");\
-    }\
-}while (0)
+    DANEJOE_LOG_AT_LEVEL(FATAL,fatal,log_name,module,fmt,##__VA_ARGS__)
@@ -0,0 +1,117 @@
+/**
+ * @file latency_histogram.hpp
+ * @author DaneJoe001 (danejoe001.github)
+ * @brief 延迟直方图
+ * @version 0.2.0
+ * @date 2026-01-11
+ * @details HDR 式对数-线性分桶：数值按最高有效位所在的 2 的幂区间分段，每段再线性切分为 128 个子桶，
+ *          任意数值的相对误差不超过 1/128（约 0.8%），桶数与记录次数无关。
+ *          记录只是一次下标计算与计数加一，可放在请求路径上；多个线程各自记录后再合并。
+ */
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+ /**
+  * @namespace DaneJoe
+  * @brief DaneJoe 命名空间
+  */
+namespace DaneJoe
+{
+    /**
+     * @class LatencyHistogram
+     * @brief 延迟直方图
+     * @details 数值单位由调用方决定（通常为纳秒），超出可表示范围的数值计入最后一个桶。
+     * @note 非线程安全。
+     */
+    class LatencyHistogram
+    {
+    public:
+        /// @brief 子桶数的二进制位数
+        static constexpr int SUB_BUCKET_BITS = 7;
+        /// @brief 每个 2 的幂区间内的子桶数
+        static constexpr uint64_t SUB_BUCKET_COUNT = uint64_t(1) << SUB_BUCKET_BITS;
+        /// @brief 可表示数值的最大二进制位数（以纳秒计约 18 分钟）
+        static constexpr int MAX_VALUE_BITS = 40;
+        /// @brief 可表示的最大数值
+        static constexpr uint64_t MAX_VALUE = (uint64_t(1) << MAX_VALUE_BITS) - 1;
+        /// @brief 桶数
+        static constexpr std::size_t BUCKET_COUNT = (MAX_VALUE_BITS - SUB_BUCKET_BITS + 1) * SUB_BUCKET_COUNT;
+    public:
+        /**
+         * @brief 构造空直方图
+         */
+        LatencyHistogram();
+        /**
+         * @brief 记录一个数值
+         * @param value 数值
+         */
+        void record(uint64_t value);
+        /**
+         * @brief 记录同一数值多次
+         * @param value 数值
+         * @param count 次数
+         */
+        void record(uint64_t value, uint64_t count);
+        /**
+         * @brief 合并另一个直方图
+         * @param other 另一个直方图
+         */
+        void merge(const LatencyHistogram& other);
+        /**
+         * @brief 清空
+         */
+        void reset();
+        /**
+         * @brief 获取记录次数
+         * @return 记录次数
+         */
+        uint64_t get_count()const;
+        /**
+         * @brief 获取最小值
+         * @return 最小值，为空时返回 0
+         */
+        uint64_t get_min()const;
+        /**
+         * @brief 获取最大值
+         * @return 最大值，为空时返回 0
+         */
+        uint64_t get_max()const;
+        /**
+         * @brief 获取平均值
+         * @return 平均值，为空时返回 0
+         */
+        double get_mean()const;
+        /**
+         * @brief 获取百分位数
+         * @param percentile 百分位，取值 [0, 100]，例如 99.9
+         * @return 该百分位所在桶的上界（不超过最大值），为空时返回 0
+         */
+        uint64_t get_percentile(double percentile)const;
+        /**
+         * @brief 计算数值所在的桶
+         * @param value 数值
+         * @return 桶下标
+         */
+        static std::size_t get_bucket_index(uint64_t value);
+        /**
+         * @brief 获取桶内的最大数值
+         * @param index 桶下标
+         * @return 落入该桶的最大数值
+         */
+        static uint64_t get_bucket_upper_value(std::size_t index);
+    private:
+        /// @brief 各桶计数
+        std::vector<uint64_t> m_buckets;
+        /// @brief 记录次数
+        uint64_t m_count = 0;
+        /// @brief 数值之和
+        uint64_t m_sum = 0;
+        /// @brief 最小值
+        uint64_t m_min = UINT64_MAX;
+        /// @brief 最大值
+        uint64_t m_max = 0;
+    };
+}
@@ -0,0 +1,288 @@
+/**
+ * @file metrics_registry.hpp
+ * @author DaneJoe001 (danejoe001.github)
+ * @brief 运行指标注册表
+ * @version 0.2.0
+ * @date 2026-01-13
+ * @details 提供计数器、仪表与延迟直方图三类指标，按名称注册到进程级注册表：
+ *          - 计数器按线程分片累加，读取时求和，热路径上只有一次无竞争的原子加；
+ *          - 仪表为单个原子值，用于连接数、队列深度等可增可减的量；
+ *          - 直方图按线程分片记录到原子桶，快照时合并为 LatencyHistogram。
+ *          指标注册后不会移除，调用方可缓存返回的引用。快照供界面轮询，也可输出为文本（/metrics）。
+ */
+#pragma once
+
+#include <map>
+#include <array>
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <string_view>
+
+#include "danejoe/metrics/latency_histogram.hpp"
+
+ /**
+  * @namespace DaneJoe
+  * @brief DaneJoe 命名空间
+  */
+namespace DaneJoe
+{
+    /// @brief 计数器分片数
+    inline constexpr std::size_t METRICS_SHARD_COUNT = 16;
+    /**
+     * @brief 分配线程的分片下标
+     * @return 分片下标（按线程首次使用的顺序轮转）
+     */
+    std::size_t assign_metrics_shard_index();
+    /**
+     * @brief 获取当前线程的分片下标
+     * @return 分片下标，取值 [0, METRICS_SHARD_COUNT)
+     */
+    inline std::size_t get_metrics_shard_index()
+    {
+        thread_local std::size_t shard_index = assign_metrics_shard_index();
+        return shard_index;
+    }
+
+    /**
+     * @class MetricsCounter
+     * @brief 计数器
+     * @details 单调递增。每个分片独占一个缓存行，不同线程累加时互不干扰。
+     */
+    class MetricsCounter
+    {
+    public:
+        /**
+         * @brief 累加
+         * @param value 增量
+         */
+        void add(uint64_t value = 1)
+        {
+            m_shards[get_metrics_shard_index()].value.fetch_add(value, std::memory_order_relaxed);
+        }
+        /**
+         * @brief 获取当前值
+         * @return 各分片之和
+         */
+        uint64_t get_value()const;
+    private:
+        /**
+         * @struct Shard
+         * @brief 计数器分片
+         */
+        struct alignas(64) Shard
+        {
+            /// @brief 分片计数
+            std::atomic<uint64_t> value = 0;
+        };
+        /// @brief 分片
+        std::array<Shard, METRICS_SHARD_COUNT> m_shards;
+    };
+
+    /**
+     * @class MetricsGauge
+     * @brief 仪表
+     * @details 可设置、可增减的瞬时值。
+     */
+    class MetricsGauge
+    {
+    public:
+        /**
+         * @brief 设置值
+         * @param value 新值
+         */
+        void set(int64_t value)
+        {
+            m_value.store(value, std::memory_order_relaxed);
+        }
+        /**
+         * @brief 增减
+         * @param delta 变化量（可为负）
+         */
+        void add(int64_t delta)
+        {
+            m_value.fetch_add(delta, std::memory_order_relaxed);
+        }
+        /**
+         * @brief 获取当前值
+         * @return 当前值
+         */
+        int64_t get_value()const
+        {
+            return m_value.load(std::memory_order_relaxed);
+        }
+    private:
+        /// @brief 当前值
+        std::atomic<int64_t> m_value = 0;
+    };
+
+    /**
+     * @struct HistogramSnapshot
+     * @brief 直方图快照
+     * @details 百分位数为所在桶的上界（相对误差不超过 1/128），数值单位与记录时一致。
+     */
+    struct HistogramSnapshot
+    {
+        /// @brief 记录次数
+        uint64_t count = 0;
+        /// @brief 数值之和
+        uint64_t sum = 0;
+        /// @brief 最大值
+        uint64_t max = 0;
+        /// @brief 50 分位
+        uint64_t p50 = 0;
+        /// @brief 90 分位
+        uint64_t p90 = 0;
+        /// @brief 99 分位
+        uint64_t p99 = 0;
+        /// @brief 99.9 分位
+        uint64_t p999 = 0;
+        /**
+         * @brief 获取平均值
+         * @return 平均值，为空时返回 0
+         */
+        double get_mean()const;
+    };
+
+    /**
+     * @class MetricsHistogram
+     * @brief 延迟直方图指标
+     * @details 分桶规则与 LatencyHistogram 相同。每个分片持有一组原子桶，记录只是一次下标计算与原子加。
+     */
+    class MetricsHistogram
+    {
+    public:
+        /// @brief 直方图分片数（每个分片约 35 KiB）
+        static constexpr std::size_t SHARD_COUNT = 4;
+        /**
+         * @brief 构造函数
+         */
+        MetricsHistogram();
+        /**
+         * @brief 记录一个数值
+         * @param value 数值
+         */
+        void record(uint64_t value);
+        /**
+         * @brief 合并各分片
+         * @return 合并后的直方图
+         */
+        LatencyHistogram merge()const;
+        /**
+         * @brief 获取快照
+         * @return 直方图快照
+         */
+        HistogramSnapshot get_snapshot()const;
+    private:
+        /**
+         * @struct Shard
+         * @brief 直方图分片
+         */
+        struct Shard
+        {
+            /// @brief 各桶计数
+            std::unique_ptr<std::atomic<uint64_t>[]> buckets;
+            /// @brief 数值之和
+            alignas(64) std::atomic<uint64_t> sum = 0;
+            /// @brief 最大值
+            std::atomic<uint64_t> max = 0;
+        };
+        /// @brief 分片
+        std::array<Shard, SHARD_COUNT> m_shards;
+    };
+
+    /**
+     * @struct MetricsSnapshot
+     * @brief 指标快照
+     * @details 各类指标按名称排序。名称可带标签，例如 `server_requests_total{path="/block"}`。
+     */
+    struct MetricsSnapshot
+    {
+        /// @brief 计数器
+        std::vector<std::pair<std::string, uint64_t>> counters;
+        /// @brief 仪表
+        std::vector<std::pair<std::string, int64_t>> gauges;
+        /// @brief 直方图
+        std::vector<std::pair<std::string, HistogramSnapshot>> histograms;
+        /**
+         * @brief 获取计数器值
+         * @param name 指标名称
+         * @return 计数器值，不存在时返回 0
+         */
+        uint64_t get_counter(std::string_view name)const;
+        /**
+         * @brief 获取仪表值
+         * @param name 指标名称
+         * @return 仪表值，不存在时返回 0
+         */
+        int64_t get_gauge(std::string_view name)const;
+        /**
+         * @brief 获取直方图快照
+         * @param name 指标名称
+         * @return 直方图快照，不存在时返回空快照
+         */
+        HistogramSnapshot get_histogram(std::string_view name)const;
+        /**
+         * @brief 输出为文本
+         * @return 每行 `名称 值`，每个指标族前有 `# TYPE` 注释；
+         *         直方图输出 _count、_sum、_max 与 quantile 标签行
+         */
+        std::string to_text()const;
+    };
+
+    /**
+     * @class MetricsRegistry
+     * @brief 指标注册表
+     * @details 单例。注册与快照在互斥锁内进行，指标本身的更新不加锁。
+     */
+    class MetricsRegistry
+    {
+    public:
+        /**
+         * @brief 获取单例
+         * @return 单例引用
+         */
+        static MetricsRegistry& get_instance();
+        /**
+         * @brief 获取计数器，不存在时创建
+         * @param name 指标名称
+         * @return 计数器引用（进程内始终有效）
+         */
+        MetricsCounter& get_counter(std::string_view name);
+        /**
+         * @brief 获取仪表，不存在时创建
+         * @param name 指标名称
+         * @return 仪表引用（进程内始终有效）
+         */
+        MetricsGauge& get_gauge(std::string_view name);
+        /**
+         * @brief 获取直方图，不存在时创建
+         * @param name 指标名称
+         * @return 直方图引用（进程内始终有效）
+         */
+        MetricsHistogram& get_histogram(std::string_view name);
+        /**
+         * @brief 获取所有指标的快照
+         * @return 指标快照
+         */
+        MetricsSnapshot get_snapshot()const;
+    private:
+        /**
+         * @brief 构造函数
+         */
+        MetricsRegistry() = default;
+    private:
+        /// @brief 注册表互斥锁
+        mutable std::mutex m_mutex;
+        /// @brief 计数器
+        std::map<std::string, std::unique_ptr<MetricsCounter>, std::less<>> m_counters;
+        /// @brief 仪表
+        std::map<std::string, std::unique_ptr<MetricsGauge>, std::less<>> m_gauges;
+        /// @brief 直方图
+        std::map<std::string, std::unique_ptr<MetricsHistogram>, std::less<>> m_histograms;
+    };
+}
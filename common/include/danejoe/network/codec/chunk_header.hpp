@@ -0,0 +1,101 @@
+/**
+ * @file chunk_header.hpp
+ * @author DaneJoe (danejoe001.github)
+ * @brief 分片头
+ * @version 0.2.0
+ * @date 2026-01-06
+ * @details 定义分片头 ChunkHeader 及其标志位 ChunkFlag。
+ *          分片层位于 SerializeHeader 描述的消息帧之下：大消息被切分为若干带 stream_id 的分片，
+ *          不同消息的分片可以在同一连接上交错发送，由接收端按 stream_id 重新拼接为完整消息帧。
+ *          分片头使用与消息头不同的魔数，接收端据此区分分片与未分片的完整帧。
+ */
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <optional>
+#include <string>
+
+#include "danejoe/common/type_traits/enum_type_traits.hpp"
+
+/**
+ * @namespace DaneJoe
+ * @brief DaneJoe 命名空间
+ */
+namespace DaneJoe
+{
+    /**
+     * @enum ChunkFlag
+     * @brief 分片标志位
+     */
+    enum class ChunkFlag :uint8_t
+    {
+        /// @brief 无标志
+        None = 0,
+        /// @brief 是否为消息的最后一个分片
+        Last = 1 << 0,
+    };
+    /**
+     * @brief 启用位掩码操作符
+     * @details 为 ChunkFlag 启用按位运算符重载（见 enum_type_traits.hpp）。
+     */
+    template<>
+    struct enable_bitmask_operator<ChunkFlag> :std::true_type {};
+    /**
+     * @brief 获取枚举字符串
+     * @param flag 枚举标志
+     * @note 用于日志输出
+     */
+    std::string to_string(DaneJoe::ChunkFlag flag);
+    /**
+     * @struct ChunkHeader
+     * @brief 分片头结构体
+     * @details 字段含义：
+     *          - magic_number：分片标识，与 SerializeHeader 的魔数不同
+     *          - stream_id：所属消息流标识，同一消息的所有分片相同
+     *          - flag：分片标志（例如 Last）
+     *          - payload_length：分片负载长度（不包含分片头本身）
+     */
+    struct ChunkHeader
+    {
+        /// @brief 分片魔数
+        static constexpr uint32_t CHUNK_MAGIC_NUMBER = 0x66666667;
+        /// @brief 魔数（用于区分分片与完整帧）
+        uint32_t magic_number = CHUNK_MAGIC_NUMBER;
+        /// @brief 消息流标识
+        uint32_t stream_id = 0;
+        /// @brief 分片标志
+        ChunkFlag flag = ChunkFlag::None;
+        /// @brief 分片负载长度，不包括自身长度
+        uint32_t payload_length = 0;
+        /**
+         * @brief 原始数据的最小长度
+         * @return 序列化字节数
+         */
+        static uint32_t min_serialized_byte_array_size();
+        /**
+         * @brief 判断数据是否以分片魔数开头
+         * @param data 数据起始地址
+         * @param size 数据长度
+         * @return 以分片魔数开头返回 true；长度不足或不匹配返回 false
+         */
+        static bool is_chunk(const uint8_t* data, std::size_t size);
+        /**
+         * @brief 获取结构体的序列化数据
+         * @return 序列化数据（网络字节序）
+         */
+        std::vector<uint8_t> to_serialized_byte_array()const;
+        /**
+         * @brief 从序列化数据获取结构体
+         * @param data 数据起始地址
+         * @param size 数据长度
+         * @return 分片头；长度不足或魔数不匹配时返回 std::nullopt
+         */
+        static std::optional<ChunkHeader> from_serialized_byte_array(const uint8_t* data, std::size_t size);
+        /**
+         * @brief 将结构体字符串化，便于调试输出
+         * @return 结构体字符串
+         */
+        std::string to_string()const;
+    };
+}
@@ -0,0 +1,78 @@
+/**
+ * @file chunk_reassembler.hpp
+ * @author DaneJoe (danejoe001.github)
+ * @brief 分片重组器
+ * @version 0.2.0
+ * @date 2026-01-06
+ * @details 定义 ChunkReassembler，位于 FrameAssembler 之前：
+ *          将接收到的字节流中的分片按 stream_id 拼接为完整消息帧，未分片的完整帧原样透传。
+ */
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <optional>
+#include <unordered_map>
+
+/**
+ * @namespace DaneJoe
+ * @brief DaneJoe 命名空间
+ */
+namespace DaneJoe
+{
+    /**
+     * @struct ChunkReassemblerConfig
+     * @brief 分片重组限制
+     * @details 分片流与帧长度均由对端声明，超出限制视为协议错误，避免对端耗尽接收端内存。
+     */
+    struct ChunkReassemblerConfig
+    {
+        /// @brief 单个连接同时重组的分片流上限
+        std::size_t max_stream_count = 64;
+        /// @brief 单个消息帧（含帧头）的字节上限，同时限制单个分片流与单个分片负载
+        uint64_t max_frame_size = 64 * 1024 * 1024;
+    };
+    /**
+     * @class ChunkReassembler
+     * @brief 分片重组器
+     * @details 字节流由若干发送单元组成，每个单元要么是以 SerializeHeader 开头的完整帧，
+     *          要么是以 ChunkHeader 开头的分片。未分片帧的字节在到达后即透传输出；
+     *          分片负载累积到对应 stream_id 的缓存中，收到 Last 分片后整体输出。
+     *          输出的字节总是以完整帧为边界交付，因此可直接交给 FrameAssembler 解析。
+     *          分片流数量、分片流累计字节数与帧长度受 ChunkReassemblerConfig 限制。
+     */
+    class ChunkReassembler
+    {
+    public:
+        /**
+         * @brief 构造函数
+         * @param config 重组限制
+         */
+        ChunkReassembler(const ChunkReassemblerConfig& config = ChunkReassemblerConfig());
+        /**
+         * @brief 写入接收到的字节数据
+         * @param data 新到达的数据片段
+         * @return 可交给帧解析的字节数据（完整帧或未分片帧的一部分）；
+         *         数据超出重组限制时返回 std::nullopt 并清空重组状态，调用方应断开连接
+         */
+        std::optional<std::vector<uint8_t>> push_data(const std::vector<uint8_t>& data);
+        /**
+         * @brief 清空重组状态
+         */
+        void clear();
+        /**
+         * @brief 是否有尚未输出的数据
+         * @return 存在未解析数据或未完成的分片流返回 true
+         */
+        bool has_pending_data()const;
+    private:
+        /// @brief 重组限制
+        ChunkReassemblerConfig m_config;
+        /// @brief 尚未解析的接收数据
+        std::vector<uint8_t> m_buffer;
+        /// @brief 当前透传中的未分片帧剩余字节数
+        uint64_t m_plain_rest_size = 0;
+        /// @brief 按 stream_id 组织的分片缓存
+        std::unordered_map<uint32_t, std::vector<uint8_t>> m_streams;
+    };
+}
@@ -14,6 +14,7 @@
 #include <cstdint>
 
 #include "danejoe/network/codec/serialize_header.hpp"
+#include "danejoe/network/codec/chunk_reassembler.hpp"
 
 /**
  * @namespace DaneJoe
@@ -25,6 +26,7 @@ namespace DaneJoe
      * @class FrameAssembler
      * @brief 帧组装器
      * @details 维护接收缓冲区并按协议解析帧头（SerializeHeader），随后累计帧体数据直到得到完整帧。
+     *          输入数据先经过 ChunkReassembler，发送端启用分片（见 FrameChunker）时同样能得到完整帧。
      */
     class FrameAssembler
     {
@@ -32,8 +34,9 @@ namespace DaneJoe
         /**
          * @brief 写入接收到的字节数据
          * @param data 新到达的数据片段
+         * @return 数据超出分片重组限制（见 ChunkReassemblerConfig）时返回 false，调用方应断开连接
          */
-        void push_data(const std::vector<uint8_t>& data);
+        bool push_data(const std::vector<uint8_t>& data);
         /**
          * @brief 从接收缓冲区弹出指定字节数
          * @param size 要弹出的字节数
@@ -49,7 +52,14 @@ namespace DaneJoe
          * @brief 清理当前正在组装的帧状态
          */
         void clear_current_frame();
+        /**
+         * @brief 是否有尚未组成完整帧的数据
+         * @return 存在残留数据返回 true
+         */
+        bool has_pending_data()const;
     private:
+        /// @brief 分片重组器
+        ChunkReassembler m_chunk_reassembler;
         /// @brief 接收缓冲区
         std::deque<uint8_t> m_buffer;
         /// @brief 当前帧缓存
@@ -0,0 +1,122 @@
+/**
+ * @file frame_chunker.hpp
+ * @author DaneJoe (danejoe001.github)
+ * @brief 帧分片器
+ * @version 0.2.0
+ * @date 2026-01-06
+ * @details 定义 FrameChunker 与 FrameChunkConfig，用于发送端把大消息帧切分为固定大小的分片，
+ *          并通过加权轮转调度在控制类小帧与多个大帧的分片之间交错输出，
+ *          避免单个大块响应长期占用连接造成小消息的队头阻塞。
+ */
+#pragma once
+
+#include <deque>
+#include <vector>
+#include <cstdint>
+#include <optional>
+
+/**
+ * @namespace DaneJoe
+ * @brief DaneJoe 命名空间
+ */
+namespace DaneJoe
+{
+    /**
+     * @struct FrameChunkConfig
+     * @brief 帧分片配置
+     */
+    struct FrameChunkConfig
+    {
+        /// @brief 是否启用分片
+        bool is_enabled = false;
+        /// @brief 分片负载大小（字节），不超过该大小的帧按完整帧发送
+        uint32_t chunk_size = 64 * 1024;
+        /// @brief 每轮调度中控制帧（小帧）的权重
+        uint32_t control_weight = 4;
+        /// @brief 每轮调度中大帧分片的权重
+        uint32_t bulk_weight = 1;
+    };
+    /**
+     * @class FrameChunker
+     * @brief 帧分片器
+     * @details 小于等于 chunk_size 的帧进入控制队列并原样输出；
+     *          大于 chunk_size 的帧分配 stream_id 并按分片输出（分片头见 ChunkHeader）。
+     *          pop_unit() 按 control_weight:bulk_weight 的比例在控制队列与大帧流之间轮转，
+     *          多个大帧流之间再按轮转方式交错。
+     * @note 非线程安全，通常由连接所在的 IO 线程独占使用。
+     */
+    class FrameChunker
+    {
+    public:
+        /**
+         * @brief 构造函数
+         * @param config 分片配置
+         */
+        FrameChunker(const FrameChunkConfig& config = FrameChunkConfig());
+        /**
+         * @brief 设置分片配置
+         * @param config 分片配置
+         */
+        void set_config(const FrameChunkConfig& config);
+        /**
+         * @brief 获取分片配置
+         * @return 分片配置
+         */
+        const FrameChunkConfig& get_config()const;
+        /**
+         * @brief 压入待发送的完整帧
+         * @param frame 完整帧（包含 SerializeHeader）
+         */
+        void push_frame(std::vector<uint8_t> frame);
+        /**
+         * @brief 弹出下一个待发送单元
+         * @return 完整的小帧或一个分片（含分片头）；无待发送数据时返回 std::nullopt
+         */
+        std::optional<std::vector<uint8_t>> pop_unit();
+        /**
+         * @brief 将若干待发送单元追加到缓冲区
+         * @param buffer 目标缓冲区
+         * @param low_watermark 缓冲区低水位（字节），缓冲区达到该大小后停止追加
+         * @return 追加的字节数
+         * @details 只在缓冲区不足低水位时追加，使新到达的控制帧能尽快插入到大帧分片之间。
+         */
+        std::size_t fill_buffer(std::vector<uint8_t>& buffer, std::size_t low_watermark);
+        /**
+         * @brief 是否存在待发送数据
+         * @return 存在返回 true
+         */
+        bool has_pending()const;
+    private:
+        /**
+         * @struct ChunkStream
+         * @brief 正在分片发送的大帧
+         */
+        struct ChunkStream
+        {
+            /// @brief 消息流标识
+            uint32_t stream_id = 0;
+            /// @brief 完整帧数据
+            std::vector<uint8_t> frame;
+            /// @brief 已发送的偏移
+            std::size_t offset = 0;
+        };
+        /**
+         * @brief 从大帧流队首生成一个分片
+         * @return 分片数据（含分片头）
+         */
+        std::vector<uint8_t> pop_bulk_chunk();
+    private:
+        /// @brief 分片配置
+        FrameChunkConfig m_config;
+        /// @brief 控制帧队列
+        std::deque<std::vector<uint8_t>> m_control_frames;
+        /// @brief 大帧流队列（轮转）
+        std::deque<ChunkStream> m_bulk_streams;
+        /// @brief 下一个分配的消息流标识
+        uint32_t m_next_stream_id = 1;
+        /// @brief 当前轮次已输出的控制帧数量
+        uint32_t m_control_served = 0;
+        /// @brief 当前轮次已输出的分片数量
+        uint32_t m_bulk_served = 0;
+    };
+}
@@ -95,6 +95,15 @@ namespace DaneJoe
          * @brief 原始数据的最小长度
          */
         static uint32_t min_serialized_byte_array_size();
+        /**
+         * @brief 直接写入定长数组的头部（不含元素值）
+         * @param dest 目标地址（至少 min_serialized_byte_array_size() 字节）
+         * @param element_type 元素类型
+         * @param element_size 元素宽度
+         * @param element_count 元素数量
+         * @note 与 to_serialized_byte_array() 在定长数组下的头部布局一致，供编码器原地构建使用。
+         */
+        static void write_fixed_header(uint8_t* dest, DataType element_type, uint32_t element_size, uint32_t element_count);
         /**
          * @brief 获取结构体所有成员序列化需要的大小
          * @note 包含可变长度部分
@@ -165,14 +174,15 @@ namespace DaneJoe
         }
         else
         {
-            // 此处是指定元素数组不需要乘以元素大小
-            result.resize(array_value.element_count);
-            uint32_t current_index = 0;
-            for (uint32_t i = 0; i < array_value.element_count; ++i)
+            if (array_value.element_value.size() < static_cast<std::size_t>(array_value.element_count) * sizeof(T))
             {
-                to_local_byte_order(reinterpret_cast<uint8_t*>(&(result[i])), reinterpret_cast<const T*>(array_value.element_value.data() + current_index));
-                current_index += sizeof(T);
+                ADD_DIAG_ERROR("network", "to_array element_value size not match element_count");
+                return std::vector<T>();
             }
+            // 此处是指定元素数组不需要乘以元素大小
+            result.resize(array_value.element_count);
+            // 整段批量翻转，由 byte_swap_copy 选择向量内核
+            to_local_byte_order(reinterpret_cast<uint8_t*>(result.data()), reinterpret_cast<const T*>(array_value.element_value.data()), array_value.element_count);
         }
         return result;
     }
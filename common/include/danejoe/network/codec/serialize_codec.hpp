@@ -10,6 +10,7 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 #include <map>
 #include <optional>
 #include <vector>
@@ -40,6 +41,9 @@ namespace DaneJoe
      * @note 序列化到字节流的数据默认使用大端（网络字节序）。
      * @note 存储到 SerializeField 结构体中的 value 默认为本地字节序；写入字节流时转换为网络字节序。
      * @note 内部在序列化前通常不会对字段长度进行严格检查，调用方应确保数据与配置约束一致。
+     * @note 构建时按 SerializeConfig::version 选择字段名编码或紧凑编码；解析时按消息头版本自动选择。
+     * @note 构建时字段直接写入构建缓冲区，不生成中间字节数组；编码器可按线程复用，
+     *       配合 reset_build(std::vector<uint8_t>&&) 与 take_serialized_data_vector_build() 回收缓冲区，稳态下构建不再分配内存。
      * @todo 当前未使用版本以及校验和反序列化最终长度检查等实现，后续再引入
      */
     class SerializeCodec
@@ -59,6 +63,12 @@ namespace DaneJoe
          * @brief 重置构建容器和构建映射
          */
         void reset_build();
+        /**
+         * @brief 以调用方提供的缓冲区重置构建
+         * @param buffer 构建缓冲区（移动接管，沿用其容量）
+         * @details 通常传入上一次 take_serialized_data_vector_build() 取出且已使用完毕的缓冲区。
+         */
+        void reset_build(std::vector<uint8_t>&& buffer);
         /**
          * @brief 重置解析容器和解析映射
          */
@@ -82,8 +92,15 @@ namespace DaneJoe
         std::optional<SerializeField> get_parsed_field(const std::string& key)const;
         /**
          * @brief 序列化好的字节流数据
+         * @note 返回副本，构建缓冲区保留在编码器内。
          */
         std::vector<uint8_t> get_serialized_data_vector_build()noexcept;
+        /**
+         * @brief 取出序列化好的字节流数据
+         * @return 以移动方式交出的构建缓冲区
+         * @details 交出后编码器处于重置后的构建状态，可直接开始下一次构建。
+         */
+        std::vector<uint8_t> take_serialized_data_vector_build()noexcept;
         /**
          * @brief 反序列化字节流数据
          */
@@ -143,14 +160,12 @@ namespace DaneJoe
             {
                 return serialize(std::string(data), data_name);
             }
-            SerializeField field;
-            field.name = std::vector<uint8_t>(data_name.begin(), data_name.end());
-            field.name_length = field.name.size();
-            field.type = get_data_type<T>();
-            field.flag = SerializeFieldFlag::None;
-            field.value = to_byte_array(data);
-            field.value_length = field.value.size();
-            return serialize(field);
+            else
+            {
+                write_field(data_name, get_data_type<T>(), SerializeFieldFlag::None,
+                    reinterpret_cast<const uint8_t*>(&data), sizeof(T));
+                return *this;
+            }
         }
         /**
          * @brief 序列化模板
@@ -170,56 +185,32 @@ namespace DaneJoe
                 ADD_DIAG_WARN("network", "Serialize data skipped: data is null or size is 0");
                 return *this;
             }
-            SerializeField field;
-            field.name = std::vector<uint8_t>(data_name.begin(), data_name.end());
-            field.name_length = field.name.size();
-            if (size > 1)
+            if (size == 1)
             {
-                // char*的多元素数据按字符串类型进行处理
-                // 需要区分一下字节流
-                if (std::is_same_v<T, char>)
-                {
-                    field.type = DaneJoe::DataType::String;
-                }
-                else
-                {
-                    field.type = DaneJoe::DataType::Array;
-                }
-                // 数组和字符串类型使用长度信息
-                field.flag = SerializeFieldFlag::HasValueLength;
+                // 普通类型不使用长度信息
+                write_field(data_name, get_data_type<T>(), SerializeFieldFlag::None,
+                    reinterpret_cast<const uint8_t*>(data), sizeof(T));
             }
-            else
+            else if constexpr (std::is_same_v<T, char>)
             {
-                field.type = get_data_type<T>();
-                // 普通类型不使用长度信息
-                field.flag = SerializeFieldFlag::None;
+                // char*的多元素数据按字符串类型进行处理
+                write_field(data_name, DaneJoe::DataType::String, SerializeFieldFlag::HasValueLength,
+                    reinterpret_cast<const uint8_t*>(data), size);
             }
-            if (field.type == DaneJoe::DataType::Array)
+            else
             {
-                SerializeArrayValue array_value;
-                array_value.element_type = get_data_type<T>();
-                array_value.element_count = size;
-                // 此处不判断是否变长
+                // 定长数组：数组头与元素直接写入构建缓冲区，元素整段转换为网络字节序
                 /// @todo 对于ptr**和嵌套容器如std::string<std::string>去单独实现模板变长
-                array_value.flag = SerializeArrayFlag::None;
-                array_value.element_value_length.push_back(sizeof(T));
-                // 此处是字节流数组
-                array_value.element_value.resize(sizeof(T) * size);
-                uint32_t current_index = 0;
-
-                for (uint32_t i = 0; i < size; i++)
+                uint32_t header_size = SerializeArrayValue::min_serialized_byte_array_size();
+                uint8_t* dest = reserve_field_value(data_name, DaneJoe::DataType::Array, header_size + sizeof(T) * size);
+                if (dest == nullptr)
                 {
-                    to_network_byte_order(array_value.element_value.data() + current_index, data[i]);
-                    current_index += sizeof(T);
+                    return *this;
                 }
-                field.value = array_value.to_serialized_byte_array();
-            }
-            else
-            {
-                field.value = to_byte_array<T>(data, size);
+                SerializeArrayValue::write_fixed_header(dest, get_data_type<T>(), sizeof(T), size);
+                to_network_byte_order(dest + header_size, data, size);
             }
-            field.value_length = field.value.size();
-            return serialize(field);
+            return *this;
         }
         /**
          * @brief 序列化模板
@@ -264,14 +255,9 @@ namespace DaneJoe
             const std::string& data,
             const std::string& data_name)
         {
-            SerializeField field;
-            field.name = std::vector<uint8_t>(data_name.begin(), data_name.end());
-            field.name_length = field.name.size();
-            field.type = DaneJoe::DataType::String;
-            field.flag = SerializeFieldFlag::HasValueLength;
-            field.value = std::vector<uint8_t>(data.begin(), data.end());
-            field.value_length = field.value.size();
-            return serialize(field);
+            write_field(data_name, DaneJoe::DataType::String, SerializeFieldFlag::HasValueLength,
+                reinterpret_cast<const uint8_t*>(data.data()), data.size());
+            return *this;
         }
         /**
          * @brief 获取消息头大小
@@ -283,6 +269,50 @@ namespace DaneJoe
          * @return 返回字段信息映射表
          */
         std::unordered_multimap<std::string, SerializeField> get_parsed_data_map()const noexcept;
+    private:
+        /**
+         * @brief 将字段直接写入构建缓冲区
+         * @param name 字段名
+         * @param type 字段类型
+         * @param flag 字段标志（紧凑编码下不使用）
+         * @param value 字段值（定长类型为本地字节序）
+         * @param value_length 字段值长度
+         * @details 紧凑编码下字段名替换为标签表中的数值标签（未登记时为 0 加字段名），
+         *          整数值使用 LEB128 变长编码（有符号整数先做 ZigZag 映射），变长值使用变长长度前缀。
+         */
+        void write_field(std::string_view name, DataType type, SerializeFieldFlag flag, const uint8_t* value, uint32_t value_length);
+        /**
+         * @brief 写入变长字段前缀并预留值空间
+         * @param name 字段名
+         * @param type 字段类型（变长类型）
+         * @param value_length 字段值长度
+         * @return 值空间起始地址；字段超出配置限制时返回 nullptr
+         * @note 返回的地址仅在下一次写入前有效。
+         */
+        uint8_t* reserve_field_value(std::string_view name, DataType type, uint32_t value_length);
+        /**
+         * @brief 写入字段前缀（字段名或标签、类型、标志与值长度）
+         * @param name 字段名
+         * @param type 字段类型
+         * @param flag 字段标志
+         * @param value_length 字段值长度
+         * @note 调用前需确保构建缓冲区容量足够。
+         */
+        void write_field_prefix(std::string_view name, DataType type, SerializeFieldFlag flag, uint32_t value_length);
+        /**
+         * @brief 检查字段是否在配置限制内
+         * @param name_length 字段名长度
+         * @param value_length 字段值长度
+         * @return 未超出限制返回 true
+         */
+        bool is_field_within_limit(std::size_t name_length, uint64_t value_length)const;
+        /**
+         * @brief 解析紧凑编码的字段
+         * @param data 序列化数据
+         * @param header 消息头
+         * @details 还原后的字段与字段名编码解析结果一致（字段名、本地字节序的定长值），上层取值方式不变。
+         */
+        void deserialize_compact(const std::vector<uint8_t>& data, const SerializeHeader& header);
     private:
         /// @brief 头部大小固定16字节
         static const uint32_t HEADER_SIZE;
@@ -303,8 +333,8 @@ namespace DaneJoe
         std::vector<uint8_t> m_serialized_byte_array_build;
         /// @brief 接收到的序列化字节流
         std::vector<uint8_t> m_serialized_byte_array_parsed;
-        /// @brief 构建的序列化字节流映射
-        std::unordered_multimap<std::string, SerializeField> m_serialized_data_map_build;
+        /// @brief 已构建的字段数量
+        uint16_t m_build_field_count = 0;
         /// @brief 接收到的序列化字节流映射
         std::unordered_multimap<std::string, SerializeField> m_serialized_data_map_parsed;
 
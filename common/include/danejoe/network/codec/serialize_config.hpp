@@ -9,6 +9,10 @@
 #pragma once
 
 #include <cstdint>
+#include <memory>
+
+#include "danejoe/network/codec/serialize_header.hpp"
+#include "danejoe/network/codec/serialize_field_tag_table.hpp"
 
  /**
   * @namespace DaneJoe
@@ -22,6 +26,8 @@ namespace DaneJoe
      * @details 用于控制序列化编码器的行为：
      *          - max_field_value_length/max_field_name_length：字段长度上限（用于边界检查）
      *          - pre_allocated_size：构建序列化字节流时的预分配容量
+     *          - version/field_tag_table：构建时使用的编码版本，以及紧凑编码下的字段标签表
+     * @note 解析时按消息头中的版本选择解码方式，与 version 配置无关；紧凑编码同样需要标签表还原字段名。
      */
     struct SerializeConfig
     {
@@ -31,6 +37,10 @@ namespace DaneJoe
         uint32_t max_field_name_length = 128;
         /// @brief 预分配大小
         uint32_t pre_allocated_size = 4 * 1024;
+        /// @brief 构建时使用的编码版本
+        SerializeVersion version = SerializeVersion::Named;
+        /// @brief 字段标签表（紧凑编码使用，可为空）
+        std::shared_ptr<const SerializeFieldTagTable> field_tag_table = nullptr;
         /**
          * @brief 构造函数
          */
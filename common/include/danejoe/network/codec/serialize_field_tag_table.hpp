@@ -0,0 +1,88 @@
+/**
+ * @file serialize_field_tag_table.hpp
+ * @author DaneJoe (danejoe001.github)
+ * @brief 字段标签表
+ * @version 0.2.0
+ * @date 2026-01-06
+ * @details 定义 SerializeFieldTagTable，用于紧凑编码模式下字段名与数值标签之间的双向映射。
+ *          通信双方需使用一致的标签表；未登记的字段名以标签 0 加字段名的形式编码，保证仍可解析。
+ */
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <cstdint>
+#include <optional>
+#include <functional>
+#include <unordered_map>
+#include <initializer_list>
+
+/**
+ * @namespace DaneJoe
+ * @brief DaneJoe 命名空间
+ */
+namespace DaneJoe
+{
+    /**
+     * @class SerializeFieldTagTable
+     * @brief 字段标签表
+     * @note 标签 0 保留，表示字段名随字段一同编码。
+     */
+    class SerializeFieldTagTable
+    {
+    public:
+        /**
+         * @brief 构造函数
+         */
+        SerializeFieldTagTable() = default;
+        /**
+         * @brief 构造函数
+         * @param entries 标签与字段名列表
+         */
+        SerializeFieldTagTable(std::initializer_list<std::pair<uint32_t, std::string>> entries);
+        /**
+         * @brief 登记字段标签
+         * @param tag 数值标签（非 0）
+         * @param name 字段名
+         * @return 登记成功返回 true；标签为 0 或标签/字段名已存在时返回 false
+         */
+        bool add(uint32_t tag, const std::string& name);
+        /**
+         * @brief 通过字段名获取标签
+         * @param name 字段名
+         * @return 标签；未登记时返回 std::nullopt
+         * @note 支持异构查找，查询时不构造临时字符串。
+         */
+        std::optional<uint32_t> get_tag(std::string_view name)const;
+        /**
+         * @brief 通过标签获取字段名
+         * @param tag 标签
+         * @return 字段名；未登记时返回 std::nullopt
+         */
+        std::optional<std::string> get_name(uint32_t tag)const;
+    private:
+        /**
+         * @struct NameHash
+         * @brief 支持 std::string_view 异构查找的字段名哈希
+         */
+        struct NameHash
+        {
+            /// @brief 启用异构查找
+            using is_transparent = void;
+            /**
+             * @brief 计算字段名哈希
+             * @param name 字段名
+             * @return 哈希值
+             */
+            std::size_t operator()(std::string_view name)const noexcept
+            {
+                return std::hash<std::string_view>{}(name);
+            }
+        };
+    private:
+        /// @brief 字段名到标签的映射
+        std::unordered_map<std::string, uint32_t, NameHash, std::equal_to<>> m_name_to_tag;
+        /// @brief 标签到字段名的映射
+        std::unordered_map<uint32_t, std::string> m_tag_to_name;
+    };
+}
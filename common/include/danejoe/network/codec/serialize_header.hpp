@@ -23,6 +23,18 @@
  */
 namespace DaneJoe
 {
+    /**
+     * @enum SerializeVersion
+     * @brief 消息编码版本
+     * @details 写入 SerializeHeader::version，解码端据此选择字段解析方式。
+     */
+    enum class SerializeVersion :uint8_t
+    {
+        /// @brief 字段名编码：name_length | name | type | flag | (value_length) | value
+        Named = 1,
+        /// @brief 紧凑编码：数值标签与 LEB128 变长整数
+        Compact = 2,
+    };
     /**
      * @enum SerializeFlag
      * @brief 消息标志位
@@ -0,0 +1,63 @@
+/**
+ * @file varint.hpp
+ * @author DaneJoe (danejoe001.github)
+ * @brief 变长整数编码
+ * @version 0.2.0
+ * @date 2026-01-06
+ * @details 提供 LEB128 无符号变长整数与 ZigZag 有符号映射，用于紧凑编码模式（SerializeVersion::Compact）。
+ *          每个字节低 7 位为数据，最高位表示是否还有后续字节，uint64_t 最多占用 10 字节。
+ */
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <optional>
+
+/**
+ * @namespace DaneJoe
+ * @brief DaneJoe 命名空间
+ */
+namespace DaneJoe
+{
+    /// @brief uint64_t 变长编码的最大字节数
+    constexpr uint32_t MAX_VARINT_SIZE = 10;
+    /**
+     * @brief 获取变长编码所需字节数
+     * @param value 待编码的值
+     * @return 字节数（1~10）
+     */
+    uint32_t get_varint_size(uint64_t value);
+    /**
+     * @brief 写入变长编码
+     * @param dest 目标地址（调用方需保证至少有 get_varint_size(value) 字节）
+     * @param value 待编码的值
+     * @return 写入的字节数
+     */
+    uint32_t write_varint(uint8_t* dest, uint64_t value);
+    /**
+     * @brief 读取变长编码
+     * @param data 数据起始地址
+     * @param size 可读字节数
+     * @param read_size 输出：实际读取的字节数
+     * @return 解码后的值；数据不完整或超过 10 字节时返回 std::nullopt
+     */
+    std::optional<uint64_t> read_varint(const uint8_t* data, std::size_t size, uint32_t& read_size);
+    /**
+     * @brief ZigZag 编码（有符号映射为无符号）
+     * @param value 有符号值
+     * @return 映射后的无符号值，使绝对值较小的负数也只占用少量字节
+     */
+    inline uint64_t zigzag_encode(int64_t value)
+    {
+        return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+    }
+    /**
+     * @brief ZigZag 解码
+     * @param value 无符号值
+     * @return 还原后的有符号值
+     */
+    inline int64_t zigzag_decode(uint64_t value)
+    {
+        return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+    }
+}
@@ -9,6 +9,8 @@
  */
 #pragma once
 
+#include <cstdint>
+
 #include "danejoe/network/container/buffer.hpp"
 #include "danejoe/common/type_traits/platform_traits.hpp"
 
@@ -19,6 +21,25 @@
 namespace DaneJoe
 {
 #if DANEJOE_PLATFORM_LINUX==1
+    /**
+     * @struct FrameTrace
+     * @brief 帧跟踪信息
+     * @details 启用 TraceRecorder 时由 IO 线程与邮箱填写时间戳（CLOCK_MONOTONIC_RAW 纳秒），
+     *          业务线程解析出 request_id 后补记；未启用时各时间戳为 0。
+     */
+    struct FrameTrace
+    {
+        /// @brief 请求ID（响应帧由业务线程填写，请求帧在解析前为 -1）
+        int64_t request_id = -1;
+        /// @brief 读到帧首字节的时间
+        int64_t first_byte_time = 0;
+        /// @brief 帧组装完成的时间
+        int64_t assembled_time = 0;
+        /// @brief 投递到邮箱的时间
+        int64_t pushed_time = 0;
+        /// @brief 业务线程取出的时间
+        int64_t popped_time = 0;
+    };
     /**
      * @struct PosixFrame
      * @brief POSIX 传输帧
@@ -30,6 +51,8 @@ namespace DaneJoe
         uint64_t connect_id;
         /// @brief 帧数据载荷（原始字节序列）
         Buffer data;
+        /// @brief 跟踪信息
+        FrameTrace trace;
     };
 #endif
 };
\ No newline at end of file
@@ -9,9 +9,13 @@
  */
 #pragma once
 
+#include <vector>
+#include <cstdint>
+
 #include "danejoe/common/type_traits/platform_traits.hpp"
 #include "danejoe/network/handle/posix_socket_handle.hpp"
 #include "danejoe/network/codec/frame_assembler.hpp"
+#include "danejoe/network/codec/frame_chunker.hpp"
 #include "danejoe/common/result/result.hpp"
 #include "danejoe/network/container/posix_frame.hpp"
 
@@ -28,6 +32,8 @@ namespace DaneJoe
      * @details 用于管理一个连接的读写过程：
      *          - read() 从 socket 读取字节并交由 FrameAssembler 组装为 PosixFrame
      *          - write() 将待发送帧写入 socket，并在必要时缓存未写完的字节
+     *          - 启用分片时，待发送帧先交给 FrameChunker 调度，写缓冲只保留少量分片，
+     *            使后到的小帧可以插入到大帧分片之间发送
      * @note 线程安全：通常假设同一连接的 read/write 在同一线程或外部同步下调用。
      */
     class ConnectContext
@@ -57,6 +63,11 @@ namespace DaneJoe
          * @return 若存在未写完的数据则返回 true，否则返回 false
          */
         bool has_pending_write() const;
+        /**
+         * @brief 设置帧分片配置
+         * @param config 分片配置
+         */
+        void set_chunk_config(const FrameChunkConfig& config);
         /**
          * @brief 获取连接标识
          * @return 连接标识
@@ -64,7 +75,7 @@ namespace DaneJoe
         uint64_t get_connect_id()const;
     private:
         /// @brief 每次从 socket 读取的缓冲区大小（字节）
-        const int BUFFER_SIZE = 1024;
+        const int BUFFER_SIZE = 64 * 1024;
         /// @brief 连接标识
         uint64_t m_connect_id = 0;
         /// @brief 套接字句柄
@@ -73,6 +84,12 @@ namespace DaneJoe
         FrameAssembler m_frame_assembler;
         /// @brief 待发送缓存（用于保存未写完的数据）
         Buffer m_write_buffer;
+        /// @brief 帧分片器（调度待发送帧）
+        FrameChunker m_frame_chunker;
+        /// @brief 正在组装的帧读到首字节的时间（仅启用跟踪时记录，0 表示没有残留数据）
+        int64_t m_first_byte_time = 0;
+        /// @brief 已交给发送队列但尚未完全写出的响应请求ID（仅启用跟踪时记录）
+        std::vector<int64_t> m_unwritten_request_ids;
     };
 #endif
 }
\ No newline at end of file
@@ -74,6 +74,12 @@ namespace DaneJoe
             std::shared_ptr<PosixEventHandle> event_handle,
             PosixSocketHandle&& server_handle,
             PosixEpollHandle&& epoll_handle);
+        /**
+         * @brief 设置帧分片配置
+         * @param config 分片配置
+         * @details 对之后接受的连接生效，需在 run() 之前调用。
+         */
+        void set_chunk_config(const FrameChunkConfig& config);
         /**
          * @brief 运行事件循环
          * @details 通常为阻塞循环；直到 stop() 触发退出。
@@ -129,6 +135,8 @@ namespace DaneJoe
         std::shared_ptr<PosixEventHandle> m_event_handle;
         /// @brief 服务器监听 socket 句柄
         PosixSocketHandle m_server_handle;
+        /// @brief 新连接使用的帧分片配置
+        FrameChunkConfig m_chunk_config;
     };
 #endif
 }
\ No newline at end of file
@@ -0,0 +1,100 @@
+/**
+ * @file adaptive_block_size.hpp
+ * @author DaneJoe (danejoe001.github)
+ * @brief 自适应块大小
+ * @version 0.2.0
+ * @date 2026-01-06
+ * @details 定义 AdaptiveBlockSize 与 AdaptiveBlockSizeConfig，用于按观测到的单块时延与吞吐决定下一个块的长度。
+ *          目标是让单个块的传输耗时接近 target_block_duration：
+ *          - 高速低时延链路上块变大，摊薄每个请求的固定开销
+ *          - 低速或丢包链路上块变小，降低单次重传的代价
+ */
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+/**
+ * @namespace DaneJoe
+ * @brief DaneJoe 命名空间
+ */
+namespace DaneJoe
+{
+    /**
+     * @struct AdaptiveBlockSizeConfig
+     * @brief 自适应块大小配置
+     */
+    struct AdaptiveBlockSizeConfig
+    {
+        /// @brief 最小块大小（字节）
+        int64_t min_block_bytes = 64 * 1024;
+        /// @brief 初始块大小（字节）
+        int64_t initial_block_bytes = 1024 * 1024;
+        /// @brief 最大块大小（字节）
+        int64_t max_block_bytes = 32 * 1024 * 1024;
+        /// @brief 块大小对齐粒度（字节）
+        int64_t alignment_bytes = 4 * 1024;
+        /// @brief 单个块的目标传输耗时
+        std::chrono::milliseconds target_block_duration = std::chrono::milliseconds(250);
+    };
+    /**
+     * @class AdaptiveBlockSize
+     * @brief 自适应块大小
+     * @details 每完成一个块，按该块的吞吐（字节 / 从发出到收到的时延）估计目标耗时内可传输的字节数，
+     *          单次调整不超过当前大小的两倍或一半；块丢失时大小减半。
+     * @note 非线程安全，通常由调度线程独占使用。
+     */
+    class AdaptiveBlockSize
+    {
+    public:
+        /**
+         * @brief 构造函数
+         * @param config 块大小配置
+         */
+        AdaptiveBlockSize(const AdaptiveBlockSizeConfig& config = AdaptiveBlockSizeConfig());
+        /**
+         * @brief 设置块大小配置
+         * @param config 块大小配置
+         * @details 当前块大小重置为初始块大小。
+         */
+        void set_config(const AdaptiveBlockSizeConfig& config);
+        /**
+         * @brief 获取块大小配置
+         * @return 块大小配置
+         */
+        AdaptiveBlockSizeConfig get_config()const;
+        /**
+         * @brief 记录一个块完成
+         * @param bytes 块字节数
+         * @param latency 从发出请求到收到响应的时延
+         */
+        void on_block_completed(int64_t bytes, std::chrono::nanoseconds latency);
+        /**
+         * @brief 记录一个块丢失（超时或失败）
+         */
+        void on_block_lost();
+        /**
+         * @brief 获取当前块大小
+         * @return 块大小（字节）
+         */
+        int64_t get_block_bytes()const;
+        /**
+         * @brief 获取下一个块的长度
+         * @param remaining_bytes 剩余未分配的字节数
+         * @return 块长度；剩余部分不足最小块大小时并入当前块
+         */
+        int64_t get_next_length(int64_t remaining_bytes)const;
+    private:
+        /**
+         * @brief 将块大小对齐并限制在配置范围内
+         * @param bytes 块大小
+         * @return 调整后的块大小
+         */
+        int64_t normalize(int64_t bytes)const;
+    private:
+        /// @brief 块大小配置
+        AdaptiveBlockSizeConfig m_config;
+        /// @brief 当前块大小
+        int64_t m_block_bytes = 0;
+    };
+}
@@ -0,0 +1,172 @@
+/**
+ * @file adaptive_window.hpp
+ * @author DaneJoe (danejoe001.github)
+ * @brief 自适应请求窗口
+ * @version 0.2.0
+ * @date 2026-01-06
+ * @details 定义 AdaptiveWindow 与 AdaptiveWindowConfig，用于按“带宽 × 最小往返时延”（BDP）估计
+ *          请求-响应式传输中应保持的在途请求数量。
+ *          - 往返时延：按 RFC 6298 维护平滑 RTT 与偏差，并记录一段时间内的最小 RTT
+ *          - 带宽：每轮（约一个窗口的确认）计算一次交付速率，取最近若干轮的最大值
+ *          - 窗口：window_gain × BDP / 平均请求字节数，增益大于 1 以持续探测可用带宽
+ */
+#pragma once
+
+#include <deque>
+#include <chrono>
+#include <cstdint>
+
+/**
+ * @namespace DaneJoe
+ * @brief DaneJoe 命名空间
+ */
+namespace DaneJoe
+{
+    /**
+     * @struct AdaptiveWindowConfig
+     * @brief 自适应窗口配置
+     */
+    struct AdaptiveWindowConfig
+    {
+        /// @brief 初始窗口（请求数），尚无带宽样本时使用
+        int64_t initial_window = 4;
+        /// @brief 最小窗口（请求数）
+        int64_t min_window = 2;
+        /// @brief 最大窗口（请求数）
+        int64_t max_window = 256;
+        /// @brief BDP 增益
+        double window_gain = 2.0;
+        /// @brief 带宽最大值滤波保留的轮数
+        std::size_t bandwidth_round_count = 8;
+        /// @brief 最小 RTT 的有效期，超时后以最新样本重新计算
+        std::chrono::milliseconds min_rtt_expiry = std::chrono::milliseconds(10000);
+        /// @brief 重传超时下限
+        std::chrono::milliseconds min_retransmit_timeout = std::chrono::milliseconds(1000);
+    };
+    /**
+     * @class AdaptiveWindow
+     * @brief 自适应请求窗口
+     * @details 调用方在发出请求时调用 on_sent()，收到响应时调用 on_acked()，
+     *          请求超时或失败时调用 on_lost()，主动撤销时调用 on_cancelled()；
+     *          can_send() 为 true 时可继续发出请求。
+     * @note 非线程安全，通常由调度线程独占使用。
+     */
+    class AdaptiveWindow
+    {
+    public:
+        /// @brief 时钟类型
+        using Clock = std::chrono::steady_clock;
+        /**
+         * @brief 构造函数
+         * @param config 窗口配置
+         */
+        AdaptiveWindow(const AdaptiveWindowConfig& config = AdaptiveWindowConfig());
+        /**
+         * @brief 设置窗口配置
+         * @param config 窗口配置
+         */
+        void set_config(const AdaptiveWindowConfig& config);
+        /**
+         * @brief 获取窗口配置
+         * @return 窗口配置
+         */
+        AdaptiveWindowConfig get_config()const;
+        /**
+         * @brief 记录发出一个请求
+         */
+        void on_sent();
+        /**
+         * @brief 记录收到一个响应
+         * @param rtt 该请求的往返时延
+         * @param bytes 该请求交付的字节数
+         * @param now 当前时间
+         */
+        void on_acked(std::chrono::nanoseconds rtt, int64_t bytes, Clock::time_point now = Clock::now());
+        /**
+         * @brief 记录一个请求丢失（超时或失败）
+         * @details 释放在途计数，清空带宽样本并将窗口减半，随后重新探测。
+         */
+        void on_lost();
+        /**
+         * @brief 撤销一个在途请求
+         * @details 仅释放在途计数，不影响带宽与窗口估计（如任务被取消）。
+         */
+        void on_cancelled();
+        /**
+         * @brief 是否可以继续发出请求
+         * @return 在途数量小于窗口时返回 true
+         */
+        bool can_send()const;
+        /**
+         * @brief 获取当前窗口（请求数）
+         */
+        int64_t get_window()const;
+        /**
+         * @brief 获取在途请求数
+         */
+        int64_t get_in_flight()const;
+        /**
+         * @brief 获取平滑 RTT
+         */
+        std::chrono::nanoseconds get_smoothed_rtt()const;
+        /**
+         * @brief 获取最小 RTT
+         */
+        std::chrono::nanoseconds get_min_rtt()const;
+        /**
+         * @brief 获取带宽估计（字节/秒）
+         */
+        double get_bandwidth()const;
+        /**
+         * @brief 获取重传超时
+         * @details srtt + 4 × rttvar，且不低于 min_retransmit_timeout。
+         */
+        std::chrono::nanoseconds get_retransmit_timeout()const;
+    private:
+        /**
+         * @brief 更新 RTT 估计
+         * @param rtt RTT 样本
+         * @param now 当前时间
+         */
+        void update_rtt(std::chrono::nanoseconds rtt, Clock::time_point now);
+        /**
+         * @brief 累计本轮交付量，轮次结束时产生带宽样本
+         * @param bytes 交付字节数
+         * @param now 当前时间
+         */
+        void update_bandwidth(int64_t bytes, Clock::time_point now);
+        /**
+         * @brief 按 BDP 重新计算窗口
+         */
+        void update_window();
+    private:
+        /// @brief 窗口配置
+        AdaptiveWindowConfig m_config;
+        /// @brief 当前窗口
+        int64_t m_window = 0;
+        /// @brief 在途请求数
+        int64_t m_in_flight = 0;
+        /// @brief 是否已有 RTT 样本
+        bool m_has_rtt_sample = false;
+        /// @brief 平滑 RTT（纳秒）
+        double m_smoothed_rtt_ns = 0.0;
+        /// @brief RTT 偏差（纳秒）
+        double m_rtt_variance_ns = 0.0;
+        /// @brief 最小 RTT（纳秒）
+        double m_min_rtt_ns = 0.0;
+        /// @brief 最小 RTT 的记录时间
+        Clock::time_point m_min_rtt_stamp;
+        /// @brief 平均请求字节数
+        double m_average_bytes = 0.0;
+        /// @brief 本轮开始时间
+        Clock::time_point m_round_start;
+        /// @brief 本轮已确认的请求数
+        int64_t m_round_acked = 0;
+        /// @brief 本轮已交付的字节数
+        int64_t m_round_bytes = 0;
+        /// @brief 本轮需要确认的请求数
+        int64_t m_round_target = 0;
+        /// @brief 最近若干轮的带宽样本（字节/秒）
+        std::deque<double> m_bandwidth_samples;
+    };
+}
@@ -0,0 +1,115 @@
+/**
+ * @file least_outstanding_balancer.hpp
+ * @author DaneJoe (danejoe001.github)
+ * @brief 最少在途字节负载均衡
+ * @version 0.2.0
+ * @date 2026-01-06
+ * @details 定义 LeastOutstandingBalancer，用于在同一端点的多条连接之间分配请求：
+ *          每个请求记录其期望响应的字节数，新请求总是分配给在途字节最少的连接。
+ *          与轮询相比，大小不一的请求不会在某条连接上堆积。
+ */
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <optional>
+#include <unordered_map>
+
+/**
+ * @namespace DaneJoe
+ * @brief DaneJoe 命名空间
+ */
+namespace DaneJoe
+{
+    /**
+     * @class LeastOutstandingBalancer
+     * @brief 最少在途字节负载均衡器
+     * @details 以槽位（slot）表示连接，槽位下标由 add_slot() 按顺序分配。
+     *          请求发出时调用 on_dispatched()，收到响应、超时或取消时调用 on_finished()，
+     *          连接断开时调用 clear_slot()。
+     * @note 非线程安全，通常由网络线程独占使用。
+     */
+    class LeastOutstandingBalancer
+    {
+    public:
+        /**
+         * @brief 添加一个槽位
+         * @return 新槽位的下标
+         */
+        std::size_t add_slot();
+        /**
+         * @brief 获取槽位数量
+         */
+        std::size_t get_slot_count()const;
+        /**
+         * @brief 选择在途字节最少的槽位
+         * @return 槽位下标；无槽位时返回空
+         * @details 在途字节相同时选择在途请求较少者，仍相同时选择下标较小者。
+         */
+        std::optional<std::size_t> select()const;
+        /**
+         * @brief 是否应当新增槽位
+         * @param max_slot_count 槽位上限
+         * @return 未达上限且所有槽位均有在途请求时返回 true
+         */
+        bool should_add_slot(std::size_t max_slot_count)const;
+        /**
+         * @brief 记录请求已分配到槽位
+         * @param request_id 请求ID
+         * @param slot 槽位下标
+         * @param bytes 期望响应的字节数
+         */
+        void on_dispatched(uint64_t request_id, std::size_t slot, int64_t bytes);
+        /**
+         * @brief 记录请求结束
+         * @param request_id 请求ID
+         * @details 未记录的请求ID会被忽略。
+         */
+        void on_finished(uint64_t request_id);
+        /**
+         * @brief 清空槽位上的在途请求
+         * @param slot 槽位下标
+         * @return 原先分配到该槽位的请求ID
+         * @details 连接断开时调用，槽位本身保留，可在重新建立连接后继续使用。
+         */
+        std::vector<uint64_t> clear_slot(std::size_t slot);
+        /**
+         * @brief 获取槽位的在途字节数
+         * @param slot 槽位下标
+         */
+        int64_t get_outstanding_bytes(std::size_t slot)const;
+        /**
+         * @brief 获取槽位的在途请求数
+         * @param slot 槽位下标
+         */
+        int64_t get_outstanding_requests(std::size_t slot)const;
+    private:
+        /**
+         * @struct SlotLoad
+         * @brief 槽位负载
+         */
+        struct SlotLoad
+        {
+            /// @brief 在途字节数
+            int64_t outstanding_bytes = 0;
+            /// @brief 在途请求数
+            int64_t outstanding_requests = 0;
+        };
+        /**
+         * @struct Assignment
+         * @brief 请求分配记录
+         */
+        struct Assignment
+        {
+            /// @brief 槽位下标
+            std::size_t slot = 0;
+            /// @brief 期望响应的字节数
+            int64_t bytes = 0;
+        };
+    private:
+        /// @brief 各槽位负载
+        std::vector<SlotLoad> m_slot_loads;
+        /// @brief 在途请求的分配记录（按 request_id 索引）
+        std::unordered_map<uint64_t, Assignment> m_assignments;
+    };
+}
@@ -0,0 +1,259 @@
+#include <cstring>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define DANEJOE_BYTE_SWAP_X86 1
+#include <immintrin.h>
+#else
+#define DANEJOE_BYTE_SWAP_X86 0
+#endif
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define DANEJOE_BYTE_SWAP_NEON 1
+#include <arm_neon.h>
+#else
+#define DANEJOE_BYTE_SWAP_NEON 0
+#endif
+
+#include "danejoe/common/enum/enum_convert.hpp"
+#include "danejoe/common/binary/byte_swap.hpp"
+
+namespace
+{
+    void byte_swap_scalar(uint8_t* dest, const uint8_t* src, std::size_t element_size, std::size_t count)noexcept
+    {
+        switch (element_size)
+        {
+        case 2:
+            for (std::size_t i = 0; i < count; i++)
+            {
+                uint16_t value;
+                std::memcpy(&value, src + i * 2, 2);
+                value = __builtin_bswap16(value);
+                std::memcpy(dest + i * 2, &value, 2);
+            }
+            break;
+        case 4:
+            for (std::size_t i = 0; i < count; i++)
+            {
+                uint32_t value;
+                std::memcpy(&value, src + i * 4, 4);
+                value = __builtin_bswap32(value);
+                std::memcpy(dest + i * 4, &value, 4);
+            }
+            break;
+        case 8:
+            for (std::size_t i = 0; i < count; i++)
+            {
+                uint64_t value;
+                std::memcpy(&value, src + i * 8, 8);
+                value = __builtin_bswap64(value);
+                std::memcpy(dest + i * 8, &value, 8);
+            }
+            break;
+        default:
+            for (std::size_t i = 0; i < count; i++)
+            {
+                uint8_t* dest_ptr = dest + i * element_size;
+                const uint8_t* src_ptr = src + i * element_size;
+                // 逐对交换，保证原地翻转时结果正确
+                for (std::size_t j = 0; j < element_size / 2; j++)
+                {
+                    uint8_t low = src_ptr[j];
+                    uint8_t high = src_ptr[element_size - j - 1];
+                    dest_ptr[j] = high;
+                    dest_ptr[element_size - j - 1] = low;
+                }
+                if (element_size % 2 == 1 && dest_ptr != src_ptr)
+                {
+                    dest_ptr[element_size / 2] = src_ptr[element_size / 2];
+                }
+            }
+            break;
+        }
+    }
+
+#if DANEJOE_BYTE_SWAP_X86==1
+    /// @brief pshufb 翻转掩码（依次对应 2/4/8 字节元素）
+    alignas(16) const uint8_t SHUFFLE_MASKS[3][16] = {
+        { 1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14 },
+        { 3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12 },
+        { 7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8 } };
+
+    /**
+     * @brief 获取 pshufb 翻转掩码
+     * @param element_size 元素宽度（2/4/8）
+     * @return 16 字节掩码
+     */
+    const uint8_t* get_shuffle_mask(std::size_t element_size)noexcept
+    {
+        return SHUFFLE_MASKS[element_size == 2 ? 0 : (element_size == 4 ? 1 : 2)];
+    }
+
+    __attribute__((target("ssse3")))
+        void byte_swap_ssse3(uint8_t* dest, const uint8_t* src, std::size_t element_size, std::size_t count)noexcept
+    {
+        const __m128i mask = _mm_load_si128(reinterpret_cast<const __m128i*>(get_shuffle_mask(element_size)));
+        std::size_t total = element_size * count;
+        std::size_t index = 0;
+        for (; index + 16 <= total; index += 16)
+        {
+            __m128i value = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + index));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + index), _mm_shuffle_epi8(value, mask));
+        }
+        byte_swap_scalar(dest + index, src + index, element_size, (total - index) / element_size);
+    }
+
+    __attribute__((target("avx2")))
+        void byte_swap_avx2(uint8_t* dest, const uint8_t* src, std::size_t element_size, std::size_t count)noexcept
+    {
+        // vpshufb 在 128 位通道内独立重排，元素不跨通道，两个通道使用相同掩码
+        const __m256i mask = _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i*>(get_shuffle_mask(element_size))));
+        std::size_t total = element_size * count;
+        std::size_t index = 0;
+        for (; index + 64 <= total; index += 64)
+        {
+            __m256i first = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + index));
+            __m256i second = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + index + 32));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dest + index), _mm256_shuffle_epi8(first, mask));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dest + index + 32), _mm256_shuffle_epi8(second, mask));
+        }
+        for (; index + 32 <= total; index += 32)
+        {
+            __m256i value = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + index));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dest + index), _mm256_shuffle_epi8(value, mask));
+        }
+        byte_swap_scalar(dest + index, src + index, element_size, (total - index) / element_size);
+    }
+#endif
+
+#if DANEJOE_BYTE_SWAP_NEON==1
+    void byte_swap_neon(uint8_t* dest, const uint8_t* src, std::size_t element_size, std::size_t count)noexcept
+    {
+        std::size_t total = element_size * count;
+        std::size_t index = 0;
+        for (; index + 16 <= total; index += 16)
+        {
+            uint8x16_t value = vld1q_u8(src + index);
+            switch (element_size)
+            {
+            case 2:
+                value = vrev16q_u8(value);
+                break;
+            case 4:
+                value = vrev32q_u8(value);
+                break;
+            default:
+                value = vrev64q_u8(value);
+                break;
+            }
+            vst1q_u8(dest + index, value);
+        }
+        byte_swap_scalar(dest + index, src + index, element_size, (total - index) / element_size);
+    }
+#endif
+
+    DaneJoe::ByteSwapKernel detect_byte_swap_kernel()noexcept
+    {
+        if (DaneJoe::is_byte_swap_kernel_supported(DaneJoe::ByteSwapKernel::Avx2))
+        {
+            return DaneJoe::ByteSwapKernel::Avx2;
+        }
+        if (DaneJoe::is_byte_swap_kernel_supported(DaneJoe::ByteSwapKernel::Ssse3))
+        {
+            return DaneJoe::ByteSwapKernel::Ssse3;
+        }
+        if (DaneJoe::is_byte_swap_kernel_supported(DaneJoe::ByteSwapKernel::Neon))
+        {
+            return DaneJoe::ByteSwapKernel::Neon;
+        }
+        return DaneJoe::ByteSwapKernel::Scalar;
+    }
+}
+
+std::string DaneJoe::to_string(ByteSwapKernel kernel)
+{
+    switch (kernel)
+    {
+    case ByteSwapKernel::Ssse3:
+        return ENUM_TO_STRING(ByteSwapKernel::Ssse3);
+    case ByteSwapKernel::Avx2:
+        return ENUM_TO_STRING(ByteSwapKernel::Avx2);
+    case ByteSwapKernel::Neon:
+        return ENUM_TO_STRING(ByteSwapKernel::Neon);
+    case ByteSwapKernel::Scalar:
+    default:
+        return ENUM_TO_STRING(ByteSwapKernel::Scalar);
+    }
+}
+
+bool DaneJoe::is_byte_swap_kernel_supported(ByteSwapKernel kernel)noexcept
+{
+    switch (kernel)
+    {
+    case ByteSwapKernel::Scalar:
+        return true;
+#if DANEJOE_BYTE_SWAP_X86==1
+    case ByteSwapKernel::Ssse3:
+        return __builtin_cpu_supports("ssse3");
+    case ByteSwapKernel::Avx2:
+        return __builtin_cpu_supports("avx2");
+#endif
+#if DANEJOE_BYTE_SWAP_NEON==1
+    case ByteSwapKernel::Neon:
+        return true;
+#endif
+    default:
+        return false;
+    }
+}
+
+DaneJoe::ByteSwapKernel DaneJoe::get_byte_swap_kernel()noexcept
+{
+    static const ByteSwapKernel kernel = detect_byte_swap_kernel();
+    return kernel;
+}
+
+void DaneJoe::byte_swap_copy(uint8_t* dest, const uint8_t* src, std::size_t element_size, std::size_t count)noexcept
+{
+    byte_swap_copy(get_byte_swap_kernel(), dest, src, element_size, count);
+}
+
+void DaneJoe::byte_swap_copy(ByteSwapKernel kernel, uint8_t* dest, const uint8_t* src, std::size_t element_size, std::size_t count)noexcept
+{
+    if (dest == nullptr || src == nullptr || count == 0 || element_size == 0)
+    {
+        return;
+    }
+    if (element_size == 1)
+    {
+        if (dest != src)
+        {
+            std::memcpy(dest, src, count);
+        }
+        return;
+    }
+    bool is_vector_width = element_size == 2 || element_size == 4 || element_size == 8;
+    if (!is_vector_width || !is_byte_swap_kernel_supported(kernel))
+    {
+        kernel = ByteSwapKernel::Scalar;
+    }
+    switch (kernel)
+    {
+#if DANEJOE_BYTE_SWAP_X86==1
+    case ByteSwapKernel::Avx2:
+        byte_swap_avx2(dest, src, element_size, count);
+        return;
+    case ByteSwapKernel::Ssse3:
+        byte_swap_ssse3(dest, src, element_size, count);
+        return;
+#endif
+#if DANEJOE_BYTE_SWAP_NEON==1
+    case ByteSwapKernel::Neon:
+        byte_swap_neon(dest, src, element_size, count);
+        return;
+#endif
+    default:
+        byte_swap_scalar(dest, src, element_size, count);
+        return;
+    }
+}
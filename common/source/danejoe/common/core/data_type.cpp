@@ -15,6 +15,7 @@ uint32_t DaneJoe::get_data_type_length(DataType type)
     case DataType::Int64:  return 8;
     case DataType::Float:  return 4;
     case DataType::Double: return 8;
+    case DataType::Bool:   return sizeof(bool);
     default: return 0;
     }
 }
@@ -0,0 +1,615 @@
+#include <cmath>
+#include <bitset>
+#include <thread>
+#include <memory>
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <utility>
+#include <algorithm>
+#include <filesystem>
+
+#include "danejoe/common/delta/file_delta.hpp"
+#include "danejoe/common/hash/xxhash64.hpp"
+#include "danejoe/common/hash/rolling_checksum.hpp"
+#include "danejoe/common/diagnostic/diagnostic_system.hpp"
+
+namespace
+{
+    /// @brief 签名编码的固定头部：文件大小、块大小、块数量
+    constexpr std::size_t SIGNATURE_HEADER_SIZE = 8 * 3;
+    /// @brief 单个块签名的编码长度
+    constexpr std::size_t BLOCK_SIGNATURE_SIZE = 4 + 8;
+    /// @brief 差量编码的固定头部：文件大小、指令数量
+    constexpr std::size_t DELTA_HEADER_SIZE = 8 * 2;
+    /// @brief 单条指令的编码头部：类型、基准偏移、长度
+    constexpr std::size_t INSTRUCTION_HEADER_SIZE = 1 + 8 + 8;
+    /// @brief 文件读写缓冲区大小
+    constexpr int64_t IO_BUFFER_SIZE = 4 * 1024 * 1024;
+    /// @brief 每个匹配线程至少负责的字节数
+    constexpr int64_t MIN_SEGMENT_SIZE = 4 * 1024 * 1024;
+
+    template<class T>
+    void append_le(std::vector<uint8_t>& bytes, T value)
+    {
+        auto raw = static_cast<uint64_t>(value);
+        for (std::size_t i = 0; i < sizeof(T); i++)
+        {
+            bytes.push_back(static_cast<uint8_t>(raw >> (8 * i)));
+        }
+    }
+
+    template<class T>
+    T load_le(const uint8_t* data)
+    {
+        uint64_t raw = 0;
+        for (std::size_t i = 0; i < sizeof(T); i++)
+        {
+            raw |= static_cast<uint64_t>(data[i]) << (8 * i);
+        }
+        return static_cast<T>(raw);
+    }
+
+    /**
+     * @class BlockLookup
+     * @brief 按弱校验和查找基准文件中的整块
+     * @details 先查位图过滤绝大多数不命中的偏移，再在按弱校验和排序的表中二分，弱校验和相同时比较强哈希。
+     *          构建后只读，可被多个匹配线程共享。
+     */
+    class BlockLookup
+    {
+    public:
+        explicit BlockLookup(const DaneJoe::FileSignature& signature) :
+            m_signature(signature),
+            m_filter(std::make_unique<std::bitset<FILTER_SIZE>>())
+        {
+            // 最后一个不足整块的块单独处理，不参与滚动匹配
+            int64_t full_block_count = signature.block_size > 0 ? signature.file_size / signature.block_size : 0;
+            m_entries.reserve(static_cast<std::size_t>(full_block_count));
+            for (int64_t index = 0; index < full_block_count; index++)
+            {
+                uint32_t weak_checksum = signature.blocks[static_cast<std::size_t>(index)].weak_checksum;
+                m_entries.emplace_back(weak_checksum, index);
+                m_filter->set(get_filter_index(weak_checksum));
+            }
+            std::sort(m_entries.begin(), m_entries.end());
+        }
+        int64_t find(uint32_t weak_checksum, const uint8_t* window)const
+        {
+            if (!m_filter->test(get_filter_index(weak_checksum)))
+            {
+                return -1;
+            }
+            auto range = std::equal_range(m_entries.begin(), m_entries.end(), std::make_pair(weak_checksum, int64_t(0)),
+                [](const std::pair<uint32_t, int64_t>& lhs, const std::pair<uint32_t, int64_t>& rhs)
+                {
+                    return lhs.first < rhs.first;
+                });
+            if (range.first == range.second)
+            {
+                return -1;
+            }
+            uint64_t strong_hash = DaneJoe::xxhash64(window, static_cast<std::size_t>(m_signature.block_size));
+            for (auto it = range.first; it != range.second; ++it)
+            {
+                if (m_signature.blocks[static_cast<std::size_t>(it->second)].strong_hash == strong_hash)
+                {
+                    return it->second;
+                }
+            }
+            return -1;
+        }
+    private:
+        static constexpr std::size_t FILTER_SIZE = std::size_t(1) << 20;
+        static std::size_t get_filter_index(uint32_t weak_checksum)
+        {
+            return static_cast<std::size_t>((weak_checksum * 0x9E3779B1u) >> 12);
+        }
+    private:
+        const DaneJoe::FileSignature& m_signature;
+        std::unique_ptr<std::bitset<FILTER_SIZE>> m_filter;
+        std::vector<std::pair<uint32_t, int64_t>> m_entries;
+    };
+
+    /**
+     * @class DeltaBuilder
+     * @brief 追加指令并合并相邻的同类指令
+     */
+    class DeltaBuilder
+    {
+    public:
+        void add_literal(const uint8_t* data, int64_t length)
+        {
+            if (length <= 0)
+            {
+                return;
+            }
+            if (m_instructions.empty() || m_instructions.back().operation != DaneJoe::DeltaOperation::Literal)
+            {
+                m_instructions.emplace_back();
+                m_instructions.back().operation = DaneJoe::DeltaOperation::Literal;
+            }
+            auto& instruction = m_instructions.back();
+            instruction.data.insert(instruction.data.end(), data, data + length);
+            instruction.length += length;
+        }
+        void add_copy(int64_t basis_offset, int64_t length)
+        {
+            if (!m_instructions.empty())
+            {
+                auto& last = m_instructions.back();
+                if (last.operation == DaneJoe::DeltaOperation::Copy && last.basis_offset + last.length == basis_offset)
+                {
+                    last.length += length;
+                    return;
+                }
+            }
+            DaneJoe::DeltaInstruction instruction;
+            instruction.operation = DaneJoe::DeltaOperation::Copy;
+            instruction.basis_offset = basis_offset;
+            instruction.length = length;
+            m_instructions.push_back(std::move(instruction));
+        }
+        void add(DaneJoe::DeltaInstruction&& instruction)
+        {
+            if (instruction.operation == DaneJoe::DeltaOperation::Copy)
+            {
+                add_copy(instruction.basis_offset, instruction.length);
+            }
+            else if (!m_instructions.empty() && m_instructions.back().operation == DaneJoe::DeltaOperation::Literal)
+            {
+                add_literal(instruction.data.data(), instruction.length);
+            }
+            else
+            {
+                m_instructions.push_back(std::move(instruction));
+            }
+        }
+        std::vector<DaneJoe::DeltaInstruction> take()
+        {
+            return std::move(m_instructions);
+        }
+    private:
+        std::vector<DaneJoe::DeltaInstruction> m_instructions;
+    };
+
+    /**
+     * @brief 在新文件的一段内滚动匹配
+     * @param path 新文件路径
+     * @param signature 基准文件签名
+     * @param lookup 块查找表
+     * @param segment_begin 段起始偏移
+     * @param segment_end 段结束偏移
+     * @param is_file_end 段是否延伸到文件末尾（末尾可匹配基准文件的最后一个不足整块的块）
+     * @return 本段的指令，读取失败时返回 std::nullopt
+     */
+    std::optional<std::vector<DaneJoe::DeltaInstruction>> match_segment(
+        const std::string& path,
+        const DaneJoe::FileSignature& signature,
+        const BlockLookup& lookup,
+        int64_t segment_begin,
+        int64_t segment_end,
+        bool is_file_end)
+    {
+        std::ifstream fin(path, std::ios::in | std::ios::binary);
+        if (!fin.is_open())
+        {
+            return std::nullopt;
+        }
+        fin.seekg(segment_begin);
+        const int64_t block_size = signature.block_size;
+        const int64_t capacity = std::max<int64_t>(IO_BUFFER_SIZE, block_size * 4);
+        std::vector<uint8_t> buffer(static_cast<std::size_t>(capacity));
+        // 缓冲区对应的文件区间 [buffer_begin, buffer_end)
+        int64_t buffer_begin = segment_begin;
+        int64_t buffer_end = segment_begin;
+        DeltaBuilder builder;
+        // 保留 [keep_from, buffer_end) 并继续读取，直到缓冲区满或到达段尾
+        auto refill = [&](int64_t keep_from)->bool
+            {
+                int64_t keep = buffer_end - keep_from;
+                std::memmove(buffer.data(), buffer.data() + (keep_from - buffer_begin), static_cast<std::size_t>(keep));
+                buffer_begin = keep_from;
+                int64_t read_end = std::min(segment_end, buffer_begin + capacity);
+                auto to_read = static_cast<std::streamsize>(read_end - buffer_end);
+                fin.read(reinterpret_cast<char*>(buffer.data() + (buffer_end - buffer_begin)), to_read);
+                if (fin.gcount() != to_read)
+                {
+                    return false;
+                }
+                buffer_end = read_end;
+                return true;
+            };
+        auto at = [&](int64_t offset)
+            {
+                return buffer.data() + (offset - buffer_begin);
+            };
+
+        int64_t pos = segment_begin;
+        int64_t literal_begin = segment_begin;
+        DaneJoe::RollingChecksum checksum;
+        bool is_rolling = false;
+        while (pos + block_size <= segment_end)
+        {
+            // 需要当前窗口及其后一个字节（用于滚动）
+            if (pos + block_size + 1 > buffer_end && buffer_end < segment_end)
+            {
+                builder.add_literal(at(literal_begin), pos - literal_begin);
+                literal_begin = pos;
+                if (!refill(pos))
+                {
+                    return std::nullopt;
+                }
+            }
+            const uint8_t* window = at(pos);
+            if (!is_rolling)
+            {
+                checksum.reset(window, static_cast<std::size_t>(block_size));
+                is_rolling = true;
+            }
+            int64_t block_index = lookup.find(checksum.get_value(), window);
+            if (block_index >= 0)
+            {
+                builder.add_literal(at(literal_begin), pos - literal_begin);
+                builder.add_copy(block_index * block_size, block_size);
+                pos += block_size;
+                literal_begin = pos;
+                is_rolling = false;
+                continue;
+            }
+            if (pos + block_size < segment_end)
+            {
+                checksum.roll(window[0], window[block_size]);
+            }
+            pos++;
+        }
+        // 剩余不足一块的数据：先读入缓冲区
+        builder.add_literal(at(literal_begin), buffer_end - literal_begin);
+        literal_begin = buffer_end;
+        while (buffer_end < segment_end)
+        {
+            if (!refill(buffer_end))
+            {
+                return std::nullopt;
+            }
+            builder.add_literal(at(literal_begin), buffer_end - literal_begin);
+            literal_begin = buffer_end;
+        }
+        auto instructions = builder.take();
+        // 文件末尾与基准文件最后一个不足整块的块相同时改为复制
+        int64_t tail_size = signature.file_size % block_size;
+        if (is_file_end && tail_size > 0 && segment_end - pos == tail_size && !instructions.empty() &&
+            instructions.back().operation == DaneJoe::DeltaOperation::Literal &&
+            instructions.back().length >= tail_size)
+        {
+            auto& last = instructions.back();
+            const uint8_t* tail = last.data.data() + (last.length - tail_size);
+            const auto& tail_block = signature.blocks.back();
+            if (DaneJoe::RollingChecksum::compute(tail, static_cast<std::size_t>(tail_size)) == tail_block.weak_checksum &&
+                DaneJoe::xxhash64(tail, static_cast<std::size_t>(tail_size)) == tail_block.strong_hash)
+            {
+                last.length -= tail_size;
+                last.data.resize(static_cast<std::size_t>(last.length));
+                if (last.length == 0)
+                {
+                    instructions.pop_back();
+                }
+                int64_t tail_offset = signature.file_size - tail_size;
+                if (!instructions.empty() && instructions.back().operation == DaneJoe::DeltaOperation::Copy &&
+                    instructions.back().basis_offset + instructions.back().length == tail_offset)
+                {
+                    instructions.back().length += tail_size;
+                }
+                else
+                {
+                    DaneJoe::DeltaInstruction instruction;
+                    instruction.operation = DaneJoe::DeltaOperation::Copy;
+                    instruction.basis_offset = tail_offset;
+                    instruction.length = tail_size;
+                    instructions.push_back(std::move(instruction));
+                }
+            }
+        }
+        return instructions;
+    }
+}
+
+int64_t DaneJoe::FileSignature::get_block_size_for(int64_t file_size)
+{
+    auto block_size = static_cast<int64_t>(std::sqrt(static_cast<double>(std::max<int64_t>(file_size, 0))));
+    block_size = (block_size + 1023) / 1024 * 1024;
+    return std::clamp(block_size, MIN_BLOCK_SIZE, MAX_BLOCK_SIZE);
+}
+
+std::vector<uint8_t> DaneJoe::FileSignature::encode()const
+{
+    std::vector<uint8_t> bytes;
+    bytes.reserve(SIGNATURE_HEADER_SIZE + blocks.size() * BLOCK_SIGNATURE_SIZE);
+    append_le(bytes, file_size);
+    append_le(bytes, block_size);
+    append_le(bytes, static_cast<uint64_t>(blocks.size()));
+    for (const auto& block : blocks)
+    {
+        append_le(bytes, block.weak_checksum);
+        append_le(bytes, block.strong_hash);
+    }
+    return bytes;
+}
+
+std::optional<DaneJoe::FileSignature> DaneJoe::FileSignature::decode(const std::vector<uint8_t>& bytes)
+{
+    if (bytes.size() < SIGNATURE_HEADER_SIZE)
+    {
+        return std::nullopt;
+    }
+    FileSignature signature;
+    signature.file_size = load_le<int64_t>(bytes.data());
+    signature.block_size = load_le<int64_t>(bytes.data() + 8);
+    auto block_count = load_le<uint64_t>(bytes.data() + 16);
+    if (signature.file_size < 0 ||
+        signature.block_size < MIN_BLOCK_SIZE || signature.block_size > MAX_BLOCK_SIZE ||
+        block_count > MAX_BLOCK_COUNT ||
+        (bytes.size() - SIGNATURE_HEADER_SIZE) / BLOCK_SIGNATURE_SIZE != block_count ||
+        (bytes.size() - SIGNATURE_HEADER_SIZE) % BLOCK_SIGNATURE_SIZE != 0 ||
+        static_cast<int64_t>(block_count) != (signature.file_size + signature.block_size - 1) / signature.block_size)
+    {
+        return std::nullopt;
+    }
+    signature.blocks.resize(static_cast<std::size_t>(block_count));
+    const uint8_t* data = bytes.data() + SIGNATURE_HEADER_SIZE;
+    for (auto& block : signature.blocks)
+    {
+        block.weak_checksum = load_le<uint32_t>(data);
+        block.strong_hash = load_le<uint64_t>(data + 4);
+        data += BLOCK_SIGNATURE_SIZE;
+    }
+    return signature;
+}
+
+std::optional<DaneJoe::FileSignature> DaneJoe::FileSignature::build_from_file(const std::string& path, int64_t block_size)
+{
+    std::error_code error_code;
+    auto file_size = std::filesystem::file_size(path, error_code);
+    std::ifstream fin(path, std::ios::in | std::ios::binary);
+    if (error_code || !fin.is_open())
+    {
+        ADD_DIAG_WARN("delta", "Failed to build signature for {}: {}", path, error_code.message());
+        return std::nullopt;
+    }
+    FileSignature signature;
+    signature.file_size = static_cast<int64_t>(file_size);
+    signature.block_size = block_size > 0 ? block_size : get_block_size_for(signature.file_size);
+    signature.blocks.reserve(static_cast<std::size_t>((signature.file_size + signature.block_size - 1) / signature.block_size));
+    // 一次读取若干整块，减少读调用次数
+    int64_t blocks_per_read = std::max<int64_t>(1, IO_BUFFER_SIZE / signature.block_size);
+    std::vector<uint8_t> buffer(static_cast<std::size_t>(blocks_per_read * signature.block_size));
+    int64_t offset = 0;
+    while (offset < signature.file_size)
+    {
+        auto read_size = static_cast<std::streamsize>(std::min<int64_t>(buffer.size(), signature.file_size - offset));
+        if (!fin.read(reinterpret_cast<char*>(buffer.data()), read_size))
+        {
+            ADD_DIAG_WARN("delta", "Failed to read {} while building signature", path);
+            return std::nullopt;
+        }
+        for (int64_t begin = 0; begin < read_size; begin += signature.block_size)
+        {
+            auto size = static_cast<std::size_t>(std::min<int64_t>(signature.block_size, read_size - begin));
+            BlockSignature block;
+            block.weak_checksum = RollingChecksum::compute(buffer.data() + begin, size);
+            block.strong_hash = xxhash64(buffer.data() + begin, size);
+            signature.blocks.push_back(block);
+        }
+        offset += read_size;
+    }
+    return signature;
+}
+
+int64_t DaneJoe::FileDelta::get_literal_bytes()const
+{
+    int64_t literal_bytes = 0;
+    for (const auto& instruction : instructions)
+    {
+        if (instruction.operation == DeltaOperation::Literal)
+        {
+            literal_bytes += instruction.length;
+        }
+    }
+    return literal_bytes;
+}
+
+std::vector<uint8_t> DaneJoe::FileDelta::encode()const
+{
+    std::vector<uint8_t> bytes;
+    bytes.reserve(DELTA_HEADER_SIZE + instructions.size() * INSTRUCTION_HEADER_SIZE + static_cast<std::size_t>(get_literal_bytes()));
+    append_le(bytes, file_size);
+    append_le(bytes, static_cast<uint64_t>(instructions.size()));
+    for (const auto& instruction : instructions)
+    {
+        bytes.push_back(static_cast<uint8_t>(instruction.operation));
+        append_le(bytes, instruction.basis_offset);
+        append_le(bytes, instruction.length);
+        if (instruction.operation == DeltaOperation::Literal)
+        {
+            bytes.insert(bytes.end(), instruction.data.begin(), instruction.data.end());
+        }
+    }
+    return bytes;
+}
+
+std::optional<DaneJoe::FileDelta> DaneJoe::FileDelta::decode(const std::vector<uint8_t>& bytes)
+{
+    if (bytes.size() < DELTA_HEADER_SIZE)
+    {
+        return std::nullopt;
+    }
+    FileDelta delta;
+    delta.file_size = load_le<int64_t>(bytes.data());
+    auto instruction_count = load_le<uint64_t>(bytes.data() + 8);
+    if (delta.file_size < 0 || instruction_count > (bytes.size() - DELTA_HEADER_SIZE) / INSTRUCTION_HEADER_SIZE)
+    {
+        return std::nullopt;
+    }
+    delta.instructions.reserve(static_cast<std::size_t>(instruction_count));
+    std::size_t position = DELTA_HEADER_SIZE;
+    int64_t output_size = 0;
+    for (uint64_t i = 0; i < instruction_count; i++)
+    {
+        if (bytes.size() - position < INSTRUCTION_HEADER_SIZE)
+        {
+            return std::nullopt;
+        }
+        DeltaInstruction instruction;
+        uint8_t operation = bytes[position];
+        instruction.basis_offset = load_le<int64_t>(bytes.data() + position + 1);
+        instruction.length = load_le<int64_t>(bytes.data() + position + 9);
+        position += INSTRUCTION_HEADER_SIZE;
+        if (operation > static_cast<uint8_t>(DeltaOperation::Literal) ||
+            instruction.basis_offset < 0 || instruction.length <= 0 ||
+            instruction.length > delta.file_size - output_size)
+        {
+            return std::nullopt;
+        }
+        instruction.operation = static_cast<DeltaOperation>(operation);
+        if (instruction.operation == DeltaOperation::Literal)
+        {
+            if (static_cast<uint64_t>(instruction.length) > bytes.size() - position)
+            {
+                return std::nullopt;
+            }
+            instruction.data.assign(bytes.begin() + static_cast<std::ptrdiff_t>(position),
+                bytes.begin() + static_cast<std::ptrdiff_t>(position + static_cast<std::size_t>(instruction.length)));
+            position += static_cast<std::size_t>(instruction.length);
+        }
+        output_size += instruction.length;
+        delta.instructions.push_back(std::move(instruction));
+    }
+    if (position != bytes.size() || output_size != delta.file_size)
+    {
+        return std::nullopt;
+    }
+    return delta;
+}
+
+std::optional<DaneJoe::FileDelta> DaneJoe::FileDelta::compute(
+    const std::string& path,
+    const FileSignature& signature,
+    int thread_count)
+{
+    std::error_code error_code;
+    auto file_size = std::filesystem::file_size(path, error_code);
+    if (error_code ||
+        signature.block_size < FileSignature::MIN_BLOCK_SIZE || signature.block_size > FileSignature::MAX_BLOCK_SIZE ||
+        static_cast<int64_t>(signature.blocks.size()) != (signature.file_size + signature.block_size - 1) / signature.block_size)
+    {
+        ADD_DIAG_WARN("delta", "Failed to compute delta for {}: {}, block_size={}, block_count={}",
+            path, error_code.message(), signature.block_size, signature.blocks.size());
+        return std::nullopt;
+    }
+    FileDelta delta;
+    delta.file_size = static_cast<int64_t>(file_size);
+    if (thread_count <= 0)
+    {
+        thread_count = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    }
+    int64_t segment_size_floor = std::max<int64_t>(MIN_SEGMENT_SIZE, signature.block_size * 64);
+    thread_count = static_cast<int>(std::clamp<int64_t>(delta.file_size / segment_size_floor, 1, thread_count));
+
+    BlockLookup lookup(signature);
+    std::vector<std::optional<std::vector<DeltaInstruction>>> results(static_cast<std::size_t>(thread_count));
+    std::vector<std::thread> workers;
+    int64_t segment_size = delta.file_size / thread_count;
+    for (int i = 0; i < thread_count; i++)
+    {
+        int64_t segment_begin = segment_size * i;
+        int64_t segment_end = i + 1 == thread_count ? delta.file_size : segment_begin + segment_size;
+        bool is_file_end = i + 1 == thread_count;
+        auto match = [&path, &signature, &lookup, &results, i, segment_begin, segment_end, is_file_end]()
+            {
+                // 异常不能逃出工作线程，按该段读取失败处理
+                try
+                {
+                    results[static_cast<std::size_t>(i)] = match_segment(path, signature, lookup, segment_begin, segment_end, is_file_end);
+                }
+                catch (const std::exception& exception)
+                {
+                    ADD_DIAG_WARN("delta", "Matching segment [{}, {}) of {} threw: {}", segment_begin, segment_end, path, exception.what());
+                    results[static_cast<std::size_t>(i)].reset();
+                }
+            };
+        if (is_file_end)
+        {
+            // 调用线程处理最后一段
+            match();
+        }
+        else
+        {
+            workers.emplace_back(match);
+        }
+    }
+    for (auto& worker : workers)
+    {
+        worker.join();
+    }
+    DeltaBuilder builder;
+    for (auto& result : results)
+    {
+        if (!result.has_value())
+        {
+            ADD_DIAG_WARN("delta", "Failed to read {} while computing delta", path);
+            return std::nullopt;
+        }
+        for (auto& instruction : result.value())
+        {
+            builder.add(std::move(instruction));
+        }
+    }
+    delta.instructions = builder.take();
+    return delta;
+}
+
+std::optional<DaneJoe::Md5> DaneJoe::FileDelta::apply(const std::string& basis_path, const std::string& output_path)const
+{
+    std::ifstream basis(basis_path, std::ios::in | std::ios::binary);
+    std::ofstream output(output_path, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!basis.is_open() || !output.is_open())
+    {
+        ADD_DIAG_WARN("delta", "Failed to open {} or {} to apply delta", basis_path, output_path);
+        return std::nullopt;
+    }
+    Md5 md5;
+    std::vector<uint8_t> buffer(static_cast<std::size_t>(IO_BUFFER_SIZE));
+    int64_t written = 0;
+    for (const auto& instruction : instructions)
+    {
+        if (instruction.operation == DeltaOperation::Literal)
+        {
+            output.write(reinterpret_cast<const char*>(instruction.data.data()), static_cast<std::streamsize>(instruction.data.size()));
+            md5.update(instruction.data.data(), instruction.data.size());
+            written += static_cast<int64_t>(instruction.data.size());
+            continue;
+        }
+        basis.seekg(instruction.basis_offset);
+        int64_t remaining = instruction.length;
+        while (remaining > 0)
+        {
+            auto size = static_cast<std::streamsize>(std::min<int64_t>(remaining, IO_BUFFER_SIZE));
+            if (!basis.read(reinterpret_cast<char*>(buffer.data()), size))
+            {
+                ADD_DIAG_WARN("delta", "Failed to read basis {} at {}", basis_path, instruction.basis_offset);
+                return std::nullopt;
+            }
+            output.write(reinterpret_cast<const char*>(buffer.data()), size);
+            md5.update(buffer.data(), static_cast<std::size_t>(size));
+            remaining -= size;
+        }
+        written += instruction.length;
+    }
+    output.flush();
+    if (!output || written != file_size)
+    {
+        ADD_DIAG_WARN("delta", "Failed to write {}: written {} of {}", output_path, written, file_size);
+        return std::nullopt;
+    }
+    return md5;
+}
@@ -1,101 +1,223 @@
 #include <chrono>
-#include <thread>
+#include <algorithm>
 
 #include "danejoe/common/diagnostic/diagnostic_system.hpp"
+#include "danejoe/common/system/system_info.hpp"
 #include "danejoe/logger/logger_manager.hpp"
 
+namespace
+{
+    /// @brief 线程复用的消息缓冲区
+    thread_local std::string t_message_buffer;
+
+    DaneJoe::LogLevel to_log_level(DaneJoe::DiagnosticEventLevel level)
+    {
+        switch (level)
+        {
+            case DaneJoe::DiagnosticEventLevel::Trace:
+                return DaneJoe::LogLevel::TRACE;
+            case DaneJoe::DiagnosticEventLevel::Debug:
+                return DaneJoe::LogLevel::DEBUG;
+            case DaneJoe::DiagnosticEventLevel::Info:
+                return DaneJoe::LogLevel::INFO;
+            case DaneJoe::DiagnosticEventLevel::Warn:
+                return DaneJoe::LogLevel::WARN;
+            case DaneJoe::DiagnosticEventLevel::Error:
+                return DaneJoe::LogLevel::ERROR;
+            case DaneJoe::DiagnosticEventLevel::Critical:
+                return DaneJoe::LogLevel::FATAL;
+            case DaneJoe::DiagnosticEventLevel::Unknown:
+            default:
+                return DaneJoe::LogLevel::WARN;
+        }
+    }
+}
+
 DaneJoe::DiagnosticSystem& DaneJoe::DiagnosticSystem::get_instance()
 {
     static DiagnosticSystem instance;
     return instance;
 }
-DaneJoe::DiagnosticSystem::DiagnosticSystem() {}
+
+DaneJoe::DiagnosticSystem::DiagnosticSystem()
+{
+    m_slots = std::make_unique<EventSlot[]>(EVENT_CAPACITY);
+    m_logger = DaneJoe::LoggerManager::get_instance().get_logger("default");
+}
 
 std::string DaneJoe::format_message(std::string_view message)
 {
     return std::string(message);
 }
+
 DaneJoe::DiagnosticSystem::~DiagnosticSystem() = default;
+
+void DaneJoe::DiagnosticSystem::set_level(DiagnosticEventLevel level)
+{
+    m_level.store(level, std::memory_order_relaxed);
+}
+
+bool DaneJoe::DiagnosticSystem::set_module_level(std::string_view module_name, DiagnosticEventLevel level)
+{
+    std::lock_guard<std::mutex> lock(m_module_level_mutex);
+    std::size_t count = m_module_level_count.load(std::memory_order_relaxed);
+    for (std::size_t i = 0; i < count; i++)
+    {
+        if (m_module_levels[i].module_name == module_name)
+        {
+            m_module_levels[i].level.store(level, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    if (count >= MODULE_LEVEL_CAPACITY)
+    {
+        return false;
+    }
+    m_module_levels[count].module_name = std::string(module_name);
+    m_module_levels[count].level.store(level, std::memory_order_relaxed);
+    // 表项写完后再发布，读者无需加锁
+    m_module_level_count.store(count + 1, std::memory_order_release);
+    return true;
+}
+
+DaneJoe::DiagnosticEventLevel DaneJoe::DiagnosticSystem::get_module_level(std::string_view module_name)const
+{
+    std::size_t count = m_module_level_count.load(std::memory_order_acquire);
+    for (std::size_t i = 0; i < count; i++)
+    {
+        if (m_module_levels[i].module_name == module_name)
+        {
+            return m_module_levels[i].level.load(std::memory_order_relaxed);
+        }
+    }
+    return m_level.load(std::memory_order_relaxed);
+}
+
+std::string DaneJoe::DiagnosticSystem::take_message_buffer()
+{
+    std::string buffer = std::move(t_message_buffer);
+    buffer.clear();
+    return buffer;
+}
+
+void DaneJoe::DiagnosticSystem::return_message_buffer(std::string&& buffer)
+{
+    t_message_buffer = std::move(buffer);
+}
+
 void DaneJoe::DiagnosticSystem::add_event(DiagnosticEventLevel level,
-    const std::string& module_name,
-    const std::string& message,
+    const char* module_name,
     int64_t line_number,
-    const std::string& function_name,
-    const std::string& file_name)
-{
-    DiagnosticEvent event;
-    event.event_id = m_event_id++;
-    event.level = level;
-    event.module_name = module_name;
-    event.message = message;
-    event.line_number = line_number;
-    event.function_name = function_name;
-    event.occurrence_time = std::chrono::system_clock::now();
-    event.thread_id = m_thread_id_hash(std::this_thread::get_id());
+    const char* function_name,
+    const char* file_name,
+    std::string_view message)
+{
+    uint64_t event_id = m_next_event_id.fetch_add(1, std::memory_order_relaxed);
+    EventSlot& slot = m_slots[event_id % EVENT_CAPACITY];
+    // 以 CAS 占用槽位：槽位正被写入（奇数）或已被更新的事件占用时放弃写入，
+    // 避免落后一圈的写入者与新写入者同时写同一槽位
+    uint64_t sequence = slot.sequence.load(std::memory_order_relaxed);
+    if (sequence % 2 != 0 || sequence > event_id * 2 ||
+        !slot.sequence.compare_exchange_strong(sequence, event_id * 2 + 1, std::memory_order_relaxed))
     {
-        std::lock_guard<std::mutex> lock(m_mutex);
-        m_events.push_back(event);
+        m_dropped_event_count.fetch_add(1, std::memory_order_relaxed);
+        forward_to_logger(level, module_name, line_number, function_name, file_name, message);
+        return;
     }
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    slot.line_number = line_number;
+    slot.module_name = module_name;
+    slot.function_name = function_name;
+    slot.file_name = file_name;
+    slot.thread_id = get_thread_id();
+    slot.level = level;
+    slot.message_size = static_cast<uint16_t>(std::min(message.size(), MESSAGE_CAPACITY));
+    std::copy_n(message.data(), slot.message_size, slot.message);
+    slot.sequence.store(event_id * 2 + 2, std::memory_order_release);
+
+    forward_to_logger(level, module_name, line_number, function_name, file_name, message);
+}
+
+void DaneJoe::DiagnosticSystem::forward_to_logger(DiagnosticEventLevel level,
+    const char* module_name,
+    int64_t line_number,
+    const char* function_name,
+    const char* file_name,
+    std::string_view message)
+{
     /// @todo 临时转接到log
-    auto default_logger = DaneJoe::LoggerManager::get_instance().get_logger("default");
-    if (!default_logger)
+    if (!m_logger)
     {
         return;
     }
-    switch (level)
-    {
-        case DiagnosticEventLevel::Trace:
-            default_logger->trace(module_name, file_name, function_name, line_number, "{}", message);
-            break;
-        case DiagnosticEventLevel::Debug:
-            default_logger->debug(module_name, file_name, function_name, line_number, "{}", message);
-            break;
-        case DiagnosticEventLevel::Info:
-            default_logger->info(module_name, file_name, function_name, line_number, "{}", message);
-            break;
-        case DiagnosticEventLevel::Warn:
-            default_logger->warn(module_name, file_name, function_name, line_number, "{}", message);
-            break;
-        case DiagnosticEventLevel::Error:
-            default_logger->error(module_name, file_name, function_name, line_number, "{}", message);
-            break;
-        case DiagnosticEventLevel::Critical:
-            default_logger->fatal(module_name, file_name, function_name, line_number, "{}", message);
-            break;
-        case DiagnosticEventLevel::Unknown:
-        default:
-            default_logger->warn(module_name, file_name, function_name, line_number, "{}", message);
-            break;
-    }
+    m_logger->log(to_log_level(level),
+        module_name,
+        file_name,
+        function_name,
+        static_cast<int>(line_number),
+        "{}",
+        message);
 }
-void DaneJoe::DiagnosticSystem::add_event(const DiagnosticEvent& event)
+
+void DaneJoe::DiagnosticSystem::clear_events()
 {
-    std::lock_guard<std::mutex> lock(m_mutex);
-    m_events.push_back(event);
+    m_cleared_event_id.store(m_next_event_id.load(std::memory_order_acquire), std::memory_order_release);
 }
-void DaneJoe::DiagnosticSystem::clear_events()
+
+uint64_t DaneJoe::DiagnosticSystem::get_dropped_event_count()const
 {
-    std::lock_guard<std::mutex> lock(m_mutex);
-    m_events.clear();
+    return m_dropped_event_count.load(std::memory_order_relaxed);
 }
+
 std::vector<DaneJoe::DiagnosticEvent> DaneJoe::DiagnosticSystem::get_events()
 {
-    std::lock_guard<std::mutex> lock(m_mutex);
-    return m_events;
+    return collect_events({});
 }
+
 std::vector<DaneJoe::DiagnosticEvent>
 DaneJoe::DiagnosticSystem::get_events_by_module(const std::string& module_name)
 {
-    std::vector<DaneJoe::DiagnosticEvent> result;
+    return collect_events(module_name);
+}
+
+std::vector<DaneJoe::DiagnosticEvent> DaneJoe::DiagnosticSystem::collect_events(std::string_view module_name)
+{
+    uint64_t end_event_id = m_next_event_id.load(std::memory_order_acquire);
+    uint64_t begin_event_id = end_event_id > EVENT_CAPACITY ? end_event_id - EVENT_CAPACITY : 0;
+    begin_event_id = std::max(begin_event_id, m_cleared_event_id.load(std::memory_order_acquire));
+    std::vector<DiagnosticEvent> result;
+    for (uint64_t event_id = begin_event_id; event_id < end_event_id; event_id++)
     {
-        std::lock_guard<std::mutex> lock(m_mutex);
-        for (auto& event : m_events)
+        const EventSlot& slot = m_slots[event_id % EVENT_CAPACITY];
+        uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+        // 尚未写完或已被更新的事件覆盖
+        if (sequence != event_id * 2 + 2)
+        {
+            continue;
+        }
+        DiagnosticEvent event;
+        event.event_id = static_cast<int64_t>(event_id);
+        event.thread_id = slot.thread_id;
+        event.level = slot.level;
+        event.module_name = slot.module_name ? slot.module_name : "";
+        event.function_name = slot.function_name ? slot.function_name : "";
+        event.file_name = slot.file_name ? slot.file_name : "";
+        event.line_number = slot.line_number;
+        event.message.assign(slot.message, slot.message_size);
+        event.occurrence_time = std::chrono::system_clock::time_point(
+            std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::nanoseconds(slot.timestamp)));
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.sequence.load(std::memory_order_relaxed) != sequence)
+        {
+            continue;
+        }
+        if (!module_name.empty() && event.module_name != module_name)
         {
-            if (event.module_name == module_name)
-            {
-                result.push_back(event);
-            }
+            continue;
         }
+        result.push_back(std::move(event));
     }
     return result;
 }
@@ -0,0 +1,255 @@
+#include <ctime>
+#include <format>
+#include <fstream>
+#include <iterator>
+#include <algorithm>
+
+#include "danejoe/common/diagnostic/trace_recorder.hpp"
+#include "danejoe/common/system/system_info.hpp"
+
+namespace
+{
+    double to_trace_time(int64_t timestamp_ns, int64_t base_ns)
+    {
+        // Chrome trace 的 ts 以微秒为单位
+        return static_cast<double>(timestamp_ns - base_ns) / 1000.0;
+    }
+}
+
+thread_local DaneJoe::TraceRecorder::ThreadBuffer* DaneJoe::TraceRecorder::t_thread_buffer = nullptr;
+
+const char* DaneJoe::to_string(TracePoint point)
+{
+    switch (point)
+    {
+        case TracePoint::Accept:
+            return "accept";
+        case TracePoint::FirstByteRead:
+            return "first_byte_read";
+        case TracePoint::FrameAssembled:
+            return "frame_assembled";
+        case TracePoint::PushedToMailBox:
+            return "pushed_to_mail_box";
+        case TracePoint::PoppedByBusiness:
+            return "popped_by_business";
+        case TracePoint::DatabaseLookupDone:
+            return "database_lookup_done";
+        case TracePoint::FileReadDone:
+            return "file_read_done";
+        case TracePoint::Encoded:
+            return "encoded";
+        case TracePoint::QueuedToClient:
+            return "queued_to_client";
+        case TracePoint::FullyWritten:
+            return "fully_written";
+        default:
+            return "unknown";
+    }
+}
+
+DaneJoe::TraceRecorder& DaneJoe::TraceRecorder::get_instance()
+{
+    static TraceRecorder instance;
+    return instance;
+}
+
+int64_t DaneJoe::TraceRecorder::now()
+{
+    timespec time_spec;
+    ::clock_gettime(CLOCK_MONOTONIC_RAW, &time_spec);
+    return static_cast<int64_t>(time_spec.tv_sec) * 1000000000 + time_spec.tv_nsec;
+}
+
+void DaneJoe::TraceRecorder::set_enabled(bool is_enabled)
+{
+    m_is_enabled.store(is_enabled, std::memory_order_relaxed);
+}
+
+void DaneJoe::TraceRecorder::set_thread_capacity(std::size_t capacity)
+{
+    m_thread_capacity.store(std::max<std::size_t>(capacity, 1), std::memory_order_relaxed);
+}
+
+DaneJoe::TraceRecorder::ThreadBuffer& DaneJoe::TraceRecorder::get_thread_buffer()
+{
+    if (t_thread_buffer)
+    {
+        return *t_thread_buffer;
+    }
+    auto buffer = std::make_shared<ThreadBuffer>();
+    buffer->capacity = m_thread_capacity.load(std::memory_order_relaxed);
+    buffer->records = std::make_unique<TraceRecord[]>(buffer->capacity);
+    {
+        std::lock_guard<std::mutex> lock(m_buffer_mutex);
+        m_buffers.push_back(buffer);
+    }
+    t_thread_buffer = buffer.get();
+    return *buffer;
+}
+
+void DaneJoe::TraceRecorder::record(TracePoint point, uint64_t connect_id, int64_t request_id, int64_t timestamp_ns)
+{
+    if (!is_enabled())
+    {
+        return;
+    }
+    ThreadBuffer& buffer = get_thread_buffer();
+    std::size_t count = buffer.count.load(std::memory_order_relaxed);
+    if (count >= buffer.capacity)
+    {
+        buffer.dropped_count.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    TraceRecord& record = buffer.records[count];
+    record.timestamp_ns = timestamp_ns;
+    record.connect_id = connect_id;
+    record.request_id = request_id;
+    record.thread_id = get_thread_id();
+    record.point = point;
+    buffer.count.store(count + 1, std::memory_order_release);
+}
+
+void DaneJoe::TraceRecorder::record(TracePoint point, uint64_t connect_id, int64_t request_id)
+{
+    record(point, connect_id, request_id, now());
+}
+
+std::vector<DaneJoe::TraceRecord> DaneJoe::TraceRecorder::collect_records()const
+{
+    std::vector<TraceRecord> records;
+    std::lock_guard<std::mutex> lock(m_buffer_mutex);
+    for (const auto& buffer : m_buffers)
+    {
+        std::size_t count = buffer->count.load(std::memory_order_acquire);
+        records.insert(records.end(), buffer->records.get(), buffer->records.get() + count);
+    }
+    return records;
+}
+
+uint64_t DaneJoe::TraceRecorder::get_dropped_count()const
+{
+    uint64_t dropped_count = 0;
+    std::lock_guard<std::mutex> lock(m_buffer_mutex);
+    for (const auto& buffer : m_buffers)
+    {
+        dropped_count += buffer->dropped_count.load(std::memory_order_relaxed);
+    }
+    return dropped_count;
+}
+
+void DaneJoe::TraceRecorder::write_chrome_trace(std::ostream& output)const
+{
+    std::vector<TraceRecord> records = collect_records();
+    std::sort(records.begin(), records.end(), [](const TraceRecord& lhs, const TraceRecord& rhs)
+        {
+            if (lhs.connect_id != rhs.connect_id)
+            {
+                return lhs.connect_id < rhs.connect_id;
+            }
+            if (lhs.request_id != rhs.request_id)
+            {
+                return lhs.request_id < rhs.request_id;
+            }
+            if (lhs.timestamp_ns != rhs.timestamp_ns)
+            {
+                return lhs.timestamp_ns < rhs.timestamp_ns;
+            }
+            return lhs.point < rhs.point;
+        });
+    int64_t base_ns = 0;
+    if (!records.empty())
+    {
+        base_ns = std::min_element(records.begin(), records.end(), [](const TraceRecord& lhs, const TraceRecord& rhs)
+            {
+                return lhs.timestamp_ns < rhs.timestamp_ns;
+            })->timestamp_ns;
+    }
+    int process_id = get_process_id();
+
+    std::string text;
+    auto out = std::back_inserter(text);
+    std::format_to(out, "{{\"displayTimeUnit\":\"ns\",\"otherData\":{{\"dropped_records\":{}}},\"traceEvents\":[\n",
+        get_dropped_count());
+    std::format_to(out, "{{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":{},\"args\":{{\"name\":\"ProjectTrans\"}}}}",
+        process_id);
+    // 各跟踪点在记录线程轨道上的瞬时事件
+    for (const auto& record : records)
+    {
+        std::format_to(out,
+            ",\n{{\"name\":\"{}\",\"cat\":\"point\",\"ph\":\"i\",\"s\":\"t\",\"ts\":{:.3f},\"pid\":{},\"tid\":{},"
+            "\"args\":{{\"connect_id\":{},\"request_id\":{}}}}}",
+            to_string(record.point),
+            to_trace_time(record.timestamp_ns, base_ns),
+            process_id,
+            record.thread_id,
+            record.connect_id,
+            record.request_id);
+    }
+    // 每个请求一条异步轨道，同一 id 下的 b/e 事件按时间嵌套
+    uint64_t span_id = 0;
+    std::size_t group_begin = 0;
+    while (group_begin < records.size())
+    {
+        std::size_t group_end = group_begin + 1;
+        while (group_end < records.size() &&
+            records[group_end].connect_id == records[group_begin].connect_id &&
+            records[group_end].request_id == records[group_begin].request_id)
+        {
+            group_end++;
+        }
+        const TraceRecord& first = records[group_begin];
+        const TraceRecord& last = records[group_end - 1];
+        if (first.request_id >= 0 && group_end - group_begin > 1)
+        {
+            span_id++;
+            std::format_to(out,
+                ",\n{{\"name\":\"request\",\"cat\":\"request\",\"ph\":\"b\",\"id\":{},\"ts\":{:.3f},\"pid\":{},\"tid\":{},"
+                "\"args\":{{\"connect_id\":{},\"request_id\":{},\"total_us\":{:.3f}}}}}",
+                span_id,
+                to_trace_time(first.timestamp_ns, base_ns),
+                process_id,
+                first.thread_id,
+                first.connect_id,
+                first.request_id,
+                to_trace_time(last.timestamp_ns, first.timestamp_ns));
+            for (std::size_t i = group_begin + 1; i < group_end; i++)
+            {
+                const TraceRecord& previous = records[i - 1];
+                const TraceRecord& current = records[i];
+                std::format_to(out,
+                    ",\n{{\"name\":\"{}\",\"cat\":\"request\",\"ph\":\"b\",\"id\":{},\"ts\":{:.3f},\"pid\":{},\"tid\":{}}}"
+                    ",\n{{\"name\":\"{}\",\"cat\":\"request\",\"ph\":\"e\",\"id\":{},\"ts\":{:.3f},\"pid\":{},\"tid\":{}}}",
+                    to_string(current.point),
+                    span_id,
+                    to_trace_time(previous.timestamp_ns, base_ns),
+                    process_id,
+                    first.thread_id,
+                    to_string(current.point),
+                    span_id,
+                    to_trace_time(current.timestamp_ns, base_ns),
+                    process_id,
+                    first.thread_id);
+            }
+            std::format_to(out,
+                ",\n{{\"name\":\"request\",\"cat\":\"request\",\"ph\":\"e\",\"id\":{},\"ts\":{:.3f},\"pid\":{},\"tid\":{}}}",
+                span_id,
+                to_trace_time(last.timestamp_ns, base_ns),
+                process_id,
+                first.thread_id);
+        }
+        group_begin = group_end;
+    }
+    text += "\n]}\n";
+    output.write(text.data(), static_cast<std::streamsize>(text.size()));
+}
+
+bool DaneJoe::TraceRecorder::dump_chrome_trace(const std::string& path)const
+{
+    std::ofstream output(path, std::ios::out | std::ios::trunc);
+    if (!output.is_open())
+    {
+        return false;
+    }
+    write_chrome_trace(output);
+    return output.good();
+}
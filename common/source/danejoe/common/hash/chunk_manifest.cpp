@@ -0,0 +1,156 @@
+#include <atomic>
+#include <thread>
+#include <fstream>
+#include <algorithm>
+#include <filesystem>
+
+#include "danejoe/common/hash/chunk_manifest.hpp"
+#include "danejoe/common/hash/xxhash64.hpp"
+#include "danejoe/common/diagnostic/diagnostic_system.hpp"
+
+int64_t DaneJoe::ChunkManifest::get_chunk_count() const
+{
+    if (chunk_size <= 0 || file_size < 0)
+    {
+        return 0;
+    }
+    return (file_size + chunk_size - 1) / chunk_size;
+}
+
+bool DaneJoe::ChunkManifest::is_valid() const
+{
+    return chunk_size > 0 && static_cast<int64_t>(chunk_hashes.size()) == get_chunk_count();
+}
+
+std::pair<int64_t, int64_t> DaneJoe::ChunkManifest::get_chunk_range(int64_t index) const
+{
+    int64_t begin = index * chunk_size;
+    return { begin, std::min(begin + chunk_size, file_size) };
+}
+
+bool DaneJoe::ChunkManifest::verify_chunk(int64_t index, const uint8_t* data, std::size_t size) const
+{
+    if (index < 0 || index >= static_cast<int64_t>(chunk_hashes.size()))
+    {
+        return false;
+    }
+    auto [begin, end] = get_chunk_range(index);
+    if (static_cast<int64_t>(size) != end - begin)
+    {
+        return false;
+    }
+    return xxhash64(data, size) == chunk_hashes[static_cast<std::size_t>(index)];
+}
+
+uint64_t DaneJoe::ChunkManifest::get_root_hash() const
+{
+    auto bytes = get_hash_bytes();
+    return xxhash64(bytes.data(), bytes.size());
+}
+
+std::vector<uint8_t> DaneJoe::ChunkManifest::get_hash_bytes() const
+{
+    std::vector<uint8_t> bytes(chunk_hashes.size() * 8);
+    for (std::size_t i = 0; i < chunk_hashes.size(); i++)
+    {
+        for (std::size_t j = 0; j < 8; j++)
+        {
+            bytes[i * 8 + j] = static_cast<uint8_t>(chunk_hashes[i] >> (8 * j));
+        }
+    }
+    return bytes;
+}
+
+bool DaneJoe::ChunkManifest::set_hash_bytes(const std::vector<uint8_t>& bytes)
+{
+    if (bytes.size() % 8 != 0)
+    {
+        return false;
+    }
+    chunk_hashes.assign(bytes.size() / 8, 0);
+    for (std::size_t i = 0; i < chunk_hashes.size(); i++)
+    {
+        for (std::size_t j = 0; j < 8; j++)
+        {
+            chunk_hashes[i] |= static_cast<uint64_t>(bytes[i * 8 + j]) << (8 * j);
+        }
+    }
+    return true;
+}
+
+std::optional<DaneJoe::ChunkManifest> DaneJoe::ChunkManifest::build_from_file(
+    const std::string& path,
+    int64_t chunk_size,
+    int thread_count)
+{
+    std::error_code error_code;
+    auto file_size = std::filesystem::file_size(path, error_code);
+    if (error_code || chunk_size <= 0)
+    {
+        ADD_DIAG_WARN("hash", "Failed to build manifest for {}: {}", path, error_code.message());
+        return std::nullopt;
+    }
+    ChunkManifest manifest;
+    manifest.file_size = static_cast<int64_t>(file_size);
+    manifest.chunk_size = chunk_size;
+    int64_t chunk_count = manifest.get_chunk_count();
+    manifest.chunk_hashes.assign(static_cast<std::size_t>(chunk_count), 0);
+    if (thread_count <= 0)
+    {
+        thread_count = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    }
+    thread_count = static_cast<int>(std::max<int64_t>(1, std::min<int64_t>(thread_count, chunk_count)));
+
+    // 每个线程负责一段连续的块，保持顺序读取
+    std::atomic<bool> is_failed = false;
+    auto hash_chunks = [&manifest, &path, &is_failed](int64_t first_chunk, int64_t last_chunk)
+        {
+            std::ifstream fin(path, std::ios::in | std::ios::binary);
+            if (!fin.is_open())
+            {
+                is_failed = true;
+                return;
+            }
+            std::vector<uint8_t> buffer(static_cast<std::size_t>(manifest.chunk_size));
+            fin.seekg(first_chunk * manifest.chunk_size);
+            for (int64_t index = first_chunk; index < last_chunk && !is_failed; index++)
+            {
+                auto [begin, end] = manifest.get_chunk_range(index);
+                auto size = static_cast<std::size_t>(end - begin);
+                if (!fin.read(reinterpret_cast<char*>(buffer.data()), static_cast<std::streamsize>(size)))
+                {
+                    is_failed = true;
+                    return;
+                }
+                manifest.chunk_hashes[static_cast<std::size_t>(index)] = xxhash64(buffer.data(), size);
+            }
+        };
+    std::vector<std::thread> workers;
+    int64_t chunks_per_thread = chunk_count / thread_count;
+    int64_t extra_chunks = chunk_count % thread_count;
+    int64_t first_chunk = 0;
+    for (int i = 0; i < thread_count; i++)
+    {
+        int64_t last_chunk = first_chunk + chunks_per_thread + (i < extra_chunks ? 1 : 0);
+        if (i + 1 == thread_count)
+        {
+            // 调用线程处理最后一段
+            hash_chunks(first_chunk, last_chunk);
+        }
+        else
+        {
+            workers.emplace_back(hash_chunks, first_chunk, last_chunk);
+        }
+        first_chunk = last_chunk;
+    }
+    for (auto& worker : workers)
+    {
+        worker.join();
+    }
+    if (is_failed)
+    {
+        ADD_DIAG_WARN("hash", "Failed to read {} while building manifest", path);
+        return std::nullopt;
+    }
+    return manifest;
+}
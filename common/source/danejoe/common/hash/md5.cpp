@@ -0,0 +1,221 @@
+#include <cstring>
+#include <algorithm>
+#include <format>
+
+#include "danejoe/common/hash/md5.hpp"
+
+namespace
+{
+    /// @brief 每步循环左移位数
+    constexpr uint32_t SHIFTS[64] = {
+        7, 12, 17, 22, 7, 12, 17, 22, 7, 12, 17, 22, 7, 12, 17, 22,
+        5, 9, 14, 20, 5, 9, 14, 20, 5, 9, 14, 20, 5, 9, 14, 20,
+        4, 11, 16, 23, 4, 11, 16, 23, 4, 11, 16, 23, 4, 11, 16, 23,
+        6, 10, 15, 21, 6, 10, 15, 21, 6, 10, 15, 21, 6, 10, 15, 21
+    };
+    /// @brief 每步加法常量 floor(abs(sin(i + 1)) * 2^32)
+    constexpr uint32_t CONSTANTS[64] = {
+        0xd76aa478, 0xe8c7b756, 0x242070db, 0xc1bdceee, 0xf57c0faf, 0x4787c62a, 0xa8304613, 0xfd469501,
+        0x698098d8, 0x8b44f7af, 0xffff5bb1, 0x895cd7be, 0x6b901122, 0xfd987193, 0xa679438e, 0x49b40821,
+        0xf61e2562, 0xc040b340, 0x265e5a51, 0xe9b6c7aa, 0xd62f105d, 0x02441453, 0xd8a1e681, 0xe7d3fbc8,
+        0x21e1cde6, 0xc33707d6, 0xf4d50d87, 0x455a14ed, 0xa9e3e905, 0xfcefa3f8, 0x676f02d9, 0x8d2a4c8a,
+        0xfffa3942, 0x8771f681, 0x6d9d6122, 0xfde5380c, 0xa4beea44, 0x4bdecfa9, 0xf6bb4b60, 0xbebfbc70,
+        0x289b7ec6, 0xeaa127fa, 0xd4ef3085, 0x04881d05, 0xd9d4d039, 0xe6db99e5, 0x1fa27cf8, 0xc4ac5665,
+        0xf4292244, 0x432aff97, 0xab9423a7, 0xfc93a039, 0x655b59c3, 0x8f0ccc92, 0xffeff47d, 0x85845dd1,
+        0x6fa87e4f, 0xfe2ce6e0, 0xa3014314, 0x4e0811a1, 0xf7537e82, 0xbd3af235, 0x2ad7d2bb, 0xeb86d391
+    };
+    /// @brief 状态导出的固定部分：4 个链接变量与已输入字节数
+    constexpr std::size_t STATE_HEADER_SIZE = 4 * 4 + 8;
+
+    uint32_t load_le32(const uint8_t* data)
+    {
+        return static_cast<uint32_t>(data[0]) |
+            (static_cast<uint32_t>(data[1]) << 8) |
+            (static_cast<uint32_t>(data[2]) << 16) |
+            (static_cast<uint32_t>(data[3]) << 24);
+    }
+
+    void store_le32(uint8_t* data, uint32_t value)
+    {
+        for (int i = 0; i < 4; i++)
+        {
+            data[i] = static_cast<uint8_t>(value >> (8 * i));
+        }
+    }
+
+    void store_le64(uint8_t* data, uint64_t value)
+    {
+        for (int i = 0; i < 8; i++)
+        {
+            data[i] = static_cast<uint8_t>(value >> (8 * i));
+        }
+    }
+
+    uint64_t load_le64(const uint8_t* data)
+    {
+        uint64_t value = 0;
+        for (int i = 0; i < 8; i++)
+        {
+            value |= static_cast<uint64_t>(data[i]) << (8 * i);
+        }
+        return value;
+    }
+
+    uint32_t rotate_left(uint32_t value, uint32_t shift)
+    {
+        return (value << shift) | (value >> (32 - shift));
+    }
+}
+
+DaneJoe::Md5::Md5() :
+    m_state({ 0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476 })
+{}
+
+void DaneJoe::Md5::update(const uint8_t* data, std::size_t size)
+{
+    if (data == nullptr || size == 0)
+    {
+        return;
+    }
+    std::size_t buffered = static_cast<std::size_t>(m_size % 64);
+    m_size += size;
+    if (buffered > 0)
+    {
+        std::size_t fill = std::min(size, 64 - buffered);
+        std::memcpy(m_buffer.data() + buffered, data, fill);
+        data += fill;
+        size -= fill;
+        if (buffered + fill < 64)
+        {
+            return;
+        }
+        process_block(m_buffer.data());
+    }
+    while (size >= 64)
+    {
+        process_block(data);
+        data += 64;
+        size -= 64;
+    }
+    if (size > 0)
+    {
+        std::memcpy(m_buffer.data(), data, size);
+    }
+}
+
+uint64_t DaneJoe::Md5::get_size() const
+{
+    return m_size;
+}
+
+DaneJoe::Md5::Digest DaneJoe::Md5::get_digest() const
+{
+    // 在副本上补齐填充，保持当前状态可继续输入
+    Md5 final_md5 = *this;
+    uint8_t length_bytes[8];
+    store_le64(length_bytes, m_size * 8);
+    uint8_t padding[64] = { 0x80 };
+    std::size_t buffered = static_cast<std::size_t>(m_size % 64);
+    std::size_t padding_size = buffered < 56 ? 56 - buffered : 120 - buffered;
+    final_md5.update(padding, padding_size);
+    final_md5.update(length_bytes, sizeof(length_bytes));
+
+    Digest digest;
+    for (std::size_t i = 0; i < 4; i++)
+    {
+        store_le32(digest.data() + i * 4, final_md5.m_state[i]);
+    }
+    return digest;
+}
+
+std::string DaneJoe::Md5::get_hex_digest() const
+{
+    std::string hex;
+    hex.reserve(DIGEST_SIZE * 2);
+    for (auto byte : get_digest())
+    {
+        hex += std::format("{:02x}", byte);
+    }
+    return hex;
+}
+
+std::vector<uint8_t> DaneJoe::Md5::save_state() const
+{
+    std::size_t buffered = static_cast<std::size_t>(m_size % 64);
+    std::vector<uint8_t> state(STATE_HEADER_SIZE + buffered);
+    for (std::size_t i = 0; i < 4; i++)
+    {
+        store_le32(state.data() + i * 4, m_state[i]);
+    }
+    store_le64(state.data() + 16, m_size);
+    std::memcpy(state.data() + STATE_HEADER_SIZE, m_buffer.data(), buffered);
+    return state;
+}
+
+bool DaneJoe::Md5::load_state(const std::vector<uint8_t>& state)
+{
+    if (state.size() < STATE_HEADER_SIZE)
+    {
+        return false;
+    }
+    uint64_t size = load_le64(state.data() + 16);
+    std::size_t buffered = static_cast<std::size_t>(size % 64);
+    if (state.size() != STATE_HEADER_SIZE + buffered)
+    {
+        return false;
+    }
+    for (std::size_t i = 0; i < 4; i++)
+    {
+        m_state[i] = load_le32(state.data() + i * 4);
+    }
+    m_size = size;
+    std::memcpy(m_buffer.data(), state.data() + STATE_HEADER_SIZE, buffered);
+    return true;
+}
+
+void DaneJoe::Md5::process_block(const uint8_t* block)
+{
+    uint32_t words[16];
+    for (std::size_t i = 0; i < 16; i++)
+    {
+        words[i] = load_le32(block + i * 4);
+    }
+    uint32_t a = m_state[0];
+    uint32_t b = m_state[1];
+    uint32_t c = m_state[2];
+    uint32_t d = m_state[3];
+    for (uint32_t i = 0; i < 64; i++)
+    {
+        uint32_t f = 0;
+        uint32_t g = 0;
+        if (i < 16)
+        {
+            f = (b & c) | (~b & d);
+            g = i;
+        }
+        else if (i < 32)
+        {
+            f = (d & b) | (~d & c);
+            g = (5 * i + 1) % 16;
+        }
+        else if (i < 48)
+        {
+            f = b ^ c ^ d;
+            g = (3 * i + 5) % 16;
+        }
+        else
+        {
+            f = c ^ (b | ~d);
+            g = (7 * i) % 16;
+        }
+        uint32_t next = d;
+        d = c;
+        c = b;
+        b = b + rotate_left(a + f + CONSTANTS[i] + words[g], SHIFTS[i]);
+        a = next;
+    }
+    m_state[0] += a;
+    m_state[1] += b;
+    m_state[2] += c;
+    m_state[3] += d;
+}
@@ -0,0 +1,20 @@
+#include "danejoe/common/hash/rolling_checksum.hpp"
+
+void DaneJoe::RollingChecksum::reset(const uint8_t* data, std::size_t size)
+{
+    m_a = 0;
+    m_b = 0;
+    m_size = size;
+    for (std::size_t i = 0; i < size; i++)
+    {
+        m_a += data[i];
+        m_b += static_cast<uint32_t>(size - i) * data[i];
+    }
+}
+
+uint32_t DaneJoe::RollingChecksum::compute(const uint8_t* data, std::size_t size)
+{
+    RollingChecksum checksum;
+    checksum.reset(data, size);
+    return checksum.get_value();
+}
@@ -0,0 +1,105 @@
+#include "danejoe/common/hash/xxhash64.hpp"
+
+namespace
+{
+    constexpr uint64_t PRIME_1 = 0x9E3779B185EBCA87ULL;
+    constexpr uint64_t PRIME_2 = 0xC2B2AE3D27D4EB4FULL;
+    constexpr uint64_t PRIME_3 = 0x165667B19E3779F9ULL;
+    constexpr uint64_t PRIME_4 = 0x85EBCA77C2B2AE63ULL;
+    constexpr uint64_t PRIME_5 = 0x27D4EB2F165667C5ULL;
+
+    uint64_t rotate_left(uint64_t value, int shift)
+    {
+        return (value << shift) | (value >> (64 - shift));
+    }
+
+    uint64_t load_le64(const uint8_t* data)
+    {
+        uint64_t value = 0;
+        for (int i = 0; i < 8; i++)
+        {
+            value |= static_cast<uint64_t>(data[i]) << (8 * i);
+        }
+        return value;
+    }
+
+    uint32_t load_le32(const uint8_t* data)
+    {
+        uint32_t value = 0;
+        for (int i = 0; i < 4; i++)
+        {
+            value |= static_cast<uint32_t>(data[i]) << (8 * i);
+        }
+        return value;
+    }
+
+    uint64_t round(uint64_t accumulator, uint64_t input)
+    {
+        accumulator += input * PRIME_2;
+        accumulator = rotate_left(accumulator, 31);
+        return accumulator * PRIME_1;
+    }
+
+    uint64_t merge_round(uint64_t accumulator, uint64_t value)
+    {
+        accumulator ^= round(0, value);
+        return accumulator * PRIME_1 + PRIME_4;
+    }
+}
+
+uint64_t DaneJoe::xxhash64(const uint8_t* data, std::size_t size, uint64_t seed)
+{
+    const uint8_t* end = data + size;
+    uint64_t hash = 0;
+    if (size >= 32)
+    {
+        // 四个独立累加器互不依赖，便于流水线与向量化
+        uint64_t v1 = seed + PRIME_1 + PRIME_2;
+        uint64_t v2 = seed + PRIME_2;
+        uint64_t v3 = seed;
+        uint64_t v4 = seed - PRIME_1;
+        const uint8_t* limit = end - 32;
+        do
+        {
+            v1 = round(v1, load_le64(data));
+            v2 = round(v2, load_le64(data + 8));
+            v3 = round(v3, load_le64(data + 16));
+            v4 = round(v4, load_le64(data + 24));
+            data += 32;
+        } while (data <= limit);
+        hash = rotate_left(v1, 1) + rotate_left(v2, 7) + rotate_left(v3, 12) + rotate_left(v4, 18);
+        hash = merge_round(hash, v1);
+        hash = merge_round(hash, v2);
+        hash = merge_round(hash, v3);
+        hash = merge_round(hash, v4);
+    }
+    else
+    {
+        hash = seed + PRIME_5;
+    }
+    hash += static_cast<uint64_t>(size);
+    while (data + 8 <= end)
+    {
+        hash ^= round(0, load_le64(data));
+        hash = rotate_left(hash, 27) * PRIME_1 + PRIME_4;
+        data += 8;
+    }
+    if (data + 4 <= end)
+    {
+        hash ^= static_cast<uint64_t>(load_le32(data)) * PRIME_1;
+        hash = rotate_left(hash, 23) * PRIME_2 + PRIME_3;
+        data += 4;
+    }
+    while (data < end)
+    {
+        hash ^= static_cast<uint64_t>(*data) * PRIME_5;
+        hash = rotate_left(hash, 11) * PRIME_1;
+        data++;
+    }
+    hash ^= hash >> 33;
+    hash *= PRIME_2;
+    hash ^= hash >> 29;
+    hash *= PRIME_3;
+    hash ^= hash >> 32;
+    return hash;
+}
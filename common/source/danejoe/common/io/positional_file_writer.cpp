@@ -0,0 +1,487 @@
+#include <algorithm>
+
+#include "danejoe/common/io/positional_file_writer.hpp"
+#include "danejoe/common/diagnostic/diagnostic_system.hpp"
+
+#if DANEJOE_PLATFORM_LINUX==1
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/uio.h>
+
+namespace
+{
+    /**
+     * @brief 完整写入一组数据段
+     * @param fd 文件描述符
+     * @param iovecs 数据段（写入过程中会被修改）
+     * @param offset 写入偏移
+     * @return 是否全部写入
+     * @details 处理 EINTR 与短写，短写后跳过已写部分继续写入。
+     */
+    bool pwritev_full(int fd, std::vector<iovec>& iovecs, int64_t offset)
+    {
+        std::size_t index = 0;
+        while (index < iovecs.size())
+        {
+            ssize_t written = ::pwritev(fd, iovecs.data() + index, static_cast<int>(iovecs.size() - index), offset);
+            if (written < 0)
+            {
+                if (errno == EINTR)
+                {
+                    continue;
+                }
+                return false;
+            }
+            offset += written;
+            auto rest = static_cast<std::size_t>(written);
+            while (index < iovecs.size() && rest >= iovecs[index].iov_len)
+            {
+                rest -= iovecs[index].iov_len;
+                index++;
+            }
+            if (index < iovecs.size())
+            {
+                iovecs[index].iov_base = static_cast<uint8_t*>(iovecs[index].iov_base) + rest;
+                iovecs[index].iov_len -= rest;
+            }
+        }
+        return true;
+    }
+}
+
+DaneJoe::PositionalFileWriter::PositionalFileWriter(const PositionalWriterConfig& config) :
+    m_config(config)
+{
+    m_thread = std::thread([this]()
+        {
+            run();
+        });
+}
+
+DaneJoe::PositionalFileWriter::~PositionalFileWriter()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_is_running = false;
+    }
+    m_condition.notify_one();
+    if (m_thread.joinable())
+    {
+        m_thread.join();
+    }
+    for (auto& [file_id, file] : m_files)
+    {
+        sync_file(file);
+    }
+}
+
+std::optional<uint64_t> DaneJoe::PositionalFileWriter::open_file(const std::string& path, int64_t file_size, std::optional<FileDigest> digest)
+{
+    UniqueHandle<int> handle(::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644));
+    if (!handle.is_valid())
+    {
+        ADD_DIAG_WARN("io", "Failed to open file {}: errno {}", path, errno);
+        return std::nullopt;
+    }
+    if (file_size > 0)
+    {
+        // 预分配失败（如文件系统不支持）不影响写入，仅失去连续分配的收益
+        int error_code = ::posix_fallocate(handle.get(), 0, file_size);
+        if (error_code != 0)
+        {
+            ADD_DIAG_WARN("io", "Failed to preallocate {} bytes for {}: errno {}", file_size, path, error_code);
+        }
+    }
+    uint64_t file_id = m_file_id_counter.fetch_add(1);
+    OpenedFile file;
+    file.handle = std::move(handle);
+    if (digest.has_value())
+    {
+        auto digest_end = static_cast<int64_t>(digest->md5.get_size());
+        for (const auto& [begin, end] : digest->written_ranges)
+        {
+            if (end > digest_end)
+            {
+                file.pending_ranges[std::max(begin, digest_end)] = end;
+            }
+        }
+        file.md5 = std::move(digest->md5);
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_files.emplace(file_id, std::move(file));
+    }
+    return file_id;
+}
+
+void DaneJoe::PositionalFileWriter::write(uint64_t file_id, int64_t offset, std::vector<uint8_t> data, Callback callback)
+{
+    Job job;
+    job.type = JobType::Write;
+    job.file_id = file_id;
+    job.offset = offset;
+    job.data = std::move(data);
+    job.callback = std::move(callback);
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_jobs.push_back(std::move(job));
+    }
+    m_condition.notify_one();
+}
+
+void DaneJoe::PositionalFileWriter::sync(uint64_t file_id, Callback callback)
+{
+    Job job;
+    job.type = JobType::Sync;
+    job.file_id = file_id;
+    job.callback = std::move(callback);
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_jobs.push_back(std::move(job));
+    }
+    m_condition.notify_one();
+}
+
+void DaneJoe::PositionalFileWriter::checkpoint(uint64_t file_id, CheckpointCallback callback)
+{
+    Job job;
+    job.type = JobType::Checkpoint;
+    job.file_id = file_id;
+    job.checkpoint_callback = std::move(callback);
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_jobs.push_back(std::move(job));
+    }
+    m_condition.notify_one();
+}
+
+void DaneJoe::PositionalFileWriter::close_file(uint64_t file_id, Callback callback)
+{
+    Job job;
+    job.type = JobType::Close;
+    job.file_id = file_id;
+    job.callback = std::move(callback);
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_jobs.push_back(std::move(job));
+    }
+    m_condition.notify_one();
+}
+
+void DaneJoe::PositionalFileWriter::invalidate_range(uint64_t file_id, int64_t begin, int64_t end, Callback callback)
+{
+    Job job;
+    job.type = JobType::Invalidate;
+    job.file_id = file_id;
+    job.offset = begin;
+    job.end_offset = end;
+    job.callback = std::move(callback);
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_jobs.push_back(std::move(job));
+    }
+    m_condition.notify_one();
+}
+
+void DaneJoe::PositionalFileWriter::run()
+{
+    std::vector<Job> jobs;
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_condition.wait(lock, [this]()
+                {
+                    return !m_is_running || !m_jobs.empty();
+                });
+            if (m_jobs.empty())
+            {
+                return;
+            }
+            // 一次取走全部积压任务，积压越多合并机会越大
+            jobs.assign(std::make_move_iterator(m_jobs.begin()), std::make_move_iterator(m_jobs.end()));
+            m_jobs.clear();
+        }
+        process_jobs(jobs);
+        jobs.clear();
+    }
+}
+
+void DaneJoe::PositionalFileWriter::process_jobs(std::vector<Job>& jobs)
+{
+    std::size_t begin = 0;
+    while (begin < jobs.size())
+    {
+        if (jobs[begin].type == JobType::Write)
+        {
+            std::size_t end = begin;
+            while (end < jobs.size() && jobs[end].type == JobType::Write)
+            {
+                end++;
+            }
+            write_jobs(jobs, begin, end);
+            begin = end;
+            continue;
+        }
+        auto& job = jobs[begin];
+        bool is_success = false;
+        std::optional<Md5> md5;
+        OpenedFile* file = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            auto file_it = m_files.find(job.file_id);
+            if (file_it != m_files.end())
+            {
+                file = &file_it->second;
+            }
+        }
+        if (file && job.type == JobType::Invalidate)
+        {
+            if (file->md5.has_value())
+            {
+                invalidate_digest(*file, job.offset, job.end_offset);
+            }
+            is_success = !file->is_failed;
+        }
+        else if (file)
+        {
+            is_success = sync_file(*file) && !file->is_failed;
+            if (job.type == JobType::Checkpoint && file->md5.has_value())
+            {
+                advance_digest(*file);
+                md5 = file->md5;
+            }
+            if (job.type == JobType::Close)
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_files.erase(job.file_id);
+            }
+        }
+        if (job.callback)
+        {
+            job.callback(is_success);
+        }
+        if (job.checkpoint_callback)
+        {
+            job.checkpoint_callback(is_success, std::move(md5));
+        }
+        begin++;
+    }
+}
+
+void DaneJoe::PositionalFileWriter::write_jobs(std::vector<Job>& jobs, std::size_t begin, std::size_t end)
+{
+    std::stable_sort(jobs.begin() + begin, jobs.begin() + end, [](const Job& lhs, const Job& rhs)
+        {
+            if (lhs.file_id != rhs.file_id)
+            {
+                return lhs.file_id < rhs.file_id;
+            }
+            return lhs.offset < rhs.offset;
+        });
+    std::vector<iovec> iovecs;
+    std::size_t group_begin = begin;
+    while (group_begin < end)
+    {
+        // 收集与首个任务偏移首尾相接的任务，合并为一次 pwritev
+        const auto& first = jobs[group_begin];
+        int64_t group_end_offset = first.offset + static_cast<int64_t>(first.data.size());
+        std::size_t group_end = group_begin + 1;
+        while (group_end < end &&
+            jobs[group_end].file_id == first.file_id &&
+            jobs[group_end].offset == group_end_offset &&
+            static_cast<int>(group_end - group_begin) < m_config.max_coalesce_segments &&
+            group_end_offset - first.offset + static_cast<int64_t>(jobs[group_end].data.size()) <= m_config.max_coalesce_bytes)
+        {
+            group_end_offset += static_cast<int64_t>(jobs[group_end].data.size());
+            group_end++;
+        }
+        OpenedFile* file = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            auto file_it = m_files.find(first.file_id);
+            if (file_it != m_files.end())
+            {
+                file = &file_it->second;
+            }
+        }
+        bool is_success = false;
+        if (file)
+        {
+            iovecs.clear();
+            for (std::size_t i = group_begin; i < group_end; i++)
+            {
+                if (!jobs[i].data.empty())
+                {
+                    iovecs.push_back(iovec{ jobs[i].data.data(), jobs[i].data.size() });
+                }
+            }
+            is_success = pwritev_full(file->handle.get(), iovecs, first.offset);
+            if (!is_success)
+            {
+                int error_code = errno;
+                file->is_failed = true;
+                ADD_DIAG_WARN("io", "Failed to write {} bytes at {}: errno {}", group_end_offset - first.offset, first.offset, error_code);
+            }
+            else
+            {
+                file->unsynced_bytes += group_end_offset - first.offset;
+                if (m_config.sync_interval_bytes > 0 && file->unsynced_bytes >= m_config.sync_interval_bytes)
+                {
+                    sync_file(*file);
+                }
+            }
+        }
+        for (std::size_t i = group_begin; i < group_end; i++)
+        {
+            if (jobs[i].callback)
+            {
+                jobs[i].callback(is_success);
+            }
+        }
+        // 先回调再摘要，摘要耗时不推迟写完成通知
+        if (is_success && file->md5.has_value())
+        {
+            for (std::size_t i = group_begin; i < group_end; i++)
+            {
+                digest_data(*file, jobs[i].offset, jobs[i].data);
+            }
+        }
+        group_begin = group_end;
+    }
+}
+
+void DaneJoe::PositionalFileWriter::digest_data(OpenedFile& file, int64_t offset, std::vector<uint8_t>& data)
+{
+    auto digest_end = static_cast<int64_t>(file.md5->get_size());
+    auto data_end = offset + static_cast<int64_t>(data.size());
+    if (data.empty() || data_end <= digest_end)
+    {
+        return;
+    }
+    if (offset <= digest_end)
+    {
+        file.md5->update(data.data() + (digest_end - offset), static_cast<std::size_t>(data_end - digest_end));
+        advance_digest(file);
+        return;
+    }
+    file.pending_bytes += static_cast<int64_t>(data.size());
+    file.pending_data.emplace(offset, std::move(data));
+    // 超出内存上限时，丢弃离前缀最远的暂存数据，改记为待读取区间
+    while (file.pending_bytes > m_config.max_digest_pending_bytes && !file.pending_data.empty())
+    {
+        auto last_it = std::prev(file.pending_data.end());
+        auto size = static_cast<int64_t>(last_it->second.size());
+        file.pending_ranges[last_it->first] = last_it->first + size;
+        file.pending_bytes -= size;
+        file.pending_data.erase(last_it);
+    }
+}
+
+void DaneJoe::PositionalFileWriter::advance_digest(OpenedFile& file)
+{
+    std::vector<uint8_t> read_buffer;
+    while (true)
+    {
+        auto digest_end = static_cast<int64_t>(file.md5->get_size());
+        if (!file.pending_data.empty() && file.pending_data.begin()->first <= digest_end)
+        {
+            auto data_it = file.pending_data.begin();
+            auto data_end = data_it->first + static_cast<int64_t>(data_it->second.size());
+            if (data_end > digest_end)
+            {
+                file.md5->update(data_it->second.data() + (digest_end - data_it->first), static_cast<std::size_t>(data_end - digest_end));
+            }
+            file.pending_bytes -= static_cast<int64_t>(data_it->second.size());
+            file.pending_data.erase(data_it);
+            continue;
+        }
+        if (!file.pending_ranges.empty() && file.pending_ranges.begin()->first <= digest_end)
+        {
+            auto range_it = file.pending_ranges.begin();
+            auto range_end = range_it->second;
+            file.pending_ranges.erase(range_it);
+            read_buffer.resize(1024 * 1024);
+            while (digest_end < range_end)
+            {
+                auto size = static_cast<std::size_t>(std::min<int64_t>(range_end - digest_end, static_cast<int64_t>(read_buffer.size())));
+                ssize_t read_size = ::pread(file.handle.get(), read_buffer.data(), size, digest_end);
+                if (read_size < 0 && errno == EINTR)
+                {
+                    continue;
+                }
+                if (read_size <= 0)
+                {
+                    int error_code = read_size < 0 ? errno : 0;
+                    file.is_failed = true;
+                    ADD_DIAG_WARN("io", "Failed to read {} bytes at {} for digest: errno {}", size, digest_end, error_code);
+                    return;
+                }
+                file.md5->update(read_buffer.data(), static_cast<std::size_t>(read_size));
+                digest_end += read_size;
+            }
+            continue;
+        }
+        return;
+    }
+}
+
+void DaneJoe::PositionalFileWriter::invalidate_digest(OpenedFile& file, int64_t begin, int64_t end)
+{
+    if (begin >= end)
+    {
+        return;
+    }
+    // 已写入的数据全部改记为待读取区间（数据均已写入文件），再扣除失效区间
+    std::vector<std::pair<int64_t, int64_t>> written_ranges;
+    auto digest_end = static_cast<int64_t>(file.md5->get_size());
+    if (begin < digest_end)
+    {
+        written_ranges.emplace_back(0, digest_end);
+        file.md5 = Md5();
+    }
+    for (const auto& [offset, data] : file.pending_data)
+    {
+        written_ranges.emplace_back(offset, offset + static_cast<int64_t>(data.size()));
+    }
+    for (const auto& [range_begin, range_end] : file.pending_ranges)
+    {
+        written_ranges.emplace_back(range_begin, range_end);
+    }
+    file.pending_data.clear();
+    file.pending_bytes = 0;
+    file.pending_ranges.clear();
+    for (const auto& [range_begin, range_end] : written_ranges)
+    {
+        if (range_begin < begin)
+        {
+            auto& kept_end = file.pending_ranges[range_begin];
+            kept_end = std::max(kept_end, std::min(range_end, begin));
+        }
+        if (range_end > end)
+        {
+            auto kept_begin = std::max(range_begin, end);
+            auto& kept_end = file.pending_ranges[kept_begin];
+            kept_end = std::max(kept_end, range_end);
+        }
+    }
+    advance_digest(file);
+}
+
+bool DaneJoe::PositionalFileWriter::sync_file(OpenedFile& file)
+{
+    if (file.unsynced_bytes == 0)
+    {
+        return true;
+    }
+    if (::fdatasync(file.handle.get()) != 0)
+    {
+        ADD_DIAG_WARN("io", "Failed to sync file: errno {}", errno);
+        file.is_failed = true;
+        return false;
+    }
+    file.unsynced_bytes = 0;
+    return true;
+}
+#endif
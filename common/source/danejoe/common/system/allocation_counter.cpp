@@ -0,0 +1,123 @@
+#include "danejoe/common/system/allocation_counter.hpp"
+#include "danejoe/common/type_traits/platform_traits.hpp"
+
+#if DANEJOE_PLATFORM_LINUX==1
+#include <new>
+#include <atomic>
+#include <algorithm>
+#include <cstdlib>
+
+namespace
+{
+    /// @brief 分配次数
+    std::atomic<uint64_t> g_allocation_count{ 0 };
+
+    void* counted_allocate(std::size_t size)
+    {
+        g_allocation_count.fetch_add(1, std::memory_order_relaxed);
+        return std::malloc(size == 0 ? 1 : size);
+    }
+
+    void* counted_allocate_aligned(std::size_t size, std::align_val_t alignment)
+    {
+        g_allocation_count.fetch_add(1, std::memory_order_relaxed);
+        void* pointer = nullptr;
+        std::size_t align = std::max(static_cast<std::size_t>(alignment), sizeof(void*));
+        if (::posix_memalign(&pointer, align, size == 0 ? 1 : size) != 0)
+        {
+            return nullptr;
+        }
+        return pointer;
+    }
+}
+
+void* operator new(std::size_t size)
+{
+    void* pointer = counted_allocate(size);
+    if (!pointer)
+    {
+        throw std::bad_alloc();
+    }
+    return pointer;
+}
+
+void* operator new[](std::size_t size)
+{
+    return ::operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    return counted_allocate(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+    return counted_allocate(size);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+    void* pointer = counted_allocate_aligned(size, alignment);
+    if (!pointer)
+    {
+        throw std::bad_alloc();
+    }
+    return pointer;
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment)
+{
+    return ::operator new(size, alignment);
+}
+
+void operator delete(void* pointer) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete[](void* pointer) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete[](void* pointer, std::size_t) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, std::align_val_t) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete[](void* pointer, std::align_val_t) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t, std::align_val_t) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete[](void* pointer, std::size_t, std::align_val_t) noexcept
+{
+    std::free(pointer);
+}
+
+uint64_t DaneJoe::get_allocation_count()
+{
+    return g_allocation_count.load(std::memory_order_relaxed);
+}
+#else
+uint64_t DaneJoe::get_allocation_count()
+{
+    return 0;
+}
+#endif
@@ -4,6 +4,7 @@
 #include <windows.h>
 #else
 #include <unistd.h>
+#include <sys/syscall.h>
 #endif
 
 
@@ -15,3 +16,13 @@ int DaneJoe::get_process_id()
     return static_cast<int>(::getpid());
 #endif
 }
+
+int DaneJoe::get_thread_id()
+{
+#if defined(_WIN32)
+    thread_local int thread_id = static_cast<int>(::GetCurrentThreadId());
+#else
+    thread_local int thread_id = static_cast<int>(::syscall(SYS_gettid));
+#endif
+    return thread_id;
+}
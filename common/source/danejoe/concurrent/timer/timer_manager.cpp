@@ -1,7 +1,14 @@
+#include <algorithm>
+
 #include "danejoe/concurrent/timer/timer_manager.hpp"
 
 using namespace std::chrono_literals;
 
+bool DaneJoe::TimerHandle::is_valid()const
+{
+    return index != UINT32_MAX;
+}
+
 DaneJoe::TimerManager& DaneJoe::TimerManager::get_instance()
 {
     static TimerManager instance;
@@ -18,23 +25,77 @@ std::chrono::steady_clock::time_point DaneJoe::TimerManager::get_steady_time()co
     return std::chrono::steady_clock::now();
 }
 
-void DaneJoe::TimerManager::add_task_until(
+DaneJoe::TimerHandle DaneJoe::TimerManager::add_task_until(
     const std::chrono::steady_clock::time_point& time, std::function<void()> callback)
 {
+    uint64_t expire_tick = to_tick(time);
+    TimerHandle handle;
+    bool is_need_notify = false;
     {
         std::lock_guard<std::mutex> lock(m_task_queue_mutex);
-        m_timer_callbacks.insert(std::make_pair(time, callback));
+        if (m_timer_count == 0)
+        {
+            // 时间轮为空时直接跳到当前刻度，避免任务线程空转追赶
+            auto now_tick = static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::milliseconds>(get_steady_time() - m_start_time).count());
+            m_current_tick = std::max(m_current_tick, now_tick);
+        }
+        uint32_t index = m_free_node_head;
+        if (index != INVALID_INDEX)
+        {
+            m_free_node_head = m_timer_nodes[index].next;
+        }
+        else
+        {
+            index = static_cast<uint32_t>(m_timer_nodes.size());
+            m_timer_nodes.emplace_back();
+        }
+        auto& node = m_timer_nodes[index];
+        node.callback = std::move(callback);
+        node.expire_tick = expire_tick;
+        link_node(index);
+        m_timer_count++;
+        handle.index = index;
+        handle.generation = node.generation;
+        uint64_t effective_tick = std::max(expire_tick, m_current_tick);
+        if (effective_tick < m_planned_wake_tick)
+        {
+            m_planned_wake_tick = effective_tick;
+            is_need_notify = true;
+        }
     }
-    m_task_queue_condition.notify_one();
+    if (is_need_notify)
+    {
+        m_task_queue_condition.notify_one();
+    }
+    return handle;
 }
-void DaneJoe::TimerManager::add_task_for(const std::chrono::steady_clock::duration& time, std::function<void()> callback)
+DaneJoe::TimerHandle DaneJoe::TimerManager::add_task_for(const std::chrono::steady_clock::duration& time, std::function<void()> callback)
+{
+    return add_task_until(get_steady_time() + time, std::move(callback));
+}
+
+bool DaneJoe::TimerManager::cancel(const TimerHandle& handle)
 {
-    std::chrono::steady_clock::time_point deadline = get_steady_time() + time;
+    std::function<void()> callback;
     {
         std::lock_guard<std::mutex> lock(m_task_queue_mutex);
-        m_timer_callbacks.insert(std::make_pair(deadline, callback));
+        if (handle.index >= m_timer_nodes.size())
+        {
+            return false;
+        }
+        auto& node = m_timer_nodes[handle.index];
+        if (node.slot == INVALID_INDEX || node.generation != handle.generation)
+        {
+            return false;
+        }
+        unlink_node(handle.index);
+        callback = std::move(node.callback);
+        free_node(handle.index);
+        m_timer_count--;
     }
-    m_task_queue_condition.notify_one();
+    // 回调在锁外析构，避免其捕获对象的析构函数重入定时器
+    return true;
 }
 
 uint64_t DaneJoe::TimerManager::add_periodic_task(const std::chrono::steady_clock::duration& time, std::function<void()> callback, int64_t remain_times)
@@ -44,11 +105,9 @@ uint64_t DaneJoe::TimerManager::add_periodic_task(const std::chrono::steady_cloc
     task.callback = std::move(callback);
     task.remain_times = remain_times;
     task.time = time;
-    {
-        std::lock_guard<std::mutex> lock(m_periodic_task_mutex);
-        m_periodic_tasks.emplace(task_id, task);
-    }
-    add_task_for(time, [task_id, this]()
+    std::lock_guard<std::mutex> lock(m_periodic_task_mutex);
+    auto it = m_periodic_tasks.emplace(task_id, std::move(task)).first;
+    it->second.timer_handle = add_task_for(time, [task_id, this]()
         {
             execute_periodic_task(task_id);
         });
@@ -83,7 +142,7 @@ void DaneJoe::TimerManager::execute_periodic_task(uint64_t task_id)
         if (times != 0)
         {
             // 添加下一轮任务回调
-            add_task_for(time, [task_id, this]()
+            task->second.timer_handle = add_task_for(time, [task_id, this]()
                 {
                     execute_periodic_task(task_id);
                 });
@@ -105,7 +164,13 @@ void DaneJoe::TimerManager::execute_periodic_task(uint64_t task_id)
 void DaneJoe::TimerManager::cancel_periodic_task(uint64_t task_id)
 {
     std::lock_guard<std::mutex> lock(m_periodic_task_mutex);
-    m_periodic_tasks.erase(task_id);
+    auto it = m_periodic_tasks.find(task_id);
+    if (it == m_periodic_tasks.end())
+    {
+        return;
+    }
+    cancel(it->second.timer_handle);
+    m_periodic_tasks.erase(it);
 }
 
 void DaneJoe::TimerManager::set_execute_environment(std::function<void(std::function<void()>)> execute_environment)
@@ -113,71 +178,216 @@ void DaneJoe::TimerManager::set_execute_environment(std::function<void(std::func
     m_execute_environment = execute_environment;
 }
 
+uint64_t DaneJoe::TimerManager::to_tick(const std::chrono::steady_clock::time_point& time)const
+{
+    if (time <= m_start_time)
+    {
+        return 0;
+    }
+    auto elapsed = time - m_start_time;
+    auto ticks = std::chrono::duration_cast<std::chrono::milliseconds>(elapsed);
+    if (ticks < elapsed)
+    {
+        ticks += TICK_DURATION;
+    }
+    return static_cast<uint64_t>(ticks.count());
+}
+
+void DaneJoe::TimerManager::link_node(uint32_t index)
+{
+    auto& node = m_timer_nodes[index];
+    uint64_t expire_tick = std::max(node.expire_tick, m_current_tick);
+    uint64_t delta = expire_tick - m_current_tick;
+    uint32_t slot = 0;
+    if (delta < LEVEL0_SIZE)
+    {
+        slot = static_cast<uint32_t>(expire_tick & (LEVEL0_SIZE - 1));
+    }
+    else
+    {
+        if (delta > MAX_WHEEL_TICKS)
+        {
+            expire_tick = m_current_tick + MAX_WHEEL_TICKS;
+            delta = MAX_WHEEL_TICKS;
+        }
+        uint32_t level = 1;
+        uint32_t shift = LEVEL0_BITS;
+        while (level < UPPER_LEVEL_COUNT && delta >= (1ull << (shift + LEVELN_BITS)))
+        {
+            level++;
+            shift += LEVELN_BITS;
+        }
+        slot = LEVEL0_SIZE + (level - 1) * LEVELN_SIZE +
+            static_cast<uint32_t>((expire_tick >> shift) & (LEVELN_SIZE - 1));
+    }
+    node.slot = slot;
+    node.prev = INVALID_INDEX;
+    node.next = m_slot_heads[slot];
+    if (node.next != INVALID_INDEX)
+    {
+        m_timer_nodes[node.next].prev = index;
+    }
+    m_slot_heads[slot] = index;
+}
+
+void DaneJoe::TimerManager::unlink_node(uint32_t index)
+{
+    auto& node = m_timer_nodes[index];
+    if (node.prev != INVALID_INDEX)
+    {
+        m_timer_nodes[node.prev].next = node.next;
+    }
+    else
+    {
+        m_slot_heads[node.slot] = node.next;
+    }
+    if (node.next != INVALID_INDEX)
+    {
+        m_timer_nodes[node.next].prev = node.prev;
+    }
+    node.prev = INVALID_INDEX;
+    node.next = INVALID_INDEX;
+}
+
+void DaneJoe::TimerManager::free_node(uint32_t index)
+{
+    auto& node = m_timer_nodes[index];
+    node.callback = nullptr;
+    node.slot = INVALID_INDEX;
+    node.prev = INVALID_INDEX;
+    node.generation++;
+    node.next = m_free_node_head;
+    m_free_node_head = index;
+}
+
+void DaneJoe::TimerManager::cascade_slot(uint32_t slot)
+{
+    uint32_t index = m_slot_heads[slot];
+    m_slot_heads[slot] = INVALID_INDEX;
+    while (index != INVALID_INDEX)
+    {
+        uint32_t next = m_timer_nodes[index].next;
+        link_node(index);
+        index = next;
+    }
+}
+
+void DaneJoe::TimerManager::advance_tick(std::vector<std::function<void()>>& expired_callbacks)
+{
+    uint64_t tick = m_current_tick;
+    // 每转完一圈低层，将上一层对应槽位中的任务下放，高层依次类推
+    uint64_t shifted_tick = tick;
+    uint32_t mask = LEVEL0_SIZE - 1;
+    uint32_t shift = LEVEL0_BITS;
+    for (uint32_t level = 1; level <= UPPER_LEVEL_COUNT; level++)
+    {
+        if ((shifted_tick & mask) != 0)
+        {
+            break;
+        }
+        shifted_tick = tick >> shift;
+        uint32_t level_index = static_cast<uint32_t>(shifted_tick & (LEVELN_SIZE - 1));
+        cascade_slot(LEVEL0_SIZE + (level - 1) * LEVELN_SIZE + level_index);
+        mask = LEVELN_SIZE - 1;
+        shift += LEVELN_BITS;
+    }
+    uint32_t slot = static_cast<uint32_t>(tick & (LEVEL0_SIZE - 1));
+    uint32_t index = m_slot_heads[slot];
+    m_slot_heads[slot] = INVALID_INDEX;
+    while (index != INVALID_INDEX)
+    {
+        uint32_t next = m_timer_nodes[index].next;
+        expired_callbacks.push_back(std::move(m_timer_nodes[index].callback));
+        free_node(index);
+        m_timer_count--;
+        index = next;
+    }
+    m_current_tick++;
+}
+
+uint64_t DaneJoe::TimerManager::get_next_wake_tick()const
+{
+    if (m_timer_count == 0)
+    {
+        return UINT64_MAX;
+    }
+    // 第 0 层一圈之内的最早非空槽位；到达一圈边界时需要下放上层任务
+    for (uint64_t tick = m_current_tick; tick < m_current_tick + LEVEL0_SIZE; tick++)
+    {
+        uint32_t slot = static_cast<uint32_t>(tick & (LEVEL0_SIZE - 1));
+        if (slot == 0 || m_slot_heads[slot] != INVALID_INDEX)
+        {
+            return tick;
+        }
+    }
+    return m_current_tick + LEVEL0_SIZE;
+}
+
 DaneJoe::TimerManager::TimerManager()
 {
+    m_start_time = get_steady_time();
+    m_slot_heads.fill(INVALID_INDEX);
     m_is_running.store(true);
 
-
     auto timer_thread_lambda = [this]()
         {
+            std::vector<std::function<void()>> expired_callbacks;
             while (m_is_running.load())
             {
                 {
                     std::unique_lock<std::mutex> lock(m_task_queue_mutex);
-                    auto wait_time = m_timer_callbacks.empty() ? std::chrono::steady_clock::time_point::max() : m_timer_callbacks.begin()->first;
-                    m_task_queue_condition.wait_until(
-                        lock,
-                        wait_time,
-                        [this, wait_time]()
-                        {
-                            if (!m_is_running.load())
-                            {
-                                return true;
-                            }
-                            if (m_timer_callbacks.empty())
-                            {
-                                return false;
-                            }
-                            return m_timer_callbacks.begin()->first < wait_time;
-                        });
-                    if (!m_is_running.load())
+                    auto now_tick = static_cast<uint64_t>(
+                        std::chrono::duration_cast<std::chrono::milliseconds>(get_steady_time() - m_start_time).count());
+                    if (m_timer_count == 0)
                     {
-                        return;
+                        m_current_tick = std::max(m_current_tick, now_tick);
                     }
-                    wait_time = m_timer_callbacks.empty() ? std::chrono::steady_clock::time_point::max() : m_timer_callbacks.begin()->first;
-                    auto now = get_steady_time();
-                    if (wait_time > now ||
-                        m_timer_callbacks.empty())
+                    while (m_current_tick <= now_tick)
                     {
-                        continue;
+                        advance_tick(expired_callbacks);
                     }
-                    while (!m_timer_callbacks.empty() &&
-                        m_timer_callbacks.begin()->first <= now)
+                    if (expired_callbacks.empty())
                     {
-                        auto it = m_timer_callbacks.begin();
-                        m_task_queue.push_back(std::move(it->second));
-                        m_timer_callbacks.erase(it);
+                        uint64_t wake_tick = get_next_wake_tick();
+                        m_planned_wake_tick = wake_tick;
+                        auto predicate = [this, wake_tick]()
+                            {
+                                return !m_is_running.load() || m_planned_wake_tick != wake_tick;
+                            };
+                        if (wake_tick == UINT64_MAX)
+                        {
+                            m_task_queue_condition.wait(lock, predicate);
+                        }
+                        else
+                        {
+                            m_task_queue_condition.wait_until(lock, m_start_time + wake_tick * TICK_DURATION, predicate);
+                        }
+                        continue;
                     }
                 }
-                while (!m_task_queue.empty())
+                // 同一批到期的回调在锁外统一执行，回调中可以再次添加或取消任务
+                for (auto& callback : expired_callbacks)
                 {
                     if (m_execute_environment)
                     {
-                        m_execute_environment(m_task_queue.front());
+                        m_execute_environment(std::move(callback));
                     }
                     else
                     {
-                        m_task_queue.front()();
+                        callback();
                     }
-                    m_task_queue.pop_front();
                 }
+                expired_callbacks.clear();
             }
         };
     m_task_thread = std::thread(timer_thread_lambda);
 }
 DaneJoe::TimerManager::~TimerManager()
 {
-    m_is_running.store(false);
+    {
+        std::lock_guard<std::mutex> lock(m_task_queue_mutex);
+        m_is_running.store(false);
+    }
     m_task_queue_condition.notify_one();
     if (m_task_thread.joinable())
     {
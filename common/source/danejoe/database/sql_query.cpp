@@ -1,6 +1,23 @@
+#include <chrono>
+
 #include "danejoe/common/diagnostic/diagnostic_system.hpp"
+#include "danejoe/metrics/metrics_registry.hpp"
 #include "danejoe/database/sql_query.hpp"
 
+namespace
+{
+    /**
+     * @brief 计算自起始时间以来经过的纳秒数
+     * @param start_time 起始时间
+     * @return 经过的纳秒数
+     */
+    uint64_t get_elapsed_ns(std::chrono::steady_clock::time_point start_time)
+    {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start_time).count());
+    }
+}
+
 DaneJoe::SqlQuery::SqlQuery(std::shared_ptr<SqlDatabase> database)
 {
     m_driver = database->get_driver();
@@ -59,7 +76,11 @@ std::vector<std::vector<DaneJoe::SqlCell>> DaneJoe::SqlQuery::execute_query()
         ADD_DIAG_ERROR("database", "Execute query failed: driver expired");
         return std::vector<std::vector<DaneJoe::SqlCell>>();
     }
-    return m_driver.lock()->execute_query(m_sql);
+    static MetricsHistogram& query_latency = MetricsRegistry::get_instance().get_histogram("database_query_latency_ns");
+    auto start_time = std::chrono::steady_clock::now();
+    auto result = m_driver.lock()->execute_query(m_sql);
+    query_latency.record(get_elapsed_ns(start_time));
+    return result;
 }
 
 bool DaneJoe::SqlQuery::execute_command()
@@ -69,5 +90,9 @@ bool DaneJoe::SqlQuery::execute_command()
         ADD_DIAG_ERROR("database", "Execute command failed: driver expired");
         return false;
     }
-    return m_driver.lock()->execute_command(m_sql);
+    static MetricsHistogram& command_latency = MetricsRegistry::get_instance().get_histogram("database_command_latency_ns");
+    auto start_time = std::chrono::steady_clock::now();
+    bool is_success = m_driver.lock()->execute_command(m_sql);
+    command_latency.record(get_elapsed_ns(start_time));
+    return is_success;
 }
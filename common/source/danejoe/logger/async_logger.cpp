@@ -1,12 +1,58 @@
 #include <iostream>
 #include <format>
 #include <string>
+#include <utility>
+#include <charconv>
+#include <algorithm>
 #include <filesystem>
 
 #include "danejoe/logger/async_logger.hpp"
+#include "danejoe/common/core/variable_util.hpp"
 
 namespace fs = std::filesystem;
 
+namespace
+{
+    /// @brief 后台线程空闲时的轮询间隔
+    constexpr auto IDLE_WAIT_TIME = std::chrono::milliseconds(10);
+    /// @brief 缓冲区满时生产者每次等待的时间
+    constexpr auto FULL_WAIT_TIME = std::chrono::microseconds(50);
+    /// @brief 每轮从单个缓冲区取出的最大记录数
+    constexpr std::size_t MAX_DRAIN_RECORD_COUNT = 4096;
+    /// @brief 下一个日志器编号
+    std::atomic<uint64_t> g_next_logger_id = 1;
+
+    /**
+     * @struct ThreadBufferCache
+     * @brief 线程持有的记录缓冲区
+     * @details 按日志器编号缓存，线程退出时将缓冲区标记为废弃，由后台线程取空后释放。
+     */
+    struct ThreadBufferCache
+    {
+        /// @brief 最近使用的日志器编号
+        uint64_t last_logger_id = 0;
+        /// @brief 最近使用的缓冲区
+        DaneJoe::LogRecordBuffer* last_buffer = nullptr;
+        /// @brief 各日志器的缓冲区
+        std::vector<std::pair<uint64_t, std::shared_ptr<DaneJoe::LogRecordBuffer>>> buffers;
+        ~ThreadBufferCache();
+    };
+
+    /// @brief 线程缓存是否已析构（平凡类型，析构后仍可读取）
+    thread_local bool t_is_buffer_cache_destroyed = false;
+    /// @brief 线程缓存
+    thread_local ThreadBufferCache t_buffer_cache;
+
+    ThreadBufferCache::~ThreadBufferCache()
+    {
+        t_is_buffer_cache_destroyed = true;
+        for (auto& [logger_id, buffer] : buffers)
+        {
+            buffer->abandon();
+        }
+    }
+}
+
 DaneJoe::AsyncLogger::AsyncLogger()
 {
     if (m_config.enable_async)
@@ -28,36 +74,69 @@ DaneJoe::AsyncLogger::AsyncLogger(const LoggerConfig& config) :ILogger(config)
     }
 }
 
+void DaneJoe::AsyncLogger::start_async_log()
+{
+    if (m_is_running.load())
+    {
+        return;
+    }
+    m_logger_id = g_next_logger_id.fetch_add(1, std::memory_order_relaxed);
+    m_last_flush_time = std::chrono::steady_clock::now();
+    m_is_running.store(true, std::memory_order_release);
+    m_async_log_thread = std::thread(&AsyncLogger::async_log_handler, this);
+}
+
 void DaneJoe::AsyncLogger::stop_async_log()
 {
+    if (!m_async_log_thread.joinable())
     {
-        std::unique_lock<std::mutex> lock(m_console_log_queue_mutex);
-        m_async_console_log_flag.store(false);
-        m_console_log_queue_cond.notify_all();
-        m_console_log_queue_cond.wait(lock, [this]()
-            {
-                return m_console_log_queue.empty();
-            });
-        m_console_log_queue_cond.notify_all();
+        return;
     }
     {
-        std::unique_lock<std::mutex> lock(m_file_log_queue_mutex);
-        m_async_file_log_flag.store(false);
-        m_file_log_queue_cond.notify_all();
-        m_file_log_queue_cond.wait(lock, [this]()
-            {
-                return m_file_log_queue.empty();
-            });
-        m_file_log_queue_cond.notify_all();
+        std::lock_guard<std::mutex> lock(m_wakeup_mutex);
+        m_is_running.store(false, std::memory_order_release);
+    }
+    m_wakeup_cond.notify_all();
+    m_async_log_thread.join();
+}
+
+DaneJoe::LogRecordBuffer* DaneJoe::AsyncLogger::get_record_buffer()
+{
+    if (!m_is_running.load(std::memory_order_acquire) || t_is_buffer_cache_destroyed)
+    {
+        return nullptr;
     }
-    if (m_async_file_log_thread.joinable())
+    ThreadBufferCache& cache = t_buffer_cache;
+    if (cache.last_logger_id == m_logger_id)
     {
-        m_async_file_log_thread.join();
+        return cache.last_buffer;
     }
-    if (m_async_console_log_thread.joinable())
+    auto it = std::find_if(cache.buffers.begin(), cache.buffers.end(), [this](const auto& entry)
+        {
+            return entry.first == m_logger_id;
+        });
+    if (it == cache.buffers.end())
     {
-        m_async_console_log_thread.join();
+        auto buffer = std::make_shared<LogRecordBuffer>(m_config.thread_buffer_size);
+        {
+            std::lock_guard<std::mutex> lock(m_buffer_mutex);
+            m_buffers.push_back(buffer);
+            m_buffer_version.fetch_add(1, std::memory_order_release);
+        }
+        it = cache.buffers.emplace(cache.buffers.end(), m_logger_id, std::move(buffer));
     }
+    cache.last_logger_id = m_logger_id;
+    cache.last_buffer = it->second.get();
+    return cache.last_buffer;
+}
+
+bool DaneJoe::AsyncLogger::wait_record_buffer(LogRecordBuffer& buffer)
+{
+    DANEJOE_UNUSED(buffer)
+    m_is_wakeup_requested.store(true, std::memory_order_relaxed);
+    m_wakeup_cond.notify_one();
+    std::this_thread::sleep_for(FULL_WAIT_TIME);
+    return m_is_running.load(std::memory_order_acquire);
 }
 
 void DaneJoe::AsyncLogger::log_msg(LogLevel level,
@@ -69,40 +148,20 @@ void DaneJoe::AsyncLogger::log_msg(LogLevel level,
     int process_id,
     const std::string& thread_id)
 {
-    std::string header = get_header(level, module, log_info, file_name, function_name, line_num, process_id, thread_id);
-    std::string log_str = std::format("{}[:] [{}] ", header, log_info);
+    std::string log_str = get_header(level, module, log_info, file_name, function_name, line_num, process_id, thread_id);
+    log_str += "[:] [";
+    log_str += log_info;
+    log_str += "] ";
+    std::lock_guard<std::mutex> lock(m_output_mutex);
     if (m_config.enable_console && m_config.console_level <= level)
     {
-        if (m_async_console_log_flag.load())
-        {
-            std::lock_guard<std::mutex> lock(m_console_log_queue_mutex);
-            m_console_log_queue.push(log_str);
-            std::atomic_thread_fence(std::memory_order_seq_cst);
-            m_console_log_queue_cond.notify_one();
-        }
-        else
-        {
-            std::lock_guard<std::mutex> lock(m_console_mutex);
-            std::cout << log_str << std::endl;
-        }
+        std::cout << log_str << std::endl;
     }
-    if (m_config.enable_file && m_config.file_level <= level)
+    if (m_config.enable_file && m_config.file_level <= level && open_log_file())
     {
-        if (m_async_file_log_flag.load())
-        {
-            std::lock_guard<std::mutex> lock(m_file_log_queue_mutex);
-            m_file_log_queue.push(log_str);
-            std::atomic_thread_fence(std::memory_order_seq_cst);
-            m_file_log_queue_cond.notify_one();
-        }
-        else
-        {
-            std::lock_guard<std::mutex> lock(m_file_mutex);
-            if (open_log_file())
-            {
-                m_log_file << log_str << std::endl;
-            }
-        }
+        m_log_file << log_str << std::endl;
+        m_is_file_dirty = false;
+        m_last_flush_time = std::chrono::steady_clock::now();
     }
 }
 
@@ -115,7 +174,7 @@ bool DaneJoe::AsyncLogger::open_log_file()
     /// @brief 确认目录存在，当目录不存在时创建目录
     fs::path full_path(m_config.log_path);
     fs::path path = full_path.parent_path();
-    if (!fs::exists(path))
+    if (!path.empty() && !fs::exists(path))
     {
         fs::create_directories(path);
     }
@@ -127,99 +186,173 @@ bool DaneJoe::AsyncLogger::open_log_file()
     return false;
 }
 
-std::shared_ptr<DaneJoe::ILogger> DaneJoe::DaneJoeLoggerCreator::operator()(const LoggerConfig& config)
-{
-    return std::make_shared<AsyncLogger>(config);
-}
-
-void DaneJoe::AsyncLogger::async_file_log_handler()
+void DaneJoe::AsyncLogger::async_log_handler()
 {
     while (true)
     {
-        std::string log_str;
+        bool is_running = m_is_running.load(std::memory_order_acquire);
+        std::size_t record_count = drain_buffers();
         {
-            std::unique_lock<std::mutex> lock(m_file_log_queue_mutex);
-            m_file_log_queue_cond.wait(
-                lock,
-                [this]
-                {
-                    return !m_file_log_queue.empty() || !m_async_file_log_flag.load();
-                });
-
-            if (m_file_log_queue.empty())
-            {
-                if (!m_async_file_log_flag.load())
-                {
-                    m_file_log_queue_cond.notify_all();
-                    return;
-                }
-                continue;
-            }
-
-            log_str = m_file_log_queue.front();
-            m_file_log_queue.pop();
-            m_file_log_queue_cond.notify_all();
+            std::lock_guard<std::mutex> lock(m_output_mutex);
+            flush_log_file(false);
+        }
+        if (record_count > 0)
+        {
+            continue;
         }
+        // 停止请求之后完整取空一轮才退出
+        if (!is_running)
+        {
+            break;
+        }
+        std::unique_lock<std::mutex> lock(m_wakeup_mutex);
+        m_wakeup_cond.wait_for(lock, IDLE_WAIT_TIME, [this]()
+            {
+                return m_is_wakeup_requested.load(std::memory_order_relaxed) || !m_is_running.load(std::memory_order_relaxed);
+            });
+        m_is_wakeup_requested.store(false, std::memory_order_relaxed);
+    }
+    std::lock_guard<std::mutex> lock(m_output_mutex);
+    flush_log_file(true);
+}
 
-        std::atomic_thread_fence(std::memory_order_seq_cst);
+void DaneJoe::AsyncLogger::refresh_drain_buffers()
+{
+    bool has_released_buffer = std::any_of(m_drain_buffers.begin(), m_drain_buffers.end(), [](const auto& buffer)
         {
-            std::lock_guard<std::mutex> lock(m_file_mutex);
-            if (open_log_file())
+            // 先确认废弃再检查为空，保证线程退出前提交的记录已被取走
+            return buffer->is_abandoned() && buffer->is_empty();
+        });
+    if (!has_released_buffer && m_buffer_version.load(std::memory_order_acquire) == m_drain_version)
+    {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(m_buffer_mutex);
+    if (has_released_buffer)
+    {
+        std::erase_if(m_buffers, [](const auto& buffer)
             {
-                m_log_file << log_str << std::endl;
-                std::flush(m_log_file);
-            }
-        }
+                return buffer->is_abandoned() && buffer->is_empty();
+            });
+        m_buffer_version.fetch_add(1, std::memory_order_release);
     }
+    m_drain_buffers = m_buffers;
+    m_drain_version = m_buffer_version.load(std::memory_order_acquire);
 }
 
-void DaneJoe::AsyncLogger::async_console_log_handler()
+std::size_t DaneJoe::AsyncLogger::drain_buffers()
 {
-    while (true)
+    refresh_drain_buffers();
+    std::size_t record_count = 0;
+    int process_id = get_pid();
+    char thread_id[16];
+    for (auto& buffer : m_drain_buffers)
     {
-        std::string log_str;
+        for (std::size_t i = 0; i < MAX_DRAIN_RECORD_COUNT; i++)
         {
-            std::unique_lock<std::mutex> lock(m_console_log_queue_mutex);
-            m_console_log_queue_cond.wait(lock, [this]()
-                {
-                    return !m_console_log_queue.empty() || !m_async_console_log_flag.load();
-                });
-
-            if (m_console_log_queue.empty())
+            auto record = buffer->front();
+            if (record.empty())
             {
-                if (!m_async_console_log_flag.load())
-                {
-                    m_console_log_queue_cond.notify_all();
-                    return;
-                }
-                continue;
+                break;
             }
-
-            log_str = m_console_log_queue.front();
-            m_console_log_queue.pop();
-            m_console_log_queue_cond.notify_all();
+            LogRecordView view = LogRecordView::parse(record);
+            PendingLine line;
+            line.timestamp = view.header.timestamp;
+            line.level = view.header.level;
+            line.offset = m_line_arena.size();
+            auto thread_id_result = std::to_chars(thread_id, thread_id + sizeof(thread_id), view.header.thread_id);
+            append_header(m_line_arena,
+                view.header.level,
+                std::chrono::system_clock::time_point(
+                    std::chrono::duration_cast<std::chrono::system_clock::duration>(
+                        std::chrono::nanoseconds(view.header.timestamp))),
+                view.module,
+                view.file_name,
+                view.function_name,
+                view.header.line_num,
+                process_id,
+                std::string_view(thread_id, static_cast<std::size_t>(thread_id_result.ptr - thread_id)));
+            m_line_arena += "[:] [";
+            if (!view.format_message(m_line_arena))
+            {
+                m_line_arena.append(view.header.format, view.header.format_size);
+            }
+            m_line_arena += "] ";
+            line.size = m_line_arena.size() - line.offset;
+            m_pending_lines.push_back(line);
+            buffer->pop_front();
+            record_count++;
         }
+    }
+    if (record_count > 0)
+    {
+        write_pending_lines();
+    }
+    return record_count;
+}
 
-        std::atomic_thread_fence(std::memory_order_seq_cst);
+void DaneJoe::AsyncLogger::write_pending_lines()
+{
+    // 各线程缓冲区内部有序，合并后按时间戳稳定排序
+    if (m_drain_buffers.size() > 1)
+    {
+        std::stable_sort(m_pending_lines.begin(), m_pending_lines.end(), [](const PendingLine& lhs, const PendingLine& rhs)
+            {
+                return lhs.timestamp < rhs.timestamp;
+            });
+    }
+    bool is_flush_required = false;
+    m_console_batch.clear();
+    m_file_batch.clear();
+    for (const auto& line : m_pending_lines)
+    {
+        std::string_view text(m_line_arena.data() + line.offset, line.size);
+        if (m_config.enable_console && m_config.console_level <= line.level)
         {
-            std::lock_guard<std::mutex> lock(m_console_mutex);
-            std::cout << log_str << std::endl;
-            std::flush(std::cout);
+            m_console_batch += text;
+            m_console_batch += '\n';
         }
+        if (m_config.enable_file && m_config.file_level <= line.level)
+        {
+            m_file_batch += text;
+            m_file_batch += '\n';
+            is_flush_required = is_flush_required || line.level >= m_config.flush_level;
+        }
+    }
+    m_line_arena.clear();
+    m_pending_lines.clear();
+
+    std::lock_guard<std::mutex> lock(m_output_mutex);
+    if (!m_console_batch.empty())
+    {
+        std::cout.write(m_console_batch.data(), static_cast<std::streamsize>(m_console_batch.size()));
+        std::cout.flush();
+    }
+    if (!m_file_batch.empty() && open_log_file())
+    {
+        m_log_file.write(m_file_batch.data(), static_cast<std::streamsize>(m_file_batch.size()));
+        m_is_file_dirty = true;
+        flush_log_file(is_flush_required);
     }
 }
 
-void DaneJoe::AsyncLogger::start_async_log()
+void DaneJoe::AsyncLogger::flush_log_file(bool is_forced)
 {
-    if (!m_async_file_log_flag.load())
+    if (!m_is_file_dirty)
     {
-        m_async_file_log_flag.store(true);
-        m_async_file_log_thread = std::thread(&AsyncLogger::async_file_log_handler, this);
+        return;
     }
-    if (!m_async_console_log_flag.load())
+    auto now = std::chrono::steady_clock::now();
+    if (!is_forced && now - m_last_flush_time < std::chrono::milliseconds(m_config.flush_interval_ms))
     {
-        m_async_console_log_flag.store(true);
-        m_async_console_log_thread = std::thread(&AsyncLogger::async_console_log_handler, this);
+        return;
     }
+    m_log_file.flush();
+    m_is_file_dirty = false;
+    m_last_flush_time = now;
+}
 
+std::shared_ptr<DaneJoe::ILogger> DaneJoe::DaneJoeLoggerCreator::operator()(const LoggerConfig& config)
+{
+    return std::make_shared<AsyncLogger>(config);
 }
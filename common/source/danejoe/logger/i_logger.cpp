@@ -1,13 +1,43 @@
-#include <sstream>
+#include <ctime>
 #include <chrono>
+#include <sstream>
+#include <charconv>
+#include <algorithm>
 
 #include "danejoe/logger/i_logger.hpp"
 #include "danejoe/common/core/variable_util.hpp"
 #include "danejoe/common/system/system_info.hpp"
 
+namespace
+{
+    /// @brief 本线程最近格式化的秒
+    thread_local std::time_t t_cached_second = -1;
+    /// @brief 本线程最近格式化的时间字符串
+    thread_local char t_cached_time[32] = {};
+    /// @brief 时间字符串长度
+    thread_local std::size_t t_cached_time_size = 0;
+
+    void append_bracket(std::string& output, std::string_view value)
+    {
+        output += '[';
+        output += value;
+        output += "] ";
+    }
+
+    void append_bracket(std::string& output, int value)
+    {
+        char buffer[16];
+        auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+        append_bracket(output, std::string_view(buffer, static_cast<std::size_t>(result.ptr - buffer)));
+    }
+}
+
 DaneJoe::ILogger::ILogger() {}
 
-DaneJoe::ILogger::ILogger(LoggerConfig config) : m_config(config) {}
+DaneJoe::ILogger::ILogger(LoggerConfig config) : m_config(config)
+{
+    update_min_level();
+}
 
 std::string DaneJoe::ILogger::to_string(LogLevel level)
 {
@@ -58,6 +88,32 @@ DaneJoe::LogLevel DaneJoe::ILogger::to_log_level(std::string level_str)
 void DaneJoe::ILogger::set_config(const LoggerConfig& config)
 {
     m_config = config;
+    update_min_level();
+}
+
+void DaneJoe::ILogger::update_min_level()
+{
+    LogLevel min_level = LogLevel::NONE;
+    if (m_config.enable_console)
+    {
+        min_level = std::min(min_level, m_config.console_level);
+    }
+    if (m_config.enable_file)
+    {
+        min_level = std::min(min_level, m_config.file_level);
+    }
+    m_min_level.store(min_level, std::memory_order_relaxed);
+}
+
+DaneJoe::LogRecordBuffer* DaneJoe::ILogger::get_record_buffer()
+{
+    return nullptr;
+}
+
+bool DaneJoe::ILogger::wait_record_buffer(LogRecordBuffer& buffer)
+{
+    DANEJOE_UNUSED(buffer)
+    return false;
 }
 
 void DaneJoe::ILogger::set_output_settings(const LogOutputSetting& settings)
@@ -80,41 +136,58 @@ std::string DaneJoe::ILogger::get_header(LogLevel level,
     const std::string& thread_id)
 {
     DANEJOE_UNUSED(log_info)
-    std::time_t raw_time_t = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
-    std::tm time_info;
-    std::tm* time_info_ptr = nullptr;
+    std::string header;
+    append_header(header,
+        level,
+        std::chrono::system_clock::now(),
+        module,
+        file_name,
+        function_name,
+        line_num,
+        process_id,
+        thread_id);
+    return header;
+}
+
+void DaneJoe::ILogger::append_header(
+    std::string& output,
+    LogLevel level,
+    std::chrono::system_clock::time_point time,
+    std::string_view module,
+    std::string_view file_name,
+    std::string_view function_name,
+    int line_num,
+    int process_id,
+    std::string_view thread_id)
+{
+    if (m_output_setting.enable_time)
+    {
+        std::time_t raw_time_t = std::chrono::system_clock::to_time_t(time);
+        if (raw_time_t != t_cached_second)
+        {
+            std::tm time_info;
 #if defined(_WIN32)
-    localtime_s(&time_info, &raw_time_t); // Windows
-    time_info_ptr = &time_info;
-#elif defined(__linux__)
-    localtime_r(&raw_time_t, &time_info); // Linux
-    time_info_ptr = &time_info;
-#elif defined(__APPLE__)
-    localtime_r(&raw_time_t, &time_info); // macOS
-    time_info_ptr = &time_info;
+            localtime_s(&time_info, &raw_time_t); // Windows
 #else
-    time_info_ptr = std::localtime(&raw_time_t);
+            localtime_r(&raw_time_t, &time_info); // Linux/macOS
 #endif
-    std::ostringstream oss;
-    oss << std::put_time(time_info_ptr, "%Y-%m-%d %H:%M:%S");
-    std::string time_str = oss.str();
-    std::string header;
-    if (m_output_setting.enable_time)
-        header += std::format("[{}] ", time_str);
+            t_cached_time_size = std::strftime(t_cached_time, sizeof(t_cached_time), "%Y-%m-%d %H:%M:%S", &time_info);
+            t_cached_second = raw_time_t;
+        }
+        append_bracket(output, std::string_view(t_cached_time, t_cached_time_size));
+    }
     if (m_output_setting.enable_level)
-        header += std::format("[{}] ", to_log_level_sign(level));
+        append_bracket(output, to_log_level_sign(level));
     if (m_output_setting.enable_module)
-        header += std::format("[{}] ", module);
-    if (m_output_setting.enable_file_name && file_name != "")
-        header += std::format("[{}] ", file_name);
-    if (m_output_setting.enable_function_name && function_name != "")
-        header += std::format("[{}] ", function_name);
+        append_bracket(output, module);
+    if (m_output_setting.enable_file_name && !file_name.empty())
+        append_bracket(output, file_name);
+    if (m_output_setting.enable_function_name && !function_name.empty())
+        append_bracket(output, function_name);
     if (m_output_setting.enable_line_num && line_num != -1)
-        header += std::format("[{}] ", line_num);
+        append_bracket(output, line_num);
     if (m_output_setting.enable_proceed_id && process_id != -1)
-        header += std::format("[{}] ", process_id);
-    if (m_output_setting.enable_thread_id && thread_id != "")
-        header += std::format("[{}] ", thread_id);
-
-    return header;
-}
+        append_bracket(output, process_id);
+    if (m_output_setting.enable_thread_id && !thread_id.empty())
+        append_bracket(output, thread_id);
+}
\ No newline at end of file
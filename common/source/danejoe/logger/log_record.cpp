@@ -0,0 +1,148 @@
+#include <bit>
+#include <exception>
+
+#include "danejoe/logger/log_record.hpp"
+
+namespace
+{
+    /// @brief 记录长度前缀大小
+    constexpr std::size_t LENGTH_PREFIX_SIZE = sizeof(uint64_t);
+    /// @brief 最小容量
+    constexpr std::size_t MIN_CAPACITY = 4096;
+
+    constexpr uint64_t align_to_word(uint64_t size)
+    {
+        return (size + 7) & ~static_cast<uint64_t>(7);
+    }
+}
+
+bool DaneJoe::LogRecordView::format_message(std::string& output)const
+{
+    if (!header.decoder)
+    {
+        return false;
+    }
+    std::size_t original_size = output.size();
+    try
+    {
+        header.decoder(args, std::string_view(header.format, header.format_size), output);
+    }
+    catch (const std::exception&)
+    {
+        // 预先格式化的参数与数值说明符（如 {:x}）不匹配时会抛出 format_error，丢弃已写入的部分
+        output.resize(original_size);
+        return false;
+    }
+    return true;
+}
+
+DaneJoe::LogRecordView DaneJoe::LogRecordView::parse(std::span<const uint8_t> record)
+{
+    LogRecordView view;
+    std::memcpy(&view.header, record.data(), sizeof(LogRecordHeader));
+    const char* cursor = reinterpret_cast<const char*>(record.data() + sizeof(LogRecordHeader));
+    view.module = std::string_view(cursor, view.header.module_size);
+    cursor += view.header.module_size;
+    view.file_name = std::string_view(cursor, view.header.file_name_size);
+    cursor += view.header.file_name_size;
+    view.function_name = std::string_view(cursor, view.header.function_name_size);
+    cursor += view.header.function_name_size;
+    view.args = reinterpret_cast<const uint8_t*>(cursor);
+    return view;
+}
+
+DaneJoe::LogRecordBuffer::LogRecordBuffer(std::size_t capacity)
+{
+    m_capacity = std::bit_ceil(std::max(capacity, MIN_CAPACITY));
+    m_data = std::make_unique<uint64_t[]>(m_capacity / sizeof(uint64_t));
+}
+
+bool DaneJoe::LogRecordBuffer::can_fit(std::size_t size)const
+{
+    // 单条记录不超过容量的一半，保证回绕后总能放下
+    return size > 0 && LENGTH_PREFIX_SIZE + align_to_word(size) <= m_capacity / 2;
+}
+
+uint8_t* DaneJoe::LogRecordBuffer::try_reserve(std::size_t size)
+{
+    if (!can_fit(size))
+    {
+        return nullptr;
+    }
+    uint64_t record_size = LENGTH_PREFIX_SIZE + align_to_word(size);
+    uint64_t write_position = m_write_position.load(std::memory_order_relaxed);
+    uint64_t offset = write_position & (m_capacity - 1);
+    uint64_t tail_size = m_capacity - offset;
+    uint64_t required_size = tail_size < record_size ? tail_size + record_size : record_size;
+    if (write_position + required_size - m_cached_read_position > m_capacity)
+    {
+        m_cached_read_position = m_read_position.load(std::memory_order_acquire);
+        if (write_position + required_size - m_cached_read_position > m_capacity)
+        {
+            return nullptr;
+        }
+    }
+    uint8_t* bytes = reinterpret_cast<uint8_t*>(m_data.get());
+    if (tail_size < record_size)
+    {
+        std::memcpy(bytes + offset, &WRAP_MARKER, sizeof(WRAP_MARKER));
+        write_position += tail_size;
+        offset = 0;
+    }
+    uint64_t payload_size = size;
+    std::memcpy(bytes + offset, &payload_size, sizeof(payload_size));
+    m_reserved_position = write_position;
+    m_reserved_size = record_size;
+    return bytes + offset + LENGTH_PREFIX_SIZE;
+}
+
+void DaneJoe::LogRecordBuffer::commit()
+{
+    m_write_position.store(m_reserved_position + m_reserved_size, std::memory_order_release);
+}
+
+std::span<const uint8_t> DaneJoe::LogRecordBuffer::front()
+{
+    uint64_t read_position = m_read_position.load(std::memory_order_relaxed);
+    uint64_t write_position = m_write_position.load(std::memory_order_acquire);
+    if (read_position == write_position)
+    {
+        return {};
+    }
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(m_data.get());
+    uint64_t offset = read_position & (m_capacity - 1);
+    uint64_t payload_size = 0;
+    std::memcpy(&payload_size, bytes + offset, sizeof(payload_size));
+    if (payload_size == WRAP_MARKER)
+    {
+        // 回绕标记总是与其后的记录一同发布
+        read_position += m_capacity - offset;
+        m_read_position.store(read_position, std::memory_order_release);
+        offset = 0;
+        std::memcpy(&payload_size, bytes, sizeof(payload_size));
+    }
+    m_front_size = LENGTH_PREFIX_SIZE + align_to_word(payload_size);
+    return std::span<const uint8_t>(bytes + offset + LENGTH_PREFIX_SIZE, payload_size);
+}
+
+void DaneJoe::LogRecordBuffer::pop_front()
+{
+    uint64_t read_position = m_read_position.load(std::memory_order_relaxed);
+    m_read_position.store(read_position + m_front_size, std::memory_order_release);
+    m_front_size = 0;
+}
+
+bool DaneJoe::LogRecordBuffer::is_empty()const
+{
+    return m_read_position.load(std::memory_order_acquire) == m_write_position.load(std::memory_order_acquire);
+}
+
+void DaneJoe::LogRecordBuffer::abandon()
+{
+    m_is_abandoned.store(true, std::memory_order_release);
+}
+
+bool DaneJoe::LogRecordBuffer::is_abandoned()const
+{
+    return m_is_abandoned.load(std::memory_order_acquire);
+}
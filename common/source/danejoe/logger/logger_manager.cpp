@@ -6,6 +6,7 @@ DaneJoe::LoggerManager::LoggerManager()
 {
     add_creator("default", std::make_shared<DaneJoe::DaneJoeLoggerCreator>());
     add_logger("default", m_default_log_config);
+    m_default_logger = m_logger_map[m_default_log_config.log_name].get();
 }
 
 DaneJoe::LoggerManager& DaneJoe::LoggerManager::get_instance()
@@ -45,6 +46,21 @@ std::shared_ptr<DaneJoe::ILogger> DaneJoe::LoggerManager::get_logger(const std::
     }
 }
 
+DaneJoe::ILogger* DaneJoe::LoggerManager::find_logger(std::string_view log_name)
+{
+    if (log_name == m_default_log_config.log_name)
+    {
+        return m_default_logger;
+    }
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_logger_map.find(std::string(log_name));
+    if (it == m_logger_map.end())
+    {
+        return m_default_logger;
+    }
+    return it->second.get();
+}
+
 void DaneJoe::LoggerManager::add_creator(const std::string& logger_type, std::shared_ptr<DaneJoe::ILoggerCreator> creator)
 {
     {
@@ -0,0 +1,116 @@
+#include <bit>
+#include <cmath>
+#include <algorithm>
+
+#include "danejoe/metrics/latency_histogram.hpp"
+
+DaneJoe::LatencyHistogram::LatencyHistogram() :
+    m_buckets(BUCKET_COUNT, 0)
+{
+}
+
+void DaneJoe::LatencyHistogram::record(uint64_t value)
+{
+    value = std::min(value, MAX_VALUE);
+    m_buckets[get_bucket_index(value)]++;
+    m_count++;
+    m_sum += value;
+    m_min = std::min(m_min, value);
+    m_max = std::max(m_max, value);
+}
+
+void DaneJoe::LatencyHistogram::record(uint64_t value, uint64_t count)
+{
+    if (count == 0)
+    {
+        return;
+    }
+    value = std::min(value, MAX_VALUE);
+    m_buckets[get_bucket_index(value)] += count;
+    m_count += count;
+    m_sum += value * count;
+    m_min = std::min(m_min, value);
+    m_max = std::max(m_max, value);
+}
+
+void DaneJoe::LatencyHistogram::merge(const LatencyHistogram& other)
+{
+    for (std::size_t i = 0; i < BUCKET_COUNT; i++)
+    {
+        m_buckets[i] += other.m_buckets[i];
+    }
+    m_count += other.m_count;
+    m_sum += other.m_sum;
+    m_min = std::min(m_min, other.m_min);
+    m_max = std::max(m_max, other.m_max);
+}
+
+void DaneJoe::LatencyHistogram::reset()
+{
+    std::fill(m_buckets.begin(), m_buckets.end(), 0);
+    m_count = 0;
+    m_sum = 0;
+    m_min = UINT64_MAX;
+    m_max = 0;
+}
+
+uint64_t DaneJoe::LatencyHistogram::get_count()const
+{
+    return m_count;
+}
+
+uint64_t DaneJoe::LatencyHistogram::get_min()const
+{
+    return m_count == 0 ? 0 : m_min;
+}
+
+uint64_t DaneJoe::LatencyHistogram::get_max()const
+{
+    return m_max;
+}
+
+double DaneJoe::LatencyHistogram::get_mean()const
+{
+    return m_count == 0 ? 0.0 : static_cast<double>(m_sum) / static_cast<double>(m_count);
+}
+
+uint64_t DaneJoe::LatencyHistogram::get_percentile(double percentile)const
+{
+    if (m_count == 0)
+    {
+        return 0;
+    }
+    percentile = std::clamp(percentile, 0.0, 100.0);
+    uint64_t target = static_cast<uint64_t>(std::ceil(percentile / 100.0 * static_cast<double>(m_count)));
+    target = std::max<uint64_t>(target, 1);
+    uint64_t cumulative = 0;
+    for (std::size_t i = 0; i < BUCKET_COUNT; i++)
+    {
+        cumulative += m_buckets[i];
+        if (cumulative >= target)
+        {
+            return std::min(get_bucket_upper_value(i), m_max);
+        }
+    }
+    return m_max;
+}
+
+std::size_t DaneJoe::LatencyHistogram::get_bucket_index(uint64_t value)
+{
+    value = std::min(value, MAX_VALUE);
+    // 最高位以下保留 SUB_BUCKET_BITS 位精度：[0, 2 * SUB_BUCKET_COUNT) 逐值成桶，之后每段宽度翻倍
+    int bit_width = static_cast<int>(std::bit_width(value));
+    int shift = std::max(0, bit_width - SUB_BUCKET_BITS - 1);
+    return static_cast<std::size_t>(shift) * SUB_BUCKET_COUNT + static_cast<std::size_t>(value >> shift);
+}
+
+uint64_t DaneJoe::LatencyHistogram::get_bucket_upper_value(std::size_t index)
+{
+    if (index < 2 * SUB_BUCKET_COUNT)
+    {
+        return index;
+    }
+    uint64_t shift = index / SUB_BUCKET_COUNT - 1;
+    uint64_t sub_bucket = index - shift * SUB_BUCKET_COUNT;
+    return ((sub_bucket + 1) << shift) - 1;
+}
@@ -0,0 +1,262 @@
+#include <format>
+#include <iterator>
+#include <algorithm>
+
+#include "danejoe/metrics/metrics_registry.hpp"
+
+namespace
+{
+    /// @brief 下一个分配的分片下标
+    std::atomic<std::size_t> g_next_shard_index = 0;
+
+    /**
+     * @brief 拆分指标名称
+     * @param name 指标名称，可带 `{...}` 标签
+     * @return 基础名称与标签内容（不含花括号）
+     */
+    std::pair<std::string_view, std::string_view> split_name(std::string_view name)
+    {
+        auto brace = name.find('{');
+        if (brace == std::string_view::npos || name.back() != '}')
+        {
+            return { name, {} };
+        }
+        return { name.substr(0, brace), name.substr(brace + 1, name.size() - brace - 2) };
+    }
+
+    /**
+     * @brief 输出一行指标
+     * @param output 输出文本
+     * @param name 指标名称
+     * @param suffix 追加在基础名称后的后缀
+     * @param extra_label 追加的标签（可为空）
+     * @param value 数值
+     */
+    template<typename T>
+    void append_line(std::string& output, std::string_view name, std::string_view suffix, std::string_view extra_label, T value)
+    {
+        auto [base_name, labels] = split_name(name);
+        auto out = std::back_inserter(output);
+        if (labels.empty() && extra_label.empty())
+        {
+            std::format_to(out, "{}{} {}\n", base_name, suffix, value);
+        }
+        else if (labels.empty() || extra_label.empty())
+        {
+            std::format_to(out, "{}{}{{{}{}}} {}\n", base_name, suffix, labels, extra_label, value);
+        }
+        else
+        {
+            std::format_to(out, "{}{}{{{},{}}} {}\n", base_name, suffix, labels, extra_label, value);
+        }
+    }
+
+    /**
+     * @brief 在指标族的第一个指标前输出类型注释
+     * @param output 输出文本
+     * @param name 指标名称
+     * @param type 指标类型
+     * @param last_base_name 上一个输出的基础名称
+     */
+    void append_type(std::string& output, std::string_view name, std::string_view type, std::string_view& last_base_name)
+    {
+        auto base_name = split_name(name).first;
+        if (base_name == last_base_name)
+        {
+            return;
+        }
+        last_base_name = base_name;
+        std::format_to(std::back_inserter(output), "# TYPE {} {}\n", base_name, type);
+    }
+
+    template<typename T, typename Map>
+    T& get_or_create(std::mutex& mutex, Map& map, std::string_view name)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = map.find(name);
+        if (it == map.end())
+        {
+            it = map.emplace(std::string(name), std::make_unique<T>()).first;
+        }
+        return *it->second;
+    }
+}
+
+std::size_t DaneJoe::assign_metrics_shard_index()
+{
+    return g_next_shard_index.fetch_add(1, std::memory_order_relaxed) % METRICS_SHARD_COUNT;
+}
+
+uint64_t DaneJoe::MetricsCounter::get_value()const
+{
+    uint64_t value = 0;
+    for (const auto& shard : m_shards)
+    {
+        value += shard.value.load(std::memory_order_relaxed);
+    }
+    return value;
+}
+
+double DaneJoe::HistogramSnapshot::get_mean()const
+{
+    if (count == 0)
+    {
+        return 0.0;
+    }
+    return static_cast<double>(sum) / static_cast<double>(count);
+}
+
+DaneJoe::MetricsHistogram::MetricsHistogram()
+{
+    for (auto& shard : m_shards)
+    {
+        shard.buckets = std::make_unique<std::atomic<uint64_t>[]>(LatencyHistogram::BUCKET_COUNT);
+    }
+}
+
+void DaneJoe::MetricsHistogram::record(uint64_t value)
+{
+    value = std::min(value, LatencyHistogram::MAX_VALUE);
+    Shard& shard = m_shards[get_metrics_shard_index() % SHARD_COUNT];
+    shard.buckets[LatencyHistogram::get_bucket_index(value)].fetch_add(1, std::memory_order_relaxed);
+    shard.sum.fetch_add(value, std::memory_order_relaxed);
+    uint64_t max = shard.max.load(std::memory_order_relaxed);
+    while (value > max && !shard.max.compare_exchange_weak(max, value, std::memory_order_relaxed))
+    {
+    }
+}
+
+DaneJoe::LatencyHistogram DaneJoe::MetricsHistogram::merge()const
+{
+    LatencyHistogram histogram;
+    for (const auto& shard : m_shards)
+    {
+        for (std::size_t i = 0; i < LatencyHistogram::BUCKET_COUNT; i++)
+        {
+            uint64_t count = shard.buckets[i].load(std::memory_order_relaxed);
+            if (count > 0)
+            {
+                histogram.record(LatencyHistogram::get_bucket_upper_value(i), count);
+            }
+        }
+    }
+    return histogram;
+}
+
+DaneJoe::HistogramSnapshot DaneJoe::MetricsHistogram::get_snapshot()const
+{
+    LatencyHistogram histogram = merge();
+    HistogramSnapshot snapshot;
+    snapshot.count = histogram.get_count();
+    // 合并后的直方图以桶上界计数，和与最大值取分片中记录的精确值
+    for (const auto& shard : m_shards)
+    {
+        snapshot.sum += shard.sum.load(std::memory_order_relaxed);
+        snapshot.max = std::max(snapshot.max, shard.max.load(std::memory_order_relaxed));
+    }
+    snapshot.p50 = std::min(histogram.get_percentile(50.0), snapshot.max);
+    snapshot.p90 = std::min(histogram.get_percentile(90.0), snapshot.max);
+    snapshot.p99 = std::min(histogram.get_percentile(99.0), snapshot.max);
+    snapshot.p999 = std::min(histogram.get_percentile(99.9), snapshot.max);
+    return snapshot;
+}
+
+uint64_t DaneJoe::MetricsSnapshot::get_counter(std::string_view name)const
+{
+    auto it = std::find_if(counters.begin(), counters.end(), [name](const auto& entry)
+        {
+            return entry.first == name;
+        });
+    return it == counters.end() ? 0 : it->second;
+}
+
+int64_t DaneJoe::MetricsSnapshot::get_gauge(std::string_view name)const
+{
+    auto it = std::find_if(gauges.begin(), gauges.end(), [name](const auto& entry)
+        {
+            return entry.first == name;
+        });
+    return it == gauges.end() ? 0 : it->second;
+}
+
+DaneJoe::HistogramSnapshot DaneJoe::MetricsSnapshot::get_histogram(std::string_view name)const
+{
+    auto it = std::find_if(histograms.begin(), histograms.end(), [name](const auto& entry)
+        {
+            return entry.first == name;
+        });
+    return it == histograms.end() ? HistogramSnapshot() : it->second;
+}
+
+std::string DaneJoe::MetricsSnapshot::to_text()const
+{
+    std::string output;
+    std::string_view last_base_name;
+    for (const auto& [name, value] : counters)
+    {
+        append_type(output, name, "counter", last_base_name);
+        append_line(output, name, "", "", value);
+    }
+    last_base_name = {};
+    for (const auto& [name, value] : gauges)
+    {
+        append_type(output, name, "gauge", last_base_name);
+        append_line(output, name, "", "", value);
+    }
+    last_base_name = {};
+    for (const auto& [name, histogram] : histograms)
+    {
+        append_type(output, name, "summary", last_base_name);
+        append_line(output, name, "", "quantile=\"0.5\"", histogram.p50);
+        append_line(output, name, "", "quantile=\"0.9\"", histogram.p90);
+        append_line(output, name, "", "quantile=\"0.99\"", histogram.p99);
+        append_line(output, name, "", "quantile=\"0.999\"", histogram.p999);
+        append_line(output, name, "_max", "", histogram.max);
+        append_line(output, name, "_sum", "", histogram.sum);
+        append_line(output, name, "_count", "", histogram.count);
+    }
+    return output;
+}
+
+DaneJoe::MetricsRegistry& DaneJoe::MetricsRegistry::get_instance()
+{
+    static MetricsRegistry instance;
+    return instance;
+}
+
+DaneJoe::MetricsCounter& DaneJoe::MetricsRegistry::get_counter(std::string_view name)
+{
+    return get_or_create<MetricsCounter>(m_mutex, m_counters, name);
+}
+
+DaneJoe::MetricsGauge& DaneJoe::MetricsRegistry::get_gauge(std::string_view name)
+{
+    return get_or_create<MetricsGauge>(m_mutex, m_gauges, name);
+}
+
+DaneJoe::MetricsHistogram& DaneJoe::MetricsRegistry::get_histogram(std::string_view name)
+{
+    return get_or_create<MetricsHistogram>(m_mutex, m_histograms, name);
+}
+
+DaneJoe::MetricsSnapshot DaneJoe::MetricsRegistry::get_snapshot()const
+{
+    MetricsSnapshot snapshot;
+    std::lock_guard<std::mutex> lock(m_mutex);
+    snapshot.counters.reserve(m_counters.size());
+    for (const auto& [name, counter] : m_counters)
+    {
+        snapshot.counters.emplace_back(name, counter->get_value());
+    }
+    snapshot.gauges.reserve(m_gauges.size());
+    for (const auto& [name, gauge] : m_gauges)
+    {
+        snapshot.gauges.emplace_back(name, gauge->get_value());
+    }
+    snapshot.histograms.reserve(m_histograms.size());
+    for (const auto& [name, histogram] : m_histograms)
+    {
+        snapshot.histograms.emplace_back(name, histogram->get_snapshot());
+    }
+    return snapshot;
+}
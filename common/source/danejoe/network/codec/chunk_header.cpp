@@ -0,0 +1,88 @@
+#include <format>
+
+#include "danejoe/network/codec/chunk_header.hpp"
+#include "danejoe/common/binary/byte_order.hpp"
+#include "danejoe/common/enum/enum_flag.hpp"
+#include "danejoe/common/enum/enum_convert.hpp"
+
+std::string DaneJoe::to_string(DaneJoe::ChunkFlag flag)
+{
+    if (has_flag(flag, ChunkFlag::Last))
+    {
+        return ENUM_TO_STRING(ChunkFlag::Last);
+    }
+    return ENUM_TO_STRING(ChunkFlag::None);
+}
+
+uint32_t DaneJoe::ChunkHeader::min_serialized_byte_array_size()
+{
+    uint32_t size
+        = sizeof(magic_number)// 获取魔数所占字节
+        + sizeof(stream_id)// 获取流标识所占字节
+        + sizeof(flag)// 获取标志所占字节
+        + sizeof(payload_length);// 获取负载长度所占字节
+    return size;
+}
+
+bool DaneJoe::ChunkHeader::is_chunk(const uint8_t* data, std::size_t size)
+{
+    if (size < sizeof(magic_number))
+    {
+        return false;
+    }
+    uint32_t magic_number = 0;
+    to_local_byte_order(reinterpret_cast<uint8_t*>(&magic_number), reinterpret_cast<const uint32_t*>(data));
+    return magic_number == CHUNK_MAGIC_NUMBER;
+}
+
+std::vector<uint8_t> DaneJoe::ChunkHeader::to_serialized_byte_array()const
+{
+    std::vector<uint8_t> data(min_serialized_byte_array_size());
+    uint32_t current_index = 0;
+    // 写入魔数
+    to_network_byte_order(data.data() + current_index, magic_number);
+    current_index += sizeof(magic_number);
+    // 写入流标识
+    to_network_byte_order(data.data() + current_index, stream_id);
+    current_index += sizeof(stream_id);
+    // 写入标志
+    to_network_byte_order(data.data() + current_index, flag);
+    current_index += sizeof(flag);
+    // 写入负载长度
+    to_network_byte_order(data.data() + current_index, payload_length);
+    current_index += sizeof(payload_length);
+    return data;
+}
+
+std::optional<DaneJoe::ChunkHeader> DaneJoe::ChunkHeader::from_serialized_byte_array(const uint8_t* data, std::size_t size)
+{
+    if (size < min_serialized_byte_array_size() || !is_chunk(data, size))
+    {
+        return std::nullopt;
+    }
+    ChunkHeader header;
+    uint32_t current_index = 0;
+    // 获取魔数
+    to_local_byte_order(reinterpret_cast<uint8_t*>(&(header.magic_number)), reinterpret_cast<const uint32_t*>(data + current_index));
+    current_index += sizeof(magic_number);
+    // 获取流标识
+    to_local_byte_order(reinterpret_cast<uint8_t*>(&(header.stream_id)), reinterpret_cast<const uint32_t*>(data + current_index));
+    current_index += sizeof(stream_id);
+    // 获取标志
+    to_local_byte_order(reinterpret_cast<uint8_t*>(&(header.flag)), reinterpret_cast<const ChunkFlag*>(data + current_index));
+    current_index += sizeof(flag);
+    // 获取负载长度
+    to_local_byte_order(reinterpret_cast<uint8_t*>(&(header.payload_length)), reinterpret_cast<const uint32_t*>(data + current_index));
+    current_index += sizeof(payload_length);
+    return header;
+}
+
+std::string DaneJoe::ChunkHeader::to_string()const
+{
+    return std::format(
+        "magic_number={} | stream_id={} | flag={} | payload_length={}",
+        magic_number,
+        stream_id,
+        DaneJoe::to_string(flag),
+        payload_length);
+}
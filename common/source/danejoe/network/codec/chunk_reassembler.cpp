@@ -0,0 +1,110 @@
+#include <algorithm>
+
+#include "danejoe/common/enum/enum_flag.hpp"
+#include "danejoe/common/diagnostic/diagnostic_system.hpp"
+#include "danejoe/network/codec/chunk_header.hpp"
+#include "danejoe/network/codec/serialize_codec.hpp"
+#include "danejoe/network/codec/serialize_header.hpp"
+#include "danejoe/network/codec/chunk_reassembler.hpp"
+
+DaneJoe::ChunkReassembler::ChunkReassembler(const ChunkReassemblerConfig& config) :
+    m_config(config)
+{}
+
+std::optional<std::vector<uint8_t>> DaneJoe::ChunkReassembler::push_data(const std::vector<uint8_t>& data)
+{
+    std::vector<uint8_t> output;
+    m_buffer.insert(m_buffer.end(), data.begin(), data.end());
+    std::size_t index = 0;
+    const std::size_t chunk_header_size = ChunkHeader::min_serialized_byte_array_size();
+    const std::size_t frame_header_size = SerializeCodec::get_message_header_size();
+    while (index < m_buffer.size())
+    {
+        // 正在透传未分片帧，直接输出剩余部分
+        if (m_plain_rest_size > 0)
+        {
+            std::size_t copy_size = std::min<uint64_t>(m_plain_rest_size, m_buffer.size() - index);
+            output.insert(output.end(), m_buffer.begin() + index, m_buffer.begin() + index + copy_size);
+            index += copy_size;
+            m_plain_rest_size -= copy_size;
+            continue;
+        }
+        std::size_t rest_size = m_buffer.size() - index;
+        const uint8_t* current = m_buffer.data() + index;
+        if (ChunkHeader::is_chunk(current, rest_size))
+        {
+            auto header_opt = ChunkHeader::from_serialized_byte_array(current, rest_size);
+            if (!header_opt.has_value())
+            {
+                // 分片头不完整，等待更多数据
+                break;
+            }
+            // 先校验再等待负载，避免按对端声明的长度无限缓存
+            auto stream_it = m_streams.find(header_opt->stream_id);
+            uint64_t stream_size = stream_it == m_streams.end() ? 0 : stream_it->second.size();
+            if (stream_it == m_streams.end() && m_streams.size() >= m_config.max_stream_count)
+            {
+                ADD_DIAG_WARN("network", "ChunkReassembler: too many streams, limit={}", m_config.max_stream_count);
+                clear();
+                return std::nullopt;
+            }
+            if (stream_size + header_opt->payload_length > m_config.max_frame_size)
+            {
+                ADD_DIAG_WARN("network", "ChunkReassembler: stream {} exceeds frame size limit, size={}, payload_length={}, limit={}",
+                    header_opt->stream_id, stream_size, header_opt->payload_length, m_config.max_frame_size);
+                clear();
+                return std::nullopt;
+            }
+            if (rest_size < chunk_header_size + header_opt->payload_length)
+            {
+                break;
+            }
+            auto& stream = m_streams[header_opt->stream_id];
+            stream.insert(stream.end(),
+                current + chunk_header_size,
+                current + chunk_header_size + header_opt->payload_length);
+            index += chunk_header_size + header_opt->payload_length;
+            if (has_flag(header_opt->flag, ChunkFlag::Last))
+            {
+                output.insert(output.end(), stream.begin(), stream.end());
+                m_streams.erase(header_opt->stream_id);
+            }
+            continue;
+        }
+        // 未分片帧：需要完整帧头才能得知长度
+        if (rest_size < frame_header_size)
+        {
+            break;
+        }
+        auto frame_header_opt = SerializeHeader::from_serialized_byte_array(
+            std::vector<uint8_t>(current, current + frame_header_size));
+        if (!frame_header_opt.has_value())
+        {
+            ADD_DIAG_WARN("network", "ChunkReassembler: invalid frame header, drop buffered data");
+            index = m_buffer.size();
+            break;
+        }
+        m_plain_rest_size = static_cast<uint64_t>(frame_header_size) + frame_header_opt->message_length;
+        if (m_plain_rest_size > m_config.max_frame_size)
+        {
+            ADD_DIAG_WARN("network", "ChunkReassembler: frame exceeds size limit, size={}, limit={}",
+                m_plain_rest_size, m_config.max_frame_size);
+            clear();
+            return std::nullopt;
+        }
+    }
+    m_buffer.erase(m_buffer.begin(), m_buffer.begin() + index);
+    return output;
+}
+
+void DaneJoe::ChunkReassembler::clear()
+{
+    m_buffer.clear();
+    m_plain_rest_size = 0;
+    m_streams.clear();
+}
+
+bool DaneJoe::ChunkReassembler::has_pending_data()const
+{
+    return !m_buffer.empty() || !m_streams.empty();
+}
@@ -3,12 +3,19 @@
 #include "danejoe/network/codec/serialize_header.hpp"
 #include "danejoe/network/codec/frame_assembler.hpp"
 
-void DaneJoe::FrameAssembler::push_data(const std::vector<uint8_t>& data)
+bool DaneJoe::FrameAssembler::push_data(const std::vector<uint8_t>& data)
 {
-    for (const auto& byte : data)
+    // 先还原分片，再按帧协议解析
+    auto frame_data_opt = m_chunk_reassembler.push_data(data);
+    if (!frame_data_opt.has_value())
+    {
+        return false;
+    }
+    for (const auto& byte : frame_data_opt.value())
     {
         m_buffer.push_back(byte);
     }
+    return true;
 }
 
 std::vector<uint8_t> DaneJoe::FrameAssembler::pop_data(uint32_t size)
@@ -72,4 +79,9 @@ void DaneJoe::FrameAssembler::clear_current_frame()
 {
     m_current_frame_index = 0;
     m_is_got_header = false;
-}
\ No newline at end of file
+}
+
+bool DaneJoe::FrameAssembler::has_pending_data()const
+{
+    return !m_buffer.empty() || m_is_got_header || m_chunk_reassembler.has_pending_data();
+}
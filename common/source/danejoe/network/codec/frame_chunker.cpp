@@ -0,0 +1,118 @@
+#include <algorithm>
+
+#include "danejoe/network/codec/chunk_header.hpp"
+#include "danejoe/network/codec/frame_chunker.hpp"
+
+DaneJoe::FrameChunker::FrameChunker(const FrameChunkConfig& config) :
+    m_config(config)
+{}
+
+void DaneJoe::FrameChunker::set_config(const FrameChunkConfig& config)
+{
+    m_config = config;
+}
+
+const DaneJoe::FrameChunkConfig& DaneJoe::FrameChunker::get_config()const
+{
+    return m_config;
+}
+
+void DaneJoe::FrameChunker::push_frame(std::vector<uint8_t> frame)
+{
+    if (frame.empty())
+    {
+        return;
+    }
+    if (!m_config.is_enabled || frame.size() <= m_config.chunk_size)
+    {
+        m_control_frames.push_back(std::move(frame));
+        return;
+    }
+    ChunkStream stream;
+    stream.stream_id = m_next_stream_id++;
+    // 0 保留为无效流标识
+    if (m_next_stream_id == 0)
+    {
+        m_next_stream_id = 1;
+    }
+    stream.frame = std::move(frame);
+    m_bulk_streams.push_back(std::move(stream));
+}
+
+std::optional<std::vector<uint8_t>> DaneJoe::FrameChunker::pop_unit()
+{
+    if (m_control_frames.empty() && m_bulk_streams.empty())
+    {
+        return std::nullopt;
+    }
+    // 当前轮次控制帧额度未用完（或没有大帧）时优先输出控制帧
+    bool is_control_turn = !m_control_frames.empty() &&
+        (m_bulk_streams.empty() || m_control_served < std::max<uint32_t>(m_config.control_weight, 1));
+    if (is_control_turn)
+    {
+        auto frame = std::move(m_control_frames.front());
+        m_control_frames.pop_front();
+        m_control_served++;
+        return frame;
+    }
+    auto chunk = pop_bulk_chunk();
+    m_bulk_served++;
+    if (m_bulk_served >= std::max<uint32_t>(m_config.bulk_weight, 1) || m_control_frames.empty())
+    {
+        // 开始新的一轮
+        m_control_served = 0;
+        m_bulk_served = 0;
+    }
+    return chunk;
+}
+
+std::vector<uint8_t> DaneJoe::FrameChunker::pop_bulk_chunk()
+{
+    auto& stream = m_bulk_streams.front();
+    std::size_t rest_size = stream.frame.size() - stream.offset;
+    std::size_t payload_size = std::min<std::size_t>(rest_size, m_config.chunk_size);
+
+    ChunkHeader header;
+    header.stream_id = stream.stream_id;
+    header.payload_length = static_cast<uint32_t>(payload_size);
+    header.flag = payload_size == rest_size ? ChunkFlag::Last : ChunkFlag::None;
+
+    std::vector<uint8_t> chunk = header.to_serialized_byte_array();
+    chunk.insert(chunk.end(),
+        stream.frame.begin() + stream.offset,
+        stream.frame.begin() + stream.offset + payload_size);
+    stream.offset += payload_size;
+
+    if (stream.offset >= stream.frame.size())
+    {
+        m_bulk_streams.pop_front();
+    }
+    else if (m_bulk_streams.size() > 1)
+    {
+        // 轮转到队尾，使多个大帧交错发送
+        m_bulk_streams.push_back(std::move(stream));
+        m_bulk_streams.pop_front();
+    }
+    return chunk;
+}
+
+std::size_t DaneJoe::FrameChunker::fill_buffer(std::vector<uint8_t>& buffer, std::size_t low_watermark)
+{
+    std::size_t appended_size = 0;
+    while (buffer.size() < low_watermark)
+    {
+        auto unit_opt = pop_unit();
+        if (!unit_opt.has_value())
+        {
+            break;
+        }
+        appended_size += unit_opt->size();
+        buffer.insert(buffer.end(), unit_opt->begin(), unit_opt->end());
+    }
+    return appended_size;
+}
+
+bool DaneJoe::FrameChunker::has_pending()const
+{
+    return !m_control_frames.empty() || !m_bulk_streams.empty();
+}
@@ -54,6 +54,18 @@ uint32_t DaneJoe::SerializeArrayValue::min_serialized_byte_array_size()
     return size;
 }
 
+void DaneJoe::SerializeArrayValue::write_fixed_header(uint8_t* dest, DataType element_type, uint32_t element_size, uint32_t element_count)
+{
+    uint32_t current_index = 0;
+    to_network_byte_order(dest + current_index, element_type);
+    current_index += sizeof(element_type);
+    to_network_byte_order(dest + current_index, element_count);
+    current_index += sizeof(element_count);
+    to_network_byte_order(dest + current_index, SerializeArrayFlag::None);
+    current_index += sizeof(SerializeArrayFlag);
+    to_network_byte_order(dest + current_index, element_size);
+}
+
 uint32_t DaneJoe::SerializeArrayValue::serialized_size()const
 {
     uint32_t size
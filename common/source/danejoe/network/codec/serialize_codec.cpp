@@ -4,6 +4,7 @@
 #include "danejoe/common/core/variable_util.hpp"
 #include "danejoe/stringify/stringify_to_string.hpp"
 #include "danejoe/network/codec/serialize_codec.hpp"
+#include "danejoe/network/codec/varint.hpp"
 
 const uint32_t DaneJoe::SerializeCodec::HEADER_SIZE = 16;
 
@@ -24,10 +25,10 @@ DaneJoe::SerializeCodec::SerializeCodec(const SerializeConfig& config) :m_serial
 void DaneJoe::SerializeCodec::set_config(const SerializeConfig& config)
 {
     m_serialized_config = config;
-    // 更新预分配容量
-    if (m_serialized_byte_array_build.size() < config.pre_allocated_size)
+    // 更新预分配容量（仅预留，不改变已构建内容）
+    if (m_serialized_byte_array_build.capacity() < config.pre_allocated_size)
     {
-        m_serialized_byte_array_build.resize(config.pre_allocated_size);
+        m_serialized_byte_array_build.reserve(config.pre_allocated_size);
     }
 }
 
@@ -37,10 +38,16 @@ void DaneJoe::SerializeCodec::set_config(const SerializeConfig& config)
 void DaneJoe::SerializeCodec::reset_build()
 {
     m_serialized_byte_array_build.clear();
-    m_serialized_data_map_build.clear();
+    m_build_field_count = 0;
     m_current_index = HEADER_SIZE;
 }
 
+void DaneJoe::SerializeCodec::reset_build(std::vector<uint8_t>&& buffer)
+{
+    m_serialized_byte_array_build = std::move(buffer);
+    reset_build();
+}
+
 void DaneJoe::SerializeCodec::reset_parse()
 {
     m_serialized_byte_array_parsed.clear();
@@ -55,6 +62,15 @@ std::vector<uint8_t>  DaneJoe::SerializeCodec::get_serialized_data_vector_build(
     return m_serialized_byte_array_build;
 }
 
+std::vector<uint8_t> DaneJoe::SerializeCodec::take_serialized_data_vector_build()noexcept
+{
+    finalize_message_header();
+    std::vector<uint8_t> result = std::move(m_serialized_byte_array_build);
+    m_serialized_byte_array_build = std::vector<uint8_t>();
+    reset_build();
+    return result;
+}
+
 std::vector<uint8_t> DaneJoe::SerializeCodec::get_serialized_data_vector_parsed()const noexcept
 {
     return m_serialized_byte_array_parsed;
@@ -76,6 +92,11 @@ void DaneJoe::SerializeCodec::deserialize(const std::vector<uint8_t>& data)
         return;
     }
     m_serialized_byte_array_parsed = data;
+    if (header.version == static_cast<uint8_t>(SerializeVersion::Compact))
+    {
+        deserialize_compact(data, header);
+        return;
+    }
     uint32_t current_index = HEADER_SIZE;
     for (uint32_t i = 0; i < header.field_count; ++i)
     {
@@ -130,22 +151,8 @@ void DaneJoe::SerializeCodec::deserialize()
 
 DaneJoe::SerializeCodec& DaneJoe::SerializeCodec::serialize(const SerializeField& field)
 {
-    if (field.name_length > m_serialized_config.max_field_name_length)
-    {
-        ADD_DIAG_WARN("network", "Serialize field skipped: name length {} exceeds maximum limit {}", field.name_length, m_serialized_config.max_field_name_length);
-        return *this;
-    }
-    if (field.value_length > m_serialized_config.max_field_value_length)
-    {
-        ADD_DIAG_WARN("network", "Serialize field skipped: value length {} exceeds maximum limit {}", field.value_length, m_serialized_config.max_field_value_length);
-        return *this;
-    }
-    uint32_t field_size = field.serialized_size();
-    ensure_enough_capacity_rest_to_build(field_size);
-    auto data = field.to_serialized_byte_array();
-    std::memcpy(m_serialized_byte_array_build.data() + m_current_index, data.data(), data.size());
-    m_current_index += field_size;
-    m_serialized_data_map_build.insert(std::make_pair(std::string(field.name.begin(), field.name.end()), field));
+    std::string_view name(reinterpret_cast<const char*>(field.name.data()), field.name.size());
+    write_field(name, field.type, field.flag, field.value.data(), field.value.size());
     return *this;
 }
 
@@ -153,10 +160,11 @@ void DaneJoe::SerializeCodec::finalize_message_header()
 {
     m_serialized_byte_array_build.resize(m_current_index);
     SerializeHeader header;
+    header.version = static_cast<uint8_t>(m_serialized_config.version);
     header.message_length = m_current_index - HEADER_SIZE;
     header.flag = SerializeFlag::None;
     header.checksum = 0;
-    header.field_count = m_serialized_data_map_build.size();
+    header.field_count = m_build_field_count;
 
     uint32_t current_index = 0;
     to_network_byte_order(m_serialized_byte_array_build.data() + current_index, header.magic_number);
@@ -173,6 +181,302 @@ void DaneJoe::SerializeCodec::finalize_message_header()
     current_index += sizeof(uint16_t);
 }
 
+namespace
+{
+    /**
+     * @brief 判断类型是否为无符号整数
+     */
+    bool is_unsigned_integer_type(DaneJoe::DataType type)
+    {
+        return type == DaneJoe::DataType::UInt8 || type == DaneJoe::DataType::UInt16 ||
+            type == DaneJoe::DataType::UInt32 || type == DaneJoe::DataType::UInt64;
+    }
+    /**
+     * @brief 判断类型是否为有符号整数
+     */
+    bool is_signed_integer_type(DaneJoe::DataType type)
+    {
+        return type == DaneJoe::DataType::Int8 || type == DaneJoe::DataType::Int16 ||
+            type == DaneJoe::DataType::Int32 || type == DaneJoe::DataType::Int64;
+    }
+    /**
+     * @brief 判断类型是否按定长值编码（整数、布尔、浮点）
+     */
+    bool is_fixed_width_type(DaneJoe::DataType type)
+    {
+        return is_unsigned_integer_type(type) || is_signed_integer_type(type) ||
+            type == DaneJoe::DataType::Bool || type == DaneJoe::DataType::Float || type == DaneJoe::DataType::Double;
+    }
+    /**
+     * @brief 从本地字节序的定长值中读取整数（按位宽零扩展）
+     */
+    uint64_t load_integer_bits(const uint8_t* value, uint32_t width)
+    {
+        uint64_t bits = 0;
+        switch (width)
+        {
+        case 1: { uint8_t v = 0; std::memcpy(&v, value, 1); bits = v; break; }
+        case 2: { uint16_t v = 0; std::memcpy(&v, value, 2); bits = v; break; }
+        case 4: { uint32_t v = 0; std::memcpy(&v, value, 4); bits = v; break; }
+        case 8: { std::memcpy(&bits, value, 8); break; }
+        default: break;
+        }
+        return bits;
+    }
+    /**
+     * @brief 按位宽将整数写回本地字节序的定长值（截断高位）
+     */
+    std::vector<uint8_t> store_integer_bits(uint64_t bits, uint32_t width)
+    {
+        std::vector<uint8_t> value(width);
+        switch (width)
+        {
+        case 1: { uint8_t v = static_cast<uint8_t>(bits); std::memcpy(value.data(), &v, 1); break; }
+        case 2: { uint16_t v = static_cast<uint16_t>(bits); std::memcpy(value.data(), &v, 2); break; }
+        case 4: { uint32_t v = static_cast<uint32_t>(bits); std::memcpy(value.data(), &v, 4); break; }
+        case 8: { std::memcpy(value.data(), &bits, 8); break; }
+        default: break;
+        }
+        return value;
+    }
+    /**
+     * @brief 按位宽对整数做符号扩展
+     */
+    int64_t sign_extend(uint64_t bits, uint32_t width)
+    {
+        switch (width)
+        {
+        case 1: return static_cast<int8_t>(bits);
+        case 2: return static_cast<int16_t>(bits);
+        case 4: return static_cast<int32_t>(bits);
+        default: return static_cast<int64_t>(bits);
+        }
+    }
+}
+
+bool DaneJoe::SerializeCodec::is_field_within_limit(std::size_t name_length, uint64_t value_length)const
+{
+    if (name_length > m_serialized_config.max_field_name_length)
+    {
+        ADD_DIAG_WARN("network", "Serialize field skipped: name length {} exceeds maximum limit {}", name_length, m_serialized_config.max_field_name_length);
+        return false;
+    }
+    if (value_length > m_serialized_config.max_field_value_length)
+    {
+        ADD_DIAG_WARN("network", "Serialize field skipped: value length {} exceeds maximum limit {}", value_length, m_serialized_config.max_field_value_length);
+        return false;
+    }
+    return true;
+}
+
+void DaneJoe::SerializeCodec::write_field_prefix(std::string_view name, DataType type, SerializeFieldFlag flag, uint32_t value_length)
+{
+    uint8_t* dest = m_serialized_byte_array_build.data();
+    if (m_serialized_config.version != SerializeVersion::Compact)
+    {
+        // name_length | name | type | flag | (value_length)
+        uint16_t name_length = static_cast<uint16_t>(name.size());
+        to_network_byte_order(dest + m_current_index, name_length);
+        m_current_index += sizeof(uint16_t);
+        std::memcpy(dest + m_current_index, name.data(), name.size());
+        m_current_index += name.size();
+        to_network_byte_order(dest + m_current_index, type);
+        m_current_index += sizeof(DataType);
+        to_network_byte_order(dest + m_current_index, flag);
+        m_current_index += sizeof(SerializeFieldFlag);
+        if (has_flag(flag, SerializeFieldFlag::HasValueLength))
+        {
+            to_network_byte_order(dest + m_current_index, value_length);
+            m_current_index += sizeof(uint32_t);
+        }
+        return;
+    }
+    uint32_t tag = 0;
+    if (m_serialized_config.field_tag_table)
+    {
+        tag = m_serialized_config.field_tag_table->get_tag(name).value_or(0);
+    }
+    // 写入标签，未登记字段附带字段名
+    m_current_index += write_varint(dest + m_current_index, tag);
+    if (tag == 0)
+    {
+        m_current_index += write_varint(dest + m_current_index, name.size());
+        std::memcpy(dest + m_current_index, name.data(), name.size());
+        m_current_index += name.size();
+    }
+    // 写入类型，变长值附带长度
+    dest[m_current_index++] = static_cast<uint8_t>(type);
+    if (!is_fixed_width_type(type))
+    {
+        m_current_index += write_varint(dest + m_current_index, value_length);
+    }
+}
+
+void DaneJoe::SerializeCodec::write_field(std::string_view name, DataType type, SerializeFieldFlag flag, const uint8_t* value, uint32_t value_length)
+{
+    if (!is_field_within_limit(name.size(), value_length))
+    {
+        return;
+    }
+    uint32_t width = get_data_type_length(type);
+    if (is_fixed_width_type(type) && value_length < width)
+    {
+        ADD_DIAG_WARN("network", "Serialize field skipped: value length {} is less than type width {}", value_length, width);
+        return;
+    }
+    // 按最坏情况预留空间：标签/字段名长度 + 字段名 + 类型 + 标志 + 值长度 + 值
+    ensure_enough_capacity_rest_to_build(MAX_VARINT_SIZE * 3 + name.size() + sizeof(DataType) + sizeof(SerializeFieldFlag) + value_length);
+    write_field_prefix(name, type, flag, value_length);
+    uint8_t* dest = m_serialized_byte_array_build.data() + m_current_index;
+    if (m_serialized_config.version == SerializeVersion::Compact && is_unsigned_integer_type(type))
+    {
+        m_current_index += write_varint(dest, load_integer_bits(value, width));
+    }
+    else if (m_serialized_config.version == SerializeVersion::Compact && is_signed_integer_type(type))
+    {
+        int64_t signed_value = sign_extend(load_integer_bits(value, width), width);
+        m_current_index += write_varint(dest, zigzag_encode(signed_value));
+    }
+    else if (m_serialized_config.version == SerializeVersion::Compact && is_fixed_width_type(type))
+    {
+        // 定长值按网络字节序写入
+        switch (width)
+        {
+        case 4: to_network_byte_order(dest, reinterpret_cast<const uint32_t*>(value)); break;
+        case 8: to_network_byte_order(dest, reinterpret_cast<const uint64_t*>(value)); break;
+        default: std::memcpy(dest, value, width); break;
+        }
+        m_current_index += width;
+    }
+    else
+    {
+        std::memcpy(dest, value, value_length);
+        m_current_index += value_length;
+    }
+    ++m_build_field_count;
+}
+
+uint8_t* DaneJoe::SerializeCodec::reserve_field_value(std::string_view name, DataType type, uint32_t value_length)
+{
+    if (!is_field_within_limit(name.size(), value_length))
+    {
+        return nullptr;
+    }
+    ensure_enough_capacity_rest_to_build(MAX_VARINT_SIZE * 3 + name.size() + sizeof(DataType) + sizeof(SerializeFieldFlag) + value_length);
+    write_field_prefix(name, type, SerializeFieldFlag::HasValueLength, value_length);
+    uint8_t* dest = m_serialized_byte_array_build.data() + m_current_index;
+    m_current_index += value_length;
+    ++m_build_field_count;
+    return dest;
+}
+
+void DaneJoe::SerializeCodec::deserialize_compact(const std::vector<uint8_t>& data, const SerializeHeader& header)
+{
+    const uint8_t* base = data.data();
+    std::size_t end_index = HEADER_SIZE + header.message_length;
+    std::size_t current_index = HEADER_SIZE;
+    uint32_t read_size = 0;
+    for (uint32_t i = 0; i < header.field_count; ++i)
+    {
+        SerializeField field;
+        // 读取标签
+        auto tag_opt = read_varint(base + current_index, end_index - current_index, read_size);
+        if (!tag_opt.has_value())
+        {
+            ADD_DIAG_WARN("network", "Deserialize compact field failed: invalid tag at {}", current_index);
+            return;
+        }
+        current_index += read_size;
+        std::string name;
+        if (tag_opt.value() == 0)
+        {
+            auto name_length_opt = read_varint(base + current_index, end_index - current_index, read_size);
+            if (!name_length_opt.has_value() || end_index - current_index - read_size < name_length_opt.value())
+            {
+                ADD_DIAG_WARN("network", "Deserialize compact field failed: invalid name at {}", current_index);
+                return;
+            }
+            current_index += read_size;
+            name.assign(base + current_index, base + current_index + name_length_opt.value());
+            current_index += name_length_opt.value();
+        }
+        else
+        {
+            std::optional<std::string> name_opt;
+            if (m_serialized_config.field_tag_table)
+            {
+                name_opt = m_serialized_config.field_tag_table->get_name(static_cast<uint32_t>(tag_opt.value()));
+            }
+            if (!name_opt.has_value())
+            {
+                ADD_DIAG_WARN("network", "Deserialize compact field: unknown tag {}", tag_opt.value());
+                name = "#" + std::to_string(tag_opt.value());
+            }
+            else
+            {
+                name = std::move(name_opt.value());
+            }
+        }
+        // 读取类型
+        if (current_index >= end_index)
+        {
+            ADD_DIAG_WARN("network", "Deserialize compact field failed: missing type of {}", name);
+            return;
+        }
+        field.type = static_cast<DataType>(base[current_index++]);
+        field.flag = SerializeFieldFlag::None;
+        uint32_t width = get_data_type_length(field.type);
+        if (is_unsigned_integer_type(field.type) || is_signed_integer_type(field.type))
+        {
+            auto value_opt = read_varint(base + current_index, end_index - current_index, read_size);
+            if (!value_opt.has_value())
+            {
+                ADD_DIAG_WARN("network", "Deserialize compact field failed: invalid varint of {}", name);
+                return;
+            }
+            current_index += read_size;
+            uint64_t bits = is_signed_integer_type(field.type) ?
+                static_cast<uint64_t>(zigzag_decode(value_opt.value())) :
+                value_opt.value();
+            field.value = store_integer_bits(bits, width);
+        }
+        else if (field.type == DataType::Bool || field.type == DataType::Float || field.type == DataType::Double)
+        {
+            if (end_index - current_index < width)
+            {
+                ADD_DIAG_WARN("network", "Deserialize compact field failed: not enough data of {}", name);
+                return;
+            }
+            // 定长值由网络字节序还原为本地字节序
+            field.value.resize(width);
+            switch (width)
+            {
+            case 4: to_local_byte_order(field.value.data(), reinterpret_cast<const uint32_t*>(base + current_index)); break;
+            case 8: to_local_byte_order(field.value.data(), reinterpret_cast<const uint64_t*>(base + current_index)); break;
+            default: std::memcpy(field.value.data(), base + current_index, width); break;
+            }
+            current_index += width;
+        }
+        else
+        {
+            auto length_opt = read_varint(base + current_index, end_index - current_index, read_size);
+            if (!length_opt.has_value() || end_index - current_index - read_size < length_opt.value())
+            {
+                ADD_DIAG_WARN("network", "Deserialize compact field failed: invalid value length of {}", name);
+                return;
+            }
+            current_index += read_size;
+            field.flag = SerializeFieldFlag::HasValueLength;
+            field.value = std::vector<uint8_t>(base + current_index, base + current_index + length_opt.value());
+            current_index += length_opt.value();
+        }
+        field.value_length = field.value.size();
+        field.name = std::vector<uint8_t>(name.begin(), name.end());
+        field.name_length = field.name.size();
+        m_serialized_data_map_parsed.insert(std::make_pair(std::move(name), std::move(field)));
+    }
+}
+
 std::optional<DaneJoe::SerializeHeader> DaneJoe::SerializeCodec::get_message_header(const std::vector<uint8_t>& data)const noexcept
 {
     if (data.size() < HEADER_SIZE)
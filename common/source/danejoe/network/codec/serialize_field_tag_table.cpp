@@ -0,0 +1,47 @@
+#include "danejoe/common/diagnostic/diagnostic_system.hpp"
+#include "danejoe/network/codec/serialize_field_tag_table.hpp"
+
+DaneJoe::SerializeFieldTagTable::SerializeFieldTagTable(std::initializer_list<std::pair<uint32_t, std::string>> entries)
+{
+    for (const auto& entry : entries)
+    {
+        add(entry.first, entry.second);
+    }
+}
+
+bool DaneJoe::SerializeFieldTagTable::add(uint32_t tag, const std::string& name)
+{
+    if (tag == 0)
+    {
+        ADD_DIAG_WARN("network", "Add field tag skipped: tag 0 is reserved, name={}", name);
+        return false;
+    }
+    if (m_name_to_tag.find(name) != m_name_to_tag.end() || m_tag_to_name.count(tag))
+    {
+        ADD_DIAG_WARN("network", "Add field tag skipped: duplicate tag {} or name {}", tag, name);
+        return false;
+    }
+    m_name_to_tag[name] = tag;
+    m_tag_to_name[tag] = name;
+    return true;
+}
+
+std::optional<uint32_t> DaneJoe::SerializeFieldTagTable::get_tag(std::string_view name)const
+{
+    auto it = m_name_to_tag.find(name);
+    if (it == m_name_to_tag.end())
+    {
+        return std::nullopt;
+    }
+    return it->second;
+}
+
+std::optional<std::string> DaneJoe::SerializeFieldTagTable::get_name(uint32_t tag)const
+{
+    auto it = m_tag_to_name.find(tag);
+    if (it == m_tag_to_name.end())
+    {
+        return std::nullopt;
+    }
+    return it->second;
+}
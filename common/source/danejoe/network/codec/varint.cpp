@@ -0,0 +1,43 @@
+#include "danejoe/network/codec/varint.hpp"
+
+uint32_t DaneJoe::get_varint_size(uint64_t value)
+{
+    uint32_t size = 1;
+    while (value >= 0x80)
+    {
+        value >>= 7;
+        size++;
+    }
+    return size;
+}
+
+uint32_t DaneJoe::write_varint(uint8_t* dest, uint64_t value)
+{
+    uint32_t index = 0;
+    while (value >= 0x80)
+    {
+        dest[index++] = static_cast<uint8_t>(value | 0x80);
+        value >>= 7;
+    }
+    dest[index++] = static_cast<uint8_t>(value);
+    return index;
+}
+
+std::optional<uint64_t> DaneJoe::read_varint(const uint8_t* data, std::size_t size, uint32_t& read_size)
+{
+    uint64_t value = 0;
+    uint32_t shift = 0;
+    for (uint32_t i = 0; i < size && i < MAX_VARINT_SIZE; i++)
+    {
+        uint8_t byte = data[i];
+        value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0)
+        {
+            read_size = i + 1;
+            return value;
+        }
+        shift += 7;
+    }
+    read_size = 0;
+    return std::nullopt;
+}
@@ -1,7 +1,36 @@
+#include <limits>
+
 #include "danejoe/network/context/connect_context.hpp"
 #include "danejoe/common/status/i_status_detail.hpp"
 #include "danejoe/network/status/posix_status_code.hpp"
  #include "danejoe/common/diagnostic/diagnostic_system.hpp"
+#include "danejoe/common/diagnostic/trace_recorder.hpp"
+#include "danejoe/metrics/metrics_registry.hpp"
+
+namespace
+{
+    /**
+     * @struct ConnectMetrics
+     * @brief 连接收发指标
+     */
+    struct ConnectMetrics
+    {
+        /// @brief 接收字节数
+        DaneJoe::MetricsCounter& bytes_in = DaneJoe::MetricsRegistry::get_instance().get_counter("network_bytes_in_total");
+        /// @brief 发送字节数
+        DaneJoe::MetricsCounter& bytes_out = DaneJoe::MetricsRegistry::get_instance().get_counter("network_bytes_out_total");
+        /// @brief 接收帧数
+        DaneJoe::MetricsCounter& frames_in = DaneJoe::MetricsRegistry::get_instance().get_counter("network_frames_in_total");
+        /// @brief 发送帧数
+        DaneJoe::MetricsCounter& frames_out = DaneJoe::MetricsRegistry::get_instance().get_counter("network_frames_out_total");
+    };
+
+    ConnectMetrics& get_connect_metrics()
+    {
+        static ConnectMetrics metrics;
+        return metrics;
+    }
+}
 
 DaneJoe::ConnectContext::ConnectContext(
     uint64_t connect_id,
@@ -19,9 +48,11 @@ DaneJoe::Result<std::vector<DaneJoe::PosixFrame>> DaneJoe::ConnectContext::read(
         return Result<std::vector<PosixFrame>>(status_code);
     }
     int read_blocks = 0;
+    const bool is_trace_enabled = TraceRecorder::get_instance().is_enabled();
+    int64_t last_read_time = 0;
     while (true)
     {
-        auto ret = m_socket_handle.read_some(1024);
+        auto ret = m_socket_handle.read_some(BUFFER_SIZE);
         if (ret.status_code().get_status_level() == StatusLevel::Error)
         {
             ADD_DIAG_WARN("network", "ConnectContext::read error: connect_id={}, fd={}, status={}",
@@ -49,11 +80,27 @@ DaneJoe::Result<std::vector<DaneJoe::PosixFrame>> DaneJoe::ConnectContext::read(
             break;
         }
         read_blocks++;
+        get_connect_metrics().bytes_in.add(ret.value().size());
+        if (is_trace_enabled)
+        {
+            last_read_time = TraceRecorder::now();
+            if (m_first_byte_time == 0)
+            {
+                m_first_byte_time = last_read_time;
+            }
+        }
         ADD_DIAG_DEBUG("network", "ConnectContext::read got bytes: connect_id={}, fd={}, size={}",
             m_connect_id,
             m_socket_handle.get_handle().get(),
             static_cast<int>(ret.value().size()));
-        m_frame_assembler.push_data(ret.value());
+        if (!m_frame_assembler.push_data(ret.value()))
+        {
+            ADD_DIAG_WARN("network", "ConnectContext::read frame limit exceeded: connect_id={}, fd={}",
+                m_connect_id,
+                m_socket_handle.get_handle().get());
+            auto status_code = make_posix_status_code(StatusLevel::Error, "frame limit exceeded");
+            return Result<std::vector<PosixFrame>>(status_code);
+        }
     }
     std::vector<PosixFrame> result_frames;
     while (true)
@@ -67,7 +114,15 @@ DaneJoe::Result<std::vector<DaneJoe::PosixFrame>> DaneJoe::ConnectContext::read(
         ADD_DIAG_DEBUG("network", "ConnectContext::read pop frame: connect_id={}, size={}",
             m_connect_id,
             static_cast<int>(frame_opt.value().size()));
-        result_frames.push_back({ m_connect_id,frame_opt.value() });
+        result_frames.push_back({ m_connect_id, frame_opt.value(), {} });
+        if (is_trace_enabled)
+        {
+            auto& trace = result_frames.back().trace;
+            trace.first_byte_time = m_first_byte_time;
+            trace.assembled_time = TraceRecorder::now();
+            // 同一次读取中后续帧的首字节时间按最近一次读取近似
+            m_first_byte_time = m_frame_assembler.has_pending_data() ? last_read_time : 0;
+        }
     }
     if (read_blocks > 0 || !result_frames.empty())
     {
@@ -77,6 +132,10 @@ DaneJoe::Result<std::vector<DaneJoe::PosixFrame>> DaneJoe::ConnectContext::read(
             read_blocks,
             static_cast<int>(result_frames.size()));
     }
+    if (!result_frames.empty())
+    {
+        get_connect_metrics().frames_in.add(result_frames.size());
+    }
     auto status_code = make_posix_status_code(StatusLevel::Ok);
     return Result<std::vector<PosixFrame>>(result_frames, status_code);
 
@@ -88,30 +147,78 @@ DaneJoe::Result<int> DaneJoe::ConnectContext::write(std::vector<PosixFrame> fram
         auto status_code = make_posix_status_code(StatusLevel::Error, "failed to read invalid socket");
         return Result<int>(status_code);
     }
-    for (const auto& frame : frames)
+    if (!frames.empty())
     {
-        m_write_buffer.insert(m_write_buffer.end(), frame.data.begin(), frame.data.end());
+        get_connect_metrics().frames_out.add(frames.size());
     }
-    auto ret =
-        m_socket_handle.write(m_write_buffer);
-    if (ret.status_code().get_status_level() == StatusLevel::Error)
+    auto& trace_recorder = TraceRecorder::get_instance();
+    for (auto& frame : frames)
     {
-        return Result<int>(ret.status_code());
+        if (trace_recorder.is_enabled() && frame.trace.request_id >= 0)
+        {
+            m_unwritten_request_ids.push_back(frame.trace.request_id);
+        }
+        m_frame_chunker.push_frame(std::move(frame.data));
     }
-    if (!ret.has_value() || ret.value() == 0)
+    // 写缓冲低水位：未启用分片时一次性取出全部待发送帧
+    const std::size_t low_watermark = m_frame_chunker.get_config().is_enabled ?
+        m_frame_chunker.get_config().chunk_size :
+        std::numeric_limits<std::size_t>::max();
+    int total_write = 0;
+    while (true)
     {
-        return Result<int>(ret.status_code());
+        m_frame_chunker.fill_buffer(m_write_buffer, low_watermark);
+        if (m_write_buffer.empty())
+        {
+            break;
+        }
+        auto ret =
+            m_socket_handle.write(m_write_buffer);
+        if (ret.status_code().get_status_level() == StatusLevel::Error)
+        {
+            return Result<int>(ret.status_code());
+        }
+        if (!ret.has_value() || ret.value() == 0)
+        {
+            if (total_write > 0)
+            {
+                break;
+            }
+            return Result<int>(ret.status_code());
+        }
+        std::size_t has_write = ret.value();
+        m_write_buffer.erase(m_write_buffer.begin(), m_write_buffer.begin() + has_write);
+        total_write += static_cast<int>(has_write);
+        get_connect_metrics().bytes_out.add(has_write);
+        // 未能写完说明 socket 暂不可写，等待下一次可写事件
+        if (!m_write_buffer.empty())
+        {
+            break;
+        }
     }
-    int total_write = ret.value();
-    m_write_buffer.erase(m_write_buffer.begin(), m_write_buffer.begin() + total_write);
 
+    // 分片后无法定位单个帧的结束位置，待发送数据全部写出时统一记录；连接上有多个响应排队时为上界
+    if (!m_unwritten_request_ids.empty() && !has_pending_write())
+    {
+        int64_t written_time = TraceRecorder::now();
+        for (int64_t request_id : m_unwritten_request_ids)
+        {
+            trace_recorder.record(TracePoint::FullyWritten, m_connect_id, request_id, written_time);
+        }
+        m_unwritten_request_ids.clear();
+    }
     auto status_code = make_posix_status_code(StatusLevel::Ok);
     return Result<int>(total_write, status_code);
 }
 
 bool DaneJoe::ConnectContext::has_pending_write() const
 {
-    return !m_write_buffer.empty();
+    return !m_write_buffer.empty() || m_frame_chunker.has_pending();
+}
+
+void DaneJoe::ConnectContext::set_chunk_config(const FrameChunkConfig& config)
+{
+    m_frame_chunker.set_config(config);
 }
 
 uint64_t DaneJoe::ConnectContext::get_connect_id()const
@@ -7,6 +7,8 @@
 #include <cstring>
 
 #include "danejoe/common/diagnostic/diagnostic_system.hpp"
+#include "danejoe/common/diagnostic/trace_recorder.hpp"
+#include "danejoe/metrics/metrics_registry.hpp"
 #include "danejoe/network/status/posix_status_code.hpp"
 #include "danejoe/network/event_loop/posix_epoll_event_loop.hpp"
 
@@ -15,6 +17,21 @@
 #include <netinet/in.h>
 #include <arpa/inet.h>
 
+namespace
+{
+    DaneJoe::MetricsGauge& get_active_connection_gauge()
+    {
+        static DaneJoe::MetricsGauge& gauge = DaneJoe::MetricsRegistry::get_instance().get_gauge("network_active_connections");
+        return gauge;
+    }
+
+    DaneJoe::MetricsCounter& get_accepted_connection_counter()
+    {
+        static DaneJoe::MetricsCounter& counter = DaneJoe::MetricsRegistry::get_instance().get_counter("network_accepted_connections_total");
+        return counter;
+    }
+}
+
 DaneJoe::PosixEpollEventLoop::PosixEpollEventLoop() {}
 
 DaneJoe::PosixEpollEventLoop::PosixEpollEventLoop(
@@ -39,6 +56,7 @@ DaneJoe::PosixEpollEventLoop::PosixEpollEventLoop(
 DaneJoe::PosixEpollEventLoop::~PosixEpollEventLoop()
 {
     stop();
+    get_active_connection_gauge().add(-static_cast<int64_t>(m_connect_contexts.size()));
 }
 void DaneJoe::PosixEpollEventLoop::init(
     std::shared_ptr<ReactorMailBox> reactor_mail_box,
@@ -75,6 +93,10 @@ void DaneJoe::PosixEpollEventLoop::init(
         }
     }
 }
+void DaneJoe::PosixEpollEventLoop::set_chunk_config(const FrameChunkConfig& config)
+{
+    m_chunk_config = config;
+}
 void DaneJoe::PosixEpollEventLoop::run()
 {
     if (!m_reactor_mail_box || !m_epoll_handle || !m_event_handle || !m_server_handle)
@@ -171,6 +193,7 @@ void DaneJoe::PosixEpollEventLoop::remove_connect(int fd)
     }
     m_reactor_mail_box->remove_to_client_queue(context_it->second.get_connect_id());
     m_connect_contexts.erase(context_it);
+    get_active_connection_gauge().add(-1);
 }
 void DaneJoe::PosixEpollEventLoop::notify()
 {
@@ -299,6 +322,8 @@ void DaneJoe::PosixEpollEventLoop::acceptable_event()
             }
         }
 
+        // 仅为调试诊断服务的 getpeername 与 MSG_PEEK，调试级别关闭时整段跳过
+        if (ADD_DIAG_IS_ENABLED(Debug, "network"))
         {
             sockaddr_in peer_addr;
             socklen_t peer_len = sizeof(peer_addr);
@@ -343,8 +368,13 @@ void DaneJoe::PosixEpollEventLoop::acceptable_event()
         }
 
         auto connect_id = m_connect_counter++;
-        m_connect_contexts.emplace(fd, ConnectContext{ connect_id, std::move(ret.value()) });
+        auto context_it =
+            m_connect_contexts.emplace(fd, ConnectContext{ connect_id, std::move(ret.value()) }).first;
+        context_it->second.set_chunk_config(m_chunk_config);
         m_reactor_mail_box->add_to_client_queue(connect_id);
+        ADD_TRACE_POINT(Accept, connect_id, -1);
+        get_accepted_connection_counter().add();
+        get_active_connection_gauge().add(1);
         ADD_DIAG_INFO("network", "accept new connection: fd={}, connect_id={}", fd, connect_id);
     }
 }
@@ -0,0 +1,67 @@
+#include <algorithm>
+
+#include "danejoe/common/diagnostic/diagnostic_system.hpp"
+#include "danejoe/network/flow/adaptive_block_size.hpp"
+
+DaneJoe::AdaptiveBlockSize::AdaptiveBlockSize(const AdaptiveBlockSizeConfig& config)
+{
+    set_config(config);
+}
+
+void DaneJoe::AdaptiveBlockSize::set_config(const AdaptiveBlockSizeConfig& config)
+{
+    m_config = config;
+    m_config.alignment_bytes = std::max<int64_t>(1, m_config.alignment_bytes);
+    m_config.min_block_bytes = std::max<int64_t>(1, m_config.min_block_bytes);
+    m_config.max_block_bytes = std::max(m_config.min_block_bytes, m_config.max_block_bytes);
+    m_block_bytes = normalize(m_config.initial_block_bytes);
+}
+
+DaneJoe::AdaptiveBlockSizeConfig DaneJoe::AdaptiveBlockSize::get_config()const
+{
+    return m_config;
+}
+
+void DaneJoe::AdaptiveBlockSize::on_block_completed(int64_t bytes, std::chrono::nanoseconds latency)
+{
+    if (bytes <= 0 || latency.count() <= 0)
+    {
+        return;
+    }
+    double bytes_per_second = static_cast<double>(bytes) / std::chrono::duration<double>(latency).count();
+    double target_seconds = std::chrono::duration<double>(m_config.target_block_duration).count();
+    auto target = static_cast<int64_t>(bytes_per_second * target_seconds);
+    // 单次最多翻倍或减半，避免个别样本引起剧烈抖动
+    target = std::clamp(target, m_block_bytes / 2, m_block_bytes * 2);
+    m_block_bytes = normalize(target);
+}
+
+void DaneJoe::AdaptiveBlockSize::on_block_lost()
+{
+    m_block_bytes = normalize(m_block_bytes / 2);
+    ADD_DIAG_DEBUG("network", "Adaptive block size reduced on loss: block_bytes={}", m_block_bytes);
+}
+
+int64_t DaneJoe::AdaptiveBlockSize::get_block_bytes()const
+{
+    return m_block_bytes;
+}
+
+int64_t DaneJoe::AdaptiveBlockSize::get_next_length(int64_t remaining_bytes)const
+{
+    if (remaining_bytes <= 0)
+    {
+        return 0;
+    }
+    if (remaining_bytes - m_block_bytes < m_config.min_block_bytes)
+    {
+        return remaining_bytes;
+    }
+    return m_block_bytes;
+}
+
+int64_t DaneJoe::AdaptiveBlockSize::normalize(int64_t bytes)const
+{
+    bytes -= bytes % m_config.alignment_bytes;
+    return std::clamp(bytes, m_config.min_block_bytes, m_config.max_block_bytes);
+}
@@ -0,0 +1,205 @@
+#include <cmath>
+#include <algorithm>
+
+#include "danejoe/common/diagnostic/diagnostic_system.hpp"
+#include "danejoe/network/flow/adaptive_window.hpp"
+
+DaneJoe::AdaptiveWindow::AdaptiveWindow(const AdaptiveWindowConfig& config)
+{
+    set_config(config);
+}
+
+void DaneJoe::AdaptiveWindow::set_config(const AdaptiveWindowConfig& config)
+{
+    m_config = config;
+    m_config.min_window = std::max<int64_t>(1, m_config.min_window);
+    m_config.max_window = std::max(m_config.min_window, m_config.max_window);
+    m_config.bandwidth_round_count = std::max<std::size_t>(1, m_config.bandwidth_round_count);
+    if (m_bandwidth_samples.empty())
+    {
+        m_window = std::clamp(m_config.initial_window, m_config.min_window, m_config.max_window);
+    }
+    else
+    {
+        update_window();
+    }
+}
+
+DaneJoe::AdaptiveWindowConfig DaneJoe::AdaptiveWindow::get_config()const
+{
+    return m_config;
+}
+
+void DaneJoe::AdaptiveWindow::on_sent()
+{
+    if (m_round_target == 0)
+    {
+        // 新一轮从当前发出的请求开始计时
+        m_round_start = Clock::now();
+        m_round_target = std::max<int64_t>(1, m_in_flight + 1);
+    }
+    m_in_flight++;
+}
+
+void DaneJoe::AdaptiveWindow::on_acked(std::chrono::nanoseconds rtt, int64_t bytes, Clock::time_point now)
+{
+    if (m_in_flight > 0)
+    {
+        m_in_flight--;
+    }
+    if (rtt.count() > 0)
+    {
+        update_rtt(rtt, now);
+    }
+    if (bytes > 0)
+    {
+        m_average_bytes = m_average_bytes <= 0.0 ?
+            static_cast<double>(bytes) :
+            m_average_bytes * 0.875 + static_cast<double>(bytes) * 0.125;
+        update_bandwidth(bytes, now);
+    }
+    update_window();
+}
+
+void DaneJoe::AdaptiveWindow::on_lost()
+{
+    if (m_in_flight > 0)
+    {
+        m_in_flight--;
+    }
+    m_bandwidth_samples.clear();
+    m_round_target = 0;
+    m_round_acked = 0;
+    m_round_bytes = 0;
+    m_window = std::max(m_config.min_window, m_window / 2);
+    ADD_DIAG_DEBUG("network", "Adaptive window reduced on loss: window={}", m_window);
+}
+
+void DaneJoe::AdaptiveWindow::on_cancelled()
+{
+    if (m_in_flight > 0)
+    {
+        m_in_flight--;
+    }
+    // 撤销的请求不再计入本轮，若本轮因此无待确认请求则放弃本轮样本
+    if (m_round_target > m_round_acked)
+    {
+        m_round_target--;
+    }
+    if (m_round_target <= m_round_acked)
+    {
+        m_round_target = 0;
+        m_round_acked = 0;
+        m_round_bytes = 0;
+    }
+}
+
+bool DaneJoe::AdaptiveWindow::can_send()const
+{
+    return m_in_flight < m_window;
+}
+
+int64_t DaneJoe::AdaptiveWindow::get_window()const
+{
+    return m_window;
+}
+
+int64_t DaneJoe::AdaptiveWindow::get_in_flight()const
+{
+    return m_in_flight;
+}
+
+std::chrono::nanoseconds DaneJoe::AdaptiveWindow::get_smoothed_rtt()const
+{
+    return std::chrono::nanoseconds(static_cast<int64_t>(m_smoothed_rtt_ns));
+}
+
+std::chrono::nanoseconds DaneJoe::AdaptiveWindow::get_min_rtt()const
+{
+    return std::chrono::nanoseconds(static_cast<int64_t>(m_min_rtt_ns));
+}
+
+double DaneJoe::AdaptiveWindow::get_bandwidth()const
+{
+    if (m_bandwidth_samples.empty())
+    {
+        return 0.0;
+    }
+    return *std::max_element(m_bandwidth_samples.begin(), m_bandwidth_samples.end());
+}
+
+std::chrono::nanoseconds DaneJoe::AdaptiveWindow::get_retransmit_timeout()const
+{
+    std::chrono::nanoseconds min_timeout = m_config.min_retransmit_timeout;
+    if (!m_has_rtt_sample)
+    {
+        return min_timeout;
+    }
+    auto timeout = std::chrono::nanoseconds(static_cast<int64_t>(m_smoothed_rtt_ns + 4.0 * m_rtt_variance_ns));
+    return std::max(timeout, min_timeout);
+}
+
+void DaneJoe::AdaptiveWindow::update_rtt(std::chrono::nanoseconds rtt, Clock::time_point now)
+{
+    double sample = static_cast<double>(rtt.count());
+    if (!m_has_rtt_sample)
+    {
+        m_smoothed_rtt_ns = sample;
+        m_rtt_variance_ns = sample / 2.0;
+        m_min_rtt_ns = sample;
+        m_min_rtt_stamp = now;
+        m_has_rtt_sample = true;
+        return;
+    }
+    // RFC 6298：alpha = 1/8，beta = 1/4
+    m_rtt_variance_ns = m_rtt_variance_ns * 0.75 + std::abs(m_smoothed_rtt_ns - sample) * 0.25;
+    m_smoothed_rtt_ns = m_smoothed_rtt_ns * 0.875 + sample * 0.125;
+    if (sample <= m_min_rtt_ns || now - m_min_rtt_stamp > m_config.min_rtt_expiry)
+    {
+        m_min_rtt_ns = sample;
+        m_min_rtt_stamp = now;
+    }
+}
+
+void DaneJoe::AdaptiveWindow::update_bandwidth(int64_t bytes, Clock::time_point now)
+{
+    if (m_round_target == 0)
+    {
+        return;
+    }
+    m_round_acked++;
+    m_round_bytes += bytes;
+    if (m_round_acked < m_round_target)
+    {
+        return;
+    }
+    auto elapsed = std::chrono::duration<double>(now - m_round_start).count();
+    if (elapsed > 0.0)
+    {
+        m_bandwidth_samples.push_back(static_cast<double>(m_round_bytes) / elapsed);
+        while (m_bandwidth_samples.size() > m_config.bandwidth_round_count)
+        {
+            m_bandwidth_samples.pop_front();
+        }
+    }
+    // 下一轮从当前时刻开始，目标为此刻仍在途的请求
+    m_round_start = now;
+    m_round_acked = 0;
+    m_round_bytes = 0;
+    m_round_target = m_in_flight;
+}
+
+void DaneJoe::AdaptiveWindow::update_window()
+{
+    double bandwidth = get_bandwidth();
+    if (bandwidth <= 0.0 || m_min_rtt_ns <= 0.0 || m_average_bytes <= 0.0)
+    {
+        return;
+    }
+    double bdp_bytes = bandwidth * m_min_rtt_ns / 1e9;
+    double target = std::ceil(m_config.window_gain * bdp_bytes / m_average_bytes);
+    // 每次最多翻倍，避免单个偏大的样本造成窗口突增
+    int64_t upper = std::max<int64_t>(m_window * 2, m_config.min_window);
+    int64_t window = std::min<int64_t>(static_cast<int64_t>(target), upper);
+    m_window = std::clamp(window, m_config.min_window, m_config.max_window);
+}
@@ -0,0 +1,105 @@
+#include "danejoe/network/flow/least_outstanding_balancer.hpp"
+
+std::size_t DaneJoe::LeastOutstandingBalancer::add_slot()
+{
+    m_slot_loads.emplace_back();
+    return m_slot_loads.size() - 1;
+}
+
+std::size_t DaneJoe::LeastOutstandingBalancer::get_slot_count()const
+{
+    return m_slot_loads.size();
+}
+
+std::optional<std::size_t> DaneJoe::LeastOutstandingBalancer::select()const
+{
+    if (m_slot_loads.empty())
+    {
+        return std::nullopt;
+    }
+    std::size_t best = 0;
+    for (std::size_t i = 1; i < m_slot_loads.size(); ++i)
+    {
+        const auto& load = m_slot_loads[i];
+        const auto& best_load = m_slot_loads[best];
+        if (load.outstanding_bytes < best_load.outstanding_bytes ||
+            (load.outstanding_bytes == best_load.outstanding_bytes &&
+                load.outstanding_requests < best_load.outstanding_requests))
+        {
+            best = i;
+        }
+    }
+    return best;
+}
+
+bool DaneJoe::LeastOutstandingBalancer::should_add_slot(std::size_t max_slot_count)const
+{
+    if (m_slot_loads.size() >= max_slot_count)
+    {
+        return false;
+    }
+    for (const auto& load : m_slot_loads)
+    {
+        if (load.outstanding_requests == 0)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+void DaneJoe::LeastOutstandingBalancer::on_dispatched(uint64_t request_id, std::size_t slot, int64_t bytes)
+{
+    if (slot >= m_slot_loads.size())
+    {
+        return;
+    }
+    auto& load = m_slot_loads[slot];
+    load.outstanding_bytes += bytes;
+    load.outstanding_requests++;
+    m_assignments[request_id] = Assignment{ slot, bytes };
+}
+
+void DaneJoe::LeastOutstandingBalancer::on_finished(uint64_t request_id)
+{
+    auto it = m_assignments.find(request_id);
+    if (it == m_assignments.end())
+    {
+        return;
+    }
+    auto& load = m_slot_loads[it->second.slot];
+    load.outstanding_bytes -= it->second.bytes;
+    load.outstanding_requests--;
+    m_assignments.erase(it);
+}
+
+std::vector<uint64_t> DaneJoe::LeastOutstandingBalancer::clear_slot(std::size_t slot)
+{
+    std::vector<uint64_t> request_ids;
+    if (slot >= m_slot_loads.size())
+    {
+        return request_ids;
+    }
+    for (auto it = m_assignments.begin(); it != m_assignments.end();)
+    {
+        if (it->second.slot != slot)
+        {
+            ++it;
+            continue;
+        }
+        request_ids.push_back(it->first);
+        it = m_assignments.erase(it);
+    }
+    m_slot_loads[slot] = SlotLoad();
+    return request_ids;
+}
+
+int64_t DaneJoe::LeastOutstandingBalancer::get_outstanding_bytes(std::size_t slot)const
+{
+    return slot < m_slot_loads.size() ? m_slot_loads[slot].outstanding_bytes : 0;
+}
+
+int64_t DaneJoe::LeastOutstandingBalancer::get_outstanding_requests(std::size_t slot)const
+{
+    return slot < m_slot_loads.size() ? m_slot_loads[slot].outstanding_requests : 0;
+}
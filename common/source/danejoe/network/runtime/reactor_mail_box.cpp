@@ -1,4 +1,21 @@
 #include "danejoe/network/runtime/reactor_mail_box.hpp"
+#include "danejoe/common/diagnostic/trace_recorder.hpp"
+#include "danejoe/metrics/metrics_registry.hpp"
+
+namespace
+{
+    DaneJoe::MetricsGauge& get_to_server_depth_gauge()
+    {
+        static DaneJoe::MetricsGauge& gauge = DaneJoe::MetricsRegistry::get_instance().get_gauge("mailbox_to_server_depth");
+        return gauge;
+    }
+
+    DaneJoe::MetricsGauge& get_to_client_depth_gauge()
+    {
+        static DaneJoe::MetricsGauge& gauge = DaneJoe::MetricsRegistry::get_instance().get_gauge("mailbox_to_client_depth");
+        return gauge;
+    }
+}
 
 DaneJoe::ReactorMailBox::ReactorMailBox()
 {
@@ -29,6 +46,7 @@ void DaneJoe::ReactorMailBox::remove_to_client_queue(uint64_t connect_id)
     {
         return;
     }
+    get_to_client_depth_gauge().add(-static_cast<int64_t>(it->second.size()));
     m_to_client_queues.erase(it);
 }
 
@@ -44,6 +62,8 @@ void DaneJoe::ReactorMailBox::push_to_client_frame(
         }
         it->second.push(frame);
     }
+    get_to_client_depth_gauge().add(1);
+    ADD_TRACE_POINT(QueuedToClient, frame.connect_id, frame.trace.request_id);
     if (m_event_handle)
     {
         m_event_handle->write(1);
@@ -51,13 +71,29 @@ void DaneJoe::ReactorMailBox::push_to_client_frame(
 }
 void DaneJoe::ReactorMailBox::push_to_server_frame(const PosixFrame& frame)
 {
-    m_to_server_frame_queue.push(frame);
+    // 先计入深度，避免业务线程先于此处取出时仪表短暂为负
+    get_to_server_depth_gauge().add(1);
+    bool is_pushed = false;
+    if (!TraceRecorder::get_instance().is_enabled())
+    {
+        is_pushed = m_to_server_frame_queue.push(frame);
+    }
+    else
+    {
+        PosixFrame traced_frame = frame;
+        traced_frame.trace.pushed_time = TraceRecorder::now();
+        is_pushed = m_to_server_frame_queue.push(std::move(traced_frame));
+    }
+    if (!is_pushed)
+    {
+        get_to_server_depth_gauge().add(-1);
+    }
 }
 void DaneJoe::ReactorMailBox::push_to_server_frame(const std::vector<PosixFrame>& frames)
 {
     for (const auto& frame : frames)
     {
-        m_to_server_frame_queue.push(frame);
+        push_to_server_frame(frame);
     }
 }
 std::optional<DaneJoe::PosixFrame>  DaneJoe::ReactorMailBox::pop_from_to_client_queue(uint64_t connect_id)
@@ -74,16 +110,27 @@ std::optional<DaneJoe::PosixFrame>  DaneJoe::ReactorMailBox::pop_from_to_client_
     }
     auto frame = it->second.front();
     it->second.pop();
+    get_to_client_depth_gauge().add(-1);
     return frame;
 }
 std::optional<DaneJoe::PosixFrame>  DaneJoe::ReactorMailBox::pop_from_to_server_frame()
 {
-    return m_to_server_frame_queue.pop();
+    auto frame = m_to_server_frame_queue.pop();
+    if (frame.has_value())
+    {
+        get_to_server_depth_gauge().add(-1);
+    }
+    return frame;
 }
 
 std::optional<DaneJoe::PosixFrame> DaneJoe::ReactorMailBox::try_pop_from_to_server_queue()
 {
-    return m_to_server_frame_queue.try_pop();
+    auto frame = m_to_server_frame_queue.try_pop();
+    if (frame.has_value())
+    {
+        get_to_server_depth_gauge().add(-1);
+    }
+    return frame;
 }
 void DaneJoe::ReactorMailBox::stop()
 {
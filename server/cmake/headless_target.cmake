@@ -0,0 +1,17 @@
+# @brief 无 Qt 依赖的服务端
+# @note 仅编译协议、实体、仓库、服务与运行时，只链接 ProjectTransCommonDaneJoe 与 SQLite
+set(SERVER_HEADLESS_EXECUTABLE_NAME ${PROJECT_NAME}Headless)
+
+if(NOT TARGET ProjectTransCommonDaneJoe)
+    add_subdirectory("${CMAKE_CURRENT_LIST_DIR}/../../common" "${CMAKE_BINARY_DIR}/ProjectTransCommon")
+endif()
+
+find_package(SQLite3 REQUIRED)
+
+add_executable(${SERVER_HEADLESS_EXECUTABLE_NAME}
+    "${CMAKE_CURRENT_LIST_DIR}/../source/main/headless_main.cpp"
+    ${SERVER_HEADLESS_SOURCES}
+)
+target_include_directories(${SERVER_HEADLESS_EXECUTABLE_NAME} PRIVATE "${CMAKE_CURRENT_LIST_DIR}/../include")
+target_link_libraries(${SERVER_HEADLESS_EXECUTABLE_NAME} PRIVATE ProjectTransCommonDaneJoe ProjectTransCommonAllocationCounter SQLite::SQLite3)
+apply_warnings(${SERVER_HEADLESS_EXECUTABLE_NAME})
@@ -2,6 +2,8 @@
 option(BUILD_TEST "Build tests" OFF)
 # @brief 构建 GUI 入口
 option(BUILD_SERVER_GUI_APP "Build GUI application entry" ON)
+# @brief 构建无 Qt 依赖的服务端
+option(BUILD_SERVER_HEADLESS "Build Qt-free headless server" ON)
 # @brief 启用编译器警告
 option(ENABLE_WARNINGS "Enable compiler warnings" ON)
 # @brief 将警告视为错误
@@ -20,6 +20,16 @@ file(GLOB SERVER_NORMAL_DIR_SOURCES CONFIGURE_DEPENDS
     "${SERVER_PROJECT_DIR}/source/runtime/*.cpp"
 )
 
+# 无界面服务端源文件（不含 Qt 视图模型）
+file(GLOB SERVER_HEADLESS_SOURCES CONFIGURE_DEPENDS
+    "${SERVER_PROJECT_DIR}/source/protocol/*.cpp"
+    "${SERVER_PROJECT_DIR}/source/model/entity/*.cpp"
+    "${SERVER_PROJECT_DIR}/source/model/transfer/*.cpp"
+    "${SERVER_PROJECT_DIR}/source/repository/*.cpp"
+    "${SERVER_PROJECT_DIR}/source/service/*.cpp"
+    "${SERVER_PROJECT_DIR}/source/runtime/*.cpp"
+)
+
 file(GLOB SERVER_QOBJECT_DIR_HEADERS CONFIGURE_DEPENDS
     "${SERVER_PROJECT_DIR}/include/view/**/*.hpp"
     "${SERVER_PROJECT_DIR}/include/main/*.hpp"
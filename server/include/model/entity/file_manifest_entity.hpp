@@ -0,0 +1,31 @@
+/**
+ * @file file_manifest_entity.hpp
+ * @author DaneJoe001 (danejoe001.github)
+ * @brief 文件分块哈希清单实体
+ * @date 2026-01-07
+ */
+
+#pragma once
+
+#include <string>
+#include <cstdint>
+
+#include "danejoe/common/hash/chunk_manifest.hpp"
+
+/**
+ * @struct FileManifestEntity
+ * @brief 文件分块哈希清单
+ * @details 添加文件时计算并保存，每个文件一条记录。
+ */
+struct FileManifestEntity
+{
+    /// @brief 文件ID
+    int32_t file_id = -1;
+    /// @brief 分块哈希清单
+    DaneJoe::ChunkManifest manifest;
+    /**
+     * @brief 转换为字符串
+     * @return 字符串
+     */
+    std::string to_string() const;
+};
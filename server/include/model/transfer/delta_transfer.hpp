@@ -0,0 +1,56 @@
+/**
+ * @file delta_transfer.hpp
+ * @author DaneJoe001 (danejoe001.github)
+ * @brief 差量传输模型
+ * @date 2026-01-08
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @struct DeltaRequestTransfer
+ * @brief 差量请求传输模型
+ * @details 客户端携带本地基准文件的签名，请求由基准文件重建目标文件的差量。
+ */
+struct DeltaRequestTransfer
+{
+    /// @brief 文件ID
+    int64_t file_id = -1;
+    /// @brief 任务ID
+    int64_t task_id = -1;
+    /// @brief 基准文件签名（FileSignature::encode()）
+    std::vector<uint8_t> signature;
+    /**
+     * @brief 转换为字符串
+     * @return 字符串
+     */
+    std::string to_string() const;
+};
+
+/**
+ * @struct DeltaResponseTransfer
+ * @brief 差量响应传输模型
+ * @details 文件不存在、签名无效或差量不划算时 delta 为空，客户端改为按块下载。
+ */
+struct DeltaResponseTransfer
+{
+    /// @brief 文件ID
+    int64_t file_id = -1;
+    /// @brief 任务ID
+    int64_t task_id = -1;
+    /// @brief 目标文件大小
+    int64_t file_size = 0;
+    /// @brief 目标文件 MD5
+    std::string md5_code;
+    /// @brief 差量（FileDelta::encode()）
+    std::vector<uint8_t> delta;
+    /**
+     * @brief 转换为字符串
+     * @return 字符串
+     */
+    std::string to_string() const;
+};
@@ -9,18 +9,30 @@
 
 #include <optional>
 
+#include "danejoe/network/codec/serialize_codec.hpp"
+
 #include "model/transfer/envelope_transfer.hpp"
 #include "model/transfer/block_transfer.hpp"
 #include "model/transfer/download_transfer.hpp"
+#include "model/transfer/manifest_transfer.hpp"
+#include "model/transfer/delta_transfer.hpp"
 #include "model/transfer/test_transfer.hpp"
 
 /**
  * @class ServerMessageCodec
  * @brief 服务端消息编解码器
+ * @details 请求解析按消息头版本自动选择字段名编码或紧凑编码；
+ *          响应按调用方传入的编码版本构建，通常与请求保持一致，以兼容只支持字段名编码的旧客户端。
  */
 class ServerMessageCodec
 {
 public:
+    /**
+     * @brief 获取帧的编码版本
+     * @param data 完整帧
+     * @return 编码版本；消息头无效或版本未知时返回 SerializeVersion::Named
+     */
+    DaneJoe::SerializeVersion get_wire_version(const std::vector<uint8_t>& data);
     /**
      * @brief 解析信封请求
      * @param data 输入字节数组
@@ -39,6 +51,18 @@ public:
      * @return 解析成功返回请求对象，否则返回空
      */
     std::optional<DownloadRequestTransfer> try_parse_byte_array_download_request(const std::vector<uint8_t>& data);
+    /**
+     * @brief 解析分块哈希清单请求
+     * @param data 输入字节数组
+     * @return 解析成功返回请求对象，否则返回空
+     */
+    std::optional<ManifestRequestTransfer> try_parse_byte_array_manifest_request(const std::vector<uint8_t>& data);
+    /**
+     * @brief 解析差量请求
+     * @param data 输入字节数组
+     * @return 解析成功返回请求对象，否则返回空
+     */
+    std::optional<DeltaRequestTransfer> try_parse_byte_array_delta_request(const std::vector<uint8_t>& data);
     /**
      * @brief 解析测试请求
      * @param data 输入字节数组
@@ -48,30 +72,94 @@ public:
     /**
      * @brief 构建信封响应字节数组
      * @param response 信封响应
+     * @param wire_version 编码版本
      * @return 可发送的响应字节数组
      */
-    std::vector<uint8_t> build_response_byte_array(const EnvelopeResponseTransfer& response);
+    std::vector<uint8_t> build_response_byte_array(const EnvelopeResponseTransfer& response,
+        DaneJoe::SerializeVersion wire_version = DaneJoe::SerializeVersion::Named);
     /**
      * @brief 构建块响应字节数组
      * @param block_response 块响应
      * @param request_id 请求ID
+     * @param wire_version 编码版本
      * @return 可发送的响应字节数组
      */
-    std::vector<uint8_t> build_block_response_byte_array(const BlockResponseTransfer& block_response, int64_t request_id);
+    std::vector<uint8_t> build_block_response_byte_array(const BlockResponseTransfer& block_response, int64_t request_id,
+        DaneJoe::SerializeVersion wire_version = DaneJoe::SerializeVersion::Named);
     /**
      * @brief 构建下载响应字节数组
      * @param download_response 下载响应
      * @param request_id 请求ID
+     * @param wire_version 编码版本
+     * @return 可发送的响应字节数组
+     */
+    std::vector<uint8_t> build_download_response_byte_array(const DownloadResponseTransfer& download_response, int64_t request_id,
+        DaneJoe::SerializeVersion wire_version = DaneJoe::SerializeVersion::Named);
+    /**
+     * @brief 构建分块哈希清单响应字节数组
+     * @param manifest_response 清单响应
+     * @param request_id 请求ID
+     * @param wire_version 编码版本
      * @return 可发送的响应字节数组
      */
-    std::vector<uint8_t> build_download_response_byte_array(const DownloadResponseTransfer& download_response, int64_t request_id);
+    std::vector<uint8_t> build_manifest_response_byte_array(const ManifestResponseTransfer& manifest_response, int64_t request_id,
+        DaneJoe::SerializeVersion wire_version = DaneJoe::SerializeVersion::Named);
+    /**
+     * @brief 构建差量响应字节数组
+     * @param delta_response 差量响应
+     * @param request_id 请求ID
+     * @param wire_version 编码版本
+     * @return 可发送的响应字节数组
+     */
+    std::vector<uint8_t> build_delta_response_byte_array(const DeltaResponseTransfer& delta_response, int64_t request_id,
+        DaneJoe::SerializeVersion wire_version = DaneJoe::SerializeVersion::Named);
     /**
      * @brief 构建测试响应字节数组
      * @param block_response 测试响应
      * @param request_id 请求ID
+     * @param wire_version 编码版本
      * @return 可发送的响应字节数组
      */
-    std::vector<uint8_t> build_test_response_byte_array(const TestResponseTransfer& block_response, int64_t request_id);
+    std::vector<uint8_t> build_test_response_byte_array(const TestResponseTransfer& block_response, int64_t request_id,
+        DaneJoe::SerializeVersion wire_version = DaneJoe::SerializeVersion::Named);
+    /**
+     * @brief 交还不再使用的响应字节数组
+     * @param frame 由 build_*_response_byte_array 构建的响应
+     * @details 缓冲区交还当前线程的信封编码器，下一次构建直接复用其容量。
+     *          只有在构建该响应的线程上交还才会被复用。
+     */
+    void recycle_frame_byte_array(std::vector<uint8_t>&& frame)const;
 private:
-
+    /**
+     * @brief 获取序列化配置
+     * @param wire_version 编码版本
+     * @return 序列化配置（编码版本与字段标签表）
+     */
+    DaneJoe::SerializeConfig get_serialize_config(
+        DaneJoe::SerializeVersion wire_version = DaneJoe::SerializeVersion::Named)const;
+    /**
+     * @brief 获取当前线程复用的消息体构建编码器
+     * @param wire_version 编码版本
+     * @return 已重置的编码器
+     */
+    DaneJoe::SerializeCodec& get_body_build_codec(DaneJoe::SerializeVersion wire_version)const;
+    /**
+     * @brief 获取当前线程复用的信封构建编码器
+     * @param body_size 消息体大小（用于预留构建缓冲区）
+     * @param wire_version 编码版本
+     * @return 已重置的编码器
+     */
+    DaneJoe::SerializeCodec& get_envelope_build_codec(std::size_t body_size, DaneJoe::SerializeVersion wire_version)const;
+    /**
+     * @brief 构建响应信封并回收消息体缓冲区
+     * @param envelope 响应信封（消息体缓冲区交还消息体编码器）
+     * @param wire_version 编码版本
+     * @return 构建后的响应
+     */
+    std::vector<uint8_t> finish_response_byte_array(EnvelopeResponseTransfer&& envelope, DaneJoe::SerializeVersion wire_version);
+private:
+    /// @brief 信封除消息体外预留的字节数
+    static constexpr uint32_t ENVELOPE_RESERVED_SIZE = 256;
+    /// @brief 响应信封版本，>=2 表示服务端支持紧凑编码，客户端据此升级请求编码（旧客户端忽略该字段）
+    static constexpr uint16_t ENVELOPE_VERSION = 2;
 };
\ No newline at end of file
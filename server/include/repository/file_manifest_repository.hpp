@@ -0,0 +1,72 @@
+/**
+ * @file file_manifest_repository.hpp
+ * @author DaneJoe001 (danejoe001.github)
+ * @brief 文件分块哈希清单仓库
+ * @date 2026-01-07
+ */
+
+#pragma once
+
+#include <optional>
+#include <cstdint>
+
+#include <danejoe/database/sql_query.hpp>
+#include <danejoe/database/sql_database.hpp>
+
+#include "model/entity/file_manifest_entity.hpp"
+
+/**
+ * @class FileManifestRepository
+ * @brief 文件分块哈希清单仓库
+ * @details 块哈希整体存为一个 BLOB（每块 8 字节小端），同时保存根哈希用于加载时自检。
+ */
+class FileManifestRepository
+{
+public:
+    /**
+     * @brief 构造函数
+     */
+    FileManifestRepository();
+    /**
+     * @brief 析构函数
+     */
+    ~FileManifestRepository();
+    /**
+     * @brief 确保表存在
+     * @return 是否创建/确认成功
+     */
+    bool ensure_table_exists();
+    /**
+     * @brief 初始化
+     */
+    void init();
+    /**
+     * @brief 保存清单
+     * @param manifest_entity 清单
+     * @return 是否保存成功
+     * @details 不存在时插入，存在时整体替换。
+     */
+    bool save(const FileManifestEntity& manifest_entity);
+    /**
+     * @brief 获取清单
+     * @param file_id 文件ID
+     * @return 清单；不存在或根哈希不一致时返回空
+     */
+    std::optional<FileManifestEntity> get_by_file_id(int32_t file_id);
+    /**
+     * @brief 删除清单
+     * @param file_id 文件ID
+     * @return 是否删除成功
+     */
+    bool remove(int32_t file_id);
+    /**
+     * @brief 是否初始化
+     * @return 是否初始化
+     */
+    bool is_init()const;
+private:
+    /// @brief 数据库
+    DaneJoe::SqlDatabasePtr m_database;
+    /// @brief SQL查询对象
+    DaneJoe::SqlQueryPtr m_query;
+};
@@ -9,14 +9,63 @@
 
 #include <atomic>
 #include <memory>
+#include <string>
+#include <thread>
+#include <vector>
 
+#include "danejoe/concurrent/container/mpmc_bounded_queue.hpp"
 #include "danejoe/network/runtime/reactor_mail_box.hpp"
 #include "protocol/server_message_codec.hpp"
 #include "service/server_file_info_service.hpp"
+#include "service/file_manifest_service.hpp"
+
+/**
+ * @struct BlockTask
+ * @brief 块读取任务
+ * @details 业务线程完成文件信息查询后交由块工作线程执行的读取任务，
+ *          工作线程只做文件读取与编码，不访问数据库。
+ */
+struct BlockTask
+{
+    /// @brief 块请求
+    BlockRequestTransfer block_request;
+    /// @brief 请求ID
+    int64_t request_id = 0;
+    /// @brief 连接ID
+    uint64_t connect_id = 0;
+    /// @brief 资源文件路径
+    std::string resource_path;
+    /// @brief 响应编码版本
+    DaneJoe::SerializeVersion wire_version = DaneJoe::SerializeVersion::Named;
+};
+
+/**
+ * @struct DeltaTask
+ * @brief 差量计算任务
+ * @details 差量需要读取并滚动匹配整个文件，交由差量工作线程执行，避免阻塞业务线程上的其他请求。
+ */
+struct DeltaTask
+{
+    /// @brief 差量请求
+    DeltaRequestTransfer delta_request;
+    /// @brief 请求ID
+    int64_t request_id = 0;
+    /// @brief 连接ID
+    uint64_t connect_id = 0;
+    /// @brief 资源文件路径
+    std::string resource_path;
+    /// @brief 文件 MD5
+    std::string md5_code;
+    /// @brief 响应编码版本
+    DaneJoe::SerializeVersion wire_version = DaneJoe::SerializeVersion::Named;
+};
 
 /**
  * @class BusinessRuntime
  * @brief 业务运行时
+ * @details 业务线程负责解析请求并直接处理 /test、/download、/manifest、/metrics 等轻量请求；
+ *          /block 请求交由块工作线程读取文件，/delta 请求交由差量工作线程计算，
+ *          因此同一连接上的响应可以乱序返回，客户端通过 request_id 关联请求与响应。
  */
 class BusinessRuntime
 {
@@ -42,10 +91,12 @@ public:
      * @brief 处理连接请求数据
      * @param data 接收到的字节数组
      * @param connect_id 连接ID
+     * @param frame_trace 帧跟踪信息（解析出 request_id 后补记 IO 侧的跟踪点）
      */
     void handle_request(
         const std::vector<uint8_t>& data,
-        uint64_t connect_id);
+        uint64_t connect_id,
+        const DaneJoe::FrameTrace& frame_trace = {});
     /**
      * @brief 处理未知请求
      */
@@ -55,31 +106,110 @@ public:
      * @param download_request 下载请求
      * @param request_id 请求ID
      * @param connect_id 连接ID
+     * @param wire_version 响应编码版本（与请求一致）
      */
     void handle_download_request(
         const DownloadRequestTransfer& download_request,
         int64_t request_id,
-        uint64_t connect_id);
+        uint64_t connect_id,
+        DaneJoe::SerializeVersion wire_version);
+    /**
+     * @brief 处理分块哈希清单请求
+     * @param manifest_request 清单请求
+     * @param request_id 请求ID
+     * @param connect_id 连接ID
+     * @param wire_version 响应编码版本（与请求一致）
+     * @details 清单在添加文件时已计算，此处只读取数据库；没有清单时返回空清单。
+     */
+    void handle_manifest_request(
+        const ManifestRequestTransfer& manifest_request,
+        int64_t request_id,
+        uint64_t connect_id,
+        DaneJoe::SerializeVersion wire_version);
+    /**
+     * @brief 处理差量请求
+     * @param delta_request 差量请求
+     * @param request_id 请求ID
+     * @param connect_id 连接ID
+     * @param wire_version 响应编码版本（与请求一致）
+     * @details 查询文件信息后将计算任务交给差量工作线程；文件不存在时直接返回空差量。
+     */
+    void handle_delta_request(
+        const DeltaRequestTransfer& delta_request,
+        int64_t request_id,
+        uint64_t connect_id,
+        DaneJoe::SerializeVersion wire_version);
     /**
      * @brief 处理测试请求
      * @param test_request 测试请求
      * @param request 请求ID
      * @param connect_id 连接ID
+     * @param wire_version 响应编码版本（与请求一致）
      */
     void handle_test_request(
         const TestRequestTransfer& test_request,
         int64_t request,
-        uint64_t connect_id);
+        uint64_t connect_id,
+        DaneJoe::SerializeVersion wire_version);
+    /**
+     * @brief 处理指标请求
+     * @param request_id 请求ID
+     * @param connect_id 连接ID
+     * @param wire_version 响应编码版本（与请求一致）
+     * @details 返回当前进程指标快照的文本形式，放在测试响应的 message 字段中。
+     */
+    void handle_metrics_request(
+        int64_t request_id,
+        uint64_t connect_id,
+        DaneJoe::SerializeVersion wire_version);
     /**
      * @brief 处理块请求
      * @param block_request 块请求
      * @param request_id 请求ID
      * @param connect_id 连接ID
+     * @param wire_version 响应编码版本（与请求一致）
      */
     void handle_block_request(
         const BlockRequestTransfer& block_request,
         int64_t request_id,
-        uint64_t connect_id);
+        uint64_t connect_id,
+        DaneJoe::SerializeVersion wire_version);
+    /**
+     * @brief 执行块读取任务
+     * @param block_task 块读取任务
+     * @details 在块工作线程中读取文件数据并将块响应推送到发送队列。
+     */
+    void handle_block_task(const BlockTask& block_task);
+    /**
+     * @brief 执行差量计算任务
+     * @param delta_task 差量计算任务
+     * @details 在差量工作线程中多线程滚动匹配文件并推送差量响应；
+     *          签名无效或字面数据超过上限时返回空差量，客户端改为按块下载。
+     */
+    void handle_delta_task(const DeltaTask& delta_task);
+private:
+    /**
+     * @brief 投递响应帧
+     * @param connect_id 连接ID
+     * @param request_id 请求ID
+     * @param data 已编码的响应数据
+     */
+    void push_response(uint64_t connect_id, int64_t request_id, std::vector<uint8_t>&& data);
+    /**
+     * @brief 补记请求帧在 IO 线程与邮箱中的跟踪点
+     * @param frame_trace 帧跟踪信息
+     * @param connect_id 连接ID
+     * @param request_id 请求ID
+     */
+    void record_frame_trace(const DaneJoe::FrameTrace& frame_trace, uint64_t connect_id, int64_t request_id);
+    /**
+     * @brief 块工作线程主循环
+     */
+    void run_block_worker();
+    /**
+     * @brief 差量工作线程主循环
+     */
+    void run_delta_worker();
 private:
     /// @brief 是否正在运行
     std::atomic<bool> m_is_running = false;
@@ -89,4 +219,20 @@ private:
     ServerMessageCodec m_message_codec;
     /// @brief 服务器文件信息服务
     ServerFileInfoService m_file_info_service;
+    /// @brief 文件分块哈希清单服务
+    FileManifestService m_file_manifest_service;
+    /// @brief 块工作线程数量
+    int m_block_worker_count = 2;
+    /// @brief 块读取任务队列
+    DaneJoe::MpmcBoundedQueue<BlockTask> m_block_task_queue = DaneJoe::MpmcBoundedQueue<BlockTask>(64);
+    /// @brief 块工作线程
+    std::vector<std::thread> m_block_workers;
+    /// @brief 单个差量计算使用的匹配线程数（<=0 时使用硬件并发数）
+    int m_delta_match_thread_count = 0;
+    /// @brief 差量字面数据上限，超过时不使用差量（差量在单个响应中返回）
+    int64_t m_max_delta_literal_bytes = 64 * 1024 * 1024;
+    /// @brief 差量计算任务队列
+    DaneJoe::MpmcBoundedQueue<DeltaTask> m_delta_task_queue = DaneJoe::MpmcBoundedQueue<DeltaTask>(8);
+    /// @brief 差量工作线程
+    std::thread m_delta_worker;
 };
\ No newline at end of file
@@ -8,6 +8,8 @@
 #pragma once
 
 #include <memory>
+#include <string>
+#include <cstdint>
 
 #include "danejoe/network/event_loop/posix_epoll_event_loop.hpp"
 #include "danejoe/network/runtime/reactor_mail_box.hpp"
@@ -22,9 +24,16 @@ public:
     /**
      * @brief 构造函数
      * @param reactor_mail_box 反应器邮箱
+     * @param listen_ip 监听地址
+     * @param listen_port 监听端口
+     * @param is_frame_chunking_enabled 是否将大响应分片发送
+     * @details 分片帧需要对端支持重组，默认关闭以兼容旧客户端。
      */
     NetworkRuntime(
-        std::shared_ptr<DaneJoe::ReactorMailBox> reactor_mail_box);
+        std::shared_ptr<DaneJoe::ReactorMailBox> reactor_mail_box,
+        const std::string& listen_ip = "127.0.0.1",
+        uint16_t listen_port = 8080,
+        bool is_frame_chunking_enabled = false);
     /**
      * @brief 初始化
      */
@@ -47,6 +56,12 @@ private:
     DaneJoe::PosixEpollEventLoop m_event_loop;
     /// @brief 反应器邮箱
     std::shared_ptr<DaneJoe::ReactorMailBox> m_reactor_mail_box = nullptr;
+    /// @brief 监听地址
+    std::string m_listen_ip;
+    /// @brief 监听端口
+    uint16_t m_listen_port = 8080;
+    /// @brief 是否将大响应分片发送
+    bool m_is_frame_chunking_enabled = false;
     /// @brief 是否已初始化
     bool m_is_init = false;
 };
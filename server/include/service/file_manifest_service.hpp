@@ -0,0 +1,60 @@
+/**
+ * @file file_manifest_service.hpp
+ * @author DaneJoe001 (danejoe001.github)
+ * @brief 文件分块哈希清单服务
+ * @date 2026-01-07
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <optional>
+
+#include "repository/file_manifest_repository.hpp"
+
+/**
+ * @class FileManifestService
+ * @brief 文件分块哈希清单服务
+ */
+class FileManifestService
+{
+public:
+    /**
+     * @brief 初始化
+     */
+    void init();
+    /**
+     * @brief 计算并保存文件的分块哈希清单
+     * @param file_id 文件ID
+     * @param resource_path 文件路径
+     * @return 是否成功
+     * @details 按 DaneJoe::ChunkManifest::DEFAULT_CHUNK_SIZE 分块，使用全部硬件线程并行计算。
+     */
+    bool build(int32_t file_id, const std::string& resource_path);
+    /**
+     * @brief 保存已计算好的清单
+     * @param file_id 文件ID
+     * @param manifest 清单（移动接管）
+     * @return 是否成功
+     * @details 供在其他线程上计算清单、回到本线程再落库的调用方使用。
+     */
+    bool save(int32_t file_id, DaneJoe::ChunkManifest manifest);
+    /**
+     * @brief 获取清单
+     * @param file_id 文件ID
+     * @return 清单
+     */
+    std::optional<FileManifestEntity> get_by_file_id(int32_t file_id);
+    /**
+     * @brief 删除清单
+     * @param file_id 文件ID
+     * @return 是否删除成功
+     */
+    bool remove(int32_t file_id);
+private:
+    /// @brief 清单仓库
+    FileManifestRepository file_manifest_repository;
+    /// @brief 判断是否已初始化
+    bool is_init = false;
+};
@@ -7,9 +7,14 @@
 
 #pragma once
 
+#include <thread>
+#include <optional>
+
 #include <QDialog>
+#include <QString>
 
 #include "service/server_file_info_service.hpp"
+#include "service/file_manifest_service.hpp"
 
 namespace Ui
 {
@@ -24,6 +29,8 @@ class QHBoxLayout;
 /**
  * @class AddFileDialog
  * @brief 添加文件对话框
+ * @details 整文件 MD5 与分块哈希清单在后台线程计算，完成后回到界面线程登记文件并更新表格模型；
+ *          计算期间禁用添加按钮。
  */
 class AddFileDialog : public QDialog
 {
@@ -34,6 +41,11 @@ public:
      * @param parent 父对象
      */
     AddFileDialog(QWidget* parent = nullptr);
+    /**
+     * @brief 析构
+     * @details 等待后台计算线程结束。
+     */
+    ~AddFileDialog();
     /**
      * @brief 初始化
      */
@@ -47,6 +59,14 @@ public slots:
      * @brief 添加文件按钮点击
      */
     void on_add_file_button_clicked();
+private:
+    /**
+     * @brief 后台计算完成
+     * @param file_path 文件路径
+     * @param md5 整文件 MD5（十六进制），读取失败时为空
+     * @param manifest 分块哈希清单，计算失败时为空
+     */
+    void on_file_hashed(const QString& file_path, std::optional<QString> md5, std::optional<DaneJoe::ChunkManifest> manifest);
 private:
     /// @brief 文件路径标签
     QLabel* m_file_path_label;
@@ -62,6 +82,10 @@ private:
     QHBoxLayout* m_file_path_layout;
     /// @brief 文件信息服务
     ServerFileInfoService m_file_info_service;
+    /// @brief 文件分块哈希清单服务
+    FileManifestService m_file_manifest_service;
+    /// @brief 后台计算线程
+    std::thread m_hash_thread;
     /// @brief 是否已初始化
     bool m_is_init = false;
 };
\ No newline at end of file
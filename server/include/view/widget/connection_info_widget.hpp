@@ -7,11 +7,18 @@
 
 #pragma once
 
+#include <cstdint>
+
 #include <QWidget>
 
+class QLabel;
+class QVBoxLayout;
+class QTimerEvent;
+
 /**
  * @class ConnectionInfoWidget
  * @brief 连接信息小部件
+ * @details 每秒轮询指标注册表，显示连接数、收发字节与帧数及邮箱队列深度。
  */
 class ConnectionInfoWidget : public QWidget {
     Q_OBJECT
@@ -25,7 +32,21 @@ public:
      * @brief 初始化
      */
     void init();
+protected:
+    /**
+     * @brief 定时刷新指标
+     * @param event 定时器事件
+     */
+    void timerEvent(QTimerEvent* event) override;
 private:
+    /// @brief 指标标签
+    QLabel* m_metrics_label = nullptr;
+    /// @brief 布局
+    QVBoxLayout* m_layout = nullptr;
+    /// @brief 上次刷新时的接收字节数
+    uint64_t m_last_bytes_in = 0;
+    /// @brief 上次刷新时的发送字节数
+    uint64_t m_last_bytes_out = 0;
     /// @brief 是否已初始化
     bool m_is_init = false;
 };
\ No newline at end of file
@@ -10,12 +10,15 @@
 #include <QWidget>
 
 class ServerFileInfoTableModel;
+class QLabel;
 class QTableView;
 class QVBoxLayout;
+class QTimerEvent;
 
 /**
  * @class ResourceInfoWidget
  * @brief 资源信息小部件
+ * @details 表格下方每秒刷新各路径请求数、块读取量与数据库查询延迟。
  */
 class ResourceInfoWidget : public QWidget {
 public:
@@ -30,11 +33,19 @@ public:
      * @brief 初始化
      */
     void init();
+protected:
+    /**
+     * @brief 定时刷新指标
+     * @param event 定时器事件
+     */
+    void timerEvent(QTimerEvent* event) override;
 private:
     /// @brief 模型
     ServerFileInfoTableModel* m_model = nullptr;
     /// @brief 表格视图
     QTableView* m_table_view = nullptr;
+    /// @brief 指标标签
+    QLabel* m_metrics_label = nullptr;
     /// @brief 布局
     QVBoxLayout* m_layout = nullptr;
     /// @brief 是否已初始化
@@ -0,0 +1,332 @@
+/**
+ * @file headless_main.cpp
+ * @author DaneJoe001 (danejoe001.github)
+ * @brief 无界面服务端入口
+ * @date 2026-01-11
+ * @details 不依赖 Qt，仅启动网络运行时与业务运行时，供压测与无桌面环境部署使用。
+ *          启动时可通过 --register 登记资源文件，每个文件输出一行 `registered file_id=.. size=.. md5=.. path=..`；
+ *          监听成功后输出 `listening <ip>:<port>`。
+ *          收到 SIGUSR1 时输出 `stats allocations=<n>`，收到 SIGINT/SIGTERM 时停止运行时并退出。
+ *          指定 --trace 时启用请求跟踪，退出时将各请求的分段耗时写为 Chrome trace JSON。
+ *          指定 --chunk-frames 时大响应分片发送，默认关闭以兼容不支持分片重组的旧客户端。
+ */
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+#include <cstdint>
+#include <fstream>
+#include <optional>
+#include <exception>
+#include <filesystem>
+#include <string_view>
+
+#include <danejoe/logger/logger_manager.hpp>
+#include <danejoe/logger/logger_config.hpp>
+#include <danejoe/database/sql_database_manager.hpp>
+#include <danejoe/database/sql_config.hpp>
+#include <danejoe/database/sqlite_driver.hpp>
+#include <danejoe/common/hash/md5.hpp>
+#include <danejoe/common/system/allocation_counter.hpp>
+#include <danejoe/common/diagnostic/trace_recorder.hpp>
+
+#include "repository/server_file_info_repository.hpp"
+#include "repository/file_manifest_repository.hpp"
+#include "service/server_file_info_service.hpp"
+#include "service/file_manifest_service.hpp"
+#include "runtime/business_runtime.hpp"
+#include "runtime/network_runtime.hpp"
+
+namespace fs = std::filesystem;
+
+namespace
+{
+    /// @brief 收到 SIGINT/SIGTERM 后置位
+    volatile std::sig_atomic_t g_is_stop_requested = 0;
+    /// @brief 收到 SIGUSR1 后置位，由主线程输出统计
+    volatile std::sig_atomic_t g_is_stats_requested = 0;
+
+    void handle_stop_signal(int)
+    {
+        g_is_stop_requested = 1;
+    }
+
+    void handle_stats_signal(int)
+    {
+        g_is_stats_requested = 1;
+    }
+
+    void print_usage(const char* program)
+    {
+        std::fprintf(stderr,
+            "Usage: %s [options]\n"
+            "Options:\n"
+            "  --ip <address>      listen address (default 127.0.0.1)\n"
+            "  --port <port>       listen port (default 8080)\n"
+            "  --database <path>   database file, recreated on start (default ./database/server/server_database.db)\n"
+            "  --register <path>   register a resource file, may be repeated\n"
+            "  --trace <path>      record per-request trace points, written as Chrome trace JSON on exit\n"
+            "  --chunk-frames      send large responses as interleaved 64KB chunks (clients must support reassembly)\n"
+            "  -v                  verbose logging\n",
+            program);
+    }
+
+    void configure_logger(bool is_verbose)
+    {
+        DaneJoe::LoggerConfig config;
+        config.console_level = is_verbose ? DaneJoe::LogLevel::INFO : DaneJoe::LogLevel::WARN;
+        config.enable_file = false;
+        auto logger = DaneJoe::LoggerManager::get_instance().get_logger("default");
+        if (logger)
+        {
+            logger->set_config(config);
+        }
+    }
+
+    bool init_database(const std::string& database_path)
+    {
+        fs::path path(database_path);
+        std::error_code error_code;
+        fs::remove(path, error_code);
+        if (path.has_parent_path())
+        {
+            fs::create_directories(path.parent_path(), error_code);
+        }
+        DaneJoe::SqlConfig config;
+        config.database_name = "server_database";
+        config.path = database_path;
+        auto& database_manager = DaneJoe::SqlDatabaseManager::get_instance();
+        database_manager.add_database("server_database", std::make_shared<DaneJoe::SqliteDriver>());
+        auto database = database_manager.get_database("server_database");
+        if (!database)
+        {
+            return false;
+        }
+        database->set_config(config);
+        database->connect();
+        ServerFileInfoRepository file_info_repository;
+        file_info_repository.init();
+        FileManifestRepository file_manifest_repository;
+        file_manifest_repository.init();
+        return file_info_repository.ensure_table_exists() && file_manifest_repository.ensure_table_exists();
+    }
+
+    std::optional<std::string> compute_file_md5(const std::string& path)
+    {
+        std::ifstream fin(path, std::ios::in | std::ios::binary);
+        if (!fin.is_open())
+        {
+            return std::nullopt;
+        }
+        DaneJoe::Md5 md5;
+        std::vector<char> buffer(1024 * 1024);
+        while (fin)
+        {
+            fin.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+            md5.update(reinterpret_cast<const uint8_t*>(buffer.data()), static_cast<std::size_t>(fin.gcount()));
+        }
+        return md5.get_hex_digest();
+    }
+
+    /**
+     * @brief 登记资源文件
+     * @details 与添加文件对话框一致：登记后以当前记录数作为文件ID，并构建分块哈希清单。
+     */
+    bool register_file(
+        const std::string& path,
+        ServerFileInfoService& file_info_service,
+        FileManifestService& file_manifest_service)
+    {
+        std::error_code error_code;
+        auto file_size = fs::file_size(path, error_code);
+        auto md5_code = error_code ? std::nullopt : compute_file_md5(path);
+        if (!md5_code.has_value())
+        {
+            std::fprintf(stderr, "Cannot read %s\n", path.c_str());
+            return false;
+        }
+        ServerFileInfo file_info;
+        file_info.file_name = fs::path(path).filename().string();
+        file_info.resource_path = fs::absolute(path).string();
+        file_info.file_size = static_cast<uint32_t>(file_size);
+        file_info.md5_code = md5_code.value();
+        if (!file_info_service.add(file_info))
+        {
+            std::fprintf(stderr, "Failed to register %s\n", path.c_str());
+            return false;
+        }
+        file_info.file_id = file_info_service.count();
+        if (!file_manifest_service.build(file_info.file_id, file_info.resource_path))
+        {
+            DANEJOE_LOG_WARN("default", "ServerHeadless", "Failed to build manifest for {}", file_info.resource_path);
+        }
+        std::printf("registered file_id=%d size=%llu md5=%s path=%s\n",
+            file_info.file_id,
+            static_cast<unsigned long long>(file_size),
+            file_info.md5_code.c_str(),
+            file_info.resource_path.c_str());
+        return true;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    std::string listen_ip = "127.0.0.1";
+    uint16_t listen_port = 8080;
+    std::string database_path = "./database/server/server_database.db";
+    std::vector<std::string> register_paths;
+    std::string trace_path;
+    bool is_verbose = false;
+    bool is_frame_chunking_enabled = false;
+    for (int i = 1; i < argc; i++)
+    {
+        std::string_view argument = argv[i];
+        if (argument == "-h" || argument == "--help")
+        {
+            print_usage(argv[0]);
+            return 0;
+        }
+        if (argument == "-v")
+        {
+            is_verbose = true;
+            continue;
+        }
+        if (argument == "--chunk-frames")
+        {
+            is_frame_chunking_enabled = true;
+            continue;
+        }
+        if (i + 1 >= argc)
+        {
+            std::fprintf(stderr, "Option %s requires a value\n", argv[i]);
+            return 2;
+        }
+        std::string value = argv[++i];
+        if (argument == "--ip")
+        {
+            listen_ip = value;
+        }
+        else if (argument == "--port")
+        {
+            int port = 0;
+            try
+            {
+                port = std::stoi(value);
+            }
+            catch (const std::exception&)
+            {
+                port = 0;
+            }
+            if (port <= 0 || port > 65535)
+            {
+                std::fprintf(stderr, "Invalid port: %s\n", value.c_str());
+                return 2;
+            }
+            listen_port = static_cast<uint16_t>(port);
+        }
+        else if (argument == "--database")
+        {
+            database_path = value;
+        }
+        else if (argument == "--register")
+        {
+            register_paths.push_back(value);
+        }
+        else if (argument == "--trace")
+        {
+            trace_path = value;
+        }
+        else
+        {
+            std::fprintf(stderr, "Unknown option %s\n", argv[i - 1]);
+            print_usage(argv[0]);
+            return 2;
+        }
+    }
+    configure_logger(is_verbose);
+    if (!init_database(database_path))
+    {
+        std::fprintf(stderr, "Failed to open database %s\n", database_path.c_str());
+        return 1;
+    }
+    ServerFileInfoService file_info_service;
+    file_info_service.init();
+    FileManifestService file_manifest_service;
+    file_manifest_service.init();
+    for (const auto& path : register_paths)
+    {
+        if (!register_file(path, file_info_service, file_manifest_service))
+        {
+            return 1;
+        }
+    }
+
+    if (!trace_path.empty())
+    {
+        DaneJoe::TraceRecorder::get_instance().set_enabled(true);
+    }
+
+    auto reactor_mail_box = std::make_shared<DaneJoe::ReactorMailBox>();
+    auto network_runtime = std::make_shared<NetworkRuntime>(reactor_mail_box, listen_ip, listen_port, is_frame_chunking_enabled);
+    network_runtime->init();
+    if (!network_runtime->is_init())
+    {
+        std::fprintf(stderr, "Failed to listen on %s:%u\n", listen_ip.c_str(), static_cast<unsigned>(listen_port));
+        return 1;
+    }
+    auto business_runtime = std::make_shared<BusinessRuntime>(reactor_mail_box);
+    business_runtime->init();
+    std::thread business_thread([business_runtime]()
+        {
+            business_runtime->run();
+        });
+    std::thread network_thread([network_runtime]()
+        {
+            network_runtime->run();
+        });
+
+    std::signal(SIGINT, handle_stop_signal);
+    std::signal(SIGTERM, handle_stop_signal);
+    std::signal(SIGUSR1, handle_stats_signal);
+    std::printf("listening %s:%u\n", listen_ip.c_str(), static_cast<unsigned>(listen_port));
+    std::fflush(stdout);
+    while (!g_is_stop_requested)
+    {
+        if (g_is_stats_requested)
+        {
+            g_is_stats_requested = 0;
+            std::printf("stats allocations=%llu\n", static_cast<unsigned long long>(DaneJoe::get_allocation_count()));
+            std::fflush(stdout);
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+
+    network_runtime->stop();
+    business_runtime->stop();
+    // 业务线程阻塞在邮箱的接收队列上，关闭邮箱后才会退出
+    reactor_mail_box->stop();
+    if (business_thread.joinable())
+    {
+        business_thread.join();
+    }
+    if (network_thread.joinable())
+    {
+        network_thread.join();
+    }
+    if (!trace_path.empty())
+    {
+        auto& trace_recorder = DaneJoe::TraceRecorder::get_instance();
+        trace_recorder.set_enabled(false);
+        if (!trace_recorder.dump_chrome_trace(trace_path))
+        {
+            std::fprintf(stderr, "Failed to write trace %s\n", trace_path.c_str());
+            return 1;
+        }
+        std::printf("trace written %s dropped=%llu\n",
+            trace_path.c_str(),
+            static_cast<unsigned long long>(trace_recorder.get_dropped_count()));
+    }
+    return 0;
+}
@@ -10,6 +10,7 @@
 #include <danejoe/database/sqlite_driver.hpp>
 
 #include "repository/server_file_info_repository.hpp"
+#include "repository/file_manifest_repository.hpp"
 #include "main/server_app.hpp"
 #include "view/widget/server_main_window.hpp"
 #include "runtime/business_runtime.hpp"
@@ -202,6 +203,12 @@ void ServerApp::init_database()
     {
         DANEJOE_LOG_ERROR("default", "Server", "Failed to create table file_info");
     }
+    FileManifestRepository file_manifest_repository;
+    file_manifest_repository.init();
+    if (!file_manifest_repository.ensure_table_exists())
+    {
+        DANEJOE_LOG_ERROR("default", "Server", "Failed to create table file_manifest");
+    }
 }
 void ServerApp::clear_database()
 {
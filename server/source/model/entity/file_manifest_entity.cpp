@@ -0,0 +1,9 @@
+#include <format>
+
+#include "model/entity/file_manifest_entity.hpp"
+
+std::string FileManifestEntity::to_string() const
+{
+    return std::format("file_id: {}, file_size: {}, chunk_size: {}, chunk_count: {}, root_hash: {:016x}",
+        file_id, manifest.file_size, manifest.chunk_size, manifest.chunk_hashes.size(), manifest.get_root_hash());
+}
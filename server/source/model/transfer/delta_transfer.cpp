@@ -0,0 +1,14 @@
+#include <format>
+
+#include "model/transfer/delta_transfer.hpp"
+
+std::string DeltaRequestTransfer::to_string() const
+{
+    return std::format("file_id={} | task_id={} | signature_size={}", file_id, task_id, signature.size());
+}
+
+std::string DeltaResponseTransfer::to_string() const
+{
+    return std::format("file_id={} | task_id={} | file_size={} | md5_code={} | delta_size={}",
+        file_id, task_id, file_size, md5_code, delta.size());
+}
@@ -0,0 +1,32 @@
+#include "protocol/message_field_tag.hpp"
+
+std::shared_ptr<const DaneJoe::SerializeFieldTagTable> get_message_field_tag_table()
+{
+    static const auto table = std::make_shared<const DaneJoe::SerializeFieldTagTable>(
+        std::initializer_list<std::pair<uint32_t, std::string>>{
+            // 信封字段
+            { 1, "version" },
+            { 2, "request_id" },
+            { 3, "request_type" },
+            { 4, "path" },
+            { 5, "content_type" },
+            { 6, "body" },
+            { 7, "status" },
+            // 业务字段
+            { 16, "block_id" },
+            { 17, "file_id" },
+            { 18, "task_id" },
+            { 19, "offset" },
+            { 20, "block_size" },
+            { 21, "data" },
+            { 22, "file_name" },
+            { 23, "file_size" },
+            { 24, "md5_code" },
+            { 25, "message" },
+            { 26, "chunk_size" },
+            { 27, "chunk_hashes" },
+            { 28, "signature" },
+            { 29, "delta" },
+        });
+    return table;
+}
@@ -2,12 +2,84 @@
 #include "danejoe/network/codec/serialize_codec.hpp"
 
 #include "protocol/server_message_codec.hpp"
+#include "protocol/message_field_tag.hpp"
+
+DaneJoe::SerializeVersion ServerMessageCodec::get_wire_version(const std::vector<uint8_t>& data)
+{
+    DaneJoe::SerializeCodec serializer;
+    auto header_opt = serializer.get_message_header(data);
+    if (header_opt.has_value() && header_opt->version == static_cast<uint8_t>(DaneJoe::SerializeVersion::Compact))
+    {
+        return DaneJoe::SerializeVersion::Compact;
+    }
+    return DaneJoe::SerializeVersion::Named;
+}
+
+DaneJoe::SerializeConfig ServerMessageCodec::get_serialize_config(DaneJoe::SerializeVersion wire_version)const
+{
+    DaneJoe::SerializeConfig config;
+    config.version = wire_version;
+    config.field_tag_table = get_message_field_tag_table();
+    return config;
+}
+
+namespace
+{
+    /**
+     * @brief 获取当前线程的消息体构建编码器
+     * @note 块工作线程并发编码，编码器按线程持有，构建缓冲区在消息间复用
+     */
+    DaneJoe::SerializeCodec& get_thread_body_codec()
+    {
+        thread_local DaneJoe::SerializeCodec codec;
+        return codec;
+    }
+    /**
+     * @brief 获取当前线程的信封构建编码器
+     */
+    DaneJoe::SerializeCodec& get_thread_envelope_codec()
+    {
+        thread_local DaneJoe::SerializeCodec codec;
+        return codec;
+    }
+}
+
+DaneJoe::SerializeCodec& ServerMessageCodec::get_body_build_codec(DaneJoe::SerializeVersion wire_version)const
+{
+    DaneJoe::SerializeCodec& codec = get_thread_body_codec();
+    codec.reset_build();
+    codec.set_config(get_serialize_config(wire_version));
+    return codec;
+}
+
+DaneJoe::SerializeCodec& ServerMessageCodec::get_envelope_build_codec(std::size_t body_size, DaneJoe::SerializeVersion wire_version)const
+{
+    DaneJoe::SerializeCodec& codec = get_thread_envelope_codec();
+    codec.reset_build();
+    // 按消息体大小一次性预留，避免块响应构建过程中多次扩容
+    codec.ensure_enough_capacity_rest_to_build(static_cast<uint32_t>(body_size) + ENVELOPE_RESERVED_SIZE);
+    codec.set_config(get_serialize_config(wire_version));
+    return codec;
+}
+
+void ServerMessageCodec::recycle_frame_byte_array(std::vector<uint8_t>&& frame)const
+{
+    get_thread_envelope_codec().reset_build(std::move(frame));
+}
+
+std::vector<uint8_t> ServerMessageCodec::finish_response_byte_array(EnvelopeResponseTransfer&& envelope, DaneJoe::SerializeVersion wire_version)
+{
+    std::vector<uint8_t> data = build_response_byte_array(envelope, wire_version);
+    // 消息体缓冲区交还消息体编码器复用
+    get_thread_body_codec().reset_build(std::move(envelope.body));
+    return data;
+}
 
 std::optional<EnvelopeRequestTransfer> ServerMessageCodec::try_parse_byte_array_request(const std::vector<uint8_t>& data)
 {
     DANEJOE_LOG_TRACE("default", "ServerMessageCodec", "Parsing envelope request");
     EnvelopeRequestTransfer envelope;
-    DaneJoe::SerializeCodec serializer;
+    DaneJoe::SerializeCodec serializer(get_serialize_config());
     serializer.deserialize(data);
 
     auto version_field_opt = serializer.get_parsed_field("version");
@@ -99,7 +171,7 @@ std::optional<BlockRequestTransfer> ServerMessageCodec::try_parse_byte_array_blo
 {
     DANEJOE_LOG_TRACE("default", "ServerMessageCodec", "Parse block request");
     BlockRequestTransfer info;
-    DaneJoe::SerializeCodec serializer;
+    DaneJoe::SerializeCodec serializer(get_serialize_config());
     serializer.deserialize(data);
 
     auto block_id_field_op = serializer.get_parsed_field("block_id");
@@ -176,7 +248,7 @@ std::optional<DownloadRequestTransfer> ServerMessageCodec::try_parse_byte_array_
 {
     DANEJOE_LOG_TRACE("default", "ServerMessageCodec", "Parse download request");
     DownloadRequestTransfer info;
-    DaneJoe::SerializeCodec serializer;
+    DaneJoe::SerializeCodec serializer(get_serialize_config());
     serializer.deserialize(data);
 
     auto file_id_field_opt = serializer.get_parsed_field("file_id");
@@ -211,10 +283,90 @@ std::optional<DownloadRequestTransfer> ServerMessageCodec::try_parse_byte_array_
     return info;
 }
 
+std::optional<ManifestRequestTransfer> ServerMessageCodec::try_parse_byte_array_manifest_request(const std::vector<uint8_t>& data)
+{
+    DANEJOE_LOG_TRACE("default", "ServerMessageCodec", "Parse manifest request");
+    ManifestRequestTransfer info;
+    DaneJoe::SerializeCodec serializer(get_serialize_config());
+    serializer.deserialize(data);
+
+    auto file_id_field_opt = serializer.get_parsed_field("file_id");
+    auto task_id_field_opt = serializer.get_parsed_field("task_id");
+
+    if (!file_id_field_opt.has_value())
+    {
+        DANEJOE_LOG_ERROR("default", "ServerMessageCodec", "File id parse failed");
+        return std::nullopt;
+    }
+    auto file_id_op = DaneJoe::to_value<int64_t>(file_id_field_opt.value());
+    if (!file_id_op.has_value())
+    {
+        DANEJOE_LOG_ERROR("default", "ServerMessageCodec", "File id parse failed");
+        return std::nullopt;
+    }
+    info.file_id = file_id_op.value();
+
+    if (task_id_field_opt.has_value())
+    {
+        auto task_id_op = DaneJoe::to_value<int64_t>(task_id_field_opt.value());
+        if (task_id_op.has_value())
+        {
+            info.task_id = task_id_op.value();
+        }
+        else
+        {
+            DANEJOE_LOG_WARN("default", "ServerMessageCodec", "Task id parse failed");
+        }
+    }
+
+    return info;
+}
+
+std::optional<DeltaRequestTransfer> ServerMessageCodec::try_parse_byte_array_delta_request(const std::vector<uint8_t>& data)
+{
+    DANEJOE_LOG_TRACE("default", "ServerMessageCodec", "Parse delta request");
+    DeltaRequestTransfer info;
+    DaneJoe::SerializeCodec serializer(get_serialize_config());
+    serializer.deserialize(data);
+
+    auto file_id_field_opt = serializer.get_parsed_field("file_id");
+    auto task_id_field_opt = serializer.get_parsed_field("task_id");
+    auto signature_field_opt = serializer.get_parsed_field("signature");
+
+    if (!file_id_field_opt.has_value() || !signature_field_opt.has_value())
+    {
+        DANEJOE_LOG_ERROR("default", "ServerMessageCodec", "Delta field missing");
+        return std::nullopt;
+    }
+    auto file_id_op = DaneJoe::to_value<int64_t>(file_id_field_opt.value());
+    if (!file_id_op.has_value())
+    {
+        DANEJOE_LOG_ERROR("default", "ServerMessageCodec", "File id parse failed");
+        return std::nullopt;
+    }
+    info.file_id = file_id_op.value();
+    info.signature = DaneJoe::to_array<uint8_t>(signature_field_opt.value());
+
+    if (task_id_field_opt.has_value())
+    {
+        auto task_id_op = DaneJoe::to_value<int64_t>(task_id_field_opt.value());
+        if (task_id_op.has_value())
+        {
+            info.task_id = task_id_op.value();
+        }
+        else
+        {
+            DANEJOE_LOG_WARN("default", "ServerMessageCodec", "Task id parse failed");
+        }
+    }
+
+    return info;
+}
+
 std::optional<TestRequestTransfer> ServerMessageCodec::try_parse_byte_array_test_request(const std::vector<uint8_t>& data)
 {
     DANEJOE_LOG_TRACE("default", "ServerMessageCodec", "Parse test request");
-    DaneJoe::SerializeCodec serializer;
+    DaneJoe::SerializeCodec serializer(get_serialize_config());
     serializer.deserialize(data);
 
     auto message_field_op = serializer.get_parsed_field("message");
@@ -229,67 +381,105 @@ std::optional<TestRequestTransfer> ServerMessageCodec::try_parse_byte_array_test
     return info;
 }
 
-std::vector<uint8_t> ServerMessageCodec::build_response_byte_array(const EnvelopeResponseTransfer& response)
+std::vector<uint8_t> ServerMessageCodec::build_response_byte_array(const EnvelopeResponseTransfer& response, DaneJoe::SerializeVersion wire_version)
 {
-    DaneJoe::SerializeCodec serializer;
+    DaneJoe::SerializeCodec& serializer = get_envelope_build_codec(response.body.size(), wire_version);
     serializer.serialize(response.version, "version");
     serializer.serialize(response.request_id, "request_id");
     serializer.serialize(static_cast<uint16_t>(response.status), "status");
     serializer.serialize(static_cast<uint8_t>(response.content_type), "content_type");
     serializer.serialize(response.body, "body");
-    return serializer.get_serialized_data_vector_build();
+    return serializer.take_serialized_data_vector_build();
 }
 
-std::vector<uint8_t> ServerMessageCodec::build_block_response_byte_array(const BlockResponseTransfer& block_response, int64_t request_id)
+std::vector<uint8_t> ServerMessageCodec::build_block_response_byte_array(const BlockResponseTransfer& block_response, int64_t request_id, DaneJoe::SerializeVersion wire_version)
 {
-    DaneJoe::SerializeCodec body_serializer;
+    DaneJoe::SerializeCodec& body_serializer = get_body_build_codec(wire_version);
     body_serializer.serialize(block_response.block_id, "block_id");
     body_serializer.serialize(block_response.file_id, "file_id");
     body_serializer.serialize(block_response.task_id, "task_id");
     body_serializer.serialize(block_response.offset, "offset");
     body_serializer.serialize(block_response.block_size, "block_size");
     body_serializer.serialize(block_response.data, "data");
-    std::vector<uint8_t> body = body_serializer.get_serialized_data_vector_build();
+    std::vector<uint8_t> body = body_serializer.take_serialized_data_vector_build();
 
     EnvelopeResponseTransfer envelope;
-    envelope.version = 1;
+    envelope.version = ENVELOPE_VERSION;
     envelope.request_id = request_id;
     envelope.status = ResponseStatus::Ok;
     envelope.content_type = ContentType::DaneJoe;
-    envelope.body = body;
-    return build_response_byte_array(envelope);
+    envelope.body = std::move(body);
+    return finish_response_byte_array(std::move(envelope), wire_version);
 }
 
-std::vector<uint8_t> ServerMessageCodec::build_download_response_byte_array(const DownloadResponseTransfer& download_response, int64_t request_id)
+std::vector<uint8_t> ServerMessageCodec::build_download_response_byte_array(const DownloadResponseTransfer& download_response, int64_t request_id, DaneJoe::SerializeVersion wire_version)
 {
-    DaneJoe::SerializeCodec body_serializer;
+    DaneJoe::SerializeCodec& body_serializer = get_body_build_codec(wire_version);
     body_serializer.serialize(download_response.task_id, "task_id");
     body_serializer.serialize(download_response.file_id, "file_id");
     body_serializer.serialize(download_response.file_name, "file_name");
     body_serializer.serialize(download_response.file_size, "file_size");
     body_serializer.serialize(download_response.md5_code, "md5_code");
-    std::vector<uint8_t> body = body_serializer.get_serialized_data_vector_build();
+    std::vector<uint8_t> body = body_serializer.take_serialized_data_vector_build();
+
+    EnvelopeResponseTransfer envelope;
+    envelope.version = ENVELOPE_VERSION;
+    envelope.request_id = request_id;
+    envelope.status = ResponseStatus::Ok;
+    envelope.content_type = ContentType::DaneJoe;
+    envelope.body = std::move(body);
+    return finish_response_byte_array(std::move(envelope), wire_version);
+}
+
+std::vector<uint8_t> ServerMessageCodec::build_manifest_response_byte_array(const ManifestResponseTransfer& manifest_response, int64_t request_id, DaneJoe::SerializeVersion wire_version)
+{
+    DaneJoe::SerializeCodec& body_serializer = get_body_build_codec(wire_version);
+    body_serializer.serialize(manifest_response.task_id, "task_id");
+    body_serializer.serialize(manifest_response.file_id, "file_id");
+    body_serializer.serialize(manifest_response.file_size, "file_size");
+    body_serializer.serialize(manifest_response.chunk_size, "chunk_size");
+    body_serializer.serialize(manifest_response.chunk_hashes, "chunk_hashes");
+    std::vector<uint8_t> body = body_serializer.take_serialized_data_vector_build();
+
+    EnvelopeResponseTransfer envelope;
+    envelope.version = ENVELOPE_VERSION;
+    envelope.request_id = request_id;
+    envelope.status = ResponseStatus::Ok;
+    envelope.content_type = ContentType::DaneJoe;
+    envelope.body = std::move(body);
+    return finish_response_byte_array(std::move(envelope), wire_version);
+}
+
+std::vector<uint8_t> ServerMessageCodec::build_delta_response_byte_array(const DeltaResponseTransfer& delta_response, int64_t request_id, DaneJoe::SerializeVersion wire_version)
+{
+    DaneJoe::SerializeCodec& body_serializer = get_body_build_codec(wire_version);
+    body_serializer.serialize(delta_response.task_id, "task_id");
+    body_serializer.serialize(delta_response.file_id, "file_id");
+    body_serializer.serialize(delta_response.file_size, "file_size");
+    body_serializer.serialize(delta_response.md5_code, "md5_code");
+    body_serializer.serialize(delta_response.delta, "delta");
+    std::vector<uint8_t> body = body_serializer.take_serialized_data_vector_build();
 
     EnvelopeResponseTransfer envelope;
-    envelope.version = 1;
+    envelope.version = ENVELOPE_VERSION;
     envelope.request_id = request_id;
     envelope.status = ResponseStatus::Ok;
     envelope.content_type = ContentType::DaneJoe;
-    envelope.body = body;
-    return build_response_byte_array(envelope);
+    envelope.body = std::move(body);
+    return finish_response_byte_array(std::move(envelope), wire_version);
 }
 
-std::vector<uint8_t> ServerMessageCodec::build_test_response_byte_array(const TestResponseTransfer& test_response, int64_t request_id)
+std::vector<uint8_t> ServerMessageCodec::build_test_response_byte_array(const TestResponseTransfer& test_response, int64_t request_id, DaneJoe::SerializeVersion wire_version)
 {
-    DaneJoe::SerializeCodec body_serializer;
+    DaneJoe::SerializeCodec& body_serializer = get_body_build_codec(wire_version);
     body_serializer.serialize(test_response.message, "message");
-    std::vector<uint8_t> body = body_serializer.get_serialized_data_vector_build();
+    std::vector<uint8_t> body = body_serializer.take_serialized_data_vector_build();
 
     EnvelopeResponseTransfer envelope;
-    envelope.version = 1;
+    envelope.version = ENVELOPE_VERSION;
     envelope.request_id = request_id;
     envelope.status = ResponseStatus::Ok;
     envelope.content_type = ContentType::DaneJoe;
-    envelope.body = body;
-    return build_response_byte_array(envelope);
+    envelope.body = std::move(body);
+    return finish_response_byte_array(std::move(envelope), wire_version);
 }
\ No newline at end of file
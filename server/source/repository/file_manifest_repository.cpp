@@ -0,0 +1,126 @@
+#include <danejoe/logger/logger_manager.hpp>
+#include <danejoe/database/sql_database_manager.hpp>
+
+#include "repository/file_manifest_repository.hpp"
+
+FileManifestRepository::FileManifestRepository() {}
+FileManifestRepository::~FileManifestRepository() {}
+
+bool FileManifestRepository::ensure_table_exists()
+{
+    if (!m_query)
+    {
+        DANEJOE_LOG_TRACE("default", "FileManifestRepository", "Database not initialized");
+        return false;
+    }
+    m_query->prepare(R"(
+        CREATE TABLE IF NOT EXISTS file_manifest (
+            file_id INTEGER PRIMARY KEY,
+            file_size INTEGER NOT NULL,
+            chunk_size INTEGER NOT NULL,
+            root_hash INTEGER NOT NULL,
+            chunk_hashes BLOB
+        );
+    )");
+    return m_query->execute_command();
+}
+
+void FileManifestRepository::init()
+{
+    if (m_query)
+    {
+        DANEJOE_LOG_TRACE("default", "FileManifestRepository", "Database already initialized");
+        return;
+    }
+    m_database = DaneJoe::SqlDatabaseManager::get_instance().get_database("server_database");
+    m_query = std::make_shared<DaneJoe::SqlQuery>(m_database);
+}
+
+bool FileManifestRepository::save(const FileManifestEntity& manifest_entity)
+{
+    if (!m_query)
+    {
+        DANEJOE_LOG_TRACE("default", "FileManifestRepository", "Database not initialized");
+        return false;
+    }
+    const auto& manifest = manifest_entity.manifest;
+    m_query->prepare("INSERT OR REPLACE INTO file_manifest (file_id, file_size, chunk_size, root_hash, chunk_hashes) VALUES (?, ?, ?, ?, ?);");
+    m_query->reset();
+    m_query->bind(1, manifest_entity.file_id);
+    m_query->bind(2, manifest.file_size);
+    m_query->bind(3, manifest.chunk_size);
+    m_query->bind(4, static_cast<int64_t>(manifest.get_root_hash()));
+    m_query->bind(5, manifest.get_hash_bytes());
+    return m_query->execute_command();
+}
+
+std::optional<FileManifestEntity> FileManifestRepository::get_by_file_id(int32_t file_id)
+{
+    if (!m_query)
+    {
+        DANEJOE_LOG_TRACE("default", "FileManifestRepository", "Database not initialized");
+        return std::nullopt;
+    }
+    m_query->prepare("SELECT * FROM file_manifest WHERE file_id = ?;");
+    m_query->reset();
+    m_query->bind(1, file_id);
+    auto data = m_query->execute_query();
+    if (data.empty())
+    {
+        return std::nullopt;
+    }
+    FileManifestEntity manifest_entity;
+    int64_t root_hash = 0;
+    for (size_t j = 0; j < data[0].size(); j++)
+    {
+        if (data[0][j].column_name == "file_id")
+        {
+            manifest_entity.file_id = std::get<int64_t>(data[0][j].data);
+        }
+        else if (data[0][j].column_name == "file_size")
+        {
+            manifest_entity.manifest.file_size = std::get<int64_t>(data[0][j].data);
+        }
+        else if (data[0][j].column_name == "chunk_size")
+        {
+            manifest_entity.manifest.chunk_size = std::get<int64_t>(data[0][j].data);
+        }
+        else if (data[0][j].column_name == "root_hash")
+        {
+            root_hash = std::get<int64_t>(data[0][j].data);
+        }
+        else if (data[0][j].column_name == "chunk_hashes")
+        {
+            // 空文件没有块，BLOB 以 NULL 存储
+            if (auto chunk_hashes = std::get_if<std::vector<uint8_t>>(&data[0][j].data))
+            {
+                manifest_entity.manifest.set_hash_bytes(*chunk_hashes);
+            }
+        }
+    }
+    if (!manifest_entity.manifest.is_valid() ||
+        static_cast<int64_t>(manifest_entity.manifest.get_root_hash()) != root_hash)
+    {
+        DANEJOE_LOG_WARN("default", "FileManifestRepository", "Manifest of file {} is corrupted", file_id);
+        return std::nullopt;
+    }
+    return manifest_entity;
+}
+
+bool FileManifestRepository::remove(int32_t file_id)
+{
+    if (!m_query)
+    {
+        DANEJOE_LOG_TRACE("default", "FileManifestRepository", "Database not initialized");
+        return false;
+    }
+    m_query->prepare("DELETE FROM file_manifest WHERE file_id = ?;");
+    m_query->reset();
+    m_query->bind(1, file_id);
+    return m_query->execute_command();
+}
+
+bool FileManifestRepository::is_init()const
+{
+    return m_query != nullptr;
+}
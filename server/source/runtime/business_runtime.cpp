@@ -1,8 +1,62 @@
+#include <format>
 #include <fstream>
+#include <exception>
 
 #include "danejoe/logger/logger_manager.hpp"
+#include "danejoe/common/delta/file_delta.hpp"
+#include "danejoe/common/diagnostic/trace_recorder.hpp"
+#include "danejoe/metrics/metrics_registry.hpp"
 #include "runtime/business_runtime.hpp"
 
+namespace
+{
+    /**
+     * @struct BusinessMetrics
+     * @brief 业务请求指标
+     */
+    struct BusinessMetrics
+    {
+        /// @brief /download 请求数
+        DaneJoe::MetricsCounter& download_requests = get_request_counter("/download");
+        /// @brief /test 请求数
+        DaneJoe::MetricsCounter& test_requests = get_request_counter("/test");
+        /// @brief /manifest 请求数
+        DaneJoe::MetricsCounter& manifest_requests = get_request_counter("/manifest");
+        /// @brief /delta 请求数
+        DaneJoe::MetricsCounter& delta_requests = get_request_counter("/delta");
+        /// @brief /block 请求数
+        DaneJoe::MetricsCounter& block_requests = get_request_counter("/block");
+        /// @brief /metrics 请求数
+        DaneJoe::MetricsCounter& metrics_requests = get_request_counter("/metrics");
+        /// @brief 未知路径请求数
+        DaneJoe::MetricsCounter& unknown_requests = get_request_counter("unknown");
+        /// @brief 解析失败的请求帧数
+        DaneJoe::MetricsCounter& parse_failures = DaneJoe::MetricsRegistry::get_instance().get_counter("server_request_parse_failures_total");
+        /// @brief 块读取次数
+        DaneJoe::MetricsCounter& block_reads = DaneJoe::MetricsRegistry::get_instance().get_counter("server_block_reads_total");
+        /// @brief 块读取字节数
+        DaneJoe::MetricsCounter& block_read_bytes = DaneJoe::MetricsRegistry::get_instance().get_counter("server_block_read_bytes_total");
+        /// @brief 块读取失败次数
+        DaneJoe::MetricsCounter& block_read_failures = DaneJoe::MetricsRegistry::get_instance().get_counter("server_block_read_failures_total");
+
+        /**
+         * @brief 获取请求路径对应的计数器
+         * @param path 请求路径
+         * @return 计数器引用
+         */
+        static DaneJoe::MetricsCounter& get_request_counter(std::string_view path)
+        {
+            return DaneJoe::MetricsRegistry::get_instance().get_counter(std::format("server_requests_total{{path=\"{}\"}}", path));
+        }
+    };
+
+    BusinessMetrics& get_business_metrics()
+    {
+        static BusinessMetrics metrics;
+        return metrics;
+    }
+}
+
 BusinessRuntime::BusinessRuntime(std::shared_ptr<DaneJoe::ReactorMailBox> reactor_mail_box) :
     m_reactor_mail_box(reactor_mail_box)
 {
@@ -11,11 +65,23 @@ BusinessRuntime::BusinessRuntime(std::shared_ptr<DaneJoe::ReactorMailBox> reacto
 void BusinessRuntime::init()
 {
     m_file_info_service.init();
+    m_file_manifest_service.init();
 }
 void BusinessRuntime::run()
 {
     DANEJOE_LOG_INFO("default", "BusinessRuntime", "Business runtime thread started");
     m_is_running.store(true);
+    for (int i = 0; i < m_block_worker_count; i++)
+    {
+        m_block_workers.emplace_back([this]()
+            {
+                run_block_worker();
+            });
+    }
+    m_delta_worker = std::thread([this]()
+        {
+            run_delta_worker();
+        });
     while (m_is_running)
     {
         auto frame_opt = m_reactor_mail_box->pop_from_to_server_frame();
@@ -23,59 +89,141 @@ void BusinessRuntime::run()
         {
             continue;
         }
+        auto& frame = frame_opt.value();
+        if (DaneJoe::TraceRecorder::get_instance().is_enabled())
+        {
+            frame.trace.popped_time = DaneJoe::TraceRecorder::now();
+        }
         DANEJOE_LOG_DEBUG("default", "BusinessRuntime", "Received frame: connect_id={}, size={}",
-            frame_opt.value().connect_id,
-            frame_opt.value().data.size());
-        handle_request(frame_opt.value().data, frame_opt.value().connect_id);
+            frame.connect_id,
+            frame.data.size());
+        handle_request(frame.data, frame.connect_id, frame.trace);
+    }
+    m_block_task_queue.close();
+    m_delta_task_queue.close();
+    for (auto& worker : m_block_workers)
+    {
+        if (worker.joinable())
+        {
+            worker.join();
+        }
+    }
+    m_block_workers.clear();
+    if (m_delta_worker.joinable())
+    {
+        m_delta_worker.join();
     }
     DANEJOE_LOG_WARN("default", "BusinessRuntime", "Business runtime thread exited");
 }
 void BusinessRuntime::stop()
 {
     m_is_running.store(false);
+    m_block_task_queue.close();
+    m_delta_task_queue.close();
+}
+
+void BusinessRuntime::run_block_worker()
+{
+    while (true)
+    {
+        auto block_task_opt = m_block_task_queue.pop();
+        if (!block_task_opt.has_value())
+        {
+            break;
+        }
+        handle_block_task(block_task_opt.value());
+    }
+}
+
+void BusinessRuntime::run_delta_worker()
+{
+    while (true)
+    {
+        auto delta_task_opt = m_delta_task_queue.pop();
+        if (!delta_task_opt.has_value())
+        {
+            break;
+        }
+        handle_delta_task(delta_task_opt.value());
+    }
 }
 
 void BusinessRuntime::handle_request(
     const std::vector<uint8_t>& frame_data,
-    uint64_t connect_id)
+    uint64_t connect_id,
+    const DaneJoe::FrameTrace& frame_trace)
 {
     auto request_opt = m_message_codec.try_parse_byte_array_request(frame_data);
+    auto& metrics = get_business_metrics();
     if (!request_opt.has_value())
     {
+        metrics.parse_failures.add();
         DANEJOE_LOG_WARN("default", "BusinessRuntime", "Parse request failed: connect_id={}, frame_size={}", connect_id, frame_data.size());
         return;
     }
     EnvelopeRequestTransfer request_transfer = request_opt.value();
+    record_frame_trace(frame_trace, connect_id, request_transfer.request_id);
+    // 响应使用与请求相同的编码版本，兼容只支持字段名编码的客户端
+    auto wire_version = m_message_codec.get_wire_version(frame_data);
     DANEJOE_LOG_DEBUG("default", "BusinessRuntime", "Received request: connect_id={}, {}", connect_id, request_transfer.to_string());
     if (request_transfer.path == "/download")
     {
+        metrics.download_requests.add();
         auto download_request_opt = m_message_codec.try_parse_byte_array_download_request(request_transfer.body);
         if (!download_request_opt.has_value())
         {
             return;
         }
-        handle_download_request(download_request_opt.value(), request_transfer.request_id, connect_id);
+        handle_download_request(download_request_opt.value(), request_transfer.request_id, connect_id, wire_version);
     }
     else if (request_transfer.path == "/test")
     {
+        metrics.test_requests.add();
         auto test_request_opt = m_message_codec.try_parse_byte_array_test_request(request_transfer.body);
         if (!test_request_opt.has_value())
         {
             return;
         }
-        handle_test_request(test_request_opt.value(), request_transfer.request_id, connect_id);
+        handle_test_request(test_request_opt.value(), request_transfer.request_id, connect_id, wire_version);
+    }
+    else if (request_transfer.path == "/manifest")
+    {
+        metrics.manifest_requests.add();
+        auto manifest_request_opt = m_message_codec.try_parse_byte_array_manifest_request(request_transfer.body);
+        if (!manifest_request_opt.has_value())
+        {
+            return;
+        }
+        handle_manifest_request(manifest_request_opt.value(), request_transfer.request_id, connect_id, wire_version);
+    }
+    else if (request_transfer.path == "/delta")
+    {
+        metrics.delta_requests.add();
+        auto delta_request_opt = m_message_codec.try_parse_byte_array_delta_request(request_transfer.body);
+        if (!delta_request_opt.has_value())
+        {
+            return;
+        }
+        handle_delta_request(delta_request_opt.value(), request_transfer.request_id, connect_id, wire_version);
     }
     else if (request_transfer.path == "/block")
     {
+        metrics.block_requests.add();
         auto block_request_opt = m_message_codec.try_parse_byte_array_block_request(request_transfer.body);
         if (!block_request_opt.has_value())
         {
             return;
         }
-        handle_block_request(block_request_opt.value(), request_transfer.request_id, connect_id);
+        handle_block_request(block_request_opt.value(), request_transfer.request_id, connect_id, wire_version);
+    }
+    else if (request_transfer.path == "/metrics")
+    {
+        metrics.metrics_requests.add();
+        handle_metrics_request(request_transfer.request_id, connect_id, wire_version);
     }
     else
     {
+        metrics.unknown_requests.add();
         handle_unknown_request();
     }
 }
@@ -85,9 +233,11 @@ void BusinessRuntime::handle_unknown_request()
 void BusinessRuntime::handle_download_request(
     const DownloadRequestTransfer& download_request,
     int64_t request_id,
-    uint64_t connect_id)
+    uint64_t connect_id,
+    DaneJoe::SerializeVersion wire_version)
 {
     auto file_entity_opt = m_file_info_service.get_by_id(download_request.file_id);
+    ADD_TRACE_POINT(DatabaseLookupDone, connect_id, request_id);
     if (!file_entity_opt.has_value())
     {
         DANEJOE_LOG_WARN("default", "BusinessRuntime", "Download request file not found: connect_id={}, request_id={}, file_id={}",
@@ -100,11 +250,8 @@ void BusinessRuntime::handle_download_request(
         response.file_name = "";
         response.file_size = 0;
         response.md5_code = "";
-        auto data = m_message_codec.build_download_response_byte_array(response, request_id);
-        if (m_reactor_mail_box)
-        {
-            m_reactor_mail_box->push_to_client_frame({ connect_id, data });
-        }
+        auto data = m_message_codec.build_download_response_byte_array(response, request_id, wire_version);
+        push_response(connect_id, request_id, std::move(data));
         return;
     }
     ServerFileInfo file_entity = file_entity_opt.value();
@@ -115,17 +262,133 @@ void BusinessRuntime::handle_download_request(
     response.file_name = file_entity.file_name;
     response.file_size = file_entity.file_size;
     response.md5_code = file_entity.md5_code;
-    auto data = m_message_codec.build_download_response_byte_array(response, request_id);
-    if (m_reactor_mail_box)
+    auto data = m_message_codec.build_download_response_byte_array(response, request_id, wire_version);
+    push_response(connect_id, request_id, std::move(data));
+}
+
+void BusinessRuntime::handle_manifest_request(
+    const ManifestRequestTransfer& manifest_request,
+    int64_t request_id,
+    uint64_t connect_id,
+    DaneJoe::SerializeVersion wire_version)
+{
+    ManifestResponseTransfer response;
+    response.file_id = manifest_request.file_id;
+    response.task_id = manifest_request.task_id;
+    auto manifest_entity_opt = m_file_manifest_service.get_by_file_id(static_cast<int32_t>(manifest_request.file_id));
+    ADD_TRACE_POINT(DatabaseLookupDone, connect_id, request_id);
+    if (manifest_entity_opt.has_value())
     {
-        m_reactor_mail_box->push_to_client_frame({ connect_id,data });
+        const auto& manifest = manifest_entity_opt->manifest;
+        response.file_size = manifest.file_size;
+        response.chunk_size = manifest.chunk_size;
+        response.chunk_hashes = manifest.get_hash_bytes();
     }
+    else
+    {
+        DANEJOE_LOG_WARN("default", "BusinessRuntime", "Manifest not found: connect_id={}, request_id={}, file_id={}",
+            connect_id,
+            request_id,
+            manifest_request.file_id);
+    }
+    auto data = m_message_codec.build_manifest_response_byte_array(response, request_id, wire_version);
+    push_response(connect_id, request_id, std::move(data));
+}
+
+void BusinessRuntime::handle_delta_request(
+    const DeltaRequestTransfer& delta_request,
+    int64_t request_id,
+    uint64_t connect_id,
+    DaneJoe::SerializeVersion wire_version)
+{
+    auto file_entity = m_file_info_service.get_by_id(delta_request.file_id);
+    ADD_TRACE_POINT(DatabaseLookupDone, connect_id, request_id);
+    if (!file_entity.has_value())
+    {
+        DANEJOE_LOG_WARN("default", "BusinessRuntime", "Delta request file not found: connect_id={}, request_id={}, file_id={}",
+            connect_id,
+            request_id,
+            delta_request.file_id);
+        DeltaResponseTransfer response;
+        response.file_id = delta_request.file_id;
+        response.task_id = delta_request.task_id;
+        auto data = m_message_codec.build_delta_response_byte_array(response, request_id, wire_version);
+        push_response(connect_id, request_id, std::move(data));
+        return;
+    }
+    DeltaTask delta_task;
+    delta_task.delta_request = delta_request;
+    delta_task.request_id = request_id;
+    delta_task.connect_id = connect_id;
+    delta_task.resource_path = file_entity->resource_path;
+    delta_task.md5_code = file_entity->md5_code;
+    delta_task.wire_version = wire_version;
+    if (!m_delta_task_queue.push(std::move(delta_task)))
+    {
+        DANEJOE_LOG_WARN("default", "BusinessRuntime", "Delta task queue closed: connect_id={}, request_id={}", connect_id, request_id);
+    }
+}
+
+void BusinessRuntime::handle_delta_task(const DeltaTask& delta_task)
+{
+    const auto& delta_request = delta_task.delta_request;
+    DeltaResponseTransfer response;
+    response.file_id = delta_request.file_id;
+    response.task_id = delta_request.task_id;
+    response.md5_code = delta_task.md5_code;
+    auto signature_opt = DaneJoe::FileSignature::decode(delta_request.signature);
+    std::optional<DaneJoe::FileDelta> delta_opt;
+    if (signature_opt.has_value())
+    {
+        // 差量工作线程没有上层异常处理，计算失败（如内存不足）时按空差量回复，客户端改为按块下载
+        try
+        {
+            delta_opt = DaneJoe::FileDelta::compute(delta_task.resource_path, signature_opt.value(), m_delta_match_thread_count);
+        }
+        catch (const std::exception& exception)
+        {
+            DANEJOE_LOG_ERROR("default", "BusinessRuntime", "Compute delta threw: connect_id={}, request_id={}, file_id={}, error={}",
+                delta_task.connect_id,
+                delta_task.request_id,
+                delta_request.file_id,
+                exception.what());
+            delta_opt.reset();
+        }
+    }
+    if (delta_opt.has_value())
+    {
+        response.file_size = delta_opt->file_size;
+        int64_t literal_bytes = delta_opt->get_literal_bytes();
+        DANEJOE_LOG_INFO("default", "BusinessRuntime", "Computed delta: connect_id={}, request_id={}, file_id={}, literal={}/{}, instructions={}",
+            delta_task.connect_id,
+            delta_task.request_id,
+            delta_request.file_id,
+            literal_bytes,
+            delta_opt->file_size,
+            delta_opt->instructions.size());
+        // 改动过大时按块下载更合适：可并行、可续传
+        if (literal_bytes <= m_max_delta_literal_bytes && literal_bytes < delta_opt->file_size)
+        {
+            response.delta = delta_opt->encode();
+        }
+    }
+    else
+    {
+        DANEJOE_LOG_WARN("default", "BusinessRuntime", "Failed to compute delta: connect_id={}, request_id={}, file_id={}, signature_size={}",
+            delta_task.connect_id,
+            delta_task.request_id,
+            delta_request.file_id,
+            delta_request.signature.size());
+    }
+    auto data = m_message_codec.build_delta_response_byte_array(response, delta_task.request_id, delta_task.wire_version);
+    push_response(delta_task.connect_id, delta_task.request_id, std::move(data));
 }
 
 void BusinessRuntime::handle_test_request(
     const TestRequestTransfer& test_request,
     int64_t request_id,
-    uint64_t connect_id)
+    uint64_t connect_id,
+    DaneJoe::SerializeVersion wire_version)
 {
     // 解析测试请求消息体
     auto message = test_request.message;
@@ -133,19 +396,30 @@ void BusinessRuntime::handle_test_request(
     TestResponseTransfer response;
     response.message = "Echo: " + message;
     // 构建测试响应,当前仅做回显
-    std::vector<uint8_t> data = m_message_codec.build_test_response_byte_array(response, request_id);
-    if (m_reactor_mail_box)
-    {
-        m_reactor_mail_box->push_to_client_frame({ connect_id,data });
-    }
+    auto data = m_message_codec.build_test_response_byte_array(response, request_id, wire_version);
+    push_response(connect_id, request_id, std::move(data));
+}
+
+void BusinessRuntime::handle_metrics_request(
+    int64_t request_id,
+    uint64_t connect_id,
+    DaneJoe::SerializeVersion wire_version)
+{
+    // 指标文本放在测试响应的 message 字段中返回，不单独定义响应模型
+    TestResponseTransfer response;
+    response.message = DaneJoe::MetricsRegistry::get_instance().get_snapshot().to_text();
+    auto data = m_message_codec.build_test_response_byte_array(response, request_id, wire_version);
+    push_response(connect_id, request_id, std::move(data));
 }
 
 void BusinessRuntime::handle_block_request(
     const BlockRequestTransfer& block_request,
     int64_t request_id,
-    uint64_t connect_id)
+    uint64_t connect_id,
+    DaneJoe::SerializeVersion wire_version)
 {
     auto file_entity = m_file_info_service.get_by_id(block_request.file_id);
+    ADD_TRACE_POINT(DatabaseLookupDone, connect_id, request_id);
     if (!file_entity.has_value())
     {
         DANEJOE_LOG_WARN("default", "BusinessRuntime", "Block request file not found: connect_id={}, request_id={}, file_id={}, block_id={}",
@@ -160,13 +434,28 @@ void BusinessRuntime::handle_block_request(
         response.offset = block_request.offset;
         response.block_size = 0;
         response.data = {};
-        auto data = m_message_codec.build_block_response_byte_array(response, request_id);
-        if (m_reactor_mail_box)
-        {
-            m_reactor_mail_box->push_to_client_frame({ connect_id, data });
-        }
+        auto data = m_message_codec.build_block_response_byte_array(response, request_id, wire_version);
+        push_response(connect_id, request_id, std::move(data));
         return;
     }
+    // 文件读取交给块工作线程，业务线程继续处理后续的轻量请求
+    BlockTask block_task;
+    block_task.block_request = block_request;
+    block_task.request_id = request_id;
+    block_task.connect_id = connect_id;
+    block_task.resource_path = file_entity->resource_path;
+    block_task.wire_version = wire_version;
+    if (!m_block_task_queue.push(std::move(block_task)))
+    {
+        DANEJOE_LOG_WARN("default", "BusinessRuntime", "Block task queue closed: connect_id={}, request_id={}", connect_id, request_id);
+    }
+}
+
+void BusinessRuntime::handle_block_task(const BlockTask& block_task)
+{
+    const auto& block_request = block_task.block_request;
+    int64_t request_id = block_task.request_id;
+    uint64_t connect_id = block_task.connect_id;
     BlockResponseTransfer response;
     response.block_id = block_request.block_id;
     response.file_id = block_request.file_id;
@@ -175,30 +464,65 @@ void BusinessRuntime::handle_block_request(
     response.block_size = block_request.block_size;
     response.data = std::vector<uint8_t>(block_request.block_size);
 
-    std::ifstream fin(file_entity->resource_path, std::ios::in | std::ios::binary);
+    std::ifstream fin(block_task.resource_path, std::ios::in | std::ios::binary);
     if (!fin.is_open())
     {
         DANEJOE_LOG_WARN("default", "BusinessRuntime", "Block request open file failed: connect_id={}, request_id={}, file_id={}, path={}",
             connect_id,
             request_id,
             block_request.file_id,
-            file_entity->resource_path);
+            block_task.resource_path);
+        get_business_metrics().block_read_failures.add();
         response.block_size = 0;
         response.data = {};
-        auto data = m_message_codec.build_block_response_byte_array(response, request_id);
-        if (m_reactor_mail_box)
-        {
-            m_reactor_mail_box->push_to_client_frame({ connect_id, data });
-        }
+        auto data = m_message_codec.build_block_response_byte_array(response, request_id, block_task.wire_version);
+        push_response(connect_id, request_id, std::move(data));
         return;
     }
     fin.seekg(block_request.offset);
     fin.read(reinterpret_cast<char*>(response.data.data()), block_request.block_size);
+    ADD_TRACE_POINT(FileReadDone, connect_id, request_id);
+    auto& metrics = get_business_metrics();
+    metrics.block_reads.add();
+    metrics.block_read_bytes.add(static_cast<uint64_t>(fin.gcount()));
 
-    auto data = m_message_codec.build_block_response_byte_array(response, request_id);
-    // 将块响应写入发送缓冲区
-    if (m_reactor_mail_box)
+    auto data = m_message_codec.build_block_response_byte_array(response, request_id, block_task.wire_version);
+    push_response(connect_id, request_id, std::move(data));
+}
+
+void BusinessRuntime::push_response(uint64_t connect_id, int64_t request_id, std::vector<uint8_t>&& data)
+{
+    ADD_TRACE_POINT(Encoded, connect_id, request_id);
+    if (!m_reactor_mail_box)
     {
-        m_reactor_mail_box->push_to_client_frame({ connect_id,data });
+        return;
+    }
+    DaneJoe::PosixFrame frame;
+    frame.connect_id = connect_id;
+    frame.data = std::move(data);
+    frame.trace.request_id = request_id;
+    m_reactor_mail_box->push_to_client_frame(frame);
+}
+
+void BusinessRuntime::record_frame_trace(const DaneJoe::FrameTrace& frame_trace, uint64_t connect_id, int64_t request_id)
+{
+    auto& trace_recorder = DaneJoe::TraceRecorder::get_instance();
+    // 跟踪在帧到达后才启用时，早期时间戳为 0，只补记已有的部分
+    if (!trace_recorder.is_enabled() || frame_trace.popped_time == 0)
+    {
+        return;
     }
-}
\ No newline at end of file
+    if (frame_trace.first_byte_time != 0)
+    {
+        trace_recorder.record(DaneJoe::TracePoint::FirstByteRead, connect_id, request_id, frame_trace.first_byte_time);
+    }
+    if (frame_trace.assembled_time != 0)
+    {
+        trace_recorder.record(DaneJoe::TracePoint::FrameAssembled, connect_id, request_id, frame_trace.assembled_time);
+    }
+    if (frame_trace.pushed_time != 0)
+    {
+        trace_recorder.record(DaneJoe::TracePoint::PushedToMailBox, connect_id, request_id, frame_trace.pushed_time);
+    }
+    trace_recorder.record(DaneJoe::TracePoint::PoppedByBusiness, connect_id, request_id, frame_trace.popped_time);
+}
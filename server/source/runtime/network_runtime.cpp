@@ -14,8 +14,14 @@ extern "C"
 }
 
 NetworkRuntime::NetworkRuntime(
-    std::shared_ptr<DaneJoe::ReactorMailBox> reactor_mail_box) :
-    m_reactor_mail_box(reactor_mail_box)
+    std::shared_ptr<DaneJoe::ReactorMailBox> reactor_mail_box,
+    const std::string& listen_ip,
+    uint16_t listen_port,
+    bool is_frame_chunking_enabled) :
+    m_reactor_mail_box(reactor_mail_box),
+    m_listen_ip(listen_ip),
+    m_listen_port(listen_port),
+    m_is_frame_chunking_enabled(is_frame_chunking_enabled)
 {}
 
 bool NetworkRuntime::is_init() const
@@ -52,10 +58,13 @@ void NetworkRuntime::init()
         DANEJOE_LOG_ERROR("default", "NetworkRuntime", "Failed to set server socket non blocking");
         return;
     }
+    // 服务端重启时跳过 TIME_WAIT 中的旧连接，压测反复启停时尤其需要
+    int reuse_address = 1;
+    ::setsockopt(server_handle.get_handle().get(), SOL_SOCKET, SO_REUSEADDR, &reuse_address, sizeof(reuse_address));
     sockaddr_in address;
     address.sin_family = AF_INET;
-    address.sin_port = ::htons(8080);
-    address.sin_addr.s_addr = ::inet_addr("127.0.0.1");
+    address.sin_port = ::htons(m_listen_port);
+    address.sin_addr.s_addr = ::inet_addr(m_listen_ip.c_str());
     auto bind_status =
         server_handle.bind((struct sockaddr*)&address, sizeof(address));
     if (bind_status.get_status_level() == DaneJoe::StatusLevel::Error)
@@ -63,17 +72,22 @@ void NetworkRuntime::init()
         DANEJOE_LOG_ERROR("default", "NetworkRuntime", "Failed to bind ip port");
         return;
     }
-    DANEJOE_LOG_INFO("default", "NetworkRuntime", "Bind success: 127.0.0.1:8080");
+    DANEJOE_LOG_INFO("default", "NetworkRuntime", "Bind success: {}:{}", m_listen_ip, m_listen_port);
+    // 并发建连时积压队列过短会导致 SYN 被丢弃、客户端按秒级重传
     auto listen_status =
-        server_handle.listen(5);
+        server_handle.listen(SOMAXCONN);
     if (listen_status.get_status_level() == DaneJoe::StatusLevel::Error)
     {
         DANEJOE_LOG_ERROR("default", "NetworkRuntime", "Failed to listen");
         return;
     }
-    DANEJOE_LOG_INFO("default", "NetworkRuntime", "Listen success, backlog=5");
+    DANEJOE_LOG_INFO("default", "NetworkRuntime", "Listen success, backlog={}", SOMAXCONN);
     m_event_loop.init(m_reactor_mail_box, event_handle, std::move(server_handle), std::move(epoll_handle));
-    DANEJOE_LOG_INFO("default", "NetworkRuntime", "Event loop initialized");
+    // 启用时大块响应按 64KB 分片与小响应交错发送，避免队头阻塞；旧客户端无法重组分片，因此需显式开启
+    DaneJoe::FrameChunkConfig chunk_config;
+    chunk_config.is_enabled = m_is_frame_chunking_enabled;
+    m_event_loop.set_chunk_config(chunk_config);
+    DANEJOE_LOG_INFO("default", "NetworkRuntime", "Event loop initialized, frame chunking: {}", m_is_frame_chunking_enabled);
     m_is_init = true;
 }
 void NetworkRuntime::run()
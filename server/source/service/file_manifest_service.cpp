@@ -0,0 +1,43 @@
+#include "danejoe/logger/logger_manager.hpp"
+
+#include "service/file_manifest_service.hpp"
+
+void FileManifestService::init()
+{
+    if (is_init)
+    {
+        return;
+    }
+    file_manifest_repository.init();
+    is_init = true;
+}
+
+bool FileManifestService::build(int32_t file_id, const std::string& resource_path)
+{
+    auto manifest_opt = DaneJoe::ChunkManifest::build_from_file(resource_path);
+    if (!manifest_opt.has_value())
+    {
+        DANEJOE_LOG_WARN("default", "FileManifestService", "Failed to build manifest of file {}: {}", file_id, resource_path);
+        return false;
+    }
+    return save(file_id, std::move(manifest_opt.value()));
+}
+
+bool FileManifestService::save(int32_t file_id, DaneJoe::ChunkManifest manifest)
+{
+    FileManifestEntity manifest_entity;
+    manifest_entity.file_id = file_id;
+    manifest_entity.manifest = std::move(manifest);
+    DANEJOE_LOG_INFO("default", "FileManifestService", "Built manifest: {}", manifest_entity.to_string());
+    return file_manifest_repository.save(manifest_entity);
+}
+
+std::optional<FileManifestEntity> FileManifestService::get_by_file_id(int32_t file_id)
+{
+    return file_manifest_repository.get_by_file_id(file_id);
+}
+
+bool FileManifestService::remove(int32_t file_id)
+{
+    return file_manifest_repository.remove(file_id);
+}
@@ -1,4 +1,5 @@
 #include <QFile>
+#include <QFileInfo>
 #include <QLabel>
 #include <QLineEdit>
 #include <QPushButton>
@@ -20,6 +21,14 @@ AddFileDialog::AddFileDialog(QWidget* parent) :QDialog(parent)
 {
 
 }
+
+AddFileDialog::~AddFileDialog()
+{
+    if (m_hash_thread.joinable())
+    {
+        m_hash_thread.join();
+    }
+}
 void AddFileDialog::init()
 {
     if (m_is_init)
@@ -57,6 +66,7 @@ void AddFileDialog::init()
     m_file_path_layout->setStretch(3, 1);
 
     m_file_info_service.init();
+    m_file_manifest_service.init();
 
     connect(m_file_path_button, &QPushButton::clicked, this, &AddFileDialog::on_file_path_button_clicked);
     connect(m_add_file_button, &QPushButton::clicked, this, &AddFileDialog::on_add_file_button_clicked);
@@ -89,27 +99,54 @@ void AddFileDialog::on_add_file_button_clicked()
         QMessageBox::warning(this, "Error", "File does not exist");
         return;
     }
-    QFileInfo qfile_info(file_path);
-    QFile file(file_path);
-    if (!file.open(QIODevice::ReadOnly))
+    if (m_hash_thread.joinable())
     {
-        QMessageBox::warning(this, "Error", "File cannot be opened");
-        return;
+        m_hash_thread.join();
     }
-    QCryptographicHash hash(QCryptographicHash::Md5);
-    if (!hash.addData(&file))
+    m_add_file_button->setEnabled(false);
+    // 整文件 MD5 与分块清单耗时与文件大小成正比，放到后台线程计算，避免阻塞界面
+    m_hash_thread = std::thread([this, file_path]()
+        {
+            std::optional<QString> md5;
+            QFile file(file_path);
+            QCryptographicHash hash(QCryptographicHash::Md5);
+            if (file.open(QIODevice::ReadOnly) && hash.addData(&file))
+            {
+                md5 = QString(hash.result().toHex());
+            }
+            std::optional<DaneJoe::ChunkManifest> manifest;
+            if (md5.has_value())
+            {
+                // 分块哈希清单由多个线程并行计算，耗时远小于上面的整文件 MD5
+                manifest = DaneJoe::ChunkManifest::build_from_file(file_path.toStdString());
+            }
+            QMetaObject::invokeMethod(this, [this, file_path, md5 = std::move(md5), manifest = std::move(manifest)]()
+                {
+                    on_file_hashed(file_path, md5, manifest);
+                }, Qt::QueuedConnection);
+        });
+}
+
+void AddFileDialog::on_file_hashed(const QString& file_path, std::optional<QString> md5, std::optional<DaneJoe::ChunkManifest> manifest)
+{
+    m_add_file_button->setEnabled(true);
+    if (!md5.has_value())
     {
         QMessageBox::warning(this, "Error", "File cannot be hashed");
         return;
     }
-    QString md5 = hash.result().toHex();
-    ServerFileInfo file_info = ServerFileInfo(0, qfile_info.fileName().toStdString(), qfile_info.filePath().toStdString(), static_cast<uint32_t>(qfile_info.size()), md5.toStdString());
+    QFileInfo qfile_info(file_path);
+    ServerFileInfo file_info = ServerFileInfo(0, qfile_info.fileName().toStdString(), qfile_info.filePath().toStdString(), static_cast<uint32_t>(qfile_info.size()), md5->toStdString());
 
     bool result = m_file_info_service.add(file_info);
     file_info.file_id = m_file_info_service.count();
     if (result)
     {
+        if (!manifest.has_value() || !m_file_manifest_service.save(file_info.file_id, std::move(manifest.value())))
+        {
+            DANEJOE_LOG_WARN("default", "AddFileDialog", "Failed to build manifest for {}", file_info.resource_path);
+        }
         ServerFileInfoTableModel::get_instance()->add(file_info);
         QMessageBox::information(this, "Success", "File added successfully");
     }
-}
\ No newline at end of file
+}
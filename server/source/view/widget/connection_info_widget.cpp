@@ -1,4 +1,12 @@
+#include <format>
+
+#include <QLabel>
+#include <QFont>
+#include <QVBoxLayout>
+#include <QTimerEvent>
+
 #include <danejoe/logger/logger_manager.hpp>
+#include <danejoe/metrics/metrics_registry.hpp>
 
 #include "view/widget/connection_info_widget.hpp"
 
@@ -14,5 +22,49 @@ void ConnectionInfoWidget::init()
     }
     this->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
     this->setObjectName("connection_info_widget");
+    m_metrics_label = new QLabel(this);
+    m_metrics_label->setAlignment(Qt::AlignLeft | Qt::AlignTop);
+    m_metrics_label->setFont(QFont("Monospace"));
+    m_layout = new QVBoxLayout(this);
+    m_layout->addWidget(m_metrics_label);
+    m_layout->setObjectName("connection_info_widget_layout");
+    startTimer(1000);
     m_is_init = true;
+}
+
+void ConnectionInfoWidget::timerEvent(QTimerEvent* event)
+{
+    Q_UNUSED(event);
+    auto snapshot = DaneJoe::MetricsRegistry::get_instance().get_snapshot();
+    uint64_t bytes_in = snapshot.get_counter("network_bytes_in_total");
+    uint64_t bytes_out = snapshot.get_counter("network_bytes_out_total");
+    // 定时器间隔为 1 秒，相邻两次的差值即为每秒速率
+    uint64_t bytes_in_rate = bytes_in - m_last_bytes_in;
+    uint64_t bytes_out_rate = bytes_out - m_last_bytes_out;
+    m_last_bytes_in = bytes_in;
+    m_last_bytes_out = bytes_out;
+    if (!isVisible())
+    {
+        return;
+    }
+    auto text = std::format(
+        "Active connections:   {}\n"
+        "Accepted connections: {}\n"
+        "\n"
+        "Bytes in:   {} ({:.1f} KiB/s)\n"
+        "Bytes out:  {} ({:.1f} KiB/s)\n"
+        "Frames in:  {}\n"
+        "Frames out: {}\n"
+        "\n"
+        "Mailbox to server depth: {}\n"
+        "Mailbox to client depth: {}",
+        snapshot.get_gauge("network_active_connections"),
+        snapshot.get_counter("network_accepted_connections_total"),
+        bytes_in, static_cast<double>(bytes_in_rate) / 1024.0,
+        bytes_out, static_cast<double>(bytes_out_rate) / 1024.0,
+        snapshot.get_counter("network_frames_in_total"),
+        snapshot.get_counter("network_frames_out_total"),
+        snapshot.get_gauge("mailbox_to_server_depth"),
+        snapshot.get_gauge("mailbox_to_client_depth"));
+    m_metrics_label->setText(QString::fromStdString(text));
 }
\ No newline at end of file
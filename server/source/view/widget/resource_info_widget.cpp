@@ -1,8 +1,13 @@
+#include <format>
+
+#include <QLabel>
 #include <QTableView>
+#include <QTimerEvent>
 #include <QHeaderView>
 #include <QVBoxLayout>
 
 #include <danejoe/logger/logger_manager.hpp>
+#include <danejoe/metrics/metrics_registry.hpp>
 
 #include "view/widget/resource_info_widget.hpp"
 #include "model/view/server_file_info_table_model.hpp"
@@ -23,10 +28,40 @@ void ResourceInfoWidget::init()
     m_table_view->setModel(m_model);
     m_table_view->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
     m_table_view->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+    m_metrics_label = new QLabel(this);
+    m_metrics_label->setAlignment(Qt::AlignLeft | Qt::AlignTop);
     m_layout = new QVBoxLayout(this);
 
     m_layout->addWidget(m_table_view);
+    m_layout->addWidget(m_metrics_label);
     m_layout->setObjectName("resource_info_widget_layout");
     m_layout->setStretch(0, 1);
+    startTimer(1000);
     m_is_init = true;
+}
+
+void ResourceInfoWidget::timerEvent(QTimerEvent* event)
+{
+    Q_UNUSED(event);
+    if (!isVisible())
+    {
+        return;
+    }
+    auto snapshot = DaneJoe::MetricsRegistry::get_instance().get_snapshot();
+    auto query_latency = snapshot.get_histogram("database_query_latency_ns");
+    auto text = std::format(
+        "Requests  /test: {}  /download: {}  /manifest: {}  /delta: {}  /block: {}\n"
+        "Block reads: {} ({:.1f} MiB)\n"
+        "Database queries: {}  p50: {:.1f} us  p99: {:.1f} us",
+        snapshot.get_counter("server_requests_total{path=\"/test\"}"),
+        snapshot.get_counter("server_requests_total{path=\"/download\"}"),
+        snapshot.get_counter("server_requests_total{path=\"/manifest\"}"),
+        snapshot.get_counter("server_requests_total{path=\"/delta\"}"),
+        snapshot.get_counter("server_requests_total{path=\"/block\"}"),
+        snapshot.get_counter("server_block_reads_total"),
+        static_cast<double>(snapshot.get_counter("server_block_read_bytes_total")) / (1024.0 * 1024.0),
+        query_latency.count,
+        static_cast<double>(query_latency.p50) / 1000.0,
+        static_cast<double>(query_latency.p99) / 1000.0);
+    m_metrics_label->setText(QString::fromStdString(text));
 }
\ No newline at end of file